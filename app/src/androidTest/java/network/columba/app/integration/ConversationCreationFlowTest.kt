@@ -68,6 +68,7 @@ class ConversationCreationFlowTest {
                 localIdentityDao = database.localIdentityDao(),
                 attachmentStorage = AttachmentStorageManager(context),
                 draftDao = database.draftDao(),
+                reactionDao = database.reactionDao(),
             )
     }
 
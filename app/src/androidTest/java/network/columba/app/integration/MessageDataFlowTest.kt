@@ -77,6 +77,7 @@ class MessageDataFlowTest {
                 localIdentityDao = database.localIdentityDao(),
                 attachmentStorage = AttachmentStorageManager(context),
                 draftDao = database.draftDao(),
+                reactionDao = database.reactionDao(),
             )
     }
 
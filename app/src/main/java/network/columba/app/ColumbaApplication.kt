@@ -2,6 +2,10 @@ package network.columba.app
 
 import android.app.Application
 import android.os.StrictMode
+import androidx.lifecycle.Lifecycle
+import androidx.lifecycle.ProcessLifecycleOwner
+import coil.ImageLoader
+import coil.ImageLoaderFactory
 import dagger.hilt.android.HiltAndroidApp
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
@@ -10,6 +14,7 @@ import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withTimeoutOrNull
+import network.columba.app.data.db.migration.BackgroundMigrationRunner
 import network.columba.app.data.repository.ContactRepository
 import network.columba.app.data.repository.ConversationRepository
 import network.columba.app.data.repository.IdentityRepository
@@ -19,6 +24,7 @@ import network.columba.app.rns.api.model.LogLevel
 import network.columba.app.rns.api.model.ReticulumConfig
 import network.columba.app.rns.api.RnsCore
 import network.columba.app.rns.api.RnsLxmf
+import network.columba.app.rns.api.util.RingLog
 import network.columba.app.service.IdentityResolutionManager
 import network.columba.app.service.MessageCollector
 import network.columba.app.service.PropagationNodeManager
@@ -28,8 +34,10 @@ import network.columba.app.startup.ServiceIdentityVerifier
 import network.columba.app.startup.StartupConfigLoader
 import network.columba.app.telemetry.CrashReporter
 import network.columba.app.telemetry.CrashReporterProvider
+import network.columba.app.util.AnimatedImageLoader
 import network.columba.app.util.CrashReportManager
 import network.columba.app.util.HexUtils.hexStringToByteArray
+import java.io.File
 import javax.inject.Inject
 
 /**
@@ -37,7 +45,9 @@ import javax.inject.Inject
  * Annotated with @HiltAndroidApp to enable Hilt dependency injection.
  */
 @HiltAndroidApp
-class ColumbaApplication : Application() {
+class ColumbaApplication :
+    Application(),
+    ImageLoaderFactory {
     companion object {
         /** Timeout for IPC calls to prevent ANR during initialization */
         internal const val IPC_TIMEOUT_MS = 5000L
@@ -100,6 +110,9 @@ class ColumbaApplication : Application() {
     @Inject
     lateinit var propagationNodeManager: PropagationNodeManager
 
+    @Inject
+    lateinit var pathTableMirror: network.columba.app.service.PathTableMirror
+
     @Inject
     lateinit var crashReportManager: CrashReportManager
 
@@ -109,6 +122,9 @@ class ColumbaApplication : Application() {
     @Inject
     lateinit var interfaceTransportObserver: network.columba.app.service.manager.InterfaceTransportObserver
 
+    @Inject
+    lateinit var backgroundMigrationRunner: BackgroundMigrationRunner
+
     // Application-level coroutine scope for app-wide operations
     // Uses Dispatchers.Default for background initialization (no main-thread work needed)
     // SupervisorJob ensures failures don't crash the entire app
@@ -120,12 +136,24 @@ class ColumbaApplication : Application() {
     // of onCreate(), before the DI graph is guaranteed ready.
     private val crashReporter: CrashReporter = CrashReporterProvider.create()
 
+    // Every Coil request in the app, including those without an explicit loader,
+    // goes through the one loader whose memory cache is shared with ImageCache.
+    override fun newImageLoader(): ImageLoader = AnimatedImageLoader.getInstance(this)
+
     override fun onCreate() {
         super.onCreate()
 
         // Install crash handler FIRST (before anything else that might crash)
         // This ensures we capture crashes from any subsequent initialization
         crashReportManager.installCrashHandler()
+
+        // Both processes share one log directory so a bug report from either one
+        // includes the other's recent RingLog records
+        val processName = getCurrentProcessName()
+        RingLog.logcatLevel = if (BuildConfig.DEBUG) RingLog.Level.VERBOSE else RingLog.Level.INFO
+        // Release builds keep RingLog's INFO default, so debug messages are never built
+        if (BuildConfig.DEBUG) RingLog.defaultLevel = RingLog.Level.DEBUG
+        RingLog.attach(File(filesDir, "logs"), processName?.substringAfter(':', "main") ?: "main")
         // Initialize crash reporting (Sentry flavor only). Consent is read synchronously
         // from the SharedPreferences mirror so we never block the main thread on DataStore.
         // When consent is not granted, the reporter does not initialize or upload anything.
@@ -158,7 +186,6 @@ class ColumbaApplication : Application() {
 
         // Skip RNS auto-init in service process or test environment
         // Only the main app process should initialize
-        val processName = getCurrentProcessName()
         if (processName?.contains(":reticulum") == true || isRunningInTest()) {
             val context = if (isRunningInTest()) "test" else "service"
             android.util.Log.d("ColumbaApplication", "$context process detected ($processName) - skipping auto-initialization")
@@ -189,6 +216,19 @@ class ColumbaApplication : Application() {
                 .cleanupAllTempFiles(this@ColumbaApplication)
         }
 
+        // Finish any post-open data migrations (chunked, resumable). Throttled while
+        // the UI is in the foreground so it never contends with scrolling or sends.
+        applicationScope.launch(Dispatchers.IO) {
+            backgroundMigrationRunner.runPending(
+                isUiActive = {
+                    ProcessLifecycleOwner
+                        .get()
+                        .lifecycle.currentState
+                        .isAtLeast(Lifecycle.State.STARTED)
+                },
+            )
+        }
+
         // Migrate unencrypted identity keys to encrypted storage (one-time, idempotent),
         // then scrub any stale plaintext identity_<hash> files. The migration reads those
         // same files for upgraders whose keys were only on disk, so the scrub MUST run
@@ -397,6 +437,7 @@ class ColumbaApplication : Application() {
                         messageCollector.startCollecting()
                         autoAnnounceManager.start()
                         identityResolutionManager.start(applicationScope)
+                        pathTableMirror.start(applicationScope)
                         propagationNodeManager.start()
                         telemetryCollectorManager.start()
                         android.util.Log.d(
@@ -575,6 +616,7 @@ class ColumbaApplication : Application() {
                         messageCollector.startCollecting()
                         autoAnnounceManager.start()
                         identityResolutionManager.start(applicationScope)
+                        pathTableMirror.start(applicationScope)
                         propagationNodeManager.start()
                         telemetryCollectorManager.start()
                         android.util.Log.d(
@@ -604,6 +646,7 @@ class ColumbaApplication : Application() {
         autoAnnounceManager.stop()
         messageCollector.stopCollecting()
         identityResolutionManager.stop()
+        pathTableMirror.stop()
         interfaceTransportObserver.stop()
 
         // Shutdown and unbind from service when app terminates
@@ -0,0 +1,17 @@
+package network.columba.app.di
+
+import dagger.hilt.EntryPoint
+import dagger.hilt.InstallIn
+import dagger.hilt.components.SingletonComponent
+import network.columba.app.notifications.NotificationHelper
+
+/**
+ * Hilt entry point for retrieving the singleton [NotificationHelper] from
+ * [network.columba.app.notifications.MessageNotificationReceiver], which the
+ * system instantiates outside the Hilt-injected object graph.
+ */
+@EntryPoint
+@InstallIn(SingletonComponent::class)
+interface NotificationHelperEntryPoint {
+    fun notificationHelper(): NotificationHelper
+}
@@ -5,6 +5,7 @@ import android.database.sqlite.SQLiteDatabase
 import android.util.Log
 import java.io.Closeable
 import java.io.File
+import java.security.MessageDigest
 import kotlin.math.pow
 
 /**
@@ -16,6 +17,11 @@ import kotlin.math.pow
  * Note: MBTiles uses TMS tile scheme (origin at bottom-left),
  * while most online tile servers use XYZ (origin at top-left).
  * This writer handles the conversion automatically.
+ *
+ * Alongside the standard tables it keeps a `tile_validators` table (HTTP
+ * ETag / Last-Modified and a content hash per tile) so a later update can
+ * revalidate tiles instead of downloading them again. Readers that only
+ * know the MBTiles spec ignore the extra table.
  */
 class MBTilesWriter(
     private val file: File,
@@ -49,6 +55,19 @@ class MBTilesWriter(
         override fun toString(): String = "$longitude,$latitude,$zoom"
     }
 
+    /**
+     * What is known about a stored tile's origin, for revalidating it.
+     *
+     * @param etag ETag the server sent with the tile, if any
+     * @param lastModified Last-Modified header the server sent, if any
+     * @param contentHash Hash of the stored tile bytes (see [contentHash])
+     */
+    data class TileValidator(
+        val etag: String?,
+        val lastModified: String?,
+        val contentHash: String,
+    )
+
     private var db: SQLiteDatabase? = null
     private var tileCount = 0
     private var totalBytes = 0L
@@ -69,6 +88,19 @@ class MBTilesWriter(
         writeMetadata()
     }
 
+    /**
+     * Open an existing MBTiles file to update it in place, keeping its tiles.
+     * Adds any missing tables and rewrites the metadata from this writer's
+     * parameters. Creates the file if it doesn't exist.
+     */
+    fun openExisting() {
+        file.parentFile?.mkdirs()
+
+        db = SQLiteDatabase.openOrCreateDatabase(file, null)
+        createSchema()
+        writeMetadata()
+    }
+
     private fun createSchema() {
         db?.let { database ->
             // Enable WAL mode for better concurrency and crash recovery
@@ -103,6 +135,21 @@ class MBTilesWriter(
                 """.trimIndent(),
             )
 
+            // Per-tile revalidation data for incremental updates
+            database.execSQL(
+                """
+                CREATE TABLE IF NOT EXISTS tile_validators (
+                    zoom_level INTEGER NOT NULL,
+                    tile_column INTEGER NOT NULL,
+                    tile_row INTEGER NOT NULL,
+                    etag TEXT,
+                    last_modified TEXT,
+                    content_hash TEXT NOT NULL,
+                    PRIMARY KEY (zoom_level, tile_column, tile_row)
+                )
+                """.trimIndent(),
+            )
+
             // Create index for faster tile lookups
             database.execSQL(
                 "CREATE INDEX IF NOT EXISTS tiles_index ON tiles (zoom_level, tile_column, tile_row)",
@@ -161,12 +208,16 @@ class MBTilesWriter(
      * @param x Tile X coordinate (XYZ scheme, origin at top-left)
      * @param y Tile Y coordinate (XYZ scheme, origin at top-left)
      * @param data The tile data (PBF/MVT bytes)
+     * @param etag ETag the server sent with the tile, if any
+     * @param lastModified Last-Modified header the server sent, if any
      */
     fun writeTile(
         z: Int,
         x: Int,
         y: Int,
         data: ByteArray,
+        etag: String? = null,
+        lastModified: String? = null,
     ) {
         db?.let { database ->
             // Convert from XYZ to TMS y-coordinate
@@ -188,11 +239,105 @@ class MBTilesWriter(
                 SQLiteDatabase.CONFLICT_REPLACE,
             )
 
+            writeValidator(database, z, x, tmsY, TileValidator(etag, lastModified, contentHash(data)))
+
             tileCount++
             totalBytes += data.size
         }
     }
 
+    /**
+     * Revalidation data for a stored tile, or null if the tile isn't stored.
+     * Tiles written before validators were recorded get a hash computed from
+     * their stored bytes, with no HTTP validators.
+     *
+     * @param z Zoom level
+     * @param x Tile X coordinate (XYZ scheme)
+     * @param y Tile Y coordinate (XYZ scheme)
+     */
+    fun getTileValidator(
+        z: Int,
+        x: Int,
+        y: Int,
+    ): TileValidator? {
+        val database = db ?: return null
+        val args = arrayOf(z.toString(), x.toString(), flipY(z, y).toString())
+        database.rawQuery(
+            "SELECT etag, last_modified, content_hash FROM tile_validators " +
+                "WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?",
+            args,
+        ).use { cursor ->
+            if (cursor.moveToFirst()) {
+                return TileValidator(
+                    etag = cursor.getString(0),
+                    lastModified = cursor.getString(1),
+                    contentHash = cursor.getString(2),
+                )
+            }
+        }
+        database.rawQuery(
+            "SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?",
+            args,
+        ).use { cursor ->
+            return if (cursor.moveToFirst()) TileValidator(null, null, contentHash(cursor.getBlob(0))) else null
+        }
+    }
+
+    /**
+     * Record new HTTP validators for a stored tile whose content didn't change.
+     *
+     * @param z Zoom level
+     * @param x Tile X coordinate (XYZ scheme)
+     * @param y Tile Y coordinate (XYZ scheme)
+     */
+    fun updateTileValidator(
+        z: Int,
+        x: Int,
+        y: Int,
+        validator: TileValidator,
+    ) {
+        db?.let { writeValidator(it, z, x, flipY(z, y), validator) }
+    }
+
+    /**
+     * Remove a tile (and its validators), e.g. when the server no longer has it.
+     *
+     * @param z Zoom level
+     * @param x Tile X coordinate (XYZ scheme)
+     * @param y Tile Y coordinate (XYZ scheme)
+     */
+    fun deleteTile(
+        z: Int,
+        x: Int,
+        y: Int,
+    ) {
+        db?.let { database ->
+            val args = arrayOf(z.toString(), x.toString(), flipY(z, y).toString())
+            val where = "zoom_level = ? AND tile_column = ? AND tile_row = ?"
+            database.delete("tiles", where, args)
+            database.delete("tile_validators", where, args)
+        }
+    }
+
+    private fun writeValidator(
+        database: SQLiteDatabase,
+        z: Int,
+        x: Int,
+        tmsY: Int,
+        validator: TileValidator,
+    ) {
+        val values =
+            ContentValues().apply {
+                put("zoom_level", z)
+                put("tile_column", x)
+                put("tile_row", tmsY)
+                put("etag", validator.etag)
+                put("last_modified", validator.lastModified)
+                put("content_hash", validator.contentHash)
+            }
+        database.insertWithOnConflict("tile_validators", null, values, SQLiteDatabase.CONFLICT_REPLACE)
+    }
+
     /**
      * Begin a transaction for bulk inserts.
      * Call [endTransaction] when done.
@@ -297,6 +442,13 @@ class MBTilesWriter(
             return (2.0.pow(zoom) - 1 - tmsY).toInt()
         }
 
+        /**
+         * Hash identifying a tile's content, used to tell whether a
+         * re-downloaded tile actually changed.
+         */
+        fun contentHash(data: ByteArray): String =
+            MessageDigest.getInstance("SHA-256").digest(data).joinToString("") { "%02x".format(it) }
+
         /**
          * Calculate bounds from center point and radius in kilometers.
          */
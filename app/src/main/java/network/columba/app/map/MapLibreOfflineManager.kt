@@ -106,44 +106,7 @@ class MapLibreOfflineManager
                         onCreated(offlineRegion.id)
 
                         // Set up download observer
-                        offlineRegion.setObserver(
-                            object : OfflineRegion.OfflineRegionObserver {
-                                override fun onStatusChanged(status: OfflineRegionStatus) {
-                                    val progress =
-                                        if (status.requiredResourceCount > 0) {
-                                            status.completedResourceCount.toFloat() / status.requiredResourceCount
-                                        } else {
-                                            0f
-                                        }
-
-                                    Log.d(
-                                        TAG,
-                                        "Download progress: ${(progress * 100).toInt()}% " +
-                                            "(${status.completedResourceCount}/${status.requiredResourceCount})",
-                                    )
-
-                                    onProgress(progress, status.completedResourceCount, status.requiredResourceCount)
-
-                                    if (status.isComplete) {
-                                        Log.d(TAG, "Download complete! Size: ${status.completedResourceSize} bytes")
-                                        offlineRegion.setObserver(null)
-                                        onComplete(offlineRegion.id, status.completedResourceSize)
-                                    }
-                                }
-
-                                override fun onError(error: OfflineRegionError) {
-                                    Log.e(TAG, "Download error: ${error.reason} - ${error.message}")
-                                    offlineRegion.setObserver(null)
-                                    onError("${error.reason}: ${error.message}")
-                                }
-
-                                override fun mapboxTileCountLimitExceeded(limit: Long) {
-                                    Log.e(TAG, "Tile count limit exceeded: $limit")
-                                    offlineRegion.setObserver(null)
-                                    onError("Tile count limit exceeded ($limit tiles). Try a smaller region or fewer zoom levels.")
-                                }
-                            },
-                        )
+                        offlineRegion.setObserver(downloadObserver(offlineRegion, onProgress, onComplete, onError))
 
                         // Start the download
                         offlineRegion.setDownloadState(OfflineRegion.STATE_ACTIVE)
@@ -157,6 +120,98 @@ class MapLibreOfflineManager
             )
         }
 
+        /**
+         * Revalidate an existing region in place.
+         *
+         * Its resources are marked expired and the download restarted, so
+         * MapLibre re-requests each one conditionally and only transfers what
+         * changed; the stored copies stay usable offline throughout.
+         *
+         * @param onComplete Callback with the region ID and its size in bytes
+         */
+        fun refreshRegion(
+            regionId: Long,
+            // progress, completedResources, requiredResources
+            onProgress: (Float, Long, Long) -> Unit,
+            // regionId, sizeBytes
+            onComplete: (Long, Long) -> Unit,
+            onError: (String) -> Unit,
+        ) {
+            findRegion(regionId) { region ->
+                if (region == null) {
+                    onError("Offline region $regionId not found")
+                    return@findRegion
+                }
+                region.invalidate(
+                    object : OfflineRegion.OfflineRegionInvalidateCallback {
+                        override fun onInvalidate() {
+                            Log.d(TAG, "Refreshing region $regionId")
+                            region.setObserver(downloadObserver(region, onProgress, onComplete, onError))
+                            region.setDownloadState(OfflineRegion.STATE_ACTIVE)
+                        }
+
+                        override fun onError(error: String) {
+                            Log.e(TAG, "Failed to invalidate region: $error")
+                            onError(error)
+                        }
+                    },
+                )
+            }
+        }
+
+        /**
+         * Stop a [refreshRegion] without reporting back; tiles already
+         * revalidated are kept and the rest stay as they were.
+         */
+        fun cancelRefresh(regionId: Long) {
+            findRegion(regionId) { region ->
+                region?.setObserver(null)
+                region?.setDownloadState(OfflineRegion.STATE_INACTIVE)
+            }
+        }
+
+        private fun downloadObserver(
+            offlineRegion: OfflineRegion,
+            onProgress: (Float, Long, Long) -> Unit,
+            onComplete: (Long, Long) -> Unit,
+            onError: (String) -> Unit,
+        ) = object : OfflineRegion.OfflineRegionObserver {
+            override fun onStatusChanged(status: OfflineRegionStatus) {
+                val progress =
+                    if (status.requiredResourceCount > 0) {
+                        status.completedResourceCount.toFloat() / status.requiredResourceCount
+                    } else {
+                        0f
+                    }
+
+                Log.d(
+                    TAG,
+                    "Download progress: ${(progress * 100).toInt()}% " +
+                        "(${status.completedResourceCount}/${status.requiredResourceCount})",
+                )
+
+                onProgress(progress, status.completedResourceCount, status.requiredResourceCount)
+
+                if (status.isComplete) {
+                    Log.d(TAG, "Download complete! Size: ${status.completedResourceSize} bytes")
+                    offlineRegion.setObserver(null)
+                    onComplete(offlineRegion.id, status.completedResourceSize)
+                }
+            }
+
+            override fun onError(error: OfflineRegionError) {
+                Log.e(TAG, "Download error: ${error.reason} - ${error.message}")
+                offlineRegion.setObserver(null)
+                onError("${error.reason}: ${error.message}")
+            }
+
+            override fun mapboxTileCountLimitExceeded(limit: Long) {
+                Log.e(TAG, "Tile count limit exceeded: $limit")
+                offlineRegion.setObserver(null)
+                onError("Tile count limit exceeded ($limit tiles). Try a smaller region or fewer zoom levels.")
+            }
+        }
+
         /**
          * List all downloaded offline regions.
          *
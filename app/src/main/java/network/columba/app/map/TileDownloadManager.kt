@@ -21,6 +21,12 @@ import java.net.HttpURLConnection
 import java.net.URL
 import java.nio.ByteBuffer
 import java.nio.ByteOrder
+import java.nio.file.Files
+import java.nio.file.StandardCopyOption
+import java.time.Instant
+import java.time.ZoneOffset
+import java.time.format.DateTimeFormatter
+import java.util.Locale
 import kotlin.math.PI
 import kotlin.math.atan
 import kotlin.math.cos
@@ -85,6 +91,8 @@ class TileDownloadManager(
         val bytesDownloaded: Long,
         val currentZoom: Int,
         val errorMessage: String? = null,
+        // Tiles kept from the existing file during an update (counted in downloadedTiles too)
+        val reusedTiles: Int = 0,
     ) {
         val progress: Float
             get() = if (totalTiles > 0) downloadedTiles.toFloat() / totalTiles else 0f
@@ -167,6 +175,70 @@ class TileDownloadManager(
             }
         }
 
+    /**
+     * Update an existing MBTiles region, reusing tiles that haven't changed.
+     *
+     * Works on a copy of [existingFile]: each tile already in it is revalidated
+     * with a conditional request (If-None-Match / If-Modified-Since) and only
+     * rewritten if the server sends different content; tiles missing from it
+     * are downloaded. Tiles stored without server validators (files written
+     * before they were recorded) are revalidated against the time the file was
+     * last written. The copy then replaces [outputFile] in one rename, so
+     * readers never see a half-updated file and [existingFile] is untouched if
+     * the update fails or is cancelled. Tiles that can't be fetched keep their
+     * stored copy and are counted in [DownloadProgress.failedTiles].
+     *
+     * RMSP sources have no per-tile revalidation; they download the region
+     * again into the copy.
+     *
+     * @param existingFile The region's current MBTiles file
+     * @param outputFile Where the updated file goes; may be [existingFile]
+     * @return The output file on success, null on failure or cancellation
+     */
+    @Suppress("LongParameterList")
+    suspend fun updateRegion(
+        existingFile: File,
+        centerLat: Double,
+        centerLon: Double,
+        radiusKm: Int,
+        minZoom: Int,
+        maxZoom: Int,
+        name: String,
+        outputFile: File,
+    ): File? =
+        withContext(Dispatchers.IO) {
+            isCancelled = false
+
+            val stagingFile = File(outputFile.parentFile, "${outputFile.name}$STAGING_SUFFIX")
+            val params = RegionParams(centerLat, centerLon, radiusKm, minZoom, maxZoom, name, stagingFile)
+            try {
+                val updated =
+                    when (tileSource) {
+                        is TileSource.Http -> {
+                            // Every tile in the file was current when it was last written
+                            val storedSince = existingFile.lastModified().takeIf { it > 0 }?.let(::httpDate)
+                            if (existingFile.exists()) existingFile.copyTo(stagingFile, overwrite = true)
+                            downloadRegionHttp(params, incremental = true, storedSince = storedSince)
+                        }
+                        is TileSource.Rmsp -> downloadRegionRmsp(tileSource, params)
+                    }
+                updated?.let {
+                    Files.move(
+                        stagingFile.toPath(),
+                        outputFile.toPath(),
+                        StandardCopyOption.REPLACE_EXISTING,
+                        StandardCopyOption.ATOMIC_MOVE,
+                    )
+                    outputFile
+                }
+            } catch (e: Exception) {
+                updateErrorStatus(e.message ?: "Update failed")
+                null
+            } finally {
+                stagingFile.delete()
+            }
+        }
+
     /**
      * Fetch TileJSON to get the current versioned tile URL template.
      * OpenFreeMap updates the version path with each planet update.
@@ -218,8 +290,15 @@ class TileDownloadManager(
 
     /**
      * Download tiles from HTTP source.
+     *
+     * @param incremental Keep the tiles already in [RegionParams.outputFile]
+     *   and only fetch what changed (see [updateRegion])
      */
-    private suspend fun downloadRegionHttp(params: RegionParams): File? {
+    private suspend fun downloadRegionHttp(
+        params: RegionParams,
+        incremental: Boolean = false,
+        storedSince: String? = null,
+    ): File? {
         return try {
             // Calculate bounds and tiles
             _progress.value = _progress.value.copy(status = DownloadProgress.Status.CALCULATING)
@@ -248,6 +327,7 @@ class TileDownloadManager(
                     downloadedTiles = 0,
                     failedTiles = 0,
                     bytesDownloaded = 0,
+                    reusedTiles = 0,
                 )
 
             val writer =
@@ -260,11 +340,11 @@ class TileDownloadManager(
                     bounds = bounds,
                     center = MBTilesWriter.Center(params.centerLon, params.centerLat, (params.minZoom + params.maxZoom) / 2),
                 )
-            writer.open()
+            if (incremental) writer.openExisting() else writer.open()
 
             var success = false
             try {
-                success = executeHttpDownload(writer, tiles, params)
+                success = executeHttpDownload(writer, tiles, params, incremental, storedSince)
                 if (success) {
                     _progress.value = _progress.value.copy(status = DownloadProgress.Status.WRITING)
                     writer.optimize()
@@ -283,14 +363,18 @@ class TileDownloadManager(
         }
     }
 
+    @Suppress("LongMethod", "CyclomaticComplexMethod")
     private suspend fun executeHttpDownload(
         writer: MBTilesWriter,
         tiles: List<TileCoord>,
         params: RegionParams,
+        incremental: Boolean = false,
+        storedSince: String? = null,
     ): Boolean {
         val writeMutex = Mutex()
         val semaphore = Semaphore(CONCURRENT_DOWNLOADS)
         var downloadedCount = 0
+        var reusedCount = 0
         var failedCount = 0
         var totalBytes = 0L
 
@@ -308,25 +392,66 @@ class TileDownloadManager(
                     zoomTiles.chunked(BATCH_SIZE).forEach { batch ->
                         if (isCancelled) return@forEach
 
+                        // What the existing file already has, for conditional requests
+                        val validators =
+                            if (incremental) {
+                                writeMutex.withLock {
+                                    batch.map { tile ->
+                                        writer.getTileValidator(tile.z, tile.x, tile.y)?.let { validator ->
+                                            // Hash only: ask whether it changed since the file was written
+                                            if (validator.etag == null && validator.lastModified == null) {
+                                                validator.copy(lastModified = storedSince)
+                                            } else {
+                                                validator
+                                            }
+                                        }
+                                    }
+                                }
+                            } else {
+                                null
+                            }
+
                         // Download batch concurrently
                         val results =
-                            batch.map { tile ->
+                            batch.mapIndexed { index, tile ->
                                 async {
                                     if (isCancelled) return@async TileResult.Failed
-                                    semaphore.withPermit { downloadTileWithRetry(tile) }
+                                    semaphore.withPermit { downloadTileWithRetry(tile, validators?.get(index)) }
                                 }
                             }.awaitAll()
 
                         // Write batch immediately to reduce memory footprint
                         for ((index, result) in results.withIndex()) {
+                            val tile = batch[index]
+                            val existing = validators?.get(index)
                             when (result) {
                                 is TileResult.Success -> {
-                                    val tile = batch[index]
-                                    writeMutex.withLock { writer.writeTile(tile.z, tile.x, tile.y, result.data) }
+                                    val unchanged = existing?.takeIf { it.contentHash == MBTilesWriter.contentHash(result.data) }
+                                    writeMutex.withLock {
+                                        if (unchanged != null) {
+                                            // Re-sent but identical: keep the stored tile, remember the new validators
+                                            writer.updateTileValidator(
+                                                tile.z,
+                                                tile.x,
+                                                tile.y,
+                                                unchanged.copy(etag = result.etag, lastModified = result.lastModified),
+                                            )
+                                            reusedCount++
+                                        } else {
+                                            writer.writeTile(tile.z, tile.x, tile.y, result.data, result.etag, result.lastModified)
+                                        }
+                                    }
                                     downloadedCount++
                                     totalBytes += result.data.size
                                 }
-                                is TileResult.NotAvailable -> { /* Skip - no data at this location */ }
+                                is TileResult.NotModified -> {
+                                    downloadedCount++
+                                    reusedCount++
+                                }
+                                is TileResult.NotAvailable -> {
+                                    // No data at this location; drop the stale copy when updating
+                                    if (existing != null) writeMutex.withLock { writer.deleteTile(tile.z, tile.x, tile.y) }
+                                }
                                 is TileResult.Failed -> failedCount++
                             }
                         }
@@ -335,6 +460,7 @@ class TileDownloadManager(
                                 downloadedTiles = downloadedCount,
                                 failedTiles = failedCount,
                                 bytesDownloaded = totalBytes,
+                                reusedTiles = reusedCount,
                             )
                     }
                 }
@@ -362,6 +488,16 @@ class TileDownloadManager(
             return false
         }
 
+        if (incremental && failedCount == tiles.size) {
+            // Nothing reached the server; leave the old file as it was
+            updateErrorStatus("No tiles could be updated")
+            return false
+        }
+        if (incremental && failedCount > 0) {
+            // Failed tiles keep their stored copy; the rest of the update still goes in
+            Log.w(TAG, "$failedCount tiles could not be updated, keeping their previous version")
+        }
+
         return true
     }
 
@@ -658,18 +794,26 @@ class TileDownloadManager(
 
     /** Result of attempting to download a tile */
     private sealed class TileResult {
-        data class Success(val data: ByteArray) : TileResult()
+        data class Success(
+            val data: ByteArray,
+            val etag: String? = null,
+            val lastModified: String? = null,
+        ) : TileResult()
+
+        object NotModified : TileResult() // 304 - stored copy is still current
 
         object NotAvailable : TileResult() // 204 - tile doesn't exist at this location
 
         object Failed : TileResult() // Failed after retries
     }
 
-    private suspend fun downloadTileWithRetry(tile: TileCoord): TileResult {
+    private suspend fun downloadTileWithRetry(
+        tile: TileCoord,
+        validator: MBTilesWriter.TileValidator? = null,
+    ): TileResult {
         repeat(MAX_RETRIES) { attempt ->
             try {
-                val data = downloadTile(tile)
-                return if (data != null) TileResult.Success(data) else TileResult.NotAvailable
+                return downloadTile(tile, validator)
             } catch (e: IOException) {
                 Log.w(TAG, "Download attempt ${attempt + 1} failed for tile ${tile.z}/${tile.x}/${tile.y}: ${e.message}")
                 if (attempt < MAX_RETRIES - 1) {
@@ -680,7 +824,14 @@ class TileDownloadManager(
         return TileResult.Failed
     }
 
-    private fun downloadTile(tile: TileCoord): ByteArray? {
+    /**
+     * Fetch one tile. With a [validator] from a stored copy the request is
+     * conditional, and a 304 comes back as [TileResult.NotModified].
+     */
+    private fun downloadTile(
+        tile: TileCoord,
+        validator: MBTilesWriter.TileValidator? = null,
+    ): TileResult {
         // Use resolved template if available, otherwise fall back to direct URL construction
         val urlString =
             resolvedTileUrlTemplate
@@ -699,12 +850,18 @@ class TileDownloadManager(
             connection.readTimeout = READ_TIMEOUT_MS
             connection.setRequestProperty("User-Agent", USER_AGENT)
             connection.requestMethod = "GET"
+            validator?.etag?.let { connection.setRequestProperty("If-None-Match", it) }
+            validator?.lastModified?.let { connection.setRequestProperty("If-Modified-Since", it) }
 
             val responseCode = connection.responseCode
+            if (responseCode == HttpURLConnection.HTTP_NOT_MODIFIED && validator != null) {
+                Log.v(TAG, "Tile ${tile.z}/${tile.x}/${tile.y} not modified (304)")
+                return TileResult.NotModified
+            }
             if (responseCode == HttpURLConnection.HTTP_NO_CONTENT) {
                 // Tile not available at this location/zoom - skip storing
                 Log.v(TAG, "Tile ${tile.z}/${tile.x}/${tile.y} not available (204)")
-                return null
+                return TileResult.NotAvailable
             }
             if (responseCode != HttpURLConnection.HTTP_OK) {
                 Log.w(TAG, "HTTP $responseCode for tile ${tile.z}/${tile.x}/${tile.y}")
@@ -713,7 +870,7 @@ class TileDownloadManager(
 
             val data = connection.inputStream.use { it.readBytes() }
             Log.v(TAG, "Downloaded tile ${tile.z}/${tile.x}/${tile.y} (${data.size} bytes)")
-            return data
+            return TileResult.Success(data, connection.getHeaderField("ETag"), connection.getHeaderField("Last-Modified"))
         } catch (e: Exception) {
             Log.w(TAG, "Failed to download tile ${tile.z}/${tile.x}/${tile.y}: ${e.message}")
             throw e
@@ -731,6 +888,12 @@ class TileDownloadManager(
         // Network I/O bound - higher concurrency than CPU count is optimal
         const val CONCURRENT_DOWNLOADS = 10
 
+        private val HTTP_DATE_FORMAT =
+            DateTimeFormatter.ofPattern("EEE, dd MMM yyyy HH:mm:ss 'GMT'", Locale.US).withZone(ZoneOffset.UTC)
+
+        /** [epochMs] as an HTTP-date (RFC 9110), for If-Modified-Since. */
+        internal fun httpDate(epochMs: Long): String = HTTP_DATE_FORMAT.format(Instant.ofEpochMilli(epochMs))
+
         /**
          * Fetch the current tile version from OpenFreeMap without downloading any tiles.
          * Useful for checking if updates are available.
@@ -781,6 +944,9 @@ class TileDownloadManager(
         const val CONNECT_TIMEOUT_MS = 30_000
         const val READ_TIMEOUT_MS = 30_000
 
+        // Suffix of the working copy an update writes before swapping it in
+        const val STAGING_SUFFIX = ".updating"
+
         /**
          * Convert latitude/longitude to tile coordinates.
          */
@@ -94,11 +94,11 @@ data class MessageExport(
     val status: String,
     val isRead: Boolean,
     val fieldsJson: String?,
-    // DB v2+ — per-target-message reactions aggregation, flat
-    // `{emoji: [senderHex, ...]}`. Optional for backwards-compat with
-    // older export bundles that still encode reactions under
-    // `fieldsJson.field16.reactions`; MigrationImporter routes either
-    // shape into the new column.
+    // Per-target-message reactions aggregation, flat
+    // `{emoji: [senderHex, ...]}`, built from the `reactions` table on
+    // export. Optional for backwards-compat with older export bundles
+    // that still encode reactions under `fieldsJson.field16.reactions`;
+    // MigrationImporter splits either shape into `reactions` rows.
     val reactionsJson: String? = null,
 )
 
@@ -9,6 +9,7 @@ import network.columba.app.data.crypto.IdentityKeyEncryptor
 import network.columba.app.data.crypto.IdentityKeyProvider
 import network.columba.app.data.database.InterfaceDatabase
 import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.ReactionEntity
 import network.columba.app.repository.SettingsRepository
 import dagger.hilt.android.qualifiers.ApplicationContext
 import kotlinx.coroutines.Dispatchers
@@ -16,6 +17,8 @@ import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.withContext
 import kotlinx.serialization.encodeToString
 import kotlinx.serialization.json.Json
+import org.json.JSONArray
+import org.json.JSONObject
 import java.io.File
 import java.io.FileOutputStream
 import java.text.SimpleDateFormat
@@ -199,8 +202,11 @@ class MigrationExporter
                 )
             }
 
-        private suspend fun exportMessagesForIdentity(identityHash: String): List<MessageExport> =
-            database.messageDao().getAllMessagesForIdentity(identityHash).map { msg ->
+        private suspend fun exportMessagesForIdentity(identityHash: String): List<MessageExport> {
+            // Bundles keep the flat per-message blob so older builds can still import them
+            val reactionsByMessage =
+                database.reactionDao().getAllReactionsForIdentity(identityHash).groupBy { it.messageId }
+            return database.messageDao().getAllMessagesForIdentity(identityHash).map { msg ->
                 MessageExport(
                     id = msg.id,
                     conversationHash = msg.conversationHash,
@@ -211,9 +217,19 @@ class MigrationExporter
                     status = msg.status,
                     isRead = msg.isRead,
                     fieldsJson = msg.fieldsJson,
-                    reactionsJson = msg.reactionsJson,
+                    reactionsJson = reactionsByMessage[msg.id]?.let(::toReactionsJson),
                 )
             }
+        }
+
+        private fun toReactionsJson(reactions: List<ReactionEntity>): String {
+            val json = JSONObject()
+            reactions.forEach { reaction ->
+                val senders = json.optJSONArray(reaction.emoji) ?: JSONArray().also { json.put(reaction.emoji, it) }
+                senders.put(reaction.sender)
+            }
+            return json.toString()
+        }
 
         private suspend fun exportContactsForIdentity(identityHash: String): List<ContactExport> =
             database.contactDao().getAllContactsSync(identityHash).map { contact ->
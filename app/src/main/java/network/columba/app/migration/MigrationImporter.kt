@@ -23,6 +23,7 @@ import network.columba.app.data.db.entity.CustomThemeEntity
 import network.columba.app.data.db.entity.LocalIdentityEntity
 import network.columba.app.data.db.entity.MessageEntity
 import network.columba.app.data.db.entity.PeerIdentityEntity
+import network.columba.app.data.db.entity.ReactionEntity
 import network.columba.app.data.model.InterfaceType
 import network.columba.app.data.util.HashUtils
 import network.columba.app.repository.SettingsRepository
@@ -370,26 +371,36 @@ class MigrationImporter
             messages: List<MessageExport>,
             onProgress: (Float) -> Unit,
         ): Int {
+            val reactions = mutableListOf<ReactionEntity>()
             val entities =
                 messages.map { msg ->
                     // Bundles exported by older Columba builds carry
                     // reactions inside `fieldsJson.field16.reactions`
                     // and have no `reactionsJson` field; lift them out
-                    // on import so the row lands in the v2+ shape.
+                    // on import, then split the blob into `reactions` rows.
                     val (lifedFieldsJson, lifedReactionsJson) =
                         if (msg.reactionsJson != null) {
                             msg.fieldsJson to msg.reactionsJson
                         } else {
                             val fieldsJson = msg.fieldsJson
                             if (fieldsJson != null) {
-                                val split =
-                                    network.columba.app.data.db.ColumbaDatabase
-                                        .splitReactionsOutOfFieldsJson(fieldsJson)
+                                val split = ColumbaDatabase.splitReactionsOutOfFieldsJson(fieldsJson)
                                 if (split != null) split else fieldsJson to null
                             } else {
                                 null to null
                             }
                         }
+                    lifedReactionsJson?.let { blob ->
+                        ColumbaDatabase.splitReactionsJson(blob).mapTo(reactions) { (emoji, sender) ->
+                            ReactionEntity(
+                                messageId = msg.id,
+                                identityHash = msg.identityHash,
+                                emoji = emoji,
+                                sender = sender,
+                                timestamp = msg.timestamp,
+                            )
+                        }
+                    }
                     MessageEntity(
                         id = msg.id,
                         conversationHash = msg.conversationHash.lowercase(),
@@ -400,7 +411,6 @@ class MigrationImporter
                         status = msg.status,
                         isRead = msg.isRead,
                         fieldsJson = lifedFieldsJson,
-                        reactionsJson = lifedReactionsJson,
                     )
                 }
             val batches = entities.chunked(100)
@@ -410,7 +420,8 @@ class MigrationImporter
                 database.messageDao().insertMessagesIgnoreDuplicates(batch)
                 onProgress(0.5f + (0.2f * (batchIndex + 1) / batches.size))
             }
-            Log.d(TAG, "Imported ${entities.size} messages")
+            reactions.chunked(500).forEach { database.reactionDao().insertReactions(it) }
+            Log.d(TAG, "Imported ${entities.size} messages, ${reactions.size} reactions")
             return entities.size
         }
 
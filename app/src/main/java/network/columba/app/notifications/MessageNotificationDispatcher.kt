@@ -0,0 +1,157 @@
+package network.columba.app.notifications
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+
+/**
+ * One received message, as it will appear in a conversation notification.
+ */
+data class NotificationMessage(
+    val text: String,
+    val timestamp: Long,
+)
+
+/**
+ * What a conversation's notification shows: the latest messages (oldest
+ * first, at most [MessageNotificationDispatcher.MAX_HISTORY]) and how many
+ * have arrived since the conversation was last opened.
+ */
+data class ConversationNotification(
+    val destinationHash: String,
+    val peerName: String,
+    val messages: List<NotificationMessage>,
+    val messageCount: Int,
+)
+
+/**
+ * Coalesces received-message notifications.
+ *
+ * A propagation sync or reconnect can deliver hundreds of messages in a few
+ * seconds. Posting one notification per message gets rate-limited by the
+ * system (roughly 5 `notify` calls per second per app), so updates are
+ * silently dropped. Instead, messages are collected per conversation for
+ * [windowMs] after the first one arrives and then handed to [post] together.
+ *
+ * Each flush carries at most [maxConversationsPerFlush] conversations, and
+ * flushes are at least [minFlushIntervalMs] apart, so with the group summary
+ * a flush stays under the system limit. Conversations that don't fit wait
+ * for the next flush, in order of their first pending message.
+ *
+ * [post], [dismiss] and [clear] callbacks run under one lock, so a flush can
+ * never re-post a conversation that is being dismissed, nor a summary that is
+ * older than the one a dismissal just wrote.
+ *
+ * @param post Called with the conversations that changed (in arrival order)
+ *   and every conversation that currently has a notification (least
+ *   recently updated first), for the summary.
+ */
+class MessageNotificationDispatcher(
+    private val scope: CoroutineScope,
+    private val windowMs: Long = DEFAULT_WINDOW_MS,
+    private val minFlushIntervalMs: Long = DEFAULT_MIN_FLUSH_INTERVAL_MS,
+    private val maxConversationsPerFlush: Int = DEFAULT_MAX_CONVERSATIONS_PER_FLUSH,
+    private val post: (updated: List<ConversationNotification>, all: List<ConversationNotification>) -> Unit,
+) {
+    companion object {
+        const val DEFAULT_WINDOW_MS = 500L
+        const val DEFAULT_MIN_FLUSH_INTERVAL_MS = 1_000L
+
+        // Plus the summary: 5 notify calls per flush, one flush per second
+        const val DEFAULT_MAX_CONVERSATIONS_PER_FLUSH = 4
+
+        // Messages kept per conversation notification (MessagingStyle shows the tail)
+        const val MAX_HISTORY = 7
+    }
+
+    private class Pending(
+        var peerName: String,
+        val messages: MutableList<NotificationMessage> = mutableListOf(),
+    )
+
+    private val lock = Any()
+    private val pending = LinkedHashMap<String, Pending>()
+
+    // Access order: the most recently updated conversation is last
+    private val shown = LinkedHashMap<String, ConversationNotification>(16, 0.75f, true)
+    private var flushJob: Job? = null
+
+    /**
+     * Queue a message for its conversation's notification.
+     */
+    fun submit(
+        destinationHash: String,
+        peerName: String,
+        message: NotificationMessage,
+    ) {
+        synchronized(lock) {
+            val entry = pending.getOrPut(destinationHash) { Pending(peerName) }
+            entry.peerName = peerName
+            entry.messages.add(message)
+            if (flushJob == null) {
+                flushJob = scope.launch { runFlushes() }
+            }
+        }
+    }
+
+    /**
+     * Forget a conversation (it was opened, read, or its notification was
+     * swiped away). [onDismissed] runs under the lock with the remaining
+     * conversations, so the caller can cancel the notification and refresh
+     * the summary without racing a flush.
+     *
+     * @return the remaining conversations
+     */
+    fun dismiss(
+        destinationHash: String,
+        onDismissed: (remaining: List<ConversationNotification>) -> Unit = {},
+    ): List<ConversationNotification> =
+        synchronized(lock) {
+            pending.remove(destinationHash)
+            shown.remove(destinationHash)
+            shown.values.toList().also(onDismissed)
+        }
+
+    /**
+     * Forget every conversation, pending or shown. [onCleared] runs under the lock.
+     */
+    fun clear(onCleared: () -> Unit = {}) {
+        synchronized(lock) {
+            pending.clear()
+            shown.clear()
+            onCleared()
+        }
+    }
+
+    private suspend fun runFlushes() {
+        delay(windowMs)
+        while (true) {
+            synchronized(lock) {
+                if (pending.isEmpty()) {
+                    flushJob = null
+                    return
+                }
+                val updated = ArrayList<ConversationNotification>(maxConversationsPerFlush)
+                val iterator = pending.entries.iterator()
+                while (iterator.hasNext() && updated.size < maxConversationsPerFlush) {
+                    val (hash, entry) = iterator.next()
+                    iterator.remove()
+                    val previous = shown[hash]
+                    val merged =
+                        ConversationNotification(
+                            destinationHash = hash,
+                            peerName = entry.peerName,
+                            messages = ((previous?.messages ?: emptyList()) + entry.messages).takeLast(MAX_HISTORY),
+                            messageCount = (previous?.messageCount ?: 0) + entry.messages.size,
+                        )
+                    shown[hash] = merged
+                    updated.add(merged)
+                }
+                post(updated, shown.values.toList())
+            }
+            // Rate cap: nothing more is posted until the interval has passed
+            delay(minFlushIntervalMs)
+        }
+    }
+}
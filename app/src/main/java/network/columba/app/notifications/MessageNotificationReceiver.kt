@@ -0,0 +1,35 @@
+package network.columba.app.notifications
+
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.util.Log
+import dagger.hilt.android.EntryPointAccessors
+import network.columba.app.di.NotificationHelperEntryPoint
+
+/**
+ * BroadcastReceiver for message notification actions.
+ *
+ * Handles:
+ * - Dismiss: the user swiped a conversation notification away, so its
+ *   message history is dropped and the next message starts a fresh one
+ */
+class MessageNotificationReceiver : BroadcastReceiver() {
+    companion object {
+        private const val TAG = "MessageNotificationReceiver"
+    }
+
+    override fun onReceive(
+        context: Context,
+        intent: Intent,
+    ) {
+        if (intent.action != NotificationHelper.ACTION_DISMISS_CONVERSATION) return
+        val destinationHash = intent.getStringExtra(NotificationHelper.EXTRA_DESTINATION_HASH) ?: return
+
+        Log.d(TAG, "Conversation notification dismissed: ${destinationHash.take(16)}")
+        EntryPointAccessors
+            .fromApplication(context.applicationContext, NotificationHelperEntryPoint::class.java)
+            .notificationHelper()
+            .dismissConversation(destinationHash)
+    }
+}
@@ -12,14 +12,18 @@ import androidx.annotation.VisibleForTesting
 import androidx.core.app.ActivityCompat
 import androidx.core.app.NotificationCompat
 import androidx.core.app.NotificationManagerCompat
+import androidx.core.app.Person
 import androidx.lifecycle.Lifecycle
 import androidx.lifecycle.ProcessLifecycleOwner
 import network.columba.app.MainActivity
 import network.columba.app.R
 import network.columba.app.data.model.InterfaceType
+import network.columba.app.di.ApplicationScope
 import network.columba.app.repository.SettingsRepository
 import dagger.hilt.android.qualifiers.ApplicationContext
-import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.flow.filterNotNull
+import kotlinx.coroutines.launch
 import javax.inject.Inject
 import javax.inject.Singleton
 
@@ -34,6 +38,7 @@ class NotificationHelper
         @ApplicationContext private val context: Context,
         private val settingsRepository: SettingsRepository,
         private val activeConversationManager: network.columba.app.service.ActiveConversationManager,
+        @ApplicationScope private val scope: CoroutineScope,
     ) {
         companion object {
             // Notification channel IDs
@@ -43,12 +48,21 @@ class NotificationHelper
 
             // Notification IDs
             private const val NOTIFICATION_ID_MESSAGE = 1000
+            private const val NOTIFICATION_ID_MESSAGE_SUMMARY = 999
+
+            // Keeps per-conversation IDs in [NOTIFICATION_ID_MESSAGE, +2^30): non-negative,
+            // no overflow, so they can never land on the summary's ID
+            private const val MESSAGE_ID_HASH_MASK = 0x3FFFFFFF
             private const val NOTIFICATION_ID_ANNOUNCE = 2000
             private const val NOTIFICATION_ID_BLE = 3000
 
+            // Groups every conversation notification under one summary
+            private const val GROUP_KEY_MESSAGES = "network.columba.app.MESSAGES"
+
             // Intent actions
             const val ACTION_OPEN_ANNOUNCE = "network.columba.app.ACTION_OPEN_ANNOUNCE"
             const val ACTION_OPEN_CONVERSATION = "network.columba.app.ACTION_OPEN_CONVERSATION"
+            const val ACTION_DISMISS_CONVERSATION = "network.columba.app.ACTION_DISMISS_CONVERSATION"
             private const val ACTION_REPLY = "network.columba.app.ACTION_REPLY"
             private const val ACTION_MARK_READ = "network.columba.app.ACTION_MARK_READ"
 
@@ -59,6 +73,11 @@ class NotificationHelper
 
         private val notificationManager = NotificationManagerCompat.from(context)
 
+        private val selfPerson = Person.Builder().setName("You").build()
+
+        private val messageDispatcher =
+            MessageNotificationDispatcher(scope, post = ::postMessageNotifications)
+
         @VisibleForTesting
         internal var isAppInForeground: () -> Boolean = {
             ProcessLifecycleOwner
@@ -69,6 +88,30 @@ class NotificationHelper
 
         init {
             createNotificationChannels()
+
+            // Opening a conversation reads it: drop its history and notification
+            scope.launch {
+                activeConversationManager.activeConversation.filterNotNull().collect(::dismissConversation)
+            }
+            scope.launch {
+                activeConversationManager.readConversations.collect(::dismissConversation)
+            }
+        }
+
+        /**
+         * Withdraw a conversation's notification and forget its history, so the
+         * next message starts a fresh notification. Called when the conversation
+         * is opened or read, and when the user swipes the notification away.
+         */
+        fun dismissConversation(destinationHash: String) {
+            messageDispatcher.dismiss(destinationHash) { remaining ->
+                try {
+                    notificationManager.cancel(messageNotificationId(destinationHash))
+                    updateMessageSummary(remaining)
+                } catch (e: SecurityException) {
+                    // Permission was revoked
+                }
+            }
         }
 
         /**
@@ -129,6 +172,10 @@ class NotificationHelper
         /**
          * Post a notification for a received message.
          *
+         * Messages are batched per conversation by [messageDispatcher]: a burst
+         * becomes one MessagingStyle notification per conversation plus a
+         * summary, instead of one `notify` per message.
+         *
          * @param destinationHash The destination hash of the sender
          * @param peerName The display name of the sender
          * @param messagePreview Preview text of the message
@@ -140,19 +187,18 @@ class NotificationHelper
             messagePreview: String,
             isFavorite: Boolean,
         ) {
-            // Check master notification toggle
-            if (!settingsRepository.notificationsEnabledFlow.first()) return
+            // Cached; only the first call after start-up waits for DataStore
+            val settings = settingsRepository.currentSettings()
 
-            // Check specific notification preference
-            val generalMessageNotifications = settingsRepository.notificationReceivedMessageFlow.first()
-            val favoriteMessageNotifications = settingsRepository.notificationReceivedMessageFavoriteFlow.first()
+            // Check master notification toggle
+            if (!settings.notificationsEnabled) return
 
             val messageNotificationsEnabled =
                 if (isFavorite) {
                     // If it's a favorite, check both general messages and favorite messages
-                    generalMessageNotifications || favoriteMessageNotifications
+                    settings.notificationReceivedMessage || settings.notificationReceivedMessageFavorite
                 } else {
-                    generalMessageNotifications
+                    settings.notificationReceivedMessage
                 }
 
             if (!messageNotificationsEnabled) return
@@ -165,6 +211,70 @@ class NotificationHelper
             // the conversation, so they should still receive the notification.
             if (isAppInForeground() && activeConversationManager.activeConversation.value == destinationHash) return
 
+            messageDispatcher.submit(
+                destinationHash,
+                peerName,
+                NotificationMessage(messagePreview, System.currentTimeMillis()),
+            )
+        }
+
+        private fun messageNotificationId(destinationHash: String) =
+            NOTIFICATION_ID_MESSAGE + (destinationHash.hashCode() and MESSAGE_ID_HASH_MASK)
+
+        /**
+         * Post one MessagingStyle notification per updated conversation, then
+         * the inbox summary (or cancel it once fewer than two remain).
+         */
+        private fun postMessageNotifications(
+            updated: List<ConversationNotification>,
+            all: List<ConversationNotification>,
+        ) {
+            try {
+                updated.forEach { conversation ->
+                    notificationManager.notify(
+                        messageNotificationId(conversation.destinationHash),
+                        buildConversationNotification(conversation),
+                    )
+                }
+                updateMessageSummary(all)
+            } catch (e: SecurityException) {
+                // Permission was revoked
+            }
+        }
+
+        private fun updateMessageSummary(all: List<ConversationNotification>) {
+            if (all.size < 2) {
+                notificationManager.cancel(NOTIFICATION_ID_MESSAGE_SUMMARY)
+                return
+            }
+            val total = all.sumOf { it.messageCount }
+            val style =
+                NotificationCompat
+                    .InboxStyle()
+                    .setSummaryText("$total messages from ${all.size} chats")
+            // Most recently updated first
+            all.asReversed().forEach { conversation ->
+                style.addLine("${conversation.peerName}: ${conversation.messages.lastOrNull()?.text.orEmpty()}")
+            }
+            val summary =
+                NotificationCompat
+                    .Builder(context, CHANNEL_ID_MESSAGES)
+                    .setSmallIcon(R.mipmap.ic_launcher)
+                    .setContentTitle("$total new messages")
+                    .setContentText(all.asReversed().joinToString { it.peerName })
+                    .setStyle(style)
+                    .setCategory(NotificationCompat.CATEGORY_MESSAGE)
+                    .setGroup(GROUP_KEY_MESSAGES)
+                    .setGroupSummary(true)
+                    .setGroupAlertBehavior(NotificationCompat.GROUP_ALERT_CHILDREN)
+                    .setAutoCancel(true)
+                    .build()
+            notificationManager.notify(NOTIFICATION_ID_MESSAGE_SUMMARY, summary)
+        }
+
+        private fun buildConversationNotification(conversation: ConversationNotification): android.app.Notification {
+            val destinationHash = conversation.destinationHash
+
             // Create intent to open the conversation
             // Use SINGLE_TOP to reuse existing activity via onNewIntent (avoids splash screen flash)
             val openIntent =
@@ -172,7 +282,7 @@ class NotificationHelper
                     flags = Intent.FLAG_ACTIVITY_NEW_TASK or Intent.FLAG_ACTIVITY_SINGLE_TOP
                     action = ACTION_OPEN_CONVERSATION
                     putExtra(EXTRA_DESTINATION_HASH, destinationHash)
-                    putExtra(EXTRA_PEER_NAME, peerName)
+                    putExtra(EXTRA_PEER_NAME, conversation.peerName)
                 }
 
             val openPendingIntent =
@@ -183,25 +293,45 @@ class NotificationHelper
                     PendingIntent.FLAG_UPDATE_CURRENT or PendingIntent.FLAG_IMMUTABLE,
                 )
 
-            // Create notification
-            val notification =
-                NotificationCompat
-                    .Builder(context, CHANNEL_ID_MESSAGES)
-                    .setSmallIcon(R.mipmap.ic_launcher)
-                    .setContentTitle(peerName)
-                    .setContentText(messagePreview)
-                    .setPriority(NotificationCompat.PRIORITY_HIGH)
-                    .setCategory(NotificationCompat.CATEGORY_MESSAGE)
-                    .setAutoCancel(true)
-                    .setContentIntent(openPendingIntent)
-                    .build()
+            // Swiping the notification away forgets its history
+            val dismissIntent =
+                Intent(context, MessageNotificationReceiver::class.java).apply {
+                    action = ACTION_DISMISS_CONVERSATION
+                    putExtra(EXTRA_DESTINATION_HASH, destinationHash)
+                }
+            val dismissPendingIntent =
+                PendingIntent.getBroadcast(
+                    context,
+                    destinationHash.hashCode(),
+                    dismissIntent,
+                    PendingIntent.FLAG_UPDATE_CURRENT or PendingIntent.FLAG_IMMUTABLE,
+                )
 
-            val notificationId = NOTIFICATION_ID_MESSAGE + destinationHash.hashCode()
-            try {
-                notificationManager.notify(notificationId, notification)
-            } catch (e: SecurityException) {
-                // Permission was revoked
+            val sender =
+                Person
+                    .Builder()
+                    .setName(conversation.peerName)
+                    .setKey(destinationHash)
+                    .build()
+            val style = NotificationCompat.MessagingStyle(selfPerson)
+            conversation.messages.forEach { message ->
+                style.addMessage(message.text, message.timestamp, sender)
             }
+
+            return NotificationCompat
+                .Builder(context, CHANNEL_ID_MESSAGES)
+                .setSmallIcon(R.mipmap.ic_launcher)
+                .setContentTitle(conversation.peerName)
+                .setContentText(conversation.messages.lastOrNull()?.text)
+                .setStyle(style)
+                .setNumber(conversation.messageCount)
+                .setPriority(NotificationCompat.PRIORITY_HIGH)
+                .setCategory(NotificationCompat.CATEGORY_MESSAGE)
+                .setGroup(GROUP_KEY_MESSAGES)
+                .setAutoCancel(true)
+                .setContentIntent(openPendingIntent)
+                .setDeleteIntent(dismissPendingIntent)
+                .build()
         }
 
         /**
@@ -232,18 +362,15 @@ class NotificationHelper
             hops: Int,
             interfaceType: InterfaceType,
         ): Boolean {
-            val notificationsEnabled = settingsRepository.notificationsEnabledFlow.first()
-            val announceEnabled = settingsRepository.notificationHeardAnnounceFlow.first()
-            val directOnly = settingsRepository.notificationAnnounceDirectOnlyFlow.first()
-            val excludeTcp = settingsRepository.notificationAnnounceExcludeTcpFlow.first()
+            val settings = settingsRepository.currentSettings()
 
             val passesFilters =
-                notificationsEnabled &&
-                    announceEnabled &&
+                settings.notificationsEnabled &&
+                    settings.notificationHeardAnnounce &&
                     // Direct-only: hops == 1 means direct neighbor
-                    !(directOnly && hops != 1) &&
+                    !(settings.notificationAnnounceDirectOnly && hops != 1) &&
                     // TCP exclusion filter
-                    !(excludeTcp && interfaceType == InterfaceType.TCP_CLIENT)
+                    !(settings.notificationAnnounceExcludeTcp && interfaceType == InterfaceType.TCP_CLIENT)
 
             return passesFilters && hasNotificationPermission()
         }
@@ -321,13 +448,13 @@ class NotificationHelper
             peerAddress: String,
             peerName: String? = null,
         ) {
+            val settings = settingsRepository.currentSettings()
+
             // Check master notification toggle
-            val notificationsEnabled = settingsRepository.notificationsEnabledFlow.first()
-            if (!notificationsEnabled) return
+            if (!settings.notificationsEnabled) return
 
             // Check specific notification preference
-            val bleConnectedEnabled = settingsRepository.notificationBleConnectedFlow.first()
-            if (!bleConnectedEnabled) return
+            if (!settings.notificationBleConnected) return
 
             // Check permission
             if (!hasNotificationPermission()) return
@@ -366,13 +493,13 @@ class NotificationHelper
             peerAddress: String,
             peerName: String? = null,
         ) {
+            val settings = settingsRepository.currentSettings()
+
             // Check master notification toggle
-            val notificationsEnabled = settingsRepository.notificationsEnabledFlow.first()
-            if (!notificationsEnabled) return
+            if (!settings.notificationsEnabled) return
 
             // Check specific notification preference
-            val bleDisconnectedEnabled = settingsRepository.notificationBleDisconnectedFlow.first()
-            if (!bleDisconnectedEnabled) return
+            if (!settings.notificationBleDisconnected) return
 
             // Check permission
             if (!hasNotificationPermission()) return
@@ -414,6 +541,6 @@ class NotificationHelper
          * Cancel all notifications.
          */
         fun cancelAllNotifications() {
-            notificationManager.cancelAll()
+            messageDispatcher.clear { notificationManager.cancelAll() }
         }
     }
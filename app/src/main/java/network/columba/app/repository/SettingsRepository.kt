@@ -19,18 +19,25 @@ import androidx.datastore.preferences.core.stringPreferencesKey
 import androidx.datastore.preferences.core.stringSetPreferencesKey
 import androidx.datastore.preferences.preferencesDataStore
 import dagger.hilt.android.qualifiers.ApplicationContext
+import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.channels.awaitClose
 import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.SharingStarted
+import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.callbackFlow
 import kotlinx.coroutines.flow.distinctUntilChanged
+import kotlinx.coroutines.flow.filterNotNull
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.flow.flatMapLatest
 import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.flow.stateIn
 import network.columba.app.data.model.ImageCompressionPreset
 import network.columba.app.data.model.MapStylePreference
 import network.columba.app.data.repository.CustomThemeRepository
+import network.columba.app.di.ApplicationScope
 import network.columba.app.rns.api.model.BatteryProfile
+import network.columba.app.rns.host.persistence.CrossProcessSettingsSignal
 import network.columba.app.rns.host.persistence.ServiceSettingsAccessor
 import network.columba.app.ui.theme.AppTheme
 import network.columba.app.ui.theme.CustomTheme
@@ -54,6 +61,7 @@ class SettingsRepository
     constructor(
         @ApplicationContext private val context: Context,
         private val customThemeRepository: CustomThemeRepository,
+        @ApplicationScope private val scope: CoroutineScope,
     ) {
         private object PreferencesKeys {
             // Notification preferences
@@ -187,9 +195,13 @@ class SettingsRepository
                 Context.MODE_MULTI_PROCESS,
             )
 
+        private val crossProcessSignal = CrossProcessSettingsSignal(context)
+
         /**
          * Creates a Flow that observes a Long value from cross-process SharedPreferences.
-         * Uses OnSharedPreferenceChangeListener to emit updates reactively.
+         * Uses OnSharedPreferenceChangeListener for writes made in this process, and
+         * [CrossProcessSettingsSignal] for writes made by the service process (the
+         * listener never hears those).
          */
         private fun crossProcessLongFlow(key: String): Flow<Long?> =
             callbackFlow {
@@ -209,11 +221,67 @@ class SettingsRepository
                     }
                 prefs.registerOnSharedPreferenceChangeListener(listener)
 
+                // The file changed on disk; re-fetching with MODE_MULTI_PROCESS reloads it
+                val fileWatch =
+                    crossProcessSignal.watch {
+                        trySend(getCrossProcessPrefs().getLong(key, -1L).takeIf { it != -1L })
+                    }
+
                 awaitClose {
                     prefs.unregisterOnSharedPreferenceChangeListener(listener)
+                    fileWatch?.close()
                 }
             }.distinctUntilChanged()
 
+        // Settings snapshot
+
+        /**
+         * Every per-event setting as one [SettingsSnapshot], rebuilt once per DataStore
+         * change and held hot in the application scope. Null only until the DataStore
+         * has been read for the first time; use [currentSettings] to wait for that.
+         */
+        val settingsSnapshot: StateFlow<SettingsSnapshot?> =
+            context.dataStore.data
+                .map { preferences -> preferences.toSettingsSnapshot() }
+                .distinctUntilChanged()
+                .stateIn(scope, SharingStarted.Eagerly, null)
+
+        /**
+         * The current [settingsSnapshot]; only suspends before the first DataStore read.
+         */
+        suspend fun currentSettings(): SettingsSnapshot = settingsSnapshot.value ?: settingsSnapshot.filterNotNull().first()
+
+        private fun Preferences.toSettingsSnapshot(): SettingsSnapshot {
+            val defaults = SettingsSnapshot()
+            return SettingsSnapshot(
+                notificationsEnabled = this[PreferencesKeys.NOTIFICATIONS_ENABLED] ?: defaults.notificationsEnabled,
+                notificationReceivedMessage =
+                    this[PreferencesKeys.NOTIFICATION_RECEIVED_MESSAGE] ?: defaults.notificationReceivedMessage,
+                notificationReceivedMessageFavorite =
+                    this[PreferencesKeys.NOTIFICATION_RECEIVED_MESSAGE_FAVORITE]
+                        ?: defaults.notificationReceivedMessageFavorite,
+                notificationHeardAnnounce =
+                    this[PreferencesKeys.NOTIFICATION_HEARD_ANNOUNCE] ?: defaults.notificationHeardAnnounce,
+                notificationAnnounceDirectOnly =
+                    this[PreferencesKeys.NOTIFICATION_ANNOUNCE_DIRECT_ONLY] ?: defaults.notificationAnnounceDirectOnly,
+                notificationAnnounceExcludeTcp =
+                    this[PreferencesKeys.NOTIFICATION_ANNOUNCE_EXCLUDE_TCP] ?: defaults.notificationAnnounceExcludeTcp,
+                notificationBleConnected =
+                    this[PreferencesKeys.NOTIFICATION_BLE_CONNECTED] ?: defaults.notificationBleConnected,
+                notificationBleDisconnected =
+                    this[PreferencesKeys.NOTIFICATION_BLE_DISCONNECTED] ?: defaults.notificationBleDisconnected,
+                autoAnnounceEnabled = this[PreferencesKeys.AUTO_ANNOUNCE_ENABLED] ?: defaults.autoAnnounceEnabled,
+                autoAnnounceIntervalHours =
+                    this[PreferencesKeys.AUTO_ANNOUNCE_INTERVAL_HOURS] ?: defaults.autoAnnounceIntervalHours,
+                blockUnknownSenders = this[PreferencesKeys.BLOCK_UNKNOWN_SENDERS] ?: defaults.blockUnknownSenders,
+                allowCallsFromContactsOnly =
+                    this[PreferencesKeys.ALLOW_CALLS_FROM_CONTACTS_ONLY] ?: defaults.allowCallsFromContactsOnly,
+                allowVoiceCalls = this[PreferencesKeys.ALLOW_VOICE_CALLS] ?: defaults.allowVoiceCalls,
+                locationSharingEnabled =
+                    this[PreferencesKeys.LOCATION_SHARING_ENABLED] ?: defaults.locationSharingEnabled,
+            )
+        }
+
         // Notification preferences
 
         /**
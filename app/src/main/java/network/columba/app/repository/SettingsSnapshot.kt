@@ -0,0 +1,33 @@
+package network.columba.app.repository
+
+/**
+ * Immutable view of the settings that are checked per event (incoming message,
+ * heard announce, BLE peer change, call) rather than per screen.
+ *
+ * Published by [SettingsRepository.settingsSnapshot], which builds one of these
+ * per DataStore change. Hot paths read a field off the current value instead of
+ * calling `.first()` on several individual flows, each of which waits on the
+ * DataStore and maps the whole preferences map again.
+ *
+ * Defaults match the individual `*Flow` properties on [SettingsRepository].
+ */
+data class SettingsSnapshot(
+    // Notifications
+    val notificationsEnabled: Boolean = true,
+    val notificationReceivedMessage: Boolean = true,
+    val notificationReceivedMessageFavorite: Boolean = true,
+    val notificationHeardAnnounce: Boolean = false,
+    val notificationAnnounceDirectOnly: Boolean = true,
+    val notificationAnnounceExcludeTcp: Boolean = true,
+    val notificationBleConnected: Boolean = false,
+    val notificationBleDisconnected: Boolean = false,
+    // Auto-announce
+    val autoAnnounceEnabled: Boolean = true,
+    val autoAnnounceIntervalHours: Int = 3,
+    // Privacy
+    val blockUnknownSenders: Boolean = false,
+    val allowCallsFromContactsOnly: Boolean = false,
+    val allowVoiceCalls: Boolean = true,
+    // Location
+    val locationSharingEnabled: Boolean = false,
+)
@@ -1,7 +1,10 @@
 package network.columba.app.service
 
+import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.flow.asStateFlow
 import javax.inject.Inject
 import javax.inject.Singleton
@@ -27,6 +30,14 @@ class ActiveConversationManager
          */
         val activeConversation: StateFlow<String?> = _activeConversation.asStateFlow()
 
+        private val _readConversations = MutableSharedFlow<String>(extraBufferCapacity = READ_BUFFER_CAPACITY)
+
+        /**
+         * Destination hashes of conversations that were just marked as read,
+         * so their notifications can be withdrawn.
+         */
+        val readConversations: SharedFlow<String> = _readConversations.asSharedFlow()
+
         /**
          * Sets the currently active conversation.
          *
@@ -36,4 +47,18 @@ class ActiveConversationManager
         fun setActive(destinationHash: String?) {
             _activeConversation.value = destinationHash
         }
+
+        /**
+         * Reports that a conversation was marked as read.
+         *
+         * @param destinationHash The destination hash of the conversation
+         */
+        fun markRead(destinationHash: String) {
+            _readConversations.tryEmit(destinationHash)
+        }
+
+        private companion object {
+            // Marks arrive one per received message while a chat is open
+            const val READ_BUFFER_CAPACITY = 16
+        }
     }
@@ -1,6 +1,5 @@
 package network.columba.app.service
 
-import android.util.Log
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.SupervisorJob
@@ -18,6 +17,9 @@ import network.columba.app.data.repository.IdentityRepository
 import network.columba.app.notifications.NotificationHelper
 import network.columba.app.rns.api.RnsCore
 import network.columba.app.rns.api.RnsLxmf
+import network.columba.app.rns.api.model.ReceivedMessage
+import network.columba.app.rns.api.util.RingLog
+import network.columba.app.rns.api.util.toHex
 import network.columba.app.rns.host.util.PeerNameResolver
 import java.util.concurrent.ConcurrentHashMap
 import javax.inject.Inject
@@ -31,12 +33,12 @@ import network.columba.app.data.repository.Message as DataMessage
  *
  * This solves the issue where data was only collected when specific screens were active.
  *
- * Note: As of the service-side persistence implementation, announces and messages are now
- * primarily persisted by ServicePersistenceManager in the :reticulum service process.
- * This collector serves as a fallback/safety net and handles:
+ * Note: Inbound messages are persisted by the :reticulum service process, which owns
+ * de-duplication and tags each event it forwards with `persisted` / `isDuplicate` /
+ * `resolvedPeerName`. For those this collector only handles:
  * - Notifications for new messages/announces
- * - UI updates via repository flows
- * - De-duplication to avoid double-persistence
+ * - Peer activity ("last seen")
+ * Messages the service did not store arrive with `persisted = false` and are saved here.
  */
 @Singleton
 class MessageCollector
@@ -54,15 +56,11 @@ class MessageCollector
     ) {
         companion object {
             private const val TAG = "MessageCollector"
-            private const val PRESEED_WINDOW_MS = 30L * 24 * 60 * 60 * 1000 // 30 days
         }
 
         // Application-scoped coroutine for background message collection
         private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
 
-        // Track processed message IDs to avoid duplicates
-        private val processedMessageIds = ConcurrentHashMap.newKeySet<String>()
-
         // Map of peer hashes to names (populated from announces)
         private val peerNames = ConcurrentHashMap<String, String>()
 
@@ -77,242 +75,28 @@ class MessageCollector
          */
         fun startCollecting() {
             if (isStarted) {
-                Log.w(TAG, "Message collection already started")
+                RingLog.w(TAG) { "Message collection already started" }
                 return
             }
 
             isStarted = true
-            Log.i(TAG, "Starting message collection service")
+            RingLog.i(TAG) { "Starting message collection service" }
 
             // Collect messages from the Reticulum protocol
             scope.launch {
-                // Pre-seed processedMessageIds with recent received messages from the DB.
-                // This prevents duplicate notifications when messages are replayed via SharedFlow
-                // or re-broadcast by drainPendingMessages() after a service restart.
-                // Bounded to last 30 days to avoid unbounded memory growth.
-                // Done inside the collection coroutine to ensure it completes before we subscribe.
-                try {
-                    val thirtyDaysAgo = System.currentTimeMillis() - PRESEED_WINDOW_MS
-                    val existingIds = conversationRepository.getReceivedMessageIds(since = thirtyDaysAgo)
-                    processedMessageIds.addAll(existingIds)
-                    Log.i(TAG, "Pre-seeded ${existingIds.size} existing message IDs for notification dedup")
-                } catch (e: Exception) {
-                    Log.w(TAG, "Failed to pre-seed message IDs - duplicate notifications may occur", e)
-                }
-
                 try {
                     rnsLxmf.observeMessages().collect { receivedMessage ->
-                        // De-duplicate: Skip if we've already processed this message in-memory
-                        if (receivedMessage.messageHash in processedMessageIds) {
-                            Log.d(TAG, "Skipping duplicate message ${receivedMessage.messageHash.take(16)} (in-memory cache)")
-                            return@collect
-                        }
-
-                        // De-duplicate: Check if message already exists in database
-                        // (may have been persisted by ServicePersistenceManager in service process)
-                        val existingMessage = conversationRepository.getMessageById(receivedMessage.messageHash)
-                        if (existingMessage != null) {
-                            processedMessageIds.add(receivedMessage.messageHash) // Add to cache to avoid repeat DB checks
-                            Log.d(TAG, "Message ${receivedMessage.messageHash.take(16)} already in database - checking if notification needed")
-
-                            // Even though message is persisted, we may still need to show notification
-                            // and save icon appearance (service process can't do these)
-                            val sourceHash = receivedMessage.sourceHash.joinToString("") { "%02x".format(it) }
-                            val peerName = getPeerNameWithFallback(sourceHash)
-
-                            // Save icon appearance even for already-persisted messages
-                            // (ServicePersistenceManager doesn't have access to icon data)
-                            receivedMessage.iconAppearance?.let { appearance ->
-                                if (appearance.iconName.isNotEmpty() &&
-                                    appearance.foregroundColor.isNotEmpty() &&
-                                    appearance.backgroundColor.isNotEmpty()
-                                ) {
-                                    try {
-                                        peerIconDao.upsertIcon(
-                                            PeerIconEntity(
-                                                destinationHash = sourceHash,
-                                                iconName = appearance.iconName,
-                                                foregroundColor = appearance.foregroundColor,
-                                                backgroundColor = appearance.backgroundColor,
-                                                updatedTimestamp = System.currentTimeMillis(),
-                                            ),
-                                        )
-                                        Log.d(TAG, "Saved icon appearance for $sourceHash: ${appearance.iconName} (from duplicate message)")
-                                    } catch (e: Exception) {
-                                        Log.w(TAG, "Failed to save icon appearance for $sourceHash", e)
-                                    }
-                                }
-                            }
-
-                            val isFavorite =
-                                try {
-                                    announceRepository.getAnnounce(sourceHash)?.isFavorite ?: false
-                                } catch (e: Exception) {
-                                    Log.w(TAG, "Could not check if peer is favorite", e)
-                                    false
-                                }
-
-                            // Only notify if the message hasn't been read yet
-                            // This prevents duplicate notifications after service restart
-                            // for messages the user has already seen
-                            if (!existingMessage.isRead) {
-                                try {
-                                    notificationHelper.notifyMessageReceived(
-                                        destinationHash = sourceHash,
-                                        peerName = peerName,
-                                        messagePreview = receivedMessage.content.take(100),
-                                        isFavorite = isFavorite,
-                                    )
-                                    Log.d(TAG, "Posted notification for already-persisted unread message")
-                                } catch (e: Exception) {
-                                    Log.e(TAG, "Failed to post notification for already-persisted message", e)
-                                }
-                            } else {
-                                Log.d(TAG, "Skipping notification for already-read message ${receivedMessage.messageHash.take(16)}")
-                            }
-
-                            // Record peer activity for "last seen" status
-                            // Receiving a message proves the peer was recently online
-                            conversationLinkManager.recordPeerActivity(sourceHash)
-
-                            return@collect
-                        }
-
-                        // CRITICAL: Verify the message was sent to the current active identity
-                        // This prevents messages from being saved to the wrong identity after switching
-                        val activeIdentity = identityRepository.getActiveIdentitySync()
-                        if (activeIdentity == null) {
-                            Log.w(TAG, "No active identity - skipping message")
-                            return@collect
-                        }
-
-                        val messageDestHash = receivedMessage.destinationHash.joinToString("") { "%02x".format(it) }
-                        if (messageDestHash != activeIdentity.destinationHash) {
-                            Log.w(
-                                TAG,
-                                "Message destination $messageDestHash doesn't match active identity " +
-                                    "${activeIdentity.destinationHash} - skipping (sent to different identity)",
-                            )
-                            return@collect
-                        }
-
-                        processedMessageIds.add(receivedMessage.messageHash)
-                        _messagesCollected.value++
-
-                        val sourceHash = receivedMessage.sourceHash.joinToString("") { "%02x".format(it) }
-                        Log.d(TAG, "Received new message #${_messagesCollected.value} from $sourceHash")
-
-                        // Create data message for storage
-                        val now = System.currentTimeMillis()
-                        val dataMessage =
-                            DataMessage(
-                                id = receivedMessage.messageHash,
-                                // From sender's perspective
-                                destinationHash = sourceHash,
-                                content = receivedMessage.content,
-                                // Use sender's timestamp for display; receivedAt for sort ordering
-                                timestamp = receivedMessage.timestamp,
-                                isFromMe = false,
-                                status = "delivered",
-                                // LXMF attachments
-                                fieldsJson = receivedMessage.fieldsJson,
-                                // Routing info (hop count and receiving interface)
-                                receivedHopCount = receivedMessage.receivedHopCount,
-                                receivedInterface = receivedMessage.receivedInterface,
-                                // Signal quality metrics (RNode/BLE; null on TCP/Auto/propagated)
-                                receivedRssi = receivedMessage.receivedRssi,
-                                receivedSnr = receivedMessage.receivedSnr,
-                                // LXMF delivery method ("opportunistic" / "direct" / "propagated"
-                                // / "paper"). Surfaced in MessageDetailScreen for received
-                                // messages — most of the path-info cards (hop count, interface,
-                                // RSSI/SNR) are null for propagation-fetched messages, so
-                                // without this the detail screen renders essentially empty.
-                                deliveryMethod = receivedMessage.deliveryMethod,
-                                // Local reception time for sort ordering
-                                receivedAt = now,
-                            )
-
-                        // Get peer name from cache, existing conversation, or use formatted hash
-                        val peerName = getPeerNameWithFallback(sourceHash)
-
-                        // Save to database - this creates/updates the conversation and adds the message
-                        try {
-                            // Prefer public key from message (directly from RNS identity cache)
-                            // Fall back to peer_identities lookup if not in message
-                            val messagePublicKey = receivedMessage.publicKey
-                            val publicKey =
-                                messagePublicKey
-                                    ?: conversationRepository.getPeerPublicKey(sourceHash)
-
-                            // Store public key to peer_identities if we got it from the message
-                            // This ensures future lookups will find it
-                            if (messagePublicKey != null) {
-                                conversationRepository.updatePeerPublicKey(sourceHash, messagePublicKey)
-                                Log.d(TAG, "Stored sender's public key for $sourceHash")
-                            }
-
-                            // Store sender's icon appearance if present (Sideband/MeshChat interop)
-                            // Icons are stored in peer_icons table (LXMF concept), separate from announces (Reticulum concept)
-                            receivedMessage.iconAppearance?.let { appearance ->
-                                if (appearance.iconName.isNotEmpty() &&
-                                    appearance.foregroundColor.isNotEmpty() &&
-                                    appearance.backgroundColor.isNotEmpty()
-                                ) {
-                                    try {
-                                        peerIconDao.upsertIcon(
-                                            PeerIconEntity(
-                                                destinationHash = sourceHash,
-                                                iconName = appearance.iconName,
-                                                foregroundColor = appearance.foregroundColor,
-                                                backgroundColor = appearance.backgroundColor,
-                                                updatedTimestamp = System.currentTimeMillis(),
-                                            ),
-                                        )
-                                        Log.d(TAG, "Saved icon appearance for $sourceHash: ${appearance.iconName}")
-                                    } catch (e: Exception) {
-                                        Log.w(TAG, "Failed to save icon appearance for $sourceHash", e)
-                                    }
-                                }
-                            }
-
-                            conversationRepository.saveMessage(sourceHash, peerName, dataMessage, publicKey)
-                            Log.d(TAG, "Message saved to database for peer ${sourceHash.take(16)} (hasPublicKey=${publicKey != null})")
-
-                            // Record peer activity for "last seen" status
-                            // Receiving a message proves the peer was recently online
-                            conversationLinkManager.recordPeerActivity(sourceHash)
-
-                            // Check if sender is a saved peer (favorite)
-                            val isFavorite =
-                                try {
-                                    announceRepository.getAnnounce(sourceHash)?.isFavorite ?: false
-                                } catch (e: Exception) {
-                                    Log.w(TAG, "Could not check if peer is favorite", e)
-                                    false
-                                }
-
-                            // Show notification for received message
-                            try {
-                                notificationHelper.notifyMessageReceived(
-                                    destinationHash = sourceHash,
-                                    peerName = peerName,
-                                    // Truncate preview
-                                    messagePreview = receivedMessage.content.take(100),
-                                    isFavorite = isFavorite,
-                                )
-                                Log.d(TAG, "Posted notification for message (favorite: $isFavorite)")
-                            } catch (e: Exception) {
-                                Log.e(TAG, "Failed to post message notification", e)
-                            }
-                        } catch (e: Exception) {
-                            Log.e(TAG, "Failed to save message to database", e)
+                        if (receivedMessage.persisted) {
+                            handleServicePersistedMessage(receivedMessage)
+                        } else {
+                            saveAndNotify(receivedMessage)
                         }
                     }
                 } catch (e: Exception) {
-                    Log.e(TAG, "Error in message collection loop", e)
+                    RingLog.e(TAG, e) { "Error in message collection loop" }
                     // Restart collection after error
                     if (isStarted) {
-                        Log.w(TAG, "Restarting message collection after error")
+                        RingLog.w(TAG) { "Restarting message collection after error" }
                         isStarted = false
                         startCollecting()
                     }
@@ -325,10 +109,10 @@ class MessageCollector
                     rnsCore.observeAnnounces().collect { announce ->
                         // Conversations are keyed by destination hash (LXMF destination)
                         // But we also need the identity hash for some operations
-                        val destinationHash = announce.destinationHash.joinToString("") { "%02x".format(it) }
-                        val identityHash = announce.identity.hash.joinToString("") { "%02x".format(it) }
+                        val destinationHash = announce.destinationHash.toHex()
+                        val identityHash = announce.identity.hash.toHex()
 
-                        Log.d(TAG, "Processing announce: destHash=$destinationHash, identityHash=$identityHash")
+                        RingLog.d(TAG) { "Processing announce: destHash=$destinationHash, identityHash=$identityHash" }
 
                         // Store the public key mapped to the IDENTITY hash (for Reticulum identity restoration)
                         // Note: Conversations are keyed by destination hash, but peer identities use identity hash
@@ -339,9 +123,9 @@ class MessageCollector
                                 // CRITICAL: Use identity hash for peer identity storage, not destination hash
                                 // This allows Reticulum to properly restore identities (hash must match public key)
                                 conversationRepository.updatePeerPublicKey(identityHash, publicKey)
-                                Log.d(TAG, "Stored public key for peer identity: $identityHash (${publicKey.size} bytes)")
+                                RingLog.d(TAG) { "Stored public key for peer identity: $identityHash (${publicKey.size} bytes)" }
                             } catch (e: Exception) {
-                                Log.w(TAG, "Could not store public key for peer", e)
+                                RingLog.w(TAG, e) { "Could not store public key for peer" }
                             }
                         }
 
@@ -358,7 +142,7 @@ class MessageCollector
                         // Cache and update peer name if successfully extracted
                         if (PeerNameResolver.isValidPeerName(peerName)) {
                             peerNames[peerHash] = peerName
-                            Log.d(TAG, "Learned peer name for ${peerHash.take(16)}")
+                            RingLog.d(TAG) { "Learned peer name for ${peerHash.take(16)}" }
 
                             // Update existing conversation with the new name
                             conversationRepository.updatePeerName(peerHash, peerName)
@@ -395,7 +179,7 @@ class MessageCollector
                                 existingAnnounce.lastSeenTimestamp > fiveSecondsAgo &&
                                 !needsTransferLimitUpdate
                             ) {
-                                Log.d(TAG, "Announce already persisted by service: ${peerHash.take(16)}")
+                                RingLog.d(TAG) { "Announce already persisted by service: ${peerHash.take(16)}" }
                             } else {
                                 announceRepository.saveAnnounce(
                                     destinationHash = peerHash,
@@ -413,11 +197,10 @@ class MessageCollector
                                     peeringCost = announce.peeringCost,
                                     propagationTransferLimitKb = propagationTransferLimitKb,
                                 )
-                                Log.d(
-                                    TAG,
+                                RingLog.d(TAG) {
                                     "Persisted announce to database (fallback): ${peerHash.take(16)}" +
-                                        if (propagationTransferLimitKb != null) " (transfer limit: ${propagationTransferLimitKb}KB)" else "",
-                                )
+                                        if (propagationTransferLimitKb != null) " (transfer limit: ${propagationTransferLimitKb}KB)" else ""
+                                }
                             }
 
                             // Check if this announce resolves a pending contact
@@ -426,10 +209,10 @@ class MessageCollector
                                     val pendingContact = contactRepository.getContact(peerHash)
                                     if (pendingContact?.status == ContactStatus.PENDING_IDENTITY) {
                                         contactRepository.updateContactWithIdentity(peerHash, publicKey)
-                                        Log.i(TAG, "Resolved pending contact from announce: $peerHash")
+                                        RingLog.i(TAG) { "Resolved pending contact from announce: $peerHash" }
                                     }
                                 } catch (e: Exception) {
-                                    Log.w(TAG, "Error checking/updating pending contact", e)
+                                    RingLog.w(TAG, e) { "Error checking/updating pending contact" }
                                 }
                             }
 
@@ -442,20 +225,227 @@ class MessageCollector
                                     interfaceType = InterfaceType.fromName(announce.receivingInterface),
                                     receivingInterface = announce.receivingInterface,
                                 )
-                                Log.d(TAG, "Posted notification for announce")
+                                RingLog.d(TAG) { "Posted notification for announce" }
                             } catch (e: Exception) {
-                                Log.e(TAG, "Failed to post announce notification", e)
+                                RingLog.e(TAG, e) { "Failed to post announce notification" }
                             }
                         } catch (e: Exception) {
-                            Log.e(TAG, "Failed to persist announce to database", e)
+                            RingLog.e(TAG, e) { "Failed to persist announce to database" }
                         }
                     }
                 } catch (e: Exception) {
-                    Log.e(TAG, "Error observing announces for names", e)
+                    RingLog.e(TAG, e) { "Error observing announces for names" }
                 }
             }
         }
 
+        /**
+         * Handle a message the service has already written (the normal path).
+         *
+         * The :reticulum process owns inbound persistence and de-duplication, so
+         * there is nothing to check here: replays of read messages arrive flagged
+         * [ReceivedMessage.isDuplicate] and are ignored, while new messages and unread
+         * replays carry the conversation's resolved name and notify.
+         */
+        private suspend fun handleServicePersistedMessage(receivedMessage: ReceivedMessage) {
+            if (receivedMessage.isDuplicate) {
+                RingLog.d(TAG) { "Skipping duplicate message ${receivedMessage.messageHash.take(16)} (already stored)" }
+                return
+            }
+
+            _messagesCollected.value++
+            val sourceHash = receivedMessage.sourceHash.toHex()
+            RingLog.d(TAG) { "Received new message #${_messagesCollected.value} from $sourceHash (persisted by service)" }
+
+            val peerName =
+                receivedMessage.resolvedPeerName
+                    ?.takeIf { PeerNameResolver.isValidPeerName(it) }
+                    ?.also { peerNames[sourceHash] = it }
+                    ?: getPeerName(sourceHash)
+
+            // Record peer activity for "last seen" status
+            // Receiving a message proves the peer was recently online
+            conversationLinkManager.recordPeerActivity(sourceHash)
+
+            notifyMessage(sourceHash, peerName, receivedMessage)
+        }
+
+        /**
+         * Fallback for messages the service did not store: its write failed, the
+         * fields were too large for it to store inline, or the backend runs in
+         * this process. Writes through [ConversationRepository] as before.
+         *
+         * Nothing marks these as duplicates upstream, so a replayed message is
+         * recognised here: it is not saved again, and only notified while unread.
+         */
+        private suspend fun saveAndNotify(receivedMessage: ReceivedMessage) {
+            val existingMessage = conversationRepository.getMessageById(receivedMessage.messageHash)
+            if (existingMessage != null) {
+                val sourceHash = receivedMessage.sourceHash.toHex()
+                RingLog.d(TAG) { "Message ${receivedMessage.messageHash.take(16)} already in database - checking if notification needed" }
+                saveIconAppearance(sourceHash, receivedMessage)
+
+                // Only notify if the message hasn't been read yet
+                // This prevents duplicate notifications after service restart
+                // for messages the user has already seen
+                if (!existingMessage.isRead) {
+                    notifyMessage(sourceHash, getPeerNameWithFallback(sourceHash), receivedMessage)
+                } else {
+                    RingLog.d(TAG) { "Skipping notification for already-read message ${receivedMessage.messageHash.take(16)}" }
+                }
+
+                // Record peer activity for "last seen" status
+                // Receiving a message proves the peer was recently online
+                conversationLinkManager.recordPeerActivity(sourceHash)
+                return
+            }
+
+            // CRITICAL: Verify the message was sent to the current active identity
+            // This prevents messages from being saved to the wrong identity after switching
+            val activeIdentity = identityRepository.getActiveIdentitySync()
+            if (activeIdentity == null) {
+                RingLog.w(TAG) { "No active identity - skipping message" }
+                return
+            }
+
+            val messageDestHash = receivedMessage.destinationHash.toHex()
+            if (messageDestHash != activeIdentity.destinationHash) {
+                RingLog.w(TAG) {
+                    "Message destination $messageDestHash doesn't match active identity " +
+                        "${activeIdentity.destinationHash} - skipping (sent to different identity)"
+                }
+                return
+            }
+
+            _messagesCollected.value++
+
+            val sourceHash = receivedMessage.sourceHash.toHex()
+            RingLog.d(TAG) { "Received new message #${_messagesCollected.value} from $sourceHash" }
+
+            // Create data message for storage
+            val now = System.currentTimeMillis()
+            val dataMessage =
+                DataMessage(
+                    id = receivedMessage.messageHash,
+                    // From sender's perspective
+                    destinationHash = sourceHash,
+                    content = receivedMessage.content,
+                    // Use sender's timestamp for display; receivedAt for sort ordering
+                    timestamp = receivedMessage.timestamp,
+                    isFromMe = false,
+                    status = "delivered",
+                    // LXMF attachments
+                    fieldsJson = receivedMessage.fieldsJson,
+                    // Routing info (hop count and receiving interface)
+                    receivedHopCount = receivedMessage.receivedHopCount,
+                    receivedInterface = receivedMessage.receivedInterface,
+                    // Signal quality metrics (RNode/BLE; null on TCP/Auto/propagated)
+                    receivedRssi = receivedMessage.receivedRssi,
+                    receivedSnr = receivedMessage.receivedSnr,
+                    // LXMF delivery method ("opportunistic" / "direct" / "propagated"
+                    // / "paper"). Surfaced in MessageDetailScreen for received
+                    // messages — most of the path-info cards (hop count, interface,
+                    // RSSI/SNR) are null for propagation-fetched messages, so
+                    // without this the detail screen renders essentially empty.
+                    deliveryMethod = receivedMessage.deliveryMethod,
+                    // Local reception time for sort ordering
+                    receivedAt = now,
+                )
+
+            // Get peer name from cache, existing conversation, or use formatted hash
+            val peerName = getPeerNameWithFallback(sourceHash)
+
+            // Save to database - this creates/updates the conversation and adds the message
+            try {
+                // Prefer public key from message (directly from RNS identity cache)
+                // Fall back to peer_identities lookup if not in message
+                val messagePublicKey = receivedMessage.publicKey
+                val publicKey =
+                    messagePublicKey
+                        ?: conversationRepository.getPeerPublicKey(sourceHash)
+
+                // Store public key to peer_identities if we got it from the message
+                // This ensures future lookups will find it
+                if (messagePublicKey != null) {
+                    conversationRepository.updatePeerPublicKey(sourceHash, messagePublicKey)
+                    RingLog.d(TAG) { "Stored sender's public key for $sourceHash" }
+                }
+
+                saveIconAppearance(sourceHash, receivedMessage)
+
+                conversationRepository.saveMessage(sourceHash, peerName, dataMessage, publicKey)
+                RingLog.d(TAG) { "Message saved to database for peer ${sourceHash.take(16)} (hasPublicKey=${publicKey != null})" }
+
+                // Record peer activity for "last seen" status
+                // Receiving a message proves the peer was recently online
+                conversationLinkManager.recordPeerActivity(sourceHash)
+
+                notifyMessage(sourceHash, peerName, receivedMessage)
+            } catch (e: Exception) {
+                RingLog.e(TAG, e) { "Failed to save message to database" }
+            }
+        }
+
+        /**
+         * Store the sender's icon appearance if present (Sideband/MeshChat interop).
+         * Icons are stored in peer_icons table (LXMF concept), separate from announces (Reticulum concept).
+         */
+        private suspend fun saveIconAppearance(
+            sourceHash: String,
+            receivedMessage: ReceivedMessage,
+        ) {
+            val appearance = receivedMessage.iconAppearance ?: return
+            if (appearance.iconName.isEmpty() ||
+                appearance.foregroundColor.isEmpty() ||
+                appearance.backgroundColor.isEmpty()
+            ) {
+                return
+            }
+            try {
+                peerIconDao.upsertIcon(
+                    PeerIconEntity(
+                        destinationHash = sourceHash,
+                        iconName = appearance.iconName,
+                        foregroundColor = appearance.foregroundColor,
+                        backgroundColor = appearance.backgroundColor,
+                        updatedTimestamp = System.currentTimeMillis(),
+                    ),
+                )
+                RingLog.d(TAG) { "Saved icon appearance for $sourceHash: ${appearance.iconName}" }
+            } catch (e: Exception) {
+                RingLog.w(TAG, e) { "Failed to save icon appearance for $sourceHash" }
+            }
+        }
+
+        private suspend fun notifyMessage(
+            sourceHash: String,
+            peerName: String,
+            receivedMessage: ReceivedMessage,
+        ) {
+            // Check if sender is a saved peer (favorite)
+            val isFavorite =
+                try {
+                    announceRepository.getAnnounce(sourceHash)?.isFavorite ?: false
+                } catch (e: Exception) {
+                    RingLog.w(TAG, e) { "Could not check if peer is favorite" }
+                    false
+                }
+
+            // Show notification for received message
+            try {
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = sourceHash,
+                    peerName = peerName,
+                    // Truncate preview
+                    messagePreview = receivedMessage.content.take(100),
+                    isFavorite = isFavorite,
+                )
+                RingLog.d(TAG) { "Posted notification for message (favorite: $isFavorite)" }
+            } catch (e: Exception) {
+                RingLog.e(TAG, e) { "Failed to post message notification" }
+            }
+        }
+
         /**
          * Get a display name for a peer, using cached name or formatted hash
          */
@@ -503,14 +493,14 @@ class MessageCollector
         ) {
             if (name.isNotBlank()) {
                 peerNames[peerHash] = name
-                Log.d(TAG, "Updated peer name for ${peerHash.take(16)}")
+                RingLog.d(TAG) { "Updated peer name for ${peerHash.take(16)}" }
 
                 // Update in database too
                 scope.launch {
                     try {
                         conversationRepository.updatePeerName(peerHash, name)
                     } catch (e: Exception) {
-                        Log.e(TAG, "Failed to update peer name in database", e)
+                        RingLog.e(TAG, e) { "Failed to update peer name in database" }
                     }
                 }
             }
@@ -524,8 +514,7 @@ class MessageCollector
             // CRITICAL: Clear peer names cache to prevent stale data after identity switch
             // This ensures fresh data is fetched from database or announces when restarted
             peerNames.clear()
-            processedMessageIds.clear()
-            Log.i(TAG, "Stopped message collection service (caches cleared)")
+            RingLog.i(TAG) { "Stopped message collection service (caches cleared)" }
         }
 
         /**
@@ -0,0 +1,108 @@
+package network.columba.app.service
+
+import android.util.Log
+import network.columba.app.data.db.dao.PathTableDao
+import network.columba.app.data.db.entity.PathTableEntryEntity
+import network.columba.app.rns.api.RnsCore
+import network.columba.app.rns.api.model.PathTableDelta
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * Keeps the `path_table` Room table in step with the backend's RNS path
+ * table, so reachability is an indexed join instead of shipping every
+ * path hash across IPC and into an `IN (...)` list.
+ *
+ * Applies [RnsCore.observePathTable] deltas as they arrive. Each
+ * subscription (including the one after a service rebind) begins with a
+ * reset, which replaces whatever the table held. A reset split across
+ * several batches is held until its last batch and applied in one
+ * transaction, so readers never see a partly refilled table.
+ */
+@Singleton
+class PathTableMirror
+    @Inject
+    constructor(
+        private val rnsCore: RnsCore,
+        private val pathTableDao: PathTableDao,
+    ) {
+        companion object {
+            private const val TAG = "PathTableMirror"
+
+            // Back-off before resubscribing after the stream fails
+            private const val RETRY_DELAY_MS = 5_000L
+        }
+
+        private var mirrorJob: Job? = null
+
+        // Entries of a reset whose remaining batches haven't arrived yet
+        private var pendingReset: MutableList<PathTableEntryEntity>? = null
+
+        /**
+         * Start mirroring. Should be called after Reticulum is initialized.
+         */
+        fun start(scope: CoroutineScope) {
+            if (mirrorJob?.isActive == true) {
+                Log.d(TAG, "Path table mirror already running")
+                return
+            }
+
+            Log.d(TAG, "Starting path table mirror")
+            mirrorJob =
+                scope.launch(Dispatchers.IO) {
+                    while (isActive) {
+                        try {
+                            // A new subscription opens with its own reset
+                            pendingReset = null
+                            rnsCore.observePathTable().collect { apply(it) }
+                        } catch (e: CancellationException) {
+                            throw e
+                        } catch (e: Exception) {
+                            Log.w(TAG, "Path table stream failed; resubscribing", e)
+                        }
+                        delay(RETRY_DELAY_MS)
+                    }
+                }
+        }
+
+        /**
+         * Stop mirroring. The table keeps its last contents until the next
+         * reset.
+         */
+        fun stop() {
+            Log.d(TAG, "Stopping path table mirror")
+            mirrorJob?.cancel()
+            mirrorJob = null
+        }
+
+        internal suspend fun apply(delta: PathTableDelta) {
+            val now = System.currentTimeMillis()
+            val upserts = ArrayList<PathTableEntryEntity>(delta.added.size + delta.updated.size)
+            delta.added.forEach { (hash, hops) -> upserts.add(PathTableEntryEntity(hash, hops, now)) }
+            delta.updated.forEach { (hash, hops) -> upserts.add(PathTableEntryEntity(hash, hops, now)) }
+
+            if (delta.reset) pendingReset = mutableListOf()
+            val reset = pendingReset
+            if (reset == null) {
+                pathTableDao.applyDelta(false, upserts, delta.expired)
+                return
+            }
+            reset.addAll(upserts)
+            if (delta.expired.isNotEmpty()) {
+                val expired = delta.expired.toHashSet()
+                reset.removeAll { it.destinationHash in expired }
+            }
+            if (delta.partial) return
+
+            pendingReset = null
+            pathTableDao.applyDelta(true, reset, emptyList())
+            Log.d(TAG, "Path table reset with ${reset.size} entries")
+        }
+    }
@@ -10,6 +10,7 @@ import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.RnsCore
 import network.columba.app.rns.api.RnsLxmf
 import network.columba.app.rns.api.RnsTelemetry
+import network.columba.app.rns.api.util.TelemeterCodec
 import network.columba.app.util.LocationCompat
 import dagger.hilt.android.qualifiers.ApplicationContext
 import kotlinx.coroutines.CancellationException
@@ -26,9 +27,6 @@ import kotlinx.coroutines.flow.distinctUntilChanged
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
-import kotlinx.serialization.Serializable
-import kotlinx.serialization.encodeToString
-import kotlinx.serialization.json.Json
 import javax.inject.Inject
 import javax.inject.Singleton
 
@@ -64,20 +62,6 @@ sealed class TelemetryRequestResult {
     data object NetworkNotReady : TelemetryRequestResult()
 }
 
-/**
- * Location telemetry data for sending to collector.
- */
-@Serializable
-private data class LocationTelemetryData(
-    val lat: Double,
-    val lng: Double,
-    val acc: Float,
-    val ts: Long,
-    val altitude: Double = 0.0,
-    val speed: Float = 0.0f,
-    val bearing: Float = 0.0f,
-)
-
 /**
  * Manages sending location telemetry to a configured collector.
  *
@@ -723,23 +707,6 @@ class TelemetryCollectorManager
                         speed = location.speed.toDouble(),
                         bearing = location.bearing.toDouble(),
                     )
-                // storeOwnTelemetry still accepts a JSON string (the
-                // collector-host TODO path; not Sideband-interop relevant).
-                // Re-serialize from `telemetry` only for that branch.
-                val locationJson by lazy {
-                    val data =
-                        LocationTelemetryData(
-                            lat = telemetry.lat,
-                            lng = telemetry.lng,
-                            acc = telemetry.acc,
-                            ts = telemetry.ts,
-                            altitude = telemetry.altitude,
-                            speed = telemetry.speed.toFloat(),
-                            bearing = telemetry.bearing.toFloat(),
-                        )
-                    Json.encodeToString(data)
-                }
-
                 // Get user's icon appearance for Sideband/MeshChat interoperability
                 val iconAppearance =
                     identityRepository.getActiveIdentitySync()?.let { activeId ->
@@ -762,7 +729,12 @@ class TelemetryCollectorManager
                     if (isLocalDestination(collectorHash)) {
                         syncHostModeIfNeededForLocalStore()?.let { return it }
                         Log.d(TAG, "📍 Collector is self, storing own telemetry locally")
-                        rnsTelemetry.storeOwnTelemetry(locationJson, iconAppearance)
+                        // Packed once here; the backend stores the bytes as-is
+                        rnsTelemetry.storeOwnTelemetryPacked(
+                            packedTelemetry = TelemeterCodec.packLocationTelemetry(telemetry),
+                            timestampSeconds = telemetry.ts / 1000L,
+                            iconAppearance = iconAppearance,
+                        )
                     } else {
                         // Get LXMF identity for network send
                         val sourceIdentity =
@@ -0,0 +1,79 @@
+package network.columba.app.ui.components
+
+import android.graphics.drawable.Animatable
+import androidx.compose.foundation.Image
+import androidx.compose.runtime.Composable
+import androidx.compose.runtime.LaunchedEffect
+import androidx.compose.runtime.getValue
+import androidx.compose.runtime.mutableStateOf
+import androidx.compose.runtime.remember
+import androidx.compose.runtime.setValue
+import androidx.compose.ui.Modifier
+import androidx.compose.ui.layout.ContentScale
+import androidx.compose.ui.layout.boundsInWindow
+import androidx.compose.ui.layout.onGloballyPositioned
+import androidx.compose.ui.platform.LocalContext
+import androidx.compose.ui.platform.LocalDensity
+import androidx.compose.ui.unit.Dp
+import androidx.lifecycle.Lifecycle
+import androidx.lifecycle.compose.LocalLifecycleOwner
+import androidx.lifecycle.compose.currentStateAsState
+import coil.compose.AsyncImagePainter
+import coil.compose.rememberAsyncImagePainter
+import network.columba.app.util.AnimatedImageLoader
+
+/**
+ * Animated GIF / WebP inside a message.
+ *
+ * Decodes at [maxWidth] rather than full resolution, and pauses the animation
+ * while the image is scrolled out of view or the screen isn't resumed, so
+ * bubbles kept composed just outside the viewport don't keep decoding frames.
+ *
+ * @param imageData Raw image bytes
+ * @param messageId Message the image belongs to (memory cache key), or null
+ * @param maxWidth Widest the image is shown at
+ */
+@Composable
+fun AnimatedMessageImage(
+    imageData: ByteArray,
+    messageId: String?,
+    maxWidth: Dp,
+    contentDescription: String?,
+    modifier: Modifier = Modifier,
+    contentScale: ContentScale = ContentScale.FillWidth,
+) {
+    val context = LocalContext.current
+    val maxWidthPx = with(LocalDensity.current) { maxWidth.roundToPx() }
+    val request =
+        remember(imageData, messageId, maxWidthPx) {
+            AnimatedImageLoader.messageImageRequest(context, imageData, messageId, maxWidthPx)
+        }
+    val painter =
+        rememberAsyncImagePainter(
+            model = request,
+            imageLoader = AnimatedImageLoader.getInstance(context),
+            contentScale = contentScale,
+        )
+
+    var onScreen by remember { mutableStateOf(true) }
+    val lifecycleState by LocalLifecycleOwner.current.lifecycle.currentStateAsState()
+    val animatable = ((painter.state as? AsyncImagePainter.State.Success)?.result?.drawable as? Animatable)
+
+    LaunchedEffect(animatable, onScreen, lifecycleState) {
+        animatable ?: return@LaunchedEffect
+        val shouldRun = onScreen && lifecycleState.isAtLeast(Lifecycle.State.RESUMED)
+        if (shouldRun && !animatable.isRunning) {
+            animatable.start()
+        } else if (!shouldRun && animatable.isRunning) {
+            animatable.stop()
+        }
+    }
+
+    Image(
+        painter = painter,
+        contentDescription = contentDescription,
+        // The list clips its children, so an item outside the viewport has empty window bounds
+        modifier = modifier.onGloballyPositioned { onScreen = !it.boundsInWindow().isEmpty },
+        contentScale = contentScale,
+    )
+}
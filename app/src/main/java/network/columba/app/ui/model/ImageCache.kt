@@ -1,32 +1,67 @@
 package network.columba.app.ui.model
 
+import android.content.ComponentCallbacks2
 import android.util.LruCache
 import androidx.compose.ui.graphics.ImageBitmap
+import androidx.compose.ui.graphics.asAndroidBitmap
+import coil.memory.MemoryCache
+import java.util.concurrent.atomic.AtomicInteger
 
 /**
- * In-memory LRU cache for decoded message images.
+ * In-memory LRU cache for message images, budgeted in bytes.
  *
  * This cache prevents expensive image decoding from happening on the main thread
  * during LazyColumn composition. Images are decoded asynchronously on IO threads
  * and stored here, then retrieved synchronously during composition.
  *
+ * One budget covers three kinds of entry:
+ * - decoded static bitmaps, keyed by message ID ([get] / [put])
+ * - raw image bytes, keyed by message ID, so a message's hex field is only
+ *   decoded once ([getRawBytes] / [putRawBytes])
+ * - Coil's decoded results, through [memoryCache], which the shared
+ *   [network.columba.app.util.AnimatedImageLoader] uses as its memory cache
+ *
  * Thread-safe: LruCache is synchronized internally.
  */
 object ImageCache {
     /**
-     * Maximum number of images to keep in cache.
-     * At ~100KB per typical message image, this is roughly 5MB of memory.
+     * Memory budget in bytes: an eighth of the heap, the usual share for an
+     * app's bitmap cache (~32MB on a 256MB heap).
      */
-    private const val MAX_CACHE_SIZE = 50
+    private val MAX_CACHE_BYTES = (Runtime.getRuntime().maxMemory() / 8).coerceAtMost(Int.MAX_VALUE.toLong()).toInt()
+
+    private data class BitmapKey(val messageId: String)
+
+    private data class RawKey(val messageId: String)
+
+    private var cache = newCache()
+    private val hits = AtomicInteger(0)
+    private val misses = AtomicInteger(0)
 
-    private var cache = LruCache<String, ImageBitmap>(MAX_CACHE_SIZE)
+    private fun newCache(): LruCache<Any, Any> =
+        object : LruCache<Any, Any>(MAX_CACHE_BYTES) {
+            override fun sizeOf(
+                key: Any,
+                value: Any,
+            ): Int =
+                when (value) {
+                    is ImageBitmap -> value.asAndroidBitmap().allocationByteCount
+                    is ByteArray -> value.size
+                    is MemoryCache.Value -> value.bitmap.allocationByteCount
+                    else -> 1
+                }.coerceAtLeast(1)
+        }
 
     /**
      * Get a cached image by message ID.
      * @param messageId The unique message identifier (hash)
      * @return The cached ImageBitmap, or null if not cached
      */
-    fun get(messageId: String): ImageBitmap? = cache.get(messageId)
+    fun get(messageId: String): ImageBitmap? {
+        val image = cache.get(BitmapKey(messageId)) as? ImageBitmap
+        if (image != null) hits.incrementAndGet() else misses.incrementAndGet()
+        return image
+    }
 
     /**
      * Store an image in the cache.
@@ -37,17 +72,34 @@ object ImageCache {
         messageId: String,
         image: ImageBitmap,
     ) {
-        cache.put(messageId, image)
+        cache.put(BitmapKey(messageId), image)
     }
 
     /**
-     * Check if an image is already cached.
-     * Uses snapshot() to avoid affecting hit/miss statistics.
+     * Check if an image is already cached. Does not count towards [getStats].
+     * Uses snapshot() so the lookup neither moves the entry in the LRU order
+     * nor affects hit/miss statistics.
      *
      * @param messageId The unique message identifier (hash)
      * @return true if the image is in cache
      */
-    fun contains(messageId: String): Boolean = cache.snapshot()?.containsKey(messageId) == true
+    fun contains(messageId: String): Boolean = cache.snapshot()?.containsKey(BitmapKey(messageId)) == true
+
+    /**
+     * Raw (already hex-decoded) image bytes for a message, if cached.
+     */
+    fun getRawBytes(messageId: String): ByteArray? = cache.get(RawKey(messageId)) as? ByteArray
+
+    /**
+     * Store the raw image bytes for a message. Entries larger than the
+     * whole budget are dropped immediately by the LRU.
+     */
+    fun putRawBytes(
+        messageId: String,
+        bytes: ByteArray,
+    ) {
+        cache.put(RawKey(messageId), bytes)
+    }
 
     /**
      * Clear all cached images.
@@ -59,14 +111,57 @@ object ImageCache {
 
     /**
      * Get current cache statistics for debugging.
-     * @return Pair of (hit count, miss count)
+     * @return Pair of (hit count, miss count) for [get]
      */
-    fun getStats(): Pair<Int, Int> = Pair(cache.hitCount(), cache.missCount())
+    fun getStats(): Pair<Int, Int> = Pair(hits.get(), misses.get())
 
     /**
-     * Get the current number of cached items.
+     * Get the current number of cached decoded images.
      */
-    fun size(): Int = cache.size()
+    fun size(): Int = cache.snapshot().keys.count { it is BitmapKey }
+
+    /**
+     * Bytes currently held, across all entry kinds.
+     */
+    fun sizeBytes(): Int = cache.size()
+
+    /**
+     * Coil memory cache backed by this cache's budget. Coil registers for
+     * memory callbacks and calls [MemoryCache.trimMemory], which trims the
+     * message images too.
+     */
+    val memoryCache: MemoryCache =
+        object : MemoryCache {
+            override val size: Int get() = cache.size()
+
+            override val maxSize: Int get() = cache.maxSize()
+
+            override val keys: Set<MemoryCache.Key>
+                get() = cache.snapshot().keys.filterIsInstance<MemoryCache.Key>().toSet()
+
+            override fun get(key: MemoryCache.Key): MemoryCache.Value? = cache.get(key) as? MemoryCache.Value
+
+            override fun set(
+                key: MemoryCache.Key,
+                value: MemoryCache.Value,
+            ) {
+                cache.put(key, value)
+            }
+
+            override fun remove(key: MemoryCache.Key): Boolean = cache.remove(key) != null
+
+            override fun clear() {
+                keys.forEach { cache.remove(it) }
+            }
+
+            override fun trimMemory(level: Int) {
+                if (level >= ComponentCallbacks2.TRIM_MEMORY_BACKGROUND) {
+                    cache.evictAll()
+                } else if (level in ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW until ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN) {
+                    cache.trimToSize(cache.size() / 2)
+                }
+            }
+        }
 
     /**
      * Reset cache completely, including hit/miss statistics.
@@ -74,6 +169,8 @@ object ImageCache {
      */
     @androidx.annotation.VisibleForTesting
     fun resetForTest() {
-        cache = LruCache(MAX_CACHE_SIZE)
+        cache = newCache()
+        hits.set(0)
+        misses.set(0)
     }
 }
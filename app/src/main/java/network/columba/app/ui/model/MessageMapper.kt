@@ -47,9 +47,9 @@ fun Message.toMessageUi(): MessageUi {
     // Get reply-to message ID: prefer DB column, fallback to parsing field 16
     val replyId = replyToMessageId ?: parseReplyToFromFields(fieldsJson)
 
-    // Parse the per-target-message reactions aggregation blob
+    // Reactions arrive pre-aggregated from the `reactions` table
     // (DB-local; the wire format is a separate per-event surface).
-    val reactionsList = parseReactionsJson(reactionsJson)
+    val reactionsList = reactions.map { (emoji, senders) -> ReactionUi(emoji = emoji, senderHashes = senders) }
 
     // Determine if we need to preserve fieldsJson for UI components
     // (uncached image, file attachments, or pending file notification)
@@ -165,8 +165,11 @@ private fun parseReplyToFromField16(fieldsJson: String?): String? =
     parseReplyToFromFields(fieldsJson)
 
 /**
- * Parse the per-target-message reactions aggregation blob stored
- * in the `reactionsJson` column (DB v2+).
+ * Parse a flat per-target-message reactions blob
+ * (`{"👍": [sender1, sender2]}`), the shape stored in the legacy
+ * `reactionsJson` column (DB v2) and still carried by backup bundles.
+ * Since DB v3 the message list reads reactions from the `reactions`
+ * table instead — see [Message.reactions].
  *
  * Reaction layering — two distinct shapes exist:
  *
@@ -179,17 +182,15 @@ private fun parseReplyToFromField16(fieldsJson: String?): String? =
  *      reaction routers dispatch the normalized event via
  *      `_reactionReceivedFlow` → `handleIncomingReaction`.
  *
- *   2. **DB-aggregated form (local-only, what this function reads):**
- *      Flat `{"👍": [sender1, sender2], "❤️": [sender3]}` stored in
- *      the `reactionsJson` column on the *target* message's row.
- *      Built locally by `handleIncomingReaction` →
- *      `mergeReactionIntoReactionsJson`. Never goes on the wire.
+ *   2. **Aggregated blob (local-only, what this function reads):**
+ *      Flat `{"👍": [sender1, sender2], "❤️": [sender3]}` keyed on the
+ *      *target* message. Never goes on the wire.
  *
  * Pre-v2 storage overloaded `fieldsJson.field16.reactions` for this
- * blob; the v1→v2 Room migration in `ColumbaDatabase.MIGRATION_1_2`
- * lifts that data into the dedicated column.
+ * blob; `ColumbaDatabase.MIGRATION_1_2` lifted it into the dedicated
+ * column and `MIGRATION_2_3` split it into `reactions` rows.
  *
- * @param reactionsJson The target message's reactionsJson column value
+ * @param reactionsJson A flat reactions blob
  * @return List of ReactionUi objects, or empty list if absent / malformed
  */
 @Suppress("SwallowedException") // Invalid JSON is expected to fail silently here
@@ -326,8 +327,10 @@ fun decodeImageWithAnimation(
     if (fieldsJson == null) return null
 
     return try {
-        // Get raw image bytes
-        val rawBytes = extractImageBytes(fieldsJson) ?: return null
+        // Get raw image bytes; the hex/disk decode is skipped when this message was seen before
+        val rawBytes =
+            ImageCache.getRawBytes(messageId)
+                ?: (extractImageBytes(fieldsJson) ?: return null).also { ImageCache.putRawBytes(messageId, it) }
 
         // Check if it's an animated GIF
         val isAnimated = ImageUtils.isAnimatedGif(rawBytes)
@@ -109,7 +109,6 @@ fun ChatsScreen(
     val searchQuery by viewModel.searchQuery.collectAsState()
     val isSyncing by viewModel.isSyncing.collectAsState()
     val syncProgress by viewModel.syncProgress.collectAsState()
-    val draftsMap by viewModel.draftsMap.collectAsState()
     val isTransportEnabled by viewModel.isTransportEnabled.collectAsState()
     var isSearching by remember { mutableStateOf(false) }
 
@@ -251,7 +250,7 @@ fun ChatsScreen(
                         // Per-card state for context menu
                         val hapticFeedback = LocalHapticFeedback.current
                         var showMenu by remember { mutableStateOf(false) }
-                        val isSaved by viewModel.isContactSaved(conversation.peerHash).collectAsState()
+                        val isSaved = conversation.isContact
                         var contactLocation by remember { mutableStateOf<Pair<Double, Double>?>(null) }
 
                         // Fetch contact location when menu opens; clear on close
@@ -263,14 +262,12 @@ fun ChatsScreen(
                             }
                         }
 
-                        val draftText = draftsMap[conversation.peerHash]
-
                         // Wrap card and menu in Box to anchor menu to card
                         Box(modifier = Modifier.fillMaxWidth()) {
                             ConversationCard(
                                 conversation = conversation,
                                 isSaved = isSaved,
-                                draftText = draftText,
+                                draftText = conversation.draftText,
                                 onClick = {
                                     if (pendingSharedText != null) {
                                         sharedTextViewModel.assignToDestination(conversation.peerHash)
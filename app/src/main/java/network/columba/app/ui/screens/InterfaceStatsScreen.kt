@@ -201,6 +201,9 @@ private fun StatsContent(
         TrafficStatsCard(
             rxBytes = state.rxBytes,
             txBytes = state.txBytes,
+            rxRate = state.rxRate,
+            txRate = state.txRate,
+            showRates = state.isOnline,
             rssi = state.rssi,
             snr = state.snr,
         )
@@ -490,6 +493,9 @@ private fun RNodeSettingsCard(
 private fun TrafficStatsCard(
     rxBytes: Long,
     txBytes: Long,
+    rxRate: Long,
+    txRate: Long,
+    showRates: Boolean,
     rssi: Int?,
     snr: Float?,
 ) {
@@ -521,6 +527,23 @@ private fun TrafficStatsCard(
                 )
             }
 
+            if (showRates) {
+                Spacer(modifier = Modifier.height(12.dp))
+                Row(
+                    modifier = Modifier.fillMaxWidth(),
+                    horizontalArrangement = Arrangement.SpaceEvenly,
+                ) {
+                    StatBox(
+                        label = "RX Rate",
+                        value = "${InterfaceFormattingUtils.formatBytes(rxRate)}/s",
+                    )
+                    StatBox(
+                        label = "TX Rate",
+                        value = "${InterfaceFormattingUtils.formatBytes(txRate)}/s",
+                    )
+                }
+            }
+
             if (rssi != null || snr != null) {
                 Spacer(modifier = Modifier.height(12.dp))
                 Row(
@@ -168,6 +168,7 @@ import kotlinx.coroutines.withContext
 import network.columba.app.R
 import network.columba.app.service.SyncProgress
 import network.columba.app.service.SyncResult
+import network.columba.app.ui.components.AnimatedMessageImage
 import network.columba.app.ui.components.AttachmentPanel
 import network.columba.app.ui.components.CodecSelectionDialog
 import network.columba.app.ui.components.FileAttachmentCard
@@ -1897,21 +1898,19 @@ fun MessageBubble(
                         ),
             ) {
                 // Large GIF without bubble background
-                AsyncImage(
-                    model =
-                        ImageRequest
-                            .Builder(context)
-                            .data(message.imageData)
-                            .crossfade(true)
-                            .build(),
-                    imageLoader = AnimatedImageLoader.getInstance(context),
-                    contentDescription = "Animated GIF",
-                    modifier =
-                        Modifier
-                            .fillMaxWidth()
-                            .clip(RoundedCornerShape(16.dp)),
-                    contentScale = ContentScale.FillWidth,
-                )
+                message.imageData?.let { imageData ->
+                    AnimatedMessageImage(
+                        imageData = imageData,
+                        messageId = message.id,
+                        maxWidth = 280.dp,
+                        contentDescription = "Animated GIF",
+                        modifier =
+                            Modifier
+                                .fillMaxWidth()
+                                .clip(RoundedCornerShape(16.dp)),
+                        contentScale = ContentScale.FillWidth,
+                    )
+                }
 
                 // Timestamp overlay at bottom-right corner
                 Box(
@@ -2033,17 +2032,13 @@ fun MessageBubble(
                         }
 
                         // Display image attachment if present (LXMF field 6 = IMAGE)
-                        // Use Coil AsyncImage for animated GIFs, static Image for regular images
+                        // Coil-backed AnimatedMessageImage for animated GIFs, static Image for regular images
                         if (isAnimated && imageData != null) {
                             // Animated GIF - use Coil for animated rendering
-                            AsyncImage(
-                                model =
-                                    ImageRequest
-                                        .Builder(context)
-                                        .data(imageData)
-                                        .crossfade(true)
-                                        .build(),
-                                imageLoader = AnimatedImageLoader.getInstance(context),
+                            AnimatedMessageImage(
+                                imageData = imageData,
+                                messageId = message.id,
+                                maxWidth = 268.dp,
                                 contentDescription = "Animated image attachment",
                                 modifier =
                                     Modifier
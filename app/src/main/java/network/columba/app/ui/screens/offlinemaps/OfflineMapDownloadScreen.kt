@@ -1002,7 +1002,7 @@ fun DownloadingStep(
         } else {
             val statusText =
                 when {
-                    progress.isComplete -> "Complete!"
+                    progress.isComplete -> progress.statusMessage?.let { "Complete. $it" } ?: "Complete!"
                     progress.errorMessage != null -> "Error"
                     progress.statusMessage != null -> progress.statusMessage
                     progress.progress > 0 -> "Downloading..."
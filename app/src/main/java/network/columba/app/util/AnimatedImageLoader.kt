@@ -5,12 +5,20 @@ import android.os.Build
 import coil.ImageLoader
 import coil.decode.GifDecoder
 import coil.decode.ImageDecoderDecoder
+import coil.request.ImageRequest
+import coil.size.Dimension
+import coil.size.Size
+import network.columba.app.ui.model.ImageCache
 
 /**
  * Factory for creating Coil ImageLoader instances with GIF animation support.
  *
  * Uses hardware-accelerated ImageDecoderDecoder on API 28+ and falls back to
  * software GifDecoder on API 24-27.
+ *
+ * The singleton is also the app's default Coil loader (see ColumbaApplication),
+ * and its memory cache is [ImageCache.memoryCache], so chat images and Coil
+ * results share one byte budget.
  */
 object AnimatedImageLoader {
     @Volatile
@@ -44,10 +52,36 @@ object AnimatedImageLoader {
                     add(GifDecoder.Factory())
                 }
             }
+            .memoryCache { ImageCache.memoryCache }
             .crossfade(true)
             .build()
     }
 
+    /**
+     * Request for an image shown in a message.
+     *
+     * Decodes at [maxWidthPx] wide rather than the image's own size (ImageDecoder
+     * decodes every animation frame at that size), and keys the memory cache by
+     * [messageId]: Coil has no cache key for ByteArray data otherwise.
+     *
+     * @param data Raw image bytes
+     * @param messageId Message the image belongs to, or null for unsent images
+     * @param maxWidthPx Width the image is displayed at, in pixels
+     */
+    fun messageImageRequest(
+        context: Context,
+        data: ByteArray,
+        messageId: String?,
+        maxWidthPx: Int,
+    ): ImageRequest =
+        ImageRequest
+            .Builder(context)
+            .data(data)
+            .size(Size(Dimension(maxWidthPx), Dimension.Undefined))
+            .apply { messageId?.let { memoryCacheKey("message-image:$it:$maxWidthPx") } }
+            .crossfade(true)
+            .build()
+
     /**
      * Clear the singleton instance. Useful for testing.
      */
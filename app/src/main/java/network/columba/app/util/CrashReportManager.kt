@@ -6,6 +6,7 @@ import android.util.Log
 import dagger.hilt.android.qualifiers.ApplicationContext
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.withContext
+import network.columba.app.rns.api.util.RingLog
 import java.text.SimpleDateFormat
 import java.util.Date
 import java.util.Locale
@@ -86,10 +87,13 @@ class CrashReportManager
                 Log.e(TAG, "Uncaught exception captured", throwable)
 
                 try {
-                    // Persist crash data without logs - logs will be captured fresh when
-                    // the user chooses to report the bug after restart. This avoids using
-                    // runBlocking which can deadlock if crash occurred on main thread.
-                    persistCrashData(throwable, logs = null)
+                    // The ring buffer is read synchronously (no subprocess, no runBlocking),
+                    // so the logs leading up to the crash can be kept with it. One small
+                    // append persists this process's last records for the other process's
+                    // bug reports; the other processes' files are not read here.
+                    RingLog.flush()
+                    val logs = RingLog.dump(MAX_LOG_LINES, RingLog.Level.DEBUG, includeOtherProcesses = false)
+                    persistCrashData(throwable, logs = logs.ifEmpty { null })
                 } catch (e: Exception) {
                     Log.e(TAG, "Failed to persist crash data", e)
                 }
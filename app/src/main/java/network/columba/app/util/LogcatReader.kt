@@ -1,19 +1,21 @@
 package network.columba.app.util
 
-import android.util.Log
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.withContext
-import java.io.BufferedReader
-import java.io.InputStreamReader
+import network.columba.app.rns.api.util.RingLog
 
 /**
- * Utility for safely reading logcat output.
+ * Utility for reading recent logs for inclusion in bug reports.
  *
- * Reads recent logs from the current process for inclusion in bug reports.
+ * Reads from [RingLog] (this process's ring plus what the other process has
+ * flushed) rather than spawning a `logcat` subprocess, so it also sees the
+ * `:reticulum` process and works where `logcat` is unavailable. Only calls
+ * that went through [RingLog] are included, and the other process only
+ * contributes what it has persisted (see [RingLog]: INFO and above, as of
+ * its last flush).
  * All reads are performed on IO dispatcher to avoid blocking the main thread.
  */
 object LogcatReader {
-    private const val TAG = "LogcatReader"
     private const val DEFAULT_MAX_LINES = 500
 
     /**
@@ -25,10 +27,14 @@ object LogcatReader {
         INFO("I"),
         WARN("W"),
         ERROR("E"),
+        ;
+
+        internal val level: RingLog.Level
+            get() = RingLog.Level.fromLetter(flag.single()) ?: RingLog.Level.VERBOSE
     }
 
     /**
-     * Read recent logs from the current process.
+     * Read recent logs from both processes.
      *
      * @param maxLines Maximum number of log lines to read (default: 500)
      * @param minPriority Minimum log priority level (default: WARN)
@@ -40,51 +46,9 @@ object LogcatReader {
     ): String =
         withContext(Dispatchers.IO) {
             try {
-                val pid = android.os.Process.myPid()
-
-                // Build logcat command:
-                // -d: dump and exit (don't block)
-                // -t N: show last N lines
-                // --pid=PID: filter to current process only
-                // *:PRIORITY: minimum priority level
-                val command =
-                    arrayOf(
-                        "logcat",
-                        "-d",
-                        "-t",
-                        maxLines.toString(),
-                        "--pid=$pid",
-                        "*:${minPriority.flag}",
-                    )
-
-                val process = Runtime.getRuntime().exec(command)
-
-                // Read output with timeout
-                val output = StringBuilder()
-                BufferedReader(InputStreamReader(process.inputStream)).use { reader ->
-                    var line: String?
-                    while (reader.readLine().also { line = it } != null) {
-                        output.appendLine(line)
-                    }
-                }
-
-                // Wait for process to complete with timeout
-                val exitCode =
-                    try {
-                        process.waitFor()
-                    } catch (e: InterruptedException) {
-                        process.destroy()
-                        Log.w(TAG, "Logcat process interrupted")
-                        return@withContext ""
-                    }
-
-                if (exitCode != 0) {
-                    Log.w(TAG, "Logcat exited with code $exitCode")
-                }
-
-                output.toString().trim()
+                RingLog.dump(maxLines, minPriority.level).trim()
             } catch (e: Exception) {
-                Log.e(TAG, "Failed to read logcat: ${e.message}", e)
+                RingLog.e("LogcatReader", e) { "Failed to read logs: ${e.message}" }
                 ""
             }
         }
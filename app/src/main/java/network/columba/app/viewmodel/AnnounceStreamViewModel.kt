@@ -32,7 +32,6 @@ import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.flow.map
 import kotlinx.coroutines.flow.stateIn
 import kotlinx.coroutines.launch
-import kotlinx.coroutines.withContext
 import kotlinx.coroutines.withTimeoutOrNull
 import javax.inject.Inject
 
@@ -51,20 +50,12 @@ class AnnounceStreamViewModel
     ) : ViewModel() {
         companion object {
             private const val TAG = "AnnounceStreamViewModel"
-
-            // Made var for testing
-            internal var updateIntervalMs = 30_000L
         }
 
         // Whether Reticulum transport mode is enabled (for blackhole option)
         private val _isTransportEnabled = MutableStateFlow(false)
         val isTransportEnabled: StateFlow<Boolean> = _isTransportEnabled
 
-        // Dirty flag: starts true for initial load, set on each announce, cleared by periodic timer
-        private val reachableCountDirty =
-            java.util.concurrent.atomic
-                .AtomicBoolean(true)
-
         private data class FilterParams(
             val query: String,
             val selectedTypes: Set<NodeType>,
@@ -156,9 +147,17 @@ class AnnounceStreamViewModel
                 }
             }.cachedIn(viewModelScope)
 
-        // Count of reachable announces (nodes with active paths in RNS path table)
-        private val _reachableAnnounceCount = MutableStateFlow(0)
-        val reachableAnnounceCount: StateFlow<Int> = _reachableAnnounceCount.asStateFlow()
+        // Count of reachable announces (nodes with active paths in RNS path table).
+        // PathTableMirror keeps the path_table side table current, so this is a
+        // Room flow over an indexed join rather than a periodic path-table fetch.
+        val reachableAnnounceCount: StateFlow<Int> =
+            announceRepository
+                .getReachableAnnounceCountFlow()
+                .stateIn(
+                    scope = viewModelScope,
+                    started = SharingStarted.WhileSubscribed(5000L),
+                    initialValue = 0,
+                )
 
         private val _initializationStatus = MutableStateFlow<String>("Initializing...")
         val initializationStatus: StateFlow<String> = _initializationStatus.asStateFlow()
@@ -189,48 +188,6 @@ class AnnounceStreamViewModel
 
             // Start collecting announces - but only if service is ready
             startCollectingAnnouncesWhenReady()
-
-            // Update reachable count periodically, but only when dirty (new announces arrived).
-            // Dirty flag starts true so the first iteration loads the initial count.
-            if (updateIntervalMs > 0) {
-                viewModelScope.launch {
-                    while (true) {
-                        if (reachableCountDirty.getAndSet(false)) {
-                            updateReachableCount()
-                        }
-                        kotlinx.coroutines.delay(updateIntervalMs)
-                    }
-                }
-            }
-        }
-
-        /**
-         * Update the reachable announce count by querying RNS path table.
-         * This provides an accurate count of currently reachable nodes.
-         */
-        private suspend fun updateReachableCount() {
-            // Don't query if network is not ready (e.g., during shutdown)
-            if (rnsCore.networkStatus.value !is NetworkStatus.READY) {
-                return
-            }
-
-            try {
-                // Get path table hashes from RNS (Python call - must be off main thread)
-                val pathTableHashes =
-                    withContext(Dispatchers.IO) {
-                        rnsCore.getPathTableHashes()
-                    }
-
-                // Count announces that match the path table (database query - already on IO dispatcher in repository)
-                val count = announceRepository.countReachableAnnounces(pathTableHashes)
-
-                _reachableAnnounceCount.value = count
-                Log.d(TAG, "Updated reachable announce count: $count (from ${pathTableHashes.size} paths)")
-            } catch (e: CancellationException) {
-                throw e
-            } catch (e: Exception) {
-                Log.e(TAG, "Error updating reachable announce count", e)
-            }
         }
 
         private fun startCollectingAnnouncesWhenReady() {
@@ -323,9 +280,6 @@ class AnnounceStreamViewModel
                             peeringCost = announce.peeringCost,
                         )
                         Log.d(TAG, "Saved/updated announce in database: ${hashHex.take(16)}")
-
-                        // Mark dirty so periodic timer triggers an update
-                        reachableCountDirty.set(true)
                     } catch (e: CancellationException) {
                         throw e
                     } catch (e: Exception) {
@@ -27,7 +27,6 @@ import kotlinx.coroutines.flow.map
 import kotlinx.coroutines.flow.onStart
 import kotlinx.coroutines.flow.stateIn
 import kotlinx.coroutines.launch
-import java.util.concurrent.ConcurrentHashMap
 import javax.inject.Inject
 
 /**
@@ -78,27 +77,15 @@ class ChatsViewModel
         // Sync progress for UI display
         val syncProgress: StateFlow<SyncProgress> = propagationNodeManager.syncProgress
 
-        // Cache for contact saved state flows to prevent flickering on recomposition
-        private val contactSavedCache = ConcurrentHashMap<String, StateFlow<Boolean>>()
-
         private val _contactToggleResult = MutableSharedFlow<ContactToggleResult>()
         val contactToggleResult: SharedFlow<ContactToggleResult> = _contactToggleResult.asSharedFlow()
 
-        // Draft texts keyed by peerHash - for showing "Draft:" in conversation list
-        val draftsMap: StateFlow<Map<String, String>> =
-            conversationRepository
-                .observeDrafts()
-                .stateIn(
-                    scope = viewModelScope,
-                    started = SharingStarted.WhileSubscribed(5000L),
-                    initialValue = emptyMap(),
-                )
-
         // Search query state
         val searchQuery = MutableStateFlow("")
 
         // Filtered conversations based on search query, with loading state
         // onStart emits loading state each time flow is collected (tab switch, screen entry)
+        // Rows already carry contact, key and draft state, so this is the list's only Room observer
         val chatsState: StateFlow<ChatsState> =
             searchQuery
                 .flatMapLatest { query ->
@@ -150,7 +137,7 @@ class ChatsViewModel
         fun saveToContacts(conversation: Conversation) {
             viewModelScope.launch {
                 try {
-                    val publicKey = resolvePeerPublicKey(conversation)
+                    val publicKey = if (conversation.hasPublicKey) resolvePeerPublicKey(conversation) else null
 
                     if (publicKey == null) {
                         Log.e(TAG, "Cannot save to contacts: Public key not available for ${conversation.peerHash}")
@@ -235,27 +222,15 @@ class ChatsViewModel
             }
         }
 
+        /**
+         * Fetch the key the row's hasPublicKey promised. Only runs on an explicit save, so the
+         * list itself never issues per-row key lookups.
+         */
         private suspend fun resolvePeerPublicKey(conversation: Conversation): ByteArray? =
             conversation.peerPublicKey
-                ?: conversationRepository.getConversation(conversation.peerHash)?.peerPublicKey
                 ?: conversationRepository.getPeerPublicKey(conversation.peerHash)
                 ?: announceRepository.getAnnounce(conversation.peerHash)?.publicKey
 
-        /**
-         * Check if a peer is saved as a contact.
-         * Uses a cache to prevent flickering when the LazyColumn recomposes.
-         */
-        fun isContactSaved(peerHash: String): StateFlow<Boolean> =
-            contactSavedCache.getOrPut(peerHash) {
-                contactRepository
-                    .hasContactFlow(peerHash)
-                    .stateIn(
-                        scope = viewModelScope,
-                        started = SharingStarted.WhileSubscribed(5000),
-                        initialValue = false,
-                    )
-            }
-
         /**
          * Trigger a manual sync with the propagation node.
          */
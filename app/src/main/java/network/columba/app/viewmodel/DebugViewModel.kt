@@ -8,6 +8,7 @@ import network.columba.app.repository.SettingsRepository
 import network.columba.app.rns.api.RnsCore
 import network.columba.app.rns.api.RnsLxmf
 import network.columba.app.rns.api.RnsTransportAdmin
+import network.columba.app.rns.api.util.RingLog
 import network.columba.app.util.IdentityQrCodeUtils
 import network.columba.app.util.generateDefaultDisplayName
 import dagger.hilt.android.lifecycle.HiltViewModel
@@ -139,6 +140,10 @@ class DebugViewModel
         private val _isRestarting = MutableStateFlow(false)
         val isRestarting: StateFlow<Boolean> = _isRestarting.asStateFlow()
 
+        // Recent RingLog lines from both processes, loaded on demand
+        private val _recentLogs = MutableStateFlow("")
+        val recentLogs: StateFlow<String> = _recentLogs.asStateFlow()
+
         init {
             observeDebugInfo()
             observeNetworkStatus()
@@ -611,6 +616,29 @@ class DebugViewModel
             return entity?.id
         }
 
+        /**
+         * Load recent log lines from this process's ring buffer and the
+         * other process's flushed log into [recentLogs].
+         */
+        fun refreshRecentLogs(
+            minLevel: RingLog.Level = RingLog.Level.DEBUG,
+            maxLines: Int = 500,
+        ) {
+            viewModelScope.launch {
+                _recentLogs.value = withContext(ioDispatcher) { RingLog.dump(maxLines, minLevel) }
+            }
+        }
+
+        /**
+         * Change the log level for [tag] in this process; null restores the default.
+         */
+        fun setLogLevel(
+            tag: String,
+            level: RingLog.Level?,
+        ) {
+            RingLog.setLevel(tag, level)
+        }
+
         override fun onCleared() {
             super.onCleared()
             Log.d(TAG, "DebugViewModel cleared")
@@ -14,17 +14,17 @@ import androidx.lifecycle.viewModelScope
 import network.columba.app.data.database.entity.InterfaceEntity
 import network.columba.app.repository.InterfaceRepository
 import network.columba.app.rns.api.RnsTransportAdmin
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.service.InterfaceConfigManager
 import network.columba.app.util.InterfaceReconnectSignal
 import dagger.hilt.android.lifecycle.HiltViewModel
 import dagger.hilt.android.qualifiers.ApplicationContext
 import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.catch
 import kotlinx.coroutines.flow.update
-import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
 import org.json.JSONObject
@@ -44,9 +44,16 @@ data class InterfaceStatsState(
     // RNode-specific stats (from live connection)
     val rssi: Int? = null,
     val snr: Float? = null,
-    // Traffic stats (from Python/RNS)
+    // Traffic stats (from the backend's interface stats stream)
     val rxBytes: Long = 0,
     val txBytes: Long = 0,
+    val rxRate: Long = 0,
+    val txRate: Long = 0,
+    // Recent samples, oldest first, for charts (NaN = no reading)
+    val rxRateHistory: List<Float> = emptyList(),
+    val txRateHistory: List<Float> = emptyList(),
+    val rssiHistory: List<Float> = emptyList(),
+    val snrHistory: List<Float> = emptyList(),
     // Parsed config fields for display
     val connectionMode: String? = null,
     val targetDeviceName: String? = null,
@@ -78,12 +85,11 @@ class InterfaceStatsViewModel
     ) : ViewModel() {
         companion object {
             private const val TAG = "InterfaceStatsVM"
-            private const val STATS_REFRESH_INTERVAL_MS = 1000L // Poll faster for responsive UI
             private const val CONNECTING_TIMEOUT_MS = 15000L // Stop showing "connecting" after 15s
             private const val ACTION_USB_PERMISSION = "network.columba.app.USB_PERMISSION"
 
             // Test configuration flags - disable background operations during tests
-            internal var enableStatsPolling = true
+            internal var enableStatsStream = true
             internal var enableReconnectSignalObserver = true
         }
 
@@ -128,8 +134,8 @@ class InterfaceStatsViewModel
         init {
             if (interfaceId >= 0) {
                 loadInterface()
-                if (enableStatsPolling) {
-                    startStatsPolling()
+                if (enableStatsStream) {
+                    observeStats()
                 }
                 if (enableReconnectSignalObserver) {
                     observeReconnectSignal()
@@ -192,24 +198,31 @@ class InterfaceStatsViewModel
             }
         }
 
-        private fun startStatsPolling() {
+        /**
+         * Follow the backend's interface stats stream. The backend samples the
+         * counters and keeps the history; this only picks out our interface.
+         */
+        private fun observeStats() {
             viewModelScope.launch {
-                while (isActive) {
-                    refreshStats()
-                    delay(STATS_REFRESH_INTERVAL_MS)
-                }
+                transportAdmin
+                    .observeInterfaceStats()
+                    .catch { e -> Log.e(TAG, "Interface stats stream failed", e) }
+                    .collect { snapshots ->
+                        val name = _state.value.interfaceEntity?.name ?: return@collect
+                        applySnapshot(snapshots.firstOrNull { it.name == name })
+                    }
             }
         }
 
-        internal suspend fun refreshStats() {
+        /**
+         * Apply one sample for this interface; null means the backend doesn't
+         * (yet) know the interface, which reads as offline.
+         */
+        internal suspend fun applySnapshot(snapshot: InterfaceStatsSnapshot?) {
             val entity = _state.value.interfaceEntity ?: return
 
             try {
-                // Get interface online status from the protocol
-                val interfaceStats = transportAdmin.getInterfaceStats(entity.name)
-                val isOnline = interfaceStats?.get("online") as? Boolean ?: false
-                val rxBytes = (interfaceStats?.get("rxb") as? Number)?.toLong() ?: 0L
-                val txBytes = (interfaceStats?.get("txb") as? Number)?.toLong() ?: 0L
+                val isOnline = snapshot?.online ?: false
 
                 // Track if interface has ever been online during this session
                 if (isOnline) {
@@ -232,11 +245,11 @@ class InterfaceStatsViewModel
                         false
                     }
 
-                // For RNode interfaces, also get RSSI if available
+                // RNode RSSI: prefer the sampled value, fall back to the config manager
                 var rssi: Int? = null
                 if (entity.type == "RNode" && isOnline) {
                     val rnodeRssi =
-                        withContext(Dispatchers.IO) {
+                        snapshot?.rssi ?: withContext(Dispatchers.IO) {
                             configManager.getRNodeRssi()
                         }
                     if (rnodeRssi > -100) {
@@ -261,14 +274,21 @@ class InterfaceStatsViewModel
                     it.copy(
                         isOnline = isOnline,
                         isConnecting = isConnecting,
-                        rxBytes = rxBytes,
-                        txBytes = txBytes,
+                        rxBytes = snapshot?.rxBytes ?: 0L,
+                        txBytes = snapshot?.txBytes ?: 0L,
+                        rxRate = snapshot?.rxRate ?: 0L,
+                        txRate = snapshot?.txRate ?: 0L,
+                        rxRateHistory = snapshot?.rxRateHistory.orEmpty(),
+                        txRateHistory = snapshot?.txRateHistory.orEmpty(),
+                        rssiHistory = snapshot?.rssiHistory.orEmpty(),
+                        snrHistory = snapshot?.snrHistory.orEmpty(),
                         rssi = rssi,
+                        snr = snapshot?.snr,
                         needsUsbPermission = needsUsbPermission,
                     )
                 }
             } catch (e: Exception) {
-                Log.e(TAG, "Error refreshing stats", e)
+                Log.e(TAG, "Error applying interface stats", e)
             }
         }
 
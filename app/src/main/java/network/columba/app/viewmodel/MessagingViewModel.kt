@@ -3,7 +3,6 @@ package network.columba.app.viewmodel
 import android.content.Context
 import android.net.Uri
 import android.util.Log
-import androidx.annotation.VisibleForTesting
 import androidx.core.content.FileProvider
 import androidx.lifecycle.ViewModel
 import androidx.lifecycle.viewModelScope
@@ -594,16 +593,8 @@ class MessagingViewModel
                     // Get the current user's hash as the sender
                     val senderHash = identity.hash.joinToString("") { "%02x".format(it) }
 
-                    // Update local database with the reaction (optimistic update)
-                    val updatedReactionsJson =
-                        mergeReactionIntoJson(
-                            message.reactionsJson,
-                            emoji,
-                            senderHash,
-                        )
-
-                    // Save the updated reactions blob to the dedicated column
-                    conversationRepository.updateMessageReactions(messageId, updatedReactionsJson)
+                    // Record the reaction locally first (optimistic update)
+                    conversationRepository.addReaction(messageId, emoji, senderHash)
 
                     Log.d(
                         TAG,
@@ -969,7 +960,7 @@ class MessagingViewModel
 
         /**
          * Handle an incoming reaction from another user.
-         * Parses the reaction JSON and updates the target message's reactions in the database.
+         * Parses the reaction JSON and records it against the target message in the database.
          *
          * Expected JSON format:
          * {"reaction_to": "msg_id", "emoji": "👍", "sender": "sender_hash", "source_hash": "...", "timestamp": ...}
@@ -988,25 +979,15 @@ class MessagingViewModel
 
                 Log.d(TAG, "😀 Incoming reaction: $emoji to message ${targetMessageId.take(16)}... from ${senderHash.take(16)}...")
 
-                // Find the target message
-                val targetMessage = conversationRepository.getMessageById(targetMessageId)
-                if (targetMessage == null) {
-                    Log.w(TAG, "Reaction received for unknown message: ${targetMessageId.take(16)}...")
+                // Record against the target message (NOT the carrier
+                // message; reactions attach to the message being reacted
+                // *to*). Unknown targets and replays are ignored by the insert.
+                val added = conversationRepository.addReaction(targetMessageId, emoji, senderHash)
+                if (!added) {
+                    Log.d(TAG, "Reaction ignored (duplicate or unknown message ${targetMessageId.take(16)}...)")
                     return
                 }
 
-                // Aggregate the reaction into the dedicated DB column on
-                // the target message (NOT the carrier message; reactions
-                // attach to the message being reacted *to*).
-                val updatedReactionsJson =
-                    mergeReactionIntoJson(
-                        targetMessage.reactionsJson,
-                        emoji,
-                        senderHash,
-                    )
-
-                conversationRepository.updateMessageReactions(targetMessageId, updatedReactionsJson)
-
                 Log.d(TAG, "😀 Reaction $emoji added to message ${targetMessageId.take(16)}... from ${senderHash.take(16)}...")
             } catch (e: Exception) {
                 Log.e(TAG, "Error handling incoming reaction: ${e.message}", e)
@@ -1092,6 +1073,7 @@ class MessagingViewModel
                 try {
                     Log.d(TAG, "Marking conversation $destinationHash as read...")
                     conversationRepository.markConversationAsRead(destinationHash)
+                    activeConversationManager.markRead(destinationHash)
                     Log.d(TAG, "Conversation marked as read")
                 } catch (e: Exception) {
                     Log.e(TAG, "Error marking conversation as read", e)
@@ -1168,6 +1150,7 @@ class MessagingViewModel
             viewModelScope.launch {
                 try {
                     conversationRepository.markConversationAsRead(destinationHash)
+                    activeConversationManager.markRead(destinationHash)
                 } catch (e: Exception) {
                     Log.e(TAG, "Error marking conversation as read", e)
                 }
@@ -2702,57 +2685,6 @@ private fun parseImageFromFieldsJson(fieldsJson: String): ByteArray? =
         null
     }
 
-/**
- * Merge an `(emoji, sender)` event into a target message's
- * `reactionsJson` aggregation blob.
- *
- * Shape: flat `{emoji: [senderHex, ...]}` — no field-16 wrapper since
- * the column is a dedicated DB surface, not an overload of the LXMF
- * fields map.
- *
- * Idempotent for the same `(emoji, sender)` pair (won't duplicate the
- * sender hash). Tolerant of malformed input — a JSON-unparseable
- * existing blob is reset to a fresh single-entry blob.
- */
-@VisibleForTesting
-internal fun mergeReactionIntoJson(
-    reactionsJson: String?,
-    emoji: String,
-    senderHash: String,
-): String {
-    val json =
-        if (reactionsJson.isNullOrEmpty()) {
-            org.json.JSONObject()
-        } else {
-            try {
-                org.json.JSONObject(reactionsJson)
-            } catch (e: Exception) {
-                Log.w(HELPER_TAG, "Failed to parse reactionsJson, creating new: ${e.message}")
-                org.json.JSONObject()
-            }
-        }
-
-    val senderList =
-        if (json.has(emoji)) {
-            json.getJSONArray(emoji)
-        } else {
-            org.json.JSONArray().also { json.put(emoji, it) }
-        }
-
-    var alreadyReacted = false
-    for (i in 0 until senderList.length()) {
-        if (senderList.optString(i) == senderHash) {
-            alreadyReacted = true
-            break
-        }
-    }
-    if (!alreadyReacted) {
-        senderList.put(senderHash)
-    }
-
-    return json.toString()
-}
-
 /**
  * Result of a contact toggle operation.
  */
@@ -76,7 +76,7 @@ data class DownloadProgress(
     val requiredResources: Long = 0L,
     val isComplete: Boolean = false,
     val errorMessage: String? = null,
-    val statusMessage: String? = null, // Shown during post-download finalization (e.g., style caching)
+    val statusMessage: String? = null, // Shown during finalization (e.g., style caching), or a note once complete
 )
 
 /**
@@ -167,6 +167,9 @@ class OfflineMapDownloadViewModel
         /** URL fetcher — overridable for testing. */
         internal var urlFetcher: (String) -> String = ::defaultFetchUrl
 
+        /** Tile downloader for MBTiles region updates — overridable for testing. */
+        internal var tileDownloadManagerFactory: (Context) -> TileDownloadManager = { TileDownloadManager(it) }
+
         companion object {
             private const val TAG = "OfflineMapDownloadVM"
 
@@ -185,6 +188,12 @@ class OfflineMapDownloadViewModel
         // Track if a download is in progress
         private var isDownloading = false
 
+        // Running incremental update of an MBTiles region, for cancellation
+        private var mbtilesUpdate: TileDownloadManager? = null
+
+        // MapLibre region being refreshed in place, for cancellation
+        private var maplibreRefresh: Long? = null
+
         init {
             // Check if geocoder backend is actually working (not just installed)
             // Geocoder.isPresent() only checks if installed, not if Play Services is enabled
@@ -221,6 +230,10 @@ class OfflineMapDownloadViewModel
          * Initialize the wizard pre-filled for updating an existing region.
          * Loads the region's parameters, skips to CONFIRM step, and records the
          * old region ID so it can be deleted after download completes.
+         *
+         * If the area is left unchanged the region is instead updated in place,
+         * keeping unchanged tiles (see [refreshMaplibreRegion]); MBTiles regions
+         * always are (see [updateMbtilesRegion]).
          */
         fun initForUpdate(regionId: Long) {
             viewModelScope.launch {
@@ -475,6 +488,12 @@ class OfflineMapDownloadViewModel
             val maplibreId = currentState.maplibreRegionId
             val dbRegionId = currentState.createdRegionId
 
+            // An MBTiles update leaves the existing file alone until it finishes
+            mbtilesUpdate?.cancel()
+            // A refreshed region is kept, with whatever tiles were revalidated so far
+            maplibreRefresh?.let { mapLibreOfflineManager.cancelRefresh(it) }
+            maplibreRefresh = null
+
             // Delete MapLibre region if it exists
             if (maplibreId != null) {
                 mapLibreOfflineManager.deleteRegion(maplibreId) { success ->
@@ -649,6 +668,17 @@ class OfflineMapDownloadViewModel
 
             viewModelScope.launch {
                 try {
+                    val updateRegion = currentState.updateRegionId?.let { offlineMapRegionRepository.getRegionById(it) }
+                    if (updateRegion != null && updateRegion.mbtilesPath != null && updateRegion.maplibreRegionId == null) {
+                        updateMbtilesRegion(updateRegion, lat, lon, name)
+                        return@launch
+                    }
+                    val refreshId = updateRegion?.maplibreRegionId
+                    if (updateRegion != null && refreshId != null && coversSameArea(updateRegion, currentState)) {
+                        refreshMaplibreRegion(updateRegion, refreshId)
+                        return@launch
+                    }
+
                     Log.d(TAG, "Starting MapLibre offline download for region: $name")
 
                     // Create database record first
@@ -664,15 +694,7 @@ class OfflineMapDownloadViewModel
 
                     _state.update { it.copy(createdRegionId = regionId) }
 
-                    // Snapshot the current tile version before downloading so
-                    // the recorded version matches the tiles we actually fetch.
-                    val tileVersionSnapshot =
-                        try {
-                            TileDownloadManager.fetchCurrentTileVersion()
-                        } catch (e: Exception) {
-                            Log.w(TAG, "Could not snapshot tile version before download", e)
-                            null
-                        }
+                    val tileVersionSnapshot = snapshotTileVersion()
 
                     // Calculate bounds for the region
                     val bounds = calculateBounds(lat, lon, currentState.radiusOption.km)
@@ -713,118 +735,13 @@ class OfflineMapDownloadViewModel
                             Log.d(TAG, "Download complete! MapLibre region ID: $maplibreRegionId, size: $sizeBytes bytes")
 
                             viewModelScope.launch {
-                                try {
-                                    // 1. Mark COMPLETE immediately so the database
-                                    //    reflects reality (tiles are saved in
-                                    //    mbgl-offline.db). If the app is killed after
-                                    //    this point, the region won't appear stuck in
-                                    //    DOWNLOADING state on next launch.
-                                    offlineMapRegionRepository.markCompleteWithMaplibreId(
-                                        id = regionId,
-                                        tileCount =
-                                            _state.value.downloadProgress
-                                                ?.completedResources
-                                                ?.toInt() ?: 0,
-                                        sizeBytes = sizeBytes,
-                                        maplibreRegionId = maplibreRegionId,
-                                    )
-
-                                    // 1b. Record the tile version so "Check for Updates"
-                                    //     can compare against the server later.
-                                    //     Prefers the pre-download snapshot (matches
-                                    //     actual tiles); falls back to a fresh fetch so
-                                    //     the region doesn't permanently lose update
-                                    //     checking if the snapshot was null.
-                                    val tileVersion =
-                                        tileVersionSnapshot ?: try {
-                                            TileDownloadManager.fetchCurrentTileVersion()
-                                        } catch (e: Exception) {
-                                            Log.w(TAG, "Failed to fetch tile version (non-fatal)", e)
-                                            null
-                                        }
-                                    if (tileVersion != null) {
-                                        offlineMapRegionRepository.updateTileVersion(
-                                            regionId,
-                                            tileVersion,
-                                        )
-                                    } else {
-                                        Log.w(TAG, "Tile version unavailable; update checking disabled for region $regionId")
-                                    }
-
-                                    // 2. Show "Finalizing..." while style caching runs.
-                                    //    This can take up to ~36s worst-case (3 retries ×
-                                    //    10s timeout + backoff delays).
-                                    _state.update {
-                                        it.copy(
-                                            downloadProgress =
-                                                it.downloadProgress?.copy(
-                                                    statusMessage = "Finalizing offline style…",
-                                                ),
-                                        )
-                                    }
-
-                                    // 3. Cache the inlined style JSON. This must
-                                    //    happen BEFORE HTTP is auto-disabled so that
-                                    //    MapTileSourceManager returns Online (not
-                                    //    Unavailable) if anything queries the map
-                                    //    while style caching is still in progress.
-                                    val styleCached = fetchAndCacheStyleJson(regionId)
-                                    val styleCacheWarning =
-                                        if (!styleCached) {
-                                            Log.w(TAG, "Style caching failed — offline map may not work after 24h")
-                                            "Map tiles saved, but offline style caching failed. " +
-                                                "The map may stop working offline after 24 hours. " +
-                                                "Try re-downloading while connected to the internet."
-                                        } else {
-                                            null
-                                        }
-
-                                    // 4. Now safe to auto-disable HTTP — the cached
-                                    //    style (if successful) is already persisted.
-                                    val wasEnabledForDownload =
-                                        settingsRepository.httpEnabledForDownloadFlow.first()
-                                    if (wasEnabledForDownload) {
-                                        Log.d(TAG, "Auto-disabling HTTP after download (was enabled for download)")
-                                        mapTileSourceManager.setHttpEnabled(false)
-                                        settingsRepository.setHttpEnabledForDownload(false)
-                                    }
-
-                                    // 5. If updating, delete the old region now that
-                                    //    the replacement is fully downloaded and cached.
-                                    val updateId = _state.value.updateRegionId
-                                    if (updateId != null) {
-                                        deleteOldRegion(updateId)
-                                    }
-
-                                    // 6. Signal completion with any warnings.
-                                    //    Both httpAutoDisabled and styleCacheWarning
-                                    //    are set atomically so the UI can consolidate
-                                    //    them into a single notification.
-                                    _state.update {
-                                        it.copy(
-                                            isComplete = true,
-                                            downloadProgress =
-                                                it.downloadProgress?.copy(
-                                                    isComplete = true,
-                                                    statusMessage = null,
-                                                ),
-                                            httpAutoDisabled = wasEnabledForDownload,
-                                            styleCacheWarning = styleCacheWarning,
-                                        )
-                                    }
-                                } catch (e: kotlinx.coroutines.CancellationException) {
-                                    throw e
-                                } catch (e: Exception) {
-                                    Log.e(TAG, "Failed to complete region finalization", e)
-                                    _state.update {
-                                        it.copy(
-                                            downloadProgress = it.downloadProgress?.copy(statusMessage = null),
-                                            errorMessage =
-                                                "Error finalizing download: ${e.message}. " +
-                                                    "MapLibre region saved but finalization failed.",
-                                        )
-                                    }
-                                }
+                                finishMaplibreDownload(
+                                    regionId = regionId,
+                                    maplibreRegionId = maplibreRegionId,
+                                    sizeBytes = sizeBytes,
+                                    tileVersionSnapshot = tileVersionSnapshot,
+                                    replacedRegionId = _state.value.updateRegionId,
+                                )
                             }
 
                             isDownloading = false
@@ -862,6 +779,311 @@ class OfflineMapDownloadViewModel
             }
         }
 
+        /**
+         * Snapshot the current tile version before downloading so the recorded
+         * version matches the tiles we actually fetch.
+         */
+        private suspend fun snapshotTileVersion(): String? =
+            try {
+                TileDownloadManager.fetchCurrentTileVersion()
+            } catch (e: kotlinx.coroutines.CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                Log.w(TAG, "Could not snapshot tile version before download", e)
+                null
+            }
+
+        private fun coversSameArea(
+            region: OfflineMapRegion,
+            state: OfflineMapDownloadState,
+        ): Boolean =
+            region.centerLatitude == state.centerLatitude &&
+                region.centerLongitude == state.centerLongitude &&
+                region.radiusKm == state.radiusOption.km &&
+                region.minZoom == state.minZoom &&
+                region.maxZoom == state.maxZoom
+
+        /**
+         * Update a MapLibre region that still covers the same area in place.
+         *
+         * MapLibre revalidates each stored tile with a conditional request and
+         * only downloads the ones that changed; the region stays usable with its
+         * old tiles meanwhile and keeps its ID. Changing the area or zoom range
+         * downloads a new region instead, and deletes the old one once done.
+         */
+        private suspend fun refreshMaplibreRegion(
+            region: OfflineMapRegion,
+            maplibreRegionId: Long,
+        ) {
+            Log.d(TAG, "Refreshing MapLibre region ${region.id} in place")
+            maplibreRefresh = maplibreRegionId
+            _state.update { it.copy(downloadProgress = DownloadProgress(statusMessage = "Checking tiles for changes…")) }
+            val tileVersionSnapshot = snapshotTileVersion()
+
+            mapLibreOfflineManager.refreshRegion(
+                regionId = maplibreRegionId,
+                onProgress = { progress, completed, required ->
+                    _state.update {
+                        it.copy(
+                            downloadProgress =
+                                DownloadProgress(
+                                    progress = progress,
+                                    completedResources = completed,
+                                    requiredResources = required,
+                                    statusMessage = "Checking tiles for changes…",
+                                ),
+                        )
+                    }
+                },
+                onComplete = { _, sizeBytes ->
+                    if (maplibreRefresh != maplibreRegionId) return@refreshRegion
+                    Log.d(TAG, "Refreshed MapLibre region $maplibreRegionId, size: $sizeBytes bytes")
+                    maplibreRefresh = null
+                    isDownloading = false
+                    viewModelScope.launch {
+                        finishMaplibreDownload(
+                            regionId = region.id,
+                            maplibreRegionId = maplibreRegionId,
+                            sizeBytes = sizeBytes,
+                            tileVersionSnapshot = tileVersionSnapshot,
+                            replacedRegionId = null,
+                        )
+                    }
+                },
+                onError = { errorMessage ->
+                    if (maplibreRefresh != maplibreRegionId) return@refreshRegion
+                    // The region keeps its old tiles, so it is not marked as failed
+                    Log.e(TAG, "Refresh failed for region ${region.id}: $errorMessage")
+                    maplibreRefresh = null
+                    isDownloading = false
+                    _state.update {
+                        it.copy(
+                            errorMessage = "Update failed: $errorMessage",
+                            downloadProgress =
+                                (it.downloadProgress ?: DownloadProgress()).copy(
+                                    errorMessage = errorMessage,
+                                    statusMessage = null,
+                                ),
+                        )
+                    }
+                },
+            )
+        }
+
+        /**
+         * Record a finished MapLibre download for [regionId]: mark it complete,
+         * note its tile version, cache the offline style and, when it replaces
+         * an older region, delete that one.
+         */
+        @Suppress("LongMethod") // Ordered finalization steps - see comments
+        private suspend fun finishMaplibreDownload(
+            regionId: Long,
+            maplibreRegionId: Long,
+            sizeBytes: Long,
+            tileVersionSnapshot: String?,
+            replacedRegionId: Long?,
+        ) {
+            try {
+                // 1. Mark COMPLETE immediately so the database
+                //    reflects reality (tiles are saved in
+                //    mbgl-offline.db). If the app is killed after
+                //    this point, the region won't appear stuck in
+                //    DOWNLOADING state on next launch.
+                offlineMapRegionRepository.markCompleteWithMaplibreId(
+                    id = regionId,
+                    tileCount =
+                        _state.value.downloadProgress
+                            ?.completedResources
+                            ?.toInt() ?: 0,
+                    sizeBytes = sizeBytes,
+                    maplibreRegionId = maplibreRegionId,
+                )
+
+                // 1b. Record the tile version so "Check for Updates"
+                //     can compare against the server later.
+                //     Prefers the pre-download snapshot (matches
+                //     actual tiles); falls back to a fresh fetch so
+                //     the region doesn't permanently lose update
+                //     checking if the snapshot was null.
+                val tileVersion =
+                    tileVersionSnapshot ?: try {
+                        TileDownloadManager.fetchCurrentTileVersion()
+                    } catch (e: Exception) {
+                        Log.w(TAG, "Failed to fetch tile version (non-fatal)", e)
+                        null
+                    }
+                if (tileVersion != null) {
+                    offlineMapRegionRepository.updateTileVersion(
+                        regionId,
+                        tileVersion,
+                    )
+                } else {
+                    Log.w(TAG, "Tile version unavailable; update checking disabled for region $regionId")
+                }
+
+                // 2. Show "Finalizing..." while style caching runs.
+                //    This can take up to ~36s worst-case (3 retries ×
+                //    10s timeout + backoff delays).
+                _state.update {
+                    it.copy(
+                        downloadProgress =
+                            it.downloadProgress?.copy(
+                                statusMessage = "Finalizing offline style…",
+                            ),
+                    )
+                }
+
+                // 3. Cache the inlined style JSON. This must
+                //    happen BEFORE HTTP is auto-disabled so that
+                //    MapTileSourceManager returns Online (not
+                //    Unavailable) if anything queries the map
+                //    while style caching is still in progress.
+                val styleCached = fetchAndCacheStyleJson(regionId)
+                val styleCacheWarning =
+                    if (!styleCached) {
+                        Log.w(TAG, "Style caching failed — offline map may not work after 24h")
+                        "Map tiles saved, but offline style caching failed. " +
+                            "The map may stop working offline after 24 hours. " +
+                            "Try re-downloading while connected to the internet."
+                    } else {
+                        null
+                    }
+
+                // 4. Now safe to auto-disable HTTP — the cached
+                //    style (if successful) is already persisted.
+                val wasEnabledForDownload =
+                    settingsRepository.httpEnabledForDownloadFlow.first()
+                if (wasEnabledForDownload) {
+                    Log.d(TAG, "Auto-disabling HTTP after download (was enabled for download)")
+                    mapTileSourceManager.setHttpEnabled(false)
+                    settingsRepository.setHttpEnabledForDownload(false)
+                }
+
+                // 5. If updating, delete the old region now that
+                //    the replacement is fully downloaded and cached.
+                if (replacedRegionId != null) {
+                    deleteOldRegion(replacedRegionId)
+                }
+
+                // 6. Signal completion with any warnings.
+                //    Both httpAutoDisabled and styleCacheWarning
+                //    are set atomically so the UI can consolidate
+                //    them into a single notification.
+                _state.update {
+                    it.copy(
+                        isComplete = true,
+                        downloadProgress =
+                            it.downloadProgress?.copy(
+                                isComplete = true,
+                                statusMessage = null,
+                            ),
+                        httpAutoDisabled = wasEnabledForDownload,
+                        styleCacheWarning = styleCacheWarning,
+                    )
+                }
+            } catch (e: kotlinx.coroutines.CancellationException) {
+                throw e
+            } catch (e: Exception) {
+                Log.e(TAG, "Failed to complete region finalization", e)
+                _state.update {
+                    it.copy(
+                        downloadProgress = it.downloadProgress?.copy(statusMessage = null),
+                        errorMessage =
+                            "Error finalizing download: ${e.message}. " +
+                                "MapLibre region saved but finalization failed.",
+                    )
+                }
+            }
+        }
+
+        /**
+         * Update a legacy MBTiles region in place.
+         *
+         * Like [refreshMaplibreRegion], this revalidates the tiles already in
+         * the region's file and only downloads changed or missing ones. The region stays usable with
+         * its old tiles until the updated file is swapped in, and keeps its ID.
+         */
+        private suspend fun updateMbtilesRegion(
+            region: OfflineMapRegion,
+            lat: Double,
+            lon: Double,
+            name: String,
+        ) {
+            val file = java.io.File(region.mbtilesPath ?: return)
+            val manager = tileDownloadManagerFactory(context)
+            mbtilesUpdate = manager
+            Log.d(TAG, "Updating MBTiles region ${region.id} incrementally: ${file.name}")
+
+            val progressJob =
+                viewModelScope.launch {
+                    manager.progress.collect { progress ->
+                        _state.update {
+                            it.copy(
+                                downloadProgress =
+                                    DownloadProgress(
+                                        progress = progress.progress,
+                                        completedResources = progress.downloadedTiles.toLong(),
+                                        requiredResources = progress.totalTiles.toLong(),
+                                        statusMessage =
+                                            if (progress.reusedTiles > 0) "${progress.reusedTiles} unchanged tiles kept" else null,
+                                    ),
+                            )
+                        }
+                    }
+                }
+            try {
+                val state = _state.value
+                val updated =
+                    manager.updateRegion(
+                        existingFile = file,
+                        centerLat = lat,
+                        centerLon = lon,
+                        radiusKm = state.radiusOption.km,
+                        minZoom = state.minZoom,
+                        maxZoom = state.maxZoom,
+                        name = name,
+                        outputFile = file,
+                    )
+                val finalProgress = manager.progress.value
+                if (updated == null) {
+                    val reason = finalProgress.errorMessage ?: "Update cancelled"
+                    Log.w(TAG, "MBTiles update failed for region ${region.id}: $reason")
+                    _state.update { it.copy(errorMessage = "Update failed: $reason") }
+                    return
+                }
+
+                val failed = finalProgress.failedTiles
+                offlineMapRegionRepository.markComplete(
+                    id = region.id,
+                    tileCount = finalProgress.downloadedTiles,
+                    sizeBytes = updated.length(),
+                    mbtilesPath = updated.absolutePath,
+                    // Some tiles are still the old version; keep offering the update
+                    tileVersion = if (failed > 0) region.tileVersion else manager.lastResolvedVersion ?: region.tileVersion,
+                )
+                Log.d(
+                    TAG,
+                    "Updated region ${region.id}: ${finalProgress.reusedTiles} of ${finalProgress.downloadedTiles} tiles unchanged, " +
+                        "$failed failed",
+                )
+                _state.update {
+                    it.copy(
+                        isComplete = true,
+                        downloadProgress =
+                            it.downloadProgress?.copy(
+                                isComplete = true,
+                                statusMessage =
+                                    if (failed > 0) "$failed tiles could not be updated and kept their previous version" else null,
+                            ),
+                    )
+                }
+            } finally {
+                progressJob.cancel()
+                mbtilesUpdate = null
+                isDownloading = false
+            }
+        }
+
         /**
          * Fetch and cache the style JSON file locally for offline rendering.
          * Called after download completes successfully (while device is still online).
@@ -2,12 +2,14 @@ package network.columba.app.data.repository
 
 import app.cash.turbine.test
 import network.columba.app.data.db.entity.ConversationEntity
+import network.columba.app.data.db.entity.MessageEntity
 import network.columba.app.data.storage.AttachmentStorageManager
 import network.columba.app.test.DatabaseTest
 import io.mockk.every
 import io.mockk.mockk
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.test.StandardTestDispatcher
 import kotlinx.coroutines.test.resetMain
 import kotlinx.coroutines.test.runTest
@@ -61,6 +63,7 @@ class ConversationRepositoryDatabaseTest : DatabaseTest() {
                 localIdentityDao = localIdentityDao,
                 attachmentStorage = mockAttachmentStorage,
                 draftDao = draftDao,
+                reactionDao = reactionDao,
             )
     }
 
@@ -467,6 +470,44 @@ class ConversationRepositoryDatabaseTest : DatabaseTest() {
             assertFalse(messageDao.messageExists("msg_to_delete", TEST_IDENTITY_HASH))
         }
 
+    // ========== Legacy Reaction Compat Tests ==========
+
+    @Test
+    fun `getMessages merges reactions not yet lifted out of fieldsJson`() =
+        runTest {
+            conversationDao.insertConversation(
+                ConversationEntity(
+                    peerHash = TEST_PEER_HASH,
+                    identityHash = TEST_IDENTITY_HASH,
+                    peerName = "Peer",
+                    peerPublicKey = null,
+                    lastMessage = "Hello",
+                    lastMessageTimestamp = 1000L,
+                    unreadCount = 0,
+                    lastSeenTimestamp = 0L,
+                ),
+            )
+            // Pre-v2 row the background migration hasn't reached yet
+            messageDao.insertMessage(
+                MessageEntity(
+                    id = "msg_legacy",
+                    conversationHash = TEST_PEER_HASH,
+                    identityHash = TEST_IDENTITY_HASH,
+                    content = "Hello",
+                    timestamp = 1000L,
+                    isFromMe = false,
+                    fieldsJson = """{"16": {"reactions": {"👍": ["s1", "s2"]}}}""",
+                ),
+            )
+            repository.addReaction("msg_legacy", "👍", "s2")
+            repository.addReaction("msg_legacy", "❤️", "s3")
+
+            val reactions = repository.getMessages(TEST_PEER_HASH).first().single().reactions
+
+            assertEquals(listOf("s2", "s1"), reactions["👍"])
+            assertEquals(listOf("s3"), reactions["❤️"])
+        }
+
     // ========== Content Sanitization Tests ==========
 
     @Test
@@ -8,6 +8,7 @@ import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
 import org.junit.Assert.assertNotEquals
 import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
 import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Test
@@ -1133,4 +1134,80 @@ class MBTilesWriterRobolectricTest {
 
         db.close()
     }
+
+    // ========== Incremental Update Tests ==========
+
+    @Test
+    fun `openExisting keeps tiles already in the file`() {
+        MBTilesWriter(file = testFile, name = "Test Map").apply {
+            open()
+            writeTile(8, 1, 2, byteArrayOf(1, 2, 3))
+            close()
+        }
+
+        val writer = MBTilesWriter(file = testFile, name = "Renamed Map")
+        writer.openExisting()
+        writer.writeTile(8, 3, 4, byteArrayOf(4))
+
+        assertNotNull(writer.getTileValidator(8, 1, 2))
+        assertNotNull(writer.getTileValidator(8, 3, 4))
+        writer.close()
+    }
+
+    @Test
+    fun `getTileValidator returns stored http validators`() {
+        val writer = MBTilesWriter(file = testFile, name = "Test Map")
+        writer.open()
+        val data = byteArrayOf(7, 8, 9)
+
+        writer.writeTile(10, 5, 6, data, etag = "\"abc\"", lastModified = "Wed, 01 Jan 2025 00:00:00 GMT")
+
+        assertEquals(
+            MBTilesWriter.TileValidator("\"abc\"", "Wed, 01 Jan 2025 00:00:00 GMT", MBTilesWriter.contentHash(data)),
+            writer.getTileValidator(10, 5, 6),
+        )
+        assertNull(writer.getTileValidator(10, 5, 7))
+        writer.close()
+    }
+
+    @Test
+    fun `getTileValidator hashes tiles written without validators`() {
+        val data = byteArrayOf(1, 1, 2, 3, 5)
+        writeLegacyTile(testFile, z = 8, x = 1, tmsY = MBTilesWriter.flipY(8, 2), data = data)
+
+        val writer = MBTilesWriter(file = testFile, name = "Test Map")
+        writer.openExisting()
+
+        assertEquals(MBTilesWriter.TileValidator(null, null, MBTilesWriter.contentHash(data)), writer.getTileValidator(8, 1, 2))
+        writer.close()
+    }
+
+    @Test
+    fun `deleteTile removes tile and validators`() {
+        val writer = MBTilesWriter(file = testFile, name = "Test Map")
+        writer.open()
+        writer.writeTile(8, 1, 2, byteArrayOf(1), etag = "\"e\"")
+
+        writer.deleteTile(8, 1, 2)
+
+        assertNull(writer.getTileValidator(8, 1, 2))
+        writer.close()
+    }
+
+    /** A file as written before validators existed: tiles table only. */
+    private fun writeLegacyTile(
+        file: File,
+        z: Int,
+        x: Int,
+        tmsY: Int,
+        data: ByteArray,
+    ) {
+        val db = SQLiteDatabase.openOrCreateDatabase(file, null)
+        db.execSQL(
+            "CREATE TABLE tiles (zoom_level INTEGER NOT NULL, tile_column INTEGER NOT NULL, " +
+                "tile_row INTEGER NOT NULL, tile_data BLOB NOT NULL, PRIMARY KEY (zoom_level, tile_column, tile_row))",
+        )
+        db.execSQL("INSERT INTO tiles VALUES (?, ?, ?, ?)", arrayOf<Any>(z, x, tmsY, data))
+        db.close()
+    }
 }
@@ -2,7 +2,9 @@ package network.columba.app.map
 
 import android.app.Application
 import android.content.Context
+import android.database.sqlite.SQLiteDatabase
 import androidx.test.core.app.ApplicationProvider
+import com.sun.net.httpserver.HttpServer
 import io.mockk.clearAllMocks
 import io.mockk.mockkConstructor
 import io.mockk.unmockkConstructor
@@ -29,8 +31,11 @@ import org.junit.runner.RunWith
 import org.robolectric.RobolectricTestRunner
 import org.robolectric.annotation.Config
 import java.io.File
+import java.net.InetSocketAddress
 import java.nio.ByteBuffer
 import java.nio.ByteOrder
+import java.time.ZonedDateTime
+import java.time.format.DateTimeFormatter
 import kotlin.math.abs
 
 /**
@@ -1325,6 +1330,154 @@ class TileDownloadManagerRobolectricTest {
             unmockkConstructor(MBTilesWriter::class)
         }
 
+    // ========== Incremental Update Tests ==========
+
+    @Test
+    fun `updateRegion revalidates stored tiles and fetches only changed ones`() =
+        runTest {
+            val server = TileStubServer().apply { start() }
+            try {
+                val file = File(testOutputDir, "update.mbtiles")
+                val manager = TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                assertNotNull(manager.downloadRegion(37.7749, -122.4194, 2, 12, 13, "Update", file))
+                val tiles = server.servedTiles()
+                assertTrue("Region should span several tiles", tiles.size > 4)
+
+                // New planet version: a couple of tiles changed
+                val changed = tiles.take(2).toSet()
+                server.version = "v2"
+                changed.forEach { server.content[it] = "changed $it".toByteArray() }
+                server.resetCounts()
+
+                val updated =
+                    TileDownloadManager(context, TileSource.Http(server.baseUrl)).run {
+                        updateRegion(file, 37.7749, -122.4194, 2, 12, 13, "Update", file).also {
+                            assertEquals(tiles.size - changed.size, progress.value.reusedTiles)
+                        }
+                    }
+
+                assertEquals(file, updated)
+                assertEquals(changed.size, server.fullResponses.get())
+                assertEquals(tiles.size - changed.size, server.notModifiedResponses.get())
+                assertFalse(File(testOutputDir, "update.mbtiles${TileDownloadManager.STAGING_SUFFIX}").exists())
+                val stored = readTiles(file)
+                assertEquals(tiles.size, stored.size)
+                changed.forEach { assertEquals("changed $it", stored[it]) }
+                (tiles - changed).forEach { assertEquals("tile $it", stored[it]) }
+            } finally {
+                server.stop()
+            }
+        }
+
+    @Test
+    fun `updateRegion keeps identical tiles when the server sends no validators`() =
+        runTest {
+            val server = TileStubServer().apply { start() }
+            try {
+                val file = File(testOutputDir, "no_etag.mbtiles")
+                TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                    .downloadRegion(37.7749, -122.4194, 2, 12, 12, "No ETag", file)
+                val tiles = server.servedTiles()
+                server.sendValidators = false
+                server.content[tiles.first()] = "changed".toByteArray()
+
+                val manager = TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                val updated = manager.updateRegion(file, 37.7749, -122.4194, 2, 12, 12, "No ETag", file)
+
+                assertNotNull(updated)
+                assertEquals(tiles.size - 1, manager.progress.value.reusedTiles)
+                assertEquals("changed", readTiles(file)[tiles.first()])
+            } finally {
+                server.stop()
+            }
+        }
+
+    @Test
+    fun `updateRegion asks whether hash-only tiles changed since the file was written`() =
+        runTest {
+            val server = TileStubServer().apply { start() }
+            try {
+                // No server validators stored, as in files from before they were recorded
+                server.sendValidators = false
+                val file = File(testOutputDir, "legacy.mbtiles")
+                TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                    .downloadRegion(37.7749, -122.4194, 2, 12, 12, "Legacy", file)
+                val tiles = server.servedTiles()
+                server.honourModifiedSince = true
+                server.content[tiles.first()] = "changed".toByteArray()
+                server.modifiedAtMs[tiles.first()] = System.currentTimeMillis() + 60_000
+                server.resetCounts()
+
+                val manager = TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                assertNotNull(manager.updateRegion(file, 37.7749, -122.4194, 2, 12, 12, "Legacy", file))
+
+                assertEquals(1, server.fullResponses.get())
+                assertEquals(tiles.size - 1, server.notModifiedResponses.get())
+                assertEquals("changed", readTiles(file)[tiles.first()])
+            } finally {
+                server.stop()
+            }
+        }
+
+    @Test
+    fun `httpDate formats an IMF-fixdate`() {
+        assertEquals("Thu, 01 Jan 1970 00:00:00 GMT", TileDownloadManager.httpDate(0))
+        assertEquals("Sat, 17 Oct 2026 08:05:09 GMT", TileDownloadManager.httpDate(1_792_224_309_000))
+    }
+
+    @Test
+    fun `updateRegion leaves the existing file untouched when it fails`() =
+        runTest {
+            val server = TileStubServer().apply { start() }
+            val file = File(testOutputDir, "keep.mbtiles")
+            try {
+                TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                    .downloadRegion(37.7749, -122.4194, 1, 12, 12, "Keep", file)
+            } finally {
+                server.stop()
+            }
+            val before = file.readBytes()
+
+            // Server gone: every tile fails, so the update is abandoned
+            val manager = TileDownloadManager(context, TileSource.Http(server.baseUrl))
+            manager.updateRegion(file, 37.7749, -122.4194, 1, 12, 12, "Keep", file)
+
+            assertTrue(before.contentEquals(file.readBytes()))
+            assertFalse(File(testOutputDir, "keep.mbtiles${TileDownloadManager.STAGING_SUFFIX}").exists())
+        }
+
+    @Test
+    fun `updateRegion keeps the stored copy of tiles that fail and applies the rest`() =
+        runTest {
+            val server = TileStubServer().apply { start() }
+            try {
+                val file = File(testOutputDir, "partial.mbtiles")
+                TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                    .downloadRegion(37.7749, -122.4194, 2, 12, 12, "Partial", file)
+                val tiles = server.servedTiles()
+                assertTrue("Region should span several tiles", tiles.size > 2)
+
+                val (broken, changed) = tiles.take(2)
+                server.version = "v2"
+                server.content[broken] = "changed $broken".toByteArray()
+                server.content[changed] = "changed $changed".toByteArray()
+                server.failing.add(broken)
+
+                val manager = TileDownloadManager(context, TileSource.Http(server.baseUrl))
+                val updated = manager.updateRegion(file, 37.7749, -122.4194, 2, 12, 12, "Partial", file)
+
+                assertEquals(file, updated)
+                assertEquals(1, manager.progress.value.failedTiles)
+                assertEquals(TileDownloadManager.DownloadProgress.Status.COMPLETE, manager.progress.value.status)
+                val stored = readTiles(file)
+                assertEquals(tiles.size, stored.size)
+                assertEquals("tile $broken", stored[broken])
+                assertEquals("changed $changed", stored[changed])
+            } finally {
+                server.stop()
+            }
+        }
+
     // ========== Helper Functions ==========
 
     /**
@@ -1352,4 +1505,100 @@ class TileDownloadManagerRobolectricTest {
 
         return buffer.array()
     }
+
+    /** Tile contents by "z/x/y" (XYZ), read back from an MBTiles file. */
+    private fun readTiles(file: File): Map<String, String> {
+        val db = SQLiteDatabase.openDatabase(file.path, null, SQLiteDatabase.OPEN_READONLY)
+        return try {
+            db.rawQuery("SELECT zoom_level, tile_column, tile_row, tile_data FROM tiles", null).use { cursor ->
+                buildMap {
+                    while (cursor.moveToNext()) {
+                        val z = cursor.getInt(0)
+                        put("$z/${cursor.getInt(1)}/${MBTilesWriter.tmsToXyzY(z, cursor.getInt(2))}", String(cursor.getBlob(3)))
+                    }
+                }
+            }
+        } finally {
+            db.close()
+        }
+    }
+
+    /**
+     * Local tile server: TileJSON at /planet pointing at versioned tile URLs,
+     * tiles with content-based ETags, and 304s for matching If-None-Match
+     * (or, when [honourModifiedSince], for tiles unchanged since If-Modified-Since).
+     */
+    private class TileStubServer {
+        private val server = HttpServer.create(InetSocketAddress("127.0.0.1", 0), 0)
+        val baseUrl get() = "http://127.0.0.1:${server.address.port}/planet"
+
+        @Volatile
+        var version = "v1"
+
+        @Volatile
+        var sendValidators = true
+
+        @Volatile
+        var honourModifiedSince = false
+
+        /** Last change by "z/x/y"; other tiles never changed. */
+        val modifiedAtMs = java.util.concurrent.ConcurrentHashMap<String, Long>()
+
+        /** Tiles by "z/x/y" that get an HTTP 500. */
+        val failing: MutableSet<String> = java.util.concurrent.ConcurrentHashMap.newKeySet()
+
+        /** Overrides by "z/x/y"; other tiles are "tile z/x/y". */
+        val content = java.util.concurrent.ConcurrentHashMap<String, ByteArray>()
+        val fullResponses = java.util.concurrent.atomic.AtomicInteger()
+        val notModifiedResponses = java.util.concurrent.atomic.AtomicInteger()
+        private val served = java.util.concurrent.ConcurrentHashMap.newKeySet<String>()
+
+        fun start() {
+            server.createContext("/planet") { exchange ->
+                val path = exchange.requestURI.path.removePrefix("/planet").trim('/')
+                if (path.isEmpty()) {
+                    val body = """{"tiles":["$baseUrl/$version/{z}/{x}/{y}.pbf"]}""".toByteArray()
+                    exchange.sendResponseHeaders(200, body.size.toLong())
+                    exchange.responseBody.use { it.write(body) }
+                    return@createContext
+                }
+                val key = path.substringAfter('/').removeSuffix(".pbf")
+                served.add(key)
+                if (key in failing) {
+                    exchange.sendResponseHeaders(500, -1)
+                    exchange.close()
+                    return@createContext
+                }
+                val body = content[key] ?: "tile $key".toByteArray()
+                val etag = "\"${MBTilesWriter.contentHash(body)}\""
+                if (sendValidators) exchange.responseHeaders.add("ETag", etag)
+                val since =
+                    exchange.requestHeaders.getFirst("If-Modified-Since")?.let {
+                        ZonedDateTime.parse(it, DateTimeFormatter.RFC_1123_DATE_TIME).toInstant().toEpochMilli()
+                    }
+                val notModified =
+                    (sendValidators && exchange.requestHeaders.getFirst("If-None-Match") == etag) ||
+                        (honourModifiedSince && since != null && (modifiedAtMs[key] ?: 0L) <= since)
+                if (notModified) {
+                    notModifiedResponses.incrementAndGet()
+                    exchange.sendResponseHeaders(304, -1)
+                } else {
+                    fullResponses.incrementAndGet()
+                    exchange.sendResponseHeaders(200, body.size.toLong())
+                    exchange.responseBody.use { it.write(body) }
+                }
+                exchange.close()
+            }
+            server.start()
+        }
+
+        fun servedTiles(): List<String> = served.sorted()
+
+        fun resetCounts() {
+            fullResponses.set(0)
+            notModifiedResponses.set(0)
+        }
+
+        fun stop() = server.stop(0)
+    }
 }
@@ -0,0 +1,173 @@
+package network.columba.app.notifications
+
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.advanceUntilIdle
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.util.Collections
+import kotlin.concurrent.thread
+
+/**
+ * Unit tests for MessageNotificationDispatcher: batching window, ordering,
+ * history and the per-flush rate cap. Runs on virtual time.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class MessageNotificationDispatcherTest {
+    private data class Flush(
+        val atMs: Long,
+        val updated: List<ConversationNotification>,
+        val all: List<ConversationNotification>,
+    ) {
+        // One notify per updated conversation, plus the summary once there are two
+        val notifyCalls: Int get() = updated.size + if (all.size >= 2) 1 else 0
+    }
+
+    private fun TestScope.dispatcher(flushes: MutableList<Flush>) =
+        MessageNotificationDispatcher(backgroundScope) { updated, all ->
+            flushes.add(Flush(testScheduler.currentTime, updated, all))
+        }
+
+    private fun MessageNotificationDispatcher.submit(
+        hash: String,
+        text: String,
+    ) = submit(hash, "Peer $hash", NotificationMessage(text, 0L))
+
+    // ========== Batching Tests ==========
+
+    @Test
+    fun `burst within the window becomes one flush`() =
+        runTest {
+            val flushes = mutableListOf<Flush>()
+            val dispatcher = dispatcher(flushes)
+
+            repeat(200) { i -> dispatcher.submit("peer${i % 3}", "m$i") }
+            advanceUntilIdle()
+
+            assertEquals(1, flushes.size)
+            assertEquals(MessageNotificationDispatcher.DEFAULT_WINDOW_MS, flushes.single().atMs)
+            assertEquals(listOf(67, 67, 66), flushes.single().updated.map { it.messageCount })
+        }
+
+    @Test
+    fun `conversations flush in order of first message and keep message order`() =
+        runTest {
+            val flushes = mutableListOf<Flush>()
+            val dispatcher = dispatcher(flushes)
+
+            dispatcher.submit("b", "b1")
+            dispatcher.submit("a", "a1")
+            dispatcher.submit("b", "b2")
+            dispatcher.submit("c", "c1")
+            dispatcher.submit("a", "a2")
+            advanceUntilIdle()
+
+            val updated = flushes.single().updated
+            assertEquals(listOf("b", "a", "c"), updated.map { it.destinationHash })
+            assertEquals(listOf("b1", "b2"), updated[0].messages.map { it.text })
+            assertEquals(listOf("a1", "a2"), updated[1].messages.map { it.text })
+        }
+
+    @Test
+    fun `history keeps the latest messages and counts accumulate across flushes`() =
+        runTest {
+            val flushes = mutableListOf<Flush>()
+            val dispatcher = dispatcher(flushes)
+
+            repeat(10) { i -> dispatcher.submit("a", "m$i") }
+            advanceUntilIdle()
+            dispatcher.submit("a", "m10")
+            advanceUntilIdle()
+
+            val latest = flushes.last().updated.single()
+            assertEquals(11, latest.messageCount)
+            assertEquals((4..10).map { "m$it" }, latest.messages.map { it.text })
+        }
+
+    @Test
+    fun `dismiss resets a conversation`() =
+        runTest {
+            val flushes = mutableListOf<Flush>()
+            val dispatcher = dispatcher(flushes)
+            dispatcher.submit("a", "old")
+            dispatcher.submit("b", "hi")
+            advanceUntilIdle()
+
+            val remaining = dispatcher.dismiss("a")
+            dispatcher.submit("a", "new")
+            advanceUntilIdle()
+
+            assertEquals(listOf("b"), remaining.map { it.destinationHash })
+            val latest = flushes.last().updated.single()
+            assertEquals(1, latest.messageCount)
+            assertEquals(listOf("new"), latest.messages.map { it.text })
+        }
+
+    @Test
+    fun `dismiss waits for an in-flight post`() =
+        runTest {
+            val events = Collections.synchronizedList(mutableListOf<String>())
+            var dismisser: Thread? = null
+            lateinit var dispatcher: MessageNotificationDispatcher
+            dispatcher =
+                MessageNotificationDispatcher(backgroundScope) { _, _ ->
+                    dismisser = thread { dispatcher.dismiss("a") { events.add("dismissed") } }
+                    // Held lock: the dismissal cannot run while the post is in progress
+                    dismisser?.join(100)
+                    events.add("posted")
+                }
+
+            dispatcher.submit("a", "m")
+            advanceUntilIdle()
+            dismisser?.join()
+
+            assertEquals(listOf("posted", "dismissed"), events.toList())
+        }
+
+    // ========== Rate Cap Tests ==========
+
+    @Test
+    fun `reconnect burst across many conversations respects the rate cap`() =
+        runTest {
+            val flushes = mutableListOf<Flush>()
+            val dispatcher = dispatcher(flushes)
+            val conversations = (0 until 30).map { "peer$it" }
+
+            // 300 messages in arrival order, 10 per conversation, interleaved
+            repeat(10) { round -> conversations.forEach { dispatcher.submit(it, "r$round") } }
+            advanceUntilIdle()
+
+            assertTrue(flushes.all { it.updated.size <= MessageNotificationDispatcher.DEFAULT_MAX_CONVERSATIONS_PER_FLUSH })
+            assertTrue(flushes.all { it.notifyCalls <= 5 })
+            flushes.zipWithNext().forEach { (a, b) ->
+                assertTrue(b.atMs - a.atMs >= MessageNotificationDispatcher.DEFAULT_MIN_FLUSH_INTERVAL_MS)
+            }
+            // Every conversation posted exactly once, oldest first, with all its messages
+            assertEquals(conversations, flushes.flatMap { f -> f.updated.map { it.destinationHash } })
+            assertTrue(flushes.flatMap { it.updated }.all { it.messageCount == 10 })
+            println("300 messages / 30 conversations: ${flushes.sumOf { it.notifyCalls }} notify calls in ${flushes.size} flushes")
+        }
+
+    @Test
+    fun `messages arriving right after a flush wait out the interval`() =
+        runTest {
+            val flushes = mutableListOf<Flush>()
+            val dispatcher = dispatcher(flushes)
+
+            dispatcher.submit("a", "first")
+            advanceTimeBy(MessageNotificationDispatcher.DEFAULT_WINDOW_MS)
+            runCurrent()
+            dispatcher.submit("a", "second")
+            advanceUntilIdle()
+
+            assertEquals(2, flushes.size)
+            assertEquals(
+                flushes[0].atMs + MessageNotificationDispatcher.DEFAULT_MIN_FLUSH_INTERVAL_MS,
+                flushes[1].atMs,
+            )
+        }
+}
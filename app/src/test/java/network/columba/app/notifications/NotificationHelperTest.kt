@@ -2,16 +2,25 @@ package network.columba.app.notifications
 
 import android.Manifest
 import android.app.Application
+import android.app.Notification
 import android.app.NotificationManager
 import android.content.Context
 import network.columba.app.repository.SettingsRepository
+import network.columba.app.repository.SettingsSnapshot
 import network.columba.app.service.ActiveConversationManager
 import io.mockk.coEvery
 import io.mockk.every
 import io.mockk.mockk
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.MutableStateFlow
-import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.UnconfinedTestDispatcher
+import kotlinx.coroutines.test.advanceUntilIdle
+import org.junit.After
+import org.junit.Assert.assertEquals
 import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Test
@@ -27,6 +36,7 @@ import org.robolectric.annotation.Config
  *
  * Uses Robolectric's shadow system for Android component testing.
  */
+@OptIn(ExperimentalCoroutinesApi::class)
 @RunWith(RobolectricTestRunner::class)
 @Config(sdk = [34], application = Application::class)
 class NotificationHelperTest {
@@ -37,6 +47,22 @@ class NotificationHelperTest {
     private lateinit var notificationHelper: NotificationHelper
 
     private val activeConversationFlow = MutableStateFlow<String?>(null)
+    private val readConversationsFlow = MutableSharedFlow<String>(extraBufferCapacity = 16)
+    private val settingsFlow =
+        MutableStateFlow<SettingsSnapshot?>(
+            SettingsSnapshot(
+                notificationHeardAnnounce = true,
+                notificationBleConnected = true,
+                notificationBleDisconnected = true,
+            ),
+        )
+
+    private fun updateSettings(transform: SettingsSnapshot.() -> SettingsSnapshot) {
+        settingsFlow.value = settingsFlow.value!!.transform()
+    }
+
+    // Runs the helper's settings cache and message batching; advanceUntilIdle() flushes
+    private val testScope = TestScope(UnconfinedTestDispatcher())
 
     @Before
     fun setup() {
@@ -53,16 +79,17 @@ class NotificationHelperTest {
 
         // Mock active conversation
         every { activeConversationManager.activeConversation } returns activeConversationFlow
+        every { activeConversationManager.readConversations } returns readConversationsFlow
 
         // Default settings: all notifications enabled
-        coEvery { settingsRepository.notificationsEnabledFlow } returns flowOf(true)
-        coEvery { settingsRepository.notificationReceivedMessageFlow } returns flowOf(true)
-        coEvery { settingsRepository.notificationReceivedMessageFavoriteFlow } returns flowOf(true)
-        coEvery { settingsRepository.notificationHeardAnnounceFlow } returns flowOf(true)
-        coEvery { settingsRepository.notificationBleConnectedFlow } returns flowOf(true)
-        coEvery { settingsRepository.notificationBleDisconnectedFlow } returns flowOf(true)
-
-        notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager)
+        coEvery { settingsRepository.currentSettings() } answers { settingsFlow.value!! }
+
+        notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager, testScope)
+    }
+
+    @After
+    fun tearDown() {
+        testScope.cancel()
     }
 
     // ========== Master Toggle Tests ==========
@@ -71,10 +98,10 @@ class NotificationHelperTest {
     fun `notifyMessageReceived does not post when master toggle is off`() =
         runBlocking {
             // Given: Master toggle is OFF
-            coEvery { settingsRepository.notificationsEnabledFlow } returns flowOf(false)
+            updateSettings { copy(notificationsEnabled = false) }
 
             // Recreate helper with new settings
-            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager)
+            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager, testScope)
 
             // When
             notificationHelper.notifyMessageReceived(
@@ -83,6 +110,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: No notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -102,6 +130,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -115,9 +144,8 @@ class NotificationHelperTest {
     fun `notifyMessageReceived blocked when message notifications disabled for non-favorite`() =
         runBlocking {
             // Given: General message notifications OFF
-            coEvery { settingsRepository.notificationReceivedMessageFlow } returns flowOf(false)
-            coEvery { settingsRepository.notificationReceivedMessageFavoriteFlow } returns flowOf(false)
-            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager)
+            updateSettings { copy(notificationReceivedMessage = false, notificationReceivedMessageFavorite = false) }
+            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager, testScope)
 
             // When: Non-favorite peer sends message
             notificationHelper.notifyMessageReceived(
@@ -126,6 +154,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: No notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -137,9 +166,8 @@ class NotificationHelperTest {
     fun `notifyMessageReceived allowed for favorite when favorite notifications enabled`() =
         runBlocking {
             // Given: General OFF but favorite ON
-            coEvery { settingsRepository.notificationReceivedMessageFlow } returns flowOf(false)
-            coEvery { settingsRepository.notificationReceivedMessageFavoriteFlow } returns flowOf(true)
-            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager)
+            updateSettings { copy(notificationReceivedMessage = false, notificationReceivedMessageFavorite = true) }
+            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager, testScope)
 
             // When: Favorite peer sends message
             notificationHelper.notifyMessageReceived(
@@ -148,6 +176,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = true,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -159,9 +188,8 @@ class NotificationHelperTest {
     fun `notifyMessageReceived allowed for favorite when general notifications enabled`() =
         runBlocking {
             // Given: General ON, favorite OFF
-            coEvery { settingsRepository.notificationReceivedMessageFlow } returns flowOf(true)
-            coEvery { settingsRepository.notificationReceivedMessageFavoriteFlow } returns flowOf(false)
-            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager)
+            updateSettings { copy(notificationReceivedMessage = true, notificationReceivedMessageFavorite = false) }
+            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager, testScope)
 
             // When: Favorite peer sends message
             notificationHelper.notifyMessageReceived(
@@ -170,6 +198,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = true,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification posted (general covers favorites too)
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -193,6 +222,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification NOT posted (suppressed — user can see the conversation)
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -214,6 +244,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification IS posted (user can't see the conversation)
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -234,6 +265,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -254,6 +286,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -272,7 +305,7 @@ class NotificationHelperTest {
             app.denyPermissions(Manifest.permission.POST_NOTIFICATIONS)
 
             // Recreate helper after permission change
-            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager)
+            notificationHelper = NotificationHelper(context, settingsRepository, activeConversationManager, testScope)
 
             // When
             notificationHelper.notifyMessageReceived(
@@ -281,6 +314,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: No notification posted
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -302,6 +336,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Notification posted (no permission needed on Android 12)
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -321,6 +356,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello world",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -345,6 +381,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello world",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -375,6 +412,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             notificationHelper.notifyMessageReceived(
                 destinationHash = hash2,
@@ -382,6 +420,7 @@ class NotificationHelperTest {
                 messagePreview = "Hi",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             // Then: Two separate notifications posted (different IDs)
             val shadowNotificationManager = shadowOf(notificationManager)
@@ -389,6 +428,124 @@ class NotificationHelperTest {
             assertTrue("Should have 2 notifications", notifications.size >= 2)
         }
 
+    @Test
+    fun `conversation ID never collides with the group summary`() =
+        runBlocking {
+            // String.hashCode() of the first is -1: 1000 + hash used to land on the summary's 999
+            listOf("00243ca6a9", "peer_b").forEach { hash ->
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = hash,
+                    peerName = hash,
+                    messagePreview = "Hello",
+                    isFavorite = false,
+                )
+            }
+            testScope.advanceUntilIdle()
+
+            val notifications = shadowOf(notificationManager).allNotifications
+            assertEquals(3, notifications.size)
+            assertEquals(1, notifications.count { it.flags and Notification.FLAG_GROUP_SUMMARY != 0 })
+        }
+
+    // ========== Burst Coalescing Tests ==========
+
+    @Test
+    fun `burst from one sender posts one notification carrying the count`() =
+        runBlocking {
+            repeat(50) { i ->
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = "abc123def456",
+                    peerName = "Peer",
+                    messagePreview = "Message $i",
+                    isFavorite = false,
+                )
+            }
+            testScope.advanceUntilIdle()
+
+            val notifications = shadowOf(notificationManager).allNotifications
+            assertEquals(1, notifications.size)
+            assertEquals(50, notifications.single().number)
+            assertEquals("Message 49", shadowOf(notifications.single()).contentText?.toString())
+        }
+
+    @Test
+    fun `burst across conversations adds a group summary`() =
+        runBlocking {
+            listOf("peer_a", "peer_b", "peer_c").forEach { hash ->
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = hash,
+                    peerName = hash,
+                    messagePreview = "Hello",
+                    isFavorite = false,
+                )
+            }
+            testScope.advanceUntilIdle()
+
+            val notifications = shadowOf(notificationManager).allNotifications
+            assertEquals(4, notifications.size)
+            assertEquals(1, notifications.count { it.flags and Notification.FLAG_GROUP_SUMMARY != 0 })
+        }
+
+    @Test
+    fun `opening a conversation clears its notification`() =
+        runBlocking {
+            notificationHelper.notifyMessageReceived(
+                destinationHash = "abc123def456",
+                peerName = "Peer",
+                messagePreview = "Hello",
+                isFavorite = false,
+            )
+            testScope.advanceUntilIdle()
+
+            activeConversationFlow.value = "abc123def456"
+            testScope.advanceUntilIdle()
+
+            assertTrue(shadowOf(notificationManager).allNotifications.isEmpty())
+        }
+
+    @Test
+    fun `marking a conversation read clears its notification`() =
+        runBlocking {
+            notificationHelper.notifyMessageReceived(
+                destinationHash = "abc123def456",
+                peerName = "Peer",
+                messagePreview = "Hello",
+                isFavorite = false,
+            )
+            testScope.advanceUntilIdle()
+
+            readConversationsFlow.emit("abc123def456")
+            testScope.advanceUntilIdle()
+
+            assertTrue(shadowOf(notificationManager).allNotifications.isEmpty())
+        }
+
+    @Test
+    fun `swiping a notification away forgets its history`() =
+        runBlocking {
+            notificationHelper.notifyMessageReceived(
+                destinationHash = "abc123def456",
+                peerName = "Peer",
+                messagePreview = "Hello",
+                isFavorite = false,
+            )
+            testScope.advanceUntilIdle()
+            val posted = shadowOf(notificationManager).allNotifications.single()
+            assertTrue("Delete intent should be set", posted.deleteIntent != null)
+
+            notificationHelper.dismissConversation("abc123def456")
+            notificationHelper.notifyMessageReceived(
+                destinationHash = "abc123def456",
+                peerName = "Peer",
+                messagePreview = "Again",
+                isFavorite = false,
+            )
+            testScope.advanceUntilIdle()
+
+            // The new notification starts over instead of counting the dismissed message
+            assertEquals(1, shadowOf(notificationManager).allNotifications.single().number)
+        }
+
     // ========== Notification Channel Tests ==========
 
     @Test
@@ -423,6 +580,7 @@ class NotificationHelperTest {
                 messagePreview = "Hello",
                 isFavorite = false,
             )
+            testScope.advanceUntilIdle()
 
             val shadowNotificationManager = shadowOf(notificationManager)
             assertTrue("Notification should exist", shadowNotificationManager.allNotifications.isNotEmpty())
@@ -10,8 +10,11 @@ import network.columba.app.rns.host.persistence.ServiceSettingsAccessor
 import io.mockk.clearAllMocks
 import io.mockk.every
 import io.mockk.mockk
+import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
 import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.test.StandardTestDispatcher
 import kotlinx.coroutines.test.resetMain
@@ -47,6 +50,7 @@ class SettingsRepositoryCrossProcessTest {
     private lateinit var mockCustomThemeRepository: CustomThemeRepository
     private lateinit var repository: SettingsRepository
     private lateinit var crossProcessPrefs: SharedPreferences
+    private lateinit var repositoryScope: CoroutineScope
 
     @Before
     fun setup() {
@@ -58,7 +62,8 @@ class SettingsRepositoryCrossProcessTest {
         every { mockCustomThemeRepository.getAllThemes() } returns flowOf(emptyList())
         every { mockCustomThemeRepository.getThemeByIdFlow(any()) } returns flowOf(null)
 
-        repository = SettingsRepository(context, mockCustomThemeRepository)
+        repositoryScope = CoroutineScope(SupervisorJob() + Dispatchers.Unconfined)
+        repository = SettingsRepository(context, mockCustomThemeRepository, repositoryScope)
 
         // Get direct access to cross-process SharedPreferences for testing
         @Suppress("DEPRECATION")
@@ -74,6 +79,7 @@ class SettingsRepositoryCrossProcessTest {
 
     @After
     fun tearDown() {
+        repositoryScope.cancel()
         Dispatchers.resetMain()
         clearAllMocks()
         crossProcessPrefs.edit().clear().apply()
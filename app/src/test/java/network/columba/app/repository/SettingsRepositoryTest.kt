@@ -8,8 +8,12 @@ import network.columba.app.data.repository.CustomThemeRepository
 import io.mockk.clearAllMocks
 import io.mockk.every
 import io.mockk.mockk
+import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.flow.filterNotNull
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.test.StandardTestDispatcher
@@ -44,6 +48,9 @@ class SettingsRepositoryTest {
     private lateinit var mockCustomThemeRepository: CustomThemeRepository
     private lateinit var repository: SettingsRepository
 
+    // Holds settingsSnapshot hot, as the application scope does in the app
+    private lateinit var repositoryScope: CoroutineScope
+
     @Before
     fun setup() {
         Dispatchers.setMain(testDispatcher)
@@ -56,11 +63,13 @@ class SettingsRepositoryTest {
         every { mockCustomThemeRepository.getAllThemes() } returns flowOf(emptyList())
         every { mockCustomThemeRepository.getThemeByIdFlow(any()) } returns flowOf(null)
 
-        repository = SettingsRepository(context, mockCustomThemeRepository)
+        repositoryScope = CoroutineScope(SupervisorJob() + Dispatchers.Unconfined)
+        repository = SettingsRepository(context, mockCustomThemeRepository, repositoryScope)
     }
 
     @After
     fun tearDown() {
+        repositoryScope.cancel()
         Dispatchers.resetMain()
         clearAllMocks()
     }
@@ -1167,6 +1176,79 @@ class SettingsRepositoryTest {
             assertFalse("Both should be false after save(false)", methodValue)
         }
 
+    // ========== Settings Snapshot Tests ==========
+
+    @Test
+    fun settingsSnapshot_reflectsSavedValues() =
+        runTest {
+            repository.saveNotificationHeardAnnounce(true)
+            repository.saveAutoAnnounceIntervalHours(7)
+            repository.saveBlockUnknownSenders(true)
+
+            val snapshot =
+                repository.settingsSnapshot.filterNotNull().first {
+                    it.notificationHeardAnnounce && it.autoAnnounceIntervalHours == 7 && it.blockUnknownSenders
+                }
+
+            assertEquals(repository.notificationsEnabledFlow.first(), snapshot.notificationsEnabled)
+            assertEquals(repository.locationSharingEnabledFlow.first(), snapshot.locationSharingEnabled)
+        }
+
+    @Test
+    fun currentSettings_matchesIndividualFlows() =
+        runTest {
+            repository.saveNotificationAnnounceDirectOnly(false)
+            repository.saveAllowVoiceCalls(false)
+            repository.settingsSnapshot.filterNotNull().first { !it.notificationAnnounceDirectOnly && !it.allowVoiceCalls }
+
+            val snapshot = repository.currentSettings()
+
+            assertEquals(repository.notificationsEnabledFlow.first(), snapshot.notificationsEnabled)
+            assertEquals(repository.notificationHeardAnnounceFlow.first(), snapshot.notificationHeardAnnounce)
+            assertEquals(repository.notificationAnnounceDirectOnlyFlow.first(), snapshot.notificationAnnounceDirectOnly)
+            assertEquals(repository.notificationAnnounceExcludeTcpFlow.first(), snapshot.notificationAnnounceExcludeTcp)
+            assertEquals(repository.autoAnnounceEnabledFlow.first(), snapshot.autoAnnounceEnabled)
+            assertEquals(repository.allowCallsFromContactsOnlyFlow.first(), snapshot.allowCallsFromContactsOnly)
+            assertEquals(repository.allowVoiceCallsFlow.first(), snapshot.allowVoiceCalls)
+        }
+
+    @Test
+    fun settingsSnapshot_perEventReadCost() =
+        runTest {
+            val events = 2_000
+            repository.currentSettings()
+
+            // Before: the announce check read four flows per event
+            val flowStart = System.nanoTime()
+            var flowPasses = 0
+            repeat(events) {
+                val pass =
+                    repository.notificationsEnabledFlow.first() &&
+                        repository.notificationHeardAnnounceFlow.first() &&
+                        !repository.notificationAnnounceDirectOnlyFlow.first() &&
+                        !repository.notificationAnnounceExcludeTcpFlow.first()
+                if (pass) flowPasses++
+            }
+            val flowMs = (System.nanoTime() - flowStart) / 1_000_000
+
+            // After: one field read off the current snapshot
+            val snapshotStart = System.nanoTime()
+            var snapshotPasses = 0
+            repeat(events) {
+                val settings = repository.currentSettings()
+                val pass =
+                    settings.notificationsEnabled &&
+                        settings.notificationHeardAnnounce &&
+                        !settings.notificationAnnounceDirectOnly &&
+                        !settings.notificationAnnounceExcludeTcp
+                if (pass) snapshotPasses++
+            }
+            val snapshotMs = (System.nanoTime() - snapshotStart) / 1_000_000
+            println("$events announce checks: 4 flow reads ${flowMs}ms, snapshot ${snapshotMs}ms")
+
+            assertEquals(flowPasses, snapshotPasses)
+        }
+
     // ========== Telemetry Collector Flow Tests ==========
 
     @Test
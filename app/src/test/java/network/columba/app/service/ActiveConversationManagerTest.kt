@@ -1,5 +1,6 @@
 package network.columba.app.service
 
+import app.cash.turbine.test
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.test.runTest
 import org.junit.Assert.assertEquals
@@ -87,4 +88,14 @@ class ActiveConversationManagerTest {
 
             assertEquals(listOf(null, testHash, null), values)
         }
+
+    @Test
+    fun `markRead emits the conversation`() =
+        runTest {
+            manager.readConversations.test {
+                manager.markRead("abc123")
+
+                assertEquals("abc123", awaitItem())
+            }
+        }
 }
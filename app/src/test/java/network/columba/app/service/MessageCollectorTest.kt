@@ -9,6 +9,7 @@ import network.columba.app.notifications.NotificationHelper
 import network.columba.app.rns.api.RnsCore
 import network.columba.app.rns.api.RnsLxmf
 import network.columba.app.rns.api.model.ReceivedMessage
+import network.columba.app.rns.api.util.toHex
 import io.mockk.Runs
 import io.mockk.clearAllMocks
 import io.mockk.coEvery
@@ -24,14 +25,15 @@ import org.junit.Assert.assertEquals
 import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Test
+import java.util.concurrent.atomic.AtomicInteger
 
 /**
  * Unit tests for MessageCollector.
  * Tests notification behavior for messages that were persisted by ServicePersistenceManager.
  *
- * Note: MessageCollector no longer persists messages itself - all persistence happens in
- * ServicePersistenceManager which enforces privacy settings like "block unknown senders".
- * MessageCollector only shows notifications for messages that exist in the database.
+ * Note: The :reticulum service owns inbound persistence and de-duplication, and tags each
+ * forwarded event with `persisted` / `isDuplicate` / `resolvedPeerName`. MessageCollector
+ * only notifies for those, and saves messages itself only when `persisted = false`.
  */
 class MessageCollectorTest {
     private lateinit var rnsCore: RnsCore
@@ -50,7 +52,7 @@ class MessageCollectorTest {
 
     private val testSourceHash = ByteArray(16) { it.toByte() }
     private val testDestHash = ByteArray(16) { (it + 16).toByte() }
-    private val testSourceHashHex = testSourceHash.joinToString("") { "%02x".format(it) }
+    private val testSourceHashHex = testSourceHash.toHex()
 
     @Before
     fun setup() {
@@ -81,24 +83,25 @@ class MessageCollectorTest {
         every { rnsCore.observeAnnounces() } returns flowOf() // Empty flow for announces
 
         // Mock conversation repository default behaviors
-        // Note: getMessageById is no longer called - MessageCollector trusts broadcasts
+        // Note: getMessageById is only used on the fallback path (persisted = false);
+        // for service-persisted messages MessageCollector trusts the service's flags
+        coEvery { conversationRepository.getMessageById(any()) } returns null
         coEvery { conversationRepository.getPeerPublicKey(any()) } returns null
         coEvery { conversationRepository.updatePeerPublicKey(any(), any()) } just Runs
         coEvery { conversationRepository.saveMessage(any(), any(), any(), any()) } just Runs
         coEvery { conversationRepository.getConversation(any()) } returns null
         coEvery { conversationRepository.updatePeerName(any(), any()) } just Runs
-        coEvery { conversationRepository.getMessageById(any()) } returns null
 
         // Mock announce repository
         coEvery { announceRepository.getAnnounce(any()) } returns null
 
-        // Mock getReceivedMessageIds for pre-seeding (empty by default)
-        coEvery { conversationRepository.getReceivedMessageIds(since = any()) } returns emptyList()
+        // Mock contact repository (peer name fallback lookups)
+        coEvery { contactRepository.getContact(any()) } returns null
 
         // Mock identity repository - return a mock active identity matching test destination
         coEvery { identityRepository.getActiveIdentitySync() } returns
             mockk {
-                every { destinationHash } returns testDestHash.joinToString("") { "%02x".format(it) }
+                every { destinationHash } returns testDestHash.toHex()
             }
 
         messageCollector =
@@ -122,13 +125,13 @@ class MessageCollectorTest {
     }
 
     // ========== De-duplication Tests ==========
-    // Note: Blocking tests are handled at the EventHandler/ServicePersistenceManager level.
-    // MessageCollector only receives broadcasts for messages that were already persisted.
+    // Note: Blocking tests are handled at the InboundMessageIngest level.
+    // Rejected messages are never forwarded to MessageCollector.
 
     @Test
     fun `processMessage shows notification for broadcast message`() =
         runBlocking {
-            // Given: A message broadcast from EventHandler (already persisted by service)
+            // Given: A message forwarded by the service after persisting it
             val testMessage =
                 ReceivedMessage(
                     messageHash = "persisted_message",
@@ -138,15 +141,9 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
                 )
 
-            // Mock that message already exists in database (persisted by ServicePersistenceManager)
-            // isRead = false means the user hasn't seen it yet, so notification should fire
-            coEvery { conversationRepository.getMessageById("persisted_message") } returns
-                mockk {
-                    every { isRead } returns false
-                }
-
             // When: Start collecting and emit message
             val startResult = runCatching { messageCollector.startCollecting() }
             assertTrue("startCollecting should complete without throwing", startResult.isSuccess)
@@ -177,9 +174,9 @@ class MessageCollectorTest {
         }
 
     @Test
-    fun `processMessage skips in-memory duplicate`() =
+    fun `processMessage skips message the service flagged as duplicate`() =
         runBlocking {
-            // Given: A message broadcast from EventHandler
+            // Given: A message forwarded by the service
             val testMessage =
                 ReceivedMessage(
                     messageHash = "duplicate_message",
@@ -189,6 +186,7 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
                 )
 
             // When: Start collecting and emit the same message twice
@@ -214,11 +212,11 @@ class MessageCollectorTest {
                 )
             }
 
-            // Emit the same message again
-            messageFlow.emit(testMessage)
+            // The service forwards the replay flagged as a duplicate
+            messageFlow.emit(testMessage.copy(isDuplicate = true))
             kotlinx.coroutines.delay(200)
 
-            // Second message should be skipped (in-memory cache) - still only 1 notification
+            // Second message should be skipped - still only 1 notification
             coVerify(exactly = 1, timeout = 2000) {
                 notificationHelper.notifyMessageReceived(
                     destinationHash = testSourceHashHex,
@@ -297,14 +295,12 @@ class MessageCollectorTest {
             }
         }
 
-    // ========== Pre-seed Dedup Tests ==========
+    // ========== Restart Dedup Tests ==========
 
     @Test
-    fun `pre-seeded message IDs prevent duplicate notifications on restart`() =
+    fun `replayed message flagged as duplicate posts no notification on restart`() =
         runBlocking {
             // Given: A message that was already in the DB from a previous session
-            coEvery { conversationRepository.getReceivedMessageIds(since = any()) } returns listOf("already_notified_msg")
-
             val testMessage =
                 ReceivedMessage(
                     messageHash = "already_notified_msg",
@@ -314,9 +310,11 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
+                    isDuplicate = true,
                 )
 
-            // When: Start collecting (pre-seeds IDs) and replay the message
+            // When: Start collecting and replay the message
             messageCollector.startCollecting()
             kotlinx.coroutines.delay(100)
             messageFlow.emit(testMessage)
@@ -325,7 +323,7 @@ class MessageCollectorTest {
             // Then: Message was skipped entirely - counter didn't increment
             assertEquals(0, messageCollector.messagesCollected.value)
 
-            // And no notification was shown (message was pre-seeded as already processed)
+            // And no notification was shown, without touching the database
             coVerify(exactly = 0) {
                 notificationHelper.notifyMessageReceived(
                     destinationHash = any(),
@@ -334,6 +332,199 @@ class MessageCollectorTest {
                     isFavorite = any(),
                 )
             }
+            coVerify(exactly = 0) { conversationRepository.getMessageById(any()) }
+            coVerify(exactly = 0) { announceRepository.getAnnounce(any()) }
+        }
+
+    // ========== Fallback Persistence Tests ==========
+
+    @Test
+    fun `message not persisted by service is saved locally and notified`() =
+        runBlocking {
+            // Given: The service could not store the message (persisted = false)
+            val testMessage =
+                ReceivedMessage(
+                    messageHash = "fallback_msg",
+                    content = "Service write failed",
+                    sourceHash = testSourceHash,
+                    destinationHash = testDestHash,
+                    timestamp = System.currentTimeMillis(),
+                )
+
+            messageCollector.startCollecting()
+            kotlinx.coroutines.delay(50)
+            messageFlow.emit(testMessage)
+            kotlinx.coroutines.delay(200)
+
+            // Then: The app saves it and notifies
+            coVerify(timeout = 2000) {
+                conversationRepository.saveMessage(testSourceHashHex, any(), any(), any())
+            }
+            coVerify(timeout = 2000) {
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = testSourceHashHex,
+                    peerName = any(),
+                    messagePreview = any(),
+                    isFavorite = any(),
+                )
+            }
+        }
+
+    @Test
+    fun `fallback replay of a read message is neither saved nor notified`() =
+        runBlocking {
+            coEvery { conversationRepository.getMessageById("fallback_read") } returns
+                mockk { every { isRead } returns true }
+            val testMessage =
+                ReceivedMessage(
+                    messageHash = "fallback_read",
+                    content = "Oversized fields, replayed",
+                    sourceHash = testSourceHash,
+                    destinationHash = testDestHash,
+                    timestamp = System.currentTimeMillis(),
+                )
+
+            messageCollector.startCollecting()
+            kotlinx.coroutines.delay(50)
+            messageFlow.emit(testMessage)
+            messageFlow.emit(testMessage)
+            kotlinx.coroutines.delay(200)
+
+            coVerify(exactly = 2, timeout = 2000) { conversationRepository.getMessageById("fallback_read") }
+            coVerify(exactly = 0) { conversationRepository.saveMessage(any(), any(), any(), any()) }
+            coVerify(exactly = 0) { notificationHelper.notifyMessageReceived(any(), any(), any(), any()) }
+        }
+
+    @Test
+    fun `fallback replay of an unread message notifies without saving again`() =
+        runBlocking {
+            coEvery { conversationRepository.getMessageById("fallback_unread") } returns
+                mockk { every { isRead } returns false }
+            val testMessage =
+                ReceivedMessage(
+                    messageHash = "fallback_unread",
+                    content = "Still unread",
+                    sourceHash = testSourceHash,
+                    destinationHash = testDestHash,
+                    timestamp = System.currentTimeMillis(),
+                )
+
+            messageCollector.startCollecting()
+            kotlinx.coroutines.delay(50)
+            messageFlow.emit(testMessage)
+            kotlinx.coroutines.delay(200)
+
+            coVerify(timeout = 2000) {
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = testSourceHashHex,
+                    peerName = any(),
+                    messagePreview = "Still unread",
+                    isFavorite = any(),
+                )
+            }
+            coVerify(exactly = 0) { conversationRepository.saveMessage(any(), any(), any(), any()) }
+        }
+
+    @Test
+    fun `service-persisted message uses resolved peer name without lookups`() =
+        runBlocking {
+            val testMessage =
+                ReceivedMessage(
+                    messageHash = "resolved_name_msg",
+                    content = "Named by service",
+                    sourceHash = testSourceHash,
+                    destinationHash = testDestHash,
+                    timestamp = System.currentTimeMillis(),
+                    persisted = true,
+                    resolvedPeerName = "Alice",
+                )
+
+            messageCollector.startCollecting()
+            kotlinx.coroutines.delay(50)
+            messageFlow.emit(testMessage)
+            kotlinx.coroutines.delay(200)
+
+            coVerify(timeout = 2000) {
+                notificationHelper.notifyMessageReceived(
+                    destinationHash = testSourceHashHex,
+                    peerName = "Alice",
+                    messagePreview = any(),
+                    isFavorite = any(),
+                )
+            }
+            coVerify(exactly = 0) { contactRepository.getContact(any()) }
+            coVerify(exactly = 0) { conversationRepository.getConversation(any()) }
+        }
+
+    // ========== Database Query Count Tests ==========
+
+    @Test
+    fun `service-owned persistence cuts app database queries per inbound message`() =
+        runBlocking {
+            // Count every repository/DAO call that reaches the database
+            val queries = AtomicInteger()
+            coEvery { identityRepository.getActiveIdentitySync() } answers {
+                queries.incrementAndGet()
+                mockk { every { destinationHash } returns testDestHash.toHex() }
+            }
+            coEvery { contactRepository.getContact(any()) } answers {
+                queries.incrementAndGet()
+                null
+            }
+            coEvery { announceRepository.getAnnounce(any()) } answers {
+                queries.incrementAndGet()
+                null
+            }
+            coEvery { conversationRepository.getConversation(any()) } answers {
+                queries.incrementAndGet()
+                null
+            }
+            coEvery { conversationRepository.getPeerPublicKey(any()) } answers {
+                queries.incrementAndGet()
+                null
+            }
+            coEvery { conversationRepository.getMessageById(any()) } answers {
+                queries.incrementAndGet()
+                null
+            }
+            coEvery { conversationRepository.saveMessage(any(), any(), any(), any()) } answers {
+                queries.incrementAndGet()
+            }
+
+            messageCollector.startCollecting()
+            kotlinx.coroutines.delay(50)
+
+            // Before: the app resolves, checks and writes the message itself
+            val unpersisted =
+                ReceivedMessage(
+                    messageHash = "count_before",
+                    content = "Saved by the app",
+                    sourceHash = testSourceHash,
+                    destinationHash = testDestHash,
+                    timestamp = System.currentTimeMillis(),
+                )
+            messageFlow.emit(unpersisted)
+            coVerify(timeout = 2000) { notificationHelper.notifyMessageReceived(any(), any(), any(), any()) }
+            val before = queries.getAndSet(0)
+
+            // After: the service already wrote it and resolved the name
+            messageFlow.emit(
+                unpersisted.copy(messageHash = "count_after", persisted = true, resolvedPeerName = "Alice"),
+            )
+            coVerify(exactly = 2, timeout = 2000) { notificationHelper.notifyMessageReceived(any(), any(), any(), any()) }
+            val after = queries.get()
+
+            // And a replay costs nothing at all
+            queries.set(0)
+            messageFlow.emit(unpersisted.copy(messageHash = "count_after", persisted = true, isDuplicate = true))
+            kotlinx.coroutines.delay(200)
+            val duplicate = queries.get()
+
+            println("MessageCollector DB queries per inbound message: app-persisted=$before, service-persisted=$after, duplicate=$duplicate")
+            // Only the favorite lookup for the notification remains
+            assertEquals(1, after)
+            assertTrue("Expected fewer queries ($after vs $before)", after < before)
+            assertEquals(0, duplicate)
         }
 
     // ========== Notification for Pre-Persisted Messages Tests ==========
@@ -351,6 +542,7 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
                 )
 
             // Peer is a favorite
@@ -390,6 +582,7 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
                 )
 
             // Announce lookup throws exception
@@ -429,6 +622,7 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
                 )
 
             // When: Start collecting and emit
@@ -463,6 +657,7 @@ class MessageCollectorTest {
                     timestamp = System.currentTimeMillis(),
                     fieldsJson = null,
                     publicKey = null,
+                    persisted = true,
                 )
 
             // When: Start collecting and emit
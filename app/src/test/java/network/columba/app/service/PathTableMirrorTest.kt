@@ -0,0 +1,90 @@
+package network.columba.app.service
+
+import io.mockk.clearAllMocks
+import io.mockk.coEvery
+import io.mockk.coVerify
+import io.mockk.mockk
+import kotlinx.coroutines.test.runTest
+import network.columba.app.data.db.dao.PathTableDao
+import network.columba.app.data.db.entity.PathTableEntryEntity
+import network.columba.app.rns.api.RnsCore
+import network.columba.app.rns.api.model.PathTableDelta
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+/**
+ * Unit tests for PathTableMirror.
+ *
+ * Verifies that a reset split across batches reaches the DAO as one
+ * transaction, and that later deltas are applied as they arrive.
+ */
+class PathTableMirrorTest {
+    private lateinit var pathTableDao: PathTableDao
+    private lateinit var mirror: PathTableMirror
+
+    // (reset, upserted hashes, expired hashes) per applyDelta call
+    private val applied = mutableListOf<Triple<Boolean, List<String>, List<String>>>()
+
+    @Before
+    fun setup() {
+        pathTableDao = mockk()
+        coEvery { pathTableDao.applyDelta(any(), any(), any()) } answers {
+            applied.add(
+                Triple(
+                    firstArg(),
+                    secondArg<List<PathTableEntryEntity>>().map { it.destinationHash },
+                    thirdArg(),
+                ),
+            )
+            Unit
+        }
+        mirror = PathTableMirror(mockk<RnsCore>(), pathTableDao)
+    }
+
+    @After
+    fun tearDown() {
+        clearAllMocks()
+    }
+
+    @Test
+    fun `reset split across batches is applied in one transaction`() =
+        runTest {
+            mirror.apply(PathTableDelta(reset = true, partial = true, added = mapOf("aa" to 1)))
+            mirror.apply(PathTableDelta(partial = true, added = mapOf("bb" to 2)))
+            assertTrue("nothing is written before the last batch", applied.isEmpty())
+
+            mirror.apply(PathTableDelta(added = mapOf("cc" to 3)))
+
+            assertEquals(listOf(Triple(true, listOf("aa", "bb", "cc"), emptyList<String>())), applied)
+        }
+
+    @Test
+    fun `deltas after the reset are applied as they arrive`() =
+        runTest {
+            mirror.apply(PathTableDelta(reset = true, added = mapOf("aa" to 1)))
+            mirror.apply(PathTableDelta(updated = mapOf("aa" to 2)))
+            mirror.apply(PathTableDelta(expired = listOf("aa")))
+
+            assertEquals(
+                listOf(
+                    Triple(true, listOf("aa"), emptyList()),
+                    Triple(false, listOf("aa"), emptyList()),
+                    Triple(false, emptyList(), listOf("aa")),
+                ),
+                applied,
+            )
+        }
+
+    @Test
+    fun `a new reset discards an unfinished one`() =
+        runTest {
+            mirror.apply(PathTableDelta(reset = true, partial = true, added = mapOf("old" to 1)))
+            mirror.apply(PathTableDelta(reset = true, added = mapOf("new" to 1)))
+
+            assertEquals(listOf(Triple(true, listOf("new"), emptyList<String>())), applied)
+            coVerify(exactly = 1) { pathTableDao.applyDelta(any(), any(), any()) }
+        }
+}
@@ -498,7 +498,7 @@ class TelemetryCollectorManagerTest {
                         lastUsedTimestamp = 1L,
                         isActive = true,
                     )
-                coEvery { mockRnsTelemetry.storeOwnTelemetry(any(), any()) } returns Result.success(Unit)
+                coEvery { mockRnsTelemetry.storeOwnTelemetryPacked(any(), any(), any()) } returns Result.success(Unit)
 
                 manager = createManager()
                 manager.start()
@@ -514,7 +514,7 @@ class TelemetryCollectorManagerTest {
 
                 assertEquals(TelemetrySendResult.Success, result)
                 coVerify(atLeast = 1) { mockRnsTelemetry.setTelemetryCollectorMode(true) }
-                coVerify(exactly = 1) { mockRnsTelemetry.storeOwnTelemetry(any(), any()) }
+                coVerify(exactly = 1) { mockRnsTelemetry.storeOwnTelemetryPacked(any(), any(), any()) }
                 coVerify(exactly = 0) {
                     mockRnsTelemetry.sendLocationTelemetry(any(), any(), any(), any())
                 }
@@ -548,7 +548,7 @@ class TelemetryCollectorManagerTest {
                 val serviceRnsTelemetry = mockk<RnsTelemetry>()
                 every { serviceRnsCore.networkStatus } returns networkStatusFlow
                 coEvery { serviceRnsTelemetry.setTelemetryCollectorMode(any()) } returns Result.success(Unit)
-                coEvery { serviceRnsTelemetry.storeOwnTelemetry(any(), any()) } returns Result.success(Unit)
+                coEvery { serviceRnsTelemetry.storeOwnTelemetryPacked(any(), any(), any()) } returns Result.success(Unit)
                 coEvery { serviceRnsLxmf.getLxmfIdentity() } returns
                     Result.success(
                         network.columba.app.rns.api.model.Identity(
@@ -599,7 +599,7 @@ class TelemetryCollectorManagerTest {
 
                 assertEquals(TelemetrySendResult.Success, result)
                 coVerify(exactly = 1) { serviceRnsTelemetry.sendLocationTelemetry(any(), any(), any(), any()) }
-                coVerify(exactly = 0) { serviceRnsTelemetry.storeOwnTelemetry(any(), any()) }
+                coVerify(exactly = 0) { serviceRnsTelemetry.storeOwnTelemetryPacked(any(), any(), any()) }
 
                 manager.stop()
             } finally {
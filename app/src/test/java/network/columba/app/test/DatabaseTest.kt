@@ -15,6 +15,7 @@ import network.columba.app.data.db.dao.DraftDao
 import network.columba.app.data.db.dao.LocalIdentityDao
 import network.columba.app.data.db.dao.MessageDao
 import network.columba.app.data.db.dao.PeerIdentityDao
+import network.columba.app.data.db.dao.ReactionDao
 import network.columba.app.data.db.entity.LocalIdentityEntity
 import org.junit.After
 import org.junit.Before
@@ -75,6 +76,7 @@ abstract class DatabaseTest {
     protected val localIdentityDao: LocalIdentityDao get() = database.localIdentityDao()
     protected val peerIdentityDao: PeerIdentityDao get() = database.peerIdentityDao()
     protected val draftDao: DraftDao get() = database.draftDao()
+    protected val reactionDao: ReactionDao get() = database.reactionDao()
 
     companion object {
         // Standard test values for identity-scoped operations
@@ -187,6 +187,8 @@ object TestFactories {
         lastMessage: String = "Hello",
         lastMessageTimestamp: Long = System.currentTimeMillis(),
         unreadCount: Int = 0,
+        isContact: Boolean = false,
+        draftText: String? = null,
     ) = Conversation(
         peerHash = peerHash,
         peerName = peerName,
@@ -195,6 +197,8 @@ object TestFactories {
         lastMessage = lastMessage,
         lastMessageTimestamp = lastMessageTimestamp,
         unreadCount = unreadCount,
+        isContact = isContact,
+        draftText = draftText,
     )
 
     /**
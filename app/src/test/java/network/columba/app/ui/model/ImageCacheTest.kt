@@ -1,9 +1,11 @@
 package network.columba.app.ui.model
 
 import android.app.Application
+import android.content.ComponentCallbacks2
 import android.graphics.Bitmap
 import androidx.compose.ui.graphics.ImageBitmap
 import androidx.compose.ui.graphics.asImageBitmap
+import coil.memory.MemoryCache
 import org.junit.After
 import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
@@ -132,7 +134,7 @@ class ImageCacheTest {
 
     @Test
     fun `cache handles many items`() {
-        // Add 30 items (less than max cache size of 50)
+        // 30 small bitmaps, far below the byte budget
         repeat(30) { i ->
             ImageCache.put("message-$i", createTestBitmap())
         }
@@ -145,6 +147,55 @@ class ImageCacheTest {
         }
     }
 
+    // ========== Byte Budget Tests ==========
+
+    @Test
+    fun `sizeBytes counts bitmap allocation bytes`() {
+        ImageCache.put("message-1", Bitmap.createBitmap(10, 10, Bitmap.Config.ARGB_8888).asImageBitmap())
+
+        assertEquals(400, ImageCache.sizeBytes())
+    }
+
+    @Test
+    fun `raw bytes are cached by message id separately from bitmaps`() {
+        val raw = ByteArray(1024) { it.toByte() }
+
+        ImageCache.putRawBytes("message-1", raw)
+
+        assertTrue(raw === ImageCache.getRawBytes("message-1"))
+        assertNull(ImageCache.get("message-1"))
+        assertEquals(0, ImageCache.size())
+        assertEquals(1024, ImageCache.sizeBytes())
+    }
+
+    @Test
+    fun `coil memory cache shares the budget with message images`() {
+        val coilCache = ImageCache.memoryCache
+        val key = MemoryCache.Key("message-image:abc:268")
+        ImageCache.put("message-1", createTestBitmap())
+
+        coilCache[key] = MemoryCache.Value(Bitmap.createBitmap(10, 10, Bitmap.Config.ARGB_8888))
+
+        assertEquals(404, ImageCache.sizeBytes())
+        assertEquals(ImageCache.sizeBytes(), coilCache.size)
+        assertEquals(setOf(key), coilCache.keys)
+
+        coilCache.clear()
+
+        assertNull(coilCache[key])
+        assertNotNull(ImageCache.get("message-1"))
+    }
+
+    @Test
+    fun `trimMemory in background evicts message images too`() {
+        ImageCache.put("message-1", createTestBitmap())
+        ImageCache.putRawBytes("message-1", ByteArray(16))
+
+        ImageCache.memoryCache.trimMemory(ComponentCallbacks2.TRIM_MEMORY_BACKGROUND)
+
+        assertEquals(0, ImageCache.sizeBytes())
+    }
+
     private fun createTestBitmap(): ImageBitmap {
         // Create a minimal test bitmap (1x1 pixel)
         return Bitmap.createBitmap(1, 1, Bitmap.Config.ARGB_8888).asImageBitmap()
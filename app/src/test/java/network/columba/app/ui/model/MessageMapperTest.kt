@@ -1937,6 +1937,51 @@ class MessageMapperTest {
         assertNull(result.imageData)
     }
 
+    @Test
+    fun `decodeImageWithAnimation reuses raw bytes for the same message`() {
+        val fieldsJson = """{"6": "${createMinimalAnimatedGifHex()}"}"""
+
+        val first = decodeImageWithAnimation("reuse-test", fieldsJson)
+        val second = decodeImageWithAnimation("reuse-test", fieldsJson)
+
+        assertTrue(first!!.rawBytes === second!!.rawBytes)
+        assertTrue(first.rawBytes === ImageCache.getRawBytes("reuse-test"))
+    }
+
+    @Test
+    fun `scrolling over animated images reuses cached raw bytes`() {
+        // 40 messages with ~150KB GIFs, scrolled up and down; each frame binds a window of 6 rows
+        val messages = List(40) { i -> "scroll-$i" to """{"6": "${createPaddedAnimatedGifHex(150_000)}"}""" }
+        val frames = (0..34).flatMap { listOf(it, it) } + (34 downTo 0).toList()
+
+        fun frameTimesMicros(messageIdFor: (String, Int) -> String): List<Long> =
+            frames.mapIndexed { frame, top ->
+                val start = System.nanoTime()
+                messages.subList(top, top + 6).forEach { (id, fields) ->
+                    decodeImageWithAnimation(messageIdFor(id, frame), fields)
+                }
+                (System.nanoTime() - start) / 1_000
+            }
+
+        // A fresh ID per frame reproduces the old behaviour of re-decoding the hex field on every bind
+        frameTimesMicros { id, frame -> "$id-warmup-$frame" }
+        val uncached = frameTimesMicros { id, frame -> "$id-frame-$frame" }.sorted()
+        val cached = frameTimesMicros { id, _ -> id }.sorted()
+
+        fun List<Long>.p95() = this[(size * 95 / 100).coerceAtMost(size - 1)]
+        println(
+            "Frame time over ${frames.size} frames: hex decode per bind avg ${uncached.average().toLong()}us " +
+                "p95 ${uncached.p95()}us; cached raw bytes avg ${cached.average().toLong()}us p95 ${cached.p95()}us",
+        )
+        // Timings are informational only; what matters is that rebinding the last window reused its bytes
+        val window = messages.subList(0, 6)
+        val cachedBytes = window.map { (id, _) -> ImageCache.getRawBytes(id) }
+        window.forEachIndexed { i, (id, fields) ->
+            assertNotNull(cachedBytes[i])
+            assertTrue(decodeImageWithAnimation(id, fields)!!.rawBytes === cachedBytes[i])
+        }
+    }
+
     // ========== Helper Functions for Animation Tests ==========
 
     /**
@@ -1947,6 +1992,25 @@ class MessageMapperTest {
         return bytes.joinToString("") { "%02x".format(it) }
     }
 
+    /**
+     * Animated GIF padded with a comment extension to roughly [size] bytes, hex-encoded.
+     */
+    private fun createPaddedAnimatedGifHex(size: Int): String {
+        val gif = createMinimalAnimatedGifBytes()
+        val padding = mutableListOf<Byte>(0x21, 0xFE.toByte())
+        var remaining = size
+        while (remaining > 0) {
+            val block = remaining.coerceAtMost(255)
+            padding.add(block.toByte())
+            repeat(block) { padding.add('x'.code.toByte()) }
+            remaining -= block
+        }
+        padding.add(0x00)
+        // Comment goes before the trailer
+        val bytes = gif.copyOfRange(0, gif.size - 1) + padding.toByteArray() + gif.last()
+        return bytes.joinToString("") { "%02x".format(it) }
+    }
+
     /**
      * Creates a minimal valid animated GIF with 2 frames.
      */
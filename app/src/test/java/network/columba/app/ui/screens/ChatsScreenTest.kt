@@ -912,10 +912,9 @@ class ChatsScreenTest {
     @Test
     fun chatsScreen_starButton_whenNotSaved_callsSaveToContacts() {
         // Given
+        // Contact is NOT saved
         val conversation = TestFactories.createConversation(peerHash = "test_peer", peerName = "Alice")
         val mockViewModel = createMockChatsViewModel(conversations = listOf(conversation))
-        // Contact is NOT saved
-        every { mockViewModel.isContactSaved("test_peer") } returns MutableStateFlow(false)
 
         composeTestRule.setContent {
             ChatsScreen(
@@ -940,10 +939,9 @@ class ChatsScreenTest {
     @Test
     fun chatsScreen_starButton_whenSaved_callsRemoveFromContacts() {
         // Given
-        val conversation = TestFactories.createConversation(peerHash = "test_peer", peerName = "Bob")
-        val mockViewModel = createMockChatsViewModel(conversations = listOf(conversation))
         // Contact IS saved
-        every { mockViewModel.isContactSaved("test_peer") } returns MutableStateFlow(true)
+        val conversation = TestFactories.createConversation(peerHash = "test_peer", peerName = "Bob", isContact = true)
+        val mockViewModel = createMockChatsViewModel(conversations = listOf(conversation))
 
         composeTestRule.setContent {
             ChatsScreen(
@@ -970,12 +968,10 @@ class ChatsScreenTest {
         // Given - one saved, one not saved
         val conversations =
             listOf(
-                TestFactories.createConversation(peerHash = "saved_peer", peerName = "Saved"),
+                TestFactories.createConversation(peerHash = "saved_peer", peerName = "Saved", isContact = true),
                 TestFactories.createConversation(peerHash = "unsaved_peer", peerName = "Unsaved"),
             )
         val mockViewModel = createMockChatsViewModel(conversations = conversations)
-        every { mockViewModel.isContactSaved("saved_peer") } returns MutableStateFlow(true)
-        every { mockViewModel.isContactSaved("unsaved_peer") } returns MutableStateFlow(false)
 
         composeTestRule.setContent {
             ChatsScreen(
@@ -1015,12 +1011,8 @@ class ChatsScreenTest {
         every { mockViewModel.syncProgress } returns MutableStateFlow(network.columba.app.service.SyncProgress.Idle)
         every { mockViewModel.manualSyncResult } returns MutableSharedFlow()
         every { mockViewModel.contactToggleResult } returns MutableSharedFlow()
-        every { mockViewModel.draftsMap } returns MutableStateFlow(emptyMap())
         every { mockViewModel.isTransportEnabled } returns MutableStateFlow(false)
 
-        // Default: contacts are not saved
-        every { mockViewModel.isContactSaved(any()) } returns MutableStateFlow(false)
-
         return mockViewModel
     }
 
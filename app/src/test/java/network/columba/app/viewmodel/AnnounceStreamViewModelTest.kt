@@ -97,9 +97,6 @@ class AnnounceStreamViewModelTest {
     fun setup() {
         Dispatchers.setMain(testDispatcher)
 
-        // Disable periodic updates in tests to prevent OOM from infinite loop
-        AnnounceStreamViewModel.updateIntervalMs = 0
-
         reticulumProtocol = mockk()
         serviceReticulumProtocol = mockk()
         announceRepository = mockk()
@@ -124,7 +121,7 @@ class AnnounceStreamViewModelTest {
         every { announceRepository.getAnnounceCountFlow() } returns flowOf(0)
         coEvery { announceRepository.saveAnnounce(any(), any(), any(), any(), any(), any(), any(), any(), any(), any(), any(), any(), any()) } just Runs
         coEvery { announceRepository.getAnnounceCount() } returns 0
-        coEvery { announceRepository.countReachableAnnounces(any()) } returns 0
+        every { announceRepository.getReachableAnnounceCountFlow() } returns flowOf(0)
         coEvery { announceRepository.deleteAllAnnouncesExceptContacts(any()) } just Runs
         coEvery { reticulumProtocol.shutdown() } returns Result.success(Unit)
         coEvery { reticulumProtocol.getPathTableHashes() } returns emptyList()
@@ -154,8 +151,6 @@ class AnnounceStreamViewModelTest {
         }
         Dispatchers.resetMain()
         clearAllMocks()
-        // Reset update interval to default
-        AnnounceStreamViewModel.updateIntervalMs = 30_000L
     }
 
     @Test
@@ -1049,13 +1044,14 @@ class AnnounceStreamViewModelTest {
             }
         }
 
-    // ========== Network Status Check Tests ==========
+    // ========== Reachable Count Tests ==========
 
     @Test
-    fun `updateReachableCount skips when network is SHUTDOWN`() =
+    fun `reachableAnnounceCount mirrors the repository flow`() =
         runTest {
-            // Given: Network is SHUTDOWN
-            networkStatusFlow.value = NetworkStatus.SHUTDOWN
+            val reachableFlow = MutableStateFlow(0)
+            every { announceRepository.getReachableAnnounceCountFlow() } returns reachableFlow
+            networkStatusFlow.value = NetworkStatus.READY
 
             viewModel =
                 AnnounceStreamViewModel(
@@ -1069,21 +1065,21 @@ class AnnounceStreamViewModelTest {
                 )
             advanceUntilIdle()
 
-            // When: We wait for any periodic updates (none should happen due to updateIntervalMs = 0)
-            advanceTimeBy(1000)
-            advanceUntilIdle()
+            viewModel.reachableAnnounceCount.test {
+                assertEquals(0, awaitItem())
 
-            // Verify reachable count remains at default (0) since network is not ready
-            assertEquals("Reachable count should remain 0 when network is SHUTDOWN", 0, viewModel.reachableAnnounceCount.value)
+                // PathTableMirror applied a delta
+                reachableFlow.value = 20_000
+                advanceUntilIdle()
 
-            // Then: getPathTableHashes should NOT be called because network is not READY
-            coVerify(exactly = 0) { reticulumProtocol.getPathTableHashes() }
+                assertEquals(20_000, awaitItem())
+                cancelAndIgnoreRemainingEvents()
+            }
         }
 
     @Test
-    fun `updateReachableCount skips when network transitions to SHUTDOWN`() =
+    fun `reachable count never fetches the path table`() =
         runTest {
-            // Given: Network starts as READY
             networkStatusFlow.value = NetworkStatus.READY
 
             viewModel =
@@ -1096,22 +1092,12 @@ class AnnounceStreamViewModelTest {
                     mockk(),
                     identityResolutionManager,
                 )
-            advanceUntilIdle()
-
-            // Clear any initial calls
-            clearMocks(reticulumProtocol, answers = false, recordedCalls = true, verificationMarks = true)
-            every { reticulumProtocol.networkStatus } returns networkStatusFlow
-            every { reticulumProtocol.observeAnnounces() } returns announceFlow
-            coEvery { reticulumProtocol.getPathTableHashes() } returns emptyList()
-
-            // When: Network transitions to SHUTDOWN
-            networkStatusFlow.value = NetworkStatus.SHUTDOWN
-            advanceUntilIdle()
-
-            // Verify reachable count remains at 0 after shutdown
-            assertEquals("Reachable count should remain 0 after shutdown", 0, viewModel.reachableAnnounceCount.value)
+            viewModel.reachableAnnounceCount.test {
+                awaitItem()
+                advanceTimeBy(120_000)
+                cancelAndIgnoreRemainingEvents()
+            }
 
-            // Then: getPathTableHashes should NOT be called after shutdown
             coVerify(exactly = 0) { reticulumProtocol.getPathTableHashes() }
         }
 
@@ -1266,57 +1252,4 @@ class AnnounceStreamViewModelTest {
             assertTrue("Should have called deleteAllAnnounces as fallback", deleteAllCalled)
             coVerify(exactly = 0) { announceRepository.deleteAllAnnouncesExceptContacts(any()) }
         }
-
-    // ========== CancellationException Propagation Tests ==========
-
-    @Test
-    fun `reachable count loop stops when viewModelScope is cancelled`() =
-        runTest {
-            // Enable periodic updates with a short interval for this test.
-            // IMPORTANT: Do NOT use advanceUntilIdle() while the while(true) loop is
-            // active — it drains all pending tasks, but the loop keeps scheduling more,
-            // causing the test to hang. Use advanceTimeBy() + runCurrent() instead.
-            AnnounceStreamViewModel.updateIntervalMs = 100L
-            networkStatusFlow.value = NetworkStatus.READY
-
-            var pathTableCallCount = 0
-            coEvery { reticulumProtocol.getPathTableHashes() } answers {
-                pathTableCallCount++
-                emptyList()
-            }
-
-            viewModel =
-                AnnounceStreamViewModel(
-                    reticulumProtocol,
-                    announceRepository,
-                    contactRepository,
-                    propagationNodeManager,
-                    identityRepository,
-                    mockk(),
-                    identityResolutionManager,
-                )
-            // Run the init block tasks (startCollectingAnnouncesWhenReady + first loop iteration)
-            runCurrent()
-
-            // Advance past the first delay + second iteration
-            advanceTimeBy(150)
-            runCurrent()
-            val callsBeforeCancel = pathTableCallCount
-            assertTrue("Loop should have called getPathTableHashes at least once", callsBeforeCancel >= 1)
-
-            // Cancel the viewModelScope (simulates ViewModel clearing)
-            viewModel.viewModelScope.cancel()
-            runCurrent()
-
-            // Advance time well past several more intervals
-            advanceTimeBy(500)
-            runCurrent()
-
-            // No additional calls should have been made after cancellation
-            assertEquals(
-                "Loop should stop after scope cancellation (CancellationException must propagate)",
-                callsBeforeCancel,
-                pathTableCallCount,
-            )
-        }
 }
@@ -16,8 +16,11 @@ import network.columba.app.service.PropagationNodeManager
 import io.mockk.*
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.awaitCancellation
+import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.flow
 import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.test.StandardTestDispatcher
 import kotlinx.coroutines.test.advanceUntilIdle
@@ -32,6 +35,7 @@ import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Rule
 import org.junit.Test
+import java.util.concurrent.atomic.AtomicInteger
 
 /**
  * Unit tests for ChatsViewModel.
@@ -103,9 +107,8 @@ class ChatsViewModelTest {
         identityResolutionManager = mockk()
         coEvery { identityResolutionManager.requestPathForContact(any()) } just Runs
 
-        // Default: no conversations, no drafts
+        // Default: no conversations
         every { conversationRepository.getConversations() } returns flowOf(emptyList())
-        every { conversationRepository.observeDrafts() } returns flowOf(emptyMap())
 
         // Default: not syncing
         every { propagationNodeManager.isSyncing } returns MutableStateFlow(false)
@@ -150,7 +153,6 @@ class ChatsViewModelTest {
             val repository: ConversationRepository = mockk()
             val testConversations = listOf(testConversation1, testConversation2)
             every { repository.getConversations() } returns flowOf(testConversations)
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
 
             // NOW create ViewModel
             val newViewModel =
@@ -190,7 +192,6 @@ class ChatsViewModelTest {
                     testConversation1, // 1000L (oldest)
                 )
             every { repository.getConversations() } returns flowOf(sortedConversations)
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
 
             // NOW create ViewModel
             val newViewModel =
@@ -269,7 +270,6 @@ class ChatsViewModelTest {
             val repository: ConversationRepository = mockk()
             val conversationsFlow = MutableStateFlow<List<Conversation>>(emptyList())
             every { repository.getConversations() } returns conversationsFlow
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
 
             // NOW create ViewModel
             val newViewModel =
@@ -318,7 +318,6 @@ class ChatsViewModelTest {
                     testConversation3.copy(unreadCount = 10),
                 )
             every { repository.getConversations() } returns flowOf(conversations)
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
 
             // NOW create ViewModel
             val newViewModel =
@@ -357,7 +356,6 @@ class ChatsViewModelTest {
                     testConversation3.copy(peerPublicKey = null),
                 )
             every { repository.getConversations() } returns flowOf(conversations)
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
 
             // NOW create ViewModel
             val newViewModel =
@@ -397,7 +395,6 @@ class ChatsViewModelTest {
                     testConversation1.copy(peerHash = "8ccb1298abcdef01", lastMessage = "Duplicate"),
                 )
             every { repository.getConversations() } returns flowOf(duplicateConversations)
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
 
             val newViewModel =
                 ChatsViewModel(
@@ -430,7 +427,6 @@ class ChatsViewModelTest {
             // Given: Search returns conversations with duplicate peerHash
             val repository: ConversationRepository = mockk()
             every { repository.getConversations() } returns flowOf(emptyList())
-            every { repository.observeDrafts() } returns flowOf(emptyMap())
             every { repository.searchConversations("alice") } returns
                 flowOf(
                     listOf(
@@ -483,6 +479,81 @@ class ChatsViewModelTest {
             }
         }
 
+    // ========== Observer Count Tests ==========
+
+    /** Emits [conversations] once and tracks how many collectors are live. */
+    private fun countingConversationsFlow(
+        conversations: List<Conversation>,
+        active: AtomicInteger,
+    ): Flow<List<Conversation>> =
+        flow {
+            active.incrementAndGet()
+            try {
+                emit(conversations)
+                awaitCancellation()
+            } finally {
+                active.decrementAndGet()
+            }
+        }
+
+    @Test
+    fun `conversation list keeps one observer regardless of list size`() =
+        runTest {
+            listOf(10, 1_000).forEach { size ->
+                val active = AtomicInteger(0)
+                val repository: ConversationRepository = mockk()
+                // Strict mock: a per-row hasContactFlow would throw
+                val contacts: ContactRepository = mockk()
+                val conversations =
+                    (0 until size).map { i ->
+                        testConversation1.copy(
+                            peerHash = "peer$i",
+                            isContact = i % 2 == 0,
+                            draftText = "draft $i".takeIf { i % 3 == 0 },
+                        )
+                    }
+                every { repository.getConversations() } returns countingConversationsFlow(conversations, active)
+
+                val newViewModel =
+                    ChatsViewModel(
+                        repository,
+                        contacts,
+                        announceRepository,
+                        blockedPeerRepository,
+                        reticulumProtocol,
+                        propagationNodeManager,
+                        receivedLocationRepository,
+                        identityResolutionManager,
+                    )
+
+                newViewModel.chatsState.test {
+                    awaitItem() // Consume initialValue (loading state)
+                    advanceUntilIdle()
+                    val state = awaitItem()
+                    assertEquals(size, state.conversations.size)
+                    assertEquals((size + 1) / 2, state.conversations.count { it.isContact })
+                    assertEquals((size + 2) / 3, state.conversations.count { it.draftText != null })
+                    assertEquals(1, active.get())
+                    cancelAndIgnoreRemainingEvents()
+                }
+                verify(exactly = 1) { repository.getConversations() }
+                verify(exactly = 0) { contacts.hasContactFlow(any()) }
+            }
+        }
+
+    @Test
+    fun `saveToContacts without a known key fails without lookups`() =
+        runTest {
+            viewModel.contactToggleResult.test {
+                viewModel.saveToContacts(testConversation3.copy(hasPublicKey = false))
+                advanceUntilIdle()
+
+                assertTrue(awaitItem() is ContactToggleResult.Error)
+            }
+            coVerify(exactly = 0) { conversationRepository.getPeerPublicKey(any()) }
+            coVerify(exactly = 0) { announceRepository.getAnnounce(any()) }
+        }
+
     // ========== Contact Location Tests ==========
 
     @Test
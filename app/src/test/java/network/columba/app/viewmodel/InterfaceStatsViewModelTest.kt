@@ -9,16 +9,20 @@ import app.cash.turbine.test
 import network.columba.app.data.database.entity.InterfaceEntity
 import network.columba.app.repository.InterfaceRepository
 import network.columba.app.rns.api.RnsTransportAdmin
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.service.InterfaceConfigManager
 import io.mockk.clearAllMocks
 import io.mockk.coEvery
 import io.mockk.every
 import io.mockk.mockk
+import io.mockk.verify
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.test.StandardTestDispatcher
 import kotlinx.coroutines.test.advanceTimeBy
 import kotlinx.coroutines.test.resetMain
+import kotlinx.coroutines.test.runCurrent
 import kotlinx.coroutines.test.runTest
 import kotlinx.coroutines.test.setMain
 import org.junit.After
@@ -87,7 +91,7 @@ class InterfaceStatsViewModelTest {
         Dispatchers.setMain(testDispatcher)
 
         // Disable background operations during tests
-        InterfaceStatsViewModel.enableStatsPolling = false
+        InterfaceStatsViewModel.enableStatsStream = false
         InterfaceStatsViewModel.enableReconnectSignalObserver = false
 
         interfaceRepository = mockk(relaxed = true)
@@ -106,7 +110,7 @@ class InterfaceStatsViewModelTest {
         clearAllMocks()
 
         // Restore defaults for other tests
-        InterfaceStatsViewModel.enableStatsPolling = true
+        InterfaceStatsViewModel.enableStatsStream = true
         InterfaceStatsViewModel.enableReconnectSignalObserver = true
     }
 
@@ -121,6 +125,13 @@ class InterfaceStatsViewModelTest {
         )
     }
 
+    private fun snapshot(
+        online: Boolean,
+        rxBytes: Long = 0L,
+        txBytes: Long = 0L,
+        name: String = "Test RNode",
+    ) = InterfaceStatsSnapshot(name = name, online = online, rxBytes = rxBytes, txBytes = txBytes)
+
     // ========== Initialization Tests ==========
 
     @Test
@@ -138,7 +149,7 @@ class InterfaceStatsViewModelTest {
     fun `invalid interface ID sets error message`() =
         runTest {
             val viewModel = createViewModel(-1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100)
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -153,10 +164,9 @@ class InterfaceStatsViewModelTest {
     fun `loadInterface sets interface entity on success`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -170,10 +180,9 @@ class InterfaceStatsViewModelTest {
     fun `loadInterface sets error when interface not found`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(99L) } returns null
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(99L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -188,7 +197,7 @@ class InterfaceStatsViewModelTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } throws RuntimeException("Database error")
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -203,10 +212,9 @@ class InterfaceStatsViewModelTest {
     fun `RNode config is parsed correctly`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -225,10 +233,9 @@ class InterfaceStatsViewModelTest {
     fun `TCPClient config is parsed correctly`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(2L) } returns testTcpClientEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(2L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -242,10 +249,9 @@ class InterfaceStatsViewModelTest {
     fun `USB RNode config parses usb_device_id`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(3L) } returns testUsbRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(3L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -259,10 +265,9 @@ class InterfaceStatsViewModelTest {
         runTest {
             val invalidEntity = testRNodeEntity.copy(configJson = "not valid json")
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns invalidEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -272,22 +277,17 @@ class InterfaceStatsViewModelTest {
             }
         }
 
-    // ========== Stats Refresh Tests ==========
+    // ========== Stats Snapshot Tests ==========
 
     @Test
-    fun `refreshStats updates online status`() =
+    fun `applySnapshot updates online status`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats("Test RNode") } returns
-                mapOf(
-                    "online" to true,
-                    "rxb" to 1000L,
-                    "txb" to 500L,
-                )
+            val stats = snapshot(online = true, rxBytes = 1000L, txBytes = 500L)
 
             val viewModel = createViewModel(1L)
             advanceTimeBy(1100) // Allow loadInterface to complete
-            viewModel.refreshStats() // Manually refresh stats since polling is disabled
+            viewModel.applySnapshot(stats) // Stream is disabled; apply a sample directly
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -298,20 +298,15 @@ class InterfaceStatsViewModelTest {
         }
 
     @Test
-    fun `refreshStats updates RSSI for online RNode`() =
+    fun `applySnapshot updates RSSI for online RNode`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats("Test RNode") } returns
-                mapOf(
-                    "online" to true,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
+            val stats = snapshot(online = true)
             every { configManager.getRNodeRssi() } returns -75
 
             val viewModel = createViewModel(1L)
             advanceTimeBy(1100) // Allow loadInterface to complete
-            viewModel.refreshStats() // Manually refresh stats since polling is disabled
+            viewModel.applySnapshot(stats) // Stream is disabled; apply a sample directly
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -320,19 +315,13 @@ class InterfaceStatsViewModelTest {
         }
 
     @Test
-    fun `refreshStats does not set RSSI if value is too low`() =
+    fun `applySnapshot does not set RSSI if value is too low`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats("Test RNode") } returns
-                mapOf(
-                    "online" to true,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
             every { configManager.getRNodeRssi() } returns -150 // Below -100 threshold
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -341,13 +330,12 @@ class InterfaceStatsViewModelTest {
         }
 
     @Test
-    fun `refreshStats handles null interface stats`() =
+    fun `applySnapshot handles null interface stats`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -357,6 +345,71 @@ class InterfaceStatsViewModelTest {
             }
         }
 
+    @Test
+    fun `applySnapshot prefers the sampled RSSI and keeps SNR`() =
+        runTest {
+            coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
+            val stats = snapshot(online = true).copy(rssi = -82, snr = 6.5f)
+
+            val viewModel = createViewModel(1L)
+            advanceTimeBy(1100) // Allow loadInterface to complete
+            viewModel.applySnapshot(stats)
+
+            assertEquals(-82, viewModel.state.value.rssi)
+            assertEquals(6.5f, viewModel.state.value.snr)
+            verify(exactly = 0) { configManager.getRNodeRssi() }
+        }
+
+    // ========== Stats Stream Tests ==========
+
+    @Test
+    fun `stats stream drives rates and history for this interface only`() =
+        runTest {
+            InterfaceStatsViewModel.enableStatsStream = true
+            val stream = MutableSharedFlow<List<InterfaceStatsSnapshot>>()
+            every { reticulumProtocol.observeInterfaceStats() } returns stream
+            coEvery { interfaceRepository.getInterfaceByIdOnce(2L) } returns testTcpClientEntity
+
+            val viewModel = createViewModel(2L)
+            advanceTimeBy(1100) // Allow loadInterface to complete
+            stream.emit(
+                listOf(
+                    snapshot(online = true, rxBytes = 9_999L),
+                    snapshot(online = true, rxBytes = 4_000L, txBytes = 1_000L, name = "Test TCP Client")
+                        .copy(rxRate = 2_000L, txRate = 500L, rxRateHistory = listOf(0f, 2_000f)),
+                ),
+            )
+            runCurrent()
+
+            val state = viewModel.state.value
+            assertTrue(state.isOnline)
+            assertEquals(4_000L, state.rxBytes)
+            assertEquals(2_000L, state.rxRate)
+            assertEquals(500L, state.txRate)
+            assertEquals(listOf(0f, 2_000f), state.rxRateHistory)
+            // One subscription for the screen's lifetime, no per-tick queries
+            verify(exactly = 1) { reticulumProtocol.observeInterfaceStats() }
+        }
+
+    @Test
+    fun `stats stream treats a missing interface as offline`() =
+        runTest {
+            InterfaceStatsViewModel.enableStatsStream = true
+            val stream = MutableSharedFlow<List<InterfaceStatsSnapshot>>()
+            every { reticulumProtocol.observeInterfaceStats() } returns stream
+            coEvery { interfaceRepository.getInterfaceByIdOnce(2L) } returns testTcpClientEntity
+
+            val viewModel = createViewModel(2L)
+            advanceTimeBy(1100) // Allow loadInterface to complete
+            stream.emit(listOf(snapshot(online = true, rxBytes = 100L, name = "Test TCP Client")))
+            runCurrent()
+            stream.emit(listOf(snapshot(online = true)))
+            runCurrent()
+
+            assertFalse(viewModel.state.value.isOnline)
+            assertEquals(0L, viewModel.state.value.rxBytes)
+        }
+
     // ========== Toggle Enabled Tests ==========
 
     @Test
@@ -366,7 +419,6 @@ class InterfaceStatsViewModelTest {
             var toggledId: Long? = null
             var toggledEnabled: Boolean? = null
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
             coEvery { interfaceRepository.toggleInterfaceEnabled(any(), any()) } answers {
                 toggleEnabledCalled = true
                 toggledId = firstArg()
@@ -374,7 +426,7 @@ class InterfaceStatsViewModelTest {
             }
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             // Verify initial state
             assertTrue(
@@ -384,7 +436,7 @@ class InterfaceStatsViewModelTest {
 
             // Toggle to disabled
             viewModel.toggleEnabled()
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             assertTrue("toggleInterfaceEnabled should be called", toggleEnabledCalled)
             assertEquals(1L, toggledId)
@@ -401,16 +453,15 @@ class InterfaceStatsViewModelTest {
         runTest {
             var toggleEnabledCalled = false
             coEvery { interfaceRepository.getInterfaceByIdOnce(99L) } returns null
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
             coEvery { interfaceRepository.toggleInterfaceEnabled(any(), any()) } answers {
                 toggleEnabledCalled = true
             }
 
             val viewModel = createViewModel(99L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.toggleEnabled()
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             // Should not call repository
             assertFalse("toggleInterfaceEnabled should not be called", toggleEnabledCalled)
@@ -422,10 +473,9 @@ class InterfaceStatsViewModelTest {
     fun `signalReconnecting resets connecting state`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.signalReconnecting()
 
@@ -441,15 +491,9 @@ class InterfaceStatsViewModelTest {
     fun `needsUsbPermission is false when not in USB mode`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns
-                mapOf(
-                    "online" to false,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -466,16 +510,11 @@ class InterfaceStatsViewModelTest {
             every { usbManager.hasPermission(mockDevice) } returns false
 
             coEvery { interfaceRepository.getInterfaceByIdOnce(3L) } returns testUsbRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns
-                mapOf(
-                    "online" to false,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
+            val stats = snapshot(online = false)
 
             val viewModel = createViewModel(3L)
             advanceTimeBy(1100) // Allow loadInterface to complete
-            viewModel.refreshStats() // Manually refresh stats since polling is disabled
+            viewModel.applySnapshot(stats) // Stream is disabled; apply a sample directly
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -489,15 +528,9 @@ class InterfaceStatsViewModelTest {
             every { usbManager.deviceList } returns HashMap()
 
             coEvery { interfaceRepository.getInterfaceByIdOnce(3L) } returns testUsbRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns
-                mapOf(
-                    "online" to false,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
 
             val viewModel = createViewModel(3L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -514,16 +547,15 @@ class InterfaceStatsViewModelTest {
                     configJson = """{"connection_mode":"usb","frequency":915000000}""",
                 )
             coEvery { interfaceRepository.getInterfaceByIdOnce(3L) } returns entityWithoutUsbId
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
             every { usbManager.requestPermission(any<UsbDevice>(), any()) } answers {
                 requestPermissionCalled = true
             }
 
             val viewModel = createViewModel(3L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.requestUsbPermission()
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             // Should not interact with USB manager for permission
             assertFalse("requestPermission should not be called without usbDeviceId", requestPermissionCalled)
@@ -544,10 +576,9 @@ class InterfaceStatsViewModelTest {
                     displayOrder = 3,
                 )
             coEvery { interfaceRepository.getInterfaceByIdOnce(4L) } returns tcpServerEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(4L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -572,10 +603,9 @@ class InterfaceStatsViewModelTest {
                     displayOrder = 4,
                 )
             coEvery { interfaceRepository.getInterfaceByIdOnce(5L) } returns unknownEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns null
 
             val viewModel = createViewModel(5L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -589,16 +619,11 @@ class InterfaceStatsViewModelTest {
     fun `isConnecting is true for enabled offline interface that was never online`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns
-                mapOf(
-                    "online" to false,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
+            val stats = snapshot(online = false)
 
             val viewModel = createViewModel(1L)
             advanceTimeBy(1100) // Allow loadInterface to complete
-            viewModel.refreshStats() // Manually refresh stats since polling is disabled
+            viewModel.applySnapshot(stats) // Stream is disabled; apply a sample directly
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -612,15 +637,9 @@ class InterfaceStatsViewModelTest {
         runTest {
             val disabledEntity = testRNodeEntity.copy(enabled = false)
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns disabledEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns
-                mapOf(
-                    "online" to false,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
@@ -632,15 +651,9 @@ class InterfaceStatsViewModelTest {
     fun `isConnecting is false for online interface`() =
         runTest {
             coEvery { interfaceRepository.getInterfaceByIdOnce(1L) } returns testRNodeEntity
-            coEvery { reticulumProtocol.getInterfaceStats(any()) } returns
-                mapOf(
-                    "online" to true,
-                    "rxb" to 0L,
-                    "txb" to 0L,
-                )
 
             val viewModel = createViewModel(1L)
-            advanceTimeBy(1100) // Allow one poll cycle (1000ms + buffer)
+            advanceTimeBy(1100) // Allow loadInterface to complete
 
             viewModel.state.test {
                 val state = awaitItem()
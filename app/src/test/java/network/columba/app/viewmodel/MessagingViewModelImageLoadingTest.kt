@@ -157,6 +157,7 @@ class MessagingViewModelImageLoadingTest {
 
         // Mock activeConversationManager
         every { activeConversationManager.setActive(any()) } just Runs
+        every { activeConversationManager.markRead(any()) } just Runs
 
         // Mock settingsRepository
         every { settingsRepository.messageFontScaleFlow } returns flowOf(1.0f)
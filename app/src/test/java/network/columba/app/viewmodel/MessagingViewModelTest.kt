@@ -36,7 +36,6 @@ import io.mockk.every
 import io.mockk.just
 import io.mockk.mockk
 import io.mockk.mockkStatic
-import io.mockk.slot
 import io.mockk.unmockkStatic
 import io.mockk.verify
 import kotlinx.coroutines.Dispatchers
@@ -135,6 +134,7 @@ class MessagingViewModelTest {
 
         // Mock activeConversationManager methods
         every { activeConversationManager.setActive(any()) } just Runs
+        every { activeConversationManager.markRead(any()) } just Runs
 
         // Mock settingsRepository methods
         coEvery { settingsRepository.getDefaultDeliveryMethod() } returns "direct"
@@ -558,6 +558,7 @@ class MessagingViewModelTest {
 
             val failingActiveConversationManager: ActiveConversationManager = mockk()
             every { failingActiveConversationManager.setActive(any()) } just Runs
+            every { failingActiveConversationManager.markRead(any()) } just Runs
 
             val failingSettingsRepository: SettingsRepository = mockk()
             coEvery { failingSettingsRepository.getDefaultDeliveryMethod() } returns "direct"
@@ -3885,8 +3886,7 @@ class MessagingViewModelTest {
                 rnsLxmf.sendReaction(any(), any(), any(), any())
             } returns Result.success(mockReceipt)
 
-            // Mock updateMessageReactions
-            coEvery { conversationRepository.updateMessageReactions(any(), any()) } just Runs
+            coEvery { conversationRepository.addReaction(any(), any(), any()) } returns true
 
             // Act
             val result = runCatching { viewModel.sendReaction("test-msg-id", "👍") }
@@ -3907,12 +3907,12 @@ class MessagingViewModelTest {
         }
 
     @Test
-    fun `sendReaction writes flat reactionsJson blob to reactionsJson column`() =
+    fun `sendReaction records the reaction under our own sender hash`() =
         runViewModelTest {
             viewModel.loadMessages(testPeerHash, testPeerName)
             advanceUntilIdle()
 
-            // Setup: Mock existing message without reactions
+            // Setup: Mock existing message
             val testMessage =
                 MessageEntity(
                     id = "test-msg-id",
@@ -3926,7 +3926,6 @@ class MessagingViewModelTest {
                     deliveryMethod = null,
                     errorMessage = null,
                     replyToMessageId = null,
-                    reactionsJson = null,
                 )
             coEvery { conversationRepository.getMessageById("test-msg-id") } returns testMessage
 
@@ -3936,23 +3935,16 @@ class MessagingViewModelTest {
             coEvery {
                 rnsLxmf.sendReaction(any(), any(), any(), any())
             } returns Result.success(mockReceipt)
-
-            // Capture the reactionsJson update
-            val capturedReactionsJson = slot<String>()
-            coEvery {
-                conversationRepository.updateMessageReactions("test-msg-id", capture(capturedReactionsJson))
-            } just Runs
+            coEvery { conversationRepository.addReaction(any(), any(), any()) } returns true
 
             // Act
             viewModel.sendReaction("test-msg-id", "👍")
             advanceUntilIdle()
 
-            // Assert: Database was updated with the flat reactions blob
-            // (DB v2+ shape — no field-16 wrapper).
-            assertTrue(capturedReactionsJson.isCaptured)
-            val json = org.json.JSONObject(capturedReactionsJson.captured)
-            assertTrue(json.has("👍"))
-            assertEquals(1, json.getJSONArray("👍").length())
+            // Assert: one reaction row for (target, emoji, our identity hash);
+            // no read-modify-write of the message row
+            val ourHash = testIdentity.hash.joinToString("") { "%02x".format(it) }
+            coVerify(exactly = 1) { conversationRepository.addReaction("test-msg-id", "👍", ourHash) }
         }
 
     @Test
@@ -3984,7 +3976,7 @@ class MessagingViewModelTest {
             coEvery {
                 rnsLxmf.sendReaction(any(), any(), any(), any())
             } returns Result.success(mockReceipt)
-            coEvery { conversationRepository.updateMessageReactions(any(), any()) } just Runs
+            coEvery { conversationRepository.addReaction(any(), any(), any()) } returns true
 
             // Set up reaction target first
             viewModel.setReactionTarget("test-msg-id")
@@ -4026,7 +4018,7 @@ class MessagingViewModelTest {
             coEvery {
                 rnsLxmf.sendReaction(any(), any(), any(), any())
             } returns Result.failure(Exception("Network error"))
-            coEvery { conversationRepository.updateMessageReactions(any(), any()) } just Runs
+            coEvery { conversationRepository.addReaction(any(), any(), any()) } returns true
 
             // Set up reaction target
             viewModel.setReactionTarget("test-msg-id")
@@ -4040,116 +4032,18 @@ class MessagingViewModelTest {
             assertNull(viewModel.pendingReactionMessageId.value)
 
             // Assert: Local database was still updated (optimistic update)
-            coVerify { conversationRepository.updateMessageReactions("test-msg-id", any()) }
-        }
-
-    @Test
-    fun `sendReaction does not touch fieldsJson when the target has reply metadata`() =
-        runViewModelTest {
-            // DB v2 split: reply metadata stays in fieldsJson / dedicated
-            // `replyToMessageId` column, reactions live in reactionsJson.
-            // The two never collide, so reactions for a reply-message
-            // only need to update reactionsJson.
-            viewModel.loadMessages(testPeerHash, testPeerName)
-            advanceUntilIdle()
-
-            val testMessage =
-                MessageEntity(
-                    id = "test-msg-id",
-                    conversationHash = testPeerHash,
-                    identityHash = "test_identity_hash",
-                    content = "Hello",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = false,
-                    status = "delivered",
-                    fieldsJson = null,
-                    deliveryMethod = null,
-                    errorMessage = null,
-                    replyToMessageId = "original-msg-id",
-                    reactionsJson = null,
-                )
-            coEvery { conversationRepository.getMessageById("test-msg-id") } returns testMessage
-
-            val mockReceipt = mockk<MessageReceipt>()
-            every { mockReceipt.messageHash } returns ByteArray(16) { it.toByte() }
-            coEvery {
-                rnsLxmf.sendReaction(any(), any(), any(), any())
-            } returns Result.success(mockReceipt)
-
-            val capturedReactionsJson = slot<String>()
-            coEvery {
-                conversationRepository.updateMessageReactions("test-msg-id", capture(capturedReactionsJson))
-            } just Runs
-
-            viewModel.sendReaction("test-msg-id", "❤️")
-            advanceUntilIdle()
-
-            // Assert: only the reactions blob is touched.
-            assertTrue(capturedReactionsJson.isCaptured)
-            val json = org.json.JSONObject(capturedReactionsJson.captured)
-            assertTrue(json.has("❤️"))
-            assertEquals(1, json.length()) // no other keys leaked in
-        }
-
-    @Test
-    fun `sendReaction adds sender to existing emoji reaction`() =
-        runViewModelTest {
-            viewModel.loadMessages(testPeerHash, testPeerName)
-            advanceUntilIdle()
-
-            // Setup: target message already has a 👍 reaction from another peer
-            val existingReactionsJson = """{"👍": ["other-sender-hash"]}"""
-            val testMessage =
-                MessageEntity(
-                    id = "test-msg-id",
-                    conversationHash = testPeerHash,
-                    identityHash = "test_identity_hash",
-                    content = "Hello",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = false,
-                    status = "delivered",
-                    fieldsJson = null,
-                    deliveryMethod = null,
-                    errorMessage = null,
-                    replyToMessageId = null,
-                    reactionsJson = existingReactionsJson,
-                )
-            coEvery { conversationRepository.getMessageById("test-msg-id") } returns testMessage
-
-            // Mock protocol
-            val mockReceipt = mockk<MessageReceipt>()
-            every { mockReceipt.messageHash } returns ByteArray(16) { it.toByte() }
-            coEvery {
-                rnsLxmf.sendReaction(any(), any(), any(), any())
-            } returns Result.success(mockReceipt)
-
-            // Capture the reactionsJson update
-            val capturedReactionsJson = slot<String>()
-            coEvery {
-                conversationRepository.updateMessageReactions("test-msg-id", capture(capturedReactionsJson))
-            } just Runs
-
-            // Act
-            viewModel.sendReaction("test-msg-id", "👍")
-            advanceUntilIdle()
-
-            // Assert: Both senders are in the reaction list
-            assertTrue(capturedReactionsJson.isCaptured)
-            val json = org.json.JSONObject(capturedReactionsJson.captured)
-            val thumbsUp = json.getJSONArray("👍")
-            assertEquals(2, thumbsUp.length())
-            assertEquals("other-sender-hash", thumbsUp.getString(0))
-            // Our sender hash is derived from testIdentity
+            coVerify { conversationRepository.addReaction("test-msg-id", "👍", any()) }
         }
 
     // ========== INCOMING REACTION TESTS ==========
 
     @Test
-    fun `handleIncomingReaction updates message when found`() =
+    fun `handleIncomingReaction records reaction against the target message`() =
         runTest {
             // Setup: Create a flow to emit reactions BEFORE ViewModel creation
             val reactionFlow = MutableSharedFlow<String>()
             every { rnsTransportAdmin.reactionReceivedFlow } returns reactionFlow
+            coEvery { conversationRepository.addReaction(any(), any(), any()) } returns true
 
             val viewModel = createTestViewModel()
             advanceUntilIdle()
@@ -4157,45 +4051,20 @@ class MessagingViewModelTest {
             viewModel.loadMessages(testPeerHash, testPeerName)
             advanceUntilIdle()
 
-            // Setup: Mock target message
-            val targetMessage =
-                MessageEntity(
-                    id = "target-msg-id",
-                    conversationHash = testPeerHash,
-                    identityHash = "test_identity_hash",
-                    content = "Hello",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = true,
-                    status = "delivered",
-                    fieldsJson = null,
-                    deliveryMethod = null,
-                    errorMessage = null,
-                    replyToMessageId = null,
-                    reactionsJson = null,
-                )
-            coEvery { conversationRepository.getMessageById("target-msg-id") } returns targetMessage
-
-            // Capture the reactionsJson update
-            val capturedReactionsJson = slot<String>()
-            coEvery {
-                conversationRepository.updateMessageReactions("target-msg-id", capture(capturedReactionsJson))
-            } just Runs
-
             // Act: Emit incoming reaction
             val reactionJson = """{"reaction_to": "target-msg-id", "emoji": "😂", "sender": "remote-sender-hash"}"""
             reactionFlow.emit(reactionJson)
             advanceUntilIdle()
 
-            // Assert: Database was updated with flat reactionsJson blob
-            assertTrue(capturedReactionsJson.isCaptured)
-            val json = org.json.JSONObject(capturedReactionsJson.captured)
-            assertTrue(json.has("😂"))
-            val senders = json.getJSONArray("😂")
-            assertEquals("remote-sender-hash", senders.getString(0))
+            // Assert: a single idempotent insert, no lookup of the target row
+            coVerify(exactly = 1) {
+                conversationRepository.addReaction("target-msg-id", "😂", "remote-sender-hash")
+            }
+            coVerify(exactly = 0) { conversationRepository.getMessageById("target-msg-id") }
         }
 
     @Test
-    fun `handleIncomingReaction ignores message when not found`() =
+    fun `handleIncomingReaction tolerates unknown target message`() =
         runViewModelTest {
             // Setup: Create a flow to emit reactions
             val reactionFlow = MutableSharedFlow<String>()
@@ -4206,8 +4075,8 @@ class MessagingViewModelTest {
             viewModel.loadMessages(testPeerHash, testPeerName)
             advanceUntilIdle()
 
-            // Setup: Message not found
-            coEvery { conversationRepository.getMessageById("nonexistent-msg") } returns null
+            // Setup: insert is ignored because the target isn't stored
+            coEvery { conversationRepository.addReaction("nonexistent-msg", any(), any()) } returns false
 
             // Act: Emit incoming reaction for unknown message
             val reactionJson = """{"reaction_to": "nonexistent-msg", "emoji": "👍", "sender": "remote-sender"}"""
@@ -4216,9 +4085,6 @@ class MessagingViewModelTest {
 
             // Assert: Emission completed successfully
             assertTrue("Reaction emission should complete without error", emitResult.isSuccess)
-
-            // Assert: No database update was attempted
-            coVerify(exactly = 0) { conversationRepository.updateMessageReactions(any(), any()) }
         }
 
     @Test
@@ -4248,59 +4114,7 @@ class MessagingViewModelTest {
             assertTrue("Incomplete JSON emission should complete without error", result2.isSuccess)
 
             // Assert: No database update was attempted for invalid reactions
-            coVerify(exactly = 0) { conversationRepository.updateMessageReactions(any(), any()) }
-        }
-
-    @Test
-    fun `handleIncomingReaction merges reactions with existing`() =
-        runTest {
-            // Setup: Create a flow to emit reactions BEFORE ViewModel creation
-            val reactionFlow = MutableSharedFlow<String>()
-            every { rnsTransportAdmin.reactionReceivedFlow } returns reactionFlow
-
-            val viewModel = createTestViewModel()
-            advanceUntilIdle()
-
-            viewModel.loadMessages(testPeerHash, testPeerName)
-            advanceUntilIdle()
-
-            // Setup: target message already has a 👍 reaction from sender-1
-            val existingReactionsJson = """{"👍": ["sender-1"]}"""
-            val targetMessage =
-                MessageEntity(
-                    id = "target-msg-id",
-                    conversationHash = testPeerHash,
-                    identityHash = "test_identity_hash",
-                    content = "Hello",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = true,
-                    status = "delivered",
-                    fieldsJson = null,
-                    deliveryMethod = null,
-                    errorMessage = null,
-                    replyToMessageId = null,
-                    reactionsJson = existingReactionsJson,
-                )
-            coEvery { conversationRepository.getMessageById("target-msg-id") } returns targetMessage
-
-            // Capture the reactionsJson update
-            val capturedReactionsJson = slot<String>()
-            coEvery {
-                conversationRepository.updateMessageReactions("target-msg-id", capture(capturedReactionsJson))
-            } just Runs
-
-            // Act: Emit incoming reaction with different emoji
-            val reactionJson = """{"reaction_to": "target-msg-id", "emoji": "❤️", "sender": "sender-2"}"""
-            reactionFlow.emit(reactionJson)
-            advanceUntilIdle()
-
-            // Assert: Both reactions exist in the flat blob
-            assertTrue(capturedReactionsJson.isCaptured)
-            val json = org.json.JSONObject(capturedReactionsJson.captured)
-            assertTrue(json.has("👍"))
-            assertTrue(json.has("❤️"))
-            assertEquals(1, json.getJSONArray("👍").length())
-            assertEquals(1, json.getJSONArray("❤️").length())
+            coVerify(exactly = 0) { conversationRepository.addReaction(any(), any(), any()) }
         }
 
     // ========== IMAGE STATE TESTS ==========
@@ -1644,5 +1644,190 @@ class OfflineMapDownloadViewModelTest {
             assertEquals(RadiusOption.SMALL, viewModel.state.value.radiusOption)
         }
 
+    @Test
+    fun `updating an MBTiles region updates its file in place`() =
+        runTest {
+            val path = java.io.File(context.cacheDir, "home.mbtiles").absolutePath
+            val existingRegion =
+                OfflineMapRegion(
+                    id = 42L,
+                    name = "Home Area",
+                    centerLatitude = 40.7128,
+                    centerLongitude = -74.0060,
+                    radiusKm = 10,
+                    minZoom = 2,
+                    maxZoom = 12,
+                    status = OfflineMapRegion.Status.COMPLETE,
+                    mbtilesPath = path,
+                    tileCount = 10,
+                    sizeBytes = 200_000L,
+                    downloadProgress = 1.0f,
+                    errorMessage = null,
+                    createdAt = System.currentTimeMillis(),
+                    completedAt = System.currentTimeMillis(),
+                    source = OfflineMapRegion.Source.HTTP,
+                    tileVersion = "20260107_001001_pt",
+                )
+            coEvery { offlineMapRegionRepository.getRegionById(42L) } returns existingRegion
+            coEvery { offlineMapRegionRepository.markComplete(any(), any(), any(), any(), any()) } just Runs
+            val manager = mockk<TileDownloadManager>(relaxed = true)
+            every { manager.progress } returns
+                MutableStateFlow(
+                    TileDownloadManager.DownloadProgress(
+                        status = TileDownloadManager.DownloadProgress.Status.COMPLETE,
+                        totalTiles = 10,
+                        downloadedTiles = 10,
+                        failedTiles = 0,
+                        bytesDownloaded = 4_000L,
+                        currentZoom = 12,
+                        reusedTiles = 8,
+                    ),
+                )
+            every { manager.lastResolvedVersion } returns "20260305_001001_pt"
+            coEvery {
+                manager.updateRegion(any(), any(), any(), any(), any(), any(), any(), any())
+            } returns java.io.File(path)
+
+            viewModel = createViewModel()
+            viewModel.tileDownloadManagerFactory = { manager }
+            viewModel.initForUpdate(42L)
+            viewModel.nextStep()
+
+            assertTrue(viewModel.state.value.isComplete)
+            coVerify { offlineMapRegionRepository.markComplete(42L, 10, any(), path, "20260305_001001_pt") }
+            coVerify(exactly = 0) { offlineMapRegionRepository.deleteRegion(any()) }
+            coVerify(exactly = 0) { offlineMapRegionRepository.createRegion(any(), any(), any(), any(), any(), any()) }
+        }
+
+    @Test
+    fun `updating an MBTiles region with failed tiles keeps its version and reports them`() =
+        runTest {
+            val path = java.io.File(context.cacheDir, "home.mbtiles").absolutePath
+            coEvery { offlineMapRegionRepository.getRegionById(42L) } returns
+                OfflineMapRegion(
+                    id = 42L,
+                    name = "Home Area",
+                    centerLatitude = 40.7128,
+                    centerLongitude = -74.0060,
+                    radiusKm = 10,
+                    minZoom = 2,
+                    maxZoom = 12,
+                    status = OfflineMapRegion.Status.COMPLETE,
+                    mbtilesPath = path,
+                    tileCount = 10,
+                    sizeBytes = 200_000L,
+                    downloadProgress = 1.0f,
+                    errorMessage = null,
+                    createdAt = System.currentTimeMillis(),
+                    completedAt = System.currentTimeMillis(),
+                    source = OfflineMapRegion.Source.HTTP,
+                    tileVersion = "20260107_001001_pt",
+                )
+            coEvery { offlineMapRegionRepository.markComplete(any(), any(), any(), any(), any()) } just Runs
+            val manager = mockk<TileDownloadManager>(relaxed = true)
+            every { manager.progress } returns
+                MutableStateFlow(
+                    TileDownloadManager.DownloadProgress(
+                        status = TileDownloadManager.DownloadProgress.Status.COMPLETE,
+                        totalTiles = 10,
+                        downloadedTiles = 7,
+                        failedTiles = 3,
+                        bytesDownloaded = 4_000L,
+                        currentZoom = 12,
+                        reusedTiles = 5,
+                    ),
+                )
+            every { manager.lastResolvedVersion } returns "20260305_001001_pt"
+            coEvery {
+                manager.updateRegion(any(), any(), any(), any(), any(), any(), any(), any())
+            } returns java.io.File(path)
+
+            viewModel = createViewModel()
+            viewModel.tileDownloadManagerFactory = { manager }
+            viewModel.initForUpdate(42L)
+            viewModel.nextStep()
+
+            val state = viewModel.state.value
+            assertTrue(state.isComplete)
+            assertNull(state.errorMessage)
+            assertTrue(state.downloadProgress?.statusMessage.orEmpty().startsWith("3 tiles"))
+            coVerify { offlineMapRegionRepository.markComplete(42L, 7, any(), path, "20260107_001001_pt") }
+        }
+
+    private fun maplibreRegion() =
+        OfflineMapRegion(
+            id = 42L,
+            name = "Home Area",
+            centerLatitude = 40.7128,
+            centerLongitude = -74.0060,
+            radiusKm = 25,
+            minZoom = 2,
+            maxZoom = 12,
+            status = OfflineMapRegion.Status.COMPLETE,
+            mbtilesPath = null,
+            tileCount = 500,
+            sizeBytes = 10_000_000L,
+            downloadProgress = 1.0f,
+            errorMessage = null,
+            createdAt = System.currentTimeMillis(),
+            completedAt = System.currentTimeMillis(),
+            source = OfflineMapRegion.Source.HTTP,
+            tileVersion = "20260107_001001_pt",
+            maplibreRegionId = 99L,
+        )
+
+    @Test
+    fun `updating a MapLibre region refreshes it in place`() =
+        runTest {
+            coEvery { offlineMapRegionRepository.getRegionById(42L) } returns maplibreRegion()
+            every { mockMapLibreOfflineManager.refreshRegion(99L, any(), any(), any()) } answers {
+                arg<(Float, Long, Long) -> Unit>(1)(1f, 500L, 500L)
+                arg<(Long, Long) -> Unit>(2)(99L, 11_000_000L)
+            }
+
+            viewModel = createViewModel()
+            viewModel.initForUpdate(42L)
+            viewModel.nextStep()
+
+            assertTrue(viewModel.state.value.isComplete)
+            coVerify { offlineMapRegionRepository.markCompleteWithMaplibreId(42L, 500, 11_000_000L, 99L) }
+            coVerify { offlineMapRegionRepository.updateTileVersion(42L, "20260305_001001_pt") }
+            coVerify(exactly = 0) { offlineMapRegionRepository.createRegion(any(), any(), any(), any(), any(), any()) }
+            coVerify(exactly = 0) { offlineMapRegionRepository.deleteRegion(any()) }
+            verify(exactly = 0) { mockMapLibreOfflineManager.deleteRegion(any(), any()) }
+        }
+
+    @Test
+    fun `cancelling a MapLibre refresh keeps the region`() =
+        runTest {
+            coEvery { offlineMapRegionRepository.getRegionById(42L) } returns maplibreRegion()
+            every { mockMapLibreOfflineManager.refreshRegion(99L, any(), any(), any()) } just Runs
+            every { mockMapLibreOfflineManager.cancelRefresh(99L) } just Runs
+
+            viewModel = createViewModel()
+            viewModel.initForUpdate(42L)
+            viewModel.nextStep()
+            viewModel.cancelDownload()
+
+            verify { mockMapLibreOfflineManager.cancelRefresh(99L) }
+            verify(exactly = 0) { mockMapLibreOfflineManager.deleteRegion(any(), any()) }
+            coVerify(exactly = 0) { offlineMapRegionRepository.deleteRegion(any()) }
+        }
+
+    @Test
+    fun `updating a MapLibre region with a new zoom range downloads it again`() =
+        runTest {
+            coEvery { offlineMapRegionRepository.getRegionById(42L) } returns maplibreRegion()
+            coEvery { offlineMapRegionRepository.createRegion(any(), any(), any(), any(), any(), any()) } returns 123L
+
+            viewModel = createViewModel()
+            viewModel.initForUpdate(42L)
+            viewModel.setZoomRange(2, 14)
+            viewModel.nextStep()
+
+            verify { mockMapLibreOfflineManager.downloadRegion(any(), any(), any(), 14.0, any(), any(), any(), any(), any()) }
+            verify(exactly = 0) { mockMapLibreOfflineManager.refreshRegion(any(), any(), any(), any()) }
+        }
+
     // endregion
 }
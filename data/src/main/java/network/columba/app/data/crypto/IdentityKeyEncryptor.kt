@@ -5,9 +5,13 @@ import android.security.keystore.KeyProperties
 import android.util.Log
 import java.nio.ByteBuffer
 import java.security.KeyStore
+import java.security.MessageDigest
 import java.security.SecureRandom
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicLong
 import javax.crypto.Cipher
 import javax.crypto.KeyGenerator
+import javax.crypto.Mac
 import javax.crypto.SecretKey
 import javax.crypto.SecretKeyFactory
 import javax.crypto.spec.GCMParameterSpec
@@ -25,7 +29,17 @@ import javax.inject.Singleton
  *
  * Encrypted format:
  * - Version 1 (Device-only): [0x01][12-byte IV][encrypted data][16-byte auth tag]
- * - Version 2 (Device+Password): [0x02][32-byte salt][12-byte IV][encrypted v1 data][16-byte auth tag]
+ * - Version 2 (Device+Password, legacy): [0x02][32-byte salt][12-byte IV][encrypted v1 data][16-byte auth tag]
+ * - Version 3 (Device+Password): [0x03][4-byte iterations][32-byte salt][12-byte IV][encrypted v1 data][16-byte auth tag]
+ *
+ * Version 2 ran one 600K-iteration PBKDF2 for the AES key and a separate
+ * 300K-iteration PBKDF2 for the stored verification hash. Version 3 runs a
+ * single PBKDF2, at an iteration count calibrated to this device and stored in
+ * the blob, and splits its output with HKDF into the AES key and the verifier.
+ * Its header (version, iterations and salt) is authenticated as GCM
+ * associated data, and blobs recording fewer than [MIN_PASSWORD_ITERATIONS]
+ * are refused. Version 2 blobs still decrypt and are upgraded on unlock (see
+ * [unlockWithPassword]).
  */
 @Suppress("TooManyFunctions") // Encryption API requires many related functions
 @Singleton
@@ -44,21 +58,87 @@ class IdentityKeyEncryptor
             private const val GCM_IV_LENGTH = 12
             private const val GCM_TAG_LENGTH = 128
             private const val SALT_LENGTH = 32
+            private const val V3_HEADER_LENGTH = 1 + 4 + SALT_LENGTH
 
             // PBKDF2 parameters (600K iterations as per OWASP recommendation)
             private const val PBKDF2_ITERATIONS = 600_000
             private const val PBKDF2_KEY_LENGTH = 256
 
+            // Version 3 KDF cost: calibrated so one derivation takes about
+            // TARGET_KDF_MILLIS here, within these bounds
+            private const val TARGET_KDF_MILLIS = 400L
+            const val MIN_PASSWORD_ITERATIONS = 300_000
+            const val MAX_PASSWORD_ITERATIONS = 2_000_000
+            private const val CALIBRATION_ITERATIONS = 20_000
+
+            // HKDF labels splitting the version 3 PBKDF2 output
+            private val HKDF_INFO_ENCRYPTION = "columba-identity-key-encryption".toByteArray()
+            private val HKDF_INFO_VERIFIER = "columba-identity-key-verifier".toByteArray()
+
             // Version bytes
             const val VERSION_DEVICE_ONLY: Byte = 0x01
             const val VERSION_DEVICE_AND_PASSWORD: Byte = 0x02
+            const val VERSION_DEVICE_AND_PASSWORD_V3: Byte = 0x03
 
             // Expected key size
             const val IDENTITY_KEY_SIZE = 64
+
+            /**
+             * Whether a stored encryption version needs a password to unlock.
+             */
+            fun isPasswordVersion(version: Int): Boolean =
+                version == VERSION_DEVICE_AND_PASSWORD.toInt() || version == VERSION_DEVICE_AND_PASSWORD_V3.toInt()
+        }
+
+        /**
+         * Password-protected key data plus the values stored beside it.
+         *
+         * @property encryptedData Version 3 blob
+         * @property salt The blob's KDF salt (stored as `passwordSalt`)
+         * @property verificationHash Verifier from the same derivation (stored as `passwordVerificationHash`)
+         */
+        class PasswordProtectedKey(
+            val encryptedData: ByteArray,
+            val salt: ByteArray,
+            val verificationHash: ByteArray,
+        )
+
+        /**
+         * Result of unlocking password-protected key data.
+         *
+         * @property keyData The decrypted 64-byte identity key
+         * @property upgraded Re-encrypted version 3 data if the input was version 2, else null
+         */
+        class PasswordUnlockResult(
+            val keyData: ByteArray,
+            val upgraded: PasswordProtectedKey?,
+        )
+
+        /**
+         * Running totals of password key derivations, for diagnostics and tests.
+         */
+        class KdfCounters {
+            val derivations = AtomicInteger()
+            val iterations = AtomicLong()
+            val nanos = AtomicLong()
+
+            fun reset() {
+                derivations.set(0)
+                iterations.set(0)
+                nanos.set(0)
+            }
         }
 
+        val kdfCounters = KdfCounters()
+
+        // Lowest iteration count accepted from stored data; only tests lower it
+        internal var minPasswordIterations = MIN_PASSWORD_ITERATIONS
+
         private val secureRandom = SecureRandom()
 
+        @Volatile
+        private var calibratedIterations = 0
+
         /**
          * Get or create the master encryption key from Android Keystore.
          * This key is hardware-backed (TEE/StrongBox) when available.
@@ -182,11 +262,11 @@ class IdentityKeyEncryptor
         /**
          * Encrypt identity key data with device + password protection (Layer 1 + Layer 2).
          *
-         * Format: [0x02][32-byte salt][12-byte IV][encrypted v1 data][16-byte auth tag]
+         * Format: version 3 (see class docs)
          *
          * @param plainKeyData The 64-byte identity key to encrypt
          * @param password The user's password for additional protection
-         * @return Double-encrypted data with version, salt, and IV
+         * @return Double-encrypted data with version, iterations, salt, and IV
          */
         fun encryptWithPassword(
             plainKeyData: ByteArray,
@@ -199,49 +279,112 @@ class IdentityKeyEncryptor
             // First, encrypt with device key (Layer 1)
             val deviceEncrypted = encryptWithDeviceKey(plainKeyData)
 
-            // Generate salt for password derivation
+            // Then with the password (Layer 2)
+            return sealWithPassword(deviceEncrypted, password).encryptedData
+        }
+
+        /**
+         * Decrypt identity key data encrypted with device + password protection.
+         *
+         * @param encryptedData The double-encrypted data (version 2 or 3)
+         * @param password The user's password
+         * @return Decrypted 64-byte identity key
+         * @throws WrongPasswordException if the password is incorrect
+         * @throws CorruptedKeyException if data is corrupted or tampered
+         */
+        fun decryptWithPassword(
+            encryptedData: ByteArray,
+            password: CharArray,
+        ): ByteArray {
+            val deviceEncrypted = openWithPassword(encryptedData, password)
+
+            // Now decrypt with device key (Layer 1)
+            return decryptWithDeviceKey(deviceEncrypted)
+        }
+
+        /**
+         * Decrypt password-protected data, upgrading version 2 data to version 3.
+         *
+         * Version 3 data costs one key derivation. Version 2 data costs a second
+         * one, once, to re-encrypt it; the caller stores [PasswordUnlockResult.upgraded].
+         *
+         * @throws WrongPasswordException if the password is incorrect
+         * @throws CorruptedKeyException if data is corrupted or tampered
+         */
+        fun unlockWithPassword(
+            encryptedData: ByteArray,
+            password: CharArray,
+        ): PasswordUnlockResult {
+            val deviceEncrypted = openWithPassword(encryptedData, password)
+            val keyData = decryptWithDeviceKey(deviceEncrypted)
+            val upgraded =
+                if (encryptedData[0] == VERSION_DEVICE_AND_PASSWORD) {
+                    sealWithPassword(deviceEncrypted, password)
+                } else {
+                    null
+                }
+            return PasswordUnlockResult(keyData, upgraded)
+        }
+
+        /**
+         * Encrypt device-encrypted (version 1) data with a password, producing
+         * version 3 data and its verifier from a single key derivation.
+         *
+         * @param iterations PBKDF2 iterations; defaults to this device's calibrated count
+         */
+        internal fun sealWithPassword(
+            deviceEncrypted: ByteArray,
+            password: CharArray,
+            iterations: Int = passwordIterations(),
+        ): PasswordProtectedKey {
+            require(iterations >= minPasswordIterations) { "KDF iteration count $iterations below $minPasswordIterations" }
             val salt = ByteArray(SALT_LENGTH)
             secureRandom.nextBytes(salt)
 
-            // Derive key from password
-            val passwordKey = deriveKeyFromPassword(password, salt)
+            val (passwordKey, verifier) = deriveKeyAndVerifier(password, salt, iterations)
+
+            // Authenticated as associated data, so the header can't be altered
+            val header =
+                ByteBuffer.allocate(V3_HEADER_LENGTH)
+                    .put(VERSION_DEVICE_AND_PASSWORD_V3)
+                    .putInt(iterations)
+                    .put(salt)
+                    .array()
 
-            // Encrypt the device-encrypted data with password key (Layer 2)
             val cipher = Cipher.getInstance("AES/GCM/NoPadding")
             cipher.init(Cipher.ENCRYPT_MODE, passwordKey)
+            cipher.updateAAD(header)
             val iv = cipher.iv
             val doubleEncrypted = cipher.doFinal(deviceEncrypted)
 
             // Securely clear the password key from memory
             secureWipe(passwordKey.encoded)
 
-            // Combine: version + salt + IV + encrypted data (includes auth tag)
-            return ByteBuffer.allocate(1 + SALT_LENGTH + GCM_IV_LENGTH + doubleEncrypted.size)
-                .put(VERSION_DEVICE_AND_PASSWORD)
-                .put(salt)
-                .put(iv)
-                .put(doubleEncrypted)
-                .array()
+            // Combine: version + iterations + salt + IV + encrypted data (includes auth tag)
+            val encrypted = header + iv + doubleEncrypted
+            return PasswordProtectedKey(encrypted, salt, verifier)
         }
 
         /**
-         * Decrypt identity key data encrypted with device + password protection.
+         * Remove the password layer (version 2 or 3), returning the device-encrypted
+         * (version 1) data inside.
          *
-         * @param encryptedData The double-encrypted data
-         * @param password The user's password
-         * @return Decrypted 64-byte identity key
          * @throws WrongPasswordException if the password is incorrect
          * @throws CorruptedKeyException if data is corrupted or tampered
          */
         @Suppress("ThrowsCount") // Input validation requires multiple checks
-        fun decryptWithPassword(
+        internal fun openWithPassword(
             encryptedData: ByteArray,
             password: CharArray,
         ): ByteArray {
             validatePasswordEncryptedData(encryptedData)
 
             val buffer = ByteBuffer.wrap(encryptedData)
-            buffer.get() // Skip version byte (already validated)
+            val version = buffer.get()
+            val iterations = if (version == VERSION_DEVICE_AND_PASSWORD_V3) buffer.getInt() else PBKDF2_ITERATIONS
+            if (iterations !in minPasswordIterations..MAX_PASSWORD_ITERATIONS * 4) {
+                throw CorruptedKeyException("Invalid KDF iteration count: $iterations")
+            }
 
             val salt = ByteArray(SALT_LENGTH)
             buffer.get(salt)
@@ -253,22 +396,25 @@ class IdentityKeyEncryptor
             buffer.get(ciphertext)
 
             // Derive key from password
-            val passwordKey = deriveKeyFromPassword(password, salt)
-
-            val deviceEncrypted =
-                try {
-                    val cipher = Cipher.getInstance("AES/GCM/NoPadding")
-                    cipher.init(Cipher.DECRYPT_MODE, passwordKey, GCMParameterSpec(GCM_TAG_LENGTH, iv))
-                    cipher.doFinal(ciphertext)
-                } catch (e: Exception) {
-                    secureWipe(passwordKey.encoded)
-                    throw WrongPasswordException("Password incorrect or data corrupted", e)
-                } finally {
-                    secureWipe(passwordKey.encoded)
+            val passwordKey =
+                if (version == VERSION_DEVICE_AND_PASSWORD_V3) {
+                    deriveKeyAndVerifier(password, salt, iterations).first
+                } else {
+                    deriveKeyFromPassword(password, salt)
                 }
 
-            // Now decrypt with device key (Layer 1)
-            return decryptWithDeviceKey(deviceEncrypted)
+            return try {
+                val cipher = Cipher.getInstance("AES/GCM/NoPadding")
+                cipher.init(Cipher.DECRYPT_MODE, passwordKey, GCMParameterSpec(GCM_TAG_LENGTH, iv))
+                if (version == VERSION_DEVICE_AND_PASSWORD_V3) {
+                    cipher.updateAAD(encryptedData, 0, V3_HEADER_LENGTH)
+                }
+                cipher.doFinal(ciphertext)
+            } catch (e: Exception) {
+                throw WrongPasswordException("Password incorrect or data corrupted", e)
+            } finally {
+                secureWipe(passwordKey.encoded)
+            }
         }
 
         @Suppress("ThrowsCount") // Validation needs multiple throw statements for different error cases
@@ -276,29 +422,115 @@ class IdentityKeyEncryptor
             if (encryptedData.isEmpty()) {
                 throw CorruptedKeyException("Encrypted data is empty")
             }
-            if (encryptedData[0] != VERSION_DEVICE_AND_PASSWORD) {
+            if (!isPasswordVersion(encryptedData[0].toInt())) {
                 throw CorruptedKeyException("Unsupported encryption version: ${encryptedData[0]} (expected device+password)")
             }
-            val minSize = 1 + SALT_LENGTH + GCM_IV_LENGTH + 1 + GCM_IV_LENGTH + IDENTITY_KEY_SIZE
+            val iterationsSize = if (encryptedData[0] == VERSION_DEVICE_AND_PASSWORD_V3) 4 else 0
+            val minSize = 1 + iterationsSize + SALT_LENGTH + GCM_IV_LENGTH + 1 + GCM_IV_LENGTH + IDENTITY_KEY_SIZE
             if (encryptedData.size < minSize) {
                 throw CorruptedKeyException("Encrypted data too short")
             }
         }
 
         /**
-         * Derive an AES key from a password using PBKDF2.
+         * Derive an AES key from a password using PBKDF2 (version 2 and export format).
          */
         private fun deriveKeyFromPassword(
             password: CharArray,
             salt: ByteArray,
         ): SecretKey {
+            val derived = pbkdf2(password, salt, PBKDF2_ITERATIONS, PBKDF2_KEY_LENGTH)
+            return SecretKeySpec(derived, "AES").also {
+                secureWipe(derived)
+            }
+        }
+
+        /**
+         * Version 3 derivation: one PBKDF2, split by HKDF into the AES key and
+         * the password verifier.
+         */
+        private fun deriveKeyAndVerifier(
+            password: CharArray,
+            salt: ByteArray,
+            iterations: Int,
+        ): Pair<SecretKey, ByteArray> {
+            val master = pbkdf2(password, salt, iterations, PBKDF2_KEY_LENGTH)
+            try {
+                val prk = hkdfExtract(salt, master)
+                val keyBytes = hkdfExpand(prk, HKDF_INFO_ENCRYPTION)
+                val verifier = hkdfExpand(prk, HKDF_INFO_VERIFIER)
+                secureWipe(prk)
+                return SecretKeySpec(keyBytes, "AES").also { secureWipe(keyBytes) } to verifier
+            } finally {
+                secureWipe(master)
+            }
+        }
+
+        private fun pbkdf2(
+            password: CharArray,
+            salt: ByteArray,
+            iterations: Int,
+            keyLengthBits: Int,
+        ): ByteArray {
+            val start = System.nanoTime()
             val factory = SecretKeyFactory.getInstance("PBKDF2WithHmacSHA256")
-            val spec = PBEKeySpec(password, salt, PBKDF2_ITERATIONS, PBKDF2_KEY_LENGTH)
-            val tmp = factory.generateSecret(spec)
+            val spec = PBEKeySpec(password, salt, iterations, keyLengthBits)
+            val derived = factory.generateSecret(spec).encoded
             spec.clearPassword()
-            return SecretKeySpec(tmp.encoded, "AES").also {
-                secureWipe(tmp.encoded)
+            kdfCounters.derivations.incrementAndGet()
+            kdfCounters.iterations.addAndGet(iterations.toLong())
+            kdfCounters.nanos.addAndGet(System.nanoTime() - start)
+            return derived
+        }
+
+        /** HKDF-Extract (RFC 5869) with HMAC-SHA256. */
+        private fun hkdfExtract(
+            salt: ByteArray,
+            inputKeyMaterial: ByteArray,
+        ): ByteArray =
+            Mac.getInstance("HmacSHA256").run {
+                init(SecretKeySpec(salt, "HmacSHA256"))
+                doFinal(inputKeyMaterial)
+            }
+
+        /** HKDF-Expand (RFC 5869) with HMAC-SHA256, for a single 32-byte block. */
+        private fun hkdfExpand(
+            prk: ByteArray,
+            info: ByteArray,
+        ): ByteArray =
+            Mac.getInstance("HmacSHA256").run {
+                init(SecretKeySpec(prk, "HmacSHA256"))
+                update(info)
+                update(1.toByte())
+                doFinal()
             }
+
+        /**
+         * PBKDF2 iterations for new version 3 data: what takes about
+         * [TARGET_KDF_MILLIS] on this device, clamped to
+         * [MIN_PASSWORD_ITERATIONS]..[MAX_PASSWORD_ITERATIONS]. Measured once per process.
+         */
+        fun passwordIterations(): Int {
+            calibratedIterations.takeIf { it > 0 }?.let { return it }
+            return calibrateIterations().also { calibratedIterations = it }
+        }
+
+        private fun calibrateIterations(): Int {
+            val factory = SecretKeyFactory.getInstance("PBKDF2WithHmacSHA256")
+            val salt = ByteArray(SALT_LENGTH)
+            val password = "calibration".toCharArray()
+            // Best of two runs, so JIT warm-up doesn't make the device look slower than it is
+            val nanos =
+                (1..2).minOf {
+                    val start = System.nanoTime()
+                    factory.generateSecret(PBEKeySpec(password, salt, CALIBRATION_ITERATIONS, PBKDF2_KEY_LENGTH))
+                    System.nanoTime() - start
+                }.coerceAtLeast(1)
+            val iterations = TARGET_KDF_MILLIS * 1_000_000L * CALIBRATION_ITERATIONS / nanos
+            // Round to thousands so the stored count doesn't leak timing noise
+            val rounded = (iterations / 1000 * 1000).coerceIn(MIN_PASSWORD_ITERATIONS.toLong(), MAX_PASSWORD_ITERATIONS.toLong())
+            Log.i(TAG, "Calibrated password KDF: $rounded iterations (~${TARGET_KDF_MILLIS}ms target)")
+            return rounded.toInt()
         }
 
         /**
@@ -313,16 +545,12 @@ class IdentityKeyEncryptor
             password: CharArray,
             salt: ByteArray,
         ): ByteArray {
-            val factory = SecretKeyFactory.getInstance("PBKDF2WithHmacSHA256")
             // Use half the iterations for verification hash (still secure, but faster for check)
-            val spec = PBEKeySpec(password, salt, PBKDF2_ITERATIONS / 2, AES_KEY_SIZE)
-            val hash = factory.generateSecret(spec).encoded
-            spec.clearPassword()
-            return hash
+            return pbkdf2(password, salt, PBKDF2_ITERATIONS / 2, AES_KEY_SIZE)
         }
 
         /**
-         * Verify a password against a stored verification hash.
+         * Verify a password against a stored version 2 verification hash.
          */
         fun verifyPassword(
             password: CharArray,
@@ -330,12 +558,33 @@ class IdentityKeyEncryptor
             expectedHash: ByteArray,
         ): Boolean {
             val computedHash = createPasswordVerificationHash(password, salt)
-            return computedHash.contentEquals(expectedHash)
+            return MessageDigest.isEqual(computedHash, expectedHash)
+        }
+
+        /**
+         * Verify a password against the verifier stored for version 3 data,
+         * using the salt and iteration count recorded in [encryptedData].
+         * Costs one key derivation.
+         */
+        fun verifyPasswordForKey(
+            encryptedData: ByteArray,
+            password: CharArray,
+            expectedVerifier: ByteArray,
+        ): Boolean {
+            if (encryptedData.size < V3_HEADER_LENGTH || encryptedData[0] != VERSION_DEVICE_AND_PASSWORD_V3) return false
+            val buffer = ByteBuffer.wrap(encryptedData, 1, 4 + SALT_LENGTH)
+            val iterations = buffer.getInt()
+            if (iterations !in minPasswordIterations..MAX_PASSWORD_ITERATIONS * 4) return false
+            val salt = ByteArray(SALT_LENGTH).also { buffer.get(it) }
+
+            val (key, verifier) = deriveKeyAndVerifier(password, salt, iterations)
+            secureWipe(key.encoded)
+            return MessageDigest.isEqual(verifier, expectedVerifier)
         }
 
         /**
          * Add password protection to device-only encrypted data.
-         * Upgrades from Version 1 to Version 2 encryption.
+         * Upgrades from Version 1 to Version 3 encryption.
          *
          * @param deviceEncryptedData Data currently encrypted with device key only
          * @param password New password to add
@@ -344,22 +593,23 @@ class IdentityKeyEncryptor
         fun addPasswordProtection(
             deviceEncryptedData: ByteArray,
             password: CharArray,
-        ): ByteArray {
-            // Decrypt with device key
-            val plainKeyData = decryptWithDeviceKey(deviceEncryptedData)
-
-            // Re-encrypt with password
-            val result = encryptWithPassword(plainKeyData, password)
-
-            // Securely wipe the plaintext
-            secureWipe(plainKeyData)
+        ): ByteArray = protectWithPassword(deviceEncryptedData, password).encryptedData
 
-            return result
+        /**
+         * Like [addPasswordProtection], also returning the salt and verifier to store.
+         * The device-encrypted data is wrapped as is, so the Keystore isn't used.
+         */
+        fun protectWithPassword(
+            deviceEncryptedData: ByteArray,
+            password: CharArray,
+        ): PasswordProtectedKey {
+            validateDeviceEncryptedData(deviceEncryptedData)
+            return sealWithPassword(deviceEncryptedData, password)
         }
 
         /**
          * Remove password protection, returning to device-only encryption.
-         * Downgrades from Version 2 to Version 1 encryption.
+         * Downgrades from Version 2 or 3 to Version 1 encryption.
          *
          * @param passwordEncryptedData Data currently encrypted with device + password
          * @param currentPassword Current password
@@ -369,16 +619,9 @@ class IdentityKeyEncryptor
             passwordEncryptedData: ByteArray,
             currentPassword: CharArray,
         ): ByteArray {
-            // Decrypt with password
-            val plainKeyData = decryptWithPassword(passwordEncryptedData, currentPassword)
-
-            // Re-encrypt with device key only
-            val result = encryptWithDeviceKey(plainKeyData)
-
-            // Securely wipe the plaintext
-            secureWipe(plainKeyData)
-
-            return result
+            val deviceEncrypted = openWithPassword(passwordEncryptedData, currentPassword)
+            validateDeviceEncryptedData(deviceEncrypted)
+            return deviceEncrypted
         }
 
         /**
@@ -393,11 +636,19 @@ class IdentityKeyEncryptor
             encryptedData: ByteArray,
             oldPassword: CharArray,
             newPassword: CharArray,
-        ): ByteArray {
-            val plainKeyData = decryptWithPassword(encryptedData, oldPassword)
-            val result = encryptWithPassword(plainKeyData, newPassword)
-            secureWipe(plainKeyData)
-            return result
+        ): ByteArray = changePasswordProtection(encryptedData, oldPassword, newPassword).encryptedData
+
+        /**
+         * Like [changePassword], also returning the salt and verifier to store.
+         * Costs one key derivation per password; the device layer is left as is.
+         */
+        fun changePasswordProtection(
+            encryptedData: ByteArray,
+            oldPassword: CharArray,
+            newPassword: CharArray,
+        ): PasswordProtectedKey {
+            val deviceEncrypted = openWithPassword(encryptedData, oldPassword)
+            return sealWithPassword(deviceEncrypted, newPassword)
         }
 
         /**
@@ -417,7 +668,7 @@ class IdentityKeyEncryptor
          * Check if the encrypted data requires a password.
          */
         fun requiresPassword(encryptedData: ByteArray): Boolean {
-            return getEncryptionVersion(encryptedData) == VERSION_DEVICE_AND_PASSWORD.toInt()
+            return isPasswordVersion(getEncryptionVersion(encryptedData))
         }
 
         /**
@@ -425,10 +676,15 @@ class IdentityKeyEncryptor
          * Used for password verification before decryption.
          */
         fun extractSalt(encryptedData: ByteArray): ByteArray? {
-            if (encryptedData.size < 1 + SALT_LENGTH) return null
-            if (encryptedData[0] != VERSION_DEVICE_AND_PASSWORD) return null
+            val offset =
+                when (encryptedData.firstOrNull()) {
+                    VERSION_DEVICE_AND_PASSWORD -> 1
+                    VERSION_DEVICE_AND_PASSWORD_V3 -> 1 + 4
+                    else -> return null
+                }
+            if (encryptedData.size < offset + SALT_LENGTH) return null
 
-            return encryptedData.copyOfRange(1, 1 + SALT_LENGTH)
+            return encryptedData.copyOfRange(offset, offset + SALT_LENGTH)
         }
 
         /**
@@ -117,7 +117,7 @@ class IdentityKeyProvider
         suspend fun requiresPassword(identityHash: String): Boolean =
             withContext(Dispatchers.IO) {
                 val identity = identityDao.getIdentity(identityHash) ?: return@withContext false
-                identity.keyEncryptionVersion == IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt()
+                IdentityKeyEncryptor.isPasswordVersion(identity.keyEncryptionVersion)
             }
 
         /**
@@ -130,13 +130,19 @@ class IdentityKeyProvider
             withContext(Dispatchers.IO) {
                 val identity = identityDao.getIdentity(identityHash) ?: return@withContext false
 
-                if (identity.keyEncryptionVersion != IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt()) {
+                if (!IdentityKeyEncryptor.isPasswordVersion(identity.keyEncryptionVersion)) {
                     return@withContext true // Not password protected
                 }
 
-                val salt = identity.passwordSalt ?: return@withContext false
                 val expectedHash = identity.passwordVerificationHash ?: return@withContext false
 
+                if (identity.keyEncryptionVersion == IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt()) {
+                    // Salt and KDF cost live in the key data itself
+                    val encryptedData = identity.encryptedKeyData ?: return@withContext false
+                    return@withContext encryptor.verifyPasswordForKey(encryptedData, password, expectedHash)
+                }
+
+                val salt = identity.passwordSalt ?: return@withContext false
                 encryptor.verifyPassword(password, salt, expectedHash)
             }
 
@@ -164,30 +170,18 @@ class IdentityKeyProvider
                                 IllegalStateException("Identity not yet encrypted with device key"),
                             )
 
-                    if (identity.keyEncryptionVersion == IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt()) {
+                    if (IdentityKeyEncryptor.isPasswordVersion(identity.keyEncryptionVersion)) {
                         return@withContext Result.failure(
                             IllegalStateException("Identity is already password protected"),
                         )
                     }
 
-                    // Get salt for password verification (reuse from encryption or generate new)
-                    val salt = ByteArray(32)
-                    secureRandom.nextBytes(salt)
-
-                    // Create password verification hash
-                    val verificationHash = encryptor.createPasswordVerificationHash(password, salt)
-
-                    // Add password protection layer
-                    val passwordEncrypted = encryptor.addPasswordProtection(currentEncryptedData, password)
+                    // Add password protection layer (one key derivation yields the
+                    // encryption key and the verification hash)
+                    val protection = encryptor.protectWithPassword(currentEncryptedData, password)
 
                     // Update database
-                    identityDao.updatePasswordProtection(
-                        identityHash = identityHash,
-                        encryptedKeyData = passwordEncrypted,
-                        version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
-                        passwordSalt = salt,
-                        passwordVerificationHash = verificationHash,
-                    )
+                    storePasswordProtection(identityHash, protection)
 
                     // Clear cache for this identity (will need password next time)
                     clearCachedKey(identityHash)
@@ -217,7 +211,7 @@ class IdentityKeyProvider
                         identityDao.getIdentity(identityHash)
                             ?: return@withContext Result.failure(KeyNotFoundException("Identity not found"))
 
-                    if (identity.keyEncryptionVersion != IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt()) {
+                    if (!IdentityKeyEncryptor.isPasswordVersion(identity.keyEncryptionVersion)) {
                         return@withContext Result.failure(
                             IllegalStateException("Identity is not password protected"),
                         )
@@ -261,7 +255,7 @@ class IdentityKeyProvider
                         identityDao.getIdentity(identityHash)
                             ?: return@withContext Result.failure(KeyNotFoundException("Identity not found"))
 
-                    if (identity.keyEncryptionVersion != IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt()) {
+                    if (!IdentityKeyEncryptor.isPasswordVersion(identity.keyEncryptionVersion)) {
                         return@withContext Result.failure(
                             IllegalStateException("Identity is not password protected"),
                         )
@@ -271,22 +265,11 @@ class IdentityKeyProvider
                         identity.encryptedKeyData
                             ?: return@withContext Result.failure(IllegalStateException("No encrypted data"))
 
-                    // Change password
-                    val newEncrypted = encryptor.changePassword(encryptedData, oldPassword, newPassword)
-
-                    // Generate new salt and verification hash
-                    val newSalt = ByteArray(32)
-                    secureRandom.nextBytes(newSalt)
-                    val newVerificationHash = encryptor.createPasswordVerificationHash(newPassword, newSalt)
+                    // Change password (new salt and verification hash come with the new data)
+                    val protection = encryptor.changePasswordProtection(encryptedData, oldPassword, newPassword)
 
                     // Update database
-                    identityDao.updatePasswordProtection(
-                        identityHash = identityHash,
-                        encryptedKeyData = newEncrypted,
-                        version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
-                        passwordSalt = newSalt,
-                        passwordVerificationHash = newVerificationHash,
-                    )
+                    storePasswordProtection(identityHash, protection)
 
                     // Clear cache
                     clearCachedKey(identityHash)
@@ -301,6 +284,19 @@ class IdentityKeyProvider
                 }
             }
 
+        private suspend fun storePasswordProtection(
+            identityHash: String,
+            protection: IdentityKeyEncryptor.PasswordProtectedKey,
+        ) {
+            identityDao.updatePasswordProtection(
+                identityHash = identityHash,
+                encryptedKeyData = protection.encryptedData,
+                version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt(),
+                passwordSalt = protection.salt,
+                passwordVerificationHash = protection.verificationHash,
+            )
+        }
+
         /**
          * Create a temporary decrypted key file for Python/Reticulum.
          *
@@ -426,7 +422,7 @@ class IdentityKeyProvider
          * Decrypt identity key based on encryption version.
          */
         @Suppress("DEPRECATION", "ThrowsCount") // Different encryption versions require different handling
-        private fun decryptIdentityKey(identity: LocalIdentityEntity, password: CharArray?): ByteArray? {
+        private suspend fun decryptIdentityKey(identity: LocalIdentityEntity, password: CharArray?): ByteArray? {
             val keyData =
                 when (identity.keyEncryptionVersion) {
                     0 -> {
@@ -440,7 +436,9 @@ class IdentityKeyProvider
                                 ?: throw CorruptedKeyException("No encrypted key data for device-encrypted identity")
                         encryptor.decryptWithDeviceKey(encryptedData)
                     }
-                    IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt() -> {
+                    IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
+                    IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt(),
+                    -> {
                         // Device + password encryption
                         if (password == null) {
                             throw WrongPasswordException("Password required for this identity")
@@ -448,7 +446,9 @@ class IdentityKeyProvider
                         val encryptedData =
                             identity.encryptedKeyData
                                 ?: throw CorruptedKeyException("No encrypted key data for password-protected identity")
-                        encryptor.decryptWithPassword(encryptedData, password)
+                        val unlocked = encryptor.unlockWithPassword(encryptedData, password)
+                        unlocked.upgraded?.let { upgradePasswordProtection(identity.identityHash, it) }
+                        unlocked.keyData
                     }
                     else -> {
                         throw CorruptedKeyException("Unknown encryption version: ${identity.keyEncryptionVersion}")
@@ -480,6 +480,23 @@ class IdentityKeyProvider
             return keyData
         }
 
+        /**
+         * Persist version 3 data re-encrypted while unlocking version 2 data.
+         * Failure is non-fatal: the version 2 data still unlocks and the
+         * upgrade is retried next time.
+         */
+        private suspend fun upgradePasswordProtection(
+            identityHash: String,
+            upgraded: IdentityKeyEncryptor.PasswordProtectedKey,
+        ) {
+            try {
+                storePasswordProtection(identityHash, upgraded)
+                Log.i(TAG, "Upgraded password protection for ${identityHash.take(8)}... to single-derivation format")
+            } catch (e: Exception) {
+                Log.w(TAG, "Failed to store upgraded password protection", e)
+            }
+        }
+
         /**
          * Read key data from the identity file.
          */
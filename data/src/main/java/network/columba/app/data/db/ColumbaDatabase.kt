@@ -6,6 +6,7 @@ import androidx.room.migration.Migration
 import androidx.sqlite.db.SupportSQLiteDatabase
 import org.json.JSONObject
 import network.columba.app.data.db.dao.AnnounceDao
+import network.columba.app.data.db.dao.BackgroundMigrationDao
 import network.columba.app.data.db.dao.BlockedPeerDao
 import network.columba.app.data.db.dao.ContactDao
 import network.columba.app.data.db.dao.ConversationDao
@@ -15,11 +16,14 @@ import network.columba.app.data.db.dao.InterfaceFirstSeenDao
 import network.columba.app.data.db.dao.LocalIdentityDao
 import network.columba.app.data.db.dao.MessageDao
 import network.columba.app.data.db.dao.OfflineMapRegionDao
+import network.columba.app.data.db.dao.PathTableDao
 import network.columba.app.data.db.dao.PeerIconDao
 import network.columba.app.data.db.dao.PeerIdentityDao
+import network.columba.app.data.db.dao.ReactionDao
 import network.columba.app.data.db.dao.ReceivedLocationDao
 import network.columba.app.data.db.dao.RmspServerDao
 import network.columba.app.data.db.entity.AnnounceEntity
+import network.columba.app.data.db.entity.BackgroundMigrationEntity
 import network.columba.app.data.db.entity.BlockedPeerEntity
 import network.columba.app.data.db.entity.ContactEntity
 import network.columba.app.data.db.entity.ConversationEntity
@@ -29,10 +33,14 @@ import network.columba.app.data.db.entity.InterfaceFirstSeenEntity
 import network.columba.app.data.db.entity.LocalIdentityEntity
 import network.columba.app.data.db.entity.MessageEntity
 import network.columba.app.data.db.entity.OfflineMapRegionEntity
+import network.columba.app.data.db.entity.PathTableEntryEntity
 import network.columba.app.data.db.entity.PeerIconEntity
 import network.columba.app.data.db.entity.PeerIdentityEntity
+import network.columba.app.data.db.entity.ReactionEntity
 import network.columba.app.data.db.entity.ReceivedLocationEntity
 import network.columba.app.data.db.entity.RmspServerEntity
+import network.columba.app.data.db.migration.BackgroundMigrationRunner
+import network.columba.app.data.db.migration.LegacyFieldReactionsMigration
 
 @Database(
     entities = [
@@ -50,61 +58,35 @@ import network.columba.app.data.db.entity.RmspServerEntity
         DraftEntity::class,
         BlockedPeerEntity::class,
         InterfaceFirstSeenEntity::class,
+        ReactionEntity::class,
+        BackgroundMigrationEntity::class,
+        PathTableEntryEntity::class,
     ],
-    version = 2,
+    version = 5,
     exportSchema = false,
 )
 abstract class ColumbaDatabase : RoomDatabase() {
     companion object {
         /**
-         * v1 → v2: split reactions out of `fieldsJson` overload into a
-         * dedicated `reactionsJson` column.
+         * v1 → v2: add the dedicated `reactionsJson` column that used to
+         * be overloaded onto `fieldsJson`.
          *
          * Prior shape (in `fieldsJson`):
          *   `{"16": {"reactions": {"👍": [sender_hex, ...]}, "reply_to": "..."}}`
          *
-         * New shape:
-         *   `reactionsJson = {"👍": [sender_hex, ...]}` (flat — no wrapper)
-         *   `fieldsJson`   = same as before but with the `reactions` key
-         *                    stripped out of `fields[16]` (and field 16
-         *                    removed entirely if it becomes empty).
-         *
-         * Backfill happens row-by-row in Kotlin (json1's `json_remove` would
-         * also work, but the parsed-rebuild path here keeps both the strip
-         * and the copy in a single deterministic place + survives
-         * malformed fieldsJson without aborting the migration).
-         *
-         * Migration is best-effort: malformed/unparseable `fieldsJson`
-         * rows keep their original blob and just get a null
-         * `reactionsJson`. UI parse path tolerates either being null.
+         * Schema only. Lifting the existing `fields[16].reactions` blobs
+         * out of `fieldsJson` used to happen here in one cursor pass over
+         * every matching row — rows that can carry multi-megabyte hex
+         * attachments, at open time, on the main startup path. It is now
+         * [LegacyFieldReactionsMigration], a chunked background migration
+         * run after open; until it completes, readers merge any reactions
+         * still embedded in `fieldsJson` (see
+         * [network.columba.app.data.repository.ConversationRepository]).
          */
         val MIGRATION_1_2: Migration =
             object : Migration(1, 2) {
                 override fun migrate(db: SupportSQLiteDatabase) {
                     db.execSQL("ALTER TABLE messages ADD COLUMN reactionsJson TEXT")
-
-                    db.query(
-                        "SELECT id, identityHash, fieldsJson FROM messages " +
-                            "WHERE fieldsJson IS NOT NULL AND fieldsJson LIKE '%reactions%'",
-                    ).use { cursor ->
-                        val idCol = cursor.getColumnIndexOrThrow("id")
-                        val identityCol = cursor.getColumnIndexOrThrow("identityHash")
-                        val fieldsCol = cursor.getColumnIndexOrThrow("fieldsJson")
-                        while (cursor.moveToNext()) {
-                            val id = cursor.getString(idCol)
-                            val identityHash = cursor.getString(identityCol)
-                            val fieldsJson = cursor.getString(fieldsCol) ?: continue
-
-                            val (newFieldsJson, reactionsJson) =
-                                splitReactionsOutOfFieldsJson(fieldsJson) ?: continue
-
-                            db.execSQL(
-                                "UPDATE messages SET fieldsJson = ?, reactionsJson = ? " +
-                                    "WHERE id = ? AND identityHash = ?",
-                                arrayOf<Any?>(newFieldsJson, reactionsJson, id, identityHash),
-                            )
-                        }
-                    }
                 }
             }
 
@@ -116,7 +98,7 @@ abstract class ColumbaDatabase : RoomDatabase() {
          *
          * Public so [MigrationImporter] (in `:app`) can reuse it when
          * importing pre-v2 backup bundles whose messages still carry
-         * the legacy overload.
+         * the legacy overload, and for [LegacyFieldReactionsMigration].
          */
         @Suppress("ReturnCount")
         fun splitReactionsOutOfFieldsJson(fieldsJson: String): Pair<String, String>? =
@@ -134,6 +116,121 @@ abstract class ColumbaDatabase : RoomDatabase() {
             } catch (_: Exception) {
                 null
             }
+
+        /**
+         * v2 → v3: normalize reactions into the `reactions` table, one row
+         * per (message, emoji, sender).
+         *
+         * Each `messages.reactionsJson` blob is split with
+         * [splitReactionsJson] and inserted with INSERT OR IGNORE, stamped
+         * with the target message's local receive time (the blob never
+         * recorded when each reaction arrived). The column itself is left
+         * in place — SQLite can't drop it cheaply — but cleared and no
+         * longer written.
+         *
+         * Best-effort like [MIGRATION_1_2]: malformed blobs contribute no
+         * rows rather than aborting the migration.
+         */
+        val MIGRATION_2_3: Migration =
+            object : Migration(2, 3) {
+                override fun migrate(db: SupportSQLiteDatabase) {
+                    db.execSQL(
+                        "CREATE TABLE IF NOT EXISTS `reactions` (" +
+                            "`messageId` TEXT NOT NULL, `identityHash` TEXT NOT NULL, " +
+                            "`emoji` TEXT NOT NULL, `sender` TEXT NOT NULL, `timestamp` INTEGER NOT NULL, " +
+                            "PRIMARY KEY(`messageId`, `identityHash`, `emoji`, `sender`), " +
+                            "FOREIGN KEY(`identityHash`) REFERENCES `local_identities`(`identityHash`) " +
+                            "ON UPDATE NO ACTION ON DELETE CASCADE )",
+                    )
+                    db.execSQL(
+                        "CREATE INDEX IF NOT EXISTS `index_reactions_identityHash` ON `reactions` (`identityHash`)",
+                    )
+
+                    db.query(
+                        "SELECT id, identityHash, COALESCE(receivedAt, timestamp) AS ts, reactionsJson " +
+                            "FROM messages WHERE reactionsJson IS NOT NULL",
+                    ).use { cursor ->
+                        val idCol = cursor.getColumnIndexOrThrow("id")
+                        val identityCol = cursor.getColumnIndexOrThrow("identityHash")
+                        val tsCol = cursor.getColumnIndexOrThrow("ts")
+                        val reactionsCol = cursor.getColumnIndexOrThrow("reactionsJson")
+                        while (cursor.moveToNext()) {
+                            val id = cursor.getString(idCol)
+                            val identityHash = cursor.getString(identityCol)
+                            val ts = cursor.getLong(tsCol)
+                            val reactionsJson = cursor.getString(reactionsCol) ?: continue
+
+                            splitReactionsJson(reactionsJson).forEach { (emoji, sender) ->
+                                db.execSQL(
+                                    "INSERT OR IGNORE INTO reactions " +
+                                        "(messageId, identityHash, emoji, sender, timestamp) VALUES (?, ?, ?, ?, ?)",
+                                    arrayOf<Any?>(id, identityHash, emoji, sender, ts),
+                                )
+                            }
+                        }
+                    }
+
+                    db.execSQL("UPDATE messages SET reactionsJson = NULL WHERE reactionsJson IS NOT NULL")
+                }
+            }
+
+        /**
+         * v3 → v4: add `background_migrations`, the progress markers for
+         * post-open data migrations run by [BackgroundMigrationRunner].
+         */
+        val MIGRATION_3_4: Migration =
+            object : Migration(3, 4) {
+                override fun migrate(db: SupportSQLiteDatabase) {
+                    db.execSQL(
+                        "CREATE TABLE IF NOT EXISTS `background_migrations` (" +
+                            "`id` TEXT NOT NULL, `lastRowId` INTEGER NOT NULL, " +
+                            "`completedAt` INTEGER, `updatedAt` INTEGER NOT NULL, PRIMARY KEY(`id`))",
+                    )
+                }
+            }
+
+        /**
+         * v4 → v5: add `path_table`, the mirror of the backend's RNS path
+         * table that reachability queries join against. Starts empty; the
+         * first `observePathTable()` reset fills it.
+         */
+        val MIGRATION_4_5: Migration =
+            object : Migration(4, 5) {
+                override fun migrate(db: SupportSQLiteDatabase) {
+                    db.execSQL(
+                        "CREATE TABLE IF NOT EXISTS `path_table` (" +
+                            "`destinationHash` TEXT NOT NULL, `hops` INTEGER NOT NULL, " +
+                            "`updatedAt` INTEGER NOT NULL, PRIMARY KEY(`destinationHash`))",
+                    )
+                }
+            }
+
+        /**
+         * Flatten a `{"👍": [sender_hex, ...]}` reactions blob into
+         * `(emoji, sender)` pairs, in blob order. Non-array values, blank
+         * or non-string senders and unparseable input are skipped.
+         *
+         * Public so [MigrationImporter] (in `:app`) can turn the blob
+         * carried by backup bundles into `reactions` rows.
+         */
+        fun splitReactionsJson(reactionsJson: String): List<Pair<String, String>> =
+            try {
+                val root = JSONObject(reactionsJson)
+                val pairs = mutableListOf<Pair<String, String>>()
+                val emojis = root.keys()
+                while (emojis.hasNext()) {
+                    val emoji = emojis.next()
+                    if (emoji.isEmpty()) continue
+                    val senders = root.optJSONArray(emoji) ?: continue
+                    for (i in 0 until senders.length()) {
+                        val sender = senders.opt(i) as? String ?: continue
+                        if (sender.isNotBlank()) pairs.add(emoji to sender)
+                    }
+                }
+                pairs
+            } catch (_: Exception) {
+                emptyList()
+            }
     }
 
     abstract fun conversationDao(): ConversationDao
@@ -163,4 +260,10 @@ abstract class ColumbaDatabase : RoomDatabase() {
     abstract fun blockedPeerDao(): BlockedPeerDao
 
     abstract fun interfaceFirstSeenDao(): InterfaceFirstSeenDao
+
+    abstract fun reactionDao(): ReactionDao
+
+    abstract fun backgroundMigrationDao(): BackgroundMigrationDao
+
+    abstract fun pathTableDao(): PathTableDao
 }
@@ -249,20 +249,22 @@ interface AnnounceDao {
     fun getTopPropagationNodes(limit: Int = 10): Flow<List<AnnounceEntity>>
 
     /**
-     * Count announces that are reachable via RNS path table.
-     * Filters to only count PEER and NODE types (excludes PROPAGATION_NODE).
+     * Count announces we currently have a path to, per the `path_table`
+     * mirror. Filters to only count PEER and NODE types (excludes
+     * PROPAGATION_NODE). A primary-key join, so it stays cheap on a
+     * transport node with tens of thousands of paths, and re-emits when
+     * either table changes.
      *
-     * @param pathTableHashes List of destination hashes from RNS path table
-     * @return Count of reachable peer/node announces
+     * @return Flow of the reachable peer/node announce count
      */
     @Query(
         """
         SELECT COUNT(*) FROM announces
-        WHERE destinationHash IN (:pathTableHashes)
-        AND nodeType IN ('PEER', 'NODE')
+        INNER JOIN path_table ON path_table.destinationHash = announces.destinationHash
+        WHERE announces.nodeType IN ('PEER', 'NODE')
     """,
     )
-    suspend fun countReachableAnnounces(pathTableHashes: List<String>): Int
+    fun observeReachableAnnounceCount(): Flow<Int>
 
     // ==================== ENRICHED QUERIES (with peer_icons JOIN) ====================
     // These queries include icon data from peer_icons table for UI display.
@@ -0,0 +1,23 @@
+package network.columba.app.data.db.dao
+
+import androidx.room.Dao
+import androidx.room.Insert
+import androidx.room.OnConflictStrategy
+import androidx.room.Query
+import network.columba.app.data.db.entity.BackgroundMigrationEntity
+
+@Dao
+interface BackgroundMigrationDao {
+    /**
+     * Blocking on purpose: called from inside `runInTransaction` together
+     * with the chunk it records.
+     */
+    @Query("SELECT * FROM background_migrations WHERE id = :id")
+    fun getProgress(id: String): BackgroundMigrationEntity?
+
+    @Insert(onConflict = OnConflictStrategy.REPLACE)
+    fun upsertProgress(progress: BackgroundMigrationEntity)
+
+    @Query("SELECT EXISTS(SELECT 1 FROM background_migrations WHERE id = :id AND completedAt IS NOT NULL)")
+    suspend fun isCompleted(id: String): Boolean
+}
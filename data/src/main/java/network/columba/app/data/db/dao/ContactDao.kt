@@ -292,6 +292,14 @@ interface ContactDao {
     @Query("SELECT * FROM contacts WHERE identityHash = :identityHash")
     suspend fun getAllContactsSync(identityHash: String): List<ContactEntity>
 
+    /**
+     * Destination hashes of all contacts for an identity. Loads only the key
+     * column so the service-side sender-policy snapshot can be rebuilt
+     * without materializing full contact rows.
+     */
+    @Query("SELECT destinationHash FROM contacts WHERE identityHash = :identityHash")
+    suspend fun getContactDestinationHashes(identityHash: String): List<String>
+
     @Query(
         """
         SELECT * FROM contacts
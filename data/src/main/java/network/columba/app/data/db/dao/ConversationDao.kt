@@ -27,6 +27,11 @@ interface ConversationDao {
      *
      * Icons come from peer_icons table (populated from LXMF messages), not from announces
      * (which are a Reticulum concept and don't contain icon data).
+     *
+     * Each row also carries whether the peer is a saved contact, whether a public key is
+     * known (conversation, peer_identities or announce), and a preview of any draft, so the
+     * chat list needs this one observer rather than one contact query per visible row.
+     * Draft previews are cut to 200 characters; the full draft lives in the drafts table.
      */
     @Query(
         """
@@ -40,11 +45,16 @@ interface ConversationDao {
             c.unreadCount,
             pi.iconName as iconName,
             pi.foregroundColor as iconForegroundColor,
-            pi.backgroundColor as iconBackgroundColor
+            pi.backgroundColor as iconBackgroundColor,
+            ct.destinationHash IS NOT NULL as isContact,
+            (c.peerPublicKey IS NOT NULL OR pid.publicKey IS NOT NULL OR a.publicKey IS NOT NULL) as hasPublicKey,
+            substr(d.content, 1, 200) as draftText
         FROM conversations c
         LEFT JOIN announces a ON c.peerHash = a.destinationHash
         LEFT JOIN contacts ct ON c.peerHash = ct.destinationHash AND c.identityHash = ct.identityHash
         LEFT JOIN peer_icons pi ON c.peerHash = pi.destinationHash
+        LEFT JOIN peer_identities pid ON c.peerHash = pid.peerHash
+        LEFT JOIN drafts d ON c.peerHash = d.conversationHash AND c.identityHash = d.identityHash
         WHERE c.identityHash = :identityHash
             AND NOT EXISTS (
                 SELECT 1 FROM blocked_peers bp
@@ -71,11 +81,16 @@ interface ConversationDao {
             c.unreadCount,
             pi.iconName as iconName,
             pi.foregroundColor as iconForegroundColor,
-            pi.backgroundColor as iconBackgroundColor
+            pi.backgroundColor as iconBackgroundColor,
+            ct.destinationHash IS NOT NULL as isContact,
+            (c.peerPublicKey IS NOT NULL OR pid.publicKey IS NOT NULL OR a.publicKey IS NOT NULL) as hasPublicKey,
+            substr(d.content, 1, 200) as draftText
         FROM conversations c
         LEFT JOIN announces a ON c.peerHash = a.destinationHash
         LEFT JOIN contacts ct ON c.peerHash = ct.destinationHash AND c.identityHash = ct.identityHash
         LEFT JOIN peer_icons pi ON c.peerHash = pi.destinationHash
+        LEFT JOIN peer_identities pid ON c.peerHash = pid.peerHash
+        LEFT JOIN drafts d ON c.peerHash = d.conversationHash AND c.identityHash = d.identityHash
         WHERE c.identityHash = :identityHash
             AND NOT EXISTS (
                 SELECT 1 FROM blocked_peers bp
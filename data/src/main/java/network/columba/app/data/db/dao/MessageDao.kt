@@ -3,6 +3,7 @@ package network.columba.app.data.db.dao
 import androidx.paging.PagingSource
 import androidx.room.Dao
 import androidx.room.Delete
+import androidx.room.Embedded
 import androidx.room.Insert
 import androidx.room.OnConflictStrategy
 import androidx.room.Query
@@ -10,11 +11,26 @@ import androidx.room.Update
 import network.columba.app.data.db.entity.MessageEntity
 import kotlinx.coroutines.flow.Flow
 
+/**
+ * Per-message reaction aggregate appended to the message-list queries.
+ * Both subqueries are point lookups on the `reactions` primary key
+ * (messageId, identityHash, …), so messages without reactions cost one
+ * index probe each. Entries are `emoji US sender US timestamp`, separated
+ * by RS — control characters that can't appear in emoji or hex hashes.
+ */
+private const val REACTION_AGGREGATE_COLUMNS =
+    "(SELECT COUNT(*) FROM reactions " +
+        "WHERE reactions.messageId = messages.id AND reactions.identityHash = messages.identityHash) " +
+        "AS reactionCount, " +
+        "(SELECT group_concat(emoji || char(31) || sender || char(31) || timestamp, char(30)) FROM reactions " +
+        "WHERE reactions.messageId = messages.id AND reactions.identityHash = messages.identityHash) " +
+        "AS reactionEntries"
+
 @Dao
 interface MessageDao {
     @Query(
         """
-        SELECT * FROM messages
+        SELECT messages.*, $REACTION_AGGREGATE_COLUMNS FROM messages
         WHERE conversationHash = :peerHash AND identityHash = :identityHash
         ORDER BY COALESCE(receivedAt, timestamp) ASC
         """,
@@ -22,7 +38,7 @@ interface MessageDao {
     fun getMessagesForConversation(
         peerHash: String,
         identityHash: String,
-    ): Flow<List<MessageEntity>>
+    ): Flow<List<MessageWithReactions>>
 
     @Query(
         """
@@ -80,6 +96,12 @@ interface MessageDao {
         identityHash: String,
     ): Boolean
 
+    @Query("SELECT EXISTS(SELECT 1 FROM messages WHERE id = :messageId AND identityHash = :identityHash AND isRead = 0)")
+    suspend fun isMessageUnread(
+        messageId: String,
+        identityHash: String,
+    ): Boolean
+
     @Query("SELECT * FROM messages WHERE id = :messageId AND identityHash = :identityHash LIMIT 1")
     suspend fun getMessageById(
         messageId: String,
@@ -139,19 +161,6 @@ interface MessageDao {
         fieldsJson: String?,
     )
 
-    @Query(
-        """
-        UPDATE messages
-        SET reactionsJson = :reactionsJson
-        WHERE id = :messageId AND identityHash = :identityHash
-        """,
-    )
-    suspend fun updateMessageReactionsJson(
-        messageId: String,
-        identityHash: String,
-        reactionsJson: String?,
-    )
-
     // Paging3 method for infinite scroll
 
     /**
@@ -162,7 +171,7 @@ interface MessageDao {
      */
     @Query(
         """
-        SELECT * FROM messages
+        SELECT messages.*, $REACTION_AGGREGATE_COLUMNS FROM messages
         WHERE conversationHash = :peerHash AND identityHash = :identityHash
         ORDER BY COALESCE(receivedAt, timestamp) DESC
         """,
@@ -170,14 +179,14 @@ interface MessageDao {
     fun getMessagesForConversationPaged(
         peerHash: String,
         identityHash: String,
-    ): PagingSource<Int, MessageEntity>
+    ): PagingSource<Int, MessageWithReactions>
 
     /**
      * Get messages sorted by sender's timestamp (for "sort by sent time" preference).
      */
     @Query(
         """
-        SELECT * FROM messages
+        SELECT messages.*, $REACTION_AGGREGATE_COLUMNS FROM messages
         WHERE conversationHash = :peerHash AND identityHash = :identityHash
         ORDER BY timestamp DESC
         """,
@@ -185,7 +194,7 @@ interface MessageDao {
     fun getMessagesForConversationPagedBySentTime(
         peerHash: String,
         identityHash: String,
-    ): PagingSource<Int, MessageEntity>
+    ): PagingSource<Int, MessageWithReactions>
 
     /**
      * Get IDs of received (not from me) messages for an identity since a cutoff time.
@@ -283,3 +292,35 @@ data class ReplyPreviewEntity(
     val fieldsJson: String?,
     val conversationHash: String,
 )
+
+/**
+ * A message row plus its aggregated reactions, as returned by the
+ * message-list queries.
+ */
+data class MessageWithReactions(
+    @Embedded val message: MessageEntity,
+    val reactionCount: Int,
+    val reactionEntries: String?,
+) {
+    /**
+     * Decode [reactionEntries] into `emoji → sender hashes`. Emojis are
+     * ordered by their first reaction and senders by reaction time, which
+     * matches the order the old per-message blob accumulated them in.
+     * Skips decoding entirely for the common no-reactions case.
+     */
+    fun reactionsByEmoji(): Map<String, List<String>> {
+        if (reactionCount == 0 || reactionEntries.isNullOrEmpty()) return emptyMap()
+        return reactionEntries
+            .split(ENTRY_SEPARATOR)
+            .mapNotNull { entry ->
+                val parts = entry.split(FIELD_SEPARATOR)
+                if (parts.size == 3) Triple(parts[0], parts[1], parts[2].toLongOrNull() ?: 0L) else null
+            }.sortedBy { it.third }
+            .groupBy({ it.first }, { it.second })
+    }
+
+    private companion object {
+        const val ENTRY_SEPARATOR = '\u001E'
+        const val FIELD_SEPARATOR = '\u001F'
+    }
+}
@@ -0,0 +1,46 @@
+package network.columba.app.data.db.dao
+
+import androidx.room.Dao
+import androidx.room.Insert
+import androidx.room.OnConflictStrategy
+import androidx.room.Query
+import androidx.room.Transaction
+import network.columba.app.data.db.entity.PathTableEntryEntity
+
+@Dao
+interface PathTableDao {
+    companion object {
+        /** Stay under SQLite's default 999 bound-variable limit. */
+        const val MAX_BIND_ARGS = 900
+    }
+
+    @Insert(onConflict = OnConflictStrategy.REPLACE)
+    suspend fun upsertAll(entries: List<PathTableEntryEntity>)
+
+    @Query("DELETE FROM path_table WHERE destinationHash IN (:destinationHashes)")
+    suspend fun deleteByHashes(destinationHashes: List<String>)
+
+    @Query("DELETE FROM path_table")
+    suspend fun clear()
+
+    @Query("SELECT COUNT(*) FROM path_table")
+    suspend fun count(): Int
+
+    @Query("SELECT hops FROM path_table WHERE destinationHash = :destinationHash")
+    suspend fun getHops(destinationHash: String): Int?
+
+    /**
+     * Apply one path-table delta atomically, so readers never see a reset
+     * half-applied. [expired] is deleted in bounded chunks.
+     */
+    @Transaction
+    suspend fun applyDelta(
+        reset: Boolean,
+        upserts: List<PathTableEntryEntity>,
+        expired: List<String>,
+    ) {
+        if (reset) clear()
+        if (upserts.isNotEmpty()) upsertAll(upserts)
+        expired.chunked(MAX_BIND_ARGS).forEach { deleteByHashes(it) }
+    }
+}
@@ -0,0 +1,69 @@
+package network.columba.app.data.db.dao
+
+import androidx.room.Dao
+import androidx.room.Insert
+import androidx.room.OnConflictStrategy
+import androidx.room.Query
+import network.columba.app.data.db.entity.ReactionEntity
+
+@Dao
+interface ReactionDao {
+    /**
+     * Record one reaction event on a stored message.
+     *
+     * Idempotent: a repeated (message, emoji, sender) is ignored, as is a
+     * reaction whose target message isn't in the database. Only the
+     * `reactions` table is written, so observers of `messages` alone
+     * (conversation list, unread counts) are not invalidated.
+     *
+     * @return the new row id, or -1 if nothing was inserted
+     */
+    @Query(
+        """
+        INSERT OR IGNORE INTO reactions (messageId, identityHash, emoji, sender, timestamp)
+        SELECT :messageId, :identityHash, :emoji, :sender, :timestamp
+        WHERE EXISTS(SELECT 1 FROM messages WHERE id = :messageId AND identityHash = :identityHash)
+        """,
+    )
+    suspend fun insertReaction(
+        messageId: String,
+        identityHash: String,
+        emoji: String,
+        sender: String,
+        timestamp: Long,
+    ): Long
+
+    /**
+     * Bulk insert reactions (for import), ignoring ones already recorded.
+     */
+    @Insert(onConflict = OnConflictStrategy.IGNORE)
+    suspend fun insertReactions(reactions: List<ReactionEntity>)
+
+    /**
+     * Get all reactions for an identity (sync, for export).
+     */
+    @Query("SELECT * FROM reactions WHERE identityHash = :identityHash ORDER BY timestamp ASC")
+    suspend fun getAllReactionsForIdentity(identityHash: String): List<ReactionEntity>
+
+    @Query("DELETE FROM reactions WHERE messageId = :messageId AND identityHash = :identityHash")
+    suspend fun deleteReactionsForMessage(
+        messageId: String,
+        identityHash: String,
+    )
+
+    /**
+     * Delete reactions whose target message no longer exists (e.g. after a
+     * conversation was deleted and its messages cascade-deleted).
+     */
+    @Query(
+        """
+        DELETE FROM reactions
+        WHERE identityHash = :identityHash
+        AND NOT EXISTS(
+            SELECT 1 FROM messages
+            WHERE messages.id = reactions.messageId AND messages.identityHash = reactions.identityHash
+        )
+        """,
+    )
+    suspend fun deleteOrphanedReactions(identityHash: String): Int
+}
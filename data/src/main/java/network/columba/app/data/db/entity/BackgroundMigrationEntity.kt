@@ -0,0 +1,21 @@
+package network.columba.app.data.db.entity
+
+import androidx.room.Entity
+import androidx.room.PrimaryKey
+
+/**
+ * Progress marker for one post-open background data migration
+ * (see [network.columba.app.data.db.migration.BackgroundMigrationRunner]).
+ *
+ * Written in the same transaction as each chunk it covers, so after a
+ * crash or process kill the marker always matches the data and the
+ * migration resumes at the first unprocessed row.
+ */
+@Entity(tableName = "background_migrations")
+data class BackgroundMigrationEntity(
+    @PrimaryKey
+    val id: String, // BackgroundMigration.id
+    val lastRowId: Long, // Highest rowid already processed (keyset cursor)
+    val completedAt: Long? = null, // Set once a chunk comes back empty
+    val updatedAt: Long,
+)
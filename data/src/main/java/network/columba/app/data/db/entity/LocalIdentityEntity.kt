@@ -14,7 +14,7 @@ import androidx.room.PrimaryKey
  * @property filePath Path to the identity file in app storage
  * @property keyData Raw 64-byte private key data (DEPRECATED: use encryptedKeyData)
  * @property encryptedKeyData AES-256-GCM encrypted key data using Android Keystore
- * @property keyEncryptionVersion Encryption version: 0=plain, 1=device-only, 2=device+password
+ * @property keyEncryptionVersion Encryption version: 0=plain, 1=device-only, 2=device+password (legacy), 3=device+password
  * @property passwordSalt Salt used for password-based key derivation (if password protected)
  * @property passwordVerificationHash Hash for verifying password correctness (if password protected)
  * @property createdTimestamp Unix timestamp when the identity was created
@@ -37,7 +37,7 @@ data class LocalIdentityEntity(
     @Deprecated("Use encryptedKeyData instead - this field will be cleared after migration")
     val keyData: ByteArray? = null,
     val encryptedKeyData: ByteArray? = null,
-    val keyEncryptionVersion: Int = 0, // 0=plain, 1=device, 2=device+password
+    val keyEncryptionVersion: Int = 0, // 0=plain, 1=device, 2/3=device+password
     val passwordSalt: ByteArray? = null,
     val passwordVerificationHash: ByteArray? = null,
     val createdTimestamp: Long,
@@ -43,13 +43,11 @@ data class MessageEntity(
     // Fields are stored as JSON: {"6": "hex_image_data", "7": "hex_audio_data"}
     // Key is LXMF field type: 5=FILE_ATTACHMENTS, 6=IMAGE, 7=AUDIO, 15=RENDERER
     val fieldsJson: String? = null,
-    // Per-target-message reactions aggregation (DB-local, never on the wire).
-    // Shape: {"👍": ["sender_hex_1", "sender_hex_2"], "❤️": ["sender_hex_3"]}
-    // The canonical wire format is fields[0x40] = {0x00: hashBytes, 0x01:
-    // contentBytes} per-event (legacy fields[0x10] still parsed inbound); the
-    // receiver routes those events into this column on the *target* message.
-    // Migrated v1→v2 from the prior fields[16].reactions overload — see
-    // MIGRATION_1_2 in ColumbaDatabase.
+    // Legacy (DB v2) per-target-message reactions blob,
+    // {"👍": ["sender_hex_1", ...]}. No longer written: since v3 each
+    // reaction is a row in the `reactions` table (ReactionEntity), and
+    // MIGRATION_2_3 in ColumbaDatabase split existing blobs into rows and
+    // cleared this column. Kept so the v2 schema doesn't need a table rebuild.
     val reactionsJson: String? = null,
     // Delivery method used when sending: "opportunistic", "direct", or "propagated"
     val deliveryMethod: String? = null,
@@ -0,0 +1,21 @@
+package network.columba.app.data.db.entity
+
+import androidx.room.Entity
+import androidx.room.PrimaryKey
+
+/**
+ * Mirror of one entry in the RNS path table: a destination we currently
+ * have a path to, and how many hops away it is.
+ *
+ * Kept in sync by the app-side path-table mirror from the backend's
+ * `observePathTable()` deltas, so "is this announce reachable" is a join
+ * on the primary key rather than a per-query copy of the whole table.
+ * Contents are runtime state: every new subscription starts with a reset
+ * that clears the table.
+ */
+@Entity(tableName = "path_table")
+data class PathTableEntryEntity(
+    @PrimaryKey val destinationHash: String,
+    val hops: Int,
+    val updatedAt: Long,
+)
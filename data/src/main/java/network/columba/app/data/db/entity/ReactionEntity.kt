@@ -0,0 +1,43 @@
+package network.columba.app.data.db.entity
+
+import androidx.room.Entity
+import androidx.room.ForeignKey
+import androidx.room.Index
+
+/**
+ * One emoji reaction from one sender on one message (DB v3+).
+ *
+ * Replaces the per-message `messages.reactionsJson` blob: every reaction
+ * event is its own row, so recording one is a single idempotent insert
+ * instead of a read-modify-write of the target message row. The composite
+ * primary key doubles as the uniqueness constraint — the same sender
+ * reacting with the same emoji twice (LXMF replay, propagation re-sync)
+ * collapses to one row.
+ *
+ * Deliberately no foreign key to `messages`: message inserts use REPLACE,
+ * which deletes and re-inserts the row and would cascade-delete its
+ * reactions. Rows for deleted messages are cleaned up by
+ * [network.columba.app.data.db.dao.ReactionDao.deleteOrphanedReactions].
+ */
+@Entity(
+    tableName = "reactions",
+    primaryKeys = ["messageId", "identityHash", "emoji", "sender"],
+    foreignKeys = [
+        ForeignKey(
+            entity = LocalIdentityEntity::class,
+            parentColumns = ["identityHash"],
+            childColumns = ["identityHash"],
+            onDelete = ForeignKey.CASCADE, // Delete reactions when identity deleted
+        ),
+    ],
+    indices = [
+        Index("identityHash"),
+    ],
+)
+data class ReactionEntity(
+    val messageId: String, // Target message (the one being reacted to)
+    val identityHash: String, // Which local identity owns the target message
+    val emoji: String,
+    val sender: String, // Reacting peer's hex hash (ours for reactions we sent)
+    val timestamp: Long, // Local time the reaction was recorded, for display order
+)
@@ -0,0 +1,38 @@
+package network.columba.app.data.db.migration
+
+import androidx.sqlite.db.SupportSQLiteDatabase
+
+/**
+ * A data migration that runs after the database is open, in small
+ * keyset-paged chunks, instead of inside Room's open-time [androidx.room.migration.Migration].
+ *
+ * Use this for backfills over large tables (messages can carry
+ * multi-megabyte `fieldsJson`): Room migrations block the first query
+ * until they finish and read through a single cursor, which risks ANRs
+ * and `CursorWindow` overflows. Schema changes still belong in a regular
+ * Room migration; only the data rewrite moves here.
+ *
+ * While a background migration is pending, readers must accept both the
+ * old and the new format for the rows it touches.
+ */
+interface BackgroundMigration {
+    /** Stable key for the progress marker. Never reuse or rename. */
+    val id: String
+
+    /**
+     * Migrate up to [limit] rows with `rowid > afterRowId`, in rowid order.
+     *
+     * Called inside a transaction that also records the returned rowid, so
+     * the chunk and its progress marker commit or roll back together.
+     * Must only read what it needs from each row — large columns should be
+     * fetched one row at a time, and only for rows that need rewriting.
+     *
+     * @return the highest rowid examined (migrated or not), or null when
+     *   there are no rows after [afterRowId] and the migration is complete
+     */
+    fun migrateChunk(
+        db: SupportSQLiteDatabase,
+        afterRowId: Long,
+        limit: Int,
+    ): Long?
+}
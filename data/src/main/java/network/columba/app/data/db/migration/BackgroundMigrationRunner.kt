@@ -0,0 +1,105 @@
+package network.columba.app.data.db.migration
+
+import android.util.Log
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.ensureActive
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import kotlinx.coroutines.yield
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.BackgroundMigrationEntity
+
+/**
+ * Runs registered [BackgroundMigration]s to completion, one chunk per
+ * transaction, resuming each from its persisted marker.
+ *
+ * Interruption is safe at any point: cancellation takes effect between
+ * chunks, and a crash or process kill mid-chunk rolls back that chunk
+ * together with its marker. While the UI is in the foreground chunks are
+ * smaller and spaced out so the migration never competes with scrolling
+ * or message sends for the write lock.
+ *
+ * Call [runPending] from a background dispatcher; it blocks on SQLite.
+ */
+class BackgroundMigrationRunner(
+    private val database: ColumbaDatabase,
+    private val migrations: List<BackgroundMigration>,
+    private val idleChunkSize: Int = DEFAULT_IDLE_CHUNK_SIZE,
+    private val activeChunkSize: Int = DEFAULT_ACTIVE_CHUNK_SIZE,
+    private val activePauseMs: Long = DEFAULT_ACTIVE_PAUSE_MS,
+    private val clock: () -> Long = System::currentTimeMillis,
+) {
+    companion object {
+        private const val TAG = "BackgroundMigrations"
+        const val DEFAULT_IDLE_CHUNK_SIZE = 500
+        const val DEFAULT_ACTIVE_CHUNK_SIZE = 50
+        const val DEFAULT_ACTIVE_PAUSE_MS = 250L
+    }
+
+    private val mutex = Mutex()
+
+    /**
+     * Run every pending migration in registration order, stopping at the
+     * first failure since later migrations may build on earlier ones.
+     * Concurrent calls wait for the running one and then find nothing
+     * left to do.
+     *
+     * @param isUiActive polled before every chunk; true throttles the run
+     * @return true if all migrations are complete
+     */
+    suspend fun runPending(isUiActive: () -> Boolean = { false }): Boolean =
+        mutex.withLock {
+            migrations.all { migration ->
+                try {
+                    run(migration, isUiActive)
+                } catch (e: CancellationException) {
+                    throw e
+                } catch (e: Exception) {
+                    // Marker still points at the last committed chunk; retried next start
+                    Log.e(TAG, "Background migration ${migration.id} failed, will resume later", e)
+                    false
+                }
+            }
+        }
+
+    suspend fun isCompleted(id: String): Boolean = database.backgroundMigrationDao().isCompleted(id)
+
+    private suspend fun run(
+        migration: BackgroundMigration,
+        isUiActive: () -> Boolean,
+    ): Boolean {
+        val dao = database.backgroundMigrationDao()
+        var progress = dao.getProgress(migration.id)
+        if (progress?.completedAt != null) return true
+
+        Log.i(TAG, "Running ${migration.id} from rowid ${progress?.lastRowId ?: 0}")
+        var chunks = 0
+        while (true) {
+            currentCoroutineContext().ensureActive()
+            val throttled = isUiActive()
+            val limit = if (throttled) activeChunkSize else idleChunkSize
+            val afterRowId = progress?.lastRowId ?: 0L
+
+            progress =
+                database.runInTransaction<BackgroundMigrationEntity> {
+                    val lastRowId = migration.migrateChunk(database.openHelper.writableDatabase, afterRowId, limit)
+                    val now = clock()
+                    BackgroundMigrationEntity(
+                        id = migration.id,
+                        lastRowId = lastRowId ?: afterRowId,
+                        completedAt = if (lastRowId == null) now else null,
+                        updatedAt = now,
+                    ).also { dao.upsertProgress(it) }
+                }
+            chunks++
+
+            if (progress.completedAt != null) {
+                Log.i(TAG, "Completed ${migration.id} after $chunks chunks")
+                return true
+            }
+            if (throttled) delay(activePauseMs) else yield()
+        }
+    }
+}
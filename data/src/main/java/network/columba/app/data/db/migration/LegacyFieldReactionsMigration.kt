@@ -0,0 +1,85 @@
+package network.columba.app.data.db.migration
+
+import android.util.Log
+import androidx.sqlite.db.SupportSQLiteDatabase
+import network.columba.app.data.db.ColumbaDatabase
+
+/**
+ * Lifts pre-v2 reactions out of `fieldsJson` (`fields[16].reactions`)
+ * into `reactions` rows, stripping them from `fieldsJson`. Replaces the
+ * data half of the old open-time `MIGRATION_1_2`.
+ *
+ * Each chunk reads only rowid, keys and two cheap SQL-side probes
+ * (`length` and `instr`) per row; `fieldsJson` itself is fetched one row
+ * at a time and only for rows that contain a reactions key. Rows too large
+ * for a `CursorWindow` are skipped — the UI can't load them either.
+ */
+class LegacyFieldReactionsMigration : BackgroundMigration {
+    companion object {
+        const val ID = "legacy_field16_reactions"
+        private const val TAG = "LegacyFieldReactions"
+
+        // Below the default 2MB CursorWindow with headroom for the other columns
+        private const val MAX_READABLE_FIELDS_CHARS = 1_500_000
+    }
+
+    override val id: String = ID
+
+    override fun migrateChunk(
+        db: SupportSQLiteDatabase,
+        afterRowId: Long,
+        limit: Int,
+    ): Long? {
+        var lastRowId: Long? = null
+        val candidates = mutableListOf<Long>()
+        db.query(
+            "SELECT rowid, length(fieldsJson) AS len, instr(fieldsJson, '\"reactions\"') > 0 AS hasReactions " +
+                "FROM messages WHERE rowid > ? ORDER BY rowid LIMIT ?",
+            arrayOf<Any?>(afterRowId, limit),
+        ).use { cursor ->
+            while (cursor.moveToNext()) {
+                val rowId = cursor.getLong(0)
+                lastRowId = rowId
+                if (cursor.getInt(2) == 0) continue
+                if (cursor.getLong(1) > MAX_READABLE_FIELDS_CHARS) {
+                    Log.w(TAG, "Skipping oversized fieldsJson at rowid $rowId")
+                    continue
+                }
+                candidates.add(rowId)
+            }
+        }
+        candidates.forEach { migrateRow(db, it) }
+        return lastRowId
+    }
+
+    private fun migrateRow(
+        db: SupportSQLiteDatabase,
+        rowId: Long,
+    ) {
+        db.query(
+            "SELECT id, identityHash, COALESCE(receivedAt, timestamp), fieldsJson FROM messages WHERE rowid = ?",
+            arrayOf<Any?>(rowId),
+        ).use { cursor ->
+            if (!cursor.moveToFirst()) return
+            val id = cursor.getString(0)
+            val identityHash = cursor.getString(1)
+            val ts = cursor.getLong(2)
+            val fieldsJson = cursor.getString(3) ?: return
+
+            val (newFieldsJson, reactionsJson) =
+                ColumbaDatabase.splitReactionsOutOfFieldsJson(fieldsJson) ?: return
+
+            ColumbaDatabase.splitReactionsJson(reactionsJson).forEach { (emoji, sender) ->
+                db.execSQL(
+                    "INSERT OR IGNORE INTO reactions " +
+                        "(messageId, identityHash, emoji, sender, timestamp) VALUES (?, ?, ?, ?, ?)",
+                    arrayOf<Any?>(id, identityHash, emoji, sender, ts),
+                )
+            }
+            db.execSQL(
+                "UPDATE messages SET fieldsJson = ? WHERE rowid = ?",
+                arrayOf<Any?>(newFieldsJson, rowId),
+            )
+        }
+    }
+}
@@ -23,10 +23,14 @@ import network.columba.app.data.db.dao.InterfaceFirstSeenDao
 import network.columba.app.data.db.dao.LocalIdentityDao
 import network.columba.app.data.db.dao.MessageDao
 import network.columba.app.data.db.dao.OfflineMapRegionDao
+import network.columba.app.data.db.dao.PathTableDao
 import network.columba.app.data.db.dao.PeerIconDao
 import network.columba.app.data.db.dao.PeerIdentityDao
+import network.columba.app.data.db.dao.ReactionDao
 import network.columba.app.data.db.dao.ReceivedLocationDao
 import network.columba.app.data.db.dao.RmspServerDao
+import network.columba.app.data.db.migration.BackgroundMigrationRunner
+import network.columba.app.data.db.migration.LegacyFieldReactionsMigration
 import javax.inject.Singleton
 
 @Module
@@ -109,13 +113,30 @@ object DatabaseModule {
                 context,
                 ColumbaDatabase::class.java,
                 DATABASE_NAME,
-            ).addMigrations(ColumbaDatabase.MIGRATION_1_2)
+            ).addMigrations(
+                ColumbaDatabase.MIGRATION_1_2,
+                ColumbaDatabase.MIGRATION_2_3,
+                ColumbaDatabase.MIGRATION_3_4,
+                ColumbaDatabase.MIGRATION_4_5,
+            )
             .fallbackToDestructiveMigration()
             .fallbackToDestructiveMigrationOnDowngrade()
             .enableMultiInstanceInvalidation()
             .addCallback(DURABILITY_CALLBACK)
             .build()
 
+    /**
+     * Post-open data migrations, in the order they must run. Append only —
+     * ids are persisted as progress markers.
+     */
+    @Provides
+    @Singleton
+    fun provideBackgroundMigrationRunner(database: ColumbaDatabase): BackgroundMigrationRunner =
+        BackgroundMigrationRunner(
+            database = database,
+            migrations = listOf(LegacyFieldReactionsMigration()),
+        )
+
     @Provides
     fun provideConversationDao(database: ColumbaDatabase): ConversationDao = database.conversationDao()
 
@@ -158,6 +179,12 @@ object DatabaseModule {
     @Provides
     fun provideInterfaceFirstSeenDao(database: ColumbaDatabase): InterfaceFirstSeenDao = database.interfaceFirstSeenDao()
 
+    @Provides
+    fun provideReactionDao(database: ColumbaDatabase): ReactionDao = database.reactionDao()
+
+    @Provides
+    fun providePathTableDao(database: ColumbaDatabase): PathTableDao = database.pathTableDao()
+
     @Provides
     @Singleton
     @Suppress("InjectDispatcher") // This IS the DI provider for the IO dispatcher
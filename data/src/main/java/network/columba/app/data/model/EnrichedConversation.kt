@@ -7,6 +7,7 @@ package network.columba.app.data.model
  * - Conversation data (from conversations table)
  * - Profile icon (from peer_icons table - LXMF message appearances)
  * - Display name with priority: nickname > announce name > peer name > hash (from contacts + announces)
+ * - Contact, public key and draft state (from contacts, peer_identities, announces and drafts)
  */
 data class EnrichedConversation(
     val peerHash: String,
@@ -21,6 +22,12 @@ data class EnrichedConversation(
     val iconName: String? = null,
     val iconForegroundColor: String? = null,
     val iconBackgroundColor: String? = null,
+    // Whether the peer is saved in contacts for this identity
+    val isContact: Boolean = false,
+    // Whether a public key is known from any source, i.e. the peer can be saved as a contact
+    val hasPublicKey: Boolean = false,
+    // Draft preview (first 200 chars), null when there is no draft
+    val draftText: String? = null,
 ) {
     override fun equals(other: Any?): Boolean {
         if (this === other) return true
@@ -43,6 +50,9 @@ data class EnrichedConversation(
         if (iconName != other.iconName) return false
         if (iconForegroundColor != other.iconForegroundColor) return false
         if (iconBackgroundColor != other.iconBackgroundColor) return false
+        if (isContact != other.isContact) return false
+        if (hasPublicKey != other.hasPublicKey) return false
+        if (draftText != other.draftText) return false
 
         return true
     }
@@ -58,6 +68,9 @@ data class EnrichedConversation(
         result = 31 * result + (iconName?.hashCode() ?: 0)
         result = 31 * result + (iconForegroundColor?.hashCode() ?: 0)
         result = 31 * result + (iconBackgroundColor?.hashCode() ?: 0)
+        result = 31 * result + isContact.hashCode()
+        result = 31 * result + hasPublicKey.hashCode()
+        result = 31 * result + (draftText?.hashCode() ?: 0)
         return result
     }
 }
@@ -305,18 +305,11 @@ class AnnounceRepository
         fun getAnnounceCountFlow(): Flow<Int> = announceDao.getAnnounceCountFlow()
 
         /**
-         * Count announces that match the given path table hashes.
-         * Filters to only count PEER and NODE types (excludes PROPAGATION_NODE).
-         *
-         * @param pathTableHashes List of destination hashes from RNS path table
-         * @return Count of matching announces
+         * Count of PEER and NODE announces we currently have a path to, as a
+         * Flow. Backed by the `path_table` mirror, so it updates as paths
+         * come and go without the caller fetching the path table.
          */
-        suspend fun countReachableAnnounces(pathTableHashes: List<String>): Int {
-            if (pathTableHashes.isEmpty()) {
-                return 0
-            }
-            return announceDao.countReachableAnnounces(pathTableHashes)
-        }
+        fun getReachableAnnounceCountFlow(): Flow<Int> = announceDao.observeReachableAnnounceCount()
 
         /**
          * Get all favorite announces as a Flow, sorted by most recently favorited.
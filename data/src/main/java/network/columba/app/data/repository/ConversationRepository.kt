@@ -10,11 +10,14 @@ import kotlinx.coroutines.flow.emptyFlow
 import kotlinx.coroutines.flow.flatMapLatest
 import kotlinx.coroutines.flow.flowOf
 import kotlinx.coroutines.flow.map
+import network.columba.app.data.db.ColumbaDatabase
 import network.columba.app.data.db.dao.ConversationDao
 import network.columba.app.data.db.dao.DraftDao
 import network.columba.app.data.db.dao.LocalIdentityDao
 import network.columba.app.data.db.dao.MessageDao
+import network.columba.app.data.db.dao.MessageWithReactions
 import network.columba.app.data.db.dao.PeerIdentityDao
+import network.columba.app.data.db.dao.ReactionDao
 import network.columba.app.data.db.entity.ConversationEntity
 import network.columba.app.data.db.entity.DraftEntity
 import network.columba.app.data.db.entity.MessageEntity
@@ -40,6 +43,10 @@ data class Conversation(
     val iconName: String? = null,
     val iconForegroundColor: String? = null,
     val iconBackgroundColor: String? = null,
+    // Contact and draft state, from the enriched conversation query
+    val isContact: Boolean = false,
+    val hasPublicKey: Boolean = peerPublicKey != null,
+    val draftText: String? = null,
 )
 
 data class Message(
@@ -62,12 +69,11 @@ data class Message(
     val receivedAt: Long? = null,
     // Interface name through which message was sent (null for received messages or pre-feature messages)
     val sentInterface: String? = null,
-    // DB-local per-target-message reactions aggregation. Flat shape:
-    //   {"👍": ["sender_hex_1", ...], "❤️": [...]}
-    // Never appears on the wire — the LXMF reaction wire format is
-    // a per-event `fields[0x10] = {reaction_to, emoji, sender}` that
-    // the receiver routes into this field on the *target* message.
-    val reactionsJson: String? = null,
+    // Reactions on this message, emoji → sender hashes, aggregated from the
+    // `reactions` table by the message-list queries. Never appears on the
+    // wire — reactions travel as separate per-event LXMF messages that the
+    // receiver records against the *target* message.
+    val reactions: Map<String, List<String>> = emptyMap(),
 )
 
 /**
@@ -94,6 +100,7 @@ class ConversationRepository
         private val localIdentityDao: LocalIdentityDao,
         private val attachmentStorage: AttachmentStorageManager,
         private val draftDao: DraftDao,
+        private val reactionDao: ReactionDao,
     ) {
         /**
          * Get all conversations for the active identity, sorted by most recent activity.
@@ -166,8 +173,8 @@ class ConversationRepository
                 if (identity == null) {
                     flowOf(emptyList())
                 } else {
-                    messageDao.getMessagesForConversation(peerHash, identity.identityHash).map { entities ->
-                        entities.map { it.toMessage() }
+                    messageDao.getMessagesForConversation(peerHash, identity.identityHash).map { rows ->
+                        rows.map { it.toMessage() }
                     }
                 }
             }
@@ -197,7 +204,7 @@ class ConversationRepository
                     messageDao.getMessagesForConversationPaged(peerHash, identityHash)
                 },
             ).flow.map { pagingData ->
-                pagingData.map { entity -> entity.toMessage() }
+                pagingData.map { row -> row.toMessage() }
             }
         }
 
@@ -224,7 +231,7 @@ class ConversationRepository
                     messageDao.getMessagesForConversationPagedBySentTime(peerHash, identityHash)
                 },
             ).flow.map { pagingData ->
-                pagingData.map { entity -> entity.toMessage() }
+                pagingData.map { row -> row.toMessage() }
             }
         }
 
@@ -384,7 +391,9 @@ class ConversationRepository
             val conversation = conversationDao.getConversation(peerHash, activeIdentity.identityHash)
             conversation?.let {
                 conversationDao.deleteConversation(it)
-                // Messages will be cascade-deleted due to foreign key
+                // Messages will be cascade-deleted due to foreign key;
+                // reactions aren't FK-linked to them, so sweep those up
+                reactionDao.deleteOrphanedReactions(activeIdentity.identityHash)
             }
         }
 
@@ -508,6 +517,7 @@ class ConversationRepository
 
             // Delete the message
             messageDao.deleteMessageById(messageId, identityHash)
+            reactionDao.deleteReactionsForMessage(messageId, identityHash)
             android.util.Log.d("ConversationRepository", "Deleted message $messageId")
 
             // Update conversation's last message preview
@@ -587,6 +597,9 @@ class ConversationRepository
                 iconName = iconName,
                 iconForegroundColor = iconForegroundColor,
                 iconBackgroundColor = iconBackgroundColor,
+                isContact = isContact,
+                hasPublicKey = hasPublicKey,
+                draftText = draftText,
             )
 
         private fun MessageEntity.toMessage() =
@@ -605,9 +618,31 @@ class ConversationRepository
                 receivedInterface = receivedInterface,
                 receivedAt = receivedAt,
                 sentInterface = sentInterface,
-                reactionsJson = reactionsJson,
             )
 
+        private fun MessageWithReactions.toMessage() =
+            message.toMessage().copy(reactions = withLegacyReactions(reactionsByEmoji(), message.fieldsJson))
+
+        /**
+         * Compatibility read path while `LegacyFieldReactionsMigration` is
+         * still running: merge reactions not yet lifted out of
+         * `fields[16].reactions` with the table's. The substring probe keeps
+         * this free for every already-migrated row.
+         */
+        private fun withLegacyReactions(
+            reactions: Map<String, List<String>>,
+            fieldsJson: String?,
+        ): Map<String, List<String>> {
+            if (fieldsJson == null || !fieldsJson.contains("\"reactions\"")) return reactions
+            val (_, legacyJson) = ColumbaDatabase.splitReactionsOutOfFieldsJson(fieldsJson) ?: return reactions
+            val merged = reactions.mapValuesTo(LinkedHashMap()) { it.value.toMutableList() }
+            ColumbaDatabase.splitReactionsJson(legacyJson).forEach { (emoji, sender) ->
+                val senders = merged.getOrPut(emoji) { mutableListOf() }
+                if (sender !in senders) senders.add(sender)
+            }
+            return merged
+        }
+
         /**
          * Update the sent interface name for a message (active identity scoped).
          */
@@ -641,31 +676,35 @@ class ConversationRepository
         }
 
         /**
-         * Update the per-target-message reactions aggregation column.
-         * Caller passes the full new `reactionsJson` blob (flat shape
-         * `{emoji: [senderHex, ...]}`). Used when adding/updating
-         * emoji reactions on a message.
-         *
-         * As of DB v2 this writes to the dedicated `reactionsJson`
-         * column — no longer overloaded onto `fieldsJson.field16`.
+         * Record an emoji reaction on a message for the active identity.
+         * Inserts one row into the `reactions` table; the message row itself
+         * is not touched. Repeating the same (emoji, sender) is a no-op.
          *
-         * @param messageId The ID of the message to update
-         * @param updatedReactionsJson The new reactions blob, or null to clear
+         * @param messageId The ID of the message being reacted to
+         * @param emoji The reaction emoji
+         * @param senderHash Hex hash of the reacting peer (ours for sent reactions)
+         * @return true if a new reaction was recorded, false if it was already
+         *   present or the target message is unknown
          */
-        suspend fun updateMessageReactions(
+        suspend fun addReaction(
             messageId: String,
-            updatedReactionsJson: String?,
-        ) {
-            val activeIdentity = localIdentityDao.getActiveIdentitySync() ?: return
-            messageDao.updateMessageReactionsJson(
-                messageId,
-                activeIdentity.identityHash,
-                updatedReactionsJson,
-            )
+            emoji: String,
+            senderHash: String,
+        ): Boolean {
+            val activeIdentity = localIdentityDao.getActiveIdentitySync() ?: return false
+            val rowId =
+                reactionDao.insertReaction(
+                    messageId = messageId,
+                    identityHash = activeIdentity.identityHash,
+                    emoji = emoji,
+                    sender = senderHash,
+                    timestamp = System.currentTimeMillis(),
+                )
             android.util.Log.d(
                 "ConversationRepository",
-                "Updated message $messageId reactions",
+                "Reaction $emoji on message $messageId: ${if (rowId != -1L) "recorded" else "ignored"}",
             )
+            return rowId != -1L
         }
 
         /**
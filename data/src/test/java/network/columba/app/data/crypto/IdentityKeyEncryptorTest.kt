@@ -11,7 +11,14 @@ import org.junit.Test
 import org.junit.runner.RunWith
 import org.robolectric.RobolectricTestRunner
 import org.robolectric.annotation.Config
+import java.nio.ByteBuffer
 import java.security.SecureRandom
+import javax.crypto.Cipher
+import javax.crypto.Mac
+import javax.crypto.SecretKeyFactory
+import javax.crypto.spec.GCMParameterSpec
+import javax.crypto.spec.PBEKeySpec
+import javax.crypto.spec.SecretKeySpec
 
 /**
  * Unit tests for IdentityKeyEncryptor.
@@ -30,11 +37,19 @@ class IdentityKeyEncryptorTest {
         // Standard 64-byte identity key for testing
         private val TEST_KEY_DATA = ByteArray(64) { it.toByte() }
         private val TEST_PASSWORD = "testPassword123!".toCharArray()
+
+        // Stand-in for Keystore-encrypted (version 1) data: the password layer
+        // treats it as opaque, so it needs only the right shape
+        private val DEVICE_BLOB =
+            byteArrayOf(IdentityKeyEncryptor.VERSION_DEVICE_ONLY) + ByteArray(12 + 64 + 16) { (it * 7).toByte() }
+
+        // Low cost keeps the password layer tests fast; calibration is tested separately
+        private const val TEST_ITERATIONS = 1_000
     }
 
     @Before
     fun setUp() {
-        encryptor = IdentityKeyEncryptor()
+        encryptor = IdentityKeyEncryptor().apply { minPasswordIterations = TEST_ITERATIONS }
     }
 
     // ==================== Password Verification Tests ====================
@@ -221,6 +236,238 @@ class IdentityKeyEncryptorTest {
         assertArrayEquals(salt, extractedSalt)
     }
 
+    // ==================== Single-Derivation Password Layer Tests ====================
+    // The password layer wraps device-encrypted data without touching the Keystore
+
+    @Test
+    fun `sealWithPassword and openWithPassword round trip`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+
+        assertEquals(IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3, sealed.encryptedData[0])
+        assertArrayEquals(DEVICE_BLOB, encryptor.openWithPassword(sealed.encryptedData, TEST_PASSWORD))
+    }
+
+    @Test(expected = WrongPasswordException::class)
+    fun `openWithPassword throws on wrong password`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+
+        encryptor.openWithPassword(sealed.encryptedData, "wrongPassword!".toCharArray())
+    }
+
+    @Test
+    fun `sealed data records iteration count and salt`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+
+        assertEquals(TEST_ITERATIONS, ByteBuffer.wrap(sealed.encryptedData, 1, 4).getInt())
+        assertArrayEquals(sealed.salt, encryptor.extractSalt(sealed.encryptedData))
+        assertEquals(32, sealed.verificationHash.size)
+    }
+
+    @Test
+    fun `verifyPasswordForKey checks verifier from the same derivation`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+
+        assertTrue(encryptor.verifyPasswordForKey(sealed.encryptedData, TEST_PASSWORD, sealed.verificationHash))
+        assertFalse(
+            encryptor.verifyPasswordForKey(sealed.encryptedData, "wrongPassword!".toCharArray(), sealed.verificationHash),
+        )
+    }
+
+    @Test
+    fun `verifier is not the encryption key`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+        val iv = sealed.encryptedData.copyOfRange(1 + 4 + 32, 1 + 4 + 32 + 12)
+        val ciphertext = sealed.encryptedData.copyOfRange(1 + 4 + 32 + 12, sealed.encryptedData.size)
+
+        val decryptedWithVerifier =
+            runCatching {
+                Cipher.getInstance("AES/GCM/NoPadding").run {
+                    init(Cipher.DECRYPT_MODE, SecretKeySpec(sealed.verificationHash, "AES"), GCMParameterSpec(128, iv))
+                    doFinal(ciphertext)
+                }
+            }
+
+        assertTrue(decryptedWithVerifier.isFailure)
+    }
+
+    @Test
+    fun `open and verify each cost one key derivation`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+        encryptor.kdfCounters.reset()
+
+        encryptor.openWithPassword(sealed.encryptedData, TEST_PASSWORD)
+
+        assertEquals(1, encryptor.kdfCounters.derivations.get())
+        assertEquals(TEST_ITERATIONS.toLong(), encryptor.kdfCounters.iterations.get())
+        assertTrue(encryptor.kdfCounters.nanos.get() > 0)
+
+        encryptor.kdfCounters.reset()
+        encryptor.verifyPasswordForKey(sealed.encryptedData, TEST_PASSWORD, sealed.verificationHash)
+
+        assertEquals(1, encryptor.kdfCounters.derivations.get())
+    }
+
+    @Test
+    fun `changePasswordProtection costs one derivation per password`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+        val newPassword = "newPassword456!".toCharArray()
+        encryptor.kdfCounters.reset()
+
+        val changed = encryptor.changePasswordProtection(sealed.encryptedData, TEST_PASSWORD, newPassword)
+
+        assertEquals(2, encryptor.kdfCounters.derivations.get())
+        assertArrayEquals(DEVICE_BLOB, encryptor.openWithPassword(changed.encryptedData, newPassword))
+        assertTrue(encryptor.verifyPasswordForKey(changed.encryptedData, newPassword, changed.verificationHash))
+    }
+
+    @Test
+    fun `sealed header is authenticated`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+        val data = sealed.encryptedData
+        val key = SecretKeySpec(version3Key(TEST_PASSWORD, sealed.salt, TEST_ITERATIONS), "AES")
+        val iv = GCMParameterSpec(128, data, 1 + 4 + 32, 12)
+        val ciphertext = data.copyOfRange(1 + 4 + 32 + 12, data.size)
+
+        val withoutHeader =
+            runCatching {
+                Cipher.getInstance("AES/GCM/NoPadding").run {
+                    init(Cipher.DECRYPT_MODE, key, iv)
+                    doFinal(ciphertext)
+                }
+            }
+        val withHeader =
+            Cipher.getInstance("AES/GCM/NoPadding").run {
+                init(Cipher.DECRYPT_MODE, key, iv)
+                updateAAD(data, 0, 1 + 4 + 32)
+                doFinal(ciphertext)
+            }
+
+        assertTrue(withoutHeader.isFailure)
+        assertArrayEquals(DEVICE_BLOB, withHeader)
+    }
+
+    @Test(expected = CorruptedKeyException::class)
+    fun `openWithPassword rejects iteration counts below the floor`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+
+        IdentityKeyEncryptor().openWithPassword(sealed.encryptedData, TEST_PASSWORD)
+    }
+
+    @Test
+    fun `verifyPasswordForKey rejects iteration counts below the floor`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+        val production = IdentityKeyEncryptor()
+
+        assertFalse(production.verifyPasswordForKey(sealed.encryptedData, TEST_PASSWORD, sealed.verificationHash))
+        assertEquals(0, production.kdfCounters.derivations.get())
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `sealWithPassword refuses iteration counts below the floor`() {
+        IdentityKeyEncryptor().sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+    }
+
+    @Test
+    fun `removePasswordProtection returns the device-encrypted data`() {
+        val sealed = encryptor.sealWithPassword(DEVICE_BLOB, TEST_PASSWORD, TEST_ITERATIONS)
+
+        assertArrayEquals(DEVICE_BLOB, encryptor.removePasswordProtection(sealed.encryptedData, TEST_PASSWORD))
+    }
+
+    // ==================== Legacy Version 2 Compatibility Tests ====================
+
+    @Test
+    fun `openWithPassword still opens version 2 data`() {
+        val legacy = createVersion2Blob(DEVICE_BLOB, TEST_PASSWORD)
+
+        assertArrayEquals(DEVICE_BLOB, encryptor.openWithPassword(legacy, TEST_PASSWORD))
+    }
+
+    @Test(expected = WrongPasswordException::class)
+    fun `openWithPassword rejects version 2 data with wrong password`() {
+        val legacy = createVersion2Blob(DEVICE_BLOB, TEST_PASSWORD)
+
+        encryptor.openWithPassword(legacy, "wrongPassword!".toCharArray())
+    }
+
+    @Test
+    fun `version 2 data resealed as version 3 keeps the same device data`() {
+        val legacy = createVersion2Blob(DEVICE_BLOB, TEST_PASSWORD)
+
+        val inner = encryptor.openWithPassword(legacy, TEST_PASSWORD)
+        val upgraded = encryptor.sealWithPassword(inner, TEST_PASSWORD, TEST_ITERATIONS)
+
+        assertEquals(IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3, upgraded.encryptedData[0])
+        assertArrayEquals(DEVICE_BLOB, encryptor.openWithPassword(upgraded.encryptedData, TEST_PASSWORD))
+    }
+
+    @Test
+    fun `verifyPasswordForKey rejects version 2 data`() {
+        val legacy = createVersion2Blob(DEVICE_BLOB, TEST_PASSWORD)
+
+        assertFalse(encryptor.verifyPasswordForKey(legacy, TEST_PASSWORD, ByteArray(32)))
+    }
+
+    // ==================== KDF Calibration Tests ====================
+
+    @Test
+    fun `passwordIterations is within bounds and stable`() {
+        val iterations = encryptor.passwordIterations()
+
+        assertTrue(iterations >= IdentityKeyEncryptor.MIN_PASSWORD_ITERATIONS)
+        assertTrue(iterations <= IdentityKeyEncryptor.MAX_PASSWORD_ITERATIONS)
+        assertEquals(iterations, encryptor.passwordIterations())
+    }
+
+    @Test
+    fun `isPasswordVersion covers versions 2 and 3`() {
+        assertFalse(IdentityKeyEncryptor.isPasswordVersion(0))
+        assertFalse(IdentityKeyEncryptor.isPasswordVersion(1))
+        assertTrue(IdentityKeyEncryptor.isPasswordVersion(2))
+        assertTrue(IdentityKeyEncryptor.isPasswordVersion(3))
+    }
+
+    /**
+     * Build version 2 data the way earlier releases did:
+     * [0x02][32-byte salt][12-byte IV][AES-GCM under PBKDF2-SHA256 (600K iterations)].
+     */
+    private fun createVersion2Blob(
+        inner: ByteArray,
+        password: CharArray,
+    ): ByteArray {
+        val salt = ByteArray(32).also { SecureRandom().nextBytes(it) }
+        val keyBytes =
+            SecretKeyFactory.getInstance("PBKDF2WithHmacSHA256")
+                .generateSecret(PBEKeySpec(password, salt, 600_000, 256))
+                .encoded
+        val cipher = Cipher.getInstance("AES/GCM/NoPadding")
+        cipher.init(Cipher.ENCRYPT_MODE, SecretKeySpec(keyBytes, "AES"))
+        return byteArrayOf(IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD) + salt + cipher.iv + cipher.doFinal(inner)
+    }
+
+    /** Version 3 AES key: PBKDF2, then HKDF-SHA256 with the encryption label. */
+    private fun version3Key(
+        password: CharArray,
+        salt: ByteArray,
+        iterations: Int,
+    ): ByteArray {
+        val master =
+            SecretKeyFactory.getInstance("PBKDF2WithHmacSHA256")
+                .generateSecret(PBEKeySpec(password, salt, iterations, 256))
+                .encoded
+        val prk =
+            Mac.getInstance("HmacSHA256").run {
+                init(SecretKeySpec(salt, "HmacSHA256"))
+                doFinal(master)
+            }
+        return Mac.getInstance("HmacSHA256").run {
+            init(SecretKeySpec(prk, "HmacSHA256"))
+            update("columba-identity-key-encryption".toByteArray())
+            update(1.toByte())
+            doFinal()
+        }
+    }
+
     // ==================== Secure Wipe Tests ====================
 
     @Test
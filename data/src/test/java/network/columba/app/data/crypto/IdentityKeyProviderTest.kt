@@ -104,7 +104,93 @@ class IdentityKeyProviderTest {
                 )
 
             coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
-            every { encryptor.decryptWithPassword(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD) } returns TEST_KEY_DATA
+            every {
+                encryptor.unlockWithPassword(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD)
+            } returns IdentityKeyEncryptor.PasswordUnlockResult(TEST_KEY_DATA, upgraded = null)
+
+            val result = keyProvider.getDecryptedKeyData(TEST_IDENTITY_HASH, TEST_PASSWORD)
+
+            assertTrue(result.isSuccess)
+            assertArrayEquals(TEST_KEY_DATA, result.getOrThrow())
+        }
+
+    @Test
+    fun `getDecryptedKeyData stores upgraded data when unlocking legacy password encryption`() =
+        runTest {
+            val upgraded = IdentityKeyEncryptor.PasswordProtectedKey(ByteArray(160), ByteArray(32) { 1 }, ByteArray(32) { 2 })
+
+            @Suppress("DEPRECATION")
+            val identity =
+                LocalIdentityEntity(
+                    identityHash = TEST_IDENTITY_HASH,
+                    displayName = "Test Identity",
+                    destinationHash = "dest123",
+                    filePath = "/fake/path",
+                    keyData = null,
+                    encryptedKeyData = PASSWORD_ENCRYPTED_DATA,
+                    keyEncryptionVersion = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
+                    passwordSalt = ByteArray(32),
+                    passwordVerificationHash = ByteArray(32),
+                    createdTimestamp = System.currentTimeMillis(),
+                    lastUsedTimestamp = System.currentTimeMillis(),
+                    isActive = true,
+                )
+
+            coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
+            every {
+                encryptor.unlockWithPassword(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD)
+            } returns IdentityKeyEncryptor.PasswordUnlockResult(TEST_KEY_DATA, upgraded)
+            coEvery {
+                identityDao.updatePasswordProtection(
+                    identityHash = any(),
+                    encryptedKeyData = any(),
+                    version = any(),
+                    passwordSalt = any(),
+                    passwordVerificationHash = any(),
+                )
+            } returns Unit
+
+            val result = keyProvider.getDecryptedKeyData(TEST_IDENTITY_HASH, TEST_PASSWORD)
+
+            assertTrue(result.isSuccess)
+            coVerify {
+                identityDao.updatePasswordProtection(
+                    identityHash = TEST_IDENTITY_HASH,
+                    encryptedKeyData = upgraded.encryptedData,
+                    version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt(),
+                    passwordSalt = upgraded.salt,
+                    passwordVerificationHash = upgraded.verificationHash,
+                )
+            }
+        }
+
+    @Test
+    fun `getDecryptedKeyData succeeds when storing upgraded data fails`() =
+        runTest {
+            val upgraded = IdentityKeyEncryptor.PasswordProtectedKey(ByteArray(160), ByteArray(32), ByteArray(32))
+
+            @Suppress("DEPRECATION")
+            val identity =
+                LocalIdentityEntity(
+                    identityHash = TEST_IDENTITY_HASH,
+                    displayName = "Test Identity",
+                    destinationHash = "dest123",
+                    filePath = "/fake/path",
+                    keyData = null,
+                    encryptedKeyData = PASSWORD_ENCRYPTED_DATA,
+                    keyEncryptionVersion = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
+                    createdTimestamp = System.currentTimeMillis(),
+                    lastUsedTimestamp = System.currentTimeMillis(),
+                    isActive = true,
+                )
+
+            coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
+            every {
+                encryptor.unlockWithPassword(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD)
+            } returns IdentityKeyEncryptor.PasswordUnlockResult(TEST_KEY_DATA, upgraded)
+            coEvery {
+                identityDao.updatePasswordProtection(any(), any(), any(), any(), any())
+            } throws IllegalStateException("database closed")
 
             val result = keyProvider.getDecryptedKeyData(TEST_IDENTITY_HASH, TEST_PASSWORD)
 
@@ -389,12 +475,42 @@ class IdentityKeyProviderTest {
             assertTrue(keyProvider.verifyPassword(TEST_IDENTITY_HASH, TEST_PASSWORD))
         }
 
+    @Test
+    fun `verifyPassword checks single-derivation verifier for version 3`() =
+        runTest {
+            val verificationHash = ByteArray(32) { 3 }
+
+            @Suppress("DEPRECATION")
+            val identity =
+                LocalIdentityEntity(
+                    identityHash = TEST_IDENTITY_HASH,
+                    displayName = "Test Identity",
+                    destinationHash = "dest123",
+                    filePath = "/fake/path",
+                    keyData = null,
+                    encryptedKeyData = PASSWORD_ENCRYPTED_DATA,
+                    keyEncryptionVersion = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt(),
+                    passwordSalt = ByteArray(32),
+                    passwordVerificationHash = verificationHash,
+                    createdTimestamp = System.currentTimeMillis(),
+                    lastUsedTimestamp = System.currentTimeMillis(),
+                    isActive = true,
+                )
+
+            coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
+            every { encryptor.verifyPasswordForKey(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD, verificationHash) } returns true
+
+            assertTrue(keyProvider.verifyPassword(TEST_IDENTITY_HASH, TEST_PASSWORD))
+            verify(exactly = 0) { encryptor.verifyPassword(any(), any(), any()) }
+        }
+
     // ==================== Enable Password Protection Tests ====================
 
     @Test
     fun `enablePasswordProtection updates database correctly`() =
         runTest {
             val newPasswordEncrypted = ByteArray(160)
+            val newSalt = ByteArray(32) { 1 }
             val newVerificationHash = ByteArray(32)
 
             @Suppress("DEPRECATION")
@@ -413,8 +529,9 @@ class IdentityKeyProviderTest {
                 )
 
             coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
-            every { encryptor.addPasswordProtection(ENCRYPTED_KEY_DATA, TEST_PASSWORD) } returns newPasswordEncrypted
-            every { encryptor.createPasswordVerificationHash(any(), any()) } returns newVerificationHash
+            every {
+                encryptor.protectWithPassword(ENCRYPTED_KEY_DATA, TEST_PASSWORD)
+            } returns IdentityKeyEncryptor.PasswordProtectedKey(newPasswordEncrypted, newSalt, newVerificationHash)
             coEvery {
                 identityDao.updatePasswordProtection(
                     identityHash = any(),
@@ -432,8 +549,8 @@ class IdentityKeyProviderTest {
                 identityDao.updatePasswordProtection(
                     identityHash = TEST_IDENTITY_HASH,
                     encryptedKeyData = newPasswordEncrypted,
-                    version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
-                    passwordSalt = any(),
+                    version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt(),
+                    passwordSalt = newSalt,
                     passwordVerificationHash = newVerificationHash,
                 )
             }
@@ -600,9 +717,8 @@ class IdentityKeyProviderTest {
 
             coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
             every {
-                encryptor.changePassword(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD, newPassword)
-            } returns newEncryptedData
-            every { encryptor.createPasswordVerificationHash(any(), any()) } returns ByteArray(32)
+                encryptor.changePasswordProtection(PASSWORD_ENCRYPTED_DATA, TEST_PASSWORD, newPassword)
+            } returns IdentityKeyEncryptor.PasswordProtectedKey(newEncryptedData, ByteArray(32), ByteArray(32))
             coEvery {
                 identityDao.updatePasswordProtection(
                     identityHash = any(),
@@ -620,7 +736,7 @@ class IdentityKeyProviderTest {
                 identityDao.updatePasswordProtection(
                     identityHash = TEST_IDENTITY_HASH,
                     encryptedKeyData = newEncryptedData,
-                    version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD.toInt(),
+                    version = IdentityKeyEncryptor.VERSION_DEVICE_AND_PASSWORD_V3.toInt(),
                     passwordSalt = any(),
                     passwordVerificationHash = any(),
                 )
@@ -650,7 +766,7 @@ class IdentityKeyProviderTest {
 
             coEvery { identityDao.getIdentity(TEST_IDENTITY_HASH) } returns identity
             every {
-                encryptor.changePassword(PASSWORD_ENCRYPTED_DATA, wrongOldPassword, newPassword)
+                encryptor.changePasswordProtection(PASSWORD_ENCRYPTED_DATA, wrongOldPassword, newPassword)
             } throws WrongPasswordException("Wrong password")
 
             val result = keyProvider.changePassword(TEST_IDENTITY_HASH, wrongOldPassword, newPassword)
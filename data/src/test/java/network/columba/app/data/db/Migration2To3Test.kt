@@ -0,0 +1,61 @@
+package network.columba.app.data.db
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Pure-Kotlin unit tests for the json-level helper that
+ * `ColumbaDatabase.MIGRATION_2_3` uses to split each `reactionsJson`
+ * blob into `reactions` rows.
+ *
+ * Runs without Robolectric / Room — exercises [ColumbaDatabase.splitReactionsJson]
+ * directly. The end-to-end backfill is covered in ReactionDaoTest.
+ */
+class Migration2To3Test {
+    @Test
+    fun `splits blob into one pair per emoji and sender in blob order`() {
+        val pairs = ColumbaDatabase.splitReactionsJson("""{"👍": ["s1", "s2"], "❤️": ["s3"]}""")
+
+        assertEquals(listOf("👍" to "s1", "👍" to "s2", "❤️" to "s3"), pairs)
+    }
+
+    @Test
+    fun `skips blank and non-string senders`() {
+        val pairs = ColumbaDatabase.splitReactionsJson("""{"👍": ["s1", "", "  ", null, 123, "s2"]}""")
+
+        assertEquals(listOf("👍" to "s1", "👍" to "s2"), pairs)
+    }
+
+    @Test
+    fun `skips non-array values and empty emoji keys`() {
+        val pairs =
+            ColumbaDatabase.splitReactionsJson(
+                """{"👍": "not an array", "": ["s1"], "😂": {"nested": true}, "❤️": ["s2"]}""",
+            )
+
+        assertEquals(listOf("❤️" to "s2"), pairs)
+    }
+
+    @Test
+    fun `duplicate senders are kept for the insert to collapse`() {
+        // INSERT OR IGNORE on the composite key dedupes; the helper stays dumb
+        val pairs = ColumbaDatabase.splitReactionsJson("""{"👍": ["s1", "s1"]}""")
+
+        assertEquals(2, pairs.size)
+    }
+
+    @Test
+    fun `returns empty list on unparseable input`() {
+        assertTrue(ColumbaDatabase.splitReactionsJson("not valid json {").isEmpty())
+        assertTrue(ColumbaDatabase.splitReactionsJson("{}").isEmpty())
+    }
+
+    @Test
+    fun `compound emoji keys survive intact`() {
+        val family = "👨‍👩‍👧"
+        val pairs = ColumbaDatabase.splitReactionsJson("""{"$family": ["s1"], "👍🏽": ["s2"]}""")
+
+        assertEquals(setOf(family, "👍🏽"), pairs.map { it.first }.toSet())
+    }
+}
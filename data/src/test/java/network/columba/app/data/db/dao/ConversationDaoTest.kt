@@ -10,10 +10,12 @@ import network.columba.app.data.db.entity.AnnounceEntity
 import network.columba.app.data.db.entity.ContactEntity
 import network.columba.app.data.db.entity.ContactStatus
 import network.columba.app.data.db.entity.ConversationEntity
+import network.columba.app.data.db.entity.DraftEntity
 import network.columba.app.data.db.entity.LocalIdentityEntity
 import kotlinx.coroutines.test.runTest
 import org.junit.After
 import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
 import org.junit.Assert.assertNotNull
 import org.junit.Assert.assertNull
 import org.junit.Assert.assertTrue
@@ -36,6 +38,7 @@ class ConversationDaoTest {
     private lateinit var identityDao: LocalIdentityDao
     private lateinit var contactDao: ContactDao
     private lateinit var announceDao: AnnounceDao
+    private lateinit var draftDao: DraftDao
 
     companion object {
         private const val IDENTITY_HASH = "identity_hash_12345678901234567"
@@ -53,6 +56,7 @@ class ConversationDaoTest {
         identityDao = database.localIdentityDao()
         contactDao = database.contactDao()
         announceDao = database.announceDao()
+        draftDao = database.draftDao()
 
         // Setup required parent entity (FK constraint)
         runTest {
@@ -616,4 +620,48 @@ class ConversationDaoTest {
                 cancelAndIgnoreRemainingEvents()
             }
         }
+
+    // ========== Contact, Key and Draft Projection Tests ==========
+
+    @Test
+    fun getEnrichedConversations_carriesContactKeyAndDraftState() =
+        runTest {
+            conversationDao.insertConversation(createTestConversation(peerHash = "peer1"))
+            conversationDao.insertConversation(createTestConversation(peerHash = "peer2"))
+            contactDao.insertContact(createTestContact("peer1"))
+            announceDao.upsertAnnounce(createTestAnnounce("peer1", peerName = "Alice"))
+            draftDao.insertOrReplaceDraft(DraftEntity("peer2", IDENTITY_HASH, "x".repeat(500), 0L))
+
+            conversationDao.getEnrichedConversations(IDENTITY_HASH).test {
+                val byPeer = awaitItem().associateBy { it.peerHash }
+                assertTrue(byPeer.getValue("peer1").isContact)
+                assertTrue(byPeer.getValue("peer1").hasPublicKey)
+                assertNull(byPeer.getValue("peer1").draftText)
+                assertFalse(byPeer.getValue("peer2").isContact)
+                assertFalse(byPeer.getValue("peer2").hasPublicKey)
+                assertEquals(200, byPeer.getValue("peer2").draftText?.length)
+                cancelAndIgnoreRemainingEvents()
+            }
+        }
+
+    @Test
+    fun getEnrichedConversations_reEmitsOnContactAndDraftChanges() =
+        runTest {
+            repeat(300) { conversationDao.insertConversation(createTestConversation(peerHash = "peer$it")) }
+
+            // One observer for the whole list, however many rows it holds
+            conversationDao.getEnrichedConversations(IDENTITY_HASH).test {
+                assertEquals(0, awaitItem().count { it.isContact })
+
+                contactDao.insertContact(createTestContact("peer42"))
+                assertEquals(listOf("peer42"), awaitItem().filter { it.isContact }.map { it.peerHash })
+
+                draftDao.insertOrReplaceDraft(DraftEntity("peer7", IDENTITY_HASH, "half-written", 0L))
+                assertEquals("half-written", awaitItem().single { it.peerHash == "peer7" }.draftText)
+
+                draftDao.deleteDraft("peer7", IDENTITY_HASH)
+                assertTrue(awaitItem().none { it.draftText != null })
+                cancelAndIgnoreRemainingEvents()
+            }
+        }
 }
@@ -377,9 +377,9 @@ class MessageDaoTest {
             messageDao.getMessagesForConversation(PEER_HASH, IDENTITY_HASH).test {
                 val messages = awaitItem()
                 assertEquals(3, messages.size)
-                assertEquals("msg1", messages[0].id) // Oldest first
-                assertEquals("msg2", messages[1].id)
-                assertEquals("msg3", messages[2].id) // Newest last
+                assertEquals("msg1", messages[0].message.id) // Oldest first
+                assertEquals("msg2", messages[1].message.id)
+                assertEquals("msg3", messages[2].message.id) // Newest last
                 cancelAndIgnoreRemainingEvents()
             }
         }
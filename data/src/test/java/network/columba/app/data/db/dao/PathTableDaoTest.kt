@@ -0,0 +1,152 @@
+package network.columba.app.data.db.dao
+
+import android.app.Application
+import android.content.Context
+import androidx.room.Room
+import androidx.test.core.app.ApplicationProvider
+import app.cash.turbine.test
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.AnnounceEntity
+import network.columba.app.data.db.entity.PathTableEntryEntity
+import kotlinx.coroutines.test.runTest
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.robolectric.RobolectricTestRunner
+import org.robolectric.annotation.Config
+
+/**
+ * Tests for PathTableDao and the reachable-announce count that joins
+ * against it, at transport-node scale (20k paths).
+ */
+@RunWith(RobolectricTestRunner::class)
+@Config(sdk = [34], application = Application::class)
+class PathTableDaoTest {
+    private lateinit var database: ColumbaDatabase
+    private lateinit var dao: PathTableDao
+    private lateinit var announceDao: AnnounceDao
+
+    @Before
+    fun setup() {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        database =
+            Room
+                .inMemoryDatabaseBuilder(context, ColumbaDatabase::class.java)
+                .allowMainThreadQueries()
+                .build()
+        dao = database.pathTableDao()
+        announceDao = database.announceDao()
+    }
+
+    @After
+    fun teardown() {
+        database.close()
+    }
+
+    // ========== Helper Functions ==========
+
+    private fun hash(index: Int): String = "%032x".format(index)
+
+    private fun entries(range: IntRange): List<PathTableEntryEntity> =
+        range.map { PathTableEntryEntity(hash(it), hops = 1 + it % 8, updatedAt = 0L) }
+
+    private fun createTestAnnounce(
+        destinationHash: String,
+        nodeType: String = "PEER",
+    ) = AnnounceEntity(
+        destinationHash = destinationHash,
+        peerName = "Peer $destinationHash",
+        publicKey = ByteArray(32) { it.toByte() },
+        appData = null,
+        hops = 1,
+        lastSeenTimestamp = System.currentTimeMillis(),
+        nodeType = nodeType,
+        receivingInterface = null,
+        aspect = if (nodeType == "PROPAGATION_NODE") "lxmf.propagation" else "lxmf.delivery",
+    )
+
+    // ========== applyDelta Tests ==========
+
+    @Test
+    fun applyDelta_resetReplacesExistingEntries() =
+        runTest {
+            dao.applyDelta(reset = true, upserts = entries(0 until 10), expired = emptyList())
+
+            dao.applyDelta(reset = true, upserts = entries(100 until 105), expired = emptyList())
+
+            assertEquals(5, dao.count())
+            assertNull(dao.getHops(hash(0)))
+        }
+
+    @Test
+    fun applyDelta_updatesHopsAndExpiresPaths() =
+        runTest {
+            dao.applyDelta(reset = true, upserts = entries(0 until 10), expired = emptyList())
+
+            dao.applyDelta(
+                reset = false,
+                upserts = listOf(PathTableEntryEntity(hash(3), hops = 12, updatedAt = 1L)),
+                expired = listOf(hash(0), hash(1)),
+            )
+
+            assertEquals(8, dao.count())
+            assertEquals(12, dao.getHops(hash(3)))
+            assertNull(dao.getHops(hash(0)))
+        }
+
+    @Test
+    fun applyDelta_expiresMoreHashesThanTheBindLimit() =
+        runTest {
+            dao.applyDelta(reset = true, upserts = entries(0 until 20_000), expired = emptyList())
+
+            // 5k expirations in one delta would overflow a single IN (...)
+            dao.applyDelta(reset = false, upserts = emptyList(), expired = (0 until 5_000).map { hash(it) })
+
+            assertEquals(15_000, dao.count())
+        }
+
+    // ========== Reachable Count Tests ==========
+
+    @Test
+    fun observeReachableAnnounceCount_countsOnlyPeersAndNodesWithPaths() =
+        runTest {
+            announceDao.upsertAnnounce(createTestAnnounce(hash(1), "PEER"))
+            announceDao.upsertAnnounce(createTestAnnounce(hash(2), "NODE"))
+            announceDao.upsertAnnounce(createTestAnnounce(hash(3), "PROPAGATION_NODE"))
+            announceDao.upsertAnnounce(createTestAnnounce(hash(4), "PEER"))
+            dao.applyDelta(reset = true, upserts = entries(1..3), expired = emptyList())
+
+            announceDao.observeReachableAnnounceCount().test {
+                assertEquals(2, awaitItem())
+                cancelAndIgnoreRemainingEvents()
+            }
+        }
+
+    @Test
+    fun observeReachableAnnounceCount_followsDeltasAt20kPaths() =
+        runTest {
+            repeat(20_000) { announceDao.upsertAnnounce(createTestAnnounce(hash(it))) }
+            val start = System.nanoTime()
+            dao.applyDelta(reset = true, upserts = entries(0 until 20_000), expired = emptyList())
+            val resetMs = (System.nanoTime() - start) / 1_000_000
+
+            announceDao.observeReachableAnnounceCount().test {
+                val queryStart = System.nanoTime()
+                assertEquals(20_000, awaitItem())
+                val queryMs = (System.nanoTime() - queryStart) / 1_000_000
+                println("Reset 20k paths in ${resetMs}ms; reachable count query in ${queryMs}ms")
+
+                dao.applyDelta(reset = false, upserts = emptyList(), expired = (0 until 2_000).map { hash(it) })
+                assertEquals(18_000, awaitItem())
+
+                // Paths to destinations we have no announce for don't count
+                dao.applyDelta(reset = false, upserts = entries(30_000 until 31_000), expired = emptyList())
+                assertEquals(18_000, awaitItem())
+
+                cancelAndIgnoreRemainingEvents()
+            }
+        }
+}
@@ -0,0 +1,272 @@
+package network.columba.app.data.db.dao
+
+import android.app.Application
+import android.content.Context
+import androidx.paging.PagingSource
+import androidx.room.Room
+import androidx.test.core.app.ApplicationProvider
+import app.cash.turbine.test
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.ConversationEntity
+import network.columba.app.data.db.entity.LocalIdentityEntity
+import network.columba.app.data.db.entity.MessageEntity
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.test.runTest
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotEquals
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.robolectric.RobolectricTestRunner
+import org.robolectric.annotation.Config
+import kotlin.system.measureTimeMillis
+
+/**
+ * Tests for ReactionDao and the reaction aggregate on the message-list queries.
+ * Validates idempotent inserts, aggregation, cleanup, the v2 → v3 backfill,
+ * and that a reaction storm never rewrites or invalidates the message rows.
+ */
+@RunWith(RobolectricTestRunner::class)
+@Config(sdk = [34], application = Application::class)
+class ReactionDaoTest {
+    private lateinit var database: ColumbaDatabase
+    private lateinit var reactionDao: ReactionDao
+    private lateinit var messageDao: MessageDao
+
+    companion object {
+        private const val IDENTITY_HASH = "identity_hash_12345678901234567"
+        private const val PEER_HASH = "peer_hash_123456789012345678901"
+        private const val DEST_HASH = "dest_hash_123456789012345678901"
+        private const val MESSAGE_ID = "target_msg"
+        private const val STORM_EVENTS = 1000
+        private const val STORM_SENDERS = 50
+        private val STORM_EMOJIS = listOf("👍", "❤️", "😂", "🎉", "🔥")
+    }
+
+    @Before
+    fun setup() {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        database =
+            Room
+                .inMemoryDatabaseBuilder(context, ColumbaDatabase::class.java)
+                .allowMainThreadQueries()
+                .build()
+        reactionDao = database.reactionDao()
+        messageDao = database.messageDao()
+
+        runTest {
+            database.localIdentityDao().insert(
+                LocalIdentityEntity(
+                    identityHash = IDENTITY_HASH,
+                    displayName = "Test Identity",
+                    destinationHash = DEST_HASH,
+                    filePath = "/test/identity.key",
+                    keyData = null,
+                    createdTimestamp = 0L,
+                    lastUsedTimestamp = 0L,
+                    isActive = true,
+                ),
+            )
+            database.conversationDao().insertConversation(
+                ConversationEntity(
+                    peerHash = PEER_HASH,
+                    identityHash = IDENTITY_HASH,
+                    peerName = "Test Peer",
+                    lastMessage = "Hello",
+                    lastMessageTimestamp = 0L,
+                    unreadCount = 0,
+                ),
+            )
+            messageDao.insertMessage(createTestMessage(MESSAGE_ID))
+        }
+    }
+
+    @After
+    fun teardown() {
+        database.close()
+    }
+
+    private fun createTestMessage(
+        id: String,
+        timestamp: Long = 1000L,
+        reactionsJson: String? = null,
+    ) = MessageEntity(
+        id = id,
+        conversationHash = PEER_HASH,
+        identityHash = IDENTITY_HASH,
+        content = "Hello",
+        timestamp = timestamp,
+        isFromMe = true,
+        reactionsJson = reactionsJson,
+    )
+
+    private suspend fun react(
+        emoji: String,
+        sender: String,
+        timestamp: Long = 0L,
+        messageId: String = MESSAGE_ID,
+    ) = reactionDao.insertReaction(messageId, IDENTITY_HASH, emoji, sender, timestamp)
+
+    private suspend fun aggregateFor(messageId: String = MESSAGE_ID): MessageWithReactions =
+        messageDao
+            .getMessagesForConversation(PEER_HASH, IDENTITY_HASH)
+            .first()
+            .single { it.message.id == messageId }
+
+    // ========== Insert Tests ==========
+
+    @Test
+    fun insertReaction_isIdempotentPerEmojiAndSender() =
+        runTest {
+            assertNotEquals(-1L, react("👍", "sender1"))
+            assertEquals(-1L, react("👍", "sender1", timestamp = 99L))
+            assertNotEquals(-1L, react("❤️", "sender1"))
+
+            val aggregate = aggregateFor()
+            assertEquals(2, aggregate.reactionCount)
+            assertEquals(mapOf("👍" to listOf("sender1"), "❤️" to listOf("sender1")), aggregate.reactionsByEmoji())
+        }
+
+    @Test
+    fun insertReaction_ignoresUnknownTargetMessage() =
+        runTest {
+            assertEquals(-1L, react("👍", "sender1", messageId = "missing_msg"))
+            assertTrue(reactionDao.getAllReactionsForIdentity(IDENTITY_HASH).isEmpty())
+        }
+
+    // ========== Aggregate Tests ==========
+
+    @Test
+    fun aggregate_isEmptyForMessagesWithoutReactions() =
+        runTest {
+            val aggregate = aggregateFor()
+            assertEquals(0, aggregate.reactionCount)
+            assertNull(aggregate.reactionEntries)
+            assertTrue(aggregate.reactionsByEmoji().isEmpty())
+        }
+
+    @Test
+    fun aggregate_ordersEmojisByFirstReactionAndSendersByTime() =
+        runTest {
+            react("❤️", "sender2", timestamp = 20L)
+            react("👍", "sender3", timestamp = 30L)
+            react("❤️", "sender1", timestamp = 10L)
+
+            val reactions = aggregateFor().reactionsByEmoji()
+            assertEquals(listOf("❤️", "👍"), reactions.keys.toList())
+            assertEquals(listOf("sender1", "sender2"), reactions["❤️"])
+        }
+
+    @Test
+    fun aggregate_isScopedToItsOwnMessage() =
+        runTest {
+            messageDao.insertMessage(createTestMessage("other_msg", timestamp = 2000L))
+            react("👍", "sender1")
+            react("👍", "sender2", messageId = "other_msg")
+
+            assertEquals(listOf("sender1"), aggregateFor().reactionsByEmoji()["👍"])
+            assertEquals(listOf("sender2"), aggregateFor("other_msg").reactionsByEmoji()["👍"])
+        }
+
+    @Test
+    fun pagedQueries_includeAggregate() =
+        runTest {
+            react("👍", "sender1")
+
+            val result =
+                messageDao.getMessagesForConversationPaged(PEER_HASH, IDENTITY_HASH).load(
+                    PagingSource.LoadParams.Refresh(key = null, loadSize = 10, placeholdersEnabled = false),
+                ) as PagingSource.LoadResult.Page
+            assertEquals(1, result.data.single().reactionCount)
+        }
+
+    // ========== Reaction Storm ==========
+
+    @Test
+    fun reactionStorm_collapsesDuplicatesWithoutTouchingMessageRow() =
+        runTest {
+            val before = messageDao.getMessageById(MESSAGE_ID, IDENTITY_HASH)
+
+            messageDao.observeMessageById(MESSAGE_ID).test {
+                awaitItem()
+
+                var inserted = 0
+                val elapsedMs =
+                    measureTimeMillis {
+                        // 1000 events over 50 senders x 5 emojis: each pair arrives 4 times
+                        repeat(STORM_EVENTS) { i ->
+                            val sender = "sender_%02d".format(i % STORM_SENDERS)
+                            val emoji = STORM_EMOJIS[(i / STORM_SENDERS) % STORM_EMOJIS.size]
+                            if (react(emoji, sender, timestamp = i.toLong()) != -1L) inserted++
+                        }
+                    }
+                println("Reaction storm: $STORM_EVENTS events, $inserted rows in ${elapsedMs}ms")
+
+                val distinct = STORM_SENDERS * STORM_EMOJIS.size
+                assertEquals(distinct, inserted)
+
+                // Only `reactions` was written, so a messages-only observer stays quiet
+                expectNoEvents()
+                cancelAndIgnoreRemainingEvents()
+
+                val aggregate = aggregateFor()
+                assertEquals(distinct, aggregate.reactionCount)
+                val reactions = aggregate.reactionsByEmoji()
+                assertEquals(STORM_EMOJIS, reactions.keys.toList())
+                reactions.values.forEach { assertEquals(STORM_SENDERS, it.size) }
+            }
+
+            assertEquals(before, messageDao.getMessageById(MESSAGE_ID, IDENTITY_HASH))
+        }
+
+    // ========== Cleanup Tests ==========
+
+    @Test
+    fun deleteOrphanedReactions_removesRowsForDeletedMessages() =
+        runTest {
+            messageDao.insertMessage(createTestMessage("other_msg"))
+            react("👍", "sender1")
+            react("👍", "sender1", messageId = "other_msg")
+
+            messageDao.deleteMessageById("other_msg", IDENTITY_HASH)
+
+            assertEquals(1, reactionDao.deleteOrphanedReactions(IDENTITY_HASH))
+            assertEquals(listOf(MESSAGE_ID), reactionDao.getAllReactionsForIdentity(IDENTITY_HASH).map { it.messageId })
+        }
+
+    @Test
+    fun messageReplace_keepsReactions() =
+        runTest {
+            react("👍", "sender1")
+
+            // REPLACE deletes and re-inserts the row; no FK means no cascade
+            messageDao.insertMessage(createTestMessage(MESSAGE_ID).copy(status = "delivered"))
+
+            assertEquals(1, aggregateFor().reactionCount)
+        }
+
+    // ========== Migration Backfill ==========
+
+    @Test
+    fun migration2To3_splitsExistingBlobsIntoRows() =
+        runTest {
+            messageDao.insertMessage(
+                createTestMessage("legacy_msg", timestamp = 5000L, reactionsJson = """{"👍": ["s1", "s2", "s1"], "❤️": ["s3"]}"""),
+            )
+            messageDao.insertMessage(createTestMessage("broken_msg", reactionsJson = "not json"))
+
+            ColumbaDatabase.MIGRATION_2_3.migrate(database.openHelper.writableDatabase)
+
+            val reactions = aggregateFor("legacy_msg").reactionsByEmoji()
+            assertEquals(listOf("s1", "s2"), reactions["👍"])
+            assertEquals(listOf("s3"), reactions["❤️"])
+            assertTrue(reactionDao.getAllReactionsForIdentity(IDENTITY_HASH).all { it.timestamp == 5000L })
+
+            // Blobs are cleared, malformed ones included
+            assertNull(messageDao.getMessageById("legacy_msg", IDENTITY_HASH)?.reactionsJson)
+            assertNull(messageDao.getMessageById("broken_msg", IDENTITY_HASH)?.reactionsJson)
+        }
+}
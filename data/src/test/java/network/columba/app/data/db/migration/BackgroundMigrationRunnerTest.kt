@@ -0,0 +1,240 @@
+package network.columba.app.data.db.migration
+
+import android.app.Application
+import android.content.Context
+import androidx.room.Room
+import androidx.sqlite.db.SupportSQLiteDatabase
+import androidx.test.core.app.ApplicationProvider
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.test.runTest
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.ConversationEntity
+import network.columba.app.data.db.entity.LocalIdentityEntity
+import network.columba.app.data.db.entity.MessageEntity
+import org.json.JSONObject
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.robolectric.RobolectricTestRunner
+import org.robolectric.annotation.Config
+import kotlin.system.measureTimeMillis
+
+/**
+ * Tests for BackgroundMigrationRunner with LegacyFieldReactionsMigration
+ * against a real in-memory Room database.
+ *
+ * The main case builds a 50k-message table, interrupts the migration once
+ * by crashing mid-chunk and once by cancellation, then resumes and checks
+ * every legacy row was migrated exactly once.
+ */
+@RunWith(RobolectricTestRunner::class)
+@Config(sdk = [34], application = Application::class)
+class BackgroundMigrationRunnerTest {
+    private lateinit var database: ColumbaDatabase
+
+    companion object {
+        private const val IDENTITY_HASH = "identity_hash_12345678901234567"
+        private const val PEER_HASH = "peer_hash_123456789012345678901"
+        private const val ROW_COUNT = 50_000
+        private const val LEGACY_EVERY = 10 // every 10th row carries fields[16].reactions
+        private const val LEGACY_ROWS = ROW_COUNT / LEGACY_EVERY
+        private const val SENDERS_PER_ROW = 2
+        private const val CHUNK_SIZE = 1_000
+    }
+
+    /** Delegates to [delegate] and reports each chunk after its writes, inside the transaction. */
+    private class ScriptedMigration(
+        private val delegate: BackgroundMigration,
+        private val afterChunk: (index: Int, limit: Int) -> Unit = { _, _ -> },
+    ) : BackgroundMigration by delegate {
+        var chunks = 0
+
+        override fun migrateChunk(
+            db: SupportSQLiteDatabase,
+            afterRowId: Long,
+            limit: Int,
+        ): Long? {
+            val lastRowId = delegate.migrateChunk(db, afterRowId, limit)
+            afterChunk(chunks++, limit)
+            return lastRowId
+        }
+    }
+
+    @Before
+    fun setup() {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        database =
+            Room
+                .inMemoryDatabaseBuilder(context, ColumbaDatabase::class.java)
+                .allowMainThreadQueries()
+                .build()
+
+        runBlocking {
+            database.localIdentityDao().insert(
+                LocalIdentityEntity(
+                    identityHash = IDENTITY_HASH,
+                    displayName = "Test Identity",
+                    destinationHash = "dest_hash_123456789012345678901",
+                    filePath = "/test/identity.key",
+                    keyData = null,
+                    createdTimestamp = 0L,
+                    lastUsedTimestamp = 0L,
+                    isActive = true,
+                ),
+            )
+            database.conversationDao().insertConversation(
+                ConversationEntity(
+                    peerHash = PEER_HASH,
+                    identityHash = IDENTITY_HASH,
+                    peerName = "Test Peer",
+                    lastMessage = "",
+                    lastMessageTimestamp = 0L,
+                    unreadCount = 0,
+                ),
+            )
+        }
+    }
+
+    @After
+    fun teardown() {
+        database.close()
+    }
+
+    private suspend fun seedMessages(count: Int) {
+        (0 until count).chunked(CHUNK_SIZE).forEach { batch ->
+            database.messageDao().insertMessages(
+                batch.map { i ->
+                    val fieldsJson =
+                        if (i % LEGACY_EVERY == 0) {
+                            """{"16": {"reactions": {"👍": ["a_$i", "b_$i"]}, "reply_to": "r_$i"}}"""
+                        } else {
+                            """{"1": "plain"}"""
+                        }
+                    MessageEntity(
+                        id = "msg_$i",
+                        conversationHash = PEER_HASH,
+                        identityHash = IDENTITY_HASH,
+                        content = "Message $i",
+                        timestamp = i.toLong(),
+                        isFromMe = false,
+                        fieldsJson = fieldsJson,
+                    )
+                },
+            )
+        }
+    }
+
+    private fun runner(migration: BackgroundMigration) =
+        BackgroundMigrationRunner(
+            database = database,
+            migrations = listOf(migration),
+            idleChunkSize = CHUNK_SIZE,
+            activeChunkSize = 10,
+            activePauseMs = 100L,
+        )
+
+    private fun reactionCount(): Int =
+        database.query("SELECT COUNT(*) FROM reactions", null).use {
+            it.moveToFirst()
+            it.getInt(0)
+        }
+
+    private fun legacyRowCount(): Int =
+        database.query("SELECT COUNT(*) FROM messages WHERE fieldsJson LIKE '%\"reactions\"%'", null).use {
+            it.moveToFirst()
+            it.getInt(0)
+        }
+
+    // ========== Interruption and Resume ==========
+
+    @Test
+    fun `50k rows migrate exactly once across a crash, a cancellation and a resume`() =
+        runBlocking {
+            seedMessages(ROW_COUNT)
+            val totalChunks = ROW_COUNT / CHUNK_SIZE + 1 // +1 for the final empty chunk
+
+            // 1. Crash inside the 4th chunk: its writes and marker roll back together
+            val crashing =
+                ScriptedMigration(LegacyFieldReactionsMigration()) { index, _ ->
+                    if (index == 3) throw IllegalStateException("simulated process death")
+                }
+            assertFalse(runner(crashing).runPending())
+
+            val afterCrash = database.backgroundMigrationDao().getProgress(LegacyFieldReactionsMigration.ID)
+            assertNotNull(afterCrash)
+            assertEquals(3L * CHUNK_SIZE, afterCrash!!.lastRowId)
+            assertNull(afterCrash.completedAt)
+            val committedLegacyRows = 3 * CHUNK_SIZE / LEGACY_EVERY
+            assertEquals(committedLegacyRows * SENDERS_PER_ROW, reactionCount())
+            assertEquals(LEGACY_ROWS - committedLegacyRows, legacyRowCount())
+
+            // 2. Cancel between chunks a few chunks later
+            lateinit var job: Job
+            val cancelling =
+                ScriptedMigration(LegacyFieldReactionsMigration()) { index, _ ->
+                    if (index == 4) job.cancel()
+                }
+            job = launch { runner(cancelling).runPending() }
+            job.join()
+            assertEquals(5, cancelling.chunks)
+            assertEquals(LEGACY_ROWS - 8 * CHUNK_SIZE / LEGACY_EVERY, legacyRowCount())
+
+            // 3. Resume to completion from the persisted marker
+            val resuming = ScriptedMigration(LegacyFieldReactionsMigration())
+            val elapsedMs = measureTimeMillis { assertTrue(runner(resuming).runPending()) }
+            println("Background migration: resumed ${resuming.chunks} of $totalChunks chunks in ${elapsedMs}ms")
+
+            assertEquals(totalChunks - 8, resuming.chunks)
+            assertEquals(LEGACY_ROWS * SENDERS_PER_ROW, reactionCount())
+            assertEquals(0, legacyRowCount())
+            assertTrue(database.backgroundMigrationDao().isCompleted(LegacyFieldReactionsMigration.ID))
+
+            // Other field-16 keys survive the strip
+            val migrated = database.messageDao().getMessageById("msg_40", IDENTITY_HASH)!!
+            assertEquals("r_40", JSONObject(migrated.fieldsJson!!).getJSONObject("16").getString("reply_to"))
+        }
+
+    @Test
+    fun `completed migration is not run again`() =
+        runBlocking {
+            seedMessages(100)
+            assertTrue(runner(LegacyFieldReactionsMigration()).runPending())
+
+            val again = ScriptedMigration(LegacyFieldReactionsMigration())
+            assertTrue(runner(again).runPending())
+            assertEquals(0, again.chunks)
+        }
+
+    // ========== Throttling ==========
+
+    @Test
+    fun `uses small chunks while the UI is active`() =
+        runTest {
+            seedMessages(100)
+            val limits = mutableListOf<Int>()
+            val recording = ScriptedMigration(LegacyFieldReactionsMigration()) { _, limit -> limits.add(limit) }
+
+            var uiActive = true
+            assertTrue(
+                runner(recording).runPending(
+                    isUiActive = {
+                        // Backgrounded after the first few chunks
+                        if (limits.size == 3) uiActive = false
+                        uiActive
+                    },
+                ),
+            )
+
+            assertEquals(listOf(10, 10, 10), limits.take(3))
+            assertTrue(limits.drop(3).all { it == CHUNK_SIZE })
+            assertEquals(0, legacyRowCount())
+        }
+}
@@ -14,6 +14,7 @@ import network.columba.app.rns.api.model.LinkSpeedProbeResult
 import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.ReceivedPacket
 import network.columba.app.rns.api.model.ReticulumConfig
 
@@ -158,8 +159,21 @@ interface RnsCore {
      */
     suspend fun getNextHopInterfaceName(destinationHash: ByteArray): String?
 
+    /**
+     * Every destination hash in the path table, as hex. Sends the whole
+     * table; prefer [observePathTable] for anything that tracks it.
+     */
     suspend fun getPathTableHashes(): List<String>
 
+    /**
+     * Path-table changes as [PathTableDelta] batches: a reset snapshot of
+     * the current table on collection, then added / updated / expired
+     * paths as they change. Neither backend has a path-table listener, so
+     * changes are found by diffing inside the backend and only the deltas
+     * cross the process boundary.
+     */
+    fun observePathTable(): Flow<PathTableDelta>
+
     /**
      * Probe link speed to a destination by checking existing links or sending
      * an empty LXMF message to establish one.
@@ -89,6 +89,23 @@ interface RnsTelemetry {
         iconAppearance: IconAppearance? = null,
     ): Result<Unit>
 
+    /**
+     * Binary variant of [storeOwnTelemetry]: [packedTelemetry] is already
+     * in the `FIELD_TELEMETRY` wire format (`TelemeterCodec.packLocationTelemetry`),
+     * so it crosses IPC and lands in the collector store without a JSON
+     * round trip.
+     *
+     * @param packedTelemetry Telemeter msgpack bytes
+     * @param timestampSeconds Capture time of the location, epoch seconds
+     * @param iconAppearance Optional icon appearance for the host
+     * @return Result indicating success
+     */
+    suspend fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance? = null,
+    ): Result<Unit>
+
     /**
      * Set the list of identity hashes allowed to request telemetry in host mode.
      *
@@ -1,10 +1,12 @@
 package network.columba.app.rns.api
 
+import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.SharedFlow
 import network.columba.app.rns.api.model.BatteryProfile
 import network.columba.app.rns.api.model.DiscoveredInterface
 import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 
 /**
  * Interface management, battery profile tuning, RNode control, BLE
@@ -121,6 +123,15 @@ interface RnsTransportAdmin {
      */
     suspend fun getInterfaceStats(interfaceName: String): Map<String, Any>?
 
+    /**
+     * Statistics for every interface, emitted at the backend's sampling
+     * cadence (about once a second). Rates and the RSSI / SNR history are
+     * computed inside the backend; see [InterfaceStatsSnapshot]. Sampling
+     * runs only while the flow is collected, and concurrent collectors
+     * share one sampler (and, across processes, one IPC subscription).
+     */
+    fun observeInterfaceStats(): Flow<List<InterfaceStatsSnapshot>>
+
     // ==================== RNode ====================
 
     /**
@@ -0,0 +1,35 @@
+package network.columba.app.rns.api.model
+
+import android.os.Parcelable
+import kotlinx.parcelize.Parcelize
+
+/**
+ * One interface's statistics at one sample (observed via
+ * [RnsTransportAdmin.observeInterfaceStats]).
+ *
+ * Rates are bytes per second over the previous sample interval, computed
+ * inside the backend from the rx/tx counters; they are 0 on the first
+ * sample and when a counter goes backwards (interface restarted).
+ *
+ * The history lists are the most recent samples, oldest first, so a chart
+ * can draw immediately without asking again. A sample with no RSSI / SNR
+ * reading is `NaN` in [rssiHistory] / [snrHistory].
+ */
+@Parcelize
+data class InterfaceStatsSnapshot(
+    val name: String,
+    val online: Boolean,
+    val rxBytes: Long,
+    val txBytes: Long,
+    val rxRate: Long = 0,
+    val txRate: Long = 0,
+    /** Last RSSI in dBm, if the interface reports one (RNode). */
+    val rssi: Int? = null,
+    /** Last SNR in dB, if the interface reports one (RNode). */
+    val snr: Float? = null,
+    val timestampMs: Long = 0,
+    val rxRateHistory: List<Float> = emptyList(),
+    val txRateHistory: List<Float> = emptyList(),
+    val rssiHistory: List<Float> = emptyList(),
+    val snrHistory: List<Float> = emptyList(),
+) : Parcelable
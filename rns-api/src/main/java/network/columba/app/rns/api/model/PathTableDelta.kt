@@ -0,0 +1,31 @@
+package network.columba.app.rns.api.model
+
+import android.os.Parcelable
+import kotlinx.parcelize.Parcelize
+
+/**
+ * One batch of path-table changes (observed via [RnsCore.observePathTable]),
+ * keyed by lowercase destination-hash hex.
+ *
+ * A subscription starts with the current table as one or more batches of
+ * [added] paths, the first of which has [reset] set: the receiver drops
+ * whatever it mirrored before applying it. Every batch of that snapshot but
+ * the last has [partial] set, so the receiver can apply the whole reset at
+ * once. Later batches only carry changes. Large batches are split so no
+ * single one approaches the Binder transaction limit.
+ */
+@Parcelize
+data class PathTableDelta(
+    val reset: Boolean = false,
+    /** More batches of the current reset snapshot follow this one. */
+    val partial: Boolean = false,
+    /** New paths: destination hash → hops. */
+    val added: Map<String, Int> = emptyMap(),
+    /** Known paths whose hop count changed. */
+    val updated: Map<String, Int> = emptyMap(),
+    /** Paths that expired or were dropped. */
+    val expired: List<String> = emptyList(),
+) : Parcelable {
+    val isEmpty: Boolean
+        get() = !reset && added.isEmpty() && updated.isEmpty() && expired.isEmpty()
+}
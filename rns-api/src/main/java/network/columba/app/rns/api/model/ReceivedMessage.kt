@@ -33,4 +33,14 @@ data class ReceivedMessage(
     // Mirrors the string vocabulary already used for outbound on
     // `MessageEntity.deliveryMethod` and `MessageDetailScreen.getDeliveryMethodInfo`.
     val deliveryMethod: String? = null,
+    // Set by the :reticulum service, which owns inbound persistence. When
+    // [persisted] is true the message (and its conversation row) is already in
+    // the database and the UI only needs to notify; [isDuplicate] marks a
+    // replay of a message that was stored and read earlier (an unread replay
+    // is left unflagged so it notifies again), and [resolvedPeerName] is
+    // the conversation's display name at write time. Raw backend events leave
+    // all three at their defaults.
+    val persisted: Boolean = false,
+    val isDuplicate: Boolean = false,
+    val resolvedPeerName: String? = null,
 ) : Parcelable
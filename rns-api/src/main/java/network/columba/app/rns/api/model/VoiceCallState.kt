@@ -5,6 +5,15 @@ import kotlinx.parcelize.Parcelize
 
 /**
  * Voice call state from LXST.
+ *
+ * The quality fields describe inbound audio on an active call and are null
+ * when the backend doesn't measure them or no audio is flowing.
+ *
+ * @property lossPercent Share of recent playout slots with no frame on time
+ * @property jitterMs Smoothed packet arrival jitter
+ * @property bufferDepthMs Audio currently held in the playout buffer
+ * @property rttMs Call link round trip time
+ * @property mouthToEarMs Estimated one-way delay from the peer's microphone
  */
 @Parcelize
 data class VoiceCallState(
@@ -13,4 +22,9 @@ data class VoiceCallState(
     val isMuted: Boolean,
     val remoteIdentity: String?,
     val profile: String?,
+    val lossPercent: Float? = null,
+    val jitterMs: Float? = null,
+    val bufferDepthMs: Int? = null,
+    val rttMs: Long? = null,
+    val mouthToEarMs: Int? = null,
 ) : Parcelable
@@ -13,8 +13,24 @@ package network.columba.app.rns.api.util
  * in ~30 more call sites across `:rns-backend-kt` and `:rns-host`.
  */
 
-/** ByteArray -> lowercase hex string. e.g. `byteArrayOf(0x01, 0xab.toByte()).toHex() == "01ab"`. */
-fun ByteArray.toHex(): String = joinToString("") { "%02x".format(it) }
+private val HEX_DIGITS = "0123456789abcdef".toCharArray()
+
+/**
+ * ByteArray -> lowercase hex string. e.g. `byteArrayOf(0x01, 0xab.toByte()).toHex() == "01ab"`.
+ *
+ * Table lookup rather than `"%02x".format` per byte: this runs for every
+ * inbound message and announce, and `String.format` allocates a Formatter
+ * each call.
+ */
+fun ByteArray.toHex(): String {
+    val out = CharArray(size * 2)
+    for (i in indices) {
+        val v = this[i].toInt() and 0xff
+        out[i * 2] = HEX_DIGITS[v ushr 4]
+        out[i * 2 + 1] = HEX_DIGITS[v and 0x0f]
+    }
+    return String(out)
+}
 
 /**
  * Hex string -> ByteArray. Caller is responsible for the hex being even-length
@@ -0,0 +1,25 @@
+package network.columba.app.rns.api.util
+
+import kotlinx.coroutines.flow.MutableSharedFlow
+import kotlinx.coroutines.flow.SharedFlow
+import kotlinx.coroutines.flow.asSharedFlow
+
+/**
+ * Process-local hint that conditions for reconnecting interfaces just
+ * improved (network changed, hardware reattached), so any interface waiting
+ * out a recovery backoff should retry now.
+ *
+ * Fired by the `:reticulum` service's network monitor; consumed by the
+ * backend's interface supervisor in the same process. Lossy by design: a
+ * hint with no waiting collector is simply dropped.
+ */
+object InterfaceRetrySignal {
+    private val _events = MutableSharedFlow<String>(extraBufferCapacity = 8)
+
+    /** Reason strings, for logging only. */
+    val events: SharedFlow<String> = _events.asSharedFlow()
+
+    fun trigger(reason: String) {
+        _events.tryEmit(reason)
+    }
+}
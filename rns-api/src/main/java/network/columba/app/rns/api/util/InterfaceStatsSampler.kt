@@ -0,0 +1,148 @@
+package network.columba.app.rns.api.util
+
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.flow
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
+
+/**
+ * One raw reading of an interface, as a backend reports it: cumulative
+ * byte counters plus the radio's last RSSI / SNR where it has them.
+ */
+data class InterfaceCounters(
+    val name: String,
+    val online: Boolean,
+    val rxBytes: Long,
+    val txBytes: Long,
+    val rssi: Int? = null,
+    val snr: Float? = null,
+)
+
+/**
+ * Fixed-capacity float history; once full, each [add] overwrites the oldest
+ * value. Not thread-safe.
+ */
+class FloatRingBuffer(
+    val capacity: Int,
+) {
+    init {
+        require(capacity > 0) { "capacity must be positive" }
+    }
+
+    private val values = FloatArray(capacity)
+    private var start = 0
+
+    var size: Int = 0
+        private set
+
+    fun add(value: Float) {
+        values[(start + size) % capacity] = value
+        if (size < capacity) size++ else start = (start + 1) % capacity
+    }
+
+    /** Contents, oldest first. */
+    fun toList(): List<Float> = List(size) { values[(start + it) % capacity] }
+}
+
+/**
+ * Turns successive [InterfaceCounters] readings into [InterfaceStatsSnapshot]s:
+ * rx/tx rates from the counter deltas, and the last [historySize] rates and
+ * RSSI / SNR readings per interface. Interfaces missing from a reading are
+ * forgotten, so one that comes back starts a fresh history.
+ *
+ * Not thread-safe; one sampler per stream.
+ */
+class InterfaceStatsSampler(
+    private val historySize: Int = DEFAULT_HISTORY_SIZE,
+) {
+    companion object {
+        /** One minute at the default one-second cadence. */
+        const val DEFAULT_HISTORY_SIZE = 60
+    }
+
+    private inner class Track {
+        var lastRxBytes = -1L
+        var lastTxBytes = -1L
+        var lastAtMs = 0L
+        val rxRates = FloatRingBuffer(historySize)
+        val txRates = FloatRingBuffer(historySize)
+        val rssi = FloatRingBuffer(historySize)
+        val snr = FloatRingBuffer(historySize)
+    }
+
+    private val tracks = HashMap<String, Track>()
+
+    /** Snapshots for [readings], taken at [nowMs], in the same order. */
+    fun sample(
+        readings: List<InterfaceCounters>,
+        nowMs: Long,
+    ): List<InterfaceStatsSnapshot> {
+        tracks.keys.retainAll(readings.mapTo(HashSet()) { it.name })
+        return readings.map { reading ->
+            val track = tracks.getOrPut(reading.name) { Track() }
+            val elapsedMs = nowMs - track.lastAtMs
+            val rxRate = rate(track.lastRxBytes, reading.rxBytes, elapsedMs)
+            val txRate = rate(track.lastTxBytes, reading.txBytes, elapsedMs)
+            track.lastRxBytes = reading.rxBytes
+            track.lastTxBytes = reading.txBytes
+            track.lastAtMs = nowMs
+            track.rxRates.add(rxRate.toFloat())
+            track.txRates.add(txRate.toFloat())
+            track.rssi.add(reading.rssi?.toFloat() ?: Float.NaN)
+            track.snr.add(reading.snr ?: Float.NaN)
+
+            InterfaceStatsSnapshot(
+                name = reading.name,
+                online = reading.online,
+                rxBytes = reading.rxBytes,
+                txBytes = reading.txBytes,
+                rxRate = rxRate,
+                txRate = txRate,
+                rssi = reading.rssi,
+                snr = reading.snr,
+                timestampMs = nowMs,
+                rxRateHistory = track.rxRates.toList(),
+                txRateHistory = track.txRates.toList(),
+                rssiHistory = track.rssi.toList(),
+                snrHistory = track.snr.toList(),
+            )
+        }
+    }
+
+    // Bytes per second; 0 without a previous reading or when the counter went backwards
+    private fun rate(
+        previous: Long,
+        current: Long,
+        elapsedMs: Long,
+    ): Long {
+        if (previous < 0 || current < previous || elapsedMs <= 0) return 0
+        return (current - previous) * 1_000 / elapsedMs
+    }
+}
+
+/**
+ * Interface statistics from a backend that can only be read, not observed:
+ * read every interface's counters every [intervalMs] and emit the sampled
+ * snapshots. A failed reading skips that round rather than ending the flow.
+ */
+fun interfaceStatsSnapshots(
+    intervalMs: Long,
+    clock: () -> Long = System::currentTimeMillis,
+    read: suspend () -> List<InterfaceCounters>,
+): Flow<List<InterfaceStatsSnapshot>> =
+    flow {
+        val sampler = InterfaceStatsSampler()
+        while (true) {
+            val readings =
+                try {
+                    read()
+                } catch (e: CancellationException) {
+                    throw e
+                } catch (_: Exception) {
+                    null
+                }
+            if (readings != null) emit(sampler.sample(readings, clock()))
+            delay(intervalMs)
+        }
+    }
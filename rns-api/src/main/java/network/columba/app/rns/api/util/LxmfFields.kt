@@ -58,7 +58,7 @@ object LxmfFields {
      *     from the inbound LXMF message's source hash on receive.
      *
      * One reaction per LXMessage on the wire; the receiver aggregates
-     * per-target-message locally (the flat `reactionsJson` column) for UI
+     * per-target-message locally (the `reactions` table) for UI
      * rendering. Outbound writes this shape only; inbound parsing falls back
      * to the legacy [FIELD_REACTION_LEGACY] for un-upgraded Columba peers —
      * see `ReactionWireCodec`.
@@ -0,0 +1,90 @@
+package network.columba.app.rns.api.util
+
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.flow
+import network.columba.app.rns.api.model.PathTableDelta
+
+/**
+ * Turns successive path-table snapshots (destination hash hex → hops) into
+ * [PathTableDelta] batches. The first snapshot becomes a reset; after that
+ * only differences are reported. Batches hold at most [maxEntriesPerDelta]
+ * entries so a large transport node's table crosses IPC in pieces.
+ *
+ * Not thread-safe; one differ per subscription.
+ */
+class PathTableDiffer(
+    private val maxEntriesPerDelta: Int = DEFAULT_MAX_ENTRIES_PER_DELTA,
+) {
+    companion object {
+        const val DEFAULT_MAX_ENTRIES_PER_DELTA = 1_000
+    }
+
+    private var previous: Map<String, Int>? = null
+
+    /** Batches that bring the receiver from the last snapshot to [current]; empty if nothing changed. */
+    fun diff(current: Map<String, Int>): List<PathTableDelta> {
+        val last = previous
+        previous = current
+        if (last == null) {
+            val chunks = current.entries.chunked(maxEntriesPerDelta)
+            if (chunks.isEmpty()) return listOf(PathTableDelta(reset = true))
+            return chunks.mapIndexed { index, chunk ->
+                PathTableDelta(
+                    reset = index == 0,
+                    partial = index < chunks.lastIndex,
+                    added = chunk.associate { it.key to it.value },
+                )
+            }
+        }
+
+        val added = mutableMapOf<String, Int>()
+        val updated = mutableMapOf<String, Int>()
+        for ((hash, hops) in current) {
+            when (last[hash]) {
+                null -> added[hash] = hops
+                hops -> Unit
+                else -> updated[hash] = hops
+            }
+        }
+        val expired = last.keys.filterNot { it in current }
+
+        val batches = mutableListOf<PathTableDelta>()
+        added.entries.chunked(maxEntriesPerDelta).forEach { chunk ->
+            batches.add(PathTableDelta(added = chunk.associate { it.key to it.value }))
+        }
+        updated.entries.chunked(maxEntriesPerDelta).forEach { chunk ->
+            batches.add(PathTableDelta(updated = chunk.associate { it.key to it.value }))
+        }
+        expired.chunked(maxEntriesPerDelta).forEach { chunk ->
+            batches.add(PathTableDelta(expired = chunk))
+        }
+        return batches
+    }
+}
+
+/**
+ * Path-table deltas from a backend that can only be snapshotted: read the
+ * table every [intervalMs], emit what changed. A failed snapshot skips that
+ * round rather than ending the flow.
+ */
+fun pathTableDeltas(
+    intervalMs: Long,
+    snapshot: suspend () -> Map<String, Int>,
+): Flow<PathTableDelta> =
+    flow {
+        val differ = PathTableDiffer()
+        while (true) {
+            val current =
+                try {
+                    snapshot()
+                } catch (e: CancellationException) {
+                    throw e
+                } catch (_: Exception) {
+                    null
+                }
+            if (current != null) differ.diff(current).forEach { emit(it) }
+            delay(intervalMs)
+        }
+    }
@@ -32,8 +32,8 @@ import org.json.JSONObject
  * {"reaction_to": <hex>, "emoji": <unicode>, "sender": <hex>,
  *  "source_hash": <hex>, "timestamp": <ms>}
  * ```
- * The aggregation + DB storage (`reactionsJson` column) is unchanged by the
- * wire migration — only the encode/decode here moved.
+ * Local storage (one row per reaction in the `reactions` table) is
+ * independent of the wire format — only the encode/decode lives here.
  */
 object ReactionWireCodec {
     // Field-map JSON keys are the decimal string of the integer field id
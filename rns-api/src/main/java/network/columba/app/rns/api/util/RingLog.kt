@@ -0,0 +1,371 @@
+package network.columba.app.rns.api.util
+
+import android.util.Log
+import java.io.File
+import java.text.SimpleDateFormat
+import java.util.Date
+import java.util.Locale
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.Executors
+import java.util.concurrent.RejectedExecutionException
+import java.util.concurrent.ScheduledExecutorService
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicLong
+import java.util.concurrent.atomic.AtomicReferenceArray
+
+/**
+ * In-memory log for hot paths, readable by the bug reporter without spawning
+ * `logcat`.
+ *
+ * Messages are passed as lambdas and only built when the tag's level gate lets
+ * them through, so a disabled `d { "..." }` costs one map lookup. Accepted
+ * records go into a fixed-size lock-free ring; timestamps, thread ids and
+ * stack traces are only turned into text when someone reads the ring. Records
+ * at or above [logcatLevel] are also forwarded to logcat, so development
+ * workflow is unchanged.
+ *
+ * Each process has its own ring. After [attach], records at or above
+ * [persistLevel] are appended to `<dir>/<process>.log` (rolling to `.log.1`)
+ * shortly after a warning or error is logged, and on [flush] (crash, export);
+ * there is no periodic timer. [dump] merges the calling process's ring with
+ * the other processes' files, so the UI process sees `:reticulum` logs and
+ * vice versa.
+ *
+ * Cross-process coverage is therefore partial by design: another process's
+ * records below [persistLevel] (DEBUG by default) never leave its ring, and
+ * its records since the last warning are only visible once it flushes. Debug
+ * lines carry peer and message hashes, which is why they stay in memory.
+ *
+ * Level gates are per process and can be changed at any time with
+ * [setLevel] / [defaultLevel]. [defaultLevel] is INFO, so release builds
+ * don't build `d {}` / `v {}` messages; the app lowers it for debug builds.
+ */
+object RingLog {
+    /** Log levels, in increasing severity; [priority] is the `android.util.Log` constant. */
+    enum class Level(
+        val letter: Char,
+        val priority: Int,
+    ) {
+        VERBOSE('V', Log.VERBOSE),
+        DEBUG('D', Log.DEBUG),
+        INFO('I', Log.INFO),
+        WARN('W', Log.WARN),
+        ERROR('E', Log.ERROR),
+        ;
+
+        companion object {
+            fun fromLetter(letter: Char): Level? = entries.firstOrNull { it.letter == letter }
+        }
+    }
+
+    /** One accepted log call, kept unformatted until read. */
+    class Record(
+        val seq: Long,
+        val timeMs: Long,
+        val threadId: Long,
+        val level: Level,
+        val tag: String,
+        val message: String,
+        val throwable: Throwable?,
+    )
+
+    private const val TAG = "RingLog"
+    private const val CAPACITY = 4096 // power of two
+    private const val MASK = CAPACITY - 1L
+    private const val FLUSH_DELAY_MS = 2_000L // coalesces a burst of warnings into one write
+    private const val MAX_SEGMENT_BYTES = 256 * 1024L
+    private const val LOG_SUFFIX = ".log"
+    private val LINE_PATTERN = Regex("""^\S+ \S+\s+\d+\s+\d+ ([VDIWE]) """)
+
+    private val slots = AtomicReferenceArray<Record?>(CAPACITY)
+    private val cursor = AtomicLong(0)
+    private val tagLevels = ConcurrentHashMap<String, Level>()
+
+    /** Level for tags without an explicit [setLevel]. */
+    @Volatile
+    var defaultLevel: Level = Level.INFO
+
+    /** Records at or above this level are also written to logcat. */
+    @Volatile
+    var logcatLevel: Level = Level.VERBOSE
+
+    /** Records below this level stay in memory and are never written to the log files. */
+    @Volatile
+    var persistLevel: Level = Level.INFO
+
+    @Volatile
+    private var logDir: File? = null
+
+    @Volatile
+    private var processName: String = "main"
+
+    @Volatile
+    private var flusher: ScheduledExecutorService? = null
+    private val flushPending = AtomicBoolean(false)
+    private var flushedSeq = 0L
+
+    // ========== Gates ==========
+
+    /** Override the level for [tag]; null goes back to [defaultLevel]. */
+    fun setLevel(
+        tag: String,
+        level: Level?,
+    ) {
+        if (level == null) tagLevels.remove(tag) else tagLevels[tag] = level
+    }
+
+    fun levelFor(tag: String): Level = tagLevels[tag] ?: defaultLevel
+
+    fun isLoggable(
+        tag: String,
+        level: Level,
+    ): Boolean = level >= (if (tagLevels.isEmpty()) defaultLevel else levelFor(tag))
+
+    // ========== Logging ==========
+
+    inline fun v(
+        tag: String,
+        message: () -> String,
+    ) {
+        if (isLoggable(tag, Level.VERBOSE)) log(Level.VERBOSE, tag, message(), null)
+    }
+
+    inline fun d(
+        tag: String,
+        message: () -> String,
+    ) {
+        if (isLoggable(tag, Level.DEBUG)) log(Level.DEBUG, tag, message(), null)
+    }
+
+    inline fun i(
+        tag: String,
+        message: () -> String,
+    ) {
+        if (isLoggable(tag, Level.INFO)) log(Level.INFO, tag, message(), null)
+    }
+
+    inline fun w(
+        tag: String,
+        throwable: Throwable? = null,
+        message: () -> String,
+    ) {
+        if (isLoggable(tag, Level.WARN)) log(Level.WARN, tag, message(), throwable)
+    }
+
+    inline fun e(
+        tag: String,
+        throwable: Throwable? = null,
+        message: () -> String,
+    ) {
+        if (isLoggable(tag, Level.ERROR)) log(Level.ERROR, tag, message(), throwable)
+    }
+
+    /** Record an already-gated message. Prefer the inline level functions. */
+    fun log(
+        level: Level,
+        tag: String,
+        message: String,
+        throwable: Throwable?,
+    ) {
+        val seq = cursor.getAndIncrement()
+        slots.set((seq and MASK).toInt(), Record(seq, System.currentTimeMillis(), Thread.currentThread().id, level, tag, message, throwable))
+
+        if (level >= logcatLevel) {
+            if (throwable == null) {
+                Log.println(level.priority, tag, message)
+            } else {
+                Log.println(level.priority, tag, message + '\n' + Log.getStackTraceString(throwable))
+            }
+        }
+        if (level >= Level.WARN) scheduleFlush()
+    }
+
+    // ========== Reading ==========
+
+    /**
+     * Records still in this process's ring at or above [minLevel], oldest
+     * first, at most [maxRecords]. Records overwritten while reading are skipped.
+     */
+    fun snapshot(
+        minLevel: Level = Level.VERBOSE,
+        maxRecords: Int = CAPACITY,
+    ): List<Record> = recordsFrom(0L, cursor.get()).filter { it.level >= minLevel }.takeLast(maxRecords)
+
+    /**
+     * Recent log lines in logcat "threadtime" format, oldest first: this
+     * process's ring plus, when [includeOtherProcesses] and [attach] was
+     * called, what the other processes have flushed.
+     *
+     * Set [includeForwarded] to false when merging with this process's logcat
+     * output, to leave out records that were already forwarded there.
+     *
+     * Does file I/O for other processes; call off the main thread.
+     */
+    fun dump(
+        maxLines: Int = 500,
+        minLevel: Level = Level.DEBUG,
+        includeOtherProcesses: Boolean = true,
+        includeForwarded: Boolean = true,
+    ): String = dumpLines(maxLines, minLevel, includeOtherProcesses, includeForwarded).joinToString("\n")
+
+    /** [dump] as individual lines. */
+    fun dumpLines(
+        maxLines: Int = 500,
+        minLevel: Level = Level.DEBUG,
+        includeOtherProcesses: Boolean = true,
+        includeForwarded: Boolean = true,
+    ): List<String> {
+        val lines = ArrayList<String>()
+        val formatter = LineFormatter()
+        val forwardedFrom = logcatLevel
+        snapshot(minLevel)
+            .filter { includeForwarded || it.level < forwardedFrom }
+            .forEach { formatter.appendLines(it, lines) }
+
+        val dir = logDir
+        if (includeOtherProcesses && dir != null) {
+            lines.addAll(readOtherProcesses(dir, minLevel, maxLines))
+            // Lines start with "MM-dd HH:mm:ss.SSS"; stable sort keeps each record's lines together
+            lines.sortBy { it.take(18) }
+        }
+        return lines.takeLast(maxLines)
+    }
+
+    private fun recordsFrom(
+        fromSeq: Long,
+        end: Long,
+    ): List<Record> {
+        val start = maxOf(fromSeq, end - CAPACITY)
+        val records = ArrayList<Record>((end - start).toInt().coerceAtLeast(0))
+        for (seq in start until end) {
+            val record = slots.get((seq and MASK).toInt())
+            // A slot is empty until its writer finishes, or already holds a newer record
+            if (record != null && record.seq == seq) records.add(record)
+        }
+        return records
+    }
+
+    private fun readOtherProcesses(
+        dir: File,
+        minLevel: Level,
+        maxLines: Int,
+    ): List<String> {
+        val own = processName + LOG_SUFFIX
+        val files = dir.listFiles { file -> file.name.endsWith(LOG_SUFFIX) && file.name != own } ?: return emptyList()
+        return files.flatMap { current ->
+            val previous = File(dir, current.name + ".1")
+            val lines =
+                try {
+                    (if (previous.exists()) previous.readLines() else emptyList()) + current.readLines()
+                } catch (e: Exception) {
+                    Log.w(TAG, "Could not read ${current.name}: ${e.message}")
+                    emptyList()
+                }
+            lines.filter { line ->
+                val level = LINE_PATTERN.find(line)?.groupValues?.get(1)?.firstOrNull()?.let(Level::fromLetter)
+                level != null && level >= minLevel
+            }.takeLast(maxLines)
+        }
+    }
+
+    /** Formats records like `logcat -v threadtime`, one line per message line. */
+    private class LineFormatter {
+        private val time = SimpleDateFormat("MM-dd HH:mm:ss.SSS", Locale.US)
+        private val pid = android.os.Process.myPid()
+
+        fun appendLines(
+            record: Record,
+            out: MutableList<String>,
+        ) {
+            val prefix = "%s %5d %5d %c %s: ".format(Locale.US, time.format(Date(record.timeMs)), pid, record.threadId, record.level.letter, record.tag)
+            val text = if (record.throwable == null) record.message else record.message + '\n' + record.throwable.stackTraceToString()
+            text.lineSequence().forEach { out.add(prefix + it) }
+        }
+    }
+
+    // ========== Cross-process persistence ==========
+
+    /**
+     * Start persisting this process's records to `<dir>/<processName>.log` so
+     * other processes can read them, and read theirs in [dump].
+     * Call once per process, early in `Application.onCreate()`.
+     */
+    @Synchronized
+    fun attach(
+        dir: File,
+        processName: String,
+    ) {
+        if (flusher != null) return
+        dir.mkdirs()
+        this.processName = processName
+        logDir = dir
+        flusher =
+            Executors.newSingleThreadScheduledExecutor { runnable ->
+                Thread(runnable, "RingLog-flush").apply { isDaemon = true }
+            }
+    }
+
+    /** Flush once, [FLUSH_DELAY_MS] from now, unless a flush is already pending. */
+    private fun scheduleFlush() {
+        val executor = flusher ?: return
+        if (!flushPending.compareAndSet(false, true)) return
+        try {
+            executor.schedule(
+                {
+                    flushPending.set(false)
+                    flush()
+                },
+                FLUSH_DELAY_MS,
+                TimeUnit.MILLISECONDS,
+            )
+        } catch (e: RejectedExecutionException) {
+            flushPending.set(false) // detached meanwhile
+        }
+    }
+
+    /**
+     * Append records at or above [persistLevel] logged since the last flush
+     * to this process's file. Runs after warnings once attached; call directly
+     * before the process dies or before exporting logs.
+     */
+    @Synchronized
+    fun flush() {
+        val dir = logDir ?: return
+        val end = cursor.get()
+        if (end == flushedSeq) return
+        try {
+            val file = File(dir, processName + LOG_SUFFIX)
+            if (file.length() > MAX_SEGMENT_BYTES) {
+                file.renameTo(File(dir, file.name + ".1"))
+            }
+            val lines = ArrayList<String>()
+            val formatter = LineFormatter()
+            val minLevel = persistLevel
+            recordsFrom(flushedSeq, end)
+                .filter { it.level >= minLevel }
+                .forEach { formatter.appendLines(it, lines) }
+            if (lines.isNotEmpty()) file.appendText(lines.joinToString("\n", postfix = "\n"))
+            flushedSeq = end
+        } catch (e: Exception) {
+            Log.w(TAG, "Flush failed: ${e.message}")
+        }
+    }
+
+    /** Forget everything in this process's ring. For tests. */
+    @Synchronized
+    fun clear() {
+        for (i in 0 until CAPACITY) slots.set(i, null)
+        flushedSeq = cursor.get()
+    }
+
+    /** Stop flushing and detach from the log directory. For tests. */
+    @Synchronized
+    fun detach() {
+        flusher?.shutdownNow()
+        flusher = null
+        flushPending.set(false)
+        logDir = null
+        processName = "main"
+    }
+}
@@ -0,0 +1,131 @@
+package network.columba.app.rns.api.util
+
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.take
+import kotlinx.coroutines.flow.toList
+import kotlinx.coroutines.test.currentTime
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Unit tests for InterfaceStatsSampler, FloatRingBuffer and the polling
+ * [interfaceStatsSnapshots] flow.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class InterfaceStatsSamplerTest {
+    private fun counters(
+        rx: Long,
+        tx: Long = 0L,
+        name: String = "RNode",
+        rssi: Int? = null,
+        snr: Float? = null,
+    ) = InterfaceCounters(name = name, online = true, rxBytes = rx, txBytes = tx, rssi = rssi, snr = snr)
+
+    // ========== Ring Buffer Tests ==========
+
+    @Test
+    fun `ring buffer keeps the newest values oldest first`() {
+        val ring = FloatRingBuffer(3)
+
+        (1..5).forEach { ring.add(it.toFloat()) }
+
+        assertEquals(3, ring.size)
+        assertEquals(listOf(3f, 4f, 5f), ring.toList())
+    }
+
+    // ========== Rate Tests ==========
+
+    @Test
+    fun `rates come from counter deltas over elapsed time`() {
+        val sampler = InterfaceStatsSampler()
+
+        val first = sampler.sample(listOf(counters(rx = 1_000, tx = 100)), nowMs = 10_000).single()
+        val second = sampler.sample(listOf(counters(rx = 5_000, tx = 600)), nowMs = 12_000).single()
+
+        assertEquals(0L, first.rxRate)
+        assertEquals(2_000L, second.rxRate)
+        assertEquals(250L, second.txRate)
+        assertEquals(listOf(0f, 2_000f), second.rxRateHistory)
+    }
+
+    @Test
+    fun `counter reset reads as zero rate instead of negative`() {
+        val sampler = InterfaceStatsSampler()
+        sampler.sample(listOf(counters(rx = 50_000)), nowMs = 0)
+
+        val afterRestart = sampler.sample(listOf(counters(rx = 200)), nowMs = 1_000).single()
+        val next = sampler.sample(listOf(counters(rx = 1_200)), nowMs = 2_000).single()
+
+        assertEquals(0L, afterRestart.rxRate)
+        assertEquals(1_000L, next.rxRate)
+    }
+
+    @Test
+    fun `history is bounded and marks missing radio readings as NaN`() {
+        val sampler = InterfaceStatsSampler(historySize = 4)
+
+        var last = sampler.sample(listOf(counters(rx = 0, rssi = -90, snr = 4f)), nowMs = 0).single()
+        (1..9).forEach { i ->
+            val reading = if (i % 2 == 0) counters(rx = i * 100L, rssi = -90 + i) else counters(rx = i * 100L)
+            last = sampler.sample(listOf(reading), nowMs = i * 1_000L).single()
+        }
+
+        assertEquals(4, last.rxRateHistory.size)
+        assertTrue(last.rxRateHistory.all { it == 100f })
+        assertEquals(4, last.rssiHistory.size)
+        assertEquals(-84f, last.rssiHistory[0])
+        assertTrue(last.rssiHistory[1].isNaN())
+        assertTrue(last.snrHistory.all { it.isNaN() })
+    }
+
+    @Test
+    fun `interface that disappears starts a fresh history when it returns`() {
+        val sampler = InterfaceStatsSampler()
+        sampler.sample(listOf(counters(rx = 0), counters(rx = 0, name = "TCP")), nowMs = 0)
+        sampler.sample(listOf(counters(rx = 100)), nowMs = 1_000)
+
+        val back = sampler.sample(listOf(counters(rx = 200), counters(rx = 900, name = "TCP")), nowMs = 2_000)
+
+        assertEquals(listOf("RNode", "TCP"), back.map { it.name })
+        assertEquals(3, back[0].rxRateHistory.size)
+        assertEquals(listOf(0f), back[1].rxRateHistory)
+    }
+
+    // ========== Flow Tests ==========
+
+    @Test
+    fun `polling flow skips failed readings and keeps its sampler`() =
+        runTest {
+            val readings =
+                ArrayDeque<() -> List<InterfaceCounters>>().apply {
+                    add { listOf(counters(rx = 0)) }
+                    add { error("reticulum not ready") }
+                    add { listOf(counters(rx = 4_000)) }
+                }
+
+            val samples =
+                interfaceStatsSnapshots(intervalMs = 1_000L, clock = { currentTime }) {
+                    readings.removeFirst()()
+                }.take(2).toList()
+
+            assertEquals(listOf(0L, 2_000L), samples.map { it.single().rxRate })
+        }
+
+    @Test
+    fun `sampling many interfaces stays cheap`() {
+        val sampler = InterfaceStatsSampler()
+        val names = (0 until 50).map { "iface$it" }
+
+        val start = System.nanoTime()
+        repeat(600) { tick ->
+            sampler.sample(names.map { counters(rx = tick * 1_000L, name = it) }, nowMs = tick * 1_000L)
+        }
+        val elapsedMs = (System.nanoTime() - start) / 1_000_000
+        println("Sampled 50 interfaces × 600 ticks in ${elapsedMs}ms")
+
+        val last = sampler.sample(names.map { counters(rx = 600_000L, name = it) }, nowMs = 600_000L)
+        assertTrue(last.all { it.rxRate == 1_000L && it.rxRateHistory.size == InterfaceStatsSampler.DEFAULT_HISTORY_SIZE })
+    }
+}
@@ -0,0 +1,131 @@
+package network.columba.app.rns.api.util
+
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.take
+import kotlinx.coroutines.flow.toList
+import kotlinx.coroutines.test.runTest
+import network.columba.app.rns.api.model.PathTableDelta
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Unit tests for PathTableDiffer and the snapshot-polling [pathTableDeltas] flow.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class PathTableDifferTest {
+    private fun hash(index: Int): String = "%032x".format(index)
+
+    private fun table(
+        count: Int,
+        hops: (Int) -> Int = { 1 + it % 8 },
+    ): Map<String, Int> = (0 until count).associate { hash(it) to hops(it) }
+
+    /** Replays [deltas] onto a map the way a mirror would. */
+    private fun MutableMap<String, Int>.replay(deltas: List<PathTableDelta>) {
+        deltas.forEach { delta ->
+            if (delta.reset) clear()
+            putAll(delta.added)
+            putAll(delta.updated)
+            delta.expired.forEach { remove(it) }
+        }
+    }
+
+    // ========== Snapshot Tests ==========
+
+    @Test
+    fun `first snapshot is a reset split into bounded batches`() {
+        val differ = PathTableDiffer(maxEntriesPerDelta = 1_000)
+
+        val batches = differ.diff(table(20_000))
+
+        assertEquals(20, batches.size)
+        assertTrue(batches.first().reset)
+        assertTrue(batches.drop(1).none { it.reset })
+        // Only the last batch closes the reset
+        assertTrue(batches.dropLast(1).all { it.partial })
+        assertFalse(batches.last().partial)
+        assertTrue(batches.all { it.added.size <= 1_000 })
+        assertEquals(table(20_000), mutableMapOf<String, Int>().apply { replay(batches) })
+    }
+
+    @Test
+    fun `empty first snapshot still resets the receiver`() {
+        val batches = PathTableDiffer().diff(emptyMap())
+
+        assertEquals(listOf(PathTableDelta(reset = true)), batches)
+    }
+
+    // ========== Delta Tests ==========
+
+    @Test
+    fun `later snapshots report only added, updated and expired paths`() {
+        val differ = PathTableDiffer()
+        differ.diff(mapOf(hash(1) to 1, hash(2) to 2, hash(3) to 3))
+
+        val batches = differ.diff(mapOf(hash(1) to 1, hash(2) to 4, hash(4) to 1))
+
+        assertEquals(
+            listOf(
+                PathTableDelta(added = mapOf(hash(4) to 1)),
+                PathTableDelta(updated = mapOf(hash(2) to 4)),
+                PathTableDelta(expired = listOf(hash(3))),
+            ),
+            batches,
+        )
+        assertFalse(batches.any { it.reset })
+    }
+
+    @Test
+    fun `unchanged snapshot produces nothing`() {
+        val differ = PathTableDiffer()
+        differ.diff(table(500))
+
+        assertTrue(differ.diff(table(500)).isEmpty())
+    }
+
+    @Test
+    fun `mirror converges on a churning 20k path table`() {
+        val differ = PathTableDiffer()
+        val mirror = mutableMapOf<String, Int>()
+        mirror.replay(differ.diff(table(20_000)))
+
+        // Drop the first 2k, re-route every 10th, add 3k new
+        val next =
+            (2_000 until 23_000).associate { i ->
+                hash(i) to if (i % 10 == 0) 9 else 1 + i % 8
+            }
+        val batches = differ.diff(next)
+        mirror.replay(batches)
+
+        assertEquals(next, mirror)
+        assertEquals(3_000, batches.sumOf { it.added.size })
+        assertEquals(2_000, batches.sumOf { it.expired.size })
+        assertFalse(batches.any { it.partial })
+    }
+
+    // ========== Flow Tests ==========
+
+    @Test
+    fun `polling flow skips failed snapshots and emits only changes`() =
+        runTest {
+            val snapshots =
+                ArrayDeque<() -> Map<String, Int>>().apply {
+                    add { mapOf(hash(1) to 1) }
+                    add { error("transport not ready") }
+                    add { mapOf(hash(1) to 1) }
+                    add { mapOf(hash(1) to 1, hash(2) to 2) }
+                }
+
+            val deltas = pathTableDeltas(intervalMs = 1_000L) { snapshots.removeFirst()() }.take(2).toList()
+
+            assertEquals(
+                listOf(
+                    PathTableDelta(reset = true, added = mapOf(hash(1) to 1)),
+                    PathTableDelta(added = mapOf(hash(2) to 2)),
+                ),
+                deltas,
+            )
+        }
+}
@@ -0,0 +1,192 @@
+package network.columba.app.rns.api.util
+
+import android.app.Application
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.rules.TemporaryFolder
+import org.junit.runner.RunWith
+import org.robolectric.RobolectricTestRunner
+import org.robolectric.annotation.Config
+import java.io.File
+import kotlin.concurrent.thread
+
+/**
+ * Tests for [RingLog]: level gates, the lock-free ring, formatting, and the
+ * per-process files that let one process read the other's records.
+ *
+ * Robolectric because forwarded records go through `android.util.Log`.
+ */
+@RunWith(RobolectricTestRunner::class)
+@Config(sdk = [34], application = Application::class)
+class RingLogTest {
+    @get:Rule
+    val tempDir = TemporaryFolder()
+
+    @Before
+    fun setup() {
+        RingLog.clear()
+        RingLog.defaultLevel = RingLog.Level.DEBUG
+    }
+
+    @After
+    fun tearDown() {
+        RingLog.detach()
+        RingLog.clear()
+        RingLog.defaultLevel = RingLog.Level.INFO
+        RingLog.logcatLevel = RingLog.Level.VERBOSE
+        RingLog.persistLevel = RingLog.Level.INFO
+        listOf("Quiet", "Loud", "Bench").forEach { RingLog.setLevel(it, null) }
+    }
+
+    // ========== Gate Tests ==========
+
+    @Test
+    fun `gated out messages are never built`() {
+        var built = 0
+        RingLog.v("Test") { built++; "verbose" }
+        RingLog.d("Test") { built++; "debug" }
+
+        assertEquals(1, built)
+        assertEquals(listOf("debug"), RingLog.snapshot().map { it.message })
+    }
+
+    @Test
+    fun `per tag levels change at runtime`() {
+        RingLog.setLevel("Quiet", RingLog.Level.WARN)
+        RingLog.setLevel("Loud", RingLog.Level.VERBOSE)
+
+        RingLog.i("Quiet") { "dropped" }
+        RingLog.w("Quiet") { "kept" }
+        RingLog.v("Loud") { "verbose kept" }
+
+        RingLog.setLevel("Quiet", null)
+        RingLog.d("Quiet") { "back to default" }
+
+        assertEquals(listOf("kept", "verbose kept", "back to default"), RingLog.snapshot().map { it.message })
+    }
+
+    // ========== Ring Tests ==========
+
+    @Test
+    fun `ring keeps the newest records in order`() {
+        repeat(5_000) { i -> RingLog.d("Test") { "m$i" } }
+
+        val records = RingLog.snapshot()
+        assertEquals(4096, records.size)
+        assertEquals("m904", records.first().message)
+        assertEquals("m4999", records.last().message)
+        assertEquals(records.map { it.seq }.sorted(), records.map { it.seq })
+    }
+
+    @Test
+    fun `concurrent writers lose nothing below capacity`() {
+        val writers =
+            List(4) { w ->
+                thread { repeat(500) { i -> RingLog.d("W$w") { "$w:$i" } } }
+            }
+        writers.forEach { it.join() }
+
+        val messages = RingLog.snapshot().map { it.message }
+        assertEquals(2_000, messages.size)
+        assertEquals(2_000, messages.toSet().size)
+        // Each writer's own records stay in its order
+        repeat(4) { w ->
+            assertEquals((0 until 500).map { "$w:$it" }, messages.filter { it.startsWith("$w:") })
+        }
+    }
+
+    @Test
+    fun `dump formats like logcat and filters by level`() {
+        RingLog.d("Tag") { "debug line" }
+        RingLog.e("Tag", IllegalStateException("boom")) { "failed" }
+
+        val errorsOnly = RingLog.dump(minLevel = RingLog.Level.ERROR).lines()
+
+        assertTrue(errorsOnly.first().matches(Regex("""\d\d-\d\d \d\d:\d\d:\d\d\.\d{3}\s+\d+\s+\d+ E Tag: failed""")))
+        assertTrue(errorsOnly.any { it.endsWith("java.lang.IllegalStateException: boom") })
+        assertFalse(errorsOnly.any { it.contains("debug line") })
+    }
+
+    // ========== Cross-process Tests ==========
+
+    @Test
+    fun `dump merges other processes' flushed logs`() {
+        val dir = tempDir.newFolder("logs")
+        File(dir, "reticulum.log").writeText(
+            "01-01 00:00:00.000  4242  4243 D Service: service debug\n" +
+                "01-01 00:00:00.001  4242  4243 V Service: service verbose\n",
+        )
+        RingLog.attach(dir, "main")
+        RingLog.d("App") { "app debug" }
+
+        val lines = RingLog.dump(minLevel = RingLog.Level.DEBUG).lines()
+
+        assertEquals(2, lines.size)
+        assertTrue(lines[0].endsWith("Service: service debug"))
+        assertTrue(lines[1].endsWith("App: app debug"))
+    }
+
+    @Test
+    fun `flush appends only new records to this process's file`() {
+        val dir = tempDir.newFolder("logs")
+        RingLog.attach(dir, "reticulum")
+
+        RingLog.i("Service") { "first" }
+        RingLog.flush()
+        RingLog.i("Service") { "second" }
+        RingLog.flush()
+        RingLog.flush()
+
+        val lines = File(dir, "reticulum.log").readLines()
+        assertEquals(2, lines.size)
+        assertTrue(lines[0].endsWith("I Service: first"))
+        assertTrue(lines[1].endsWith("I Service: second"))
+    }
+
+    @Test
+    fun `flush does not persist records below the persist level`() {
+        val dir = tempDir.newFolder("logs")
+        RingLog.attach(dir, "reticulum")
+
+        RingLog.d("Service") { "peer 0a1b2c debug" }
+        RingLog.i("Service") { "started" }
+        RingLog.flush()
+
+        val lines = File(dir, "reticulum.log").readLines()
+        assertEquals(1, lines.size)
+        assertTrue(lines[0].endsWith("I Service: started"))
+        // Still readable in-process
+        assertTrue(RingLog.dump().contains("peer 0a1b2c debug"))
+    }
+
+    @Test
+    fun `dump can leave out records already forwarded to logcat`() {
+        RingLog.logcatLevel = RingLog.Level.INFO
+        RingLog.d("Tag") { "ring only" }
+        RingLog.i("Tag") { "also in logcat" }
+
+        val lines = RingLog.dumpLines(includeForwarded = false)
+
+        assertEquals(1, lines.size)
+        assertTrue(lines[0].endsWith("D Tag: ring only"))
+    }
+
+    // ========== Hot Path ==========
+
+    @Test
+    fun `hot path logging under a gated tag never builds the message`() {
+        val address = "AA:BB:CC:DD:EE:FF"
+        var built = 0
+        RingLog.setLevel("Bench", RingLog.Level.INFO)
+
+        repeat(10_000) { i -> RingLog.d("Bench") { built++; "Fragment $i sent to $address" } }
+
+        assertEquals(0, built)
+        assertTrue(RingLog.snapshot().isEmpty())
+    }
+}
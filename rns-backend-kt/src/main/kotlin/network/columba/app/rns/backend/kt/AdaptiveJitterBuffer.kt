@@ -0,0 +1,275 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package network.columba.app.rns.backend.kt
+
+import kotlin.math.abs
+import kotlin.math.ceil
+
+/**
+ * Playout buffer for inbound LXST codec frames, sized from observed jitter.
+ *
+ * LXST frames carry no sequence numbers or timestamps, so arrivals are
+ * compared against the nominal frame cadence. Frames landing within half a
+ * frame time of each other count as one packet (a bundle, see
+ * [LxstFrameBundler]); the RFC 3550 jitter estimator runs on
+ * |inter-packet arrival - frames in the previous packet x frame time|. The
+ * playout delay target is one packet's worth of audio plus
+ * [JITTER_MULTIPLIER] times that jitter, clamped to [minDelayMs]..[maxDelayMs].
+ *
+ * Playout is driven by [poll] with the caller's clock, so the buffer is
+ * deterministic under test. A frame missing at its playout time is concealed
+ * by repeating the previous frame (up to [MAX_CONCEALED_FRAMES] in a row),
+ * after which playout stops and re-primes to the target delay; slots falling
+ * due while it re-primes count as lost. When the queue
+ * sits well above the target (e.g. after a burst), one frame per tick is shed
+ * so latency returns to the target.
+ *
+ * Not thread-safe; [CallPlayout] serialises access.
+ */
+internal class AdaptiveJitterBuffer(
+    private val minDelayMs: Int = MIN_DELAY_MS,
+    private val maxDelayMs: Int = MAX_DELAY_MS,
+) {
+    companion object {
+        const val MIN_DELAY_MS = 40
+        const val MAX_DELAY_MS = 1_500
+        const val MAX_CONCEALED_FRAMES = 2
+
+        /** Playout slots in the loss window. */
+        const val LOSS_WINDOW = 100
+
+        private const val JITTER_MULTIPLIER = 3.0
+        private const val JITTER_GAIN = 1.0 / 16
+        private const val DRAIN_SLACK_FRAMES = 2
+    }
+
+    private val queue = ArrayDeque<ByteArray>()
+    private var lastArrivalMs = -1L
+    private var burstFrames = 0
+    private var packetFrames = 1
+    private var jitter = 0.0
+    private var playing = false
+    private var rebuffering = false
+    private var nextPlayoutMs = 0L
+    private var lastFrame: ByteArray? = null
+    private var concealedRun = 0
+
+    private val lossSlots = BooleanArray(LOSS_WINDOW)
+    private var lossSlotIndex = 0
+    private var lossSlotsFilled = 0
+    private var lostInWindow = 0
+
+    /** Nominal time between frames for the active profile. */
+    var frameTimeMs: Int = 60
+        set(value) {
+            field = value.coerceAtLeast(1)
+        }
+
+    var framesReceived = 0L
+        private set
+    var framesPlayed = 0L
+        private set
+    var framesConcealed = 0L
+        private set
+    var framesDropped = 0L
+        private set
+    var rebuffers = 0L
+        private set
+
+    /** Smoothed arrival jitter in ms. */
+    val jitterMs: Double get() = jitter
+
+    /** Playout delay the buffer is aiming for. */
+    val targetDelayMs: Int
+        get() = (packetFrames * frameTimeMs + JITTER_MULTIPLIER * jitter).toInt().coerceIn(maxOf(minDelayMs, frameTimeMs), maxDelayMs)
+
+    /** Audio currently queued, in ms. */
+    val depthMs: Int get() = queue.size * frameTimeMs
+
+    /** Share of playout slots in the loss window with no frame on time. */
+    val lossPercent: Float
+        get() = if (lossSlotsFilled == 0) 0f else lostInWindow * 100f / lossSlotsFilled
+
+    /** Whether the loss window holds enough slots for [lossPercent] to mean much. */
+    val lossWindowFull: Boolean get() = lossSlotsFilled >= LOSS_WINDOW
+
+    private val targetFrames: Int get() = ceil(targetDelayMs.toDouble() / frameTimeMs).toInt()
+
+    fun push(
+        frame: ByteArray,
+        nowMs: Long,
+    ) {
+        if (lastArrivalMs >= 0 && nowMs - lastArrivalMs < frameTimeMs / 2) {
+            burstFrames++
+        } else {
+            if (lastArrivalMs >= 0) {
+                packetFrames = burstFrames
+                val expected = burstFrames.toLong() * frameTimeMs
+                val deviation = abs((nowMs - lastArrivalMs) - expected).coerceAtMost(maxDelayMs.toLong())
+                jitter += (deviation - jitter) * JITTER_GAIN
+            }
+            lastArrivalMs = nowMs
+            burstFrames = 1
+        }
+        framesReceived++
+        queue.addLast(frame)
+
+        // Room for the target, the drain slack and one more packet
+        val capacity = targetFrames + DRAIN_SLACK_FRAMES + packetFrames
+        while (queue.size > capacity) {
+            queue.removeFirst()
+            framesDropped++
+        }
+    }
+
+    /**
+     * Move every frame due by [nowMs] (played or concealed) into [out].
+     */
+    fun poll(
+        nowMs: Long,
+        out: MutableList<ByteArray>,
+    ) {
+        if (!playing) {
+            if (queue.isEmpty() || depthMs < targetDelayMs) {
+                // An outage keeps costing audio until playout resumes
+                if (rebuffering) {
+                    while (nowMs >= nextPlayoutMs) {
+                        nextPlayoutMs += frameTimeMs
+                        recordSlot(lost = true)
+                    }
+                }
+                return
+            }
+            playing = true
+            // After a rebuffer the slot cadence carries on
+            if (!rebuffering) nextPlayoutMs = nowMs
+            rebuffering = false
+        }
+        while (nowMs >= nextPlayoutMs) {
+            nextPlayoutMs += frameTimeMs
+            val frame = queue.removeFirstOrNull()
+            if (frame != null) {
+                concealedRun = 0
+                lastFrame = frame
+                framesPlayed++
+                recordSlot(lost = false)
+                out.add(frame)
+                if (queue.size > targetFrames + DRAIN_SLACK_FRAMES) {
+                    queue.removeFirst()
+                    framesDropped++
+                }
+                continue
+            }
+
+            recordSlot(lost = true)
+            val previous = lastFrame
+            if (previous != null && concealedRun < MAX_CONCEALED_FRAMES) {
+                concealedRun++
+                framesConcealed++
+                out.add(previous)
+            } else {
+                // Outage: stop and re-prime rather than keep repeating audio
+                playing = false
+                rebuffering = true
+                concealedRun = 0
+                lastFrame = null
+                rebuffers++
+                return
+            }
+        }
+    }
+
+    fun reset() {
+        queue.clear()
+        lastArrivalMs = -1L
+        burstFrames = 0
+        packetFrames = 1
+        jitter = 0.0
+        playing = false
+        rebuffering = false
+        lastFrame = null
+        concealedRun = 0
+        lossSlots.fill(false)
+        lossSlotIndex = 0
+        lossSlotsFilled = 0
+        lostInWindow = 0
+        framesReceived = 0
+        framesPlayed = 0
+        framesConcealed = 0
+        framesDropped = 0
+        rebuffers = 0
+    }
+
+    private fun recordSlot(lost: Boolean) {
+        if (lossSlotsFilled == LOSS_WINDOW) {
+            if (lossSlots[lossSlotIndex]) lostInWindow--
+        } else {
+            lossSlotsFilled++
+        }
+        lossSlots[lossSlotIndex] = lost
+        if (lost) lostInWindow++
+        lossSlotIndex = (lossSlotIndex + 1) % LOSS_WINDOW
+    }
+}
+
+/**
+ * Decides when sustained playout loss should move a call to a more robust
+ * LXST profile.
+ *
+ * Loss must stay above the profile's tolerance for [SUSTAIN_MS] over a full
+ * loss window, and switches are at least [COOLDOWN_MS] apart so the new
+ * profile gets a fair trial. Only ever steps down.
+ */
+internal class ProfileDowngradeTrigger {
+    companion object {
+        const val SUSTAIN_MS = 5_000L
+        const val COOLDOWN_MS = 20_000L
+
+        /** Loss Opus profiles ride out with concealment; Codec2 degrades sooner. */
+        fun lossTolerancePercent(profileId: Int): Float = if (profileId in 0x10..0x30) 5f else 10f
+
+        /** Next more robust profile, or null at the bottom. */
+        fun downgradeFrom(profileId: Int): Int? =
+            when (profileId) {
+                0x60 -> 0x50
+                0x50 -> 0x40
+                0x70, 0x80 -> 0x40 // Low-latency: fewer, larger packets first
+                0x40 -> 0x30
+                0x30 -> 0x20
+                0x20 -> 0x10
+                else -> null
+            }
+    }
+
+    private var lossSinceMs = -1L
+    private var lastSwitchMs = Long.MIN_VALUE / 2
+
+    /**
+     * Returns the profile id to switch to, or null to stay.
+     */
+    fun evaluate(
+        profileId: Int,
+        lossPercent: Float,
+        windowFull: Boolean,
+        nowMs: Long,
+    ): Int? {
+        if (!windowFull || lossPercent <= lossTolerancePercent(profileId)) {
+            lossSinceMs = -1L
+            return null
+        }
+        if (lossSinceMs < 0) lossSinceMs = nowMs
+        if (nowMs - lossSinceMs < SUSTAIN_MS || nowMs - lastSwitchMs < COOLDOWN_MS) return null
+
+        val target = downgradeFrom(profileId) ?: return null
+        lastSwitchMs = nowMs
+        lossSinceMs = -1L
+        return target
+    }
+
+    fun reset() {
+        lossSinceMs = -1L
+        lastSwitchMs = Long.MIN_VALUE / 2
+    }
+}
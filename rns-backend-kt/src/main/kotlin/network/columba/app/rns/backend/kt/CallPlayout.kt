@@ -0,0 +1,136 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package network.columba.app.rns.backend.kt
+
+import java.util.concurrent.ScheduledExecutorService
+import java.util.concurrent.ScheduledFuture
+import java.util.concurrent.TimeUnit
+
+/**
+ * Live quality of the current call's inbound audio.
+ *
+ * @property mouthToEarMs Estimate: one frame of capture, half the RTT, and the playout delay
+ */
+internal data class CallQualityStats(
+    val lossPercent: Float,
+    val jitterMs: Float,
+    val bufferDepthMs: Int,
+    val targetDelayMs: Int,
+    val rttMs: Long?,
+    val mouthToEarMs: Int?,
+    val framesConcealed: Long,
+    val framesDropped: Long,
+)
+
+/**
+ * Runs an [AdaptiveJitterBuffer] between the call transport and the LXST
+ * decoder.
+ *
+ * Inbound frames are [push]ed from the link thread; a [TICK_MS] tick on
+ * [scheduler] hands due frames to [deliver] in order. The tick starts with the
+ * first frame and stops itself once the call goes quiet for [IDLE_STOP_MS].
+ * Once a second it asks [ProfileDowngradeTrigger] whether sustained loss
+ * calls for a more robust profile and, if so, reports it to [onProfileDowngrade].
+ *
+ * @param profileId Active LXST profile id, or null if unknown
+ * @param rttMs Current link RTT in ms, or null if unknown
+ */
+internal class CallPlayout(
+    private val scheduler: ScheduledExecutorService,
+    private val profileId: () -> Int?,
+    private val rttMs: () -> Long?,
+    private val onProfileDowngrade: (Int) -> Unit,
+    private val deliver: (ByteArray) -> Unit,
+    private val clock: () -> Long = { System.nanoTime() / 1_000_000 },
+) {
+    companion object {
+        const val TICK_MS = 10L
+        // Long enough for an outage to sustain a downgrade first
+        const val IDLE_STOP_MS = 10_000L
+        private const val QUALITY_CHECK_INTERVAL_MS = 1_000L
+        private const val DEFAULT_FRAME_TIME_MS = 60
+    }
+
+    private val lock = Any()
+    private val buffer = AdaptiveJitterBuffer()
+    private val trigger = ProfileDowngradeTrigger()
+    private val due = ArrayList<ByteArray>(4)
+    private var tickTask: ScheduledFuture<*>? = null
+    private var lastPushMs = 0L
+    private var lastQualityCheckMs = 0L
+
+    fun push(frame: ByteArray) {
+        synchronized(lock) {
+            val now = clock()
+            buffer.frameTimeMs = currentFrameTimeMs()
+            buffer.push(frame, now)
+            lastPushMs = now
+            if (tickTask == null) {
+                lastQualityCheckMs = now
+                tickTask = scheduler.scheduleAtFixedRate(::tick, 0, TICK_MS, TimeUnit.MILLISECONDS)
+            }
+        }
+    }
+
+    /** Stop playout and forget the call's state. */
+    fun reset() {
+        synchronized(lock) {
+            tickTask?.cancel(false)
+            tickTask = null
+            buffer.reset()
+            trigger.reset()
+            due.clear()
+        }
+    }
+
+    /** Current stats, or null when no call audio is flowing. */
+    fun stats(): CallQualityStats? =
+        synchronized(lock) {
+            if (tickTask == null) return null
+            val rtt = rttMs()
+            CallQualityStats(
+                lossPercent = buffer.lossPercent,
+                jitterMs = buffer.jitterMs.toFloat(),
+                bufferDepthMs = buffer.depthMs,
+                targetDelayMs = buffer.targetDelayMs,
+                rttMs = rtt,
+                mouthToEarMs = rtt?.let { (buffer.frameTimeMs + it / 2 + buffer.targetDelayMs).toInt() },
+                framesConcealed = buffer.framesConcealed,
+                framesDropped = buffer.framesDropped,
+            )
+        }
+
+    private fun currentFrameTimeMs(): Int = profileId()?.let(LxstBundlePolicy::frameTimeMs) ?: DEFAULT_FRAME_TIME_MS
+
+    private fun tick() {
+        var downgrade: Int? = null
+        val frames =
+            synchronized(lock) {
+                val now = clock()
+                buffer.poll(now, due)
+
+                if (now - lastQualityCheckMs >= QUALITY_CHECK_INTERVAL_MS) {
+                    lastQualityCheckMs = now
+                    val profile = profileId()
+                    if (profile != null) {
+                        downgrade = trigger.evaluate(profile, buffer.lossPercent, buffer.lossWindowFull, now)
+                    }
+                }
+
+                if (due.isEmpty() && buffer.depthMs == 0 && now - lastPushMs >= IDLE_STOP_MS) {
+                    tickTask?.cancel(false)
+                    tickTask = null
+                    buffer.reset()
+                }
+                if (due.isEmpty()) {
+                    emptyList()
+                } else {
+                    due.toList().also { due.clear() }
+                }
+            }
+        frames.forEach(deliver)
+        downgrade?.let(onProfileDowngrade)
+    }
+}
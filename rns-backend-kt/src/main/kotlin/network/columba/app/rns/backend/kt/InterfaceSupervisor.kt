@@ -0,0 +1,267 @@
+package network.columba.app.rns.backend.kt
+
+import android.util.Log
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.SharingStarted
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.collectLatest
+import kotlinx.coroutines.flow.distinctUntilChanged
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.flow.flatMapLatest
+import kotlinx.coroutines.flow.flowOf
+import kotlinx.coroutines.flow.launchIn
+import kotlinx.coroutines.flow.onEach
+import kotlinx.coroutines.flow.stateIn
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withTimeoutOrNull
+import java.util.concurrent.ConcurrentHashMap
+import kotlin.math.min
+import kotlin.random.Random
+
+/**
+ * Uptime and reconnect counters for one supervised interface.
+ *
+ * @property online Current online state
+ * @property uptimeMs Time since the interface last came online (0 while offline)
+ * @property totalUptimeMs Online time summed over the supervision lifetime
+ * @property reconnectAttempts Recovery attempts made since supervision started
+ * @property reconnects Times the interface came back online after a recovery attempt
+ * @property nextRetryAtMs When the next recovery attempt is due, or null if none is pending
+ */
+internal data class InterfaceSupervisionStats(
+    val online: Boolean,
+    val uptimeMs: Long,
+    val totalUptimeMs: Long,
+    val reconnectAttempts: Int,
+    val reconnects: Int,
+    val nextRetryAtMs: Long?,
+)
+
+/**
+ * Recovery backoff: attempt 0 runs immediately, attempt n waits
+ * `initialDelayMs * 2^(n-1)` capped at [maxDelayMs], spread by ±[jitter]
+ * so interfaces that dropped together don't retry in lockstep.
+ */
+internal data class RecoveryBackoff(
+    val initialDelayMs: Long = 5_000L,
+    val maxDelayMs: Long = 5 * 60_000L,
+    val jitter: Double = 0.2,
+    val attemptWindowMs: Long = 12_000L,
+) {
+    fun delayFor(
+        attempt: Int,
+        random: Random,
+    ): Long {
+        if (attempt <= 0) return 0L
+        val base = min(maxDelayMs, initialDelayMs shl min(attempt - 1, 20))
+        val spread = (base * jitter).toLong()
+        return if (spread == 0L) base else base + random.nextLong(-spread, spread + 1)
+    }
+}
+
+/**
+ * Single event-driven supervisor for running interfaces.
+ *
+ * Collects each interface's `online` StateFlow instead of polling it. An
+ * online → offline edge (or a failed start) on an interface that has a
+ * recovery action starts a retry loop with jittered exponential backoff;
+ * the loop ends as soon as the interface reports online again. Nothing wakes
+ * while interfaces are stable. [retrySignals] events (network change,
+ * hardware reattach) cut any pending backoff short and reset it.
+ *
+ * Supervision outlives the interface instance: a recovery restart creates a
+ * new interface object, which is [attach]ed under the same name.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+internal class InterfaceSupervisor(
+    private val scope: CoroutineScope,
+    retrySignals: Flow<String>,
+    private val onOnlineChanged: (name: String, online: Boolean) -> Unit = { _, _ -> },
+    private val backoff: RecoveryBackoff = RecoveryBackoff(),
+    private val clock: () -> Long = System::currentTimeMillis,
+    private val random: Random = Random.Default,
+) {
+    companion object {
+        private const val TAG = "InterfaceSupervisor"
+    }
+
+    private inner class Entry(
+        val name: String,
+        val recover: (suspend () -> Unit)?,
+    ) {
+        val entryScope = CoroutineScope(scope.coroutineContext + SupervisorJob(scope.coroutineContext[Job]))
+        val source = MutableStateFlow<StateFlow<Boolean>?>(null)
+        val online: StateFlow<Boolean> =
+            source
+                .flatMapLatest { it ?: flowOf(false) }
+                .distinctUntilChanged()
+                .stateIn(entryScope, SharingStarted.Eagerly, false)
+        val needsRecovery = MutableStateFlow(false)
+        val boost = Channel<Unit>(Channel.CONFLATED)
+
+        @Volatile var wasOnline = false
+
+        @Volatile var onlineSince: Long? = null
+
+        @Volatile var accumulatedUptimeMs = 0L
+
+        @Volatile var reconnectAttempts = 0
+
+        @Volatile var attemptsSinceOffline = 0
+
+        @Volatile var reconnects = 0
+
+        @Volatile var nextRetryAt: Long? = null
+
+        fun start() {
+            online.onEach { isOnline -> onEdge(this, isOnline) }.launchIn(entryScope)
+            if (recover != null) {
+                entryScope.launch {
+                    needsRecovery.collectLatest { needed -> if (needed) recoveryLoop(this@Entry, recover) }
+                }
+            }
+        }
+    }
+
+    private val entries = ConcurrentHashMap<String, Entry>()
+
+    init {
+        retrySignals.onEach { retryNow(it) }.launchIn(scope)
+    }
+
+    /**
+     * Start supervising [name]. [recover] restarts the interface (and should
+     * [attach] the new instance); null means observe only, for interfaces
+     * that reconnect on their own. Replaces any previous supervision.
+     */
+    fun supervise(
+        name: String,
+        recover: (suspend () -> Unit)? = null,
+    ) {
+        val entry = Entry(name, recover)
+        entries.put(name, entry)?.entryScope?.cancel()
+        entry.start()
+    }
+
+    /**
+     * Point [name]'s supervision at a (new) interface instance. Creates an
+     * observe-only entry if [name] isn't supervised yet. [isCurrent] is checked
+     * atomically with the registration so a racing teardown can't leave an
+     * orphaned entry behind.
+     */
+    fun attach(
+        name: String,
+        online: StateFlow<Boolean>,
+        isCurrent: () -> Boolean = { true },
+    ) {
+        var created: Entry? = null
+        var current = false
+        val entry =
+            entries.compute(name) { _, existing ->
+                current = isCurrent()
+                when {
+                    !current || existing != null -> existing
+                    else -> Entry(name, null).also { created = it }
+                }
+            } ?: return
+        created?.start()
+        if (current) entry.source.value = online
+    }
+
+    /** A start attempt failed before the interface ever came online. */
+    fun reportStartFailed(name: String) {
+        val entry = entries[name] ?: return
+        if (entry.recover == null) return
+        Log.w(TAG, "Interface $name failed to start; scheduling recovery")
+        entry.needsRecovery.value = true
+    }
+
+    /** Stop supervising [name] (interface removed or disabled). */
+    fun remove(name: String) {
+        entries.remove(name)?.entryScope?.cancel()
+    }
+
+    fun supervisedNames(): Set<String> = entries.keys.toSet()
+
+    /** Cut every pending recovery backoff short. */
+    fun retryNow(reason: String) {
+        val waiting = entries.values.filter { it.needsRecovery.value }
+        if (waiting.isEmpty()) return
+        Log.i(TAG, "Retrying ${waiting.size} interface(s) now: $reason")
+        waiting.forEach { it.boost.trySend(Unit) }
+    }
+
+    fun stats(name: String): InterfaceSupervisionStats? {
+        val entry = entries[name] ?: return null
+        val now = clock()
+        val session = entry.onlineSince?.let { now - it } ?: 0L
+        return InterfaceSupervisionStats(
+            online = entry.online.value,
+            uptimeMs = session,
+            totalUptimeMs = entry.accumulatedUptimeMs + session,
+            reconnectAttempts = entry.reconnectAttempts,
+            reconnects = entry.reconnects,
+            nextRetryAtMs = entry.nextRetryAt,
+        )
+    }
+
+    private fun onEdge(
+        entry: Entry,
+        isOnline: Boolean,
+    ) {
+        val now = clock()
+        if (isOnline) {
+            entry.onlineSince = now
+            if (entry.attemptsSinceOffline > 0) entry.reconnects++
+            entry.attemptsSinceOffline = 0
+            entry.wasOnline = true
+            entry.needsRecovery.value = false
+        } else {
+            entry.onlineSince?.let { entry.accumulatedUptimeMs += now - it }
+            entry.onlineSince = null
+            if (entry.wasOnline && entry.recover != null) {
+                Log.w(TAG, "Interface ${entry.name} went offline; starting recovery")
+                entry.needsRecovery.value = true
+            }
+        }
+        onOnlineChanged(entry.name, isOnline)
+    }
+
+    private suspend fun recoveryLoop(
+        entry: Entry,
+        recover: suspend () -> Unit,
+    ) {
+        // A hint from before this outage says nothing about it
+        entry.boost.tryReceive()
+        var attempt = 0
+        try {
+            while (true) {
+                val waitMs = backoff.delayFor(attempt, random)
+                if (waitMs > 0) {
+                    entry.nextRetryAt = clock() + waitMs
+                    val boosted = withTimeoutOrNull(waitMs) { entry.boost.receive() } != null
+                    if (boosted) attempt = 0
+                }
+                entry.nextRetryAt = null
+
+                entry.reconnectAttempts++
+                entry.attemptsSinceOffline++
+                Log.i(TAG, "Recovering interface ${entry.name} (attempt ${attempt + 1})")
+                recover()
+
+                if (withTimeoutOrNull(backoff.attemptWindowMs) { entry.online.first { it } } != null) return
+                Log.w(TAG, "Interface ${entry.name} did not come online yet; backing off")
+                attempt++
+            }
+        } finally {
+            entry.nextRetryAt = null
+        }
+    }
+}
@@ -0,0 +1,162 @@
+package network.columba.app.rns.backend.kt
+
+import network.columba.app.rns.api.model.IconAppearance
+import network.columba.app.rns.api.model.LocationTelemetry
+import network.columba.app.rns.api.util.TelemeterCodec
+import org.json.JSONObject
+
+/**
+ * Merges the telemetry side-channels of one inbound message
+ * (`FIELD_TELEMETRY`, `FIELD_CUSTOM_META`, legacy field 7) straight into a
+ * [LocationTelemetry], so the receive path allocates one result object per
+ * message instead of a JSONObject working buffer.
+ *
+ * JSON is only parsed for payloads that are JSON on the wire (pre-Telemeter
+ * Columba peers); Telemeter and meta msgpack go through [TelemeterCodec].
+ */
+internal class LocationTelemetryBuilder {
+    private var hasLocation = false
+    private var type = LocationTelemetry.TYPE_LOCATION_SHARE
+    private var lat = 0.0
+    private var lng = 0.0
+    private var acc = 0f
+    private var ts = 0L
+    private var altitude = 0.0
+    private var speed = 0.0
+    private var bearing = 0.0
+    private var expires: Long? = null
+    private var cease = false
+    private var approxRadius = 0
+
+    val isEmpty: Boolean
+        get() = !hasLocation
+
+    /** Take the location body from [telemetry] unless one was already merged. */
+    fun mergeLocation(telemetry: LocationTelemetry?): LocationTelemetryBuilder {
+        if (telemetry == null || hasLocation) return this
+        hasLocation = true
+        type = telemetry.type
+        lat = telemetry.lat
+        lng = telemetry.lng
+        acc = telemetry.acc
+        ts = telemetry.ts
+        altitude = telemetry.altitude
+        speed = telemetry.speed
+        bearing = telemetry.bearing
+        expires = telemetry.expires
+        cease = telemetry.cease
+        approxRadius = telemetry.approxRadius
+        return this
+    }
+
+    /**
+     * Apply Columba's extras. A cease replaces whatever location was merged
+     * (the sender zeroes it anyway); otherwise the extras only decorate an
+     * existing location.
+     */
+    fun mergeMeta(
+        meta: TelemeterCodec.ColumbaMeta?,
+        fallbackTs: Long,
+    ): LocationTelemetryBuilder {
+        if (meta == null) return this
+        if (meta.cease) {
+            hasLocation = true
+            type = LocationTelemetry.TYPE_LOCATION_SHARE
+            lat = 0.0
+            lng = 0.0
+            acc = 0f
+            altitude = 0.0
+            speed = 0.0
+            bearing = 0.0
+            expires = null
+            approxRadius = 0
+            cease = true
+            ts = meta.tsMillis ?: fallbackTs
+        } else if (hasLocation) {
+            meta.expires?.let { expires = it }
+            if (meta.approxRadius > 0) approxRadius = meta.approxRadius
+            meta.tsMillis?.let { ts = it }
+        }
+        return this
+    }
+
+    fun build(
+        sourceHash: String?,
+        appearance: IconAppearance?,
+    ): LocationTelemetry? {
+        if (!hasLocation) return null
+        return LocationTelemetry(
+            type = type,
+            lat = lat,
+            lng = lng,
+            acc = acc,
+            ts = ts,
+            altitude = altitude,
+            speed = speed,
+            bearing = bearing,
+            expires = expires,
+            cease = cease,
+            approxRadius = approxRadius,
+            sourceHash = sourceHash?.lowercase(),
+            appearance = appearance,
+        )
+    }
+
+    companion object {
+        /**
+         * Decode a `FIELD_TELEMETRY` value: Telemeter msgpack, or the JSON
+         * (string or bytes) legacy Columba peers sent before it.
+         */
+        fun decodeLocation(field: Any?): LocationTelemetry? =
+            when (field) {
+                is ByteArray -> TelemeterCodec.unpackLocationTelemetry(field) ?: decodeJsonLocation(field)
+                is String -> decodeJsonLocation(field)
+                else -> null
+            }
+
+        /** Decode a `FIELD_CUSTOM_META` value: msgpack, or legacy JSON. */
+        fun decodeMeta(field: Any?): TelemeterCodec.ColumbaMeta? {
+            if (field is ByteArray) TelemeterCodec.unpackColumbaMeta(field)?.let { return it }
+            val json = parseJson(field) ?: return null
+            return TelemeterCodec.ColumbaMeta(
+                cease = json.optBoolean("cease", false),
+                expires = if (json.has("expires") && !json.isNull("expires")) json.optLong("expires") else null,
+                approxRadius = json.optInt("approxRadius", 0),
+                tsMillis = if (json.has("ts") && !json.isNull("ts")) json.optLong("ts") else null,
+            )
+        }
+
+        fun decodeJsonLocation(field: Any?): LocationTelemetry? {
+            val json = parseJson(field) ?: return null
+            val cease = json.optBoolean("cease", false)
+            // A cease carries no position; anything else without one isn't a location
+            if (!cease && (!json.has("lat") || !json.has("lng"))) return null
+            return runCatching {
+                LocationTelemetry(
+                    type = json.optString("type", LocationTelemetry.TYPE_LOCATION_SHARE),
+                    lat = json.optDouble("lat", 0.0),
+                    lng = json.optDouble("lng", 0.0),
+                    acc = json.optDouble("acc", 0.0).toFloat(),
+                    ts = json.optLong("ts", 0L),
+                    altitude = json.optDouble("altitude", 0.0),
+                    speed = json.optDouble("speed", 0.0),
+                    bearing = json.optDouble("bearing", 0.0),
+                    expires = if (json.has("expires") && !json.isNull("expires")) json.getLong("expires") else null,
+                    cease = cease,
+                    approxRadius = json.optInt("approxRadius", 0),
+                )
+            }.getOrNull()
+        }
+
+        private fun parseJson(field: Any?): JSONObject? =
+            try {
+                when (field) {
+                    is String -> JSONObject(field)
+                    is ByteArray -> JSONObject(String(field, Charsets.UTF_8))
+                    else -> null
+                }
+            } catch (_: Exception) {
+                null
+            }
+    }
+}
@@ -0,0 +1,483 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package network.columba.app.rns.backend.kt
+
+import java.util.concurrent.ScheduledExecutorService
+import java.util.concurrent.ScheduledFuture
+import java.util.concurrent.TimeUnit
+
+/**
+ * Hand-rolled msgpack framing for LXST telephony packets.
+ *
+ * Python LXST exchanges single-entry msgpack maps over the call link:
+ *   {0: [signal, ...]}             FIELD_SIGNALLING
+ *   {1: frame} or {1: [frame, ...]} FIELD_FRAMES (one codec frame or a bundle)
+ *
+ * These are the only shapes on the voice path, so they are written and parsed
+ * directly instead of going through a msgpack packer/unpacker per packet.
+ */
+internal object LxstWireCodec {
+    const val FIELD_SIGNALLING = 0x00
+    const val FIELD_FRAMES = 0x01
+
+    /** Encoded size of a bin header for a payload of [length] bytes. */
+    fun binHeaderSize(length: Int): Int =
+        when {
+            length < 0x100 -> 2
+            length < 0x10000 -> 3
+            else -> 5
+        }
+
+    /** Write a msgpack bin header at [offset]; returns the offset after it. */
+    fun writeBinHeader(
+        buffer: ByteArray,
+        offset: Int,
+        length: Int,
+    ): Int {
+        var pos = offset
+        when {
+            length < 0x100 -> {
+                buffer[pos++] = 0xC4.toByte()
+                buffer[pos++] = length.toByte()
+            }
+            length < 0x10000 -> {
+                buffer[pos++] = 0xC5.toByte()
+                buffer[pos++] = (length ushr 8).toByte()
+                buffer[pos++] = length.toByte()
+            }
+            else -> {
+                buffer[pos++] = 0xC6.toByte()
+                buffer[pos++] = (length ushr 24).toByte()
+                buffer[pos++] = (length ushr 16).toByte()
+                buffer[pos++] = (length ushr 8).toByte()
+                buffer[pos++] = length.toByte()
+            }
+        }
+        return pos
+    }
+
+    /** Encode `{0: [signal]}`. */
+    fun encodeSignal(signal: Int): ByteArray {
+        val value = signal.toLong() and 0xFFFFFFFFL
+        val intSize =
+            when {
+                value < 0x80 -> 1
+                value < 0x100 -> 2
+                value < 0x10000 -> 3
+                else -> 5
+            }
+        val out = ByteArray(3 + intSize)
+        out[0] = 0x81.toByte() // fixmap(1)
+        out[1] = FIELD_SIGNALLING.toByte()
+        out[2] = 0x91.toByte() // fixarray(1)
+        when (intSize) {
+            1 -> out[3] = value.toByte()
+            2 -> {
+                out[3] = 0xCC.toByte()
+                out[4] = value.toByte()
+            }
+            3 -> {
+                out[3] = 0xCD.toByte()
+                out[4] = (value ushr 8).toByte()
+                out[5] = value.toByte()
+            }
+            else -> {
+                out[3] = 0xCE.toByte()
+                out[4] = (value ushr 24).toByte()
+                out[5] = (value ushr 16).toByte()
+                out[6] = (value ushr 8).toByte()
+                out[7] = value.toByte()
+            }
+        }
+        return out
+    }
+
+    /** Encode `{1: frame}`. */
+    fun encodeFrame(frame: ByteArray): ByteArray {
+        val out = ByteArray(2 + binHeaderSize(frame.size) + frame.size)
+        out[0] = 0x81.toByte()
+        out[1] = FIELD_FRAMES.toByte()
+        val pos = writeBinHeader(out, 2, frame.size)
+        System.arraycopy(frame, 0, out, pos, frame.size)
+        return out
+    }
+}
+
+/**
+ * Parses LXST packets without a msgpack unpacker.
+ *
+ * Reuses its scratch arrays across packets; the only allocation per packet is
+ * the copy of each frame handed to [Sink.onFrame], which the audio pipeline keeps.
+ * Returns false for anything outside the shapes in [LxstWireCodec] so the
+ * caller can fall back to a generic msgpack decode.
+ */
+internal class LxstPacketDecoder {
+    interface Sink {
+        fun onSignal(signal: Int)
+
+        fun onFrame(frame: ByteArray)
+    }
+
+    companion object {
+        private const val MAX_SIGNALS = 16
+        private const val MAX_FRAMES = 32
+        private const val INVALID = Long.MIN_VALUE
+    }
+
+    private val signals = IntArray(MAX_SIGNALS)
+    private val frameOffsets = IntArray(MAX_FRAMES)
+    private val frameLengths = IntArray(MAX_FRAMES)
+    private var signalCount = 0
+    private var frameCount = 0
+    private var data = ByteArray(0)
+    private var pos = 0
+
+    /**
+     * Decode [packet], dispatching signals before frames (as the generic path did).
+     * Nothing is dispatched unless the whole packet parses.
+     */
+    @Synchronized
+    fun decode(
+        packet: ByteArray,
+        sink: Sink,
+    ): Boolean {
+        data = packet
+        pos = 0
+        signalCount = 0
+        frameCount = 0
+        val parsed = parse()
+        data = ByteArray(0)
+        if (!parsed) return false
+
+        for (i in 0 until signalCount) sink.onSignal(signals[i])
+        for (i in 0 until frameCount) {
+            val start = frameOffsets[i]
+            sink.onFrame(packet.copyOfRange(start, start + frameLengths[i]))
+        }
+        return true
+    }
+
+    @Suppress("ReturnCount") // Each malformed shape bails out early
+    private fun parse(): Boolean {
+        val entries = readMapHeader()
+        if (entries <= 0) return false
+        repeat(entries) {
+            when (readInt()) {
+                LxstWireCodec.FIELD_SIGNALLING.toLong() -> if (!parseSignals()) return false
+                LxstWireCodec.FIELD_FRAMES.toLong() -> if (!parseFrames()) return false
+                else -> return false
+            }
+        }
+        return pos == data.size
+    }
+
+    private fun parseSignals(): Boolean {
+        val count = readArrayHeader()
+        if (count < 0 || signalCount + count > MAX_SIGNALS) return false
+        repeat(count) {
+            val value = readInt()
+            if (value == INVALID) return false
+            signals[signalCount++] = value.toInt()
+        }
+        return true
+    }
+
+    private fun parseFrames(): Boolean {
+        if (pos >= data.size) return false
+        val head = data[pos].toInt() and 0xFF
+        val count = if (head in 0xC4..0xC6) 1 else readArrayHeader()
+        if (count < 0 || frameCount + count > MAX_FRAMES) return false
+        repeat(count) {
+            val length = readBinHeader()
+            if (length < 0 || length > data.size - pos) return false
+            frameOffsets[frameCount] = pos
+            frameLengths[frameCount] = length
+            frameCount++
+            pos += length
+        }
+        return true
+    }
+
+    private fun readMapHeader(): Int {
+        if (pos >= data.size) return -1
+        val b = data[pos++].toInt() and 0xFF
+        return when {
+            b in 0x80..0x8F -> b and 0x0F
+            b == 0xDE -> readUnsigned(2).asCount()
+            else -> -1
+        }
+    }
+
+    private fun readArrayHeader(): Int {
+        if (pos >= data.size) return -1
+        val b = data[pos++].toInt() and 0xFF
+        return when {
+            b in 0x90..0x9F -> b and 0x0F
+            b == 0xDC -> readUnsigned(2).asCount()
+            b == 0xDD -> readUnsigned(4).asCount()
+            else -> -1
+        }
+    }
+
+    private fun readBinHeader(): Int {
+        if (pos >= data.size) return -1
+        val b = data[pos++].toInt() and 0xFF
+        return when (b) {
+            0xC4 -> readUnsigned(1).asCount()
+            0xC5 -> readUnsigned(2).asCount()
+            0xC6 -> readUnsigned(4).asCount()
+            else -> -1
+        }
+    }
+
+    private fun readInt(): Long {
+        if (pos >= data.size) return INVALID
+        val b = data[pos++].toInt() and 0xFF
+        return when {
+            b <= 0x7F -> b.toLong()
+            b >= 0xE0 -> (b - 0x100).toLong()
+            b == 0xCC -> readUnsigned(1)
+            b == 0xCD -> readUnsigned(2)
+            b == 0xCE -> readUnsigned(4)
+            b == 0xD0 -> readUnsigned(1).let { if (it == INVALID) it else it.toByte().toLong() }
+            b == 0xD1 -> readUnsigned(2).let { if (it == INVALID) it else it.toShort().toLong() }
+            b == 0xD2 -> readUnsigned(4).let { if (it == INVALID) it else it.toInt().toLong() }
+            else -> INVALID
+        }
+    }
+
+    private fun Long.asCount(): Int = if (this in 0..Int.MAX_VALUE) toInt() else -1
+
+    private fun readUnsigned(bytes: Int): Long {
+        if (data.size - pos < bytes) return INVALID
+        var value = 0L
+        repeat(bytes) { value = (value shl 8) or (data[pos++].toLong() and 0xFF) }
+        return value
+    }
+}
+
+/**
+ * Chooses how many codec frames go into one link packet.
+ *
+ * Each Reticulum link packet carries ~19 bytes of header plus ~50-60 bytes
+ * of link encryption overhead, which dwarfs a 35-byte Codec2 frame. Bundling
+ * frames amortises that, at the cost of holding audio back: a bundle of n
+ * frames delays the first by (n - 1) frame times. That delay is only spent
+ * where it is small next to the link's own round trip time, so fast links keep
+ * sending one frame per packet.
+ *
+ * Only peers that announced bundle support during call setup get bundles:
+ * older peers (Python LXST and earlier native builds) accept one binary frame
+ * per packet and nothing else.
+ */
+internal object LxstBundlePolicy {
+    /** Default Reticulum link MDU (500-byte MTU). */
+    const val LINK_MDU = 431
+
+    /**
+     * Signal each side sends once the call link is up to say it unpacks
+     * bundled frames. LXST ignores signals below PREFERRED_PROFILE (0xFF)
+     * that it doesn't know, so older peers drop it.
+     */
+    const val FRAME_BUNDLES_SIGNAL = 0xB1
+
+    const val MAX_FRAMES_PER_PACKET = 8
+
+    /** Bundling may add at most this fraction of the RTT as latency... */
+    private const val RTT_LATENCY_FRACTION = 0.5
+
+    /** ...and never more than this. */
+    const val MAX_ADDED_LATENCY_MS = 1_000L
+
+    /** Low-latency profiles ask for short frames; never hold those back. */
+    private const val LOW_LATENCY_FRAME_MS = 20
+
+    /**
+     * Frame time of an LXST profile, by profile id (LXST Telephony.Profiles),
+     * or null for an unknown id.
+     */
+    fun frameTimeMs(profileId: Int): Int? =
+        when (profileId) {
+            0x10 -> 400 // Ultra low bandwidth (Codec2 700C)
+            0x20 -> 320 // Very low bandwidth (Codec2 1600)
+            0x30 -> 200 // Low bandwidth (Codec2 3200)
+            0x40, 0x50, 0x60 -> 60 // Medium / high / max quality (Opus)
+            0x70 -> 20 // Low latency
+            0x80 -> 10 // Ultra low latency
+            else -> null
+        }
+
+    /**
+     * Frames per packet for a link with round trip time [rttMs] (null if not yet
+     * measured) carrying frames every [frameTimeMs], to a peer that has
+     * ([peerAcceptsBundles]) or hasn't sent [FRAME_BUNDLES_SIGNAL].
+     */
+    fun framesPerPacket(
+        frameTimeMs: Int,
+        rttMs: Long?,
+        peerAcceptsBundles: Boolean,
+    ): Int {
+        if (!peerAcceptsBundles) return 1
+        if (frameTimeMs <= LOW_LATENCY_FRAME_MS || rttMs == null || rttMs <= 0) return 1
+        val budgetMs = (rttMs * RTT_LATENCY_FRACTION).toLong().coerceAtMost(MAX_ADDED_LATENCY_MS)
+        return (1 + budgetMs / frameTimeMs).toInt().coerceIn(1, MAX_FRAMES_PER_PACKET)
+    }
+}
+
+/**
+ * Packs outbound codec frames into LXST packets, bundling up to
+ * [framesPerPacket] of them per packet.
+ *
+ * Frames are written straight into a reused staging buffer as msgpack bin
+ * entries; a flush copies them behind the map header into the one array
+ * handed to [output]. A single-frame packet is `{1: frame}`, the same bytes
+ * as before bundling, so bundling only changes the wire format when the
+ * policy asks for it. Packets never exceed [mdu] bytes.
+ *
+ * If [scheduler] is set, a partial bundle is flushed once its first frame
+ * has waited for the rest of the bundle, so silence or call end can't strand audio.
+ */
+internal class LxstFrameBundler(
+    private val mdu: Int = LxstBundlePolicy.LINK_MDU,
+    private val scheduler: ScheduledExecutorService? = null,
+    private val output: (ByteArray) -> Unit,
+) {
+    companion object {
+        // fixmap(1) + key + array header (fixarray up to 15 frames)
+        private const val BUNDLE_HEADER_SIZE = 3
+        private const val FRAME_INTERVAL_SMOOTHING = 0.2
+    }
+
+    private val lock = Any()
+    private val staging = ByteArray(mdu)
+    private var stagedBytes = 0
+    private var stagedFrames = 0
+    private var pendingFlush: ScheduledFuture<*>? = null
+    private var lastOfferNanos = 0L
+    private var frameIntervalMs = 0.0
+
+    /**
+     * Target frames per packet; takes effect from the next frame. Stays at one,
+     * the only format older peers accept, unless the owner raises it.
+     */
+    @Volatile
+    var framesPerPacket: Int = 1
+        set(value) {
+            field = value.coerceIn(1, LxstBundlePolicy.MAX_FRAMES_PER_PACKET)
+        }
+
+    /** Frame time used to schedule partial-bundle flushes. */
+    @Volatile
+    var frameTimeMs: Int = 0
+
+    /** Smoothed interval between offered frames, or null before two frames. */
+    val measuredFrameIntervalMs: Int?
+        get() = synchronized(lock) { frameIntervalMs.takeIf { it > 0 }?.toInt() }
+
+    /** Packets, frames and bytes handed to [output], for diagnostics and tests. */
+    var packetsSent = 0L
+        private set
+    var framesSent = 0L
+        private set
+    var bytesSent = 0L
+        private set
+
+    fun offer(frame: ByteArray) {
+        var flushed: ByteArray? = null
+        var packet: ByteArray? = null
+        synchronized(lock) {
+            trackInterval()
+            val entrySize = LxstWireCodec.binHeaderSize(frame.size) + frame.size
+            if (BUNDLE_HEADER_SIZE + stagedBytes + entrySize > mdu) {
+                // Bundle is full by size: send what's staged first
+                flushed = takePacketLocked()
+            }
+            if (BUNDLE_HEADER_SIZE + entrySize > mdu) {
+                // Oversized frame goes alone, as it did before bundling
+                framesSent++
+                packet = LxstWireCodec.encodeFrame(frame)
+            } else {
+                val pos = LxstWireCodec.writeBinHeader(staging, stagedBytes, frame.size)
+                System.arraycopy(frame, 0, staging, pos, frame.size)
+                stagedBytes = pos + frame.size
+                stagedFrames++
+
+                if (stagedFrames >= framesPerPacket) {
+                    packet = takePacketLocked()
+                } else if (stagedFrames == 1) {
+                    scheduleFlushLocked()
+                }
+            }
+        }
+        flushed?.let(::emit)
+        packet?.let(::emit)
+    }
+
+    /** Send any staged frames now (e.g. before a signal, to keep ordering). */
+    fun flush() {
+        synchronized(lock) { takePacketLocked() }?.let(::emit)
+    }
+
+    /** Drop staged frames (link gone). */
+    fun clear() {
+        synchronized(lock) {
+            pendingFlush?.cancel(false)
+            pendingFlush = null
+            stagedBytes = 0
+            stagedFrames = 0
+            lastOfferNanos = 0L
+            frameIntervalMs = 0.0
+        }
+    }
+
+    private fun trackInterval() {
+        val now = System.nanoTime()
+        if (lastOfferNanos != 0L) {
+            val intervalMs = (now - lastOfferNanos) / 1_000_000.0
+            frameIntervalMs =
+                if (frameIntervalMs == 0.0) {
+                    intervalMs
+                } else {
+                    frameIntervalMs + FRAME_INTERVAL_SMOOTHING * (intervalMs - frameIntervalMs)
+                }
+        }
+        lastOfferNanos = now
+    }
+
+    private fun scheduleFlushLocked() {
+        val executor = scheduler ?: return
+        val frameTime = frameTimeMs.takeIf { it > 0 } ?: return
+        // Wait for the rest of the bundle plus half a frame of slack
+        val delayMs = (framesPerPacket - 1) * frameTime + frameTime / 2L
+        pendingFlush = executor.schedule({ flush() }, delayMs, TimeUnit.MILLISECONDS)
+    }
+
+    private fun takePacketLocked(): ByteArray? {
+        if (stagedFrames == 0) return null
+        pendingFlush?.cancel(false)
+        pendingFlush = null
+
+        val bundled = stagedFrames > 1
+        val headerSize = if (bundled) BUNDLE_HEADER_SIZE else 2
+        val packet = ByteArray(headerSize + stagedBytes)
+        packet[0] = 0x81.toByte() // fixmap(1)
+        packet[1] = LxstWireCodec.FIELD_FRAMES.toByte()
+        if (bundled) packet[2] = (0x90 or stagedFrames).toByte() // fixarray(n)
+        System.arraycopy(staging, 0, packet, headerSize, stagedBytes)
+
+        framesSent += stagedFrames
+        stagedBytes = 0
+        stagedFrames = 0
+        return packet
+    }
+
+    private fun emit(packet: ByteArray) {
+        synchronized(lock) {
+            packetsSent++
+            bytesSent += packet.size
+        }
+        output(packet)
+    }
+}
@@ -43,9 +43,13 @@ import tech.torlando.lxst.telephone.Telephone
  *   Packetizer → PacketRouter.sendPacket() → AudioPacketHandler → transport.sendPacket() → Link
  *
  * Inbound (network → speaker):
- *   Link → transport.packetCallback → PacketRouter.onInboundPacket() → LinkSource / Mixer
+ *   Link → transport.packetCallback → CallPlayout (jitter buffer) → PacketRouter.onInboundPacket() → LinkSource / Mixer
  * ```
  *
+ * [CallPlayout] sizes playout delay from observed jitter, conceals lost
+ * frames, reports live quality ([qualityStats]) and steps the call down to a
+ * more robust profile when loss stays above what the codec tolerates.
+ *
  * ## Incoming call identity protocol
  * 1. Remote caller establishes link to `lxst.telephony` destination
  * 2. We send STATUS_AVAILABLE (0x03) to prompt the caller to call `link.identify()`
@@ -78,6 +82,18 @@ class NativeCallManager(
     private val audioBridge: AudioDevice = AudioDevice.getInstance(context)
     private val callCoordinator: CallCoordinator = CallCoordinator.getInstance()
 
+    private val playout =
+        CallPlayout(
+            scheduler = NativeNetworkTransport.callScheduler,
+            profileId = { if (::telephone.isInitialized) telephone.activeProfile?.id else null },
+            rttMs = { transport.linkRttMs },
+            onProfileDowngrade = { profileId ->
+                Log.w(TAG, "Sustained call loss, switching to profile 0x${profileId.toString(16)}")
+                transport.requestProfile(profileId)
+            },
+            deliver = { frame -> packetRouter.onInboundPacket(frame) },
+        )
+
     /**
      * The [Telephone] instance, created during [setup].
      * Exposed so [NativeReticulumProtocol] can query call status.
@@ -126,9 +142,12 @@ class NativeCallManager(
             },
         )
 
-        // 3. Wire transport → PacketRouter (inbound audio from remote peer).
-        //    Signal routing is set by Telephone.init (see step 4).
-        transport.setPacketCallback { data -> packetRouter.onInboundPacket(data) }
+        // 3. Wire transport → playout buffer → PacketRouter (inbound audio from
+        //    remote peer). Signal routing is set by Telephone.init (see step 4).
+        transport.setPacketCallback { data -> playout.push(data) }
+        // The call is over however the link went (remote hangup included):
+        // drop its queued audio and loss history before the next call
+        transport.setLinkClosedCallback { playout.reset() }
 
         // 4. Create Telephone — its init block sets transport.signalCallback to onSignalReceived
         telephone =
@@ -336,6 +355,7 @@ class NativeCallManager(
                     } ?: Profile.DEFAULT
 
             Log.i(TAG, "Starting call with profile ${profile.abbreviation} (0x${profile.id.toString(16)})")
+            transport.setProfile(profile)
             telephone.call(destBytes, profile)
         }
     }
@@ -346,8 +366,12 @@ class NativeCallManager(
 
     override fun hangup() {
         telephone.hangup()
+        playout.reset()
     }
 
+    /** Live quality of the current call's inbound audio, or null when none is flowing. */
+    internal fun qualityStats(): CallQualityStats? = playout.stats()
+
     override fun muteMicrophone(muted: Boolean) {
         telephone.muteTransmit(muted)
     }
@@ -421,6 +445,7 @@ class NativeCallManager(
             }
         }
         callCoordinator.setCallManager(null)
+        playout.reset()
         telephonyDestination = null
         // Tear down any active call link so NativeNetworkTransport.activeLink is
         // cleared — otherwise a subsequent setup() would see a stale closed link.
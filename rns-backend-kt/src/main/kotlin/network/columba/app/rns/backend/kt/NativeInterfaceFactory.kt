@@ -4,13 +4,12 @@ import android.content.Context
 import android.util.Log
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.cancel
-import kotlinx.coroutines.flow.launchIn
-import kotlinx.coroutines.flow.onEach
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.util.InterfaceRetrySignal
 import network.reticulum.interfaces.auto.AutoInterface
 import network.reticulum.interfaces.tcp.TCPClientInterface
 import network.reticulum.interfaces.tcp.TCPServerInterface
@@ -27,18 +26,7 @@ internal object NativeInterfaceFactory {
 
     /** Running interfaces keyed by config name. */
     private val runningInterfaces = java.util.concurrent.ConcurrentHashMap<String, network.reticulum.interfaces.Interface>()
-    private val rnodeRecoveryJobs = java.util.concurrent.ConcurrentHashMap<String, kotlinx.coroutines.Job>()
 
-    /**
-     * Per-interface collector jobs watching [network.reticulum.interfaces.Interface.online].
-     * reticulum-kt v0.0.9+ exposes `online` as a `StateFlow<Boolean>`; some
-     * interface types (notably [network.reticulum.interfaces.rnode.RNodeInterface])
-     * don't flip online until their handshake completes 3-5s after
-     * registration. Without an observer the Columba UI caches the initial
-     * `false` value forever. This map keeps the collector jobs alive for
-     * the lifetime of the interface and lets us cancel them in [stopInterface].
-     */
-    private val onlineObservers = java.util.concurrent.ConcurrentHashMap<String, Job>()
     private val listeners = java.util.concurrent.CopyOnWriteArraySet<() -> Unit>()
 
     /** App context for BLE driver construction. */
@@ -73,13 +61,36 @@ internal object NativeInterfaceFactory {
      */
     private val scope: CoroutineScope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
 
+    /**
+     * Watches every running interface's [network.reticulum.interfaces.Interface.online]
+     * StateFlow and drives RNode recovery on offline edges. reticulum-kt
+     * v0.0.9+ exposes `online` as a `StateFlow<Boolean>`; some interface
+     * types (notably [network.reticulum.interfaces.rnode.RNodeInterface])
+     * don't flip online until their handshake completes 3-5s after
+     * registration. Without an observer the Columba UI caches the initial
+     * `false` value forever, so every transition re-notifies listeners.
+     *
+     * TCP clients and BLE reconnect inside reticulum-kt and are observed
+     * only, for uptime stats.
+     */
+    private val supervisor =
+        InterfaceSupervisor(
+            scope = scope,
+            retrySignals = InterfaceRetrySignal.events,
+            onOnlineChanged = { name, online ->
+                Log.d(TAG, "Interface $name online → $online")
+                notifyListeners()
+            },
+        )
+
     /**
      * Diff-based sync: compare running interfaces with desired config.
      * Only stops removed ones, only starts new ones, leaves unchanged running.
      */
     fun syncInterfaces(configs: List<InterfaceConfig>) {
         val desiredNames = configs.filter { it.enabled }.map { it.name }.toSet()
-        val runningNames = runningInterfaces.keys.toSet()
+        // Interfaces torn down mid-recovery still count as running
+        val runningNames = runningInterfaces.keys.toSet() + supervisor.supervisedNames()
 
         // Stop removed interfaces
         for (name in runningNames - desiredNames) {
@@ -89,7 +100,7 @@ internal object NativeInterfaceFactory {
         // Start new interfaces
         for (name in desiredNames - runningNames) {
             val config = configs.first { it.name == name }
-            startInterface(config)
+            startSupervised(config)
         }
 
         Log.d(
@@ -112,12 +123,33 @@ internal object NativeInterfaceFactory {
     fun restartInterface(config: InterfaceConfig) {
         stopInterface(config.name)
         if (config.enabled) {
-            startInterface(config)
+            startSupervised(config)
         }
     }
 
+    /** Uptime / reconnect counters for a running interface, or null if it isn't supervised. */
+    fun supervisionStats(name: String): InterfaceSupervisionStats? = supervisor.stats(name)
+
+    /**
+     * Start an interface under supervision. RNodes get a recovery action
+     * (tear down and start again from the same config); other types
+     * reconnect internally and are only observed.
+     */
+    private fun startSupervised(config: InterfaceConfig) {
+        if (config is InterfaceConfig.RNode) {
+            supervisor.supervise(config.name) {
+                withContext(Dispatchers.IO) {
+                    if (runningInterfaces[config.name]?.online?.value == true) return@withContext
+                    teardownInterface(config.name)
+                    startInterface(config)
+                }
+            }
+        }
+        startInterface(config)
+    }
+
     fun shutdownAll() {
-        for (name in runningInterfaces.keys.toList()) {
+        for (name in runningInterfaces.keys.toList() + supervisor.supervisedNames()) {
             stopInterface(name)
         }
     }
@@ -153,66 +185,15 @@ internal object NativeInterfaceFactory {
             MulticastLockHelper.acquire(appContext)
         }
 
-        observeOnlineState(name, iface)
+        // Checked atomically with registration: stopInterface() removes the
+        // name from runningInterfaces BEFORE dropping supervision, so a racing
+        // teardown that won leaves no orphaned observer behind.
+        supervisor.attach(name, iface.online) { runningInterfaces[name] === iface }
 
         Log.i(TAG, "Started interface: $name (online=${iface.online.value})")
         notifyListeners()
     }
 
-    /**
-     * Collect the interface's online StateFlow and re-notify listeners on
-     * every distinct transition.
-     *
-     * Previously used `.drop(1)` to skip the initial replay value StateFlow
-     * hands out on subscribe, on the assumption that the initial value was
-     * already surfaced via the [notifyListeners] call at the bottom of
-     * [registerAndTrack]. That assumption broke when the interface
-     * transitions online *before* the collector can subscribe:
-     *
-     *   1. [startInterface] calls [iface.start()] (line 125).
-     *   2. For RNode over a warm USB connection, KISS handshake completes
-     *      in well under a second, transitioning `iface.online` false→true.
-     *   3. [registerAndTrack] runs, captures `online=true` in its
-     *      [notifyListeners] snapshot.
-     *   4. [observeOnlineState] subscribes — StateFlow replays the CURRENT
-     *      value (`true`). With `.drop(1)` that emission is swallowed as
-     *      "the initial value". There is no subsequent change, so the
-     *      collector never fires again.
-     *   5. Later, [notifyListeners] is called for unrelated reasons (e.g.
-     *      user toggles another interface) but the interface-list-UI caches
-     *      the first snapshot and never re-reads — the RNode card stays
-     *      "offline" until the app restarts.
-     *
-     * The fix is to remove the drop: the StateFlow's initial replay is now
-     * propagated as one extra [notifyListeners] call (idempotent — same
-     * snapshot as the one emitted at the bottom of [registerAndTrack]),
-     * which closes the window where a fast transition between start() and
-     * subscribe can strand the UI in the wrong state.
-     */
-    private fun observeOnlineState(
-        name: String,
-        iface: network.reticulum.interfaces.Interface,
-    ) {
-        // Atomically replace any previous collector under the same key.
-        // runningInterfaces is the source of truth for "this interface is
-        // currently managed"; stopInterface() removes it BEFORE
-        // onlineObservers, so a racing teardown that won the
-        // runningInterfaces lock first will leave us with an absent key —
-        // we detect that here and refuse to install the collector,
-        // preventing an orphaned observer from surviving teardown.
-        onlineObservers.compute(name) { _, previous ->
-            previous?.cancel()
-            if (!runningInterfaces.containsKey(name)) {
-                return@compute null
-            }
-            iface.online
-                .onEach { online ->
-                    Log.d(TAG, "Interface $name online → $online")
-                    notifyListeners()
-                }.launchIn(scope)
-        }
-    }
-
     @Suppress("TooGenericExceptionCaught")
     private fun startBleInterface(config: InterfaceConfig.AndroidBLE) {
         val ctx = appContext
@@ -282,20 +263,30 @@ internal object NativeInterfaceFactory {
             hostBridge = rnodeHostBridge,
             scope = scope,
             onRegisterAndTrack = ::registerAndTrack,
-            onMonitorLifecycle = ::monitorRNodeLifecycle,
-            onEnsureRecovery = ::ensureRNodeRecovery,
+            onStartFailed = { supervisor.reportStartFailed(it.name) },
         )
     }
 
+    /** Stop an interface and end its supervision. */
     private fun stopInterface(name: String) {
-        rnodeRecoveryJobs.remove(name)?.cancel()
-        // Remove from runningInterfaces BEFORE onlineObservers so that a
-        // concurrent observeOnlineState() still sitting in its compute
-        // block sees the interface as unmanaged and bails out instead of
-        // leaving an orphaned collector behind.
+        // Remove from runningInterfaces BEFORE dropping supervision so that a
+        // concurrent registerAndTrack() sees the interface as unmanaged and
+        // doesn't re-attach it.
         val iface = runningInterfaces.remove(name)
-        onlineObservers.remove(name)?.cancel()
-        if (iface == null) return
+        supervisor.remove(name)
+        if (iface != null) detachInterface(name, iface)
+    }
+
+    /** Stop an interface but keep supervising it (recovery restart). */
+    private fun teardownInterface(name: String) {
+        val iface = runningInterfaces.remove(name) ?: return
+        detachInterface(name, iface)
+    }
+
+    private fun detachInterface(
+        name: String,
+        iface: network.reticulum.interfaces.Interface,
+    ) {
         try {
             val ref =
                 network.reticulum.interfaces.InterfaceAdapter
@@ -331,31 +322,6 @@ internal object NativeInterfaceFactory {
         }
     }
 
-    private fun monitorRNodeLifecycle(
-        config: InterfaceConfig.RNode,
-        iface: network.reticulum.interfaces.rnode.RNodeInterface,
-    ) {
-        RNodeRecoveryHelper.monitorLifecycle(
-            config = config,
-            iface = iface,
-            scope = scope,
-            runningInterfaces = runningInterfaces,
-            onNotifyListeners = ::notifyListeners,
-            onEnsureRecovery = ::ensureRNodeRecovery,
-        )
-    }
-
-    private fun ensureRNodeRecovery(config: InterfaceConfig.RNode) {
-        RNodeRecoveryHelper.ensureRecovery(
-            config = config,
-            scope = scope,
-            rnodeRecoveryJobs = rnodeRecoveryJobs,
-            runningInterfaces = runningInterfaces,
-            onStopInterface = ::stopInterface,
-            onStartInterface = ::startInterface,
-        )
-    }
-
     private fun createInterface(config: InterfaceConfig): Any? {
         fun mapScopeToHex(scopeName: String): String =
             when (scopeName.lowercase()) {
@@ -29,9 +29,19 @@ internal class NativeMessageSender(
     private val deliveryDestinationProvider: () -> NativeDestination?,
     private val deliveryStatusFlow: MutableSharedFlow<DeliveryStatusUpdate>,
     private val scopeProvider: () -> kotlinx.coroutines.CoroutineScope,
+    private val pathWaiter: PathWaiter<NativeIdentity>,
+    private val identityTimeoutsMs: Map<DeliveryMethod, Long> = DEFAULT_IDENTITY_TIMEOUTS_MS,
 ) {
     companion object {
         private const val TAG = "NativeReticulumProtocol"
+
+        /** How long a send waits for an unknown recipient's identity, per delivery method. */
+        val DEFAULT_IDENTITY_TIMEOUTS_MS =
+            mapOf(
+                DeliveryMethod.OPPORTUNISTIC to 10_000L,
+                DeliveryMethod.DIRECT to 10_000L,
+                DeliveryMethod.PROPAGATED to 10_000L,
+            )
     }
 
     data class MessageOptions(
@@ -67,7 +77,7 @@ internal class NativeMessageSender(
         kotlinx.coroutines.withContext(Dispatchers.IO) {
             runCatching {
                 val router = routerProvider() ?: error("Router not initialized")
-                val recipientIdentity = resolveRecipientIdentity(destinationHash)
+                val recipientIdentity = resolveRecipientIdentity(destinationHash, deliveryMethod)
                 val recipientDest =
                     NativeDestination.create(
                         recipientIdentity,
@@ -105,25 +115,15 @@ internal class NativeMessageSender(
             }
         }
 
-    private suspend fun resolveRecipientIdentity(destinationHash: ByteArray): NativeIdentity {
-        var recipientIdentity =
-            NativeIdentity.recall(destinationHash)
-                ?: NativeIdentity.recallByIdentityHash(destinationHash)
-
-        if (recipientIdentity == null) {
-            Log.d(TAG, "Recipient identity not cached, requesting path for ${destinationHash.toHex().take(16)}")
-            Transport.requestPath(destinationHash)
-            val deadline = System.currentTimeMillis() + 10_000
-            while (recipientIdentity == null && System.currentTimeMillis() < deadline) {
-                kotlinx.coroutines.delay(250)
-                recipientIdentity = NativeIdentity.recall(destinationHash)
-                    ?: NativeIdentity.recallByIdentityHash(destinationHash)
-            }
-            checkNotNull(recipientIdentity) {
-                "Recipient not found after path request: ${destinationHash.toHex().take(16)}"
-            }
+    private suspend fun resolveRecipientIdentity(
+        destinationHash: ByteArray,
+        deliveryMethod: DeliveryMethod,
+    ): NativeIdentity {
+        val timeoutMs = identityTimeoutsMs[deliveryMethod] ?: 10_000L
+        val recipientIdentity = pathWaiter.await(destinationHash, timeoutMs)
+        return checkNotNull(recipientIdentity) {
+            "Recipient not found after path request: ${destinationHash.toHex().take(16)}"
         }
-        return recipientIdentity
     }
 
     private fun buildFields(options: MessageOptions): MutableMap<Int, Any> {
@@ -15,6 +15,9 @@ import network.reticulum.link.LinkConstants
 import network.reticulum.transport.Transport
 import tech.torlando.lxst.audio.Signalling
 import tech.torlando.lxst.telephone.NetworkTransport
+import tech.torlando.lxst.telephone.Profile
+import java.util.concurrent.Executors
+import java.util.concurrent.ScheduledExecutorService
 
 /**
  * Native Kotlin implementation of [NetworkTransport] for LXST telephony.
@@ -25,12 +28,33 @@ import tech.torlando.lxst.telephone.NetworkTransport
  *
  * This is the critical change that fixes voice call latency caused by GIL
  * contention between the audio transmit loop and announce processing.
+ *
+ * Packets are framed by [LxstWireCodec] / [LxstPacketDecoder] rather than a
+ * msgpack packer per frame. On slow links outbound frames are bundled several
+ * per packet ([LxstFrameBundler], sized by [LxstBundlePolicy] from the link RTT
+ * and the call profile's frame time); inbound bundles are unpacked frame by frame.
+ * Frames are only bundled towards a peer that sent
+ * [LxstBundlePolicy.FRAME_BUNDLES_SIGNAL]: the callee sends it once it has
+ * accepted the call link, and a caller that understands it answers in kind.
  */
 class NativeNetworkTransport : NetworkTransport {
     companion object {
         private const val TAG = "NativeNetworkTransport"
         private const val LXST_APP_NAME = "lxst"
         private const val LXST_ASPECT = "telephony"
+
+        /**
+         * LXST PREFERRED_PROFILE signal base: signal `PREFERRED_PROFILE + id`
+         * asks the receiving Telephone to switch to profile `id`.
+         */
+        private const val PREFERRED_PROFILE_SIGNAL = 0xFF
+
+        /** Fires partial-bundle flushes and call playout ticks for the process. */
+        internal val callScheduler: ScheduledExecutorService by lazy {
+            Executors.newSingleThreadScheduledExecutor { r ->
+                Thread(r, "LxstCallTimer").apply { isDaemon = true }
+            }
+        }
     }
 
     // These fields are written from both coroutines (call lifecycle) and
@@ -43,8 +67,47 @@ class NativeNetworkTransport : NetworkTransport {
 
     @Volatile private var signalCallback: ((Int) -> Unit)? = null
 
+    @Volatile private var linkClosedCallback: (() -> Unit)? = null
+
     @Volatile private var locallyClosingLink: Link? = null
 
+    /** Profile id of the current outgoing call, or null (inbound: frame time is measured). */
+    @Volatile private var activeProfileId: Int? = null
+
+    /** Whether the peer on [activeLink] sent [LxstBundlePolicy.FRAME_BUNDLES_SIGNAL]... */
+    @Volatile private var peerAcceptsBundles = false
+
+    /** ...and whether we did. */
+    @Volatile private var bundleSupportSent = false
+
+    private val bundler =
+        LxstFrameBundler(scheduler = callScheduler) { packet ->
+            activeLink?.takeIf { it.status == LinkConstants.ACTIVE }?.send(packet)
+        }
+
+    private val decoder = LxstPacketDecoder()
+
+    private val inboundSink =
+        object : LxstPacketDecoder.Sink {
+            override fun onSignal(signal: Int) {
+                Log.d(TAG, "Inbound signal 0x${signal.toString(16)}")
+                if (signal == LxstBundlePolicy.FRAME_BUNDLES_SIGNAL) {
+                    // Ours, not the Telephone's
+                    peerAcceptsBundles = true
+                    sendBundleSupport()
+                    return
+                }
+                // Note: we identify proactively after link establishment
+                // (see establishLinkToIdentity), so no need to re-identify
+                // on STATUS_AVAILABLE. Double-identify confuses Python Sideband.
+                signalCallback?.invoke(signal)
+            }
+
+            override fun onFrame(frame: ByteArray) {
+                packetCallback?.invoke(frame)
+            }
+        }
+
     /**
      * Local identity used to identify ourselves to the remote peer.
      *
@@ -58,6 +121,31 @@ class NativeNetworkTransport : NetworkTransport {
         localIdentity = identity
     }
 
+    /**
+     * Set the profile of the call about to be placed, so frame bundling knows
+     * the frame time up front. Without it the frame interval is measured.
+     */
+    fun setProfile(profile: Profile) {
+        activeProfileId = profile.id
+    }
+
+    /** Round trip time of the call link in ms, or null without an active link. */
+    val linkRttMs: Long?
+        get() = activeLink?.takeIf { it.status == LinkConstants.ACTIVE }?.rtt?.toLong()
+
+    /**
+     * Move both ends of the call to LXST profile [profileId], as LXST's own
+     * profile negotiation does: the peer gets PREFERRED_PROFILE over the link
+     * and the local Telephone receives the same signal, so it reconfigures its
+     * pipeline without re-sending it.
+     */
+    fun requestProfile(profileId: Int) {
+        val signal = PREFERRED_PROFILE_SIGNAL + profileId
+        sendSignal(signal)
+        activeProfileId = profileId
+        signalCallback?.invoke(signal)
+    }
+
     private fun handleLinkClosed(
         link: Link,
         reason: Int,
@@ -70,6 +158,8 @@ class NativeNetworkTransport : NetworkTransport {
         }
         if (activeLink === link) {
             activeLink = null
+            resetBundling()
+            linkClosedCallback?.invoke()
         }
 
         // Mirror the old Python path: remote link close notifies Telephone with
@@ -143,6 +233,7 @@ class NativeNetworkTransport : NetworkTransport {
                 },
             )
 
+        resetBundling()
         activeLink = link
         // Install callbacks immediately after Link.create(). The callee can send
         // STATUS_AVAILABLE as soon as the link comes up; if we wait until the
@@ -179,45 +270,45 @@ class NativeNetworkTransport : NetworkTransport {
         } else {
             Log.w(TAG, "Link failed to establish (status=${link.status})")
             activeLink = null
+            resetBundling()
             false
         }
     }
 
     override fun teardownLink() {
-        activeLink?.let { link ->
+        val link = activeLink
+        if (link != null) {
             Log.i(TAG, "Tearing down link")
             locallyClosingLink = link
             link.teardown()
         }
         activeLink = null
+        resetBundling()
+        if (link != null) linkClosedCallback?.invoke()
     }
 
     override fun sendPacket(encodedFrame: ByteArray) {
         val link = activeLink ?: return
         if (link.status != LinkConstants.ACTIVE) return
-        // Wrap audio in msgpack {FIELD_FRAMES(1): binary} for Python interop
-        val packer =
-            org.msgpack.core.MessagePack
-                .newDefaultBufferPacker()
-        packer.packMapHeader(1)
-        packer.packInt(0x01) // FIELD_FRAMES
-        packer.packBinaryHeader(encodedFrame.size)
-        packer.writePayload(encodedFrame)
-        link.send(packer.toByteArray())
+        // Audio goes out as msgpack {FIELD_FRAMES(1): binary} (or a list of
+        // them when bundled) for Python interop
+        val frameTime =
+            activeProfileId?.let(LxstBundlePolicy::frameTimeMs)
+                ?: bundler.measuredFrameIntervalMs
+        if (frameTime != null) {
+            bundler.frameTimeMs = frameTime
+            bundler.framesPerPacket = LxstBundlePolicy.framesPerPacket(frameTime, link.rtt?.toLong(), peerAcceptsBundles)
+        }
+        bundler.offer(encodedFrame)
     }
 
     override fun sendSignal(signal: Int) {
         val link = activeLink ?: return
         if (link.status != LinkConstants.ACTIVE) return
+        // Audio staged before the signal goes first, keeping wire order
+        bundler.flush()
         // Wrap signal in msgpack {FIELD_SIGNALLING(0): [signal]} for Python interop
-        val packer =
-            org.msgpack.core.MessagePack
-                .newDefaultBufferPacker()
-        packer.packMapHeader(1)
-        packer.packInt(0x00) // FIELD_SIGNALLING
-        packer.packArrayHeader(1)
-        packer.packInt(signal)
-        link.send(packer.toByteArray())
+        link.send(LxstWireCodec.encodeSignal(signal))
     }
 
     override fun setPacketCallback(callback: (ByteArray) -> Unit) {
@@ -228,6 +319,11 @@ class NativeNetworkTransport : NetworkTransport {
         signalCallback = callback
     }
 
+    /** Called once the call link is gone, whichever end closed it. */
+    fun setLinkClosedCallback(callback: () -> Unit) {
+        linkClosedCallback = callback
+    }
+
     /**
      * Accept an inbound link from an incoming caller.
      *
@@ -239,6 +335,8 @@ class NativeNetworkTransport : NetworkTransport {
      */
     fun acceptInboundLink(link: Link) {
         Log.i(TAG, "Accepting inbound call link: ${link.linkId.toHex().take(16)}")
+        resetBundling()
+        activeProfileId = null
         activeLink = link
         link.setPacketCallback { data, _ ->
             handleIncomingPacket(data)
@@ -246,6 +344,20 @@ class NativeNetworkTransport : NetworkTransport {
         link.setLinkClosedCallback { l ->
             handleLinkClosed(link, l.teardownReason, "Inbound link")
         }
+        sendBundleSupport()
+    }
+
+    private fun sendBundleSupport() {
+        if (bundleSupportSent) return
+        bundleSupportSent = true
+        sendSignal(LxstBundlePolicy.FRAME_BUNDLES_SIGNAL)
+    }
+
+    /** Drop staged frames and the peer's bundle support along with its link. */
+    private fun resetBundling() {
+        peerAcceptsBundles = false
+        bundleSupportSent = false
+        bundler.clear()
     }
 
     private fun handleIncomingPacket(data: ByteArray) {
@@ -254,7 +366,11 @@ class NativeNetworkTransport : NetworkTransport {
         // Python LXST sends data as msgpack maps:
         //   {0: [signal_value, ...]} for signals (FIELD_SIGNALLING=0x00)
         //   {1: binary_audio}        for audio frames (FIELD_FRAMES=0x01)
+        //   {1: [binary_audio, ...]} for bundled audio frames
         // Also handle raw 1-byte signals for Kotlin↔Kotlin calls.
+        if (data.size > 1 && decoder.decode(data, inboundSink)) return
+
+        // Anything the fast decoder doesn't recognise takes the generic path
         val unpacked =
             try {
                 org.msgpack.core.MessagePack
@@ -278,17 +394,16 @@ class NativeNetworkTransport : NetworkTransport {
 
             if (signalling != null && signalling.isArrayValue) {
                 for (sig in signalling.asArrayValue()) {
-                    val signal = sig.asIntegerValue().toInt()
-                    Log.d(TAG, "Inbound signal 0x${signal.toString(16)}")
-                    // Note: we identify proactively after link establishment
-                    // (see establishLinkToIdentity), so no need to re-identify
-                    // on STATUS_AVAILABLE. Double-identify confuses Python Sideband.
-                    signalCallback?.invoke(signal)
+                    inboundSink.onSignal(sig.asIntegerValue().toInt())
                 }
             }
 
             if (frames != null && frames.isBinaryValue) {
-                packetCallback?.invoke(frames.asBinaryValue().asByteArray())
+                inboundSink.onFrame(frames.asBinaryValue().asByteArray())
+            } else if (frames != null && frames.isArrayValue) {
+                for (frame in frames.asArrayValue()) {
+                    if (frame.isBinaryValue) inboundSink.onFrame(frame.asBinaryValue().asByteArray())
+                }
             }
         } else if (data.size == 1) {
             val signal = data[0].toInt() and 0xFF
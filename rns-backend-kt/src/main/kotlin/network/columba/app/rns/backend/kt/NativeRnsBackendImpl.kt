@@ -7,6 +7,7 @@ import network.columba.app.rns.api.model.DeliveryStatusUpdate
 import network.columba.app.rns.api.model.DiscoveredInterface
 import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.IconAppearance
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.rns.api.model.LocationTelemetry
 import network.columba.app.rns.api.model.MessageReceipt
 import network.columba.app.rns.api.model.PropagationState
@@ -14,10 +15,13 @@ import network.columba.app.rns.api.model.ReceivedMessage
 import network.columba.app.rns.api.model.VoiceCallState
 import network.columba.app.rns.api.util.AppDataParser
 import network.columba.app.rns.api.util.Aspects
+import network.columba.app.rns.api.util.InterfaceCounters
 import network.columba.app.rns.api.util.LxmfFields
 import network.columba.app.rns.api.util.ReactionWireCodec
 import network.columba.app.rns.api.util.hexToBytes
+import network.columba.app.rns.api.util.interfaceStatsSnapshots
 import network.columba.app.rns.api.util.isUserVisibleChatMessage
+import network.columba.app.rns.api.util.pathTableDeltas
 import network.columba.app.rns.api.util.toHex
 
 import android.util.Log
@@ -48,6 +52,7 @@ import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.NodeType
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.ReceivedPacket
 import network.columba.app.rns.api.model.ReticulumConfig
 import network.reticulum.Reticulum
@@ -100,6 +105,13 @@ class NativeRnsBackendImpl(
      * allowed through (preserves the pre-feature behaviour).
      */
     private val callPrivacyBridge: CallPrivacyBridge? = null,
+    /**
+     * Builds the Reticulum Room database in place of the on-disk `reticulum.db`.
+     * Used by the headless node harness to run the transport stores against an
+     * in-memory database without handing the backend a Context (which would
+     * also start battery monitoring and telephony). Null in production.
+     */
+    private val reticulumDatabaseFactory: (() -> network.reticulum.android.db.ReticulumDatabase)? = null,
 ) : network.columba.app.rns.api.RnsCore,
     network.columba.app.rns.api.RnsLxmf,
     network.columba.app.rns.api.RnsTelephony,
@@ -116,6 +128,12 @@ class NativeRnsBackendImpl(
         /** Live-poll cadence for `propagationTransferState`. ~2 polls / second. */
         private const val PROPAGATION_POLL_INTERVAL_MS = 500L
 
+        /** Snapshot cadence for `observePathTable`. Paths change on announce timescales. */
+        private const val PATH_TABLE_POLL_INTERVAL_MS = 5_000L
+
+        /** Sampling cadence for `observeInterfaceStats`. */
+        private const val INTERFACE_STATS_INTERVAL_MS = 1_000L
+
         fun NativeIdentity.toColumba(): ColumbaIdentity =
             ColumbaIdentity(
                 hash = this.hash,
@@ -258,7 +276,7 @@ class NativeRnsBackendImpl(
 
     // Telemetry collector state
     @Volatile private var telemetryCollectorEnabled = false
-    private val storedTelemetry = java.util.concurrent.ConcurrentHashMap<String, NativeTelemetryHandler.StoredTelemetryEntry>()
+    private val telemetryStore = TelemetryCollectorStore()
 
     @Volatile private var telemetryAllowedRequesters = emptySet<String>()
 
@@ -344,9 +362,17 @@ class NativeRnsBackendImpl(
             deliveryDestinationProvider = { deliveryDestination },
             deliveryStatusFlow = _deliveryStatus,
             scopeProvider = { scope },
+            pathWaiter = pathWaiter,
         )
     }
 
+    /** Woken by the announce handler, so sends to unknown peers don't poll. */
+    private val pathWaiter =
+        PathWaiter(
+            recall = { hash -> NativeIdentity.recall(hash) ?: NativeIdentity.recallByIdentityHash(hash) },
+            requestPath = { hash -> Transport.requestPath(hash) },
+        )
+
     private val telemetryHandler by lazy {
         NativeTelemetryHandler(
             scopeProvider = { scope },
@@ -360,7 +386,7 @@ class NativeRnsBackendImpl(
                     options = NativeMessageSender.MessageOptions(extraFields = extraFields),
                 )
             },
-            storedTelemetry = storedTelemetry,
+            telemetryStore = telemetryStore,
             telemetryCollectorEnabledProvider = { telemetryCollectorEnabled },
             telemetryAllowedRequestersProvider = { telemetryAllowedRequesters },
         )
@@ -438,23 +464,24 @@ class NativeRnsBackendImpl(
     private fun initializePersistentStores(configDir: String) {
         if (reticulumDatabase != null) return
 
-        val context = appContext?.applicationContext
-        if (context == null) {
+        val db =
+            reticulumDatabaseFactory?.invoke()
+                ?: appContext?.applicationContext?.let { context ->
+                    Room
+                        .databaseBuilder(
+                            context,
+                            network.reticulum.android.db.ReticulumDatabase::class.java,
+                            "reticulum.db",
+                        ).addMigrations(
+                            network.reticulum.android.db.ReticulumDatabase.MIGRATION_1_2,
+                            network.reticulum.android.db.ReticulumDatabase.MIGRATION_2_3,
+                        ).build()
+                }
+        if (db == null) {
             Log.w(TAG, "No appContext — skipping Room persistent store setup")
             return
         }
 
-        val db =
-            Room
-                .databaseBuilder(
-                    context,
-                    network.reticulum.android.db.ReticulumDatabase::class.java,
-                    "reticulum.db",
-                ).addMigrations(
-                    network.reticulum.android.db.ReticulumDatabase.MIGRATION_1_2,
-                    network.reticulum.android.db.ReticulumDatabase.MIGRATION_2_3,
-                ).build()
-
         val executor =
             java.util.concurrent.Executors.newSingleThreadExecutor { runnable ->
                 Thread(runnable, "NativeReticulumDB-write").apply { isDaemon = true }
@@ -500,6 +527,7 @@ class NativeRnsBackendImpl(
     }
 
     private fun closePersistentStores() {
+        telemetryStore.close()
         Transport.pathStore = null
         Transport.packetHashStore = null
         Transport.tunnelStore = null
@@ -585,6 +613,7 @@ class NativeRnsBackendImpl(
                 }
 
                 initializePersistentStores(config.storagePath)
+                telemetryStore.open(java.io.File(config.storagePath, "telemetry_collector.log"))
 
                 // Start Reticulum with a fresh in-memory transport identity so the
                 // node-level RPC private key never touches disk. Transport identity
@@ -758,6 +787,9 @@ class NativeRnsBackendImpl(
                     receivingInterfaceName: String?,
                     matchedAspect: String?,
                 ): Boolean {
+                    // Any announce (including path responses) makes its identity recallable
+                    pathWaiter.onIdentityKnown(destinationHash, announcedIdentity)
+                    pathWaiter.onIdentityKnown(announcedIdentity.hash, announcedIdentity)
                     if (matchedAspect == null) return false // unknown aspect — not an app we handle
                     handleAnnounce(matchedAspect, destinationHash, announcedIdentity, appData, hops, receivingInterfaceName)
                     return true
@@ -1058,6 +1090,15 @@ class NativeRnsBackendImpl(
 
     override suspend fun getPathTableHashes(): List<String> = Transport.pathTable.keys.map { it.toString() }
 
+    // Transport has no path-table listener; diff snapshots in-process so only deltas leave it
+    override fun observePathTable(): Flow<PathTableDelta> =
+        pathTableDeltas(PATH_TABLE_POLL_INTERVAL_MS) {
+            Transport.pathTable.keys.associate { key ->
+                val hex = key.toString()
+                hex to (Transport.hopsTo(hex.hexToBytes()) ?: 0)
+            }
+        }
+
     override suspend fun persistTransportData() {
         // Transport persists automatically via its internal mechanisms
         NativeIdentity.saveKnownDestinations()
@@ -1462,25 +1503,44 @@ class NativeRnsBackendImpl(
         iconAppearance: IconAppearance?,
     ): Result<Unit> =
         runCatching {
-            val locationData = JSONObject(locationJson)
-            val ownHash = deliveryDestination?.hexHash ?: deliveryIdentity?.hexHash ?: "local"
-            val appearanceField =
-                iconAppearance?.let {
-                    listOf(
-                        it.iconName,
-                        it.foregroundColor.hexToBytes(),
-                        it.backgroundColor.hexToBytes(),
-                    )
-                }
-            telemetryHandler.storeTelemetryForCollector(
-                sourceHashHex = ownHash,
-                packedTelemetry = telemetryHandler.packLocationTelemetry(locationData),
-                timestampSeconds = locationData.optLong("ts", System.currentTimeMillis()) / 1000L,
-                appearanceField = appearanceField,
+            val telemetry = checkNotNull(LocationTelemetryBuilder.decodeJsonLocation(locationJson)) { "Not a location: $locationJson" }
+            val ts = if (telemetry.ts > 0) telemetry.ts else System.currentTimeMillis()
+            storeOwnPackedTelemetry(
+                packedTelemetry = network.columba.app.rns.api.util.TelemeterCodec.packLocationTelemetry(telemetry.copy(ts = ts)),
+                timestampSeconds = ts / 1000L,
+                iconAppearance = iconAppearance,
             )
-            Log.d(TAG, "Stored own telemetry ($ownHash)")
         }
 
+    override suspend fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ): Result<Unit> = runCatching { storeOwnPackedTelemetry(packedTelemetry, timestampSeconds, iconAppearance) }
+
+    private fun storeOwnPackedTelemetry(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ) {
+        val ownHash = deliveryDestination?.hexHash ?: deliveryIdentity?.hexHash ?: "local"
+        val appearanceField =
+            iconAppearance?.let {
+                listOf(
+                    it.iconName,
+                    it.foregroundColor.hexToBytes(),
+                    it.backgroundColor.hexToBytes(),
+                )
+            }
+        telemetryHandler.storeTelemetryForCollector(
+            sourceHashHex = ownHash,
+            packedTelemetry = packedTelemetry,
+            timestampSeconds = timestampSeconds,
+            appearanceField = appearanceField,
+        )
+        Log.d(TAG, "Stored own telemetry ($ownHash)")
+    }
+
     override suspend fun setTelemetryAllowedRequesters(allowedHashes: Set<String>): Result<Unit> =
         runCatching {
             telemetryAllowedRequesters = allowedHashes.toSet()
@@ -1904,18 +1964,40 @@ class NativeRnsBackendImpl(
 
     override suspend fun getInterfaceStats(interfaceName: String): Map<String, Any>? {
         val iface = Transport.getInterfaces().find { it.name == interfaceName } ?: return null
-        return mapOf(
-            "name" to iface.name,
-            "online" to iface.online,
-            "status" to if (iface.online) "Online" else "Offline",
-            "rxb" to iface.rxBytes,
-            "txb" to iface.txBytes,
-            "mode" to iface.mode.name,
-            "bitrate" to iface.bitrate,
-            "mtu" to iface.hwMtu,
-        )
+        val stats =
+            mutableMapOf<String, Any>(
+                "name" to iface.name,
+                "online" to iface.online,
+                "status" to if (iface.online) "Online" else "Offline",
+                "rxb" to iface.rxBytes,
+                "txb" to iface.txBytes,
+                "mode" to iface.mode.name,
+                "bitrate" to iface.bitrate,
+                "mtu" to iface.hwMtu,
+            )
+        NativeInterfaceFactory.supervisionStats(interfaceName)?.let { supervision ->
+            stats["uptimeMs"] = supervision.uptimeMs
+            stats["totalUptimeMs"] = supervision.totalUptimeMs
+            stats["reconnectAttempts"] = supervision.reconnectAttempts
+            stats["reconnects"] = supervision.reconnects
+            supervision.nextRetryAtMs?.let { stats["nextRetryAtMs"] = it }
+        }
+        return stats
     }
 
+    // Interfaces keep running byte counters but have no change listener; sample them
+    override fun observeInterfaceStats(): Flow<List<InterfaceStatsSnapshot>> =
+        interfaceStatsSnapshots(INTERFACE_STATS_INTERVAL_MS) {
+            Transport.getInterfaces().map { iface ->
+                InterfaceCounters(
+                    name = iface.name,
+                    online = iface.online,
+                    rxBytes = iface.rxBytes,
+                    txBytes = iface.txBytes,
+                )
+            }
+        }
+
     override suspend fun getDiscoveredInterfaces(): List<DiscoveredInterface> =
         Transport.listDiscoveredInterfaces().map { (info, status) ->
             val statusCode =
@@ -2175,14 +2257,21 @@ class NativeRnsBackendImpl(
                         remoteIdentity = remoteIdentity,
                         profile = null,
                     )
-                is tech.torlando.lxst.core.CallState.Active ->
+                is tech.torlando.lxst.core.CallState.Active -> {
+                    val quality = callManager?.qualityStats()
                     VoiceCallState(
                         status = "active",
                         isActive = true,
                         isMuted = isMuted,
                         remoteIdentity = remoteIdentity,
                         profile = callManager?.telephone?.activeProfile?.abbreviation,
+                        lossPercent = quality?.lossPercent,
+                        jitterMs = quality?.jitterMs,
+                        bufferDepthMs = quality?.bufferDepthMs,
+                        rttMs = quality?.rttMs ?: callTransport.linkRttMs,
+                        mouthToEarMs = quality?.mouthToEarMs,
                     )
+                }
             }
         }
 
@@ -0,0 +1,72 @@
+package network.columba.app.rns.backend.kt
+
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.withTimeoutOrNull
+import network.columba.app.rns.api.util.toHex
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Registry of callers waiting for a destination's identity to become known.
+ *
+ * [await] returns as soon as the announce handler reports the identity via
+ * [onIdentityKnown] (path responses arrive as announces through the same
+ * handler), instead of polling the identity store. Concurrent waiters for one
+ * destination share a single pending entry and a single path request.
+ *
+ * @param recall Looks the identity up in the local store
+ * @param requestPath Issues a path request for a destination
+ */
+internal class PathWaiter<T : Any>(
+    private val recall: (ByteArray) -> T?,
+    private val requestPath: (ByteArray) -> Unit,
+) {
+    private class Pending<T> {
+        val result = CompletableDeferred<T>()
+        var waiters = 0
+    }
+
+    private val pending = ConcurrentHashMap<String, Pending<T>>()
+
+    /**
+     * Return the identity for [destinationHash], requesting a path and
+     * waiting up to [timeoutMs] for it if it isn't known yet. Null on timeout.
+     */
+    suspend fun await(
+        destinationHash: ByteArray,
+        timeoutMs: Long,
+    ): T? {
+        recall(destinationHash)?.let { return it }
+
+        val key = destinationHash.toHex()
+        var first = false
+        val entry =
+            pending.compute(key) { _, existing ->
+                (existing ?: Pending<T>().also { first = true }).also { it.waiters++ }
+            }!!
+        try {
+            // The announce may have landed between the recall above and registration
+            recall(destinationHash)?.let { entry.result.complete(it) }
+            if (first && !entry.result.isCompleted) requestPath(destinationHash)
+            return withTimeoutOrNull(timeoutMs) { entry.result.await() } ?: recall(destinationHash)
+        } finally {
+            pending.computeIfPresent(key) { _, current ->
+                when {
+                    current !== entry -> current
+                    --current.waiters == 0 -> null
+                    else -> current
+                }
+            }
+        }
+    }
+
+    /** Wake every caller waiting on [destinationHash]. */
+    fun onIdentityKnown(
+        destinationHash: ByteArray,
+        identity: T,
+    ) {
+        if (pending.isEmpty()) return
+        pending.remove(destinationHash.toHex())?.result?.complete(identity)
+    }
+
+    fun pendingCount(): Int = pending.size
+}
@@ -15,8 +15,7 @@ internal object RNodeConnectionHelper {
         hostBridge: RNodeHostBridge?,
         scope: CoroutineScope,
         onRegisterAndTrack: (String, network.reticulum.interfaces.Interface) -> Unit,
-        onMonitorLifecycle: (InterfaceConfig.RNode, network.reticulum.interfaces.rnode.RNodeInterface) -> Unit,
-        onEnsureRecovery: (InterfaceConfig.RNode) -> Unit,
+        onStartFailed: (InterfaceConfig.RNode) -> Unit,
     ) {
         val ctx = appContext
         if (ctx == null) {
@@ -46,11 +45,15 @@ internal object RNodeConnectionHelper {
                     }
                 }
 
+            // Framebuffer uploads only send lines the device doesn't already show,
+            // coalesced into a few writes paced by the link itself. The cache lives
+            // and dies with this connection.
+            val framebufferCache = RNodeFramebufferCache()
             val iface =
                 network.reticulum.interfaces.rnode.RNodeInterface(
                     name = config.name,
-                    inputStream = input,
-                    outputStream = output,
+                    inputStream = RNodeResetWatchInputStream(input, deviceKey = config.name, cache = framebufferCache),
+                    outputStream = RNodeFramebufferOutputStream(output, deviceKey = config.name, cache = framebufferCache),
                     frequency = config.frequency,
                     bandwidth = config.bandwidth.toLong(),
                     txPower = config.txPower,
@@ -58,8 +61,8 @@ internal object RNodeConnectionHelper {
                     codingRate = config.codingRate,
                     flowControl = config.connectionMode == "usb",
                     activityKeepaliveMs = if (config.connectionMode == "tcp") 3_500L else null,
-                    framebufferLineDelayMs = if (config.connectionMode == "tcp") 15L else 0L,
-                    framebufferEnableDelayMs = if (config.connectionMode == "tcp") 50L else 0L,
+                    framebufferLineDelayMs = 0L,
+                    framebufferEnableDelayMs = 0L,
                     // Safe to pass the factory's process-lifetime scope directly (unlike
                     // AndroidBLEDriver, which cancels its scope in shutdown()). RNodeInterface
                     // derives an internal ioScope with a child SupervisorJob tied to this
@@ -77,12 +80,13 @@ internal object RNodeConnectionHelper {
                 )
             }
             iface.start()
+            // Registration attaches it to the interface supervisor, which
+            // handles offline edges from here on
             onRegisterAndTrack(config.name, iface)
-            onMonitorLifecycle(config, iface)
             Log.i(TAG, "RNode interface started: ${config.name} (${config.connectionMode})")
         } catch (e: Exception) {
             Log.e(TAG, "Failed to start RNode interface ${config.name}: ${e.message}", e)
-            onEnsureRecovery(config)
+            onStartFailed(config)
         }
     }
 
@@ -0,0 +1,229 @@
+package network.columba.app.rns.backend.kt
+
+import android.util.Log
+import java.io.ByteArrayOutputStream
+import java.io.FilterInputStream
+import java.io.FilterOutputStream
+import java.io.InputStream
+import java.io.OutputStream
+
+/**
+ * Framebuffer lines sent to an RNode over one connection, so a repeated
+ * upload only re-sends the lines that changed. One instance is shared by a
+ * connection's two stream wrappers and starts empty, so a new connection
+ * always uploads in full; it is also reset when the output stream closes and
+ * when the device reports a reboot, since either can leave the panel blank.
+ */
+internal class RNodeFramebufferCache {
+    companion object {
+        const val LINES = 64
+        const val BYTES_PER_LINE = 8
+    }
+
+    private val sent = arrayOfNulls<ByteArray>(LINES)
+
+    @Synchronized
+    fun shows(
+        line: Int,
+        pixels: ByteArray,
+    ): Boolean = sent[line]?.contentEquals(pixels) == true
+
+    @Synchronized
+    fun record(lines: List<Pair<Int, ByteArray>>) {
+        lines.forEach { (line, pixels) -> sent[line] = pixels }
+    }
+
+    @Synchronized
+    fun forget() {
+        sent.fill(null)
+    }
+}
+
+/**
+ * Turns reticulum-kt's line-by-line framebuffer upload into a delta upload.
+ *
+ * RNodeInterface writes every `CMD_FB_WRITE` line as its own frame. Lines
+ * this device already shows (per [cache]) are dropped; the
+ * rest are held and written in chunks of at most [maxWriteBytes] once the
+ * last line goes by or any other frame is written. The wrapped stream's own
+ * backpressure paces the chunks (the BLE stream waits for each write
+ * callback), so RNodeInterface's per-line delays can be zero.
+ *
+ * A write that isn't exactly one framebuffer line frame passes straight
+ * through, after any held lines, so frame order is unchanged.
+ */
+internal class RNodeFramebufferOutputStream(
+    out: OutputStream,
+    private val deviceKey: String,
+    private val cache: RNodeFramebufferCache,
+    private val maxWriteBytes: Int = DEFAULT_MAX_WRITE_BYTES,
+) : FilterOutputStream(out) {
+    companion object {
+        private const val TAG = "RNodeFramebuffer"
+        const val DEFAULT_MAX_WRITE_BYTES = 512
+        private const val FEND = 0xC0.toByte()
+        private const val FESC = 0xDB.toByte()
+        private const val TFEND = 0xDC.toByte()
+        private const val TFESC = 0xDD.toByte()
+        private const val CMD_FB_WRITE = 0x43.toByte()
+
+        /** Line number and pixels of a whole `CMD_FB_WRITE` frame, or null for anything else. */
+        internal fun parseLineFrame(
+            b: ByteArray,
+            off: Int,
+            len: Int,
+        ): Pair<Int, ByteArray>? {
+            if (len < 4 || b[off] != FEND || b[off + 1] != CMD_FB_WRITE || b[off + len - 1] != FEND) return null
+            val payload = ByteArray(1 + RNodeFramebufferCache.BYTES_PER_LINE)
+            var size = 0
+            var i = off + 2
+            while (i < off + len - 1) {
+                var byte = b[i]
+                if (byte == FEND) return null
+                if (byte == FESC) {
+                    i++
+                    byte =
+                        when (b.getOrNull(i)) {
+                            TFEND -> FEND
+                            TFESC -> FESC
+                            else -> return null
+                        }
+                }
+                if (size == payload.size) return null
+                payload[size++] = byte
+                i++
+            }
+            if (size != payload.size) return null
+            val line = payload[0].toInt() and 0xFF
+            if (line >= RNodeFramebufferCache.LINES) return null
+            return line to payload.copyOfRange(1, payload.size)
+        }
+    }
+
+    private val pending = ByteArrayOutputStream(maxWriteBytes)
+    private val pendingLines = mutableListOf<Pair<Int, ByteArray>>()
+
+    /** Lines dropped because the device already shows them. */
+    @Volatile
+    var skippedLines = 0
+        private set
+
+    @Synchronized
+    override fun write(b: Int) {
+        flushPending()
+        out.write(b)
+    }
+
+    @Synchronized
+    override fun write(
+        b: ByteArray,
+        off: Int,
+        len: Int,
+    ) {
+        val lineFrame = parseLineFrame(b, off, len)
+        if (lineFrame == null) {
+            flushPending()
+            out.write(b, off, len)
+            return
+        }
+        val (line, pixels) = lineFrame
+        if (cache.shows(line, pixels) && pendingLines.none { it.first == line }) {
+            skippedLines++
+        } else {
+            if (pending.size() > 0 && pending.size() + len > maxWriteBytes) writePending()
+            pending.write(b, off, len)
+            pendingLines.add(lineFrame)
+        }
+        if (line == RNodeFramebufferCache.LINES - 1) flushPending()
+    }
+
+    /**
+     * Held lines are not pushed out by flush(): RNodeInterface flushes after
+     * every frame, which would undo the batching. They go out on the last
+     * line, the next non-line write, or close().
+     */
+    @Synchronized
+    override fun flush() {
+        if (pending.size() == 0) out.flush()
+    }
+
+    @Synchronized
+    override fun close() {
+        runCatching { flushPending() }
+        // The connection is ending; a new one starts from a full upload
+        cache.forget()
+        super.close()
+    }
+
+    private fun flushPending() {
+        if (pending.size() == 0) return
+        writePending()
+        out.flush()
+    }
+
+    private fun writePending() {
+        try {
+            out.write(pending.toByteArray())
+        } catch (e: Exception) {
+            // Unknown how much arrived; send everything next time
+            cache.forget()
+            pending.reset()
+            pendingLines.clear()
+            throw e
+        }
+        cache.record(pendingLines)
+        if (pendingLines.size > 0) {
+            Log.d(TAG, "$deviceKey: wrote ${pendingLines.size} framebuffer lines in ${pending.size()} bytes")
+        }
+        pending.reset()
+        pendingLines.clear()
+    }
+}
+
+/**
+ * Watches the RNode's inbound stream for the `CMD_RESET 0xF8` frame it
+ * sends after booting, and forgets [cache] when it appears. Bytes are
+ * passed through untouched.
+ */
+internal class RNodeResetWatchInputStream(
+    input: InputStream,
+    private val deviceKey: String,
+    private val cache: RNodeFramebufferCache,
+) : FilterInputStream(input) {
+    private companion object {
+        val RESET_BOOTED_FRAME = byteArrayOf(0xC0.toByte(), 0x55, 0xF8.toByte(), 0xC0.toByte())
+    }
+
+    private var matched = 0
+
+    override fun read(): Int {
+        val byte = super.read()
+        if (byte >= 0) watch(byte.toByte())
+        return byte
+    }
+
+    override fun read(
+        b: ByteArray,
+        off: Int,
+        len: Int,
+    ): Int {
+        val count = super.read(b, off, len)
+        for (i in off until off + count) watch(b[i])
+        return count
+    }
+
+    private fun watch(byte: Byte) {
+        matched =
+            when (byte) {
+                RESET_BOOTED_FRAME[matched] -> matched + 1
+                RESET_BOOTED_FRAME[0] -> 1
+                else -> 0
+            }
+        if (matched == RESET_BOOTED_FRAME.size) {
+            Log.i("RNodeFramebuffer", "$deviceKey reported a reboot; resending framebuffer in full")
+            cache.forget()
+            // The closing FEND can open the next frame
+            matched = 1
+        }
+    }
+}
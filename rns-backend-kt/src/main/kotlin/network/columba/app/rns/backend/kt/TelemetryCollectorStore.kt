@@ -0,0 +1,281 @@
+package network.columba.app.rns.backend.kt
+
+import android.util.Log
+import org.msgpack.core.MessagePack
+import java.io.BufferedInputStream
+import java.io.BufferedOutputStream
+import java.io.DataInputStream
+import java.io.DataOutputStream
+import java.io.EOFException
+import java.io.File
+import java.io.FileInputStream
+import java.io.FileOutputStream
+import java.util.TreeMap
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.Executors
+import java.util.concurrent.TimeUnit
+
+/**
+ * Telemetry kept by collector mode, indexed by receive time and by sender.
+ *
+ * Entries live in memory behind two indexes: a receive-time TreeMap, so a
+ * `timebase` request is a `tailMap` range query rather than a scan, and a
+ * per-sender history capped at [maxEntriesPerSender]. Anything older than
+ * [retentionMs] is pruned.
+ *
+ * When [open]ed on a file, every entry is also appended to a length-prefixed
+ * msgpack log on a background writer, and the log is replayed on the next
+ * open, so collected telemetry survives a service restart. The log is
+ * rewritten without pruned entries once they outnumber the live ones.
+ * Persistence is best-effort: a torn tail record is dropped and write
+ * failures are logged, never thrown.
+ */
+internal class TelemetryCollectorStore(
+    private val retentionMs: Long = DEFAULT_RETENTION_MS,
+    private val maxEntriesPerSender: Int = DEFAULT_MAX_ENTRIES_PER_SENDER,
+    private val clock: () -> Long = System::currentTimeMillis,
+) {
+    companion object {
+        private const val TAG = "TelemetryCollectorStore"
+        const val DEFAULT_RETENTION_MS = 48 * 60 * 60 * 1000L
+        const val DEFAULT_MAX_ENTRIES_PER_SENDER = 32
+        private const val MAX_RECORD_BYTES = 64 * 1024
+    }
+
+    data class Entry(
+        val sourceHashHex: String,
+        val timestampSeconds: Long,
+        val packedTelemetry: ByteArray,
+        val appearanceField: List<Any>? = null,
+        val receivedAtMillis: Long,
+    )
+
+    private val byTime = TreeMap<Long, MutableList<Entry>>()
+    private val bySender = HashMap<String, ArrayDeque<Entry>>()
+    private var size = 0
+
+    private var logFile: File? = null
+    private var writer: ExecutorService? = null
+    private var output: DataOutputStream? = null
+    private var deadRecords = 0
+
+    /** Load [file] (if present) and persist new entries to it. */
+    @Synchronized
+    fun open(file: File) {
+        if (logFile == file) return
+        close()
+        clear()
+        logFile = file
+        deadRecords = 0
+        val (loaded, intact) = readLog(file)
+        loaded.forEach { index(it) }
+        prune()
+        writer =
+            Executors.newSingleThreadExecutor { runnable ->
+                Thread(runnable, "TelemetryCollector-write").apply { isDaemon = true }
+            }
+        // Rewrite a damaged log too, so new records don't land after the torn one
+        if (deadRecords > 0 || !intact) compactLocked() else writer?.execute { openOutput(file) }
+        Log.i(TAG, "Loaded $size telemetry entries from ${bySender.size} senders")
+    }
+
+    /** Flush pending writes and stop persisting. In-memory entries are kept. */
+    @Synchronized
+    fun close() {
+        writer?.let { executor ->
+            executor.execute {
+                runCatching { output?.close() }
+                output = null
+            }
+            executor.shutdown()
+            runCatching { executor.awaitTermination(5, TimeUnit.SECONDS) }
+        }
+        writer = null
+        logFile = null
+    }
+
+    @Synchronized
+    fun store(
+        sourceHashHex: String,
+        timestampSeconds: Long,
+        packedTelemetry: ByteArray,
+        appearanceField: List<Any>? = null,
+    ) {
+        // Keep the time index append-ordered even if the wall clock steps back
+        val now = maxOf(clock(), byTime.lastEntry()?.key ?: 0L)
+        val entry = Entry(sourceHashHex, timestampSeconds, packedTelemetry, appearanceField, now)
+        index(entry)
+        writer?.execute { append(entry) }
+        prune()
+        if (writer != null && deadRecords > maxOf(size, maxEntriesPerSender)) compactLocked()
+    }
+
+    /** Newest entry of every sender, oldest first. */
+    @Synchronized
+    fun latestPerSender(): List<Entry> =
+        bySender.values
+            .map { it.last() }
+            .sortedBy { it.receivedAtMillis }
+
+    /** Every entry received at or after [timebaseMillis], oldest first. */
+    @Synchronized
+    fun receivedSince(timebaseMillis: Long): List<Entry> = byTime.tailMap(timebaseMillis, true).values.flatten()
+
+    /** [sourceHashHex]'s history, oldest first. */
+    @Synchronized
+    fun history(sourceHashHex: String): List<Entry> = bySender[sourceHashHex]?.toList().orEmpty()
+
+    @Synchronized
+    fun size(): Int = size
+
+    @Synchronized
+    fun senderCount(): Int = bySender.size
+
+    @Synchronized
+    fun clear() {
+        byTime.clear()
+        bySender.clear()
+        size = 0
+    }
+
+    private fun index(entry: Entry) {
+        byTime.getOrPut(entry.receivedAtMillis) { ArrayList(1) }.add(entry)
+        val history = bySender.getOrPut(entry.sourceHashHex) { ArrayDeque() }
+        history.addLast(entry)
+        size++
+        if (history.size > maxEntriesPerSender) unindex(history.removeFirst(), fromHistory = false)
+    }
+
+    private fun unindex(
+        entry: Entry,
+        fromHistory: Boolean,
+    ) {
+        byTime[entry.receivedAtMillis]?.let { bucket ->
+            bucket.remove(entry)
+            if (bucket.isEmpty()) byTime.remove(entry.receivedAtMillis)
+        }
+        if (fromHistory) {
+            val history = bySender[entry.sourceHashHex]
+            history?.remove(entry)
+            if (history.isNullOrEmpty()) bySender.remove(entry.sourceHashHex)
+        }
+        size--
+        deadRecords++
+    }
+
+    private fun prune() {
+        val expired = byTime.headMap(clock() - retentionMs, false)
+        if (expired.isEmpty()) return
+        expired.values.flatten().forEach { unindex(it, fromHistory = true) }
+    }
+
+    // ==================== Append log ====================
+
+    private fun compactLocked() {
+        val file = logFile ?: return
+        val snapshot = byTime.values.flatten()
+        deadRecords = 0
+        writer?.execute {
+            runCatching { output?.close() }
+            output = null
+            val tmp = File(file.path + ".tmp")
+            try {
+                DataOutputStream(BufferedOutputStream(FileOutputStream(tmp))).use { out ->
+                    snapshot.forEach { writeRecord(out, it) }
+                }
+                if (!tmp.renameTo(file)) error("rename failed")
+            } catch (e: Exception) {
+                Log.w(TAG, "Telemetry log compaction failed: ${e.message}")
+                tmp.delete()
+            }
+            openOutput(file)
+        }
+    }
+
+    private fun openOutput(file: File) {
+        output =
+            try {
+                file.parentFile?.mkdirs()
+                DataOutputStream(BufferedOutputStream(FileOutputStream(file, true)))
+            } catch (e: Exception) {
+                Log.w(TAG, "Telemetry log unavailable, collecting in memory only: ${e.message}")
+                null
+            }
+    }
+
+    private fun append(entry: Entry) {
+        val out = output ?: return
+        try {
+            writeRecord(out, entry)
+            out.flush()
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to persist telemetry entry: ${e.message}")
+        }
+    }
+
+    private fun writeRecord(
+        out: DataOutputStream,
+        entry: Entry,
+    ) {
+        val packer = MessagePack.newDefaultBufferPacker()
+        MsgpackHelper.packValue(
+            packer,
+            listOf(
+                entry.sourceHashHex,
+                entry.timestampSeconds,
+                entry.receivedAtMillis,
+                entry.packedTelemetry,
+                entry.appearanceField,
+            ),
+        )
+        val bytes = packer.toByteArray()
+        out.writeInt(bytes.size)
+        out.write(bytes)
+    }
+
+    /** Entries in receive order, and whether the log was read to a clean end. */
+    private fun readLog(file: File): Pair<List<Entry>, Boolean> {
+        if (!file.exists()) return emptyList<Entry>() to true
+        val entries = mutableListOf<Entry>()
+        var intact = true
+        try {
+            DataInputStream(BufferedInputStream(FileInputStream(file))).use { input ->
+                while (true) {
+                    val length =
+                        try {
+                            input.readInt()
+                        } catch (_: EOFException) {
+                            break
+                        }
+                    if (length !in 1..MAX_RECORD_BYTES) {
+                        intact = false
+                        break
+                    }
+                    val bytes = ByteArray(length)
+                    input.readFully(bytes)
+                    readRecord(bytes)?.let { entries.add(it) }
+                }
+            }
+        } catch (_: EOFException) {
+            Log.w(TAG, "Telemetry log ends in a partial record; dropping it")
+            intact = false
+        } catch (e: Exception) {
+            Log.w(TAG, "Telemetry log unreadable after ${entries.size} entries: ${e.message}")
+            intact = false
+        }
+        return entries.sortedBy { it.receivedAtMillis } to intact
+    }
+
+    @Suppress("UNCHECKED_CAST")
+    private fun readRecord(bytes: ByteArray): Entry? =
+        runCatching {
+            val row = MessagePack.newDefaultUnpacker(bytes).use { MsgpackHelper.unpackValue(it) } as List<*>
+            Entry(
+                sourceHashHex = row[0] as String,
+                timestampSeconds = (row[1] as Number).toLong(),
+                receivedAtMillis = (row[2] as Number).toLong(),
+                packedTelemetry = row[3] as ByteArray,
+                appearanceField = row.getOrNull(4) as? List<Any>,
+            )
+        }.getOrNull()
+}
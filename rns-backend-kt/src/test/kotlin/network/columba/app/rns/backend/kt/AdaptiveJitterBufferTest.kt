@@ -0,0 +1,304 @@
+package network.columba.app.rns.backend.kt
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.nio.ByteBuffer
+import java.util.Random
+
+/**
+ * Unit tests for the native call playout path: [AdaptiveJitterBuffer] driven
+ * by deterministic packet traces, and [ProfileDowngradeTrigger].
+ *
+ * Traces are generated from a fixed seed: frames captured at the profile's
+ * cadence, optionally bundled, delayed by a base latency plus uniform jitter,
+ * and dropped per packet at a given rate. The simulator replays arrivals on a
+ * 10 ms tick, the same cadence [CallPlayout] uses.
+ */
+class AdaptiveJitterBufferTest {
+    private class Arrival(
+        val atMs: Long,
+        val index: Int,
+    )
+
+    private class Run(
+        val buffer: AdaptiveJitterBuffer,
+        val played: List<Int>,
+        val depthAt: Map<Long, Int>,
+        val windowLossSamples: List<Float>,
+    )
+
+    private fun frame(index: Int): ByteArray = ByteBuffer.allocate(4).putInt(index).array()
+
+    private fun indexOf(frame: ByteArray): Int = ByteBuffer.wrap(frame).int
+
+    private fun trace(
+        frames: Int,
+        frameTimeMs: Int,
+        seed: Long,
+        jitterMs: Int,
+        lossRate: Double = 0.0,
+        framesPerPacket: Int = 1,
+        baseDelayMs: Int = 100,
+    ): List<Arrival> {
+        val random = Random(seed)
+        val arrivals = ArrayList<Arrival>()
+        for (first in 0 until frames step framesPerPacket) {
+            val last = minOf(first + framesPerPacket, frames) - 1
+            // A packet leaves once its last frame is captured
+            val arrival = last.toLong() * frameTimeMs + baseDelayMs + random.nextInt(jitterMs + 1)
+            if (random.nextDouble() < lossRate) continue
+            for (i in first..last) arrivals.add(Arrival(arrival, i))
+        }
+        return arrivals.sortedBy { it.atMs }
+    }
+
+    private fun simulate(
+        arrivals: List<Arrival>,
+        frameTimeMs: Int,
+        untilMs: Long = arrivals.last().atMs,
+    ): Run {
+        val buffer = AdaptiveJitterBuffer().apply { this.frameTimeMs = frameTimeMs }
+        val out = ArrayList<ByteArray>()
+        val depthAt = HashMap<Long, Int>()
+        val lossSamples = ArrayList<Float>()
+        var next = 0
+        var now = 0L
+        while (now <= untilMs) {
+            while (next < arrivals.size && arrivals[next].atMs <= now) {
+                buffer.push(frame(arrivals[next].index), now)
+                next++
+            }
+            buffer.poll(now, out)
+            depthAt[now] = buffer.depthMs
+            if (now % 1_000 == 0L && buffer.lossWindowFull) lossSamples.add(buffer.lossPercent)
+            now += CallPlayout.TICK_MS
+        }
+        return Run(buffer, out.map(::indexOf), depthAt, lossSamples)
+    }
+
+    private fun assertInOrder(played: List<Int>) {
+        played.zipWithNext().forEach { (a, b) -> assertTrue("played $b after $a", b >= a) }
+    }
+
+    // ========== Traces ==========
+
+    @Test
+    fun `clean link plays every frame at the minimum delay`() {
+        val run = simulate(trace(frames = 333, frameTimeMs = 60, seed = 1, jitterMs = 0), frameTimeMs = 60)
+
+        with(run.buffer) {
+            assertEquals(333L, framesPlayed)
+            assertEquals(0L, framesConcealed)
+            assertEquals(0L, framesDropped)
+            assertEquals(0L, rebuffers)
+            assertEquals(0f, lossPercent)
+            assertEquals(60, targetDelayMs)
+        }
+        assertEquals((0 until 333).toList(), run.played)
+    }
+
+    @Test
+    fun `jittery link raises the playout delay and keeps concealment rare`() {
+        for (seed in 1L..5L) {
+            val run = simulate(trace(frames = 333, frameTimeMs = 60, seed = seed, jitterMs = 300), frameTimeMs = 60)
+
+            with(run.buffer) {
+                println(
+                    "Jitter 0-300 ms, seed $seed: jitter ${"%.1f".format(jitterMs)} ms, target $targetDelayMs ms, " +
+                        "concealed $framesConcealed, rebuffers $rebuffers",
+                )
+                assertTrue("seed $seed: target $targetDelayMs", targetDelayMs >= 120)
+                assertTrue("seed $seed: concealed $framesConcealed", framesConcealed <= 333 / 50)
+                assertTrue("seed $seed: rebuffers $rebuffers", rebuffers <= 1)
+                assertEquals(0L, framesDropped)
+            }
+        }
+    }
+
+    @Test
+    fun `bundled ULBW packets are buffered whole`() {
+        for (seed in 1L..5L) {
+            val arrivals = trace(frames = 150, frameTimeMs = 400, seed = seed, jitterMs = 50, framesPerPacket = 3)
+            val run = simulate(arrivals, frameTimeMs = 400)
+
+            with(run.buffer) {
+                assertTrue("seed $seed: target $targetDelayMs", targetDelayMs >= 3 * 400)
+                assertTrue("seed $seed: concealed $framesConcealed", framesConcealed <= 1)
+                assertEquals(0L, framesDropped)
+                assertEquals(0L, rebuffers)
+            }
+            assertInOrder(run.played)
+        }
+    }
+
+    @Test
+    fun `window loss tracks injected packet loss`() {
+        for (seed in 1L..5L) {
+            val arrivals = trace(frames = 1_000, frameTimeMs = 60, seed = seed, jitterMs = 20, lossRate = 0.10)
+            val run = simulate(arrivals, frameTimeMs = 60)
+
+            val meanLoss = run.windowLossSamples.average()
+            assertTrue("seed $seed: mean window loss $meanLoss", meanLoss in 5.0..15.0)
+            assertTrue(run.buffer.framesConcealed > 0)
+        }
+    }
+
+    @Test
+    fun `outage longer than concealment rebuffers and resumes`() {
+        // Two seconds of frames lost mid-call on a clean link
+        val arrivals = (0 until 300).filterNot { it in 100 until 133 }.map { Arrival(it * 60L + 100, it) }
+
+        val run = simulate(arrivals, frameTimeMs = 60)
+
+        with(run.buffer) {
+            assertEquals(AdaptiveJitterBuffer.MAX_CONCEALED_FRAMES.toLong(), framesConcealed)
+            assertEquals(1L, rebuffers)
+        }
+        assertEquals(99, run.played[99])
+        assertEquals(listOf(99, 99), run.played.subList(100, 102))
+        assertTrue("playout resumed", run.played.last() > 250)
+        assertInOrder(run.played)
+    }
+
+    @Test
+    fun `slots due while rebuffering count as lost`() {
+        val arrivals = (0 until 300).filterNot { it in 100 until 133 }.map { Arrival(it * 60L + 100, it) }
+
+        // Up to the first frame after the outage: 33 of the last 100 slots had no audio
+        val run = simulate(arrivals, frameTimeMs = 60, untilMs = 133 * 60L + 100)
+
+        assertEquals(1L, run.buffer.rebuffers)
+        assertEquals(34f, run.buffer.lossPercent, 1f)
+    }
+
+    @Test
+    fun `sustained outage triggers a downgrade`() {
+        // Eight seconds without audio on an Opus call
+        val arrivals = (0 until 400).filterNot { it in 150 until 283 }.map { Arrival(it * 60L + 100, it) }
+        val buffer = AdaptiveJitterBuffer().apply { frameTimeMs = 60 }
+        val trigger = ProfileDowngradeTrigger()
+        val out = ArrayList<ByteArray>()
+        var next = 0
+        var downgradedAtMs = -1L
+
+        var now = 0L
+        while (now <= 283 * 60L + 100 && downgradedAtMs < 0) {
+            while (next < arrivals.size && arrivals[next].atMs <= now) buffer.push(frame(arrivals[next++].index), now)
+            buffer.poll(now, out)
+            if (now % 1_000 == 0L && trigger.evaluate(0x40, buffer.lossPercent, buffer.lossWindowFull, now) == 0x30) {
+                downgradedAtMs = now
+            }
+            now += CallPlayout.TICK_MS
+        }
+
+        assertTrue("no downgrade during the outage", downgradedAtMs > 150 * 60L)
+    }
+
+    @Test
+    fun `burst after a stall is drained back to the target`() {
+        // Frames 100..116 are held up and land together with frame 117
+        val releaseMs = 117 * 60L + 100
+        val arrivals = (0 until 300).map { Arrival(if (it in 100 until 117) releaseMs else it * 60L + 100, it) }
+
+        val run = simulate(arrivals, frameTimeMs = 60)
+
+        with(run.buffer) {
+            assertTrue("dropped $framesDropped", framesDropped > 0)
+            assertTrue("depth $depthMs, target $targetDelayMs", depthMs <= targetDelayMs + 2 * 60)
+        }
+        val twoSecondsLater = run.depthAt.getValue(releaseMs + 2_000)
+        assertTrue("depth 2 s after the burst: $twoSecondsLater", twoSecondsLater <= 5 * 60)
+        assertInOrder(run.played)
+    }
+
+    @Test
+    fun `same trace gives the same playout`() {
+        val arrivals = trace(frames = 500, frameTimeMs = 20, seed = 7, jitterMs = 120, lossRate = 0.05)
+
+        val first = simulate(arrivals, frameTimeMs = 20)
+        val second = simulate(arrivals, frameTimeMs = 20)
+
+        assertEquals(first.played, second.played)
+        assertEquals(first.buffer.targetDelayMs, second.buffer.targetDelayMs)
+    }
+
+    @Test
+    fun `reset forgets the call`() {
+        val buffer = AdaptiveJitterBuffer()
+        val out = ArrayList<ByteArray>()
+        trace(frames = 50, frameTimeMs = 60, seed = 3, jitterMs = 200).forEach { buffer.push(frame(it.index), it.atMs) }
+        buffer.poll(5_000, out)
+
+        buffer.reset()
+
+        with(buffer) {
+            assertEquals(0, depthMs)
+            assertEquals(0.0, jitterMs, 0.0)
+            assertEquals(60, targetDelayMs)
+            assertEquals(0f, lossPercent)
+            assertEquals(0L, framesReceived)
+        }
+    }
+
+    // ========== Profile Downgrade ==========
+
+    @Test
+    fun `downgrade needs a full window and sustained loss`() {
+        val trigger = ProfileDowngradeTrigger()
+
+        assertNull(trigger.evaluate(0x40, 30f, windowFull = false, nowMs = 0))
+        assertNull(trigger.evaluate(0x40, 30f, windowFull = true, nowMs = 1_000))
+        assertNull(trigger.evaluate(0x40, 30f, windowFull = true, nowMs = 5_999))
+        assertEquals(0x30, trigger.evaluate(0x40, 30f, windowFull = true, nowMs = 6_000))
+    }
+
+    @Test
+    fun `loss dipping below tolerance restarts the sustain period`() {
+        val trigger = ProfileDowngradeTrigger()
+
+        trigger.evaluate(0x50, 20f, windowFull = true, nowMs = 0)
+        trigger.evaluate(0x50, 20f, windowFull = true, nowMs = 4_000)
+        assertNull(trigger.evaluate(0x50, 2f, windowFull = true, nowMs = 4_500))
+        assertNull(trigger.evaluate(0x50, 20f, windowFull = true, nowMs = 5_000))
+        assertNull(trigger.evaluate(0x50, 20f, windowFull = true, nowMs = 9_999))
+        assertEquals(0x40, trigger.evaluate(0x50, 20f, windowFull = true, nowMs = 10_000))
+    }
+
+    @Test
+    fun `switches are spaced by the cooldown`() {
+        val trigger = ProfileDowngradeTrigger()
+        trigger.evaluate(0x40, 30f, windowFull = true, nowMs = 0)
+        assertEquals(0x30, trigger.evaluate(0x40, 30f, windowFull = true, nowMs = 5_000))
+
+        var now = 6_000L
+        while (now < 5_000 + ProfileDowngradeTrigger.COOLDOWN_MS) {
+            assertNull("at $now", trigger.evaluate(0x30, 30f, windowFull = true, nowMs = now))
+            now += 1_000
+        }
+        assertEquals(0x20, trigger.evaluate(0x30, 30f, windowFull = true, nowMs = now))
+    }
+
+    @Test
+    fun `Codec2 profiles tolerate less loss than Opus`() {
+        val codec2 = ProfileDowngradeTrigger()
+        val opus = ProfileDowngradeTrigger()
+
+        assertNull(codec2.evaluate(0x30, 7f, windowFull = true, nowMs = 0))
+        assertNull(opus.evaluate(0x40, 7f, windowFull = true, nowMs = 0))
+
+        val later = ProfileDowngradeTrigger.SUSTAIN_MS
+        assertEquals(0x20, codec2.evaluate(0x30, 7f, windowFull = true, nowMs = later))
+        assertNull(opus.evaluate(0x40, 7f, windowFull = true, nowMs = later))
+    }
+
+    @Test
+    fun `downgrade chain ends at ULBW`() {
+        assertEquals(0x40, ProfileDowngradeTrigger.downgradeFrom(0x70))
+        assertEquals(0x40, ProfileDowngradeTrigger.downgradeFrom(0x80))
+
+        val chain = generateSequence(0x60) { ProfileDowngradeTrigger.downgradeFrom(it) }.toList()
+        assertEquals(listOf(0x60, 0x50, 0x40, 0x30, 0x20, 0x10), chain)
+    }
+}
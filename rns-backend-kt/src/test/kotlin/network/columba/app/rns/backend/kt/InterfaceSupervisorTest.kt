@@ -0,0 +1,274 @@
+package network.columba.app.rns.backend.kt
+
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableSharedFlow
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import kotlin.random.Random
+
+/**
+ * Unit tests for InterfaceSupervisor.
+ *
+ * Interfaces are plain MutableStateFlows and recovery actions just record
+ * when they ran, so every timing below is virtual time.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class InterfaceSupervisorTest {
+    private val retrySignals = MutableSharedFlow<String>(extraBufferCapacity = 8)
+    private val recoveries = mutableListOf<Long>()
+
+    private fun TestScope.createSupervisor(backoff: RecoveryBackoff = RecoveryBackoff(jitter = 0.0)): InterfaceSupervisor =
+        InterfaceSupervisor(
+            scope = backgroundScope,
+            retrySignals = retrySignals,
+            backoff = backoff,
+            clock = { testScheduler.currentTime },
+            random = Random(42),
+        )
+
+    private fun TestScope.recordRecovery(): suspend () -> Unit = { recoveries.add(testScheduler.currentTime) }
+
+    // ========== Recovery Trigger Tests ==========
+
+    @Test
+    fun `offline edge starts recovery immediately`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val online = MutableStateFlow(true)
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", online)
+            runCurrent()
+            assertTrue(recoveries.isEmpty())
+
+            online.value = false
+            runCurrent()
+
+            assertEquals(listOf(0L), recoveries)
+        }
+
+    @Test
+    fun `nothing runs while interfaces stay online`() =
+        runTest {
+            val supervisor = createSupervisor()
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", MutableStateFlow(true))
+
+            advanceTimeBy(60 * 60_000L)
+            runCurrent()
+
+            assertTrue(recoveries.isEmpty())
+            assertNull(supervisor.stats("RNode")!!.nextRetryAtMs)
+        }
+
+    @Test
+    fun `interface that never came online is not recovered`() =
+        runTest {
+            val supervisor = createSupervisor()
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", MutableStateFlow(false))
+
+            advanceTimeBy(60_000L)
+            runCurrent()
+
+            assertTrue(recoveries.isEmpty())
+        }
+
+    @Test
+    fun `failed start schedules recovery`() =
+        runTest {
+            val supervisor = createSupervisor()
+            supervisor.supervise("RNode", recordRecovery())
+            runCurrent()
+
+            supervisor.reportStartFailed("RNode")
+            runCurrent()
+
+            assertEquals(listOf(0L), recoveries)
+        }
+
+    @Test
+    fun `observe-only interface is never recovered`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val online = MutableStateFlow(true)
+            supervisor.attach("TCP Client", online)
+            runCurrent()
+
+            online.value = false
+            supervisor.reportStartFailed("TCP Client")
+            advanceTimeBy(60_000L)
+            runCurrent()
+
+            assertTrue(recoveries.isEmpty())
+            assertEquals(false, supervisor.stats("TCP Client")!!.online)
+        }
+
+    // ========== Backoff Tests ==========
+
+    @Test
+    fun `failed attempts back off exponentially`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val online = MutableStateFlow(true)
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", online)
+            runCurrent()
+
+            online.value = false
+            advanceTimeBy(80_000L)
+            runCurrent()
+
+            // Attempt window is 12s, then 5s, 10s, 20s of backoff
+            assertEquals(listOf(0L, 17_000L, 39_000L, 71_000L), recoveries)
+        }
+
+    @Test
+    fun `retry signal cuts the backoff short`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val online = MutableStateFlow(true)
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", online)
+            runCurrent()
+
+            online.value = false
+            advanceTimeBy(30_000L)
+            runCurrent()
+            // Second attempt failed at 29s; third would wait until 39s
+            assertEquals(listOf(0L, 17_000L), recoveries)
+            assertEquals(39_000L, supervisor.stats("RNode")!!.nextRetryAtMs)
+
+            retrySignals.emit("network changed")
+            runCurrent()
+
+            assertEquals(listOf(0L, 17_000L, 30_000L), recoveries)
+        }
+
+    @Test
+    fun `retry signal with nothing waiting is ignored`() =
+        runTest {
+            val supervisor = createSupervisor()
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", MutableStateFlow(true))
+            runCurrent()
+
+            retrySignals.emit("network changed")
+            runCurrent()
+
+            assertTrue(recoveries.isEmpty())
+        }
+
+    @Test
+    fun `backoff caps at max delay and stays within jitter`() {
+        val exact = RecoveryBackoff(jitter = 0.0)
+        assertEquals(0L, exact.delayFor(0, Random(1)))
+        assertEquals(5_000L, exact.delayFor(1, Random(1)))
+        assertEquals(10_000L, exact.delayFor(2, Random(1)))
+        assertEquals(300_000L, exact.delayFor(8, Random(1)))
+        assertEquals(300_000L, exact.delayFor(1_000, Random(1)))
+
+        val jittered = RecoveryBackoff(jitter = 0.2)
+        val random = Random(7)
+        repeat(1_000) { i ->
+            val attempt = i % 10 + 1
+            val base = exact.delayFor(attempt, random)
+            val delay = jittered.delayFor(attempt, random)
+            assertTrue("attempt $attempt: $delay", delay in (base * 0.8).toLong()..(base * 1.2).toLong())
+        }
+    }
+
+    // ========== Lifecycle & Stats Tests ==========
+
+    @Test
+    fun `recovery onto a new instance ends the loop and counts a reconnect`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val original = MutableStateFlow(true)
+            supervisor.supervise("RNode") {
+                recoveries.add(testScheduler.currentTime)
+                supervisor.attach("RNode", MutableStateFlow(true))
+            }
+            supervisor.attach("RNode", original)
+            runCurrent()
+
+            original.value = false
+            advanceTimeBy(60 * 60_000L)
+            runCurrent()
+
+            assertEquals(listOf(0L), recoveries)
+            val stats = supervisor.stats("RNode")!!
+            assertTrue(stats.online)
+            assertEquals(1, stats.reconnectAttempts)
+            assertEquals(1, stats.reconnects)
+            assertNull(stats.nextRetryAtMs)
+        }
+
+    @Test
+    fun `stats track session and total uptime`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val online = MutableStateFlow(true)
+            supervisor.attach("TCP Client", online)
+            runCurrent()
+
+            advanceTimeBy(60_000L)
+            runCurrent()
+            assertEquals(60_000L, supervisor.stats("TCP Client")!!.uptimeMs)
+
+            online.value = false
+            runCurrent()
+            advanceTimeBy(30_000L)
+            online.value = true
+            runCurrent()
+            advanceTimeBy(10_000L)
+            runCurrent()
+
+            val stats = supervisor.stats("TCP Client")!!
+            assertEquals(10_000L, stats.uptimeMs)
+            assertEquals(70_000L, stats.totalUptimeMs)
+            assertEquals(0, stats.reconnects)
+        }
+
+    @Test
+    fun `remove cancels pending recovery`() =
+        runTest {
+            val supervisor = createSupervisor()
+            val online = MutableStateFlow(true)
+            supervisor.supervise("RNode", recordRecovery())
+            supervisor.attach("RNode", online)
+            runCurrent()
+
+            online.value = false
+            runCurrent()
+            assertEquals(1, recoveries.size)
+
+            supervisor.remove("RNode")
+            advanceTimeBy(60 * 60_000L)
+            runCurrent()
+
+            assertEquals(1, recoveries.size)
+            assertNull(supervisor.stats("RNode"))
+            assertTrue(supervisor.supervisedNames().isEmpty())
+        }
+
+    @Test
+    fun `attach after teardown does not resurrect supervision`() =
+        runTest {
+            val supervisor = createSupervisor()
+
+            supervisor.attach("RNode", MutableStateFlow(true)) { false }
+            runCurrent()
+
+            assertNull(supervisor.stats("RNode"))
+            supervisor.attach("RNode", MutableStateFlow(true))
+            assertNotNull(supervisor.stats("RNode"))
+        }
+}
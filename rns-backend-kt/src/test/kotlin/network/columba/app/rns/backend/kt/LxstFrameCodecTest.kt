@@ -0,0 +1,303 @@
+package network.columba.app.rns.backend.kt
+
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.msgpack.core.MessagePack
+import java.util.concurrent.Executors
+import java.util.concurrent.TimeUnit
+
+/**
+ * Unit tests for the LXST voice frame path: hand-rolled framing, the
+ * allocation-light decoder, frame bundling and the bundling policy.
+ *
+ * Wire compatibility is checked against msgpack-core, which is what the
+ * transport used before and what Python LXST's msgpack produces.
+ */
+class LxstFrameCodecTest {
+    private fun frame(
+        size: Int,
+        seed: Int = 0,
+    ) = ByteArray(size) { (it + seed).toByte() }
+
+    /** Records what the decoder dispatches. */
+    private class RecordingSink : LxstPacketDecoder.Sink {
+        val signals = mutableListOf<Int>()
+        val frames = mutableListOf<ByteArray>()
+
+        override fun onSignal(signal: Int) {
+            signals.add(signal)
+        }
+
+        override fun onFrame(frame: ByteArray) {
+            frames.add(frame)
+        }
+    }
+
+    private fun msgpackFrame(frame: ByteArray): ByteArray =
+        MessagePack.newDefaultBufferPacker().run {
+            packMapHeader(1)
+            packInt(0x01)
+            packBinaryHeader(frame.size)
+            writePayload(frame)
+            toByteArray()
+        }
+
+    private fun msgpackSignal(signal: Int): ByteArray =
+        MessagePack.newDefaultBufferPacker().run {
+            packMapHeader(1)
+            packInt(0x00)
+            packArrayHeader(1)
+            packInt(signal)
+            toByteArray()
+        }
+
+    // ========== Wire Format ==========
+
+    @Test
+    fun `encodeFrame matches msgpack-core output`() {
+        for (size in listOf(1, 35, 255, 256, 1200)) {
+            val frame = frame(size)
+            assertArrayEquals("size $size", msgpackFrame(frame), LxstWireCodec.encodeFrame(frame))
+        }
+    }
+
+    @Test
+    fun `encodeSignal matches msgpack-core output`() {
+        for (signal in listOf(0x00, 0x02, 0x06, 0x7F, 0xFF, 0x1FF, 0x10000)) {
+            assertArrayEquals("signal $signal", msgpackSignal(signal), LxstWireCodec.encodeSignal(signal))
+        }
+    }
+
+    @Test
+    fun `bundle unpacks with msgpack-core as a list of binaries`() {
+        val packets = mutableListOf<ByteArray>()
+        val bundler = LxstFrameBundler { packets.add(it) }
+        bundler.framesPerPacket = 3
+        val frames = listOf(frame(35, 1), frame(35, 2), frame(35, 3))
+
+        frames.forEach(bundler::offer)
+
+        assertEquals(1, packets.size)
+        val unpacker = MessagePack.newDefaultUnpacker(packets[0])
+        assertEquals(1, unpacker.unpackMapHeader())
+        assertEquals(0x01, unpacker.unpackInt())
+        assertEquals(3, unpacker.unpackArrayHeader())
+        frames.forEach { expected ->
+            assertArrayEquals(expected, unpacker.readPayload(unpacker.unpackBinaryHeader()))
+        }
+        assertFalse(unpacker.hasNext())
+    }
+
+    // ========== Decoder ==========
+
+    @Test
+    fun `decoder reads single frames and signals`() {
+        val sink = RecordingSink()
+        val decoder = LxstPacketDecoder()
+        val frame = frame(40)
+
+        assertTrue(decoder.decode(msgpackFrame(frame), sink))
+        assertTrue(decoder.decode(msgpackSignal(0x06), sink))
+        assertTrue(decoder.decode(msgpackSignal(0x1FF), sink))
+
+        assertEquals(1, sink.frames.size)
+        assertArrayEquals(frame, sink.frames[0])
+        assertEquals(listOf(0x06, 0x1FF), sink.signals)
+    }
+
+    @Test
+    fun `decoder reads bundles in order`() {
+        val packet =
+            MessagePack.newDefaultBufferPacker().run {
+                packMapHeader(1)
+                packInt(0x01)
+                packArrayHeader(2)
+                packBinaryHeader(3)
+                writePayload(byteArrayOf(1, 2, 3))
+                packBinaryHeader(2)
+                writePayload(byteArrayOf(4, 5))
+                toByteArray()
+            }
+        val sink = RecordingSink()
+
+        assertTrue(LxstPacketDecoder().decode(packet, sink))
+
+        assertEquals(2, sink.frames.size)
+        assertArrayEquals(byteArrayOf(1, 2, 3), sink.frames[0])
+        assertArrayEquals(byteArrayOf(4, 5), sink.frames[1])
+    }
+
+    @Test
+    fun `decoder dispatches signals before frames in a combined packet`() {
+        val packet =
+            MessagePack.newDefaultBufferPacker().run {
+                packMapHeader(2)
+                packInt(0x01)
+                packBinaryHeader(2)
+                writePayload(byteArrayOf(9, 9))
+                packInt(0x00)
+                packArrayHeader(1)
+                packInt(0x04)
+                toByteArray()
+            }
+        val order = mutableListOf<String>()
+        val sink =
+            object : LxstPacketDecoder.Sink {
+                override fun onSignal(signal: Int) {
+                    order.add("signal")
+                }
+
+                override fun onFrame(frame: ByteArray) {
+                    order.add("frame")
+                }
+            }
+
+        assertTrue(LxstPacketDecoder().decode(packet, sink))
+
+        assertEquals(listOf("signal", "frame"), order)
+    }
+
+    @Test
+    fun `decoder rejects other shapes without dispatching`() {
+        val decoder = LxstPacketDecoder()
+        val sink = RecordingSink()
+        val truncated = LxstWireCodec.encodeFrame(frame(40)).copyOf(20)
+        val rawAudio = byteArrayOf(0x01, 0x02, 0x03, 0x04)
+        val stringKey =
+            MessagePack.newDefaultBufferPacker().run {
+                packMapHeader(1)
+                packString("x")
+                packInt(1)
+                toByteArray()
+            }
+        val trailing = LxstWireCodec.encodeSignal(0x02) + byteArrayOf(0)
+
+        for (packet in listOf(truncated, rawAudio, stringKey, trailing, ByteArray(0))) {
+            assertFalse(decoder.decode(packet, sink))
+        }
+        assertTrue(sink.frames.isEmpty())
+        assertTrue(sink.signals.isEmpty())
+    }
+
+    // ========== Bundler ==========
+
+    @Test
+    fun `one frame per packet is the pre-bundling wire format`() {
+        val packets = mutableListOf<ByteArray>()
+        val bundler = LxstFrameBundler { packets.add(it) }
+        val frame = frame(60)
+
+        bundler.offer(frame)
+
+        assertEquals(1, packets.size)
+        assertArrayEquals(msgpackFrame(frame), packets[0])
+    }
+
+    @Test
+    fun `bundler flushes early rather than exceed the MDU`() {
+        val packets = mutableListOf<ByteArray>()
+        val bundler = LxstFrameBundler(mdu = 100) { packets.add(it) }
+        bundler.framesPerPacket = 8
+
+        repeat(5) { bundler.offer(frame(40, it)) }
+        bundler.flush()
+
+        assertTrue(packets.all { it.size <= 100 })
+        val sink = RecordingSink()
+        val decoder = LxstPacketDecoder()
+        packets.forEach { assertTrue(decoder.decode(it, sink)) }
+        assertEquals(5, sink.frames.size)
+        sink.frames.forEachIndexed { i, f -> assertArrayEquals(frame(40, i), f) }
+        assertEquals(5L, bundler.framesSent)
+    }
+
+    @Test
+    fun `oversized frame is sent alone after staged frames`() {
+        val packets = mutableListOf<ByteArray>()
+        val bundler = LxstFrameBundler(mdu = 100) { packets.add(it) }
+        bundler.framesPerPacket = 4
+
+        bundler.offer(frame(10, 1))
+        bundler.offer(frame(200, 2))
+
+        assertEquals(2, packets.size)
+        assertArrayEquals(msgpackFrame(frame(10, 1)), packets[0])
+        assertArrayEquals(msgpackFrame(frame(200, 2)), packets[1])
+    }
+
+    @Test
+    fun `partial bundle is flushed by the scheduler`() {
+        val scheduler = Executors.newSingleThreadScheduledExecutor()
+        try {
+            val packets = java.util.concurrent.LinkedBlockingQueue<ByteArray>()
+            val bundler = LxstFrameBundler(scheduler = scheduler) { packets.add(it) }
+            bundler.framesPerPacket = 4
+            bundler.frameTimeMs = 10
+
+            bundler.offer(frame(35))
+
+            val packet = packets.poll(2, TimeUnit.SECONDS)
+            assertArrayEquals(msgpackFrame(frame(35)), packet)
+        } finally {
+            scheduler.shutdownNow()
+        }
+    }
+
+    @Test
+    fun `clear drops staged frames`() {
+        val packets = mutableListOf<ByteArray>()
+        val bundler = LxstFrameBundler { packets.add(it) }
+        bundler.framesPerPacket = 4
+
+        bundler.offer(frame(35))
+        bundler.clear()
+        bundler.flush()
+
+        assertTrue(packets.isEmpty())
+    }
+
+    // ========== Policy ==========
+
+    @Test
+    fun `fast links and low-latency profiles send one frame per packet`() {
+        assertEquals(1, LxstBundlePolicy.framesPerPacket(60, 80, peerAcceptsBundles = true))
+        assertEquals(1, LxstBundlePolicy.framesPerPacket(400, null, peerAcceptsBundles = true))
+        assertEquals(1, LxstBundlePolicy.framesPerPacket(20, 5_000, peerAcceptsBundles = true))
+        assertEquals(1, LxstBundlePolicy.framesPerPacket(10, 5_000, peerAcceptsBundles = true))
+    }
+
+    @Test
+    fun `slow links bundle within the latency budget`() {
+        // LoRa-class RTT with Codec2 700C: 1 s budget / 400 ms frames
+        assertEquals(3, LxstBundlePolicy.framesPerPacket(400, 3_000, peerAcceptsBundles = true))
+        // Half a second of RTT with Opus frames: 250 ms / 60 ms
+        assertEquals(5, LxstBundlePolicy.framesPerPacket(60, 500, peerAcceptsBundles = true))
+        // Capped
+        assertEquals(
+            LxstBundlePolicy.MAX_FRAMES_PER_PACKET,
+            LxstBundlePolicy.framesPerPacket(60, 60_000, peerAcceptsBundles = true),
+        )
+    }
+
+    @Test
+    fun `peers that have not signalled bundle support get one frame per packet`() {
+        assertEquals(1, LxstBundlePolicy.framesPerPacket(400, 3_000, peerAcceptsBundles = false))
+        assertEquals(1, LxstBundlePolicy.framesPerPacket(60, 60_000, peerAcceptsBundles = false))
+    }
+
+    @Test
+    fun `bundle support signal is one LXST ignores`() {
+        // Not a call status (0x00..0x06) and below PREFERRED_PROFILE, which switches profiles
+        assertTrue(LxstBundlePolicy.FRAME_BUNDLES_SIGNAL in 0x07 until 0xFF)
+    }
+
+    @Test
+    fun `frame time comes from the profile id`() {
+        assertEquals(400, LxstBundlePolicy.frameTimeMs(0x10))
+        assertEquals(60, LxstBundlePolicy.frameTimeMs(0x40))
+        assertEquals(null, LxstBundlePolicy.frameTimeMs(0x99))
+    }
+}
@@ -0,0 +1,150 @@
+package network.columba.app.rns.backend.kt
+
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Test
+import org.msgpack.core.MessagePack
+import java.lang.management.ManagementFactory
+
+/**
+ * Benchmark: the LXST voice frame path before and after pooled framing and
+ * bundling, per second of audio.
+ *
+ * - Allocations: bytes allocated on the test thread (HotSpot ThreadMXBean;
+ *   skipped on JVMs without allocation accounting) to frame audio for
+ *   sending and to decode it on receipt.
+ * - Bytes on air: packet payloads plus Reticulum link overhead per packet
+ *   (19-byte header, 16-byte IV, 32-byte HMAC, PKCS7 padding to 16 bytes).
+ */
+class LxstFramePathAllocationTest {
+    private val threadBean =
+        ManagementFactory.getThreadMXBean() as? com.sun.management.ThreadMXBean
+
+    /** A call profile: frame time and encoded frame size (codec byte included). */
+    private class Scenario(
+        val name: String,
+        val frameTimeMs: Int,
+        val frameBytes: Int,
+        val rttMs: Long,
+    ) {
+        val framesPerWindow get() = WINDOW_SECONDS * 1000 / frameTimeMs
+    }
+
+    companion object {
+        /** Audio simulated per run; results are reported per second. */
+        private const val WINDOW_SECONDS = 10
+    }
+
+    private val scenarios =
+        listOf(
+            // Codec2 700C over LoRa
+            Scenario("ULBW over LoRa", frameTimeMs = 400, frameBytes = 36, rttMs = 3_000),
+            // Codec2 3200 over a slow multi-hop path
+            Scenario("LBW over slow path", frameTimeMs = 200, frameBytes = 81, rttMs = 1_500),
+            // Opus over TCP/WiFi: bundling stays off
+            Scenario("MQ over TCP", frameTimeMs = 60, frameBytes = 120, rttMs = 60),
+        )
+
+    private fun onAirBytes(payload: Int): Int = 19 + 16 + 32 + (payload / 16 + 1) * 16
+
+    private fun allocatedBytes(
+        repetitions: Int = 500,
+        block: () -> Unit,
+    ): Long {
+        val bean = threadBean!!
+        val threadId = Thread.currentThread().id
+        repeat(100) { block() }
+        val before = bean.getThreadAllocatedBytes(threadId)
+        repeat(repetitions) { block() }
+        val after = bean.getThreadAllocatedBytes(threadId)
+        return (after - before) / repetitions
+    }
+
+    /** The pre-bundling send path: a msgpack buffer packer per frame. */
+    private fun legacyPack(frame: ByteArray): ByteArray {
+        val packer = MessagePack.newDefaultBufferPacker()
+        packer.packMapHeader(1)
+        packer.packInt(0x01)
+        packer.packBinaryHeader(frame.size)
+        packer.writePayload(frame)
+        return packer.toByteArray()
+    }
+
+    /** The pre-bundling receive path: a generic msgpack unpacker per packet. */
+    private fun legacyDecode(
+        packet: ByteArray,
+        onFrame: (ByteArray) -> Unit,
+    ) {
+        val value = MessagePack.newDefaultUnpacker(packet).unpackValue()
+        val frames = value.asMapValue().map()[org.msgpack.value.ValueFactory.newInteger(0x01)]
+        if (frames != null && frames.isBinaryValue) onFrame(frames.asBinaryValue().asByteArray())
+    }
+
+    // ========== Benchmarks ==========
+
+    @Test
+    fun `bundled framing cuts allocations and bytes on air per second of audio`() {
+        assumeTrue("ThreadMXBean allocation accounting unavailable", threadBean?.isThreadAllocatedMemorySupported == true)
+        threadBean!!.isThreadAllocatedMemoryEnabled = true
+
+        for (scenario in scenarios) {
+            val frames = List(scenario.framesPerWindow) { i -> ByteArray(scenario.frameBytes) { (it + i).toByte() } }
+            val framesPerPacket = LxstBundlePolicy.framesPerPacket(scenario.frameTimeMs, scenario.rttMs, peerAcceptsBundles = true)
+
+            // Send side
+            var legacyAir = 0
+            var legacySink = 0
+            val legacySendBytes =
+                allocatedBytes {
+                    legacyAir = 0
+                    frames.forEach { legacyAir += onAirBytes(legacyPack(it).size).also { n -> legacySink += n } }
+                }
+            var newAir = 0
+            val packets = ArrayList<ByteArray>()
+            val bundler =
+                LxstFrameBundler { packet ->
+                    newAir += onAirBytes(packet.size)
+                    packets.add(packet)
+                }
+            bundler.framesPerPacket = framesPerPacket
+            val newSendBytes =
+                allocatedBytes {
+                    newAir = 0
+                    packets.clear()
+                    frames.forEach(bundler::offer)
+                    bundler.flush()
+                }
+
+            // Receive side, the same audio
+            val legacyPackets = frames.map(::legacyPack)
+            var received = 0
+            val legacyReceiveBytes =
+                allocatedBytes { legacyPackets.forEach { legacyDecode(it) { received++ } } }
+            val decoder = LxstPacketDecoder()
+            val sink =
+                object : LxstPacketDecoder.Sink {
+                    override fun onSignal(signal: Int) = Unit
+
+                    override fun onFrame(frame: ByteArray) {
+                        received++
+                    }
+                }
+            val newPackets = packets.toList()
+            val newReceiveBytes = allocatedBytes { newPackets.forEach { decoder.decode(it, sink) } }
+            check(received > 0 && legacySink > 0)
+
+            println(
+                "${scenario.name} ($framesPerPacket frames/packet): " +
+                    "send ${legacySendBytes / WINDOW_SECONDS} -> ${newSendBytes / WINDOW_SECONDS} B/s allocated, " +
+                    "receive ${legacyReceiveBytes / WINDOW_SECONDS} -> ${newReceiveBytes / WINDOW_SECONDS} B/s allocated, " +
+                    "on air ${legacyAir / WINDOW_SECONDS} -> ${newAir / WINDOW_SECONDS} B/s",
+            )
+            assertTrue("${scenario.name}: send allocations", newSendBytes < legacySendBytes)
+            assertTrue("${scenario.name}: receive allocations", newReceiveBytes < legacyReceiveBytes)
+            assertTrue("${scenario.name}: bytes on air", newAir <= legacyAir)
+            if (framesPerPacket > 1) {
+                assertTrue("${scenario.name}: bundling should save airtime", newAir < legacyAir)
+            }
+        }
+    }
+}
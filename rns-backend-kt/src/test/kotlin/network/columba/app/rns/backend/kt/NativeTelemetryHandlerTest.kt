@@ -8,15 +8,18 @@ import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.first
 import kotlinx.coroutines.runBlocking
 import kotlinx.coroutines.withTimeoutOrNull
+import org.msgpack.core.MessagePack
 import network.columba.app.rns.api.model.LocationTelemetry
+import network.columba.app.rns.api.model.DeliveryMethod
 import network.columba.app.rns.api.util.LxmfFields
+import network.columba.app.rns.api.util.toHex
 import network.reticulum.lxmf.LXMessage
 import org.junit.Assert.assertEquals
 import org.junit.Assert.assertNotNull
 import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Test
-import java.util.concurrent.ConcurrentHashMap
 
 /**
  * Verifies NativeTelemetryHandler.handleIncomingTelemetry correctly
@@ -42,7 +45,7 @@ class NativeTelemetryHandlerTest {
                 locationTelemetryFlow = locationFlow,
                 deliveryIdentityProvider = { null },
                 sendMessageFn = { _, _, _, _ -> },
-                storedTelemetry = ConcurrentHashMap(),
+                telemetryStore = TelemetryCollectorStore(),
                 telemetryCollectorEnabledProvider = { false },
                 telemetryAllowedRequestersProvider = { emptySet() },
             )
@@ -119,4 +122,106 @@ class NativeTelemetryHandlerTest {
             pollFlowNonBlocking(timeoutMillis = 150),
         )
     }
+
+    // ========== Collector Response Tests ==========
+
+    private class SentResponse(
+        val destination: ByteArray,
+        val method: DeliveryMethod,
+        val rows: List<List<*>>,
+    )
+
+    private fun collectorHandler(
+        store: TelemetryCollectorStore,
+        requester: ByteArray,
+        sent: MutableList<SentResponse>,
+    ) = NativeTelemetryHandler(
+        scopeProvider = { CoroutineScope(Dispatchers.Unconfined) },
+        locationTelemetryFlow = locationFlow,
+        deliveryIdentityProvider = { mockk<NativeIdentity>(relaxed = true) },
+        sendMessageFn = { dest, _, method, fields ->
+            @Suppress("UNCHECKED_CAST")
+            sent.add(SentResponse(dest, method, fields!![LxmfFields.FIELD_TELEMETRY_STREAM] as List<List<*>>))
+        },
+        telemetryStore = store,
+        telemetryCollectorEnabledProvider = { true },
+        telemetryAllowedRequestersProvider = { setOf(requester.toHex()) },
+    )
+
+    private fun telemetryRequest(
+        requester: ByteArray,
+        timebase: Long?,
+    ): LXMessage {
+        val command = if (timebase == null) mapOf(0x01 to emptyList<Any>()) else mapOf(0x01 to listOf(timebase))
+        val message = mockk<LXMessage>()
+        every { message.fields } returns mutableMapOf(LxmfFields.FIELD_COMMANDS to listOf(command))
+        every { message.sourceHash } returns requester
+        return message
+    }
+
+    private fun storeSenders(
+        store: TelemetryCollectorStore,
+        count: Int,
+    ) {
+        repeat(count) { i ->
+            store.store(
+                sourceHashHex = "%032x".format(i),
+                timestampSeconds = 1_700_000_000L + i,
+                packedTelemetry = ByteArray(48) { (i + it).toByte() },
+                appearanceField = listOf("account", byteArrayOf(0x11, 0x22, 0x33), byteArrayOf(0x44, 0x55, 0x66)),
+            )
+        }
+    }
+
+    private fun packedSize(value: Any): Int {
+        val packer = MessagePack.newDefaultBufferPacker()
+        MsgpackHelper.packValue(packer, value)
+        return packer.toByteArray().size
+    }
+
+    @Test
+    fun `500 sender response is split into size-bounded stream messages`() {
+        val requester = ByteArray(16) { 0x7F }
+        val store = TelemetryCollectorStore()
+        storeSenders(store, 500)
+        val sent = mutableListOf<SentResponse>()
+
+        collectorHandler(store, requester, sent).handleTelemetryCommands(telemetryRequest(requester, timebase = null))
+
+        assertTrue("expected several messages, got ${sent.size}", sent.size > 1)
+        assertEquals(500, sent.sumOf { it.rows.size })
+        sent.forEach { response ->
+            assertTrue(response.destination.contentEquals(requester))
+            assertEquals(DeliveryMethod.DIRECT, response.method)
+            assertTrue(packedSize(response.rows) <= NativeTelemetryHandler.TELEMETRY_STREAM_MAX_BYTES)
+        }
+        val senders = sent.flatMap { it.rows }.map { (it[0] as ByteArray).toHex() }
+        assertEquals(500, senders.toSet().size)
+        println("500 senders → ${sent.size} stream messages, largest ${sent.maxOf { packedSize(it.rows) }} bytes")
+    }
+
+    @Test
+    fun `timebase in seconds returns only entries received since`() {
+        val requester = ByteArray(16) { 0x7F }
+        val store = TelemetryCollectorStore()
+        storeSenders(store, 5)
+        val sent = mutableListOf<SentResponse>()
+        val future = System.currentTimeMillis() / 1000L + 3600
+
+        collectorHandler(store, requester, sent).handleTelemetryCommands(telemetryRequest(requester, timebase = future))
+
+        assertEquals(1, sent.size)
+        assertTrue(sent.single().rows.isEmpty())
+    }
+
+    @Test
+    fun `oversized single row is sent on its own`() {
+        val small = listOf<Any>(ByteArray(16), 1L, ByteArray(10))
+        val huge = listOf<Any>(ByteArray(16), 2L, ByteArray(4096))
+
+        val chunks = NativeTelemetryHandler.chunkTelemetryStream(listOf(small, huge, small), maxBytes = 1024)
+
+        assertEquals(listOf(1, 1, 1), chunks.map { it.size })
+        assertTrue(chunks[1].single() === huge)
+    }
 }
@@ -0,0 +1,153 @@
+package network.columba.app.rns.backend.kt
+
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.async
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import network.columba.app.rns.api.util.toHex
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Unit tests for PathWaiter.
+ *
+ * The identity store is a plain map and "announces" are direct
+ * onIdentityKnown calls, so completion times are exact virtual times.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class PathWaiterTest {
+    private val store = mutableMapOf<String, String>()
+    private val pathRequests = mutableListOf<String>()
+    private val peer = ByteArray(16) { 0x42 }
+    private val otherPeer = ByteArray(16) { 0x17 }
+
+    private val waiter =
+        PathWaiter(
+            recall = { hash -> store[hash.toHex()] },
+            requestPath = { hash -> pathRequests.add(hash.toHex()) },
+        )
+
+    /** What the transport does on an announce: store the identity, then notify. */
+    private fun announce(
+        hash: ByteArray,
+        identity: String,
+    ) {
+        store[hash.toHex()] = identity
+        waiter.onIdentityKnown(hash, identity)
+    }
+
+    // ========== Latency Tests ==========
+
+    @Test
+    fun `known identity returns without a path request`() =
+        runTest {
+            store[peer.toHex()] = "identity"
+
+            assertEquals("identity", waiter.await(peer, 10_000L))
+            assertTrue(pathRequests.isEmpty())
+        }
+
+    @Test
+    fun `send completes at the moment the announce arrives`() =
+        runTest {
+            listOf(1L, 37L, 251L, 1_337L, 9_999L).forEach { arrivalMs ->
+                store.clear()
+                val start = testScheduler.currentTime
+                val result = async { waiter.await(peer, 10_000L) to testScheduler.currentTime }
+                runCurrent()
+
+                advanceTimeBy(arrivalMs)
+                announce(peer, "identity")
+                runCurrent()
+
+                val (identity, completedAt) = result.await()
+                assertEquals("identity", identity)
+                // No polling interval: latency is exactly the announce delay
+                assertEquals(arrivalMs, completedAt - start)
+            }
+        }
+
+    @Test
+    fun `times out with null when no announce arrives`() =
+        runTest {
+            val result = async { waiter.await(peer, 5_000L) to testScheduler.currentTime }
+
+            val (identity, completedAt) = result.await()
+            assertNull(identity)
+            assertEquals(5_000L, completedAt)
+            assertEquals(0, waiter.pendingCount())
+        }
+
+    @Test
+    fun `identity stored without an announce is picked up at the deadline`() =
+        runTest {
+            val result = async { waiter.await(peer, 5_000L) }
+            runCurrent()
+
+            store[peer.toHex()] = "identity"
+
+            assertEquals("identity", result.await())
+        }
+
+    // ========== Sharing Tests ==========
+
+    @Test
+    fun `concurrent waiters share a single path request`() =
+        runTest {
+            val results = (1..5).map { async { waiter.await(peer, 10_000L) } }
+            runCurrent()
+
+            assertEquals(listOf(peer.toHex()), pathRequests)
+            assertEquals(1, waiter.pendingCount())
+
+            announce(peer, "identity")
+            results.forEach { assertEquals("identity", it.await()) }
+            assertEquals(0, waiter.pendingCount())
+        }
+
+    @Test
+    fun `announce for another destination does not wake the waiter`() =
+        runTest {
+            val result = async { waiter.await(peer, 10_000L) }
+            runCurrent()
+
+            announce(otherPeer, "other")
+            runCurrent()
+            assertFalse(result.isCompleted)
+
+            announce(peer, "identity")
+            assertEquals("identity", result.await())
+        }
+
+    @Test
+    fun `waiters with different timeouts expire independently`() =
+        runTest {
+            val short = async { waiter.await(peer, 2_000L) }
+            val long = async { waiter.await(peer, 10_000L) }
+            runCurrent()
+
+            advanceTimeBy(2_001L)
+            runCurrent()
+            assertTrue(short.isCompleted)
+            assertNull(short.await())
+            assertFalse(long.isCompleted)
+            assertEquals(1, waiter.pendingCount())
+
+            announce(peer, "identity")
+            assertEquals("identity", long.await())
+            assertEquals(1, pathRequests.size)
+        }
+
+    @Test
+    fun `a new wait after a timeout issues a fresh path request`() =
+        runTest {
+            assertNull(waiter.await(peer, 1_000L))
+            assertNull(waiter.await(peer, 1_000L))
+
+            assertEquals(2, pathRequests.size)
+        }
+}
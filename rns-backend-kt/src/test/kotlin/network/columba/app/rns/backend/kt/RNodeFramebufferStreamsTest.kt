@@ -0,0 +1,251 @@
+package network.columba.app.rns.backend.kt
+
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.io.ByteArrayInputStream
+import java.io.ByteArrayOutputStream
+import java.io.OutputStream
+
+/**
+ * Unit tests for the RNode framebuffer stream wrappers.
+ *
+ * A fake serial stream records every write(), standing in for the link; each
+ * write is one BLE write callback. The upload is driven the way
+ * RNodeInterface does it: one frame per line, each followed by flush(), then
+ * the enable command.
+ */
+class RNodeFramebufferStreamsTest {
+    private class FakeSerialStream : OutputStream() {
+        val writes = mutableListOf<ByteArray>()
+        var flushes = 0
+        var failing = false
+
+        override fun write(b: Int) {
+            write(byteArrayOf(b.toByte()), 0, 1)
+        }
+
+        override fun write(
+            b: ByteArray,
+            off: Int,
+            len: Int,
+        ) {
+            if (failing) throw java.io.IOException("link lost")
+            writes.add(b.copyOfRange(off, off + len))
+        }
+
+        override fun flush() {
+            flushes++
+        }
+
+        fun bytes(): ByteArray {
+            val all = ByteArrayOutputStream()
+            writes.forEach { all.write(it) }
+            return all.toByteArray()
+        }
+    }
+
+    private val deviceKey = "RNode A"
+
+    private fun testImage(seed: Int): ByteArray = ByteArray(512) { ((it * 37) + seed).toByte() }
+
+    private fun escape(data: ByteArray): ByteArray {
+        val out = ByteArrayOutputStream()
+        data.forEach { byte ->
+            when (byte) {
+                0xC0.toByte() -> out.write(byteArrayOf(0xDB.toByte(), 0xDC.toByte()))
+                0xDB.toByte() -> out.write(byteArrayOf(0xDB.toByte(), 0xDD.toByte()))
+                else -> out.write(byte.toInt())
+            }
+        }
+        return out.toByteArray()
+    }
+
+    private fun lineFrame(
+        line: Int,
+        image: ByteArray,
+    ): ByteArray {
+        val payload = byteArrayOf(line.toByte()) + image.copyOfRange(line * 8, line * 8 + 8)
+        return byteArrayOf(0xC0.toByte(), 0x43) + escape(payload) + byteArrayOf(0xC0.toByte())
+    }
+
+    private val enableFrame = byteArrayOf(0xC0.toByte(), 0x41, 0x01, 0xC0.toByte())
+
+    /** What RNodeInterface does with displayImageData and zero delays. */
+    private fun upload(
+        stream: OutputStream,
+        image: ByteArray,
+    ) {
+        repeat(64) { line ->
+            stream.write(lineFrame(line, image))
+            stream.flush()
+        }
+        stream.write(enableFrame)
+        stream.flush()
+    }
+
+    /** Line numbers of the CMD_FB_WRITE frames in [bytes]. */
+    private fun writtenLines(bytes: ByteArray): List<Int> {
+        val lines = mutableListOf<Int>()
+        var i = 0
+        while (i < bytes.size - 2) {
+            if (bytes[i] == 0xC0.toByte() && bytes[i + 1] == 0x43.toByte()) {
+                lines.add(bytes[i + 2].toInt() and 0xFF)
+                i = bytes.indexOf(0xC0.toByte(), i + 2) + 1
+            } else {
+                i++
+            }
+        }
+        return lines
+    }
+
+    private fun ByteArray.indexOf(
+        value: Byte,
+        from: Int,
+    ): Int = (from until size).first { this[it] == value }
+
+    // ========== Batching Tests ==========
+
+    @Test
+    fun `first upload coalesces 64 line frames into MTU-sized writes`() {
+        val serial = FakeSerialStream()
+        val stream = RNodeFramebufferOutputStream(serial, deviceKey, RNodeFramebufferCache(), maxWriteBytes = 512)
+        val image = testImage(seed = 1)
+
+        upload(stream, image)
+
+        val expected = ByteArrayOutputStream()
+        repeat(64) { expected.write(lineFrame(it, image)) }
+        expected.write(enableFrame)
+        assertArrayEquals(expected.toByteArray(), serial.bytes())
+
+        // Two line batches plus the enable frame, not 65 paced writes
+        assertEquals(3, serial.writes.size)
+        serial.writes.forEach { bytes ->
+            assertTrue(bytes.size <= 512)
+            assertEquals(0xC0.toByte(), bytes.first())
+            assertEquals(0xC0.toByte(), bytes.last())
+        }
+        // Enable goes out after every line, in its own write right behind them
+        assertArrayEquals(enableFrame, serial.writes.last())
+    }
+
+    @Test
+    fun `repeat upload on the same connection sends only changed lines`() {
+        val serial = FakeSerialStream()
+        val stream = RNodeFramebufferOutputStream(serial, deviceKey, RNodeFramebufferCache())
+        val image = testImage(seed = 1)
+        upload(stream, image)
+        serial.writes.clear()
+
+        val changed = image.copyOf()
+        changed[5 * 8] = (changed[5 * 8].toInt() xor 0xFF).toByte()
+        changed[40 * 8 + 3] = (changed[40 * 8 + 3].toInt() xor 0x01).toByte()
+        upload(stream, changed)
+
+        assertEquals(listOf(5, 40), writtenLines(serial.bytes()))
+        assertEquals(62, stream.skippedLines)
+        assertEquals(2, serial.writes.size)
+        assertArrayEquals(enableFrame, serial.writes.last())
+    }
+
+    @Test
+    fun `unchanged image sends only the enable command`() {
+        val serial = FakeSerialStream()
+        val stream = RNodeFramebufferOutputStream(serial, deviceKey, RNodeFramebufferCache())
+        val image = testImage(seed = 2)
+        upload(stream, image)
+        serial.writes.clear()
+
+        upload(stream, image)
+
+        assertEquals(1, serial.writes.size)
+        assertArrayEquals(enableFrame, serial.bytes())
+    }
+
+    @Test
+    fun `other frames pass through in order and flush held lines first`() {
+        val serial = FakeSerialStream()
+        val stream = RNodeFramebufferOutputStream(serial, deviceKey, RNodeFramebufferCache())
+        val image = testImage(seed = 3)
+        val dataFrame = byteArrayOf(0xC0.toByte(), 0x00, 0x01, 0x02, 0xC0.toByte())
+
+        stream.write(lineFrame(0, image))
+        stream.write(lineFrame(1, image))
+        stream.flush()
+        assertTrue("lines are held across flush()", serial.writes.isEmpty())
+
+        stream.write(dataFrame)
+
+        assertEquals(2, serial.writes.size)
+        assertArrayEquals(lineFrame(0, image) + lineFrame(1, image), serial.writes[0])
+        assertArrayEquals(dataFrame, serial.writes[1])
+    }
+
+    // ========== Connection Lifetime Tests ==========
+
+    @Test
+    fun `a new connection uploads in full`() {
+        val image = testImage(seed = 4)
+        upload(RNodeFramebufferOutputStream(FakeSerialStream(), deviceKey, RNodeFramebufferCache()), image)
+
+        val serial = FakeSerialStream()
+        upload(RNodeFramebufferOutputStream(serial, deviceKey, RNodeFramebufferCache()), image)
+
+        assertEquals(64, writtenLines(serial.bytes()).size)
+    }
+
+    @Test
+    fun `closing the connection forgets what was sent`() {
+        val image = testImage(seed = 4)
+        val cache = RNodeFramebufferCache()
+        RNodeFramebufferOutputStream(FakeSerialStream(), deviceKey, cache).use { upload(it, image) }
+
+        val serial = FakeSerialStream()
+        upload(RNodeFramebufferOutputStream(serial, deviceKey, cache), image)
+
+        assertEquals(64, writtenLines(serial.bytes()).size)
+    }
+
+    @Test
+    fun `failed write forgets the device so the next upload is full`() {
+        val serial = FakeSerialStream()
+        val stream = RNodeFramebufferOutputStream(serial, deviceKey, RNodeFramebufferCache())
+        val image = testImage(seed = 5)
+        upload(stream, image)
+
+        serial.failing = true
+        runCatching { upload(stream, testImage(seed = 6)) }
+        serial.failing = false
+        serial.writes.clear()
+        upload(stream, image)
+
+        assertEquals(64, writtenLines(serial.bytes()).size)
+    }
+
+    // ========== Reset Watch Tests ==========
+
+    @Test
+    fun `reboot report on the inbound stream forgets the cached framebuffer`() {
+        val image = testImage(seed = 6)
+        val cache = RNodeFramebufferCache()
+        val serial = FakeSerialStream()
+        val stream = RNodeFramebufferOutputStream(serial, deviceKey, cache)
+        upload(stream, image)
+        val inbound =
+            byteArrayOf(0xC0.toByte(), 0x08, 0x46, 0xC0.toByte()) +
+                byteArrayOf(0xC0.toByte(), 0x55, 0xF8.toByte(), 0xC0.toByte())
+
+        val input = RNodeResetWatchInputStream(ByteArrayInputStream(inbound), deviceKey, cache)
+        val read = ByteArray(inbound.size)
+        // Split across reads the way a serial stream delivers it
+        input.read(read, 0, 6)
+        input.read(read, 6, inbound.size - 6)
+
+        assertArrayEquals(inbound, read)
+        serial.writes.clear()
+        upload(stream, image)
+        assertEquals(64, writtenLines(serial.bytes()).size)
+    }
+}
@@ -0,0 +1,178 @@
+package network.columba.app.rns.backend.kt
+
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Rule
+import org.junit.Test
+import org.junit.rules.TemporaryFolder
+import java.io.File
+
+/**
+ * Unit tests for TelemetryCollectorStore: the receive-time index, per-sender
+ * history, retention, and the append log that survives restarts.
+ */
+class TelemetryCollectorStoreTest {
+    @get:Rule
+    val tempFolder = TemporaryFolder()
+
+    private var now = 1_700_000_000_000L
+
+    private fun createStore(
+        retentionMs: Long = TelemetryCollectorStore.DEFAULT_RETENTION_MS,
+        maxEntriesPerSender: Int = TelemetryCollectorStore.DEFAULT_MAX_ENTRIES_PER_SENDER,
+    ) = TelemetryCollectorStore(retentionMs, maxEntriesPerSender, clock = { now })
+
+    private fun sender(index: Int): String = "%032x".format(index)
+
+    private fun packed(
+        senderIndex: Int,
+        sequence: Int,
+    ): ByteArray = "telemetry-$senderIndex-$sequence".encodeToByteArray()
+
+    /** 500 senders reporting [rounds] times, one minute apart. */
+    private fun TelemetryCollectorStore.fillWithSenders(rounds: Int) {
+        repeat(rounds) { round ->
+            repeat(500) { i ->
+                store(sender(i), now / 1000L, packed(i, round))
+                now += 1
+            }
+            now += 60_000L
+        }
+    }
+
+    // ========== Index Tests ==========
+
+    @Test
+    fun `timebase query returns only entries received since then`() {
+        val store = createStore()
+        store.fillWithSenders(rounds = 3)
+        val timebase = now
+        store.fillWithSenders(rounds = 2)
+
+        val start = System.nanoTime()
+        val since = store.receivedSince(timebase)
+        val elapsedUs = (System.nanoTime() - start) / 1000
+        println("receivedSince over ${store.size()} entries: ${since.size} rows in ${elapsedUs}us")
+
+        assertEquals(1000, since.size)
+        assertTrue(since.all { it.receivedAtMillis >= timebase })
+        assertEquals(since.sortedBy { it.receivedAtMillis }, since)
+    }
+
+    @Test
+    fun `latest per sender returns one entry for each of 500 senders`() {
+        val store = createStore()
+        store.fillWithSenders(rounds = 4)
+
+        val latest = store.latestPerSender()
+
+        assertEquals(500, latest.size)
+        assertEquals(500, store.senderCount())
+        latest.forEach { entry ->
+            val index = entry.sourceHashHex.toInt(16)
+            assertArrayEquals(packed(index, 3), entry.packedTelemetry)
+        }
+    }
+
+    @Test
+    fun `per-sender history is capped at the oldest end`() {
+        val store = createStore(maxEntriesPerSender = 3)
+        repeat(5) { round ->
+            store.store(sender(1), now / 1000L, packed(1, round))
+            now += 1000L
+        }
+
+        val history = store.history(sender(1))
+
+        assertEquals(listOf(2, 3, 4).map { packed(1, it).decodeToString() }, history.map { it.packedTelemetry.decodeToString() })
+        assertEquals(3, store.size())
+        assertEquals(3, store.receivedSince(0L).size)
+    }
+
+    @Test
+    fun `entries past retention are pruned`() {
+        val store = createStore(retentionMs = 60 * 60_000L)
+        store.store(sender(1), now / 1000L, packed(1, 0))
+        store.store(sender(2), now / 1000L, packed(2, 0))
+        now += 30 * 60_000L
+        store.store(sender(2), now / 1000L, packed(2, 1))
+
+        now += 45 * 60_000L
+        store.store(sender(3), now / 1000L, packed(3, 0))
+
+        assertEquals(2, store.size())
+        assertEquals(listOf(sender(2), sender(3)), store.latestPerSender().map { it.sourceHashHex })
+        assertTrue(store.history(sender(1)).isEmpty())
+    }
+
+    // ========== Persistence Tests ==========
+
+    @Test
+    fun `collected telemetry survives a restart`() {
+        val file = File(tempFolder.root, "telemetry_collector.log")
+        val appearance = listOf("account", byteArrayOf(1, 2, 3), byteArrayOf(4, 5, 6))
+        val first = createStore()
+        first.open(file)
+        first.fillWithSenders(rounds = 2)
+        first.store(sender(7), now / 1000L, packed(7, 99), appearance)
+        first.close()
+
+        val second = createStore()
+        second.open(file)
+
+        assertEquals(first.size(), second.size())
+        assertEquals(500, second.senderCount())
+        val restored = second.latestPerSender().last()
+        assertArrayEquals(packed(7, 99), restored.packedTelemetry)
+        assertEquals("account", restored.appearanceField!![0])
+        assertArrayEquals(byteArrayOf(4, 5, 6), restored.appearanceField!![2] as ByteArray)
+        assertEquals(
+            first.receivedSince(0L).map { it.receivedAtMillis },
+            second.receivedSince(0L).map { it.receivedAtMillis },
+        )
+    }
+
+    @Test
+    fun `torn tail record is dropped on load`() {
+        val file = File(tempFolder.root, "telemetry_collector.log")
+        val first = createStore()
+        first.open(file)
+        repeat(10) { first.store(sender(it), now / 1000L, packed(it, 0)) }
+        first.close()
+        file.writeBytes(file.readBytes().dropLast(5).toByteArray())
+
+        val second = createStore()
+        second.open(file)
+        assertEquals(9, second.size())
+
+        // New records must not land behind the torn one
+        second.store(sender(10), now / 1000L, packed(10, 0))
+        second.close()
+        val third = createStore()
+        third.open(file)
+        assertEquals(10, third.size())
+    }
+
+    @Test
+    fun `expired entries are compacted out of the log`() {
+        val file = File(tempFolder.root, "telemetry_collector.log")
+        val first = createStore(retentionMs = 60 * 60_000L)
+        first.open(file)
+        first.fillWithSenders(rounds = 1)
+        first.close()
+        val fullSize = file.length()
+
+        now += 2 * 60 * 60_000L
+        val second = createStore(retentionMs = 60 * 60_000L)
+        second.open(file)
+        second.store(sender(1), now / 1000L, packed(1, 1))
+        second.close()
+
+        assertEquals(1, second.size())
+        assertTrue("log should shrink from $fullSize bytes, was ${file.length()}", file.length() < fullSize / 100)
+        val third = createStore(retentionMs = 60 * 60_000L)
+        third.open(file)
+        assertEquals(1, third.size())
+    }
+}
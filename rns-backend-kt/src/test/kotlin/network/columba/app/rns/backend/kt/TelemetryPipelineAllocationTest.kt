@@ -0,0 +1,158 @@
+package network.columba.app.rns.backend.kt
+
+import network.columba.app.rns.api.model.LocationTelemetry
+import network.columba.app.rns.api.util.LxmfFields
+import network.columba.app.rns.api.util.TelemeterCodec
+import network.columba.app.rns.api.util.toHex
+import org.json.JSONObject
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Test
+import java.lang.management.ManagementFactory
+
+/**
+ * Allocation benchmark: the typed [LocationTelemetryBuilder] receive path
+ * against the JSONObject working-buffer path it replaced, and the binary
+ * `storeOwnTelemetryPacked` hand-off against the JSON-string one.
+ *
+ * Counts bytes allocated on the test thread via HotSpot's ThreadMXBean;
+ * skipped on JVMs without allocation accounting.
+ */
+class TelemetryPipelineAllocationTest {
+    private val sourceHash = ByteArray(16) { (it * 7).toByte() }
+    private val telemetry =
+        LocationTelemetry(
+            lat = 52.520008,
+            lng = 13.404954,
+            acc = 4.5f,
+            ts = 1_700_000_000_123L,
+            altitude = 34.0,
+            speed = 1.4,
+            bearing = 270.0,
+            expires = 1_700_003_600_000L,
+        )
+    private val fields: Map<Int, Any> =
+        mapOf(
+            LxmfFields.FIELD_TELEMETRY to TelemeterCodec.packLocationTelemetry(telemetry),
+            LxmfFields.FIELD_CUSTOM_META to TelemeterCodec.packColumbaMeta(telemetry)!!,
+        )
+
+    private val threadBean =
+        ManagementFactory.getThreadMXBean() as? com.sun.management.ThreadMXBean
+
+    private fun allocatedBytesPerCall(
+        iterations: Int = 20_000,
+        block: () -> Any?,
+    ): Long {
+        val bean = threadBean!!
+        val threadId = Thread.currentThread().id
+        repeat(2_000) { block() }
+        val before = bean.getThreadAllocatedBytes(threadId)
+        var sink = 0
+        repeat(iterations) { sink += block().hashCode() }
+        val after = bean.getThreadAllocatedBytes(threadId)
+        check(sink != 42) // keep results alive
+        return (after - before) / iterations
+    }
+
+    /** The pre-builder receive path: decode into a JSONObject, merge, log, convert. */
+    private fun legacyReceive(fields: Map<Int, Any>): LocationTelemetry? {
+        val decoded = TelemeterCodec.unpackLocationTelemetry(fields[LxmfFields.FIELD_TELEMETRY] as ByteArray) ?: return null
+        val event =
+            JSONObject()
+                .put("type", LocationTelemetry.TYPE_LOCATION_SHARE)
+                .put("lat", decoded.lat)
+                .put("lng", decoded.lng)
+                .put("acc", decoded.acc.toDouble())
+                .put("ts", decoded.ts)
+                .put("altitude", decoded.altitude)
+                .put("speed", decoded.speed)
+                .put("bearing", decoded.bearing)
+        TelemeterCodec.unpackColumbaMeta(fields[LxmfFields.FIELD_CUSTOM_META] as ByteArray)?.let { meta ->
+            meta.expires?.let { event.put("expires", it) }
+            if (meta.approxRadius > 0) event.put("approxRadius", meta.approxRadius)
+        }
+        event.put("source_hash", sourceHash.toHex())
+        // The old path logged the whole buffer at debug level
+        val logLine = "Emitting location telemetry: $event"
+        check(logLine.isNotEmpty())
+        return LocationTelemetry(
+            type = event.optString("type", LocationTelemetry.TYPE_LOCATION_SHARE),
+            lat = event.optDouble("lat", 0.0),
+            lng = event.optDouble("lng", 0.0),
+            acc = event.optDouble("acc", 0.0).toFloat(),
+            ts = event.optLong("ts", 0L),
+            altitude = event.optDouble("altitude", 0.0),
+            speed = event.optDouble("speed", 0.0),
+            bearing = event.optDouble("bearing", 0.0),
+            expires = if (event.has("expires") && !event.isNull("expires")) event.getLong("expires") else null,
+            approxRadius = event.optInt("approxRadius", 0),
+            sourceHash = event.optString("source_hash", "").ifBlank { null }?.lowercase(),
+        )
+    }
+
+    private fun typedReceive(fields: Map<Int, Any>): LocationTelemetry? =
+        LocationTelemetryBuilder()
+            .mergeLocation(LocationTelemetryBuilder.decodeLocation(fields[LxmfFields.FIELD_TELEMETRY]))
+            .mergeMeta(LocationTelemetryBuilder.decodeMeta(fields[LxmfFields.FIELD_CUSTOM_META]), fallbackTs = 0L)
+            .build(sourceHash = sourceHash.toHex(), appearance = null)
+
+    // ========== Correctness ==========
+
+    @Test
+    fun `typed path produces what the JSON path did`() {
+        val legacy = legacyReceive(fields)
+        val typed = typedReceive(fields)
+
+        assertNotNull(typed)
+        assertEquals(legacy!!.lat, typed!!.lat, 1e-9)
+        assertEquals(legacy.lng, typed.lng, 1e-9)
+        assertEquals(legacy.expires, typed.expires)
+        assertEquals(legacy.sourceHash, typed.sourceHash)
+        // The typed path also keeps the ms-precision timestamp from the meta block
+        assertEquals(telemetry.ts, typed.ts)
+    }
+
+    // ========== Allocation Benchmarks ==========
+
+    @Test
+    fun `typed receive path allocates less than the JSON buffer path`() {
+        assumeTrue("ThreadMXBean allocation accounting unavailable", threadBean?.isThreadAllocatedMemorySupported == true)
+        threadBean!!.isThreadAllocatedMemoryEnabled = true
+
+        val legacyBytes = allocatedBytesPerCall { legacyReceive(fields) }
+        val typedBytes = allocatedBytesPerCall { typedReceive(fields) }
+
+        println("Receive path: JSON buffer $legacyBytes B/message, typed builder $typedBytes B/message")
+        assertTrue("typed $typedBytes B should be below JSON $legacyBytes B", typedBytes < legacyBytes)
+    }
+
+    @Test
+    fun `packed storeOwnTelemetry allocates less than the JSON string variant`() {
+        assumeTrue("ThreadMXBean allocation accounting unavailable", threadBean?.isThreadAllocatedMemorySupported == true)
+        threadBean!!.isThreadAllocatedMemoryEnabled = true
+
+        // JSON variant: app serialises, backend parses and packs
+        val jsonBytes =
+            allocatedBytesPerCall {
+                val json =
+                    JSONObject()
+                        .put("lat", telemetry.lat)
+                        .put("lng", telemetry.lng)
+                        .put("acc", telemetry.acc.toDouble())
+                        .put("ts", telemetry.ts)
+                        .put("altitude", telemetry.altitude)
+                        .put("speed", telemetry.speed)
+                        .put("bearing", telemetry.bearing)
+                        .toString()
+                TelemeterCodec.packLocationTelemetry(LocationTelemetryBuilder.decodeJsonLocation(json)!!)
+            }
+        // Packed variant: app packs once, backend stores the bytes
+        val packedBytes = allocatedBytesPerCall { TelemeterCodec.packLocationTelemetry(telemetry) }
+
+        println("storeOwnTelemetry: JSON $jsonBytes B/call, packed $packedBytes B/call")
+        assertTrue("packed $packedBytes B should be below JSON $jsonBytes B", packedBytes < jsonBytes)
+    }
+}
@@ -0,0 +1,263 @@
+package network.columba.app.rns.backend.kt.harness
+
+import android.app.Application
+import android.content.Context
+import androidx.room.Room
+import androidx.test.core.app.ApplicationProvider
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeoutOrNull
+import network.columba.app.rns.api.model.DeliveryMethod
+import network.columba.app.rns.api.model.Identity
+import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.ReticulumConfig
+import network.columba.app.rns.api.util.hexToBytes
+import network.columba.app.rns.api.util.toHex
+import network.columba.app.rns.backend.kt.NativeRnsBackendImpl
+import network.reticulum.android.db.ReticulumDatabase
+import org.json.JSONObject
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runner.notification.RunNotifier
+import org.robolectric.RobolectricTestRunner
+import org.robolectric.annotation.Config
+import java.io.File
+import java.lang.management.ManagementFactory
+
+/**
+ * One node of the headless harness, run in its own JVM by [NodeHarness].
+ *
+ * reticulum-kt's Transport is a process-wide singleton, so every node gets a
+ * process. The node is a Robolectric test only so that Room has a Context for
+ * its in-memory database; the backend itself gets no Context, which keeps
+ * battery monitoring and telephony out of the measurements.
+ *
+ * Commands arrive on stdin and events leave on stdout, one JSON object per
+ * line (see [HarnessProtocol]). Skipped unless launched by the harness.
+ */
+@RunWith(HarnessNodeProcess.Runner::class)
+@Config(sdk = [34], application = Application::class)
+class HarnessNodeProcess {
+    companion object {
+        private const val ONLINE_TIMEOUT_MS = 30_000L
+        private const val ONLINE_POLL_MS = 20L
+    }
+
+    private lateinit var node: HarnessProtocol.NodeConfig
+    private lateinit var backend: NativeRnsBackendImpl
+    private lateinit var identity: Identity
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+
+    // Sends go out in command order so flood latencies include queueing
+    private val sends = Channel<JSONObject>(Channel.UNLIMITED)
+
+    /** Reports the node as ignored in ordinary test runs, before any Robolectric sandbox boots. */
+    class Runner(
+        testClass: Class<*>,
+    ) : RobolectricTestRunner(testClass) {
+        override fun run(notifier: RunNotifier) {
+            if (System.getenv(HarnessProtocol.NODE_CONFIG_ENV) == null) {
+                notifier.fireTestIgnored(description)
+            } else {
+                super.run(notifier)
+            }
+        }
+    }
+
+    @Test
+    fun serve() {
+        node = HarnessProtocol.NodeConfig.fromJson(JSONObject(System.getenv(HarnessProtocol.NODE_CONFIG_ENV)))
+
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        backend =
+            NativeRnsBackendImpl(
+                reticulumDatabaseFactory = {
+                    Room.inMemoryDatabaseBuilder(context, ReticulumDatabase::class.java).build()
+                },
+            )
+
+        val lxmfHash =
+            runBlocking {
+                backend.initialize(reticulumConfig()).getOrThrow()
+                awaitOnline()
+                identity = backend.getLxmfIdentity().getOrThrow()
+                backend.getLxmfDestination().getOrThrow().hexHash
+            }
+        observeBackend()
+        scope.launch { for (command in sends) send(command) }
+        emit(HarnessProtocol.event("ready").put("lxmf", lxmfHash))
+
+        try {
+            System.`in`.bufferedReader().useLines { lines ->
+                for (line in lines) {
+                    val command = JSONObject(line)
+                    if (command.getString("op") == "shutdown") break
+                    handle(command)
+                }
+            }
+        } finally {
+            scope.cancel()
+            runBlocking { backend.shutdown() }
+            emit(HarnessProtocol.event("stopped"))
+        }
+    }
+
+    private fun reticulumConfig(): ReticulumConfig =
+        ReticulumConfig(
+            storagePath = File(node.storageDir).apply { mkdirs() }.path,
+            enabledInterfaces = interfaces(),
+            displayName = node.name,
+            enableTransport = node.hub,
+        )
+
+    private fun interfaces(): List<InterfaceConfig> =
+        listOf(
+            if (node.hub) {
+                InterfaceConfig.TCPServer(name = "Harness hub", listenIp = "127.0.0.1", listenPort = node.hubPort)
+            } else {
+                InterfaceConfig.TCPClient(name = "Harness uplink", targetHost = "127.0.0.1", targetPort = node.hubPort)
+            },
+        )
+
+    private fun observeBackend() {
+        scope.launch {
+            backend.observeMessages().collect { message ->
+                emit(
+                    HarnessProtocol.event("message")
+                        .put("content", message.content)
+                        .put("from", message.sourceHash.toHex())
+                        .put("fieldsLength", message.fieldsJson?.length ?: 0),
+                )
+            }
+        }
+        scope.launch {
+            backend.observeAnnounces().collect { announce ->
+                emit(
+                    HarnessProtocol.event("announce")
+                        .put("destination", announce.destinationHash.toHex())
+                        .put("name", announce.displayName ?: "")
+                        .put("hops", announce.hops),
+                )
+            }
+        }
+        scope.launch {
+            backend.observeDeliveryStatus().collect { update ->
+                emit(
+                    HarnessProtocol.event("delivery")
+                        .put("hash", update.messageHash)
+                        .put("status", update.status),
+                )
+            }
+        }
+    }
+
+    private fun handle(command: JSONObject) {
+        when (command.getString("op")) {
+            "send" -> sends.trySend(command)
+            "announce" ->
+                scope.launch {
+                    backend.triggerAutoAnnounce(command.getString("name"))
+                    reply(command)
+                }
+            "hasPath" ->
+                scope.launch {
+                    val known = backend.hasPath(command.getString("to").hexToBytes())
+                    reply(command) { put("value", known) }
+                }
+            "requestPath" ->
+                scope.launch {
+                    backend.requestPath(command.getString("to").hexToBytes())
+                    reply(command)
+                }
+            "reconnect" ->
+                scope.launch {
+                    backend.reloadInterfaces(emptyList())
+                    delay(command.optLong("downMs", 0))
+                    backend.reloadInterfaces(interfaces())
+                    awaitOnline()
+                    reply(command)
+                }
+            "stats" -> reply(command) { putStats(this) }
+            else -> emit(HarnessProtocol.event("error").put("message", "unknown op ${command.getString("op")}"))
+        }
+    }
+
+    /** Interfaces start asynchronously; anything sent before they are up is lost. */
+    private suspend fun awaitOnline() {
+        val name = interfaces().single().name
+        withTimeoutOrNull(ONLINE_TIMEOUT_MS) {
+            while (backend.getInterfaceStats(name)?.get("online") != true) delay(ONLINE_POLL_MS)
+        }
+    }
+
+    private suspend fun send(command: JSONObject) {
+        val attachmentBytes = command.optInt("attachmentBytes", 0)
+        val result =
+            backend.sendLxmfMessageWithMethod(
+                destinationHash = command.getString("to").hexToBytes(),
+                content = command.getString("content"),
+                sourceIdentity = identity,
+                deliveryMethod = DeliveryMethod.valueOf(command.optString("method", DeliveryMethod.DIRECT.name)),
+                tryPropagationOnFail = false,
+                imageData = null,
+                imageFormat = null,
+                fileAttachments =
+                    if (attachmentBytes > 0) {
+                        listOf("harness.bin" to ByteArray(attachmentBytes) { it.toByte() })
+                    } else {
+                        null
+                    },
+                replyToMessageId = null,
+                replyQuotedContent = null,
+                iconAppearance = null,
+                extraFields = null,
+            )
+        result.exceptionOrNull()?.let { e ->
+            emit(
+                HarnessProtocol.event("sendFailed")
+                    .put("content", command.getString("content"))
+                    .put("message", e.message ?: e.javaClass.simpleName),
+            )
+        }
+    }
+
+    /**
+     * Allocation is summed over live threads, so bytes allocated by threads
+     * that exited since the last sample are missed; good enough for a rate
+     * over a scenario where the stack's long-lived threads do the work.
+     */
+    private fun putStats(reply: JSONObject) {
+        val threads = ManagementFactory.getThreadMXBean() as? com.sun.management.ThreadMXBean
+        val allocated =
+            if (threads?.isThreadAllocatedMemorySupported == true) {
+                threads.isThreadAllocatedMemoryEnabled = true
+                threads.getThreadAllocatedBytes(threads.allThreadIds).filter { it > 0 }.sum()
+            } else {
+                -1L
+            }
+        val gcs = ManagementFactory.getGarbageCollectorMXBeans()
+        reply
+            .put("uptimeMs", ManagementFactory.getRuntimeMXBean().uptime)
+            .put("allocatedBytes", allocated)
+            .put("heapUsedBytes", ManagementFactory.getMemoryMXBean().heapMemoryUsage.used)
+            .put("gcCount", gcs.sumOf { it.collectionCount.coerceAtLeast(0) })
+            .put("gcTimeMs", gcs.sumOf { it.collectionTime.coerceAtLeast(0) })
+    }
+
+    private fun reply(
+        command: JSONObject,
+        fill: JSONObject.() -> Unit = {},
+    ) {
+        emit(HarnessProtocol.event("reply").put("req", command.getInt("req")).apply(fill))
+    }
+
+    private fun emit(event: JSONObject) {
+        println(HarnessProtocol.EVENT_PREFIX + event)
+    }
+}
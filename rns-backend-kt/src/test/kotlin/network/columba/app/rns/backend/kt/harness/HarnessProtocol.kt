@@ -0,0 +1,60 @@
+package network.columba.app.rns.backend.kt.harness
+
+import org.json.JSONObject
+
+/**
+ * Line protocol between [NodeHarness] and its [HarnessNodeProcess] children.
+ *
+ * Commands (stdin) are JSON objects with an `op` and a `req` id; ops that
+ * finish asynchronously answer with a `reply` event carrying the same `req`.
+ * Events (stdout) are JSON objects with an `event` field, prefixed with
+ * [EVENT_PREFIX] so Robolectric's own output can share the stream.
+ *
+ * | op          | fields                                 | reply                        |
+ * |-------------|----------------------------------------|------------------------------|
+ * | send        | to, content, method?, attachmentBytes? | none (`sendFailed` on error) |
+ * | announce    | name                                   | after announcing             |
+ * | hasPath     | to                                     | `value`                      |
+ * | requestPath | to                                     | after requesting             |
+ * | reconnect   | downMs?                                | after interfaces reload      |
+ * | stats       |                                        | JVM allocation and GC        |
+ * | shutdown    |                                        | `stopped` event              |
+ *
+ * Unsolicited events: `ready` (with the node's `lxmf` hash), `message`,
+ * `announce`, `delivery`, `sendFailed`, `error`.
+ */
+internal object HarnessProtocol {
+    const val NODE_CONFIG_ENV = "COLUMBA_HARNESS_NODE"
+    const val EVENT_PREFIX = "@@harness "
+
+    /** How a node joins the harness topology: the hub serves TCP, spokes dial it. */
+    data class NodeConfig(
+        val name: String,
+        val storageDir: String,
+        val hub: Boolean,
+        val hubPort: Int,
+    ) {
+        fun toJson(): JSONObject =
+            JSONObject()
+                .put("name", name)
+                .put("storageDir", storageDir)
+                .put("hub", hub)
+                .put("hubPort", hubPort)
+
+        companion object {
+            fun fromJson(json: JSONObject) =
+                NodeConfig(
+                    name = json.getString("name"),
+                    storageDir = json.getString("storageDir"),
+                    hub = json.getBoolean("hub"),
+                    hubPort = json.getInt("hubPort"),
+                )
+        }
+    }
+
+    fun event(type: String): JSONObject = JSONObject().put("event", type)
+
+    /** Parse an event line, or null for anything else on the stream. */
+    fun parseEvent(line: String): JSONObject? =
+        if (line.startsWith(EVENT_PREFIX)) JSONObject(line.substring(EVENT_PREFIX.length)) else null
+}
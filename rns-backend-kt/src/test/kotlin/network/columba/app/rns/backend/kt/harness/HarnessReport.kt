@@ -0,0 +1,181 @@
+package network.columba.app.rns.backend.kt.harness
+
+import org.json.JSONArray
+import org.json.JSONObject
+import java.time.Instant
+import java.util.Collections
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.locks.ReentrantLock
+import kotlin.concurrent.withLock
+import kotlin.math.ceil
+
+/**
+ * JVM counters from one node at one moment (the `stats` command).
+ */
+internal data class NodeSample(
+    val uptimeMs: Long,
+    val allocatedBytes: Long,
+    val gcCount: Long,
+) {
+    companion object {
+        fun fromJson(json: JSONObject) =
+            NodeSample(
+                uptimeMs = json.getLong("uptimeMs"),
+                allocatedBytes = json.getLong("allocatedBytes"),
+                gcCount = json.getLong("gcCount"),
+            )
+    }
+}
+
+/**
+ * Outcome of one scenario.
+ *
+ * @property operations Events the scenario expected (messages, announce sightings, ...)
+ * @property completed Events that arrived before the scenario timed out
+ * @property payloadBytes Application bytes carried by the completed events
+ * @property latenciesMs Per-event latency, command to arrival, in ms
+ */
+internal data class ScenarioResult(
+    val name: String,
+    val operations: Int,
+    val completed: Int,
+    val durationMs: Long,
+    val payloadBytes: Long,
+    val latenciesMs: List<Double>,
+    val nodesBefore: Map<String, NodeSample>,
+    val nodesAfter: Map<String, NodeSample>,
+) {
+    val throughputPerSec: Double get() = if (durationMs > 0) completed * 1000.0 / durationMs else 0.0
+
+    fun toJson(): JSONObject {
+        val sorted = latenciesMs.sorted()
+        val nodes = JSONObject()
+        for ((name, after) in nodesAfter) {
+            val before = nodesBefore[name] ?: continue
+            nodes.put(
+                name,
+                JSONObject()
+                    .put("allocationBytesPerSec", allocationRate(before, after))
+                    .put("gcCount", after.gcCount - before.gcCount),
+            )
+        }
+        return JSONObject()
+            .put("name", name)
+            .put("operations", operations)
+            .put("completed", completed)
+            .put("durationMs", durationMs)
+            .put("throughputPerSec", throughputPerSec)
+            .put("bytesPerSec", if (durationMs > 0) payloadBytes * 1000 / durationMs else 0)
+            .put(
+                "latencyMs",
+                JSONObject()
+                    .put("p50", percentile(sorted, 50.0))
+                    .put("p99", percentile(sorted, 99.0))
+                    .put("max", sorted.lastOrNull() ?: 0.0),
+            ).put("nodes", nodes)
+    }
+
+    companion object {
+        /** Nearest-rank percentile of an ascending list; 0 when empty. */
+        fun percentile(
+            sorted: List<Double>,
+            p: Double,
+        ): Double {
+            if (sorted.isEmpty()) return 0.0
+            val rank = ceil(p / 100 * sorted.size).toInt().coerceIn(1, sorted.size)
+            return sorted[rank - 1]
+        }
+
+        /** Bytes allocated per second between two samples, or -1 without allocation accounting. */
+        fun allocationRate(
+            before: NodeSample,
+            after: NodeSample,
+        ): Long {
+            val elapsedMs = after.uptimeMs - before.uptimeMs
+            if (before.allocatedBytes < 0 || after.allocatedBytes < 0 || elapsedMs <= 0) return -1
+            return (after.allocatedBytes - before.allocatedBytes).coerceAtLeast(0) * 1000 / elapsedMs
+        }
+    }
+}
+
+/**
+ * A harness run, as written to the JSON report.
+ *
+ * @param label Free-form build label (e.g. a commit hash) for comparing runs
+ */
+internal class HarnessReport(
+    private val label: String?,
+    private val nodes: List<String>,
+    private val scenarios: List<ScenarioResult>,
+) {
+    companion object {
+        const val SCHEMA_VERSION = 1
+    }
+
+    fun toJson(): JSONObject =
+        JSONObject()
+            .put("schema", SCHEMA_VERSION)
+            .put("label", label ?: JSONObject.NULL)
+            .put("createdAt", Instant.now().toString())
+            .put("jvm", System.getProperty("java.version"))
+            .put("topology", JSONObject().put("type", "hub-and-spoke-tcp").put("nodes", JSONArray(nodes)))
+            .put("scenarios", JSONArray(scenarios.map(ScenarioResult::toJson)))
+}
+
+/**
+ * Matches scenario events to the commands that caused them, by key.
+ * Thread-safe: node reader threads complete while the scenario thread starts.
+ */
+internal class LatencyRecorder {
+    private val started = ConcurrentHashMap<String, Long>()
+    private val latencies = Collections.synchronizedList(ArrayList<Double>())
+    private val lock = ReentrantLock()
+    private val completion = lock.newCondition()
+
+    @Volatile var firstStartNanos = 0L
+        private set
+
+    @Volatile var lastCompletionNanos = 0L
+        private set
+
+    val latenciesMs: List<Double> get() = synchronized(latencies) { latencies.toList() }
+
+    val completed: Int get() = latencies.size
+
+    fun start(
+        key: String,
+        atNanos: Long = System.nanoTime(),
+    ) {
+        if (firstStartNanos == 0L) firstStartNanos = atNanos
+        started[key] = atNanos
+    }
+
+    /** Record [key] as arrived; repeats and unknown keys are ignored. */
+    fun complete(
+        key: String,
+        atNanos: Long,
+    ) {
+        val startedAt = started.remove(key) ?: return
+        lock.withLock {
+            latencies.add((atNanos - startedAt) / 1_000_000.0)
+            lastCompletionNanos = maxOf(lastCompletionNanos, atNanos)
+            completion.signalAll()
+        }
+    }
+
+    /** Wait until [count] events have completed in total; false on timeout. */
+    fun await(
+        count: Int,
+        timeoutMs: Long,
+    ): Boolean {
+        var remainingNanos = TimeUnit.MILLISECONDS.toNanos(timeoutMs)
+        lock.withLock {
+            while (latencies.size < count) {
+                if (remainingNanos <= 0) return false
+                remainingNanos = completion.awaitNanos(remainingNanos)
+            }
+        }
+        return true
+    }
+}
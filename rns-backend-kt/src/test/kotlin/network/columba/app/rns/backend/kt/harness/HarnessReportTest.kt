@@ -0,0 +1,121 @@
+package network.columba.app.rns.backend.kt.harness
+
+import org.json.JSONObject
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import kotlin.concurrent.thread
+
+/**
+ * Unit tests for the node harness bookkeeping: percentiles, allocation rates,
+ * the report JSON and the protocol framing. The harness itself only runs in
+ * [NodeHarnessBenchmark].
+ */
+class HarnessReportTest {
+    private fun result(latencies: List<Double>) =
+        ScenarioResult(
+            name = "message_flood",
+            operations = 4,
+            completed = latencies.size,
+            durationMs = 2_000,
+            payloadBytes = 4_096,
+            latenciesMs = latencies,
+            nodesBefore = mapOf("hub" to NodeSample(uptimeMs = 1_000, allocatedBytes = 1_000_000, gcCount = 2)),
+            nodesAfter = mapOf("hub" to NodeSample(uptimeMs = 3_000, allocatedBytes = 5_000_000, gcCount = 5)),
+        )
+
+    // ========== Report ==========
+
+    @Test
+    fun `percentiles use nearest rank`() {
+        val sorted = (1..100).map { it.toDouble() }
+
+        assertEquals(50.0, ScenarioResult.percentile(sorted, 50.0), 0.0)
+        assertEquals(99.0, ScenarioResult.percentile(sorted, 99.0), 0.0)
+        assertEquals(7.0, ScenarioResult.percentile(listOf(3.0, 7.0), 99.0), 0.0)
+        assertEquals(0.0, ScenarioResult.percentile(emptyList(), 50.0), 0.0)
+    }
+
+    @Test
+    fun `allocation rate is per second of node uptime`() {
+        val before = NodeSample(uptimeMs = 1_000, allocatedBytes = 1_000_000, gcCount = 0)
+        val after = NodeSample(uptimeMs = 3_000, allocatedBytes = 5_000_000, gcCount = 0)
+
+        assertEquals(2_000_000L, ScenarioResult.allocationRate(before, after))
+        assertEquals(-1L, ScenarioResult.allocationRate(before.copy(allocatedBytes = -1), after))
+    }
+
+    @Test
+    fun `scenario JSON carries throughput latency and per-node allocation`() {
+        val json = result(listOf(40.0, 10.0, 30.0, 20.0)).toJson()
+
+        assertEquals("message_flood", json.getString("name"))
+        assertEquals(4, json.getInt("completed"))
+        assertEquals(2.0, json.getDouble("throughputPerSec"), 0.0)
+        assertEquals(2_048L, json.getLong("bytesPerSec"))
+        assertEquals(20.0, json.getJSONObject("latencyMs").getDouble("p50"), 0.0)
+        assertEquals(40.0, json.getJSONObject("latencyMs").getDouble("p99"), 0.0)
+        val hub = json.getJSONObject("nodes").getJSONObject("hub")
+        assertEquals(2_000_000L, hub.getLong("allocationBytesPerSec"))
+        assertEquals(3L, hub.getLong("gcCount"))
+    }
+
+    @Test
+    fun `report round-trips through JSON text`() {
+        val text = HarnessReport("abc123", listOf("hub", "spoke1"), listOf(result(listOf(5.0)))).toJson().toString()
+
+        val parsed = JSONObject(text)
+        assertEquals(HarnessReport.SCHEMA_VERSION, parsed.getInt("schema"))
+        assertEquals("abc123", parsed.getString("label"))
+        assertEquals(2, parsed.getJSONObject("topology").getJSONArray("nodes").length())
+        assertEquals(1, parsed.getJSONArray("scenarios").length())
+    }
+
+    // ========== Recorder ==========
+
+    @Test
+    fun `recorder matches completions to starts and ignores strays`() {
+        val recorder = LatencyRecorder()
+        recorder.start("a", atNanos = 1_000_000)
+        recorder.start("b", atNanos = 2_000_000)
+
+        recorder.complete("a", atNanos = 6_000_000)
+        recorder.complete("a", atNanos = 9_000_000)
+        recorder.complete("unknown", atNanos = 9_000_000)
+
+        assertEquals(listOf(5.0), recorder.latenciesMs)
+        assertFalse(recorder.await(2, timeoutMs = 10))
+    }
+
+    @Test
+    fun `recorder await wakes on completion from another thread`() {
+        val recorder = LatencyRecorder()
+        recorder.start("a")
+
+        val completer = thread { recorder.complete("a", System.nanoTime()) }
+
+        assertTrue(recorder.await(1, timeoutMs = 5_000))
+        completer.join()
+    }
+
+    // ========== Protocol ==========
+
+    @Test
+    fun `only prefixed lines are events`() {
+        val event = HarnessProtocol.event("ready").put("lxmf", "00ff")
+
+        val parsed = HarnessProtocol.parseEvent(HarnessProtocol.EVENT_PREFIX + event)
+
+        assertEquals("00ff", parsed?.getString("lxmf"))
+        assertNull(HarnessProtocol.parseEvent("WARNING: Robolectric is downloading android-all"))
+    }
+
+    @Test
+    fun `node config round-trips`() {
+        val config = HarnessProtocol.NodeConfig("spoke1", "/tmp/spoke1", hub = false, hubPort = 40_123)
+
+        assertEquals(config, HarnessProtocol.NodeConfig.fromJson(JSONObject(config.toJson().toString())))
+    }
+}
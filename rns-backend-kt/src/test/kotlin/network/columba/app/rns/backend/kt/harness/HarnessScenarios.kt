@@ -0,0 +1,156 @@
+package network.columba.app.rns.backend.kt.harness
+
+import org.json.JSONObject
+
+/**
+ * Scripted load against a running [NodeHarness].
+ *
+ * Latency is measured on the harness clock, from writing the command that
+ * causes an event to reading that event from the observing node, so it
+ * includes the (sub-millisecond) pipe hop on each side.
+ */
+internal class HarnessScenarios(
+    private val harness: NodeHarness,
+) {
+    companion object {
+        const val FLOOD_MESSAGES = 200
+        const val STORM_ROUNDS = 10
+        const val RESOURCE_TRANSFERS = 5
+        const val RESOURCE_BYTES = 256 * 1024
+        const val CHURN_ROUNDS = 10
+
+        // Announces of one destination are only passed on if they are newer,
+        // at one-second resolution, so rounds are spaced just over that.
+        private const val ANNOUNCE_SPACING_MS = 1_100L
+        private const val CHURN_DOWN_MS = 1_000L
+        private const val TIMEOUT_MS = 120_000L
+    }
+
+    private val sender get() = harness.spokes[0]
+    private val receiver get() = harness.spokes[1]
+
+    /** [FLOOD_MESSAGES] direct messages fired back to back between two spokes. */
+    fun messageFlood(): ScenarioResult =
+        measure("message_flood", FLOOD_MESSAGES) { recorder ->
+            receiver.listening(onMessage(recorder)) {
+                repeat(FLOOD_MESSAGES) { i ->
+                    val key = "flood-$i"
+                    recorder.start(key)
+                    sender.post("send", JSONObject().put("to", receiver.lxmf).put("content", key))
+                }
+                recorder.await(FLOOD_MESSAGES, TIMEOUT_MS)
+            }
+            0L
+        }
+
+    /** Every spoke announces each round; each announce should reach every other spoke via the hub. */
+    fun announceStorm(): ScenarioResult {
+        val spokes = harness.spokes
+        val sightingsPerRound = spokes.size * (spokes.size - 1)
+        return measure("announce_storm", STORM_ROUNDS * sightingsPerRound) { recorder ->
+            val listeners =
+                spokes.associateWith { observer ->
+                    { event: JSONObject, at: Long ->
+                        if (event.getString("event") == "announce") {
+                            recorder.complete("${observer.name}<-${event.getString("name")}", at)
+                        }
+                    }
+                }
+            listeningAll(listeners) {
+                repeat(STORM_ROUNDS) { round ->
+                    for (announcer in spokes) {
+                        val name = "${announcer.name}#storm-$round"
+                        val at = System.nanoTime()
+                        spokes.filter { it !== announcer }.forEach { recorder.start("${it.name}<-$name", at) }
+                        announcer.post("announce", JSONObject().put("name", name))
+                    }
+                    Thread.sleep(ANNOUNCE_SPACING_MS)
+                }
+                recorder.await(STORM_ROUNDS * sightingsPerRound, TIMEOUT_MS)
+            }
+            0L
+        }
+    }
+
+    /** Messages carrying a [RESOURCE_BYTES] attachment, sent one at a time so each is a lone transfer. */
+    fun resourceTransfer(): ScenarioResult =
+        measure("resource_transfer", RESOURCE_TRANSFERS) { recorder ->
+            receiver.listening(onMessage(recorder)) {
+                for (i in 0 until RESOURCE_TRANSFERS) {
+                    val key = "resource-$i"
+                    recorder.start(key)
+                    sender.post(
+                        "send",
+                        JSONObject().put("to", receiver.lxmf).put("content", key).put("attachmentBytes", RESOURCE_BYTES),
+                    )
+                    if (!recorder.await(i + 1, TIMEOUT_MS)) break
+                }
+            }
+            recorder.completed.toLong() * RESOURCE_BYTES
+        }
+
+    /**
+     * The receiver drops its uplink, reconnects and re-announces; latency is
+     * from the drop until the sender sees the fresh announce.
+     */
+    fun pathChurn(): ScenarioResult =
+        measure("path_churn", CHURN_ROUNDS) { recorder ->
+            val listener = { event: JSONObject, at: Long ->
+                if (event.getString("event") == "announce") recorder.complete(event.getString("name"), at)
+            }
+            sender.listening(listener) {
+                for (round in 0 until CHURN_ROUNDS) {
+                    val name = "${receiver.name}#churn-$round"
+                    recorder.start(name)
+                    receiver.call("reconnect", JSONObject().put("downMs", CHURN_DOWN_MS))
+                    receiver.call("announce", JSONObject().put("name", name))
+                    if (!recorder.await(round + 1, TIMEOUT_MS)) break
+                }
+            }
+            0L
+        }
+
+    private fun onMessage(recorder: LatencyRecorder) =
+        { event: JSONObject, at: Long ->
+            if (event.getString("event") == "message") recorder.complete(event.getString("content"), at)
+        }
+
+    private fun <T> listeningAll(
+        listeners: Map<NodeHarness.Node, (JSONObject, Long) -> Unit>,
+        block: () -> T,
+    ): T {
+        val entries = listeners.entries.toList()
+
+        fun nest(i: Int): T = if (i == entries.size) block() else entries[i].key.listening(entries[i].value) { nest(i + 1) }
+        return nest(0)
+    }
+
+    /**
+     * Run [scenario], sampling every node's JVM counters either side.
+     * [scenario] returns the payload bytes it moved.
+     */
+    private fun measure(
+        name: String,
+        operations: Int,
+        scenario: (LatencyRecorder) -> Long,
+    ): ScenarioResult {
+        val before = sampleNodes()
+        val recorder = LatencyRecorder()
+        val payloadBytes = scenario(recorder)
+        val after = sampleNodes()
+        val durationNanos =
+            if (recorder.completed > 0) recorder.lastCompletionNanos - recorder.firstStartNanos else 0L
+        return ScenarioResult(
+            name = name,
+            operations = operations,
+            completed = recorder.completed,
+            durationMs = durationNanos / 1_000_000,
+            payloadBytes = payloadBytes,
+            latenciesMs = recorder.latenciesMs,
+            nodesBefore = before,
+            nodesAfter = after,
+        )
+    }
+
+    private fun sampleNodes(): Map<String, NodeSample> = harness.nodes.associate { it.name to NodeSample.fromJson(it.call("stats")) }
+}
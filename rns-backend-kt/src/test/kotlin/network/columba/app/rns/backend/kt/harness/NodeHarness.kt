@@ -0,0 +1,198 @@
+package network.columba.app.rns.backend.kt.harness
+
+import org.json.JSONObject
+import org.junit.runner.JUnitCore
+import java.io.Closeable
+import java.io.File
+import java.net.ServerSocket
+import java.util.concurrent.CompletableFuture
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.CopyOnWriteArrayList
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+import kotlin.concurrent.thread
+
+/**
+ * Boots a hub-and-spoke network of native backend nodes, one JVM each, over
+ * local TCP.
+ *
+ * The hub runs a TCP server interface with transport enabled; every spoke
+ * dials it, so spoke-to-spoke traffic crosses the hub's transport and stores.
+ * Node stdout/stderr that is not protocol traffic goes to per-node logs in
+ * [workDir].
+ */
+internal class NodeHarness(
+    private val workDir: File,
+    private val spokeCount: Int = DEFAULT_SPOKES,
+) : Closeable {
+    companion object {
+        const val DEFAULT_SPOKES = 3
+        private const val NODE_HEAP = "512m"
+        private const val READY_TIMEOUT_MS = 120_000L
+        private const val PATH_TIMEOUT_MS = 60_000L
+        private const val PATH_POLL_MS = 250L
+    }
+
+    init {
+        require(spokeCount >= 2) { "Scenarios need at least two spokes" }
+    }
+
+    private val started = mutableListOf<Node>()
+
+    lateinit var hub: Node
+        private set
+    lateinit var spokes: List<Node>
+        private set
+
+    val nodes: List<Node> get() = started
+
+    /** Spawn every node, wait for them to come up and for spokes to learn paths to each other. */
+    fun start() {
+        val hubPort = ServerSocket(0).use { it.localPort }
+        hub = spawn(HarnessProtocol.NodeConfig("hub", File(workDir, "hub").path, hub = true, hubPort = hubPort))
+        hub.awaitReady(READY_TIMEOUT_MS)
+        spokes =
+            (1..spokeCount)
+                .map { i -> spawn(HarnessProtocol.NodeConfig("spoke$i", File(workDir, "spoke$i").path, hub = false, hubPort = hubPort)) }
+                .onEach { it.awaitReady(READY_TIMEOUT_MS) }
+
+        spokes.forEach { it.call("announce", JSONObject().put("name", it.name)) }
+        for (from in spokes) {
+            for (to in spokes) {
+                if (from !== to) awaitPath(from, to)
+            }
+        }
+    }
+
+    private fun awaitPath(
+        from: Node,
+        to: Node,
+    ) {
+        val deadline = System.nanoTime() + TimeUnit.MILLISECONDS.toNanos(PATH_TIMEOUT_MS)
+        while (!from.call("hasPath", JSONObject().put("to", to.lxmf)).getBoolean("value")) {
+            check(System.nanoTime() < deadline) { "${from.name} found no path to ${to.name}" }
+            from.call("requestPath", JSONObject().put("to", to.lxmf))
+            Thread.sleep(PATH_POLL_MS)
+        }
+    }
+
+    private fun spawn(config: HarnessProtocol.NodeConfig): Node {
+        val command =
+            buildList {
+                add(File(System.getProperty("java.home"), "bin/java").path)
+                add("-Xmx$NODE_HEAP")
+                // Carry Robolectric settings (offline jars etc.) over from the test JVM
+                System.getProperties().stringPropertyNames().filter { it.startsWith("robolectric.") }.forEach {
+                    add("-D$it=${System.getProperty(it)}")
+                }
+                add("-cp")
+                add(System.getProperty("java.class.path"))
+                add(JUnitCore::class.java.name)
+                add(HarnessNodeProcess::class.java.name)
+            }
+        val process =
+            ProcessBuilder(command)
+                .redirectError(File(workDir, "${config.name}.stderr.log"))
+                .apply { environment()[HarnessProtocol.NODE_CONFIG_ENV] = config.toJson().toString() }
+                .start()
+        return Node(config.name, process, File(workDir, "${config.name}.stdout.log")).also(started::add)
+    }
+
+    override fun close() {
+        started.forEach(Node::stop)
+        started.clear()
+    }
+
+    /** Handle on one node process. */
+    class Node(
+        val name: String,
+        private val process: Process,
+        log: File,
+    ) {
+        private val writer = process.outputStream.bufferedWriter()
+        private val nextReq = AtomicInteger()
+        private val pending = ConcurrentHashMap<Int, CompletableFuture<JSONObject>>()
+        private val listeners = CopyOnWriteArrayList<(JSONObject, Long) -> Unit>()
+        private val ready = CompletableFuture<JSONObject>()
+
+        /** The node's LXMF delivery destination hash, hex. */
+        lateinit var lxmf: String
+            private set
+
+        init {
+            thread(name = "harness-$name", isDaemon = true) {
+                log.bufferedWriter().use { out ->
+                    process.inputStream.bufferedReader().forEachLine { line ->
+                        val receivedAt = System.nanoTime()
+                        val event = HarnessProtocol.parseEvent(line)
+                        if (event == null) {
+                            out.appendLine(line)
+                        } else {
+                            when (event.getString("event")) {
+                                "ready" -> ready.complete(event)
+                                "reply" -> pending.remove(event.getInt("req"))?.complete(event)
+                            }
+                            listeners.forEach { it(event, receivedAt) }
+                        }
+                    }
+                }
+                val exited = IllegalStateException("$name exited; see its logs")
+                ready.completeExceptionally(exited)
+                pending.values.forEach { it.completeExceptionally(exited) }
+            }
+        }
+
+        fun awaitReady(timeoutMs: Long) {
+            lxmf = ready.get(timeoutMs, TimeUnit.MILLISECONDS).getString("lxmf")
+        }
+
+        /** Send a command without waiting for it to finish. */
+        fun post(
+            op: String,
+            fields: JSONObject = JSONObject(),
+        ) {
+            write(fields.put("op", op).put("req", nextReq.incrementAndGet()))
+        }
+
+        /** Send a command and wait for its reply. */
+        fun call(
+            op: String,
+            fields: JSONObject = JSONObject(),
+            timeoutMs: Long = 30_000,
+        ): JSONObject {
+            val req = nextReq.incrementAndGet()
+            val reply = CompletableFuture<JSONObject>()
+            pending[req] = reply
+            write(fields.put("op", op).put("req", req))
+            return reply.get(timeoutMs, TimeUnit.MILLISECONDS)
+        }
+
+        /** Run [block] with [listener] seeing every event and its arrival time (nanoTime). */
+        fun <T> listening(
+            listener: (JSONObject, Long) -> Unit,
+            block: () -> T,
+        ): T {
+            listeners.add(listener)
+            try {
+                return block()
+            } finally {
+                listeners.remove(listener)
+            }
+        }
+
+        private fun write(command: JSONObject) {
+            synchronized(writer) {
+                writer.write(command.toString())
+                writer.newLine()
+                writer.flush()
+            }
+        }
+
+        fun stop() {
+            runCatching { write(JSONObject().put("op", "shutdown").put("req", nextReq.incrementAndGet())) }
+            if (!process.waitFor(30, TimeUnit.SECONDS)) {
+                process.destroyForcibly()
+            }
+        }
+    }
+}
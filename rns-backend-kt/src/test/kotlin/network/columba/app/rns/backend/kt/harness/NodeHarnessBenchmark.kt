@@ -0,0 +1,65 @@
+package network.columba.app.rns.backend.kt.harness
+
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Test
+import java.io.File
+import java.nio.file.Files
+
+/**
+ * Benchmark: end-to-end throughput, latency and allocation of the native
+ * backend, with every node a separate JVM on local TCP (see [NodeHarness]).
+ *
+ * Takes a few minutes, so it only runs when asked:
+ *
+ *     COLUMBA_NODE_HARNESS=1 ./gradlew :rns-backend-kt:testDebugUnitTest \
+ *         --tests '*NodeHarnessBenchmark*'
+ *
+ * Optional: `COLUMBA_NODE_HARNESS_SPOKES` (default 3),
+ * `COLUMBA_NODE_HARNESS_LABEL` (e.g. the commit hash, copied into the report)
+ * and `COLUMBA_NODE_HARNESS_REPORT` (default `build/node-harness/report.json`).
+ * Compare reports from two builds to spot regressions; node logs are kept in
+ * the printed work directory.
+ */
+class NodeHarnessBenchmark {
+    companion object {
+        private const val RUN_ENV = "COLUMBA_NODE_HARNESS"
+    }
+
+    // ========== Benchmarks ==========
+
+    @Test
+    fun `scripted scenarios report throughput latency and allocation as JSON`() {
+        assumeTrue("Set $RUN_ENV=1 to run the node harness", System.getenv(RUN_ENV) == "1")
+        val spokes = System.getenv("${RUN_ENV}_SPOKES")?.toIntOrNull() ?: NodeHarness.DEFAULT_SPOKES
+        val workDir = Files.createTempDirectory("columba-node-harness").toFile()
+        println("Node harness work directory: $workDir")
+
+        NodeHarness(workDir, spokes).use { harness ->
+            harness.start()
+            val scenarios = HarnessScenarios(harness)
+            val results =
+                listOf(
+                    scenarios.messageFlood(),
+                    scenarios.announceStorm(),
+                    scenarios.resourceTransfer(),
+                    scenarios.pathChurn(),
+                )
+
+            val report = HarnessReport(System.getenv("${RUN_ENV}_LABEL"), harness.nodes.map { it.name }, results).toJson()
+            val output = File(System.getenv("${RUN_ENV}_REPORT") ?: "build/node-harness/report.json")
+            output.parentFile?.mkdirs()
+            output.writeText(report.toString(2))
+            println(report.toString(2))
+            println("Node harness report: ${output.absolutePath}")
+
+            results.forEach { result ->
+                println(
+                    "${result.name}: ${result.completed}/${result.operations} in ${result.durationMs} ms, " +
+                        "%.1f/s".format(result.throughputPerSec),
+                )
+                assertTrue("${result.name}: nothing arrived", result.completed > 0)
+            }
+        }
+    }
+}
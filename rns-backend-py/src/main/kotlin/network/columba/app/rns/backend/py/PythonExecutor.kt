@@ -0,0 +1,122 @@
+package network.columba.app.rns.backend.py
+
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.asCoroutineDispatcher
+import kotlinx.coroutines.launch
+import java.util.concurrent.Executors
+import java.util.concurrent.SynchronousQueue
+import java.util.concurrent.ThreadPoolExecutor
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * The threads every PyObject call runs on.
+ *
+ * Only one thread can hold the GIL, so spreading Python work over
+ * `Dispatchers.IO` just has dozens of threads queue for it (and gives each
+ * one its own Chaquopy thread state). Two threads rather than one so a
+ * single slow upstream call can't stall every other caller; blocks that
+ * wait should `delay`, not `Thread.sleep`, so they give the thread back
+ * while waiting.
+ *
+ * Calls known to hold their thread for seconds — `Reticulum()` start-up and
+ * teardown, and sends, where `handle_outbound` may block in
+ * [StampGeneratorCallback] until a stamp is found — run on
+ * [blockingDispatcher] instead, so they can never occupy both [dispatcher]
+ * threads. Its threads are created on demand and retire when idle.
+ */
+internal object PythonExecutor {
+    const val THREAD_COUNT = 2
+    private const val BLOCKING_KEEP_ALIVE_SECONDS = 30L
+
+    private val threadSeq = AtomicInteger(0)
+    private val blockingThreadSeq = AtomicInteger(0)
+
+    val dispatcher: CoroutineDispatcher =
+        Executors
+            .newFixedThreadPool(THREAD_COUNT) { runnable ->
+                Thread(runnable, "rns-python-${threadSeq.incrementAndGet()}").apply { isDaemon = true }
+            }.asCoroutineDispatcher()
+
+    /** For long-running or blocking Python calls; see the class doc. */
+    val blockingDispatcher: CoroutineDispatcher =
+        ThreadPoolExecutor(0, Int.MAX_VALUE, BLOCKING_KEEP_ALIVE_SECONDS, TimeUnit.SECONDS, SynchronousQueue()) { runnable ->
+            Thread(runnable, "rns-python-blocking-${blockingThreadSeq.incrementAndGet()}").apply { isDaemon = true }
+        }.asCoroutineDispatcher()
+
+    /** For backend-internal background jobs that call into Python. */
+    fun newScope(): CoroutineScope = CoroutineScope(SupervisorJob() + dispatcher)
+}
+
+/**
+ * Answers many single-key lookups with few [lookup] calls.
+ *
+ * Callers that arrive while a lookup is in flight are queued and answered
+ * together by the next one, so N concurrent `hasPath` / `getHopCount`
+ * calls cost one JNI crossing per round instead of N (or 2N). Concurrent
+ * requests for the same key share one result. Batches are capped at
+ * [maxBatchSize] keys.
+ *
+ * [lookup] must return exactly one value per key, in order. If it throws,
+ * every caller in that batch gets the exception.
+ */
+internal class CoalescingBatcher<K, V>(
+    private val scope: CoroutineScope,
+    private val maxBatchSize: Int = DEFAULT_MAX_BATCH_SIZE,
+    private val lookup: suspend (List<K>) -> List<V>,
+) {
+    companion object {
+        const val DEFAULT_MAX_BATCH_SIZE = 256
+    }
+
+    private val lock = Any()
+    private var pending = LinkedHashMap<K, CompletableDeferred<V>>()
+    private var draining = false
+
+    suspend fun get(key: K): V {
+        val deferred: CompletableDeferred<V>
+        val startDrain: Boolean
+        synchronized(lock) {
+            deferred = pending.getOrPut(key) { CompletableDeferred() }
+            startDrain = !draining
+            draining = true
+        }
+        if (startDrain) scope.launch { drain() }
+        return deferred.await()
+    }
+
+    private suspend fun drain() {
+        while (true) {
+            val batch =
+                synchronized(lock) {
+                    if (pending.isEmpty()) {
+                        draining = false
+                        return
+                    }
+                    val taken = LinkedHashMap<K, CompletableDeferred<V>>()
+                    val iterator = pending.entries.iterator()
+                    while (iterator.hasNext() && taken.size < maxBatchSize) {
+                        val entry = iterator.next()
+                        taken[entry.key] = entry.value
+                        iterator.remove()
+                    }
+                    taken
+                }
+            try {
+                val values = lookup(batch.keys.toList())
+                check(values.size == batch.size) { "lookup returned ${values.size} values for ${batch.size} keys" }
+                batch.values.forEachIndexed { index, deferred -> deferred.complete(values[index]) }
+            } catch (e: CancellationException) {
+                batch.values.forEach { it.completeExceptionally(e) }
+                synchronized(lock) { draining = false }
+                throw e
+            } catch (e: Throwable) {
+                batch.values.forEach { it.completeExceptionally(e) }
+            }
+        }
+    }
+}
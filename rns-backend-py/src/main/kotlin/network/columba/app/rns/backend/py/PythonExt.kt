@@ -2,7 +2,7 @@ package network.columba.app.rns.backend.py
 
 import com.chaquo.python.PyObject
 import com.chaquo.python.Python
-import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.CoroutineDispatcher
 import kotlinx.coroutines.withContext
 import network.columba.app.rns.api.RnsError
 import network.columba.app.rns.api.RnsException
@@ -16,7 +16,7 @@ import network.columba.app.rns.api.util.hexToBytes
  *    `List` into a `callAttr` list parameter makes Python see
  *    `'ArrayList' object is not iterable`. Always convert first.
  *  - **Off-thread + typed errors** ([pyResult]). Every PyObject call holds
- *    the GIL; it must run on `Dispatchers.IO`, never the caller's thread.
+ *    the GIL; it must run on [PythonExecutor], never the caller's thread.
  *    Chaquopy's `PyException` can't cross the AIDL seam, so failures are
  *    translated to [RnsException] / [RnsError] here.
  */
@@ -119,15 +119,19 @@ fun PyObject.dictBytes(key: String): ByteArray? =
 // --- Off-thread call + typed-error translation -----------------------------
 
 /**
- * Run a block of PyObject calls on [Dispatchers.IO] and fold the outcome into
+ * Run a block of PyObject calls on [PythonExecutor] and fold the outcome into
  * a [Result]. A thrown [RnsException] is preserved verbatim; anything else
  * (including Chaquopy's `PyException`) is wrapped in [RnsError.Generic] with
  * the message + stack trace text so the failure survives the AIDL seam.
  *
- * Use this for every `suspend fun ...: Result<T>` on the sub-interfaces.
+ * Use this for every `suspend fun ...: Result<T>` on the sub-interfaces;
+ * pass [PythonExecutor.blockingDispatcher] for calls that can block for long.
  */
-internal suspend fun <T> pyResult(block: suspend () -> T): Result<T> =
-    withContext(Dispatchers.IO) {
+internal suspend fun <T> pyResult(
+    dispatcher: CoroutineDispatcher = PythonExecutor.dispatcher,
+    block: suspend () -> T,
+): Result<T> =
+    withContext(dispatcher) {
         try {
             Result.success(block())
         } catch (e: RnsException) {
@@ -145,12 +149,15 @@ internal suspend fun <T> pyResult(block: suspend () -> T): Result<T> =
     }
 
 /**
- * Run a block of PyObject calls on [Dispatchers.IO] for a non-`Result`
+ * Run a block of PyObject calls on [PythonExecutor] for a non-`Result`
  * suspend method, translating Chaquopy `PyException` into [RnsException] so
  * it still crosses the AIDL seam as a typed error.
  */
-internal suspend fun <T> pyCall(block: suspend () -> T): T =
-    withContext(Dispatchers.IO) {
+internal suspend fun <T> pyCall(
+    dispatcher: CoroutineDispatcher = PythonExecutor.dispatcher,
+    block: suspend () -> T,
+): T =
+    withContext(dispatcher) {
         try {
             block()
         } catch (e: RnsException) {
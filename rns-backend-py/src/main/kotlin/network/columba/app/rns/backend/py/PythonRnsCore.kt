@@ -3,7 +3,9 @@ package network.columba.app.rns.backend.py
 import android.util.Log
 import com.chaquo.python.PyObject
 import network.columba.app.rns.api.util.hexToBytes
+import network.columba.app.rns.api.util.pathTableDeltas
 import network.columba.app.rns.api.util.toHex
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
@@ -24,6 +26,7 @@ import network.columba.app.rns.api.model.LinkStatus
 import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.ReceivedPacket
 import network.columba.app.rns.api.model.ReticulumConfig
 import java.util.concurrent.ConcurrentHashMap
@@ -34,7 +37,7 @@ import java.util.concurrent.atomic.AtomicLong
  *
  * This is the **pattern template** for the other `PythonRns*` sub-impls:
  *  - every `suspend` method routes through [pyResult] / [pyCall] so PyObject
- *    calls run on `Dispatchers.IO` and Chaquopy `PyException`s become typed
+ *    calls run on [PythonExecutor] and Chaquopy `PyException`s become typed
  *    [RnsError]s;
  *  - live upstream objects (`RNS.Identity` / `RNS.Destination` / `RNS.Link`)
  *    live in [PythonRnsRuntime]'s registries, keyed by the hash/handle that
@@ -65,6 +68,18 @@ class PythonRnsCore(
         /** Lower bound on the link-establishment wait — guards against
          *  tiny caller timeouts that would race the link setup. */
         const val MIN_LINK_WAIT_MS = 1_000L
+
+        /** Snapshot cadence for `observePathTable` (ms). */
+        const val PATH_TABLE_POLL_INTERVAL_MS = 5_000L
+
+        /** `event_bridge.path_table_snapshot` record: 16-byte hash + 1 hops byte. */
+        const val PATH_TABLE_RECORD_SIZE = 17
+
+        /** Truncated destination hash length `event_bridge.path_info` expects. */
+        const val DESTINATION_HASH_BYTES = 16
+
+        /** `event_bridge.path_info` byte for "no path". */
+        const val PATH_INFO_NO_PATH = 0xFF
     }
 
     private val _networkStatus = MutableStateFlow<NetworkStatus>(NetworkStatus.SHUTDOWN)
@@ -73,6 +88,24 @@ class PythonRnsCore(
     /** Monotonic handle ids for live `RNS.Link` objects (mirrors `:rns-ipc` HandleRegistry). */
     private val linkHandleSeq = AtomicLong(1)
 
+    /**
+     * [hasPath] / [getHopCount] lookups, batched into `event_bridge.path_info`
+     * calls: one crossing per round for however many destinations are being
+     * asked about, instead of `has_path` + `hops_to` crossings for each.
+     * Value is the hop count, or null when there is no path.
+     */
+    private val pathInfo =
+        CoalescingBatcher<String, Int?>(PythonExecutor.newScope()) { hexHashes ->
+            val packed = ByteArray(hexHashes.size * DESTINATION_HASH_BYTES)
+            hexHashes.forEachIndexed { index, hex ->
+                hex.hexToBytes().copyInto(packed, index * DESTINATION_HASH_BYTES)
+            }
+            runtime.eventBridge
+                .callAttr("path_info", packed.toPyBytes())
+                .toJava(ByteArray::class.java)
+                .map { byte -> (byte.toInt() and 0xFF).takeIf { it != PATH_INFO_NO_PATH } }
+        }
+
     /** Local block/blackhole sets. Enforcement is shared app-logic in `:rns-host`. */
     private val blockedDestinations = ConcurrentHashMap.newKeySet<String>()
     private val blackholedIdentities = ConcurrentHashMap.newKeySet<String>()
@@ -83,7 +116,7 @@ class PythonRnsCore(
     // boundary must flip networkStatus to ERROR before re-throwing.
     @Suppress("TooGenericExceptionCaught")
     override suspend fun initialize(config: ReticulumConfig): Result<Unit> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             _networkStatus.value = NetworkStatus.INITIALIZING
             try {
                 runtime.start(config)
@@ -108,7 +141,7 @@ class PythonRnsCore(
         }
 
     override suspend fun shutdown(): Result<Unit> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             runtime.stop()
             _networkStatus.value = NetworkStatus.SHUTDOWN
         }
@@ -344,10 +377,7 @@ class PythonRnsCore(
     // ==================== Path & transport ====================
 
     override suspend fun hasPath(destinationHash: ByteArray): Boolean =
-        pyCall {
-            transport().callAttr("has_path", destinationHash.toPyBytes())
-                ?.toJava(Boolean::class.javaObjectType) ?: false
-        }
+        pyCall { pathHops(destinationHash) != null }
 
     override suspend fun requestPath(destinationHash: ByteArray): Result<Unit> =
         pyResult {
@@ -362,15 +392,11 @@ class PythonRnsCore(
     }
 
     override suspend fun getHopCount(destinationHash: ByteArray): Int? =
-        pyCall {
-            val t = transport()
-            if (t.callAttr("has_path", destinationHash.toPyBytes())
-                    ?.toJava(Boolean::class.javaObjectType) != true
-            ) {
-                return@pyCall null
-            }
-            t.callAttr("hops_to", destinationHash.toPyBytes())?.toJava(Int::class.javaObjectType)
-        }
+        pyCall { pathHops(destinationHash) }
+
+    /** Hops to [destinationHash] via [pathInfo], or null without a path (or for a malformed hash). */
+    private suspend fun pathHops(destinationHash: ByteArray): Int? =
+        if (destinationHash.size != DESTINATION_HASH_BYTES) null else pathInfo.get(destinationHash.toHex())
 
     override suspend fun getNextHopInterfaceName(destinationHash: ByteArray): String? =
         pyCall {
@@ -447,6 +473,17 @@ class PythonRnsCore(
             }
         }
 
+    // Python RNS has no path-table listener either; event_bridge packs a
+    // snapshot into one bytes object and the diffing happens here.
+    override fun observePathTable(): Flow<PathTableDelta> =
+        pathTableDeltas(PATH_TABLE_POLL_INTERVAL_MS) {
+            pyCall {
+                val packed =
+                    runtime.eventBridge.callAttr("path_table_snapshot").toJava(ByteArray::class.java)
+                decodePathTableSnapshot(packed)
+            }
+        }
+
     override suspend fun probeLinkSpeed(
         destinationHash: ByteArray,
         timeoutSeconds: Float,
@@ -726,7 +763,7 @@ class PythonRnsCore(
         "TooGenericExceptionCaught",
         "CyclomaticComplexMethod",
     )
-    private fun tryEstablishLink(
+    private suspend fun tryEstablishLink(
         destinationHash: ByteArray,
         timeoutSeconds: Float,
     ): Pair<PyObject?, String?> {
@@ -801,7 +838,7 @@ class PythonRnsCore(
             runCatching { transport.callAttr("request_path", recipientHashPy) }
             val pathDeadlineMs = System.currentTimeMillis() + PATH_WAIT_MS
             while (!hasPath && System.currentTimeMillis() < pathDeadlineMs) {
-                Thread.sleep(PATH_POLL_MS)
+                delay(PATH_POLL_MS)
                 hasPath = runCatching {
                     transport.callAttr("has_path", recipientHashPy)
                         ?.toJava(Boolean::class.javaObjectType) ?: false
@@ -851,7 +888,7 @@ class PythonRnsCore(
                 runCatching { directLinks?.callAttr("pop", recipientHashPy, null) }
                 return null to "Link closed during establishment"
             }
-            Thread.sleep(LINK_POLL_MS)
+            delay(LINK_POLL_MS)
         }
 
         // Timeout.
@@ -963,7 +1000,7 @@ class PythonRnsCore(
                     .onFailure { Log.w(TAG, "request_path failed", it) }
                 val pathDeadline = System.currentTimeMillis() + PATH_WAIT_MS
                 while (!hasPath && System.currentTimeMillis() < pathDeadline) {
-                    Thread.sleep(PATH_POLL_MS)
+                    delay(PATH_POLL_MS)
                     hasPath = transport.callAttr("has_path", createdHashPy)
                         ?.toJava(Boolean::class.javaObjectType) ?: false
                 }
@@ -1014,7 +1051,7 @@ class PythonRnsCore(
                         Log.w(TAG, "establishConversationLink: link closed during establishment")
                         return@pyResult ConversationLinkResult(isActive = false, error = "Link closed")
                     }
-                    Thread.sleep(LINK_POLL_MS)
+                    delay(LINK_POLL_MS)
                 }
                 // Timeout
                 runCatching { link.callAttr("teardown") }
@@ -1406,6 +1443,17 @@ class PythonRnsCore(
         )
     }
 
+    private fun decodePathTableSnapshot(packed: ByteArray): Map<String, Int> {
+        val table = HashMap<String, Int>(packed.size / PATH_TABLE_RECORD_SIZE * 2)
+        var offset = 0
+        while (offset + PATH_TABLE_RECORD_SIZE <= packed.size) {
+            val hash = packed.copyOfRange(offset, offset + PATH_TABLE_RECORD_SIZE - 1).toHex()
+            table[hash] = packed[offset + PATH_TABLE_RECORD_SIZE - 1].toInt() and 0xFF
+            offset += PATH_TABLE_RECORD_SIZE
+        }
+        return table
+    }
+
     private fun directionConst(direction: Direction): String =
         when (direction) {
             Direction.IN -> "IN"
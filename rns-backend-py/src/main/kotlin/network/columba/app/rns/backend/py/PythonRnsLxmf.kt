@@ -3,10 +3,7 @@ package network.columba.app.rns.backend.py
 import android.util.Log
 import com.chaquo.python.PyObject
 import com.chaquo.python.Python
-import kotlinx.coroutines.CoroutineScope
-import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
-import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableSharedFlow
@@ -37,7 +34,7 @@ import network.columba.app.rns.api.util.toHex
  *
  * Follows the [PythonRnsCore] pattern template: every `suspend` method routes
  * through [pyResult] / [pyCall] so the GIL-holding PyObject calls run on
- * `Dispatchers.IO` and Chaquopy `PyException`s become typed [RnsError]s; the
+ * [PythonExecutor] and Chaquopy `PyException`s become typed [RnsError]s; the
  * observable flows are sourced from [PythonEventBridge]; where the exact
  * upstream call shape needs on-device iteration the method is an honest
  * best-effort with a `TODO(on-device)` marker — never a silent fake.
@@ -76,7 +73,7 @@ class PythonRnsLxmf(
      * the process restarts. The single in-flight job is tracked in
      * [propagationPollJob] so a re-trigger / cancel can interrupt it.
      */
-    private val backgroundScope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
+    private val backgroundScope = PythonExecutor.newScope()
 
     @Volatile
     private var propagationPollJob: Job? = null
@@ -105,7 +102,7 @@ class PythonRnsLxmf(
         imageFormat: String?,
         fileAttachments: List<Pair<String, ByteArray>>?,
     ): Result<MessageReceipt> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             runtime.requireRunning()
             val fields = buildFields(
                 imageData = imageData,
@@ -135,7 +132,7 @@ class PythonRnsLxmf(
         iconAppearance: IconAppearance?,
         extraFields: Map<Int, Any>?,
     ): Result<MessageReceipt> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             runtime.requireRunning()
             val fields = buildFields(
                 imageData = imageData,
@@ -168,7 +165,7 @@ class PythonRnsLxmf(
         emoji: String,
         sourceIdentity: Identity,
     ): Result<MessageReceipt> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             runtime.requireRunning()
             // Canonical LXMF `fields[0x40] = {0x00: hashBytes, 0x01: emojiBytes}`
             // on an otherwise-empty message — the reactor is derived from the
@@ -201,7 +198,7 @@ class PythonRnsLxmf(
     // method) throws a distinct typed RnsException; collapsing them would lose
     // the failure distinction the UI surfaces.
     @Suppress("ThrowsCount", "LongParameterList")
-    private fun dispatchLxmessage(
+    private suspend fun dispatchLxmessage(
         destinationHash: ByteArray,
         content: String,
         fields: PyObject,
@@ -267,7 +264,7 @@ class PythonRnsLxmf(
      * "delivery")` — the same shape `NativeMessageSender` uses. If the identity
      * is not yet known a path is requested and we poll briefly.
      */
-    private fun resolveRecipientDestination(destinationHash: ByteArray): PyObject {
+    private suspend fun resolveRecipientDestination(destinationHash: ByteArray): PyObject {
         val hex = destinationHash.toHex()
         runtime.destinations[hex]?.let { return it }
 
@@ -281,7 +278,7 @@ class PythonRnsLxmf(
             transport().callAttr("request_path", hashPy)
             val deadline = System.currentTimeMillis() + PATH_RESOLVE_TIMEOUT_MS
             while (recipientIdentity == null && System.currentTimeMillis() < deadline) {
-                Thread.sleep(PATH_RESOLVE_POLL_MS)
+                delay(PATH_RESOLVE_POLL_MS)
                 recipientIdentity = identityClass.callAttr("recall", hashPy)
             }
         }
@@ -30,7 +30,7 @@ import java.util.concurrent.atomic.AtomicBoolean
  * facade. See the module CLAUDE.md.
  *
  * Threading: every method here is expected to be called from
- * `Dispatchers.IO` (the sub-impls wrap their calls in [pyResult] / [pyCall]).
+ * [PythonExecutor] (the sub-impls wrap their calls in [pyResult] / [pyCall]).
  * The registries are [ConcurrentHashMap] because event-bridge callbacks fire
  * on RNS internal threads.
  */
@@ -183,7 +183,7 @@ class PythonRnsRuntime(
      * first `RNS.Reticulum()` is constructed. `Reticulum.__init__` ends by
      * registering SIGINT/SIGTERM handlers via `signal.signal()`, which raises
      * `ValueError` off Python's main thread — and every PyObject call here runs
-     * on `Dispatchers.IO`, so without this `__init__` aborts after Transport +
+     * on [PythonExecutor]'s threads, so without this `__init__` aborts after Transport +
      * interfaces are up but before it returns. Idempotent; the Python side also
      * guards against a double-apply.
      */
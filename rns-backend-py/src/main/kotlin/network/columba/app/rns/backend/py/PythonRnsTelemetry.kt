@@ -79,7 +79,7 @@ class PythonRnsTelemetry(
         sourceIdentity: Identity,
         iconAppearance: IconAppearance?,
     ): Result<MessageReceipt> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             runtime.requireRunning()
             // Wire format (Sideband-interop, paramount):
             //   FIELD_TELEMETRY (0x02)   = upstream Telemeter msgpack
@@ -110,7 +110,7 @@ class PythonRnsTelemetry(
         timebase: Long?,
         isCollectorRequest: Boolean,
     ): Result<MessageReceipt> =
-        pyResult {
+        pyResult(PythonExecutor.blockingDispatcher) {
             runtime.requireRunning()
             // LXMF FIELD_COMMANDS telemetry request. Match Sideband's
             // canonical shape `{0x01: [timebase, is_collector_request]}`
@@ -161,11 +161,8 @@ class PythonRnsTelemetry(
     ): Result<Unit> =
         pyResult {
             // Pack the JSON into a Sideband-compatible FIELD_TELEMETRY
-            // blob via the shared `TelemeterCodec`, then hand it to
-            // `event_bridge.store_own_telemetry` so it lands in the same
-            // `_collected_telemetry` dict the FIELD_COMMANDS responder
-            // serves. Keyed in event_bridge by the local delivery
-            // destination hash — no need to pass the key from here.
+            // blob via the shared `TelemeterCodec`, then store it like the
+            // packed variant does.
             val parsed = Json.parseToJsonElement(locationJson).jsonObject
             val telemetry =
                 LocationTelemetry(
@@ -177,29 +174,49 @@ class PythonRnsTelemetry(
                     speed = parsed["speed"]?.jsonPrimitive?.double ?: 0.0,
                     bearing = parsed["bearing"]?.jsonPrimitive?.double ?: 0.0,
                 )
-            val packedBytes = TelemeterCodec.packLocationTelemetry(telemetry)
-            val tsSeconds = telemetry.ts / 1000L
-            val appearancePy =
-                iconAppearance?.let { it.toPyField() }
-                    ?: runtime.python.getBuiltins().get("None")
-            runtime.eventBridge.callAttr(
-                "store_own_telemetry",
-                packedBytes.toPyBytes(),
-                tsSeconds,
-                appearancePy,
-            )
+            storeOwnPacked(TelemeterCodec.packLocationTelemetry(telemetry), telemetry.ts / 1000L, iconAppearance)
             // Keep the local mirror so a debug `ownTelemetry` inspection
             // still shows what was last stored — the canonical store now
             // lives Python-side.
-            val key = runtime.localIdentity
-                ?.get("hash")
-                ?.toJava(ByteArray::class.java)
-                ?.toHex()
-                ?: "local"
-            ownTelemetry[key] = locationJson
-            Log.d(TAG, "stored own telemetry for $key (${packedBytes.size} packed bytes)")
+            ownTelemetry[ownTelemetryKey()] = locationJson
         }
 
+    override suspend fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ): Result<Unit> = pyResult { storeOwnPacked(packedTelemetry, timestampSeconds, iconAppearance) }
+
+    /**
+     * Hand Telemeter bytes to `event_bridge.store_own_telemetry` so they
+     * land in the same `_collected_telemetry` dict the FIELD_COMMANDS
+     * responder serves. Keyed in event_bridge by the local delivery
+     * destination hash — no need to pass the key from here.
+     */
+    private fun storeOwnPacked(
+        packedBytes: ByteArray,
+        tsSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ) {
+        val appearancePy =
+            iconAppearance?.let { it.toPyField() }
+                ?: runtime.python.getBuiltins().get("None")
+        runtime.eventBridge.callAttr(
+            "store_own_telemetry",
+            packedBytes.toPyBytes(),
+            tsSeconds,
+            appearancePy,
+        )
+        Log.d(TAG, "stored own telemetry for ${ownTelemetryKey()} (${packedBytes.size} packed bytes)")
+    }
+
+    private fun ownTelemetryKey(): String =
+        runtime.localIdentity
+            ?.get("hash")
+            ?.toJava(ByteArray::class.java)
+            ?.toHex()
+            ?: "local"
+
     override suspend fun setTelemetryAllowedRequesters(allowedHashes: Set<String>): Result<Unit> =
         pyResult {
             // Push allow-set into event_bridge so the responder's
@@ -2,6 +2,7 @@ package network.columba.app.rns.backend.py
 
 import android.util.Log
 import com.chaquo.python.PyObject
+import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.asSharedFlow
@@ -10,6 +11,9 @@ import network.columba.app.rns.api.model.BatteryProfile
 import network.columba.app.rns.api.model.DiscoveredInterface
 import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
+import network.columba.app.rns.api.util.InterfaceCounters
+import network.columba.app.rns.api.util.interfaceStatsSnapshots
 import org.json.JSONArray
 import org.json.JSONObject
 
@@ -52,6 +56,9 @@ class PythonRnsTransportAdmin(
 
         /** Empty JSON array — the contract's documented "no BLE peers" value. */
         const val EMPTY_JSON_ARRAY = "[]"
+
+        /** Sampling cadence for `observeInterfaceStats` (ms). */
+        const val INTERFACE_STATS_INTERVAL_MS = 1_000L
     }
 
     // These four flows are mostly idle in this structural cut: upstream RNS has
@@ -300,13 +307,7 @@ class PythonRnsTransportAdmin(
 
     override suspend fun getInterfaceStats(interfaceName: String): Map<String, Any>? =
         pyCall {
-            // Best-effort: RNS.Reticulum.get_interface_stats() returns a dict
-            // with an `interfaces` list; find the entry whose name matches.
-            val instance = runtime.reticulumInstance ?: return@pyCall null
-            val stats = instance.callAttr("get_interface_stats") ?: return@pyCall null
-            val ifaceList = stats.callAttr("get", "interfaces") ?: return@pyCall null
-            val match = runtime.python.builtins.callAttr("list", ifaceList).asList()
-                .firstOrNull { it.dictStr("name") == interfaceName }
+            val match = interfaceStatEntries().firstOrNull { it.dictStr("name") == interfaceName }
                 ?: return@pyCall null
             mapOf(
                 "online" to match.dictBool("status"),
@@ -315,6 +316,26 @@ class PythonRnsTransportAdmin(
             )
         }
 
+    // One get_interface_stats() call per sample covers every interface;
+    // rates and history are worked out on the Kotlin side.
+    override fun observeInterfaceStats(): Flow<List<InterfaceStatsSnapshot>> =
+        interfaceStatsSnapshots(INTERFACE_STATS_INTERVAL_MS) {
+            pyCall {
+                interfaceStatEntries().mapNotNull { entry ->
+                    val name = entry.dictStr("name") ?: return@mapNotNull null
+                    InterfaceCounters(
+                        name = name,
+                        online = entry.dictBool("status"),
+                        rxBytes = entry.dictLong("rxb") ?: 0L,
+                        txBytes = entry.dictLong("txb") ?: 0L,
+                        // Only RNodeInterface reports these (r_stat_rssi / r_stat_snr)
+                        rssi = entry.dictInt("rssi"),
+                        snr = runCatching { entry.dictDouble("snr")?.toFloat() }.getOrNull(),
+                    )
+                }
+            }
+        }
+
     // ==================== RNode ====================
 
     override suspend fun reconnectRNodeInterface() {
@@ -339,6 +360,18 @@ class PythonRnsTransportAdmin(
 
     // ==================== Internal helpers ====================
 
+    /**
+     * Best-effort: RNS.Reticulum.get_interface_stats() returns a dict with an
+     * `interfaces` list of per-interface dicts. Empty before start-up.
+     * Call inside [pyCall].
+     */
+    private fun interfaceStatEntries(): List<PyObject> {
+        val instance = runtime.reticulumInstance ?: return emptyList()
+        val stats = instance.callAttr("get_interface_stats") ?: return emptyList()
+        val ifaceList = stats.callAttr("get", "interfaces") ?: return emptyList()
+        return runtime.python.builtins.callAttr("list", ifaceList).asList()
+    }
+
     /** `RNS.Transport` — used statically by upstream RNS. */
     private fun transport(): PyObject =
         runtime.rnsModule["Transport"] ?: error("RNS.Transport not resolvable")
@@ -77,6 +77,10 @@ class KISS:
 
     # Framebuffer constants
     FB_BYTES_PER_LINE = 8  # 64 pixels / 8 bits per byte
+    FB_LINES = 64
+
+    # CMD_RESET payload the firmware sends when it has just booted
+    RESET_BOOTED = 0xF8
 
     # Detection
     DETECT_REQ = 0x73
@@ -158,6 +162,20 @@ class KISS:
         return bytes(result)
 
 
+# Last framebuffer sent to each RNode over its current connection, keyed by
+# interface name, so a repeated upload only re-sends the lines that changed.
+# Forgotten when a connection opens or goes offline (stop() included) and
+# when the device reports a reboot: what the panel shows is only known for
+# the link it was written over.
+_sent_framebuffers = {}
+_sent_framebuffers_lock = threading.Lock()
+
+
+def _forget_framebuffer(name):
+    with _sent_framebuffers_lock:
+        _sent_framebuffers.pop(name, None)
+
+
 class ColumbaRNodeInterface(Interface):
     """
     Columba-authored RNS.Interface speaking KISS to RNode LoRa hardware
@@ -180,6 +198,11 @@ class ColumbaRNodeInterface(Interface):
     DETECT_TIMEOUT = 5.0
     CONFIG_DELAY = 0.15
 
+    # Largest single write when uploading the framebuffer. The bridges split
+    # it into link-sized packets and BLE waits for each write callback, so
+    # pacing comes from the link rather than from sleeps.
+    FB_MAX_WRITE = 512
+
     # Connection modes (string values mirror what RnsConfigFile.kt emits)
     MODE_CLASSIC = "classic"  # Bluetooth Classic (SPP/RFCOMM)
     MODE_BLE = "ble"          # Bluetooth Low Energy (GATT)
@@ -465,6 +488,9 @@ class ColumbaRNodeInterface(Interface):
 
     def start(self):
         """Start the interface - connect to RNode and configure radio."""
+        # A new connection starts from a full framebuffer upload
+        _forget_framebuffer(self.name)
+
         # Handle USB mode separately
         if self.connection_mode == self.MODE_USB:
             return self._start_usb()
@@ -942,48 +968,81 @@ class ColumbaRNodeInterface(Interface):
             line: Line number (0-63)
             line_data: 8 bytes of pixel data (64 pixels, 1 bit per pixel)
         """
-        if line < 0 or line > 63:
+        self._write(self._framebuffer_line_frame(line, line_data))
+
+    @staticmethod
+    def _framebuffer_line_frame(line, line_data):
+        if line < 0 or line >= KISS.FB_LINES:
             raise ValueError(f"Line must be 0-63, got {line}")
         if len(line_data) != KISS.FB_BYTES_PER_LINE:
             raise ValueError(f"Line data must be {KISS.FB_BYTES_PER_LINE} bytes")
 
-        data = bytes([line]) + line_data
-        escaped = KISS.escape(data)
-        kiss_command = bytes([KISS.FEND, KISS.CMD_FB_WRITE]) + escaped + bytes([KISS.FEND])
-        self._write(kiss_command)
+        escaped = KISS.escape(bytes([line]) + bytes(line_data))
+        return bytes([KISS.FEND, KISS.CMD_FB_WRITE]) + escaped + bytes([KISS.FEND])
 
-    def display_image(self, imagedata):
+    def display_image(self, imagedata, enable=False):
         """Send a 64x64 monochrome image to RNode display.
 
+        Only lines that differ from the last image sent to this RNode are
+        written. The line frames (and the enable command, if requested) are
+        coalesced into a few large writes instead of 64 paced ones.
+
         Args:
             imagedata: List or bytes of 512 bytes (64 lines x 8 bytes per line)
+            enable: Also switch the display to the external framebuffer
+
+        Returns:
+            Number of lines written.
         """
-        if len(imagedata) != 512:
+        if len(imagedata) != KISS.FB_LINES * KISS.FB_BYTES_PER_LINE:
             raise ValueError(f"Image data must be 512 bytes, got {len(imagedata)}")
+        image = bytes(imagedata)
 
-        for line in range(64):
-            line_start = line * KISS.FB_BYTES_PER_LINE
-            line_end = line_start + KISS.FB_BYTES_PER_LINE
-            line_data = bytes(imagedata[line_start:line_end])
-            self.write_framebuffer(line, line_data)
-            # Small delay to prevent BLE write throttling
-            time.sleep(0.015)
+        with _sent_framebuffers_lock:
+            previous = _sent_framebuffers.get(self.name)
 
-        RNS.log(f"{self} Sent 64x64 image to RNode framebuffer", RNS.LOG_DEBUG)
+        frames = []
+        for line in range(KISS.FB_LINES):
+            line_start = line * KISS.FB_BYTES_PER_LINE
+            line_data = image[line_start:line_start + KISS.FB_BYTES_PER_LINE]
+            if previous is not None and previous[line_start:line_start + KISS.FB_BYTES_PER_LINE] == line_data:
+                continue
+            frames.append(self._framebuffer_line_frame(line, line_data))
+        changed = len(frames)
+        if enable:
+            frames.append(bytes([KISS.FEND, KISS.CMD_FB_EXT, 0x01, KISS.FEND]))
+
+        # Frames stay whole within a write so a failed write never leaves
+        # half a command on the wire
+        batch = b""
+        for frame in frames:
+            if batch and len(batch) + len(frame) > self.FB_MAX_WRITE:
+                self._write(batch)
+                batch = b""
+            batch += frame
+        if batch:
+            self._write(batch)
+
+        with _sent_framebuffers_lock:
+            _sent_framebuffers[self.name] = image
+        if enable:
+            self.framebuffer_enabled = True
+
+        RNS.log(f"{self} Sent {changed}/{KISS.FB_LINES} framebuffer lines to RNode", RNS.LOG_DEBUG)
+        return changed
 
     def _display_logo(self):
         """Display or disable the Columba logo on RNode based on settings."""
         if self.enable_framebuffer:
             try:
                 from columba_logo import columba_fb_data
-                self.display_image(columba_fb_data)
-                # Delay before enable command to ensure framebuffer data is processed
-                time.sleep(0.05)
-                self.enable_external_framebuffer()
+                # The enable command rides in the same batch, after the lines
+                self.display_image(columba_fb_data, enable=True)
                 RNS.log(f"{self} Displayed Columba logo on RNode", RNS.LOG_DEBUG)
             except ImportError:
                 RNS.log(f"{self} columba_logo module not found, skipping logo display", RNS.LOG_WARNING)
             except Exception as e:  # noqa: BLE001
+                _forget_framebuffer(self.name)
                 RNS.log(f"{self} Failed to display logo: {e}", RNS.LOG_WARNING)
         else:
             # Explicitly disable external framebuffer to restore normal RNode UI
@@ -1110,6 +1169,10 @@ class ColumbaRNodeInterface(Interface):
                                     RNS.log(f"Error callback failed: {cb_err}", RNS.LOG_ERROR)
                         elif command == KISS.CMD_READY:
                             pass  # Device ready
+                        elif command == KISS.CMD_RESET:
+                            if byte == KISS.RESET_BOOTED:
+                                # Rebooted: its framebuffer no longer matches what we sent
+                                _forget_framebuffer(self.name)
 
             except Exception as e:  # noqa: BLE001
                 if self._running.is_set():
@@ -1255,6 +1318,10 @@ class ColumbaRNodeInterface(Interface):
                                     RNS.log(f"Error callback failed: {cb_err}", RNS.LOG_ERROR)
                         elif command == KISS.CMD_READY:
                             pass  # Device ready
+                        elif command == KISS.CMD_RESET:
+                            if byte == KISS.RESET_BOOTED:
+                                # Rebooted: its framebuffer no longer matches what we sent
+                                _forget_framebuffer(self.name)
 
             except Exception as e:  # noqa: BLE001
                 if self._running.is_set():
@@ -1337,6 +1404,9 @@ class ColumbaRNodeInterface(Interface):
         with self._read_lock:
             old_status = self.online
             self.online = is_online
+        if not is_online:
+            # The link is gone; whatever the panel shows is no longer known
+            _forget_framebuffer(self.name)
         if old_status != is_online:
             # Existing in-Python observer chain (callbacks registered by other
             # python-side code that wants the live online state).
@@ -699,6 +699,64 @@ def set_incoming_message_size_limit(limit_kb):
     )
 
 
+DESTINATION_HASH_BYTES = 16
+PATH_TABLE_RECORD_SIZE = DESTINATION_HASH_BYTES + 1
+
+
+def path_table_snapshot():
+    """Return the path table as packed bytes for `PythonRnsCore.observePathTable`.
+
+    One 17-byte record per path: the 16-byte destination hash followed by
+    hops clamped to 255. A single bytes object crosses Chaquopy in one call;
+    returning a dict of 20k entries would box every key and value.
+    """
+    table = getattr(RNS.Transport, "path_table", None) or {}
+    hops_index = getattr(RNS.Transport, "IDX_PT_HOPS", 2)
+    out = bytearray()
+    # Copy first: the transport thread mutates the table while we walk it
+    for destination_hash, entry in list(table.items()):
+        if len(destination_hash) != DESTINATION_HASH_BYTES:
+            continue
+        try:
+            hops = int(entry[hops_index])
+        except (IndexError, TypeError, ValueError):
+            continue
+        out += destination_hash
+        out.append(min(max(hops, 0), 255))
+    return bytes(out)
+
+
+PATH_INFO_NO_PATH = 0xFF
+
+
+def path_info(packed_hashes):
+    """Answer has-path + hops for many destinations in one call.
+
+    `packed_hashes` is the concatenation of 16-byte destination hashes.
+    Returns one byte per hash, in order: hops clamped to 254, or
+    PATH_INFO_NO_PATH when there is no path. Uses the same
+    `has_path` / `hops_to` the per-destination calls did, but the loop runs
+    here, so the Kotlin side pays one crossing for the whole batch (see
+    `PythonRnsCore.pathInfo`).
+    """
+    transport = RNS.Transport
+    size = DESTINATION_HASH_BYTES
+    data = bytes(packed_hashes)
+    out = bytearray()
+    for offset in range(0, len(data) - size + 1, size):
+        destination_hash = data[offset:offset + size]
+        try:
+            if not transport.has_path(destination_hash):
+                out.append(PATH_INFO_NO_PATH)
+                continue
+            hops = int(transport.hops_to(destination_hash))
+        except Exception:  # noqa: BLE001 — one bad entry must not fail the batch
+            out.append(PATH_INFO_NO_PATH)
+            continue
+        out.append(min(max(hops, 0), PATH_INFO_NO_PATH - 1))
+    return bytes(out)
+
+
 def _signal_metrics(interface_obj):
     """Extract (rssi, snr) from a receiving `RNS.Interface` at delivery time.
 
@@ -0,0 +1,169 @@
+package network.columba.app.rns.backend.py
+
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withContext
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import java.util.concurrent.CopyOnWriteArrayList
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.locks.ReentrantLock
+import kotlin.concurrent.withLock
+
+/**
+ * Unit tests for [CoalescingBatcher] and [PythonExecutor], no Python runtime
+ * required. The microbenchmark stands in for Chaquopy with a fair lock (the
+ * GIL) and a fixed busy-wait per crossing.
+ */
+class CoalescingBatcherTest {
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+
+    @After
+    fun tearDown() {
+        scope.cancel()
+    }
+
+    /** Blocks like a JNI crossing would, so callers pile up behind it. */
+    private fun slowLookup(
+        batches: MutableList<List<String>>,
+        costMs: Long = 20L,
+    ): suspend (List<String>) -> List<Int?> =
+        { keys ->
+            batches.add(keys)
+            Thread.sleep(costMs)
+            keys.map { it.length }
+        }
+
+    // ========== Coalescing Tests ==========
+
+    @Test
+    fun `identical concurrent keys share one lookup`() =
+        runBlocking {
+            val batches = CopyOnWriteArrayList<List<String>>()
+            val batcher = CoalescingBatcher(scope, lookup = slowLookup(batches))
+
+            val results =
+                (1..50).map { async(Dispatchers.Default) { batcher.get("abcd") } }.awaitAll()
+
+            assertTrue(results.all { it == 4 })
+            assertTrue("expected ≤ 3 lookups, got ${batches.size}", batches.size <= 3)
+            assertTrue(batches.all { it == listOf("abcd") })
+        }
+
+    @Test
+    fun `callers arriving during a lookup are answered by the next batch`() =
+        runBlocking {
+            val batches = CopyOnWriteArrayList<List<String>>()
+            val batcher = CoalescingBatcher(scope, lookup = slowLookup(batches))
+            val keys = (0 until 200).map { "k".repeat(1 + it % 40) }
+
+            val results = keys.map { key -> async(Dispatchers.Default) { batcher.get(key) } }.awaitAll()
+
+            assertEquals(keys.map { it.length }, results)
+            println("200 lookups over 40 keys answered in ${batches.size} batches")
+            assertTrue("expected few batches, got ${batches.size}", batches.size < 20)
+        }
+
+    @Test
+    fun `batches are capped at maxBatchSize`() =
+        runBlocking {
+            val batches = CopyOnWriteArrayList<List<String>>()
+            val batcher = CoalescingBatcher(scope, maxBatchSize = 8, lookup = slowLookup(batches, costMs = 5L))
+
+            (0 until 100).map { i -> async(Dispatchers.Default) { batcher.get("key$i") } }.awaitAll()
+
+            assertTrue(batches.all { it.size <= 8 })
+            assertEquals(100, batches.sumOf { it.size })
+        }
+
+    @Test
+    fun `failed lookup fails its batch and the next call retries`() =
+        runBlocking {
+            val calls = AtomicInteger(0)
+            val batcher =
+                CoalescingBatcher<String, Int?>(scope) { keys ->
+                    if (calls.getAndIncrement() == 0) error("python not ready")
+                    keys.map { it.length }
+                }
+
+            val first = runCatching { batcher.get("abc") }
+
+            assertTrue(first.isFailure)
+            assertEquals(3, batcher.get("abc"))
+        }
+
+    // ========== Microbenchmark ==========
+
+    /** A fake interpreter: every crossing takes the GIL and spins for [crossingCostNanos]. */
+    private class FakeInterpreter(
+        private val crossingCostNanos: Long,
+    ) {
+        private val gil = ReentrantLock(true)
+        val crossings = AtomicInteger(0)
+
+        fun <T> cross(block: () -> T): T =
+            gil.withLock {
+                crossings.incrementAndGet()
+                val until = System.nanoTime() + crossingCostNanos
+                while (System.nanoTime() < until) Thread.onSpinWait()
+                block()
+            }
+    }
+
+    @Test
+    fun `microbenchmark batched path lookups against per-destination crossings`() =
+        runBlocking {
+            val callers = 64
+            val rounds = 20
+            val crossingCostNanos = 20_000L
+            val hashes = (0 until callers).map { "%032x".format(it) }
+
+            // Before: each caller on Dispatchers.IO does has_path + hops_to + next_hop_interface
+            val perCall = FakeInterpreter(crossingCostNanos)
+            val perCallStart = System.nanoTime()
+            repeat(rounds) {
+                hashes
+                    .map { hash ->
+                        async(Dispatchers.IO) {
+                            perCall.cross { true }
+                            perCall.cross { hash.length }
+                            perCall.cross { "iface" }
+                        }
+                    }.awaitAll()
+            }
+            val perCallMs = (System.nanoTime() - perCallStart) / 1_000_000
+
+            // After: callers share path_info batches on the Python executor
+            val batched = FakeInterpreter(crossingCostNanos)
+            val batcher =
+                CoalescingBatcher<String, Int?>(PythonExecutor.newScope()) { keys ->
+                    batched.cross { keys.map { it.length } }
+                }
+            val batchedStart = System.nanoTime()
+            repeat(rounds) {
+                hashes
+                    .map { hash ->
+                        async(Dispatchers.Default) {
+                            withContext(PythonExecutor.dispatcher) { batcher.get(hash) }
+                        }
+                    }.awaitAll()
+            }
+            val batchedMs = (System.nanoTime() - batchedStart) / 1_000_000
+
+            println(
+                "Per-destination: ${perCall.crossings.get()} crossings in ${perCallMs}ms; " +
+                    "batched: ${batched.crossings.get()} crossings in ${batchedMs}ms " +
+                    "(${crossingCostNanos / 1_000}µs per crossing, $callers callers × $rounds rounds)",
+            )
+            assertEquals(callers * rounds * 3, perCall.crossings.get())
+            // Never more than one crossing per lookup, against three before
+            assertTrue(batched.crossings.get() <= callers * rounds)
+        }
+}
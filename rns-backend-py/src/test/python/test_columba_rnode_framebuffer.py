@@ -0,0 +1,199 @@
+import importlib.util
+import sys
+import threading
+import types
+import unittest
+from pathlib import Path
+
+
+INTERFACE_PATH = (
+    Path(__file__).resolve().parents[2]
+    / "main/python/columba_rnode_interface.py"
+)
+
+FEND = 0xC0
+FESC = 0xDB
+TFEND = 0xDC
+TFESC = 0xDD
+CMD_FB_EXT = 0x41
+CMD_FB_WRITE = 0x43
+
+class Interface:
+    pass
+
+
+class FakeSerialBridge:
+    """Records every write, standing in for the Kotlin serial bridge."""
+
+    def __init__(self):
+        self.writes = []
+
+    def writeSync(self, data):
+        self.writes.append(bytes(data))
+        return len(data)
+
+    def notifyOnlineStatusChanged(self, is_online, name):
+        pass
+
+
+def parse_frames(stream):
+    """Split a KISS byte stream into (command, unescaped payload) tuples."""
+    frames = []
+    in_frame = False
+    escape = False
+    command = None
+    payload = bytearray()
+    for byte in stream:
+        if byte == FEND:
+            if in_frame and command is not None:
+                frames.append((command, bytes(payload)))
+            in_frame = True
+            command = None
+            payload = bytearray()
+        elif in_frame:
+            if escape:
+                payload.append(FEND if byte == TFEND else FESC)
+                escape = False
+            elif byte == FESC:
+                escape = True
+            elif command is None:
+                command = byte
+            else:
+                payload.append(byte)
+    return frames
+
+
+def test_image(seed):
+    # Includes 0xC0/0xDB bytes so escaping is exercised
+    return bytes(((i * 37) + seed) & 0xFF for i in range(512))
+
+
+class ColumbaRNodeFramebufferTests(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        rns = types.ModuleType("RNS")
+        for name, level in (("LOG_DEBUG", 7), ("LOG_VERBOSE", 5), ("LOG_INFO", 6), ("LOG_WARNING", 4), ("LOG_ERROR", 3)):
+            setattr(rns, name, level)
+        setattr(rns, "log", lambda *args, **kwargs: None)
+        interfaces = types.ModuleType("RNS.Interfaces")
+        interface_module = types.ModuleType("RNS.Interfaces.Interface")
+        setattr(interface_module, "Interface", Interface)
+        sys.modules["RNS"] = rns
+        sys.modules["RNS.Interfaces"] = interfaces
+        sys.modules["RNS.Interfaces.Interface"] = interface_module
+
+        spec = importlib.util.spec_from_file_location(
+            "columba_rnode_framebuffer_test", INTERFACE_PATH
+        )
+        assert spec is not None and spec.loader is not None
+        module = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(module)
+        cls.module = module
+
+    def setUp(self):
+        self.module._sent_framebuffers.clear()
+
+    def new_interface(self, name="RNode A"):
+        iface = self.module.ColumbaRNodeInterface.__new__(self.module.ColumbaRNodeInterface)
+        iface.name = name
+        iface.connection_mode = iface.MODE_BLE
+        iface.kotlin_bridge = FakeSerialBridge()
+        iface.framebuffer_enabled = False
+        iface.online = True
+        iface._read_lock = threading.Lock()
+        iface._on_online_status_changed = None
+        return iface
+
+    def written_frames(self, iface):
+        return parse_frames(b"".join(iface.kotlin_bridge.writes))
+
+    def test_first_upload_sends_every_line_then_enable_in_few_writes(self):
+        iface = self.new_interface()
+        image = test_image(seed=1)
+
+        sent = iface.display_image(image, enable=True)
+
+        self.assertEqual(64, sent)
+        frames = self.written_frames(iface)
+        self.assertEqual(65, len(frames))
+        for line, (command, payload) in enumerate(frames[:64]):
+            self.assertEqual(CMD_FB_WRITE, command)
+            self.assertEqual(bytes([line]) + image[line * 8:(line + 1) * 8], payload)
+        # Enable comes last, in the same upload, with no settle sleep before it
+        self.assertEqual((CMD_FB_EXT, b"\x01"), frames[64])
+        self.assertTrue(iface.framebuffer_enabled)
+
+        # Coalesced into MTU-sized writes, each holding only whole frames,
+        # instead of the old 65 paced writes
+        self.assertLessEqual(len(iface.kotlin_bridge.writes), 3)
+        for data in iface.kotlin_bridge.writes:
+            self.assertLessEqual(len(data), iface.FB_MAX_WRITE)
+            self.assertEqual(FEND, data[0])
+            self.assertEqual(FEND, data[-1])
+
+    def test_repeat_upload_sends_only_changed_lines(self):
+        iface = self.new_interface()
+        image = test_image(seed=1)
+        iface.display_image(image)
+        iface.kotlin_bridge = FakeSerialBridge()
+
+        changed = bytearray(image)
+        changed[5 * 8] ^= 0xFF
+        changed[40 * 8 + 3] ^= 0x01
+        sent = iface.display_image(bytes(changed), enable=True)
+
+        self.assertEqual(2, sent)
+        frames = self.written_frames(iface)
+        self.assertEqual([5, 40], [payload[0] for command, payload in frames if command == CMD_FB_WRITE])
+        self.assertEqual((CMD_FB_EXT, b"\x01"), frames[-1])
+        self.assertEqual(1, len(iface.kotlin_bridge.writes))
+
+    def test_unchanged_image_sends_only_the_enable_command(self):
+        iface = self.new_interface()
+        image = test_image(seed=3)
+        iface.display_image(image, enable=True)
+        iface.kotlin_bridge = FakeSerialBridge()
+
+        self.assertEqual(0, iface.display_image(image, enable=True))
+        self.assertEqual([(CMD_FB_EXT, b"\x01")], self.written_frames(iface))
+
+    def test_cache_is_per_device(self):
+        first = self.new_interface("RNode A")
+        second = self.new_interface("RNode B")
+        image = test_image(seed=2)
+
+        first.display_image(image)
+
+        self.assertEqual(64, second.display_image(image))
+
+    def test_forgotten_framebuffer_is_resent_in_full(self):
+        iface = self.new_interface()
+        image = test_image(seed=4)
+        iface.display_image(image)
+
+        # What a device reboot report does
+        self.module._forget_framebuffer(iface.name)
+
+        self.assertEqual(64, iface.display_image(image))
+
+    def test_going_offline_forgets_the_framebuffer(self):
+        iface = self.new_interface()
+        image = test_image(seed=5)
+        iface.display_image(image)
+
+        # Disconnect, USB detach and stop() all take the interface offline
+        iface._set_online(False)
+        iface._set_online(True)
+
+        self.assertEqual(64, iface.display_image(image))
+
+    def test_rejects_wrong_image_size(self):
+        iface = self.new_interface()
+
+        with self.assertRaises(ValueError):
+            iface.display_image(b"\x00" * 511)
+        self.assertEqual([], iface.kotlin_bridge.writes)
+
+
+if __name__ == "__main__":
+    unittest.main()
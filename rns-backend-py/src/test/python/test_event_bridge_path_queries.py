@@ -0,0 +1,77 @@
+import importlib.util
+import sys
+import types
+import unittest
+from pathlib import Path
+
+
+BRIDGE_PATH = Path(__file__).resolve().parents[2] / "main/python/event_bridge.py"
+
+
+class FakeTransport:
+    """Just enough of RNS.Transport for the path queries."""
+
+    IDX_PT_HOPS = 2
+    path_table = {}
+
+    @classmethod
+    def has_path(cls, destination_hash):
+        return destination_hash in cls.path_table
+
+    @classmethod
+    def hops_to(cls, destination_hash):
+        return cls.path_table[destination_hash][cls.IDX_PT_HOPS]
+
+
+def dest(index):
+    return index.to_bytes(16, "big")
+
+
+class EventBridgePathQueryTests(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        rns = types.ModuleType("RNS")
+        for name, level in (("LOG_DEBUG", 7), ("LOG_VERBOSE", 5), ("LOG_INFO", 6), ("LOG_WARNING", 4), ("LOG_ERROR", 3)):
+            setattr(rns, name, level)
+        setattr(rns, "log", lambda *args, **kwargs: None)
+        setattr(rns, "Transport", FakeTransport)
+        sys.modules["RNS"] = rns
+        sys.modules.setdefault("LXMF", types.ModuleType("LXMF"))
+
+        spec = importlib.util.spec_from_file_location("event_bridge_path_test", BRIDGE_PATH)
+        assert spec is not None and spec.loader is not None
+        module = importlib.util.module_from_spec(spec)
+        spec.loader.exec_module(module)
+        cls.module = module
+
+    def setUp(self):
+        FakeTransport.path_table = {
+            dest(1): (None, None, 1),
+            dest(2): (None, None, 3),
+            dest(3): (None, None, 900),
+        }
+
+    def test_path_info_returns_one_byte_per_hash_in_order(self):
+        packed = dest(2) + dest(9) + dest(1) + dest(3)
+
+        result = self.module.path_info(packed)
+
+        self.assertEqual(bytes([3, self.module.PATH_INFO_NO_PATH, 1, 254]), result)
+
+    def test_path_info_ignores_trailing_partial_hash(self):
+        self.assertEqual(bytes([1]), self.module.path_info(dest(1) + b"\x00\x01"))
+
+    def test_path_info_marks_failing_lookups_as_no_path(self):
+        FakeTransport.path_table[dest(4)] = ()
+
+        self.assertEqual(bytes([self.module.PATH_INFO_NO_PATH]), self.module.path_info(dest(4)))
+
+    def test_path_table_snapshot_packs_hash_and_hops(self):
+        snapshot = self.module.path_table_snapshot()
+
+        records = {snapshot[i:i + 16]: snapshot[i + 16] for i in range(0, len(snapshot), 17)}
+        self.assertEqual({dest(1): 1, dest(2): 3, dest(3): 255}, records)
+
+
+if __name__ == "__main__":
+    unittest.main()
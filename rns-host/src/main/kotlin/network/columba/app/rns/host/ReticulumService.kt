@@ -15,9 +15,11 @@ import kotlinx.coroutines.cancel
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withTimeout
 import network.columba.app.rns.api.RnsBackend
+import network.columba.app.rns.api.util.InterfaceRetrySignal
 import network.columba.app.rns.host.binder.ReticulumServiceBinder
 import network.columba.app.rns.host.di.ServiceModule
 import network.columba.app.rns.host.persistence.BackendInitializer
+import network.columba.app.rns.host.persistence.InboundMessageHandoff
 import network.columba.app.rns.host.rnode.KotlinRNodeBridge
 import network.columba.app.rns.host.rnode.RNodeOnlineStatusListener
 import network.columba.app.rns.host.usb.KotlinUSBBridge
@@ -90,6 +92,10 @@ class ReticulumService : Service() {
     // the rare case the service runs only via startService (no bindService caller).
     private var aidlServer: RnsBackendServer? = null
 
+    // Persists every inbound message before the UI sees it; the AIDL server
+    // serves its enriched stream instead of the backend's raw one.
+    private lateinit var inboundHandoff: InboundMessageHandoff
+
     // Process-start timestamp used to detect stale ACTION_STOP redeliveries during
     // an Apply & Restart cycle. See onStartCommand's ACTION_STOP branch for the
     // full rationale. SystemClock.elapsedRealtime is monotonic and includes
@@ -125,6 +131,8 @@ class ReticulumService : Service() {
                     // callback thread. Blocking that thread can cause Android's watchdog to kill
                     // the service, leading to "Service not bound" errors.
                     Log.d(TAG, "Network changed - restarting AutoInterface and triggering LXMF announce")
+                    // Interfaces waiting out a recovery backoff retry now rather than later
+                    InterfaceRetrySignal.trigger("network changed")
                     // Guard: binder property must be initialized AND Reticulum must be ready
                     // This prevents announces during service initialization, which can cause
                     // DataStore race conditions and service crashes
@@ -253,6 +261,15 @@ class ReticulumService : Service() {
         // Clean up stale announces (>30 days old) on each service lifecycle
         managers.persistenceManager.cleanupStaleAnnounces()
 
+        // Start collecting inbound messages now, not on first bind, so messages
+        // arriving while the UI process is dead are still written.
+        inboundHandoff =
+            InboundMessageHandoff(
+                lxmf = rnsBackend.lxmf,
+                persistenceManager = managers.persistenceManager,
+                scope = serviceScope,
+            ).also { it.start() }
+
         // Create binder returned from onBind(). No cross-process protocol calls flow
         // through here anymore — it's just a liveness handle for bindService consumers.
         binder =
@@ -430,7 +447,7 @@ class ReticulumService : Service() {
         // BleCoordinator) call its `restartAutoInterface` / `announceLxmfDestination`
         // helpers via direct Java calls — A.10 rewires those to use `rnsBackend`.
         return aidlServer ?: RnsBackendServer(
-            impl = rnsBackend,
+            impl = inboundHandoff.wrap(rnsBackend),
             scope = serviceScope,
             // Shared app cache (same UID as the UI process) for staging
             // out-of-band inbound fields blobs; see FieldsBlob / IRnsMessageCallback.
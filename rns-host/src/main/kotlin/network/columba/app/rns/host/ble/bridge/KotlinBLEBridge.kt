@@ -2,6 +2,7 @@ package network.columba.app.rns.host.ble.bridge
 
 import com.chaquo.python.PyObject
 import network.columba.app.rns.api.annotation.ReflectivelyKept
+import network.columba.app.rns.api.util.RingLog
 import network.columba.app.rns.api.util.toHex
 import android.annotation.SuppressLint
 import android.bluetooth.BluetoothAdapter
@@ -10,7 +11,6 @@ import android.content.BroadcastReceiver
 import android.content.Context
 import android.content.Intent
 import android.content.IntentFilter
-import android.util.Log
 import network.columba.app.rns.host.ble.client.BleGattClient
 import network.columba.app.rns.host.ble.client.BleScanner
 import network.columba.app.rns.host.ble.model.BleConstants
@@ -147,7 +147,7 @@ class KotlinBLEBridge(
                             BluetoothAdapter.STATE_OFF,
                         )
 
-                    Log.i(TAG, "Bluetooth adapter state changed: ${stateToString(previousState)} -> ${stateToString(state)}")
+                    RingLog.i(TAG) { "Bluetooth adapter state changed: ${stateToString(previousState)} -> ${stateToString(state)}" }
                     _adapterState.value = state
 
                     scope.launch {
@@ -174,10 +174,10 @@ class KotlinBLEBridge(
             val filter = IntentFilter(BluetoothAdapter.ACTION_STATE_CHANGED)
             context.registerReceiver(bluetoothStateReceiver, filter)
             isReceiverRegistered = true
-            Log.i(TAG, "Bluetooth adapter state receiver registered - monitoring ${BluetoothAdapter.ACTION_STATE_CHANGED}")
-            Log.d(TAG, "Current BT state at registration: ${stateToString(_adapterState.value)}")
+            RingLog.i(TAG) { "Bluetooth adapter state receiver registered - monitoring ${BluetoothAdapter.ACTION_STATE_CHANGED}" }
+            RingLog.d(TAG) { "Current BT state at registration: ${stateToString(_adapterState.value)}" }
         } catch (e: Exception) {
-            Log.e(TAG, "Failed to register Bluetooth state receiver in init", e)
+            RingLog.e(TAG, e) { "Failed to register Bluetooth state receiver in init" }
         }
     }
 
@@ -271,7 +271,7 @@ class KotlinBLEBridge(
     override fun addBleConnectionsListener(listener: network.columba.app.rns.api.BleConnectionsListener) {
         synchronized(listenerLock) {
             connectionChangeListeners.add(listener)
-            Log.d(TAG, "BLE connections listener added (total: ${connectionChangeListeners.size})")
+            RingLog.d(TAG) { "BLE connections listener added (total: ${connectionChangeListeners.size})" }
         }
     }
 
@@ -281,7 +281,7 @@ class KotlinBLEBridge(
     override fun removeBleConnectionsListener(listener: network.columba.app.rns.api.BleConnectionsListener) {
         synchronized(listenerLock) {
             connectionChangeListeners.remove(listener)
-            Log.d(TAG, "BLE connections listener removed (total: ${connectionChangeListeners.size})")
+            RingLog.d(TAG) { "BLE connections listener removed (total: ${connectionChangeListeners.size})" }
         }
     }
 
@@ -296,7 +296,7 @@ class KotlinBLEBridge(
                 try {
                     listener.onBleConnectionsChanged(json)
                 } catch (e: Exception) {
-                    Log.e(TAG, "Error notifying connection change listener", e)
+                    RingLog.e(TAG, e) { "Error notifying connection change listener" }
                 }
             }
         }
@@ -399,7 +399,7 @@ class KotlinBLEBridge(
         val role = if (isCentral && !isPeripheral) "central" else "peripheral"
         runCatching {
             onConnected?.callAttr("__call__", address, mtu, role, identityHash)
-        }.onFailure { Log.w(TAG, "Python onConnected callback threw for $address: ${it.message}") }
+        }.onFailure { RingLog.w(TAG) { "Python onConnected callback threw for $address: ${it.message}" } }
     }
 
     /**
@@ -421,12 +421,12 @@ class KotlinBLEBridge(
             }
         }
         if (peersToSync.isEmpty()) {
-            Log.d(TAG, "No existing connections with identity to sync to Python")
+            RingLog.d(TAG) { "No existing connections with identity to sync to Python" }
             return
         }
-        Log.i(TAG, "Syncing ${peersToSync.size} existing connections to Python")
+        RingLog.i(TAG) { "Syncing ${peersToSync.size} existing connections to Python" }
         peersToSync.forEach { (address, peer, identityHash) ->
-            Log.d(TAG, "Syncing connection: $address with identity ${identityHash.take(16)}...")
+            RingLog.d(TAG) { "Syncing connection: $address with identity ${identityHash.take(16)}..." }
             notifyPythonConnected(
                 address = address,
                 mtu = peer.mtu,
@@ -437,7 +437,7 @@ class KotlinBLEBridge(
             // MTU also re-fires so the driver's fragmenter/reassembler are sized correctly.
             runCatching {
                 onMtuNegotiated?.callAttr("__call__", address, peer.mtu)
-            }.onFailure { Log.w(TAG, "Python onMtuNegotiated sync threw for $address: ${it.message}") }
+            }.onFailure { RingLog.w(TAG) { "Python onMtuNegotiated sync threw for $address: ${it.message}" } }
         }
     }
 
@@ -503,7 +503,7 @@ class KotlinBLEBridge(
             }
             jsonArray.toString()
         } catch (e: Exception) {
-            Log.e(TAG, "Error building connection details JSON", e)
+            RingLog.e(TAG, e) { "Error building connection details JSON" }
             "[]"
         }
 
@@ -542,7 +542,7 @@ class KotlinBLEBridge(
                     }
                 }
             }
-        Log.d(TAG, "Started periodic connection refresh")
+        RingLog.d(TAG) { "Started periodic connection refresh" }
     }
 
     /**
@@ -552,7 +552,7 @@ class KotlinBLEBridge(
     fun stopPeriodicConnectionRefresh() {
         connectionRefreshJob?.cancel()
         connectionRefreshJob = null
-        Log.d(TAG, "Stopped periodic connection refresh")
+        RingLog.d(TAG) { "Stopped periodic connection refresh" }
     }
 
     // Stored UUIDs for restart capability
@@ -594,6 +594,14 @@ class KotlinBLEBridge(
         CLOSE_PERIPHERAL,
     }
 
+    /**
+     * Path chosen for an outbound fragment under the peer mutex (the send happens after it).
+     */
+    private enum class SendRoute {
+        CENTRAL,
+        PERIPHERAL,
+    }
+
     /**
      * Data class to track peer connection state.
      */
@@ -658,11 +666,11 @@ class KotlinBLEBridge(
     ): Result<Unit> {
         return try {
             if (isStarted) {
-                Log.w(TAG, "BLE bridge already started")
+                RingLog.w(TAG) { "BLE bridge already started" }
                 return Result.success(Unit)
             }
 
-            Log.i(TAG, "Starting BLE bridge...")
+            RingLog.i(TAG) { "Starting BLE bridge..." }
 
             // Store UUIDs for restart capability
             storedServiceUuid = serviceUuid
@@ -672,13 +680,13 @@ class KotlinBLEBridge(
 
             // Verify Bluetooth hardware is available
             if (bluetoothAdapter == null) {
-                Log.e(TAG, "Bluetooth hardware is not available")
+                RingLog.e(TAG) { "Bluetooth hardware is not available" }
                 return Result.failure(Exception("Bluetooth hardware is not available"))
             }
 
             // Verify Bluetooth is enabled
             if (!bluetoothAdapter.isEnabled) {
-                Log.e(TAG, "Bluetooth is disabled")
+                RingLog.e(TAG) { "Bluetooth is disabled" }
                 return Result.failure(Exception("Bluetooth is disabled"))
             }
 
@@ -687,21 +695,21 @@ class KotlinBLEBridge(
 
             // Start GATT server (peripheral mode)
             gattServer?.open()?.fold(
-                onSuccess = { Log.d(TAG, "GATT server opened successfully") },
+                onSuccess = { RingLog.d(TAG) { "GATT server opened successfully" } },
                 onFailure = {
-                    Log.e(TAG, "Failed to open GATT server", it)
+                    RingLog.e(TAG, it) { "Failed to open GATT server" }
                     return Result.failure(it)
                 },
             ) ?: return Result.failure(Exception("GATT server not available"))
 
             // Bluetooth adapter state receiver is registered in init block
-            Log.d(TAG, "Bluetooth state receiver already active (registered in init)")
+            RingLog.d(TAG) { "Bluetooth state receiver already active (registered in init)" }
 
             isStarted = true
-            Log.i(TAG, "BLE bridge started successfully")
+            RingLog.i(TAG) { "BLE bridge started successfully" }
             Result.success(Unit)
         } catch (e: Exception) {
-            Log.e(TAG, "Failed to start BLE bridge", e)
+            RingLog.e(TAG, e) { "Failed to start BLE bridge" }
 
             // Clean up partially initialized state to prevent resource leaks
             try {
@@ -717,13 +725,13 @@ class KotlinBLEBridge(
                         context.unregisterReceiver(bluetoothStateReceiver)
                         isReceiverRegistered = false
                     } catch (unregisterException: IllegalArgumentException) {
-                        Log.w(TAG, "Receiver was not registered during cleanup", unregisterException)
+                        RingLog.w(TAG, unregisterException) { "Receiver was not registered during cleanup" }
                     }
                 }
 
-                Log.d(TAG, "Cleanup completed after initialization failure")
+                RingLog.d(TAG) { "Cleanup completed after initialization failure" }
             } catch (cleanupException: Exception) {
-                Log.e(TAG, "Error during initialization cleanup", cleanupException)
+                RingLog.e(TAG, cleanupException) { "Error during initialization cleanup" }
             }
 
             Result.failure(e)
@@ -746,7 +754,7 @@ class KotlinBLEBridge(
             return
         }
 
-        Log.i(TAG, "Stopping BLE bridge...")
+        RingLog.i(TAG) { "Stopping BLE bridge..." }
 
         // Each cleanup step is wrapped in try-catch to ensure continuation even if one fails
         // This prevents partial cleanup that could cause resource leaks
@@ -755,14 +763,14 @@ class KotlinBLEBridge(
         try {
             stopScanning()
         } catch (e: Exception) {
-            Log.e(TAG, "Error stopping scanner during cleanup", e)
+            RingLog.e(TAG, e) { "Error stopping scanner during cleanup" }
         }
 
         // Stop advertising
         try {
             stopAdvertising()
         } catch (e: Exception) {
-            Log.e(TAG, "Error stopping advertiser during cleanup", e)
+            RingLog.e(TAG, e) { "Error stopping advertiser during cleanup" }
         }
 
         // Disconnect all peers
@@ -771,18 +779,18 @@ class KotlinBLEBridge(
                 try {
                     disconnect(address)
                 } catch (e: Exception) {
-                    Log.e(TAG, "Error disconnecting from $address during cleanup", e)
+                    RingLog.e(TAG, e) { "Error disconnecting from $address during cleanup" }
                 }
             }
         } catch (e: Exception) {
-            Log.e(TAG, "Error iterating connected peers during cleanup", e)
+            RingLog.e(TAG, e) { "Error iterating connected peers during cleanup" }
         }
 
         // Close GATT server
         try {
             gattServer?.close()
         } catch (e: Exception) {
-            Log.e(TAG, "Error closing GATT server during cleanup", e)
+            RingLog.e(TAG, e) { "Error closing GATT server during cleanup" }
         }
 
         // Unregister Bluetooth adapter state receiver
@@ -790,11 +798,11 @@ class KotlinBLEBridge(
             try {
                 context.unregisterReceiver(bluetoothStateReceiver)
                 isReceiverRegistered = false
-                Log.d(TAG, "Bluetooth adapter state receiver unregistered")
+                RingLog.d(TAG) { "Bluetooth adapter state receiver unregistered" }
             } catch (e: IllegalArgumentException) {
-                Log.w(TAG, "Receiver was not registered during cleanup")
+                RingLog.w(TAG) { "Receiver was not registered during cleanup" }
             } catch (e: Exception) {
-                Log.e(TAG, "Error unregistering receiver during cleanup", e)
+                RingLog.e(TAG, e) { "Error unregistering receiver during cleanup" }
             }
         }
 
@@ -807,11 +815,11 @@ class KotlinBLEBridge(
             processedIdentityCallbacks.clear()
             pendingCentralConnections.clear()
         } catch (e: Exception) {
-            Log.e(TAG, "Error clearing state during cleanup", e)
+            RingLog.e(TAG, e) { "Error clearing state during cleanup" }
         }
 
         isStarted = false
-        Log.i(TAG, "BLE bridge stopped")
+        RingLog.i(TAG) { "BLE bridge stopped" }
     }
 
     /**
@@ -834,7 +842,7 @@ class KotlinBLEBridge(
      */
     suspend fun restart() {
         try {
-            Log.i(TAG, "Restarting BLE bridge after permission grant...")
+            RingLog.i(TAG) { "Restarting BLE bridge after permission grant..." }
 
             // Check if we have stored UUIDs (BLE was started before)
             val serviceUuid = storedServiceUuid
@@ -843,7 +851,7 @@ class KotlinBLEBridge(
             val identityCharUuid = storedIdentityCharUuid
             @Suppress("ComplexCondition") // All 4 UUIDs must be present to restart
             if (serviceUuid == null || rxCharUuid == null || txCharUuid == null || identityCharUuid == null) {
-                Log.w(TAG, "Cannot restart BLE - no stored UUIDs (BLE was never started)")
+                RingLog.w(TAG) { "Cannot restart BLE - no stored UUIDs (BLE was never started)" }
                 return
             }
 
@@ -852,14 +860,14 @@ class KotlinBLEBridge(
 
             // Stop BLE if it's currently running
             if (isStarted) {
-                Log.d(TAG, "Stopping BLE before restart...")
+                RingLog.d(TAG) { "Stopping BLE before restart..." }
                 stop()
                 // Give it a moment to fully stop
                 delay(500)
             }
 
             // Restart with stored UUIDs
-            Log.d(TAG, "Starting BLE with stored UUIDs...")
+            RingLog.d(TAG) { "Starting BLE with stored UUIDs..." }
             start(
                 serviceUuid,
                 rxCharUuid,
@@ -867,46 +875,46 @@ class KotlinBLEBridge(
                 identityCharUuid,
             ).fold(
                 onSuccess = {
-                    Log.i(TAG, "BLE restart successful - interface is now operational")
+                    RingLog.i(TAG) { "BLE restart successful - interface is now operational" }
 
                     // Restore transport identity if it was set before
                     savedIdentity?.let { identity ->
-                        Log.d(TAG, "Restoring transport identity after restart")
+                        RingLog.d(TAG) { "Restoring transport identity after restart" }
                         setIdentity(identity)
                     }
 
                     // Start scanning to discover peer devices
-                    Log.d(TAG, "Starting BLE scanning after restart...")
+                    RingLog.d(TAG) { "Starting BLE scanning after restart..." }
                     startScanning()
                         .onSuccess {
-                            Log.d(TAG, "Scanner started after restart")
+                            RingLog.d(TAG) { "Scanner started after restart" }
                         }.onFailure { error ->
-                            Log.e(TAG, "Failed to start scanner after restart: ${error.message}", error)
+                            RingLog.e(TAG, error) { "Failed to start scanner after restart: ${error.message}" }
                         }
 
                     // Start advertising when identity is ready
                     if (savedIdentity != null) {
                         // Identity already available - advertise immediately
                         val systemDeviceName = bluetoothAdapter?.name ?: "Reticulum"
-                        Log.d(TAG, "Starting BLE advertising after restart with system name '$systemDeviceName'...")
+                        RingLog.d(TAG) { "Starting BLE advertising after restart with system name '$systemDeviceName'..." }
                         startAdvertising(systemDeviceName)
                             .onSuccess {
-                                Log.d(TAG, "Advertiser started after restart")
+                                RingLog.d(TAG) { "Advertiser started after restart" }
                             }.onFailure { error ->
-                                Log.e(TAG, "Failed to start advertising after restart: ${error.message}", error)
+                                RingLog.e(TAG, error) { "Failed to start advertising after restart: ${error.message}" }
                             }
                     } else {
                         // Wait for identity to be set by Python
-                        Log.d(TAG, "Waiting for identity before starting advertising...")
+                        RingLog.d(TAG) { "Waiting for identity before starting advertising..." }
                         identityReadyCallback = {
                             scope.launch {
                                 val systemDeviceName = bluetoothAdapter?.name ?: "Reticulum"
-                                Log.d(TAG, "Identity ready - starting BLE advertising with system name '$systemDeviceName'...")
+                                RingLog.d(TAG) { "Identity ready - starting BLE advertising with system name '$systemDeviceName'..." }
                                 startAdvertising(systemDeviceName)
                                     .onSuccess {
-                                        Log.d(TAG, "Advertiser started after identity set")
+                                        RingLog.d(TAG) { "Advertiser started after identity set" }
                                     }.onFailure { error ->
-                                        Log.e(TAG, "Failed to start advertising: ${error.message}", error)
+                                        RingLog.e(TAG, error) { "Failed to start advertising: ${error.message}" }
                                     }
                             }
                         }
@@ -915,18 +923,18 @@ class KotlinBLEBridge(
                         scope.launch {
                             delay(30000) // 30 second timeout
                             if (identityReadyCallback != null) {
-                                Log.w(TAG, "Timeout waiting for identity - advertising not started")
+                                RingLog.w(TAG) { "Timeout waiting for identity - advertising not started" }
                                 identityReadyCallback = null
                             }
                         }
                     }
                 },
                 onFailure = { error ->
-                    Log.e(TAG, "BLE restart failed: ${error.message}", error)
+                    RingLog.e(TAG, error) { "BLE restart failed: ${error.message}" }
                 },
             )
         } catch (e: Exception) {
-            Log.e(TAG, "Error during BLE restart", e)
+            RingLog.e(TAG, e) { "Error during BLE restart" }
         }
     }
 
@@ -942,11 +950,11 @@ class KotlinBLEBridge(
         // Update all BLE components (if available)
         gattClient?.setTransportIdentity(identityBytes)
         gattServer?.setTransportIdentity(identityBytes)
-        Log.i(TAG, "Transport identity set: ${identityBytes.toHex()}")
+        RingLog.i(TAG) { "Transport identity set: ${identityBytes.toHex()}" }
 
         // Trigger any pending identity callback (e.g., from restart waiting for identity)
         identityReadyCallback?.let { callback ->
-            Log.d(TAG, "Triggering identity ready callback")
+            RingLog.d(TAG) { "Triggering identity ready callback" }
             callback()
             identityReadyCallback = null
         }
@@ -972,15 +980,15 @@ class KotlinBLEBridge(
         withContext(Dispatchers.Default) {
             val scannerInstance = scanner
             if (scannerInstance == null) {
-                Log.e(TAG, "Cannot start scanning - Bluetooth not available")
+                RingLog.e(TAG) { "Cannot start scanning - Bluetooth not available" }
                 return@withContext Result.failure(Exception("Bluetooth not available"))
             }
             scannerInstance
                 .startScanning()
                 .onSuccess {
-                    Log.d(TAG, "Scanning started")
+                    RingLog.d(TAG) { "Scanning started" }
                 }.onFailure {
-                    Log.e(TAG, "Failed to start scanning", it)
+                    RingLog.e(TAG, it) { "Failed to start scanning" }
                 }
         }
 
@@ -1002,7 +1010,7 @@ class KotlinBLEBridge(
     suspend fun stopScanning() =
         withContext(Dispatchers.Default) {
             scanner?.stopScanning()
-            Log.d(TAG, "Scanning stopped")
+            RingLog.d(TAG) { "Scanning stopped" }
         }
 
     fun startAdvertisingAsync(deviceName: String = "Reticulum") {
@@ -1023,15 +1031,15 @@ class KotlinBLEBridge(
 
             val advertiserInstance = advertiser
             if (advertiserInstance == null) {
-                Log.e(TAG, "Cannot start advertising - Bluetooth not available")
+                RingLog.e(TAG) { "Cannot start advertising - Bluetooth not available" }
                 return@withContext Result.failure(Exception("Bluetooth not available"))
             }
             advertiserInstance
                 .startAdvertising(deviceName)
                 .onSuccess {
-                    Log.d(TAG, "Advertising started")
+                    RingLog.d(TAG) { "Advertising started" }
                 }.onFailure {
-                    Log.e(TAG, "Failed to start advertising", it)
+                    RingLog.e(TAG, it) { "Failed to start advertising" }
                 }
         }
 
@@ -1049,7 +1057,7 @@ class KotlinBLEBridge(
     fun stopAdvertising() {
         scope.launch {
             advertiser?.stopAdvertising()
-            Log.d(TAG, "Advertising stopped")
+            RingLog.d(TAG) { "Advertising stopped" }
         }
     }
 
@@ -1066,7 +1074,7 @@ class KotlinBLEBridge(
         if (!advertiserInstance.isAdvertising.value && transportIdentityHash != null) {
             scope.launch {
                 val name = storedDeviceName ?: "Reticulum"
-                Log.d(TAG, "ensureAdvertising: restarting as '$name'")
+                RingLog.d(TAG) { "ensureAdvertising: restarting as '$name'" }
                 advertiserInstance.startAdvertising(name)
             }
             return false // Was not advertising, now restarting
@@ -1095,7 +1103,7 @@ class KotlinBLEBridge(
             // Get local MAC address
             val localAddress = bluetoothAdapter?.address
             if (localAddress == null) {
-                Log.w(TAG, "Local MAC address unavailable (no Bluetooth?), falling back to always connect")
+                RingLog.w(TAG) { "Local MAC address unavailable (no Bluetooth?), falling back to always connect" }
                 return true
             }
 
@@ -1108,7 +1116,7 @@ class KotlinBLEBridge(
                 try {
                     localMacStripped.toLong(16)
                 } catch (e: NumberFormatException) {
-                    Log.w(TAG, "Invalid local MAC format: $localAddress, falling back to always connect")
+                    RingLog.w(TAG) { "Invalid local MAC format: $localAddress, falling back to always connect" }
                     return true
                 }
 
@@ -1116,18 +1124,18 @@ class KotlinBLEBridge(
                 try {
                     peerMacStripped.toLong(16)
                 } catch (e: NumberFormatException) {
-                    Log.w(TAG, "Invalid peer MAC format: $peerAddress, falling back to always connect")
+                    RingLog.w(TAG) { "Invalid peer MAC format: $peerAddress, falling back to always connect" }
                     return true
                 }
 
             // Lower MAC initiates connection
             val shouldConnect = localMacInt < peerMacInt
 
-            Log.d(TAG, "MAC comparison: local=$localAddress ($localMacInt), peer=$peerAddress ($peerMacInt), shouldConnect=$shouldConnect")
+            RingLog.d(TAG) { "MAC comparison: local=$localAddress ($localMacInt), peer=$peerAddress ($peerMacInt), shouldConnect=$shouldConnect" }
 
             return shouldConnect
         } catch (e: Exception) {
-            Log.e(TAG, "Error in MAC comparison, falling back to always connect", e)
+            RingLog.e(TAG, e) { "Error in MAC comparison, falling back to always connect" }
             return true
         }
     }
@@ -1151,7 +1159,7 @@ class KotlinBLEBridge(
      */
     suspend fun connect(address: String) {
         try {
-            Log.i(TAG, "Connecting to $address...")
+            RingLog.i(TAG) { "Connecting to $address..." }
 
             // NOTE: MAC sorting moved to Python. Python should call shouldConnect() first.
             // We still check for existing connections to avoid duplicate GATT operations.
@@ -1161,16 +1169,16 @@ class KotlinBLEBridge(
 
             when {
                 alreadyCentral -> {
-                    Log.w(TAG, "Already connected to $address as central")
+                    RingLog.w(TAG) { "Already connected to $address as central" }
                 }
                 centralCount >= BleConstants.MAX_CONNECTIONS -> {
-                    Log.w(TAG, "Maximum central connections reached ($centralCount/${BleConstants.MAX_CONNECTIONS})")
+                    RingLog.w(TAG) { "Maximum central connections reached ($centralCount/${BleConstants.MAX_CONNECTIONS})" }
                 }
                 client == null -> {
-                    Log.w(TAG, "Cannot connect to $address - Bluetooth not available")
+                    RingLog.w(TAG) { "Cannot connect to $address - Bluetooth not available" }
                 }
                 !pendingCentralConnections.add(address) -> {
-                    Log.d(TAG, "Central connection already pending for $address")
+                    RingLog.d(TAG) { "Central connection already pending for $address" }
                 }
                 else -> {
                     // Track atomically as pending before entering the GATT client. The
@@ -1179,16 +1187,15 @@ class KotlinBLEBridge(
                     val result = client.connect(address)
                     if (result.isFailure) {
                         pendingCentralConnections.remove(address)
-                        Log.w(
-                            TAG,
-                            "Failed to start central connection to $address: ${result.exceptionOrNull()?.message}",
-                        )
+                        RingLog.w(TAG) {
+                            "Failed to start central connection to $address: ${result.exceptionOrNull()?.message}"
+                        }
                     }
                 }
             }
         } catch (e: Exception) {
             pendingCentralConnections.remove(address)
-            Log.e(TAG, "Failed to connect to $address", e)
+            RingLog.e(TAG, e) { "Failed to connect to $address" }
         }
     }
 
@@ -1207,11 +1214,11 @@ class KotlinBLEBridge(
      */
     suspend fun disconnect(address: String) {
         try {
-            Log.i(TAG, "Disconnecting from $address...")
+            RingLog.i(TAG) { "Disconnecting from $address..." }
 
             val peer = connectedPeers[address]
             if (peer == null) {
-                Log.w(TAG, "No connection found for $address")
+                RingLog.w(TAG) { "No connection found for $address" }
                 return
             }
 
@@ -1225,7 +1232,7 @@ class KotlinBLEBridge(
 
             // Cleanup will happen in onDisconnected callback
         } catch (e: Exception) {
-            Log.e(TAG, "Failed to disconnect from $address", e)
+            RingLog.e(TAG, e) { "Failed to disconnect from $address" }
         }
     }
 
@@ -1249,7 +1256,7 @@ class KotlinBLEBridge(
      */
     suspend fun disconnectCentral(address: String) {
         try {
-            Log.i(TAG, "Disconnecting central connection to $address...")
+            RingLog.i(TAG) { "Disconnecting central connection to $address..." }
             gattClient?.disconnect(address)
 
             // Update peer state - mark as no longer central
@@ -1257,7 +1264,7 @@ class KotlinBLEBridge(
                 connectedPeers[address]?.isCentral = false
             }
         } catch (e: Exception) {
-            Log.e(TAG, "Failed to disconnect central from $address", e)
+            RingLog.e(TAG, e) { "Failed to disconnect central from $address" }
         }
     }
 
@@ -1281,7 +1288,7 @@ class KotlinBLEBridge(
      */
     suspend fun disconnectPeripheral(address: String) {
         try {
-            Log.i(TAG, "Disconnecting peripheral connection from $address...")
+            RingLog.i(TAG) { "Disconnecting peripheral connection from $address..." }
             gattServer?.disconnectCentral(address)
 
             // Update peer state - mark as no longer peripheral
@@ -1289,7 +1296,7 @@ class KotlinBLEBridge(
                 connectedPeers[address]?.isPeripheral = false
             }
         } catch (e: Exception) {
-            Log.e(TAG, "Failed to disconnect peripheral from $address", e)
+            RingLog.e(TAG, e) { "Failed to disconnect peripheral from $address" }
         }
     }
 
@@ -1310,6 +1317,11 @@ class KotlinBLEBridge(
      *
      * Launches coroutines internally - safe to call from Python.
      *
+     * Peripheral-path sends suspend while the central's notification queue is
+     * full (see BleNotificationQueue). The per-peer mutex is held meanwhile, so
+     * further fragments for that peer wait here in order rather than being
+     * dropped by the stack.
+     *
      * @param address BLE MAC address
      * @param data Pre-fragmented data bytes (single fragment)
      */
@@ -1331,7 +1343,7 @@ class KotlinBLEBridge(
                 if (identityHash == null) {
                     identityHash = staleAddressToIdentity[address]
                     if (identityHash != null) {
-                        Log.d(TAG, "Found identity $identityHash for stale address $address in cache")
+                        RingLog.d(TAG) { "Found identity $identityHash for stale address $address in cache" }
                     }
                 }
 
@@ -1340,7 +1352,7 @@ class KotlinBLEBridge(
                     if (currentAddress != null && currentAddress != address) {
                         peer = connectedPeers[currentAddress]
                         if (peer != null) {
-                            Log.i(TAG, "Address $address resolved to $currentAddress via identity $identityHash")
+                            RingLog.i(TAG) { "Address $address resolved to $currentAddress via identity $identityHash" }
                             targetAddress = currentAddress
                         }
                     }
@@ -1348,7 +1360,7 @@ class KotlinBLEBridge(
             }
 
             if (peer == null) {
-                Log.w(TAG, "Cannot send to $address - not connected (identity lookup also failed)")
+                RingLog.w(TAG) { "Cannot send to $address - not connected (identity lookup also failed)" }
                 return
             }
 
@@ -1356,41 +1368,52 @@ class KotlinBLEBridge(
             peer.lastActivity = System.currentTimeMillis()
 
             // Data is now a pre-formatted fragment from the Python layer
-            Log.d(TAG, "Sending ${data.size} byte fragment to $targetAddress")
-
-            // CRITICAL SECTION: Acquire per-peer mutex to ensure state read and send are atomic
-            // This prevents TOCTOU race condition where deduplicationState changes between
-            // computing useCentral/usePeripheral and actually using those values.
-            peer.stateMutex.withLock {
-                // TEST HOOK: Widen TOCTOU race window for testing (inside mutex)
-                if (testDelayAfterStateReadMs > 0) {
-                    kotlinx.coroutines.delay(testDelayAfterStateReadMs)
-                }
+            RingLog.d(TAG) { "Sending ${data.size} byte fragment to $targetAddress" }
+
+            // Decide the route under the per-peer mutex so it reflects a consistent
+            // deduplicationState (no TOCTOU between reading the state and picking a path),
+            // but send after releasing it: a peripheral send can suspend on a full
+            // notification queue, and one slow central must not hold up dedup
+            // transitions and disconnect handling for this peer. If the chosen path
+            // closes meanwhile, the send fails and is logged below.
+            val route =
+                peer.stateMutex.withLock {
+                    // TEST HOOK: Widen TOCTOU race window for testing (inside mutex)
+                    if (testDelayAfterStateReadMs > 0) {
+                        kotlinx.coroutines.delay(testDelayAfterStateReadMs)
+                    }
 
-                // Read state and make decision while holding mutex
-                val useCentral = peer.isCentral && peer.deduplicationState != DeduplicationState.CLOSING_CENTRAL
-                val usePeripheral = peer.isPeripheral && peer.deduplicationState != DeduplicationState.CLOSING_PERIPHERAL
+                    when {
+                        peer.isCentral && peer.deduplicationState != DeduplicationState.CLOSING_CENTRAL -> SendRoute.CENTRAL
+                        // Otherwise use peripheral connection (notify their TX)
+                        peer.isPeripheral && peer.deduplicationState != DeduplicationState.CLOSING_PERIPHERAL -> SendRoute.PERIPHERAL
+                        else -> {
+                            // Both paths blocked during deduplication
+                            if (peer.deduplicationState != DeduplicationState.NONE) {
+                                RingLog.w(TAG) {
+                                    "Cannot send to $targetAddress - deduplication in progress (state=${peer.deduplicationState})"
+                                }
+                            }
+                            null
+                        }
+                    }
+                }
 
-                if (useCentral) {
+            when (route) {
+                SendRoute.CENTRAL ->
                     gattClient?.sendData(targetAddress, data)?.fold(
-                        onSuccess = { Log.v(TAG, "Fragment sent via central to $targetAddress") },
-                        onFailure = { Log.e(TAG, "Failed to send fragment via central to $targetAddress", it) },
-                    ) ?: Log.w(TAG, "Cannot send via central - Bluetooth not available")
-                }
-                // Otherwise use peripheral connection (notify their TX)
-                else if (usePeripheral) {
+                        onSuccess = { RingLog.v(TAG) { "Fragment sent via central to $targetAddress" } },
+                        onFailure = { RingLog.e(TAG, it) { "Failed to send fragment via central to $targetAddress" } },
+                    ) ?: RingLog.w(TAG) { "Cannot send via central - Bluetooth not available" }
+                SendRoute.PERIPHERAL ->
                     gattServer?.notifyCentrals(data, targetAddress)?.fold(
-                        onSuccess = { Log.v(TAG, "Fragment sent via peripheral to $targetAddress") },
-                        onFailure = { Log.e(TAG, "Failed to send fragment via peripheral to $targetAddress", it) },
-                    ) ?: Log.w(TAG, "Cannot send via peripheral - Bluetooth not available")
-                }
-                // Both paths blocked during deduplication
-                else if (peer.deduplicationState != DeduplicationState.NONE) {
-                    Log.w(TAG, "Cannot send to $targetAddress - deduplication in progress (state=${peer.deduplicationState})")
-                }
+                        onSuccess = { RingLog.v(TAG) { "Fragment sent via peripheral to $targetAddress" } },
+                        onFailure = { RingLog.e(TAG, it) { "Failed to send fragment via peripheral to $targetAddress" } },
+                    ) ?: RingLog.w(TAG) { "Cannot send via peripheral - Bluetooth not available" }
+                null -> Unit
             }
         } catch (e: Exception) {
-            Log.e(TAG, "Failed to send data to $targetAddress (requested: $address)", e)
+            RingLog.e(TAG, e) { "Failed to send data to $targetAddress (requested: $address)" }
         }
     }
 
@@ -1426,10 +1449,10 @@ class KotlinBLEBridge(
     fun getPeerRssi(address: String): Int? {
         val peer = connectedPeers[address]
         return if (peer != null && peer.rssi != -100) {
-            Log.d(TAG, "getPeerRssi($address) = ${peer.rssi} dBm")
+            RingLog.d(TAG) { "getPeerRssi($address) = ${peer.rssi} dBm" }
             peer.rssi
         } else {
-            Log.d(TAG, "getPeerRssi($address) = null (peer not found or RSSI unknown)")
+            RingLog.d(TAG) { "getPeerRssi($address) = null (peer not found or RSSI unknown)" }
             null
         }
     }
@@ -1445,12 +1468,12 @@ class KotlinBLEBridge(
      * @return true if identity was found and callback fired, false otherwise
      */
     fun requestIdentityResync(address: String): Boolean {
-        Log.d(TAG, "Identity resync requested for $address")
+        RingLog.d(TAG) { "Identity resync requested for $address" }
 
         // Try to get identity from our tracking
         val identityHash = addressToIdentity[address]
         if (identityHash != null) {
-            Log.i(TAG, "Identity resync: found identity ${identityHash.take(16)}... for $address")
+            RingLog.i(TAG) { "Identity resync: found identity ${identityHash.take(16)}... for $address" }
 
             return true
         }
@@ -1458,13 +1481,12 @@ class KotlinBLEBridge(
         // No identity found in our tracking
         val peer = connectedPeers[address]
         if (peer != null) {
-            Log.w(
-                TAG,
+            RingLog.w(TAG) {
                 "Identity resync: peer $address is connected but has no tracked identity " +
-                    "(central=${peer.isCentral}, peripheral=${peer.isPeripheral})",
-            )
+                    "(central=${peer.isCentral}, peripheral=${peer.isPeripheral})"
+            }
         } else {
-            Log.w(TAG, "Identity resync: peer $address is not connected")
+            RingLog.w(TAG) { "Identity resync: peer $address is not connected" }
         }
 
         return false
@@ -1612,13 +1634,13 @@ class KotlinBLEBridge(
     private fun setupCallbacks() {
         // Scanner callbacks (if available)
         scanner?.onDeviceDiscovered = { device: BleDevice ->
-            Log.d(TAG, "Device discovered: ${device.address} (${device.name}) RSSI=${device.rssi}")
+            RingLog.d(TAG) { "Device discovered: ${device.address} (${device.name}) RSSI=${device.rssi}" }
             // Forward to Python driver. Convert List<String>? → Array<String>? so
             // Chaquopy auto-converts to a Python list at the boundary (matches v0.10.x).
             val serviceUuidsArray = device.serviceUuids?.toTypedArray()
             runCatching {
                 onDeviceDiscovered?.callAttr("__call__", device.address, device.name, device.rssi, serviceUuidsArray)
-            }.onFailure { Log.w(TAG, "Python onDeviceDiscovered threw for ${device.address}: ${it.message}") }
+            }.onFailure { RingLog.w(TAG) { "Python onDeviceDiscovered threw for ${device.address}: ${it.message}" } }
         }
 
         // GATT Client callbacks (central mode, if available)
@@ -1637,7 +1659,7 @@ class KotlinBLEBridge(
         gattClient?.onConnectionFailed = { address: String, error: String ->
             // Clean up pending central tracking when connection fails
             pendingCentralConnections.remove(address)
-            Log.d(TAG, "Central connection failed to $address: $error")
+            RingLog.d(TAG) { "Central connection failed to $address: $error" }
 
             // Central handshake failed - try to complete via peripheral if connected
             // This handles dual-connection scenarios where both devices connect as central
@@ -1647,7 +1669,7 @@ class KotlinBLEBridge(
                 if (identityHash != null) {
                     val completed = gattServer?.completeConnectionWithIdentity(address, identityHash) ?: false
                     if (completed) {
-                        Log.i(TAG, "Central failed, completed peripheral connection for $address")
+                        RingLog.i(TAG) { "Central failed, completed peripheral connection for $address" }
                     }
                 }
             }
@@ -1704,13 +1726,13 @@ class KotlinBLEBridge(
 
         // Advertiser callbacks (for logging and potential Python notification, if available)
         advertiser?.onAdvertisingStarted = { deviceName: String ->
-            Log.i(TAG, "Advertising started: $deviceName")
+            RingLog.i(TAG) { "Advertising started: $deviceName" }
         }
         advertiser?.onAdvertisingStopped = {
-            Log.i(TAG, "Advertising stopped")
+            RingLog.i(TAG) { "Advertising stopped" }
         }
         advertiser?.onAdvertisingFailed = { errorCode: Int, message: String ->
-            Log.e(TAG, "Advertising failed: $message (code: $errorCode)")
+            RingLog.e(TAG) { "Advertising failed: $message (code: $errorCode)" }
         }
     }
 
@@ -1721,12 +1743,12 @@ class KotlinBLEBridge(
         if (!peer.isCentral || !peer.isPeripheral) return DedupeAction.NONE
 
         dualConnectionRaceCount++
-        Log.d(TAG, "Dual connection count: $dualConnectionRaceCount")
+        RingLog.d(TAG) { "Dual connection count: $dualConnectionRaceCount" }
 
         val peerIdentity = addressToIdentity[address]
         val localIdentityBytes = transportIdentityHash
         if (peerIdentity == null || localIdentityBytes == null) {
-            Log.w(TAG, "Dual connection but identity not yet available - deferring deduplication")
+            RingLog.w(TAG) { "Dual connection but identity not yet available - deferring deduplication" }
             return DedupeAction.NONE
         }
 
@@ -1741,19 +1763,17 @@ class KotlinBLEBridge(
 
         return peer.stateMutex.withLock {
             if (preferredRole == PreferredBleRole.CENTRAL) {
-                Log.i(
-                    TAG,
+                RingLog.i(TAG) {
                     "Deduplication: keeping central " +
-                        "(centralMtu=$centralMtu peripheralMtu=$peripheralMtu)",
-                )
+                        "(centralMtu=$centralMtu peripheralMtu=$peripheralMtu)"
+                }
                 peer.deduplicationState = DeduplicationState.CLOSING_PERIPHERAL
                 DedupeAction.CLOSE_PERIPHERAL
             } else {
-                Log.i(
-                    TAG,
+                RingLog.i(TAG) {
                     "Deduplication: keeping peripheral " +
-                        "(centralMtu=$centralMtu peripheralMtu=$peripheralMtu)",
-                )
+                        "(centralMtu=$centralMtu peripheralMtu=$peripheralMtu)"
+                }
                 peer.deduplicationState = DeduplicationState.CLOSING_CENTRAL
                 DedupeAction.CLOSE_CENTRAL
             }
@@ -1819,7 +1839,7 @@ class KotlinBLEBridge(
             // send-visible deduplication state under its per-peer mutex.
             dedupeAction = resolveDualConnectionAction(address, peer)
 
-            Log.i(TAG, "Peer connected: $address (central=$isCentral, peripheral=${peer.isPeripheral}, dedupe=${peer.deduplicationState}, MTU=$mtu)")
+            RingLog.i(TAG) { "Peer connected: $address (central=$isCentral, peripheral=${peer.isPeripheral}, dedupe=${peer.deduplicationState}, MTU=$mtu)" }
 
             val identityHash = addressToIdentity[address]
 
@@ -1835,7 +1855,7 @@ class KotlinBLEBridge(
                         isCentral = isCentral,
                         isPeripheral = peer.isPeripheral,
                     )
-                Log.d(TAG, "Connection $address pending identity - withholding Python callback")
+                RingLog.d(TAG) { "Connection $address pending identity - withholding Python callback" }
             } else {
                 notifyPythonConnected(address, peer.mtu, isCentral, peer.isPeripheral, identityHash)
             }
@@ -1852,7 +1872,7 @@ class KotlinBLEBridge(
                         closingCentral = true,
                     )
                 scheduleDeduplicationTrackerCleanup(address)
-                Log.i(TAG, "Deduplication: disconnecting central connection to $address")
+                RingLog.i(TAG) { "Deduplication: disconnecting central connection to $address" }
                 gattClient?.disconnect(address)
             }
             DedupeAction.CLOSE_PERIPHERAL -> {
@@ -1863,7 +1883,7 @@ class KotlinBLEBridge(
                         closingCentral = false,
                     )
                 scheduleDeduplicationTrackerCleanup(address)
-                Log.i(TAG, "Deduplication: disconnecting peripheral connection from $address")
+                RingLog.i(TAG) { "Deduplication: disconnecting peripheral connection from $address" }
                 gattServer?.disconnectCentral(address)
             }
             DedupeAction.NONE -> { /* No deduplication needed */ }
@@ -1875,7 +1895,7 @@ class KotlinBLEBridge(
 
     private fun scheduleReciprocalCentralConnection(address: String) {
         if (transportIdentityHash == null || addressToIdentity[address] == null) {
-            Log.d(TAG, "Reciprocal connection deferred for $address until both identities are available")
+            RingLog.d(TAG) { "Reciprocal connection deferred for $address until both identities are available" }
             return
         }
         if (reciprocalConnectionTasks.containsKey(address)) return
@@ -1895,7 +1915,7 @@ class KotlinBLEBridge(
                     }
                 reciprocalConnectionTasks.remove(address)
                 if (shouldConnect) {
-                    Log.i(TAG, "Fallback-only inbound link at $address; forming reciprocal Android-central link")
+                    RingLog.i(TAG) { "Fallback-only inbound link at $address; forming reciprocal Android-central link" }
                     connect(address)
                 }
             }
@@ -1916,7 +1936,7 @@ class KotlinBLEBridge(
                     gattClient?.isConnected(address) == true
                 }
             if (!keptConnectionAlive) {
-                Log.w(TAG, "Deduplication grace expired without surviving link for $address")
+                RingLog.w(TAG) { "Deduplication grace expired without surviving link for $address" }
                 handlePeerDisconnected(address, isCentral = !tracker.closingCentral)
             }
         }
@@ -1937,7 +1957,7 @@ class KotlinBLEBridge(
         peersMutex.withLock {
             val peer = connectedPeers[address]
             if (peer == null) {
-                Log.w(TAG, "Disconnect notification for unknown peer: $address")
+                RingLog.w(TAG) { "Disconnect notification for unknown peer: $address" }
                 return
             }
 
@@ -1955,20 +1975,19 @@ class KotlinBLEBridge(
                     if (!isExpectedDisconnect) {
                         // This disconnect is for the connection we're KEEPING, not closing
                         // This is a spurious disconnect from Android BLE stack - ignore it
-                        Log.w(
-                            TAG,
+                        RingLog.w(TAG) {
                             "DEDUP PROTECTION: Ignoring spurious disconnect for $address " +
                                 "(received ${if (isCentral) "central" else "peripheral"} disconnect, " +
                                 "but we're closing ${if (dedupeTracker.closingCentral) "central" else "peripheral"}). " +
-                                "This is an Android BLE stack bug.",
-                        )
+                                "This is an Android BLE stack bug."
+                        }
                         return
                     }
                     // Expected disconnect - process it, but retain the tracker.
                     // On some Android stacks closing one GATT role tears down
                     // the shared ACL and a second callback for the kept role
                     // follows about a second later.
-                    Log.d(TAG, "Deduplication disconnect processed for $address (${if (isCentral) "central" else "peripheral"})")
+                    RingLog.d(TAG) { "Deduplication disconnect processed for $address (${if (isCentral) "central" else "peripheral"})" }
                 }
             }
 
@@ -1982,7 +2001,7 @@ class KotlinBLEBridge(
                 peer.stateMutex.withLock {
                     if (peer.deduplicationState == DeduplicationState.CLOSING_CENTRAL) {
                         peer.deduplicationState = DeduplicationState.NONE
-                        Log.d(TAG, "Deduplication complete: central connection closed for $address")
+                        RingLog.d(TAG) { "Deduplication complete: central connection closed for $address" }
                     }
                 }
             } else {
@@ -1994,7 +2013,7 @@ class KotlinBLEBridge(
                 peer.stateMutex.withLock {
                     if (peer.deduplicationState == DeduplicationState.CLOSING_PERIPHERAL) {
                         peer.deduplicationState = DeduplicationState.NONE
-                        Log.d(TAG, "Deduplication complete: peripheral connection closed for $address")
+                        RingLog.d(TAG) { "Deduplication complete: peripheral connection closed for $address" }
                     }
                 }
             }
@@ -2006,11 +2025,10 @@ class KotlinBLEBridge(
                 val remainingTracker = deduplicationInProgress.remove(address)
                 if (remainingTracker != null) {
                     val elapsed = System.currentTimeMillis() - remainingTracker.timestamp
-                    Log.w(
-                        TAG,
+                    RingLog.w(TAG) {
                         "DEDUP WARNING: Both connections closed for $address despite deduplication protection " +
-                            "(${elapsed}ms since deduplication started). This shouldn't happen.",
-                    )
+                            "(${elapsed}ms since deduplication started). This shouldn't happen."
+                    }
                 }
 
                 connectedPeers.remove(address)
@@ -2029,7 +2047,7 @@ class KotlinBLEBridge(
                         identityToAddress.remove(identityHash)
                         // Clean up any stale entries for this identity
                         staleAddressToIdentity.entries.removeIf { it.value == identityHash }
-                        Log.d(TAG, "Cleaned up all mappings for identity $identityHash")
+                        RingLog.d(TAG) { "Cleaned up all mappings for identity $identityHash" }
                     } else {
                         // Identity still connected at another address - cache the stale mapping
                         // This allows send() to resolve the old address to the current one
@@ -2050,10 +2068,10 @@ class KotlinBLEBridge(
                                 }
                             if (bestAddress != null) {
                                 identityToAddress[identityHash] = bestAddress
-                                Log.d(TAG, "Updated identityToAddress[$identityHash] from disconnected $address to $bestAddress")
+                                RingLog.d(TAG) { "Updated identityToAddress[$identityHash] from disconnected $address to $bestAddress" }
                             }
                         }
-                        Log.d(TAG, "Cached stale address $address -> $identityHash (identity still has other addresses: $otherAddresses)")
+                        RingLog.d(TAG) { "Cached stale address $address -> $identityHash (identity still has other addresses: $otherAddresses)" }
                     }
                 }
 
@@ -2062,13 +2080,13 @@ class KotlinBLEBridge(
                 // (fixes bug where static-MAC devices like Linux couldn't reconnect)
                 processedIdentityCallbacks.removeIf { it.startsWith("$address:") }
 
-                Log.i(TAG, "Peer disconnected: $address")
+                RingLog.i(TAG) { "Peer disconnected: $address" }
 
                 // Remove from scanner cache so device can be rediscovered and reconnected
                 // This enables automatic reconnection on next scan cycle
                 scanner?.removeDevice(address)
             } else {
-                Log.d(TAG, "Peer $address partially disconnected (central=${peer.isCentral}, peripheral=${peer.isPeripheral})")
+                RingLog.d(TAG) { "Peer $address partially disconnected (central=${peer.isCentral}, peripheral=${peer.isPeripheral})" }
             }
         }
 
@@ -2081,7 +2099,7 @@ class KotlinBLEBridge(
         if (connectedPeers[address] == null) {
             runCatching {
                 onDisconnected?.callAttr("__call__", address)
-            }.onFailure { Log.w(TAG, "Python onDisconnected threw for $address: ${it.message}") }
+            }.onFailure { RingLog.w(TAG) { "Python onDisconnected threw for $address: ${it.message}" } }
         }
     }
 
@@ -2105,7 +2123,7 @@ class KotlinBLEBridge(
                     centralPeerMtus[address] ?: BleConstants.MIN_USABLE_MTU,
                     peripheralPeerMtus[address] ?: BleConstants.MIN_USABLE_MTU,
                 )
-                Log.d(TAG, "MTU updated for $address: ${peer.mtu}")
+                RingLog.d(TAG) { "MTU updated for $address: ${peer.mtu}" }
                 peer.mtu
             } else {
                 mtu
@@ -2116,7 +2134,7 @@ class KotlinBLEBridge(
         // peers' connection callbacks waiting for the same lock.
         runCatching {
             onMtuNegotiated?.callAttr("__call__", address, effectiveMtu)
-        }.onFailure { Log.w(TAG, "Python onMtuNegotiated threw for $address: ${it.message}") }
+        }.onFailure { RingLog.w(TAG) { "Python onMtuNegotiated threw for $address: ${it.message}" } }
     }
 
     /**
@@ -2131,7 +2149,7 @@ class KotlinBLEBridge(
         try {
             // VALIDATION: Check fragment size before processing
             if (fragment.size > MAX_BLE_PACKET_SIZE) {
-                Log.w(TAG, "BLE packet too large: ${fragment.size} bytes (max $MAX_BLE_PACKET_SIZE), discarding")
+                RingLog.w(TAG) { "BLE packet too large: ${fragment.size} bytes (max $MAX_BLE_PACKET_SIZE), discarding" }
                 return
             }
 
@@ -2142,34 +2160,34 @@ class KotlinBLEBridge(
             if (peer == null) {
                 // Try resolving via identity (handles address changes after deduplication)
                 val identityHash = addressToIdentity[address]
-                Log.d(TAG, "[LAST_ACTIVITY] address=$address not in connectedPeers, identityHash=$identityHash")
+                RingLog.d(TAG) { "[LAST_ACTIVITY] address=$address not in connectedPeers, identityHash=$identityHash" }
                 if (identityHash != null) {
                     val currentAddress = identityToAddress[identityHash]
-                    Log.d(TAG, "[LAST_ACTIVITY] identity $identityHash -> currentAddress=$currentAddress")
+                    RingLog.d(TAG) { "[LAST_ACTIVITY] identity $identityHash -> currentAddress=$currentAddress" }
                     if (currentAddress != null) {
                         peer = connectedPeers[currentAddress]
                         resolvedAddress = currentAddress
-                        Log.d(TAG, "[LAST_ACTIVITY] resolved peer at $currentAddress: ${peer != null}")
+                        RingLog.d(TAG) { "[LAST_ACTIVITY] resolved peer at $currentAddress: ${peer != null}" }
                     }
                 }
             }
             if (peer != null) {
                 peer.lastActivity = System.currentTimeMillis()
-                Log.d(TAG, "[LAST_ACTIVITY] Updated lastActivity for $resolvedAddress")
+                RingLog.d(TAG) { "[LAST_ACTIVITY] Updated lastActivity for $resolvedAddress" }
             } else {
-                Log.w(TAG, "[LAST_ACTIVITY] Could not find peer for $address")
+                RingLog.w(TAG) { "[LAST_ACTIVITY] Could not find peer for $address" }
             }
 
-            Log.d(TAG, "Received ${fragment.size} byte fragment from $address")
+            RingLog.d(TAG) { "Received ${fragment.size} byte fragment from $address" }
 
             // Forward the raw fragment to the Python driver. Reassembly (HDLC framing,
             // out-of-order fragments) is handled inside `android_ble_driver.py` —
             // Kotlin just delivers what arrived on the wire under the routed address.
             runCatching {
                 onDataReceived?.callAttr("__call__", resolvedAddress, fragment)
-            }.onFailure { Log.w(TAG, "Python onDataReceived threw for $resolvedAddress: ${it.message}") }
+            }.onFailure { RingLog.w(TAG) { "Python onDataReceived threw for $resolvedAddress: ${it.message}" } }
         } catch (e: Exception) {
-            Log.e(TAG, "Error processing fragment from $address", e)
+            RingLog.e(TAG, e) { "Error processing fragment from $address" }
         }
     }
 
@@ -2191,7 +2209,7 @@ class KotlinBLEBridge(
         // This prevents race conditions when the same identity notification fires multiple times
         val dedupeKey = "$address:$identityHash"
         if (!processedIdentityCallbacks.add(dedupeKey)) {
-            Log.d(TAG, "Ignoring duplicate identity callback for $address ($identityHash)")
+            RingLog.d(TAG) { "Ignoring duplicate identity callback for $address ($identityHash)" }
             return
         }
 
@@ -2209,11 +2227,10 @@ class KotlinBLEBridge(
                 val isDuplicate = duplicateCallback.callAttr("__call__", address, identityBytes)
                     ?.toBoolean() == true
                 if (isDuplicate) {
-                    Log.w(
-                        TAG,
+                    RingLog.w(TAG) {
                         "Duplicate identity rejected for $address — identity ${identityHash.take(16)}… " +
-                            "already connected at different MAC (MAC rotation)",
-                    )
+                            "already connected at different MAC (MAC rotation)"
+                    }
                     scope.launch {
                         if (isCentralConnection) {
                             gattClient?.disconnect(address)
@@ -2226,7 +2243,7 @@ class KotlinBLEBridge(
                     return
                 }
             } catch (e: Exception) {
-                Log.w(TAG, "Error in duplicate-identity callback for $address: ${e.message}")
+                RingLog.w(TAG) { "Error in duplicate-identity callback for $address: ${e.message}" }
                 // Fall through to normal processing — a misbehaving callback
                 // shouldn't block the connection.
             }
@@ -2261,11 +2278,10 @@ class KotlinBLEBridge(
                         gattClient?.isConnected(existingAddress) == true
 
                 if (existingPeer?.isCentral == true && !existingActuallyHasCentral) {
-                    Log.w(
-                        TAG,
+                    RingLog.w(TAG) {
                         "Stale central connection detected for $existingAddress " +
-                            "(peer says central=true but GATT not connected)",
-                    )
+                            "(peer says central=true but GATT not connected)"
+                    }
                 }
 
                 val shouldUpdate =
@@ -2284,24 +2300,24 @@ class KotlinBLEBridge(
 
                 if (shouldUpdate) {
                     identityToAddress[identityHash] = address
-                    Log.d(TAG, "Updated identity→address mapping: $identityHash → $address (central=${peerAtNewAddress.isCentral})")
+                    RingLog.d(TAG) { "Updated identity→address mapping: $identityHash → $address (central=${peerAtNewAddress.isCentral})" }
 
                     if (existingAddress != null && existingAddress != address) {
                         // Python needs the old→new redirect so its
                         // `address_to_identity` map stays consistent and
                         // outbound writes route to the live MAC.
                         addressChangeNotification = Pair(existingAddress, address)
-                        Log.i(TAG, "Address changed for identity $identityHash: $existingAddress → $address (central=${peerAtNewAddress.isCentral})")
+                        RingLog.i(TAG) { "Address changed for identity $identityHash: $existingAddress → $address (central=${peerAtNewAddress.isCentral})" }
                     }
                 } else {
-                    Log.d(TAG, "Keeping existing identity→address mapping: $identityHash → $existingAddress (existing has live central)")
+                    RingLog.d(TAG) { "Keeping existing identity→address mapping: $identityHash → $existingAddress (existing has live central)" }
                     // DON'T send address change notification here!
                     // Python's on_device_connected already added address_to_identity for the new address.
                     // Sending a redirect (new → existing) would DELETE the new address mapping,
                     // preventing Python from receiving data from the new address.
                     // Python's peer_address already points to the central address (correct for sending).
                     if (existingAddress != null && existingAddress != address) {
-                        Log.d(TAG, "NOT notifying Python: $address already handled by on_device_connected, peer_address stays $existingAddress")
+                        RingLog.d(TAG) { "NOT notifying Python: $address already handled by on_device_connected, peer_address stays $existingAddress" }
                     }
                 }
             } else {
@@ -2310,9 +2326,9 @@ class KotlinBLEBridge(
                 val existingPeer = existingAddress?.let { connectedPeers[it] }
                 if (existingPeer == null) {
                     identityToAddress[identityHash] = address
-                    Log.d(TAG, "Set identity→address mapping: $identityHash → $address (no existing peer)")
+                    RingLog.d(TAG) { "Set identity→address mapping: $identityHash → $address (no existing peer)" }
                 } else {
-                    Log.d(TAG, "Identity $identityHash already mapped to $existingAddress with valid peer, not overwriting with $address")
+                    RingLog.d(TAG) { "Identity $identityHash already mapped to $existingAddress with valid peer, not overwriting with $address" }
                 }
             }
 
@@ -2324,10 +2340,10 @@ class KotlinBLEBridge(
             // Check for pending connection that was waiting for identity
             completedPending = pendingConnections.remove(address)
             if (completedPending != null) {
-                Log.d(TAG, "Completing pending connection for $address - identity now available")
+                RingLog.d(TAG) { "Completing pending connection for $address - identity now available" }
             }
 
-            Log.i(TAG, "Identity received from $address: $identityHash (isCentral=$isCentralConnection)")
+            RingLog.i(TAG) { "Identity received from $address: $identityHash (isCentral=$isCentralConnection)" }
         }
 
         // Fire deferred onConnected for connections that were waiting for identity.
@@ -2335,13 +2351,12 @@ class KotlinBLEBridge(
         // mutated between pendingConnections capture and now, e.g. dual-connection).
         completedPending?.let { pending ->
             val currentPeer = connectedPeers[address]
-            Log.d(
-                TAG,
+            RingLog.d(TAG) {
                 "Completing deferred connection notification for $address " +
                     "(identity=${identityHash.take(16)}…, " +
                     "central=${currentPeer?.isCentral ?: pending.isCentral}, " +
-                    "peripheral=${currentPeer?.isPeripheral ?: pending.isPeripheral})",
-            )
+                    "peripheral=${currentPeer?.isPeripheral ?: pending.isPeripheral})"
+            }
             notifyPythonConnected(
                 address = pending.address,
                 mtu = currentPeer?.mtu ?: pending.mtu,
@@ -2355,7 +2370,7 @@ class KotlinBLEBridge(
         // map indexes on this, and downstream routing depends on it being current.
         runCatching {
             onIdentityReceived?.callAttr("__call__", address, identityHash)
-        }.onFailure { Log.w(TAG, "Python onIdentityReceived threw for $address: ${it.message}") }
+        }.onFailure { RingLog.w(TAG) { "Python onIdentityReceived threw for $address: ${it.message}" } }
 
         // Android can request a larger ATT MTU only as GATT client. Require a
         // completed inbound identity handshake before connecting back, so an
@@ -2368,13 +2383,12 @@ class KotlinBLEBridge(
         // when the identity→address mapping actually moved (set inside the mutex
         // section above); a no-op for first-seen identities.
         addressChangeNotification?.let { (oldAddress, newAddress) ->
-            Log.d(
-                TAG,
-                "Notifying Python of MAC rotation: $oldAddress → $newAddress (identity=${identityHash.take(16)}…)",
-            )
+            RingLog.d(TAG) {
+                "Notifying Python of MAC rotation: $oldAddress → $newAddress (identity=${identityHash.take(16)}…)"
+            }
             runCatching {
                 onAddressChanged?.callAttr("__call__", oldAddress, newAddress, identityHash)
-            }.onFailure { Log.w(TAG, "Python onAddressChanged threw for $oldAddress→$newAddress: ${it.message}") }
+            }.onFailure { RingLog.w(TAG) { "Python onAddressChanged threw for $oldAddress→$newAddress: ${it.message}" } }
         }
     }
 
@@ -2385,7 +2399,7 @@ class KotlinBLEBridge(
     private suspend fun handleAdapterStateChange(state: Int) {
         when (state) {
             BluetoothAdapter.STATE_OFF, BluetoothAdapter.STATE_TURNING_OFF -> {
-                Log.w(TAG, "Bluetooth disabled - clearing all connections")
+                RingLog.w(TAG) { "Bluetooth disabled - clearing all connections" }
                 // Immediately clear all connections since they're invalid
                 connectedPeers.keys.toList().forEach { address ->
                     handlePeerDisconnected(address, isCentral = true)
@@ -2403,21 +2417,21 @@ class KotlinBLEBridge(
                 stopAdvertising()
             }
             BluetoothAdapter.STATE_ON -> {
-                Log.i(TAG, "Bluetooth enabled - auto-restarting BLE interface")
+                RingLog.i(TAG) { "Bluetooth enabled - auto-restarting BLE interface" }
                 if (isStarted) {
                     // Auto-restart scanning and advertising
                     storedServiceUuid?.let { serviceUuid ->
-                        Log.d(TAG, "Restarting scanner...")
+                        RingLog.d(TAG) { "Restarting scanner..." }
                         startScanning().onFailure { error ->
-                            Log.e(TAG, "Failed to restart scanner: ${error.message}")
+                            RingLog.e(TAG) { "Failed to restart scanner: ${error.message}" }
                         }
 
                         // Restart advertising if we have identity
                         if (transportIdentityHash != null) {
                             val deviceName = storedDeviceName ?: "Reticulum"
-                            Log.d(TAG, "Restarting advertising with name '$deviceName'...")
+                            RingLog.d(TAG) { "Restarting advertising with name '$deviceName'..." }
                             startAdvertising(deviceName).onFailure { error ->
-                                Log.e(TAG, "Failed to restart advertising: ${error.message}")
+                                RingLog.e(TAG) { "Failed to restart advertising: ${error.message}" }
                             }
                         }
                     }
@@ -2455,41 +2469,41 @@ class KotlinBLEBridge(
      */
     fun stopImmediate() {
         if (!isStarted) {
-            Log.d(TAG, "stopImmediate: already stopped")
+            RingLog.d(TAG) { "stopImmediate: already stopped" }
             return
         }
 
-        Log.i(TAG, "Stopping BLE bridge immediately (forced shutdown)")
+        RingLog.i(TAG) { "Stopping BLE bridge immediately (forced shutdown)" }
 
         try {
             scanner?.stopImmediate()
         } catch (e: Exception) {
-            Log.e(TAG, "Error in scanner stopImmediate", e)
+            RingLog.e(TAG, e) { "Error in scanner stopImmediate" }
         }
 
         try {
             advertiser?.stopImmediate()
         } catch (e: Exception) {
-            Log.e(TAG, "Error in advertiser stopImmediate", e)
+            RingLog.e(TAG, e) { "Error in advertiser stopImmediate" }
         }
 
         try {
             gattServer?.closeImmediate()
         } catch (e: Exception) {
-            Log.e(TAG, "Error in gattServer closeImmediate", e)
+            RingLog.e(TAG, e) { "Error in gattServer closeImmediate" }
         }
 
         try {
             gattClient?.closeImmediate()
         } catch (e: Exception) {
-            Log.e(TAG, "Error in gattClient closeImmediate", e)
+            RingLog.e(TAG, e) { "Error in gattClient closeImmediate" }
         }
 
         // Cancel scope (kills all pending coroutines)
         try {
             scope.cancel()
         } catch (e: Exception) {
-            Log.e(TAG, "Error cancelling scope", e)
+            RingLog.e(TAG, e) { "Error cancelling scope" }
         }
 
         // Unregister Bluetooth state receiver
@@ -2498,7 +2512,7 @@ class KotlinBLEBridge(
                 context.unregisterReceiver(bluetoothStateReceiver)
                 isReceiverRegistered = false
             } catch (e: Exception) {
-                Log.w(TAG, "Error unregistering receiver in stopImmediate", e)
+                RingLog.w(TAG, e) { "Error unregistering receiver in stopImmediate" }
             }
         }
 
@@ -2511,11 +2525,11 @@ class KotlinBLEBridge(
             processedIdentityCallbacks.clear()
             pendingCentralConnections.clear()
         } catch (e: Exception) {
-            Log.e(TAG, "Error clearing state in stopImmediate", e)
+            RingLog.e(TAG, e) { "Error clearing state in stopImmediate" }
         }
 
         isStarted = false
-        Log.i(TAG, "BLE bridge stopped immediately")
+        RingLog.i(TAG) { "BLE bridge stopped immediately" }
     }
 
     /**
@@ -2553,13 +2567,12 @@ class KotlinBLEBridge(
         scanner?.updatePowerSettings(powerSettings)
         advertiser?.updatePowerSettings(powerSettings)
 
-        Log.i(
-            TAG,
+        RingLog.i(TAG) {
             "Power settings configured: preset=$preset, " +
                 "discovery=${powerSettings.discoveryIntervalMs}ms, " +
                 "idle=${powerSettings.discoveryIntervalIdleMs}ms, " +
                 "scanDuration=${powerSettings.scanDurationMs}ms, " +
-                "adRefresh=${powerSettings.advertisingRefreshIntervalMs}ms",
-        )
+                "adRefresh=${powerSettings.advertisingRefreshIntervalMs}ms"
+        }
     }
 }
@@ -309,6 +309,7 @@ class BleGattClient(
                     connData.gatt.disconnect()
                     connData.gatt.close()
                 }
+                operationQueue.releaseConnection(address)
                 Log.d(TAG, "Disconnected from $address (manual)")
                 onDisconnected?.invoke(address, null)
             }
@@ -483,6 +484,9 @@ class BleGattClient(
                         "Error (status: $status)"
                     }
 
+                // Fail anything still queued for this peer instead of letting it time out
+                operationQueue.releaseConnection(address)
+
                 // Check if this was a manual disconnect (callback will be fired by disconnect())
                 val isManualDisconnect =
                     manualDisconnectsMutex.withLock {
@@ -531,6 +535,7 @@ class BleGattClient(
 
             onConnectionFailed?.invoke(address, "Service discovery failed (status: $status)")
             operationQueue.completeOperationByKey(
+                address,
                 "services",
                 BleOperationQueue.OperationResult.Failure(Exception("Service discovery failed: $status")),
             )
@@ -553,6 +558,7 @@ class BleGattClient(
 
             onConnectionFailed?.invoke(address, "Reticulum service not found")
             operationQueue.completeOperationByKey(
+                address,
                 "services",
                 BleOperationQueue.OperationResult.Failure(Exception("Reticulum service not found")),
             )
@@ -578,6 +584,7 @@ class BleGattClient(
 
             onConnectionFailed?.invoke(address, "Required characteristics not found")
             operationQueue.completeOperationByKey(
+                address,
                 "services",
                 BleOperationQueue.OperationResult.Failure(Exception("Required characteristics not found")),
             )
@@ -595,7 +602,7 @@ class BleGattClient(
         Log.d(TAG, "Services discovered on $address, reading identity...")
 
         // Complete service discovery operation successfully
-        operationQueue.completeOperationByKey("services", BleOperationQueue.OperationResult.Success())
+        operationQueue.completeOperationByKey(address, "services", BleOperationQueue.OperationResult.Success())
 
         // Read identity characteristic (if available)
         if (identityChar != null) {
@@ -697,7 +704,7 @@ class BleGattClient(
             onMtuChanged?.invoke(address, usableMtu)
 
             // Complete MTU operation in queue
-            operationQueue.completeOperationByKey("mtu", BleOperationQueue.OperationResult.Success())
+            operationQueue.completeOperationByKey(address, "mtu", BleOperationQueue.OperationResult.Success())
         } else {
             // No successful exchange means the link remains at the mandatory
             // ATT 23 / characteristic-value 20 fallback. Do not guess 185.
@@ -711,7 +718,7 @@ class BleGattClient(
             onMtuChanged?.invoke(address, fallbackMtu)
 
             // Mark as success (not failure) so connection continues with fallback MTU
-            operationQueue.completeOperationByKey("mtu", BleOperationQueue.OperationResult.Success())
+            operationQueue.completeOperationByKey(address, "mtu", BleOperationQueue.OperationResult.Success())
         }
 
         // Enable notifications on TX characteristic
@@ -875,10 +882,11 @@ class BleGattClient(
         if (status == BluetoothGatt.GATT_SUCCESS) {
             Log.v(TAG, "Write successful to $address")
             // Complete operation in queue
-            operationQueue.completeOperationByKey("write", BleOperationQueue.OperationResult.Success())
+            operationQueue.completeOperationByKey(address, "write", BleOperationQueue.OperationResult.Success())
         } else {
             Log.e(TAG, "Write failed to $address (status: $status)")
             operationQueue.completeOperationByKey(
+                address,
                 "write",
                 BleOperationQueue.OperationResult.Failure(Exception("Write failed: $status")),
             )
@@ -909,7 +917,7 @@ class BleGattClient(
                     onIdentityReceived?.invoke(address, identityHash)
 
                     // Complete operation and continue with MTU negotiation
-                    operationQueue.completeOperationByKey("read", BleOperationQueue.OperationResult.Success())
+                    operationQueue.completeOperationByKey(address, "read", BleOperationQueue.OperationResult.Success())
 
                     Log.i(TAG, ">>> IDENTITY READ COMPLETE for $address - proceeding to MTU negotiation")
 
@@ -926,6 +934,7 @@ class BleGattClient(
                     Log.w(TAG, "    Received: ${value.size} bytes")
                     Log.w(TAG, "    Falling back to MAC-based tracking...")
                     operationQueue.completeOperationByKey(
+                        address,
                         "read",
                         BleOperationQueue.OperationResult.Failure(
                             Exception("Invalid identity size: ${value.size}"),
@@ -939,7 +948,7 @@ class BleGattClient(
                 }
             } else {
                 Log.v(TAG, "Read successful from $address for characteristic ${characteristic.uuid}")
-                operationQueue.completeOperationByKey("read", BleOperationQueue.OperationResult.Success())
+                operationQueue.completeOperationByKey(address, "read", BleOperationQueue.OperationResult.Success())
             }
         } else {
             if (characteristic.uuid == BleConstants.CHARACTERISTIC_IDENTITY_UUID) {
@@ -954,6 +963,7 @@ class BleGattClient(
             }
 
             operationQueue.completeOperationByKey(
+                address,
                 "read",
                 BleOperationQueue.OperationResult.Failure(Exception("Read failed: $status")),
             )
@@ -982,7 +992,7 @@ class BleGattClient(
     ) {
         if (status == BluetoothGatt.GATT_SUCCESS) {
             Log.v(TAG, "Descriptor write successful for $address")
-            operationQueue.completeOperationByKey("descriptor", BleOperationQueue.OperationResult.Success())
+            operationQueue.completeOperationByKey(address, "descriptor", BleOperationQueue.OperationResult.Success())
         } else {
             val errorMsg =
                 when (status) {
@@ -996,6 +1006,7 @@ class BleGattClient(
             Log.e(TAG, "Descriptor write failed for $address: $errorMsg (status: $status)")
             Log.e(TAG, "  Descriptor UUID: ${descriptor.uuid}")
             operationQueue.completeOperationByKey(
+                address,
                 "descriptor",
                 BleOperationQueue.OperationResult.Failure(Exception("Descriptor write failed: $errorMsg")),
             )
@@ -1012,6 +1023,7 @@ class BleGattClient(
             Log.v(TAG, "Descriptor read successful for $address: ${value.size} bytes")
             Log.v(TAG, "  Descriptor UUID: ${descriptor.uuid}")
             operationQueue.completeOperationByKey(
+                address,
                 "descriptor_read",
                 BleOperationQueue.OperationResult.Success(value),
             )
@@ -1027,6 +1039,7 @@ class BleGattClient(
             Log.e(TAG, "Descriptor read failed for $address: $errorMsg (status: $status)")
             Log.e(TAG, "  Descriptor UUID: ${descriptor.uuid}")
             operationQueue.completeOperationByKey(
+                address,
                 "descriptor_read",
                 BleOperationQueue.OperationResult.Failure(Exception("Descriptor read failed: $errorMsg")),
             )
@@ -12,6 +12,7 @@ import android.content.Context
 import android.content.pm.PackageManager
 import android.os.Build
 import android.os.ParcelUuid
+import android.os.SystemClock
 import android.util.Log
 import androidx.core.content.ContextCompat
 import network.columba.app.rns.host.ble.model.BleConstants
@@ -39,9 +40,15 @@ import kotlinx.coroutines.withContext
  * - Start with frequent scanning (5s intervals) when discovering new devices
  * - Back off to infrequent scanning (30s intervals) when environment is stable
  * - Respect Android's scan frequency limits (5 scans per 30 seconds)
- * - Filter for Reticulum service UUID
+ * - Filter for Reticulum service UUID (in the controller, where offloaded)
  * - Track discovered devices with RSSI updates
  *
+ * Results are delivered per [ScanDeliveryPolicy]: batched by the controller
+ * while discovering, FIRST_MATCH / MATCH_LOST tracking once idle, and one
+ * callback per advertisement only on controllers that offload neither.
+ * Devices are kept in a [ScannedDeviceIndex], so [getDevicesSortedByPriority]
+ * doesn't re-sort.
+ *
  * Note: Permission checks are performed at UI layer before BLE operations are initiated.
  *
  * @property context Application context
@@ -59,6 +66,10 @@ class BleScanner(
         private const val TAG = "Columba:BLE:K:Scan"
         private const val NEW_DEVICE_THRESHOLD = 3
         private const val IDLE_SCANS_THRESHOLD = 3
+
+        // Batches delivered per scan window in BATCHED mode; the rest is flushed at stop
+        private const val BATCHES_PER_SCAN = 2
+        private const val MIN_REPORT_DELAY_MS = 1000L
     }
 
     // Power-tunable scan intervals (defaults from BleConstants)
@@ -92,7 +103,16 @@ class BleScanner(
     val discoveredDevices: StateFlow<Map<String, BleDevice>> = _discoveredDevices.asStateFlow()
 
     private val devicesMutex = Mutex()
-    private val devices = java.util.concurrent.ConcurrentHashMap<String, BleDevice>()
+    private val devices = ScannedDeviceIndex()
+
+    private val deliveryPolicy =
+        ScanDeliveryPolicy(
+            batchingSupported = bluetoothAdapter.isOffloadedScanBatchingSupported,
+            trackingSupported = bluetoothAdapter.isOffloadedFilteringSupported,
+        )
+
+    @Volatile
+    private var currentDelivery = ScanDelivery.IMMEDIATE
 
     // Smart polling state
     private var scanJob: Job? = null
@@ -117,18 +137,27 @@ class BleScanner(
                 callbackType: Int,
                 result: ScanResult,
             ) {
+                val sighting = result.toSighting(lost = callbackType == ScanSettings.CALLBACK_TYPE_MATCH_LOST)
                 scope.launch {
-                    handleScanResult(result)
+                    handleSightings(listOf(sighting))
                 }
             }
 
             override fun onBatchScanResults(results: List<ScanResult>) {
+                val sightings = results.map { it.toSighting(lost = false) }
                 scope.launch {
-                    results.forEach { handleScanResult(it) }
+                    handleSightings(sightings)
                 }
             }
 
             override fun onScanFailed(errorCode: Int) {
+                val delivery = currentDelivery
+                if (deliveryPolicy.onScanFailed(delivery, errorCode)) {
+                    // Next scan falls back; not a failure the connection manager needs to hear about
+                    Log.w(TAG, "Controller refused $delivery scan (error $errorCode), falling back")
+                    _isScanning.value = false
+                    return
+                }
                 Log.e(TAG, "BLE scan failed with error code: $errorCode")
                 scope.launch {
                     _isScanning.value = false
@@ -260,15 +289,9 @@ class BleScanner(
                         .build()
 
                 // Configure scan settings
-                val scanSettings =
-                    ScanSettings
-                        .Builder()
-                        .setScanMode(determineScanMode())
-                        .setCallbackType(ScanSettings.CALLBACK_TYPE_ALL_MATCHES)
-                        .setMatchMode(ScanSettings.MATCH_MODE_AGGRESSIVE)
-                        .setNumOfMatches(ScanSettings.MATCH_NUM_MAX_ADVERTISEMENT)
-                        .setReportDelay(0) // Report immediately
-                        .build()
+                val delivery = deliveryPolicy.choose(idle = scansWithoutNewDevices >= IDLE_SCANS_THRESHOLD)
+                val scanSettings = buildScanSettings(delivery)
+                currentDelivery = delivery
 
                 // Reset new devices counter
                 newDevicesInLastScan = 0
@@ -280,13 +303,16 @@ class BleScanner(
                 Log.d(
                     TAG,
                     "Started scan (interval: ${currentScanInterval}ms, " +
-                        "mode: ${determineScanMode()}, minRssi: $minRssi)",
+                        "mode: ${determineScanMode()}, delivery: $delivery, minRssi: $minRssi)",
                 )
 
                 // Scan for fixed duration
                 delay(scanDurationMs)
 
-                // Stop scan
+                // Stop scan, collecting whatever the controller still holds
+                if (delivery == ScanDelivery.BATCHED) {
+                    scanner.flushPendingScanResults(scanCallback)
+                }
                 scanner.stopScan(scanCallback)
                 _isScanning.value = false
 
@@ -305,57 +331,63 @@ class BleScanner(
         }
     }
 
-    /**
-     * Handle a scan result (device discovered or updated).
-     */
-    private suspend fun handleScanResult(result: ScanResult) {
-        val device = result.device
-        val rssi = result.rssi
-        val address = device.address
-        val name = result.scanRecord?.deviceName ?: device.name
-
-        // Ignore devices below RSSI threshold
-        if (rssi < BleConstants.MIN_RSSI_DBM) {
-            return
+    private fun buildScanSettings(delivery: ScanDelivery): ScanSettings {
+        val builder =
+            ScanSettings
+                .Builder()
+                .setScanMode(determineScanMode())
+                .setMatchMode(ScanSettings.MATCH_MODE_AGGRESSIVE)
+        when (delivery) {
+            ScanDelivery.BATCHED ->
+                builder
+                    .setCallbackType(ScanSettings.CALLBACK_TYPE_ALL_MATCHES)
+                    .setNumOfMatches(ScanSettings.MATCH_NUM_MAX_ADVERTISEMENT)
+                    .setReportDelay(maxOf(MIN_REPORT_DELAY_MS, scanDurationMs / BATCHES_PER_SCAN))
+            ScanDelivery.MATCH_TRACKING ->
+                builder
+                    .setCallbackType(ScanSettings.CALLBACK_TYPE_FIRST_MATCH or ScanSettings.CALLBACK_TYPE_MATCH_LOST)
+                    .setNumOfMatches(ScanSettings.MATCH_NUM_ONE_ADVERTISEMENT)
+                    .setReportDelay(0)
+            ScanDelivery.IMMEDIATE ->
+                builder
+                    .setCallbackType(ScanSettings.CALLBACK_TYPE_ALL_MATCHES)
+                    .setNumOfMatches(ScanSettings.MATCH_NUM_MAX_ADVERTISEMENT)
+                    .setReportDelay(0) // Report immediately
         }
+        return builder.build()
+    }
 
+    private fun ScanResult.toSighting(lost: Boolean): ScanSighting {
+        // Batched results can be up to a report delay old; date them by when they were heard
+        val ageMs = ((SystemClock.elapsedRealtimeNanos() - timestampNanos) / 1_000_000).coerceAtLeast(0)
+        return ScanSighting(
+            address = device.address,
+            name = scanRecord?.deviceName ?: device.name,
+            rssi = rssi,
+            seenAtMs = System.currentTimeMillis() - ageMs,
+            serviceUuids = scanRecord?.serviceUuids?.map { it.uuid.toString() },
+            lost = lost,
+        )
+    }
+
+    /**
+     * Apply a scan callback's sightings (one advertisement, or a whole batch)
+     * under one lock, and publish [discoveredDevices] once for all of them.
+     */
+    private suspend fun handleSightings(sightings: List<ScanSighting>) {
         // Protocol v2.2: Identity is read from GATT Identity characteristic during handshake,
         // not from device name. Device name may contain identity for human readability.
 
         devicesMutex.withLock {
-            val existingDevice = devices[address]
-
-            if (existingDevice == null) {
-                val serviceUuids = result.scanRecord?.serviceUuids?.map { it.uuid.toString() }
-                // New device discovered
-                val bleDevice =
-                    BleDevice(
-                        address = address,
-                        name = name,
-                        rssi = rssi,
-                        serviceUuids = serviceUuids,
-                        identityHash = null, // Identity read from GATT characteristic, not device name
-                    )
-                devices[address] = bleDevice
-                newDevicesInLastScan++
-
-                Log.d(TAG, "Discovered new device: $address ($name) RSSI: $rssi dBm")
-                onDeviceDiscovered?.invoke(bleDevice)
-            } else {
-                // Update existing device
-                val updated =
-                    existingDevice.copy(
-                        rssi = rssi,
-                        lastSeen = System.currentTimeMillis(),
-                    )
-                devices[address] = updated
+            val update = devices.apply(sightings)
+            if (!update.changed) return
 
-                Log.v(
-                    TAG,
-                    "Updated device: $address RSSI: $rssi dBm " +
-                        "(was ${existingDevice.rssi} dBm)",
-                )
+            newDevicesInLastScan += update.discovered.size
+            update.discovered.forEach { device ->
+                Log.d(TAG, "Discovered new device: ${device.address} (${device.name}) RSSI: ${device.rssi} dBm")
+                onDeviceDiscovered?.invoke(device)
             }
+            update.lost.forEach { address -> Log.d(TAG, "Lost device: $address (will be rediscovered)") }
 
             // Update state flow
             _discoveredDevices.value = devices.toMap()
@@ -428,17 +460,16 @@ class BleScanner(
      */
     suspend fun getDevicesSortedByPriority(): List<BleDevice> =
         devicesMutex.withLock {
-            devices.values.sortedByDescending { it.calculatePriorityScore() }
+            devices.sortedByPriority()
         }
 
     /**
      * Get a snapshot of discovered devices as a map (address -> device).
      * Thread-safe synchronous access for use in AIDL/IPC contexts.
      *
-     * Note: This creates a copy of the devices map. For best performance,
-     * prefer getDevicesSortedByPriority() in coroutine contexts.
+     * Returns the last published [discoveredDevices] map; no copy is made.
      */
-    fun getDevicesSnapshot(): Map<String, BleDevice> = devices.toMap()
+    fun getDevicesSnapshot(): Map<String, BleDevice> = _discoveredDevices.value
 
     /**
      * Clear discovered devices.
@@ -461,7 +492,7 @@ class BleScanner(
      */
     suspend fun removeDevice(address: String) {
         devicesMutex.withLock {
-            if (devices.remove(address) != null) {
+            if (devices.remove(address)) {
                 _discoveredDevices.value = devices.toMap()
                 Log.d(TAG, "Removed device from cache: $address (will be rediscovered)")
             }
@@ -0,0 +1,85 @@
+package network.columba.app.rns.host.ble.client
+
+import android.bluetooth.le.ScanCallback
+
+/**
+ * How a scan hands its results to the app.
+ */
+enum class ScanDelivery {
+    /**
+     * The controller buffers matches and delivers them in batches
+     * (`setReportDelay` > 0, `onBatchScanResults`): one wakeup per batch
+     * instead of per advertisement, RSSI still refreshed.
+     */
+    BATCHED,
+
+    /**
+     * The controller tracks matches itself and reports each device once
+     * when it appears (CALLBACK_TYPE_FIRST_MATCH) and once when it goes
+     * quiet (CALLBACK_TYPE_MATCH_LOST). Fewest wakeups; RSSI is refreshed
+     * once per scan.
+     */
+    MATCH_TRACKING,
+
+    /** Every advertisement is delivered as it arrives (`setReportDelay(0)`). */
+    IMMEDIATE,
+}
+
+/**
+ * Picks a [ScanDelivery] for each scan from what the controller offloads,
+ * and falls back when the controller refuses a mode it claimed to support.
+ *
+ * While new devices are turning up the scanner wants fresh RSSI for every
+ * device, so it batches. Once the environment is idle only arrivals and
+ * departures matter, so it tracks matches. Either mode falls back to the
+ * other, then to [ScanDelivery.IMMEDIATE].
+ *
+ * @param batchingSupported `BluetoothAdapter.isOffloadedScanBatchingSupported`
+ * @param trackingSupported `BluetoothAdapter.isOffloadedFilteringSupported`;
+ *                          hardware tracking may still be refused at scan start
+ */
+class ScanDeliveryPolicy(
+    batchingSupported: Boolean,
+    trackingSupported: Boolean,
+) {
+    @Volatile
+    private var batching = batchingSupported
+
+    @Volatile
+    private var tracking = trackingSupported
+
+    fun choose(idle: Boolean): ScanDelivery =
+        when {
+            idle && tracking -> ScanDelivery.MATCH_TRACKING
+            batching -> ScanDelivery.BATCHED
+            tracking -> ScanDelivery.MATCH_TRACKING
+            else -> ScanDelivery.IMMEDIATE
+        }
+
+    /**
+     * A scan started with [delivery] failed with [errorCode]. If the failure
+     * means the controller can't do that mode, stop choosing it and return
+     * true; the next scan uses a fallback. Returns false for failures a
+     * fallback wouldn't fix, and for [ScanDelivery.IMMEDIATE].
+     */
+    fun onScanFailed(
+        delivery: ScanDelivery,
+        errorCode: Int,
+    ): Boolean {
+        val modeRefused =
+            errorCode == ScanCallback.SCAN_FAILED_FEATURE_UNSUPPORTED ||
+                errorCode == ScanCallback.SCAN_FAILED_OUT_OF_HARDWARE_RESOURCES
+        if (!modeRefused) return false
+        return when (delivery) {
+            ScanDelivery.BATCHED -> {
+                batching = false
+                true
+            }
+            ScanDelivery.MATCH_TRACKING -> {
+                tracking = false
+                true
+            }
+            ScanDelivery.IMMEDIATE -> false
+        }
+    }
+}
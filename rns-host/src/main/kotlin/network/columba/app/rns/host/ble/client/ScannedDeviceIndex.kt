@@ -0,0 +1,145 @@
+package network.columba.app.rns.host.ble.client
+
+import network.columba.app.rns.host.ble.model.BleConstants
+import network.columba.app.rns.host.ble.model.BleDevice
+import java.util.TreeSet
+
+/**
+ * One advertisement (or one MATCH_LOST report) as the scanner saw it,
+ * independent of the platform `ScanResult`.
+ *
+ * @property seenAtMs Wall-clock time of the advertisement. For batched
+ *                    results this is when the controller heard it, not when
+ *                    the batch was delivered.
+ * @property lost The controller reported the device gone (CALLBACK_TYPE_MATCH_LOST)
+ */
+data class ScanSighting(
+    val address: String,
+    val name: String?,
+    val rssi: Int,
+    val seenAtMs: Long,
+    val serviceUuids: List<String>? = null,
+    val lost: Boolean = false,
+)
+
+/**
+ * Discovered devices keyed by address, kept in priority order as sightings
+ * arrive so that [sortedByPriority] doesn't re-sort on every call.
+ *
+ * Each sighting moves one device within a [TreeSet] ordered by
+ * [BleDevice.priorityRank], which is O(log n). Ranks are taken as of one
+ * reference time, and [sortedByPriority] re-ranks everything once the
+ * reference is [RERANK_INTERVAL_MS] old, so the order never drifts more than
+ * one recency point from [BleDevice.calculatePriorityScore].
+ *
+ * Not thread-safe; [BleScanner] guards it with its devices mutex.
+ */
+internal class ScannedDeviceIndex(
+    private val minRssi: Int = BleConstants.MIN_RSSI_DBM,
+) {
+    companion object {
+        // Ten seconds of age is one point of the score's recency bonus
+        const val RERANK_INTERVAL_MS = 10_000L
+    }
+
+    /** What one [apply] call changed. */
+    data class Update(
+        val discovered: List<BleDevice>,
+        val lost: List<String>,
+        val changed: Boolean,
+    )
+
+    private class Ranked(
+        val device: BleDevice,
+        val rank: Double,
+    )
+
+    private val byAddress = HashMap<String, Ranked>()
+    private val order =
+        TreeSet<Ranked>(compareByDescending<Ranked> { it.rank }.thenBy { it.device.address })
+
+    private var rankedAtMs = System.currentTimeMillis()
+
+    val size: Int get() = byAddress.size
+
+    operator fun get(address: String): BleDevice? = byAddress[address]?.device
+
+    /**
+     * Apply [sightings] in order. Sightings below the RSSI threshold are
+     * ignored, and a sighting older than the one already recorded for that
+     * device doesn't change it. MATCH_LOST drops the device, so it is reported
+     * as discovered again when it comes back.
+     */
+    fun apply(sightings: List<ScanSighting>): Update {
+        val discovered = mutableListOf<BleDevice>()
+        val lost = mutableListOf<String>()
+        var changed = false
+
+        for (sighting in sightings) {
+            if (sighting.lost) {
+                if (remove(sighting.address)) {
+                    lost.add(sighting.address)
+                    changed = true
+                }
+                continue
+            }
+            if (sighting.rssi < minRssi) continue
+
+            val existing = byAddress[sighting.address]?.device
+            if (existing == null) {
+                // Identity is read from the GATT characteristic, never from the advertisement
+                val device =
+                    BleDevice(
+                        address = sighting.address,
+                        name = sighting.name,
+                        rssi = sighting.rssi,
+                        serviceUuids = sighting.serviceUuids,
+                        identityHash = null,
+                        firstSeen = sighting.seenAtMs,
+                        lastSeen = sighting.seenAtMs,
+                    )
+                put(device)
+                discovered.add(device)
+                changed = true
+            } else if (sighting.seenAtMs >= existing.lastSeen) {
+                put(existing.copy(rssi = sighting.rssi, lastSeen = sighting.seenAtMs))
+                changed = true
+            }
+        }
+        return Update(discovered, lost, changed)
+    }
+
+    /** Insert or replace [device]. */
+    fun put(device: BleDevice) {
+        byAddress.remove(device.address)?.let { order.remove(it) }
+        val ranked = Ranked(device, device.priorityRank(minRssi, rankedAtMs))
+        byAddress[device.address] = ranked
+        order.add(ranked)
+    }
+
+    fun remove(address: String): Boolean {
+        val ranked = byAddress.remove(address) ?: return false
+        order.remove(ranked)
+        return true
+    }
+
+    fun clear() {
+        byAddress.clear()
+        order.clear()
+    }
+
+    /** Devices, highest priority first, as of [nowMs]. */
+    fun sortedByPriority(nowMs: Long = System.currentTimeMillis()): List<BleDevice> {
+        if (nowMs - rankedAtMs >= RERANK_INTERVAL_MS) rerank(nowMs)
+        return order.map { it.device }
+    }
+
+    private fun rerank(nowMs: Long) {
+        rankedAtMs = nowMs
+        val devices = byAddress.values.map { it.device }
+        clear()
+        devices.forEach(::put)
+    }
+
+    fun toMap(): Map<String, BleDevice> = byAddress.mapValues { it.value.device }
+}
@@ -220,4 +220,27 @@ object BleConstants {
      * Keepalive packets keep the connection alive during idle periods.
      */
     const val CONNECTION_KEEPALIVE_INTERVAL_MS = 15000L // 15 seconds
+
+    // Peripheral Notification Flow Control
+    /**
+     * Maximum notifications queued per central before senders suspend.
+     * Bounds memory per slow central and pushes backpressure up to the bridge.
+     */
+    const val NOTIFY_QUEUE_DEPTH = 32
+
+    /**
+     * How long to wait for onNotificationSent before sending the next notification.
+     * Some stacks never report it; this keeps a lost callback from stalling the queue.
+     */
+    const val NOTIFY_SENT_TIMEOUT_MS = 1000L
+
+    /**
+     * Retries when the stack reports ERROR_GATT_WRITE_REQUEST_BUSY for a notification.
+     */
+    const val NOTIFY_BUSY_MAX_RETRIES = 3
+
+    /**
+     * Delay between busy retries in milliseconds.
+     */
+    const val NOTIFY_BUSY_RETRY_DELAY_MS = 20L
 }
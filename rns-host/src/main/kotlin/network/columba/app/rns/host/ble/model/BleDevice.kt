@@ -53,7 +53,22 @@ data class BleDevice(
      * @param minRssi Minimum RSSI threshold (typically -85 dBm)
      * @return Score from 0-145, higher is better
      */
-    fun calculatePriorityScore(minRssi: Int = -85): Double {
+    fun calculatePriorityScore(minRssi: Int = -85): Double = priorityRank(minRssi, System.currentTimeMillis())
+
+    /**
+     * [calculatePriorityScore] as of [referenceMs] rather than now, for keeping
+     * devices in a sorted index that is only re-ranked now and then.
+     *
+     * Recency is capped to the same 0-25 points as the score, so a device
+     * sighted after [referenceMs] gets the full bonus rather than more.
+     *
+     * @param minRssi Minimum RSSI threshold (typically -85 dBm)
+     * @param referenceMs Wall-clock time the device's age is measured from
+     */
+    fun priorityRank(
+        minRssi: Int = -85,
+        referenceMs: Long,
+    ): Double {
         // RSSI component (60% weight, 0-70 points)
         val rssiNormalized = (rssi - minRssi).toDouble() / (0 - minRssi)
         val rssiScore = rssiNormalized * 70
@@ -62,8 +77,8 @@ data class BleDevice(
         val historyScore = getSuccessRate() * 50
 
         // Recency bonus (10% weight, 0-25 points)
-        val ageSeconds = (System.currentTimeMillis() - lastSeen) / 1000.0
-        val recencyScore = maxOf(0.0, 25 - (ageSeconds / 10))
+        val ageSeconds = (referenceMs - lastSeen) / 1000.0
+        val recencyScore = (25 - (ageSeconds / 10)).coerceIn(0.0, 25.0)
 
         return rssiScore + historyScore + recencyScore
     }
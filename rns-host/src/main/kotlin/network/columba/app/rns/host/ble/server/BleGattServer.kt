@@ -15,6 +15,8 @@ import android.bluetooth.BluetoothProfile
 import android.content.Context
 import android.content.pm.PackageManager
 import android.os.Build
+import android.os.Handler
+import android.os.HandlerThread
 import android.util.Log
 import androidx.core.content.ContextCompat
 import network.columba.app.rns.host.ble.model.BleConstants
@@ -23,7 +25,11 @@ import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.android.asCoroutineDispatcher
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
 import kotlinx.coroutines.cancel
+import kotlinx.coroutines.coroutineScope
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
@@ -80,11 +86,20 @@ class BleGattServer(
 ) {
     companion object {
         private const val TAG = "Columba:BLE:K:Server"
+
+        // Notify status when the server closed under a queued notification
+        private const val NOTIFY_STATUS_SERVER_CLOSED = -1
     }
 
     private var gattServer: BluetoothGattServer? = null
     private var txCharacteristic: BluetoothGattCharacteristic? = null
 
+    // Outbound notifications: per-central flow-controlled queues on a dedicated thread
+    private var notifyThread: HandlerThread? = null
+
+    @Volatile
+    private var notificationQueue: BleNotificationQueue? = null
+
     // Local transport identity (16 bytes, set by Python bridge)
     @Volatile
     private var transportIdentityHash: ByteArray? = null
@@ -230,11 +245,8 @@ class BleGattServer(
                 device: BluetoothDevice,
                 status: Int,
             ) {
-                if (status == BluetoothGatt.GATT_SUCCESS) {
-                    Log.v(TAG, "Notification sent to ${device.address}")
-                } else {
-                    Log.e(TAG, "Notification failed to ${device.address} (status: $status)")
-                }
+                // Releases the central's queue for its next notification
+                notificationQueue?.onNotificationSent(device.address, status)
             }
 
             override fun onServiceAdded(
@@ -328,6 +340,7 @@ class BleGattServer(
 
                 // Store TX characteristic reference
                 txCharacteristic = service.getCharacteristic(BleConstants.CHARACTERISTIC_TX_UUID)
+                startNotificationQueue()
 
                 _isServerOpen.value = true
                 Log.d(TAG, "GATT server opened and service registered successfully")
@@ -368,6 +381,8 @@ class BleGattServer(
                     centralMtus.clear()
                 }
 
+                stopNotificationQueue()
+
                 // Close server
                 gattServer?.close()
                 gattServer = null
@@ -398,6 +413,7 @@ class BleGattServer(
         }
 
         try {
+            stopNotificationQueue()
             gattServer?.close()
             gattServer = null
             txCharacteristic = null
@@ -413,66 +429,47 @@ class BleGattServer(
     /**
      * Send data to a specific central (or all centrals if address is null).
      *
+     * Values go through each central's notification queue, which sends one
+     * at a time and waits for `onNotificationSent` in between. Suspends while
+     * a target's queue is full. A broadcast enqueues to every target
+     * concurrently, so a central with a full queue delays this call but not
+     * the value reaching the other centrals.
+     *
      * @param data Data to send
      * @param centralAddress Address of specific central (null = send to all)
-     * @return Result indicating success or failure
+     * @return Result indicating success (queued for at least one central) or failure
      */
     suspend fun notifyCentrals(
         data: ByteArray,
         centralAddress: String? = null,
     ): Result<Unit> {
-        val server =
-            gattServer ?: return Result.failure(
+        val queue =
+            notificationQueue ?: return Result.failure(
                 IllegalStateException("GATT server not open"),
             )
 
-        val txChar =
-            txCharacteristic ?: return Result.failure(
-                IllegalStateException("TX characteristic not available"),
-            )
-
-        return withContext(Dispatchers.Main) {
-            try {
-                if (!hasConnectPermission()) {
-                    return@withContext Result.failure(
-                        SecurityException("Missing BLUETOOTH_CONNECT permission"),
-                    )
-                }
-
-                val targets =
-                    centralsMutex.withLock {
-                        if (centralAddress != null) {
-                            connectedCentrals[centralAddress]?.let { listOf(it) }.orEmpty()
-                        } else {
-                            connectedCentrals.values.toList()
-                        }
-                    }
+        if (!hasConnectPermission()) {
+            return Result.failure(SecurityException("Missing BLUETOOTH_CONNECT permission"))
+        }
 
-                if (targets.isEmpty()) {
-                    return@withContext Result.failure(
-                        IllegalStateException("No connected centrals to notify"),
-                    )
+        val targets =
+            centralsMutex.withLock {
+                if (centralAddress != null) {
+                    connectedCentrals[centralAddress]?.let { listOf(it) }.orEmpty()
+                } else {
+                    connectedCentrals.values.toList()
                 }
+            }
 
-                // Set characteristic value
-                txChar.value = data
-
-                // Send notification to each central
-                targets.forEach { device ->
-                    val success = server.notifyCharacteristicChanged(device, txChar, false)
-                    if (success) {
-                        Log.v(TAG, "Notified ${device.address} with ${data.size} bytes")
-                    } else {
-                        Log.e(TAG, "Failed to notify ${device.address}")
-                    }
-                }
+        if (targets.isEmpty()) {
+            return Result.failure(IllegalStateException("No connected centrals to notify"))
+        }
 
-                Result.success(Unit)
-            } catch (e: Exception) {
-                Log.e(TAG, "Error sending notification", e)
-                Result.failure(e)
+        val results =
+            coroutineScope {
+                targets.map { device -> async { queue.enqueue(device, data) } }.awaitAll()
             }
-        }
+        return results.firstOrNull { it.isSuccess } ?: results.first()
     }
 
     /**
@@ -512,6 +509,7 @@ class BleGattServer(
                     centralsMutex.withLock {
                         connectedCentrals.remove(address)
                     }
+                    notificationQueue?.remove(address)
                     mtuMutex.withLock {
                         centralMtus.remove(address)
                     }
@@ -624,6 +622,7 @@ class BleGattServer(
                 centralsMutex.withLock {
                     connectedCentrals[address] = device
                 }
+                notificationQueue?.open(device)
 
                 mtuMutex.withLock {
                     centralMtus[address] = BleConstants.MIN_USABLE_MTU
@@ -645,6 +644,7 @@ class BleGattServer(
                 centralsMutex.withLock {
                     connectedCentrals.remove(address)
                 }
+                notificationQueue?.remove(address)
 
                 mtuMutex.withLock {
                     centralMtus.remove(address)
@@ -989,6 +989,50 @@ class BleGattServer(
         return service
     }
 
+    private fun startNotificationQueue() {
+        stopNotificationQueue()
+        val thread = HandlerThread("BleGattServer-notify").also { it.start() }
+        notifyThread = thread
+        notificationQueue =
+            BleNotificationQueue(
+                scope = scope,
+                dispatcher = Handler(thread.looper).asCoroutineDispatcher("BleGattServer-notify"),
+                notifier = ::sendNotification,
+            )
+    }
+
+    private fun stopNotificationQueue() {
+        notificationQueue?.clear()
+        notificationQueue = null
+        notifyThread?.quitSafely()
+        notifyThread = null
+    }
+
+    /**
+     * Send one TX notification. Runs only on the notify thread.
+     *
+     * @return GATT_SUCCESS when the stack accepted it, otherwise its status code
+     */
+    private fun sendNotification(
+        device: BluetoothDevice,
+        value: ByteArray,
+    ): Int {
+        val server = gattServer ?: return NOTIFY_STATUS_SERVER_CLOSED
+        val txChar = txCharacteristic ?: return NOTIFY_STATUS_SERVER_CLOSED
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU) {
+            // Value passed per call: no shared characteristic state between centrals
+            return server.notifyCharacteristicChanged(device, txChar, false, value)
+        }
+        // Legacy API reads the shared characteristic value; safe because every
+        // notification is sent from this one thread. It doesn't say why it
+        // failed, and busy is by far the common case, so retry as busy.
+        @Suppress("DEPRECATION")
+        txChar.value = value
+        @Suppress("DEPRECATION")
+        val accepted = server.notifyCharacteristicChanged(device, txChar, false)
+        return if (accepted) BleConstants.GATT_SUCCESS else BleConstants.ERROR_GATT_WRITE_REQUEST_BUSY
+    }
+
     /**
      * Check if BLUETOOTH_CONNECT permission is granted.
      */
@@ -0,0 +1,241 @@
+package network.columba.app.rns.host.ble.server
+
+import android.bluetooth.BluetoothDevice
+import android.util.Log
+import network.columba.app.rns.host.ble.model.BleConstants
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.channels.ClosedSendChannelException
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withTimeoutOrNull
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Per-central outbound queue for GATT server notifications.
+ *
+ * Android's GATT server allows one outstanding notification per central;
+ * sending the next one before `onNotificationSent` makes the stack drop it
+ * silently. Each central gets its own bounded channel drained by one worker
+ * on [dispatcher], which waits for the delivery callback (or a timeout)
+ * before sending the next value. A slow central only stalls its own queue,
+ * and [enqueue] suspends once that queue is full so senders feel the
+ * backpressure instead of the stack dropping packets.
+ *
+ * Every send is numbered. `onNotificationSent` carries no identifier, but the
+ * stack reports in send order, so a send that timed out keeps its number on an
+ * "owed" list and the next callback is matched against it first: a late
+ * callback is consumed there instead of completing the value sent after it.
+ *
+ * Queues follow the connection: [open] on connect, [remove] on disconnect.
+ * [enqueue] never creates one, so a send racing a disconnect fails instead
+ * of leaving an orphan queue and worker behind.
+ *
+ * @property scope Scope the per-central workers run in
+ * @property dispatcher Dispatcher for all notify calls (a dedicated handler thread in production)
+ * @property notifier Sends one notification and returns the stack's status code
+ * @property maxDepth Queued values per central before [enqueue] suspends
+ * @property sentTimeoutMs How long to wait for [onNotificationSent] per value
+ */
+internal class BleNotificationQueue(
+    private val scope: CoroutineScope,
+    private val dispatcher: CoroutineDispatcher,
+    private val notifier: (BluetoothDevice, ByteArray) -> Int,
+    private val maxDepth: Int = BleConstants.NOTIFY_QUEUE_DEPTH,
+    private val sentTimeoutMs: Long = BleConstants.NOTIFY_SENT_TIMEOUT_MS,
+) {
+    companion object {
+        private const val TAG = "Columba:BLE:K:NotifyQ"
+    }
+
+    private class InFlight(
+        val sequence: Long,
+    ) {
+        val sent = CompletableDeferred<Int>()
+
+        // A callback owed to an earlier, timed-out send arrived while this one was out
+        var consumedLateCallback = false
+    }
+
+    private class CentralQueue(
+        val channel: Channel<ByteArray>,
+    ) {
+        lateinit var worker: Job
+
+        private var nextSequence = 0L
+        private var inFlight: InFlight? = null
+
+        // Timed-out sends whose callback may still arrive, oldest first
+        private val owed = ArrayDeque<Long>()
+
+        /** Number the next send and wait for its callback. */
+        @Synchronized
+        fun arm(): InFlight = InFlight(nextSequence++).also { inFlight = it }
+
+        /** No callback is coming for [send] (busy, error or permission failure). */
+        @Synchronized
+        fun disarm(send: InFlight) {
+            if (inFlight === send) inFlight = null
+        }
+
+        /**
+         * [send] timed out; its callback may still arrive and must not be taken
+         * for the next send's. If a late callback was already consumed while it
+         * was out, assume that one was really [send]'s rather than owing another,
+         * so a callback that never comes costs one timeout instead of shifting
+         * every later match by one.
+         */
+        @Synchronized
+        fun expire(send: InFlight) {
+            if (inFlight !== send) return
+            inFlight = null
+            if (!send.consumedLateCallback) owed.addLast(send.sequence)
+        }
+
+        /** Match a delivery callback: to the oldest owed send, else the current one. */
+        @Synchronized
+        fun onSent(status: Int): Long? {
+            val current = inFlight
+            owed.removeFirstOrNull()?.let { late ->
+                current?.consumedLateCallback = true
+                return late
+            }
+            inFlight = null
+            current?.sent?.complete(status)
+            return null
+        }
+
+        @Synchronized
+        fun cancelInFlight() {
+            inFlight?.sent?.cancel()
+            inFlight = null
+        }
+    }
+
+    private val queues = ConcurrentHashMap<String, CentralQueue>()
+
+    /**
+     * Start a queue for a newly connected central. No-op if it already has one.
+     */
+    fun open(device: BluetoothDevice) {
+        queues.computeIfAbsent(device.address) { start(device) }
+    }
+
+    /**
+     * Queue [data] for [device], suspending while its queue is full.
+     *
+     * @return failure if the central is not [open] or was removed before the
+     *   value was accepted
+     */
+    suspend fun enqueue(
+        device: BluetoothDevice,
+        data: ByteArray,
+    ): Result<Unit> {
+        val queue =
+            queues[device.address]
+                ?: return Result.failure(IllegalStateException("Central ${device.address} not connected"))
+        return try {
+            queue.channel.send(data)
+            Result.success(Unit)
+        } catch (e: ClosedSendChannelException) {
+            Result.failure(IllegalStateException("Central ${device.address} disconnected", e))
+        }
+    }
+
+    /**
+     * Delivery callback from `BluetoothGattServerCallback.onNotificationSent`.
+     */
+    fun onNotificationSent(
+        address: String,
+        status: Int,
+    ) {
+        val late = queues[address]?.onSent(status) ?: return
+        Log.d(TAG, "Ignored late onNotificationSent from $address for timed-out send #$late")
+    }
+
+    /**
+     * Drop a central's queue (disconnect). Pending values are discarded and
+     * suspended senders fail.
+     */
+    fun remove(address: String) {
+        queues.remove(address)?.let { stop(address, it) }
+    }
+
+    /**
+     * Drop every queue (server close).
+     */
+    fun clear() {
+        queues.keys.toList().forEach { remove(it) }
+    }
+
+    private fun start(device: BluetoothDevice): CentralQueue {
+        val queue = CentralQueue(Channel(maxDepth))
+        queue.worker =
+            scope.launch(dispatcher) {
+                for (value in queue.channel) {
+                    deliver(device, value, queue)
+                }
+            }
+        return queue
+    }
+
+    private fun stop(
+        address: String,
+        queue: CentralQueue,
+    ) {
+        queue.channel.close()
+        queue.worker.cancel()
+        queue.cancelInFlight()
+        // Fail senders suspended on a full queue and discard what was buffered
+        queue.channel.cancel()
+        Log.d(TAG, "Notification queue for $address stopped")
+    }
+
+    private suspend fun deliver(
+        device: BluetoothDevice,
+        value: ByteArray,
+        queue: CentralQueue,
+    ) {
+        repeat(BleConstants.NOTIFY_BUSY_MAX_RETRIES + 1) {
+            // Armed before sending: the callback can beat notifier's return
+            val send = queue.arm()
+
+            val status =
+                try {
+                    notifier(device, value)
+                } catch (e: SecurityException) {
+                    queue.disarm(send)
+                    Log.e(TAG, "Permission denied notifying ${device.address}", e)
+                    return
+                }
+
+            when (status) {
+                BleConstants.GATT_SUCCESS -> {
+                    val result = withTimeoutOrNull(sentTimeoutMs) { send.sent.await() }
+                    when (result) {
+                        null -> {
+                            queue.expire(send)
+                            Log.w(TAG, "No onNotificationSent from ${device.address} within ${sentTimeoutMs}ms")
+                        }
+                        BleConstants.GATT_SUCCESS -> Log.v(TAG, "Notified ${device.address} with ${value.size} bytes")
+                        else -> Log.e(TAG, "Notification failed to ${device.address} (status: $result)")
+                    }
+                    return
+                }
+                BleConstants.ERROR_GATT_WRITE_REQUEST_BUSY -> {
+                    queue.disarm(send)
+                    delay(BleConstants.NOTIFY_BUSY_RETRY_DELAY_MS)
+                }
+                else -> {
+                    queue.disarm(send)
+                    Log.e(TAG, "Failed to notify ${device.address} (status: $status)")
+                    return
+                }
+            }
+        }
+        Log.e(TAG, "Dropped ${value.size} byte notification to ${device.address}: stack stayed busy")
+    }
+}
@@ -0,0 +1,47 @@
+package network.columba.app.rns.host.ble.util
+
+/**
+ * Timeout that follows the observed latency of one kind of GATT operation
+ * on one connection, in the style of TCP's retransmission timer:
+ * `srtt + 4 × rttvar`, clamped to [minMs]..[maxMs].
+ *
+ * Until the first sample it answers [initialMs]. Each timeout doubles the
+ * current value (up to [maxMs]) so a peer that has become slow gets more
+ * room rather than timing out forever; the next real sample pulls it back.
+ *
+ * Not thread-safe; [BleOperationQueue] synchronizes on the map that holds it.
+ */
+class AdaptiveTimeout(
+    private val initialMs: Long,
+    private val minMs: Long,
+    private val maxMs: Long,
+) {
+    private var smoothedMs = -1.0
+    private var variationMs = 0.0
+    private var backedOffMs = 0L
+
+    /** Timeout to use for the next operation. */
+    fun currentMs(): Long {
+        if (backedOffMs > 0) return backedOffMs
+        if (smoothedMs < 0) return initialMs
+        return (smoothedMs + 4 * variationMs).toLong().coerceIn(minMs, maxMs)
+    }
+
+    /** An operation completed after [latencyMs]. */
+    fun record(latencyMs: Long) {
+        val sample = latencyMs.toDouble()
+        if (smoothedMs < 0) {
+            smoothedMs = sample
+            variationMs = sample / 2
+        } else {
+            variationMs = 0.75 * variationMs + 0.25 * kotlin.math.abs(smoothedMs - sample)
+            smoothedMs = 0.875 * smoothedMs + 0.125 * sample
+        }
+        backedOffMs = 0
+    }
+
+    /** An operation timed out. */
+    fun onTimeout() {
+        backedOffMs = (currentMs() * 2).coerceAtMost(maxMs)
+    }
+}
@@ -7,23 +7,19 @@ import android.bluetooth.BluetoothGattDescriptor
 import android.os.Build
 import android.util.Log
 import network.columba.app.rns.host.ble.model.BleConstants
-import kotlinx.coroutines.CancellableContinuation
 import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.cancel
 import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.launch
-import kotlinx.coroutines.suspendCancellableCoroutine
-import kotlinx.coroutines.sync.Mutex
-import kotlinx.coroutines.sync.withLock
-import java.util.UUID
-import java.util.concurrent.atomic.AtomicBoolean
-import kotlin.coroutines.resume
-import kotlin.coroutines.resumeWithException
+import kotlinx.coroutines.selects.select
+import kotlinx.coroutines.withTimeoutOrNull
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicInteger
 
 /**
  * Operation queue for Android BLE operations.
@@ -32,6 +28,17 @@ import kotlin.coroutines.resumeWithException
  * If you call multiple operations in succession (e.g., read(), read()), the second
  * will fail silently. This queue ensures serial execution with proper completion tracking.
  *
+ * That limit is per `BluetoothGatt` object (each connection has its own client
+ * interface and "device busy" flag), so operations run in one lane per
+ * connection: a slow service discovery on one peer doesn't hold up writes to
+ * another. Adapter-level operations ([BleOperation.Connect]) share a single
+ * global lane.
+ *
+ * Within a lane, [Priority.HIGH] operations (data and keepalive writes by
+ * default) run before queued [Priority.NORMAL] setup operations. Operations
+ * time out adaptively from the latencies observed on that peer, see
+ * [AdaptiveTimeout]; what was learned is kept across reconnects.
+ *
  * All operations are executed on a dedicated coroutine dispatcher to avoid blocking
  * the main thread or binder threads.
  *
@@ -47,6 +54,35 @@ class BleOperationQueue(
     companion object {
         private const val TAG = "Columba:BLE:K:Queue"
         private const val DEFAULT_TIMEOUT_MS = BleConstants.OPERATION_TIMEOUT_MS
+
+        /** Adaptive timeouts never go below this, so a jittery link doesn't trip them. */
+        private const val MIN_TIMEOUT_MS = 1_000L
+
+        /**
+         * Writes never time out sooner than the old fixed timeout: a write that
+         * is merely slow would otherwise be failed and the link torn down.
+         */
+        private const val MIN_WRITE_TIMEOUT_MS = DEFAULT_TIMEOUT_MS
+
+        /** Adaptive timeouts never go above this, so a dead peer is still detected. */
+        private const val MAX_TIMEOUT_MS = DEFAULT_TIMEOUT_MS * 3
+
+        /** Lane for adapter-level operations that Android serializes across connections. */
+        private const val GLOBAL_LANE = "adapter"
+
+        /** Peers whose learned timeouts are kept; the least recently used is forgotten first. */
+        private const val MAX_LEARNED_PEERS = 32
+    }
+
+    /**
+     * Scheduling priority within a connection's lane.
+     */
+    enum class Priority {
+        /** Data and keepalive writes: run before any queued setup operation. */
+        HIGH,
+
+        /** Connection setup: discovery, MTU, reads, descriptor writes. */
+        NORMAL,
     }
 
     /**
@@ -134,182 +170,326 @@ class BleOperationQueue(
 
         /**
          * Operation was queued successfully and will complete via callback.
-         * Do not call completeOperation() - the callback handler will do it.
+         * Do not call completeOperationByKey() - the callback handler will do it.
          */
         object Pending : OperationResult()
     }
 
-    private val operationQueue = Channel<suspend () -> OperationResult?>(Channel.UNLIMITED)
-    private val operationInProgress = AtomicBoolean(false)
-    private val pendingOperations = mutableMapOf<String, ContinuationHolder>()
-    private val mutex = Mutex()
+    /** One enqueued operation and the signal its caller waits on. */
+    private class Entry(
+        val operation: BleOperation,
+        val timeoutMs: Long?,
+    ) {
+        val key = completionKey(operation)
+        val result = CompletableDeferred<OperationResult>()
+
+        /** Position in its lane, assigned when it starts. */
+        var sequence = 0L
+
+        /** A callback taken for an earlier, timed-out operation; see [Lane.complete]. */
+        var heldResult: OperationResult? = null
+    }
 
     /**
-     * Channel to signal when async operations complete.
-     * This ensures the queue processor waits for callbacks before processing next operation.
+     * Serial executor for one connection (or the adapter). The worker takes
+     * HIGH before NORMAL and waits for each Pending operation's callback, or
+     * its timeout, before starting the next.
      */
-    private val operationCompletion = Channel<Unit>(Channel.RENDEZVOUS)
+    private inner class Lane(
+        val name: String,
+    ) {
+        val high = Channel<Entry>(Channel.UNLIMITED)
+        val normal = Channel<Entry>(Channel.UNLIMITED)
 
-    private data class ContinuationHolder(
-        val continuation: CancellableContinuation<OperationResult>,
-        val timeoutJob: Job,
-    )
+        /** Operation waiting for its GATT callback; only completion by key looks at it. */
+        @Volatile
+        var inFlight: Entry? = null
 
-    init {
-        // Start queue processor
-        scope.launch {
-            for (operation in operationQueue) {
+        private val timeouts = learnedTimeouts(name)
+
+        // Guards inFlight's heldResult, result and lateCallbacks between callbacks and the worker
+        private val callbackLock = Any()
+        private var nextSequence = 0L
+
+        /**
+         * Per key, the sequence number of a timed-out operation whose GATT
+         * callback may still arrive. Android delivers callbacks in order and
+         * holds one outstanding request per connection, so there is at most one.
+         */
+        private val lateCallbacks = HashMap<String, Long>()
+
+        val worker =
+            scope.launch {
                 try {
-                    operationInProgress.set(true)
-                    val result = operation()
-
-                    // If operation is Pending (async), wait for callback to complete it
-                    // before processing next operation. This prevents concurrent BLE operations.
-                    if (result is OperationResult.Pending) {
-                        Log.d(TAG, "Operation is async (Pending), waiting for callback completion...")
-                        operationCompletion.receive()
-                        Log.d(TAG, "Async operation completed, ready for next operation")
+                    while (true) {
+                        val entry =
+                            select<Entry> {
+                                high.onReceive { it }
+                                normal.onReceive { it }
+                            }
+                        // Caller gave up while it was queued
+                        if (entry.result.isCompleted) continue
+                        run(entry)
                     }
+                } catch (e: CancellationException) {
+                    throw e
                 } catch (e: Exception) {
-                    Log.e(TAG, "Error executing operation", e)
-                } finally {
-                    operationInProgress.set(false)
+                    // Channels closed by releaseConnection()
+                    Log.d(TAG, "Lane $name stopped")
                 }
             }
-        }
-    }
 
-    /**
-     * Enqueue a BLE operation and suspend until it completes.
-     *
-     * @param operation The operation to execute
-     * @param timeoutMs Timeout in milliseconds (default: 5000ms)
-     * @return Result of the operation
-     */
-    suspend fun enqueue(
-        operation: BleOperation,
-        timeoutMs: Long = DEFAULT_TIMEOUT_MS,
-    ): OperationResult =
-        suspendCancellableCoroutine { continuation ->
-            val operationId = UUID.randomUUID().toString()
-
-            val timeoutJob =
-                scope.launch {
-                    delay(timeoutMs)
-                    mutex.withLock {
-                        pendingOperations.remove(operationId)?.let {
-                            it.continuation.resumeWithException(
-                                TimeoutException("Operation timed out after ${timeoutMs}ms: $operation"),
-                            )
-                        }
-                    }
-                    // CRITICAL: Signal queue processor that operation completed (via timeout)
-                    // Without this, the queue stays blocked on operationCompletion.receive()
-                    // and ALL subsequent operations for ALL connections will timeout
-                    operationCompletion.trySend(Unit)
+        private suspend fun run(entry: Entry) {
+            inProgress.incrementAndGet()
+            entry.sequence = ++nextSequence
+            inFlight = entry
+            val startedAt = System.nanoTime()
+            try {
+                val result = executeOperation(entry.operation)
+                if (result !is OperationResult.Pending) {
+                    entry.result.complete(result)
+                    return
                 }
 
-            scope.launch {
-                mutex.withLock {
-                    pendingOperations[operationId] = ContinuationHolder(continuation, timeoutJob)
+                // Wait for the callback before the next operation on this connection
+                val timeout = timeoutFor(entry)
+                val completed = withTimeoutOrNull(timeout) { entry.result.await() }
+                if (completed == null) {
+                    onTimedOut(entry, timeout)
+                } else {
+                    synchronized(timeouts) { timeouts[entry.key]?.record((System.nanoTime() - startedAt) / 1_000_000) }
                 }
+            } catch (e: CancellationException) {
+                entry.result.complete(OperationResult.Failure(e))
+                throw e
+            } catch (e: Exception) {
+                Log.e(TAG, "Error executing operation", e)
+                entry.result.complete(OperationResult.Failure(e))
+            } finally {
+                inFlight = null
+                inProgress.decrementAndGet()
+            }
+        }
 
-                operationQueue.send {
-                    try {
-                        val result = executeOperation(operation)
-                        // Only complete immediately if not Pending
-                        // Pending operations will be completed by their callbacks
-                        if (result !is OperationResult.Pending) {
-                            completeOperation(operationId, result)
-                        }
-                        result // Return result so queue processor knows if it should wait
-                    } catch (e: Exception) {
-                        // Complete the operation with failure
-                        completeOperation(operationId, OperationResult.Failure(e))
-                        // Signal completion to unblock queue processor
-                        // This prevents deadlock when an exception occurs during a Pending operation
-                        operationCompletion.trySend(Unit)
-                        null // Return null on exception
+        private fun onTimedOut(
+            entry: Entry,
+            timeout: Long,
+        ) {
+            val held =
+                synchronized(callbackLock) {
+                    if (entry.result.isCompleted) return
+                    val held = entry.heldResult
+                    if (held == null) {
+                        lateCallbacks[entry.key] = entry.sequence
+                    } else {
+                        // The earlier operation's callback never came: the one we held was ours
+                        lateCallbacks.remove(entry.key)
                     }
+                    held
                 }
+            if (held != null) {
+                entry.result.complete(held)
+                return
             }
+            synchronized(timeouts) { timeouts[entry.key]?.onTimeout() }
+            entry.result.complete(
+                OperationResult.Failure(
+                    TimeoutException("Operation timed out after ${timeout}ms: ${entry.operation}"),
+                ),
+            )
+        }
 
-            continuation.invokeOnCancellation {
-                scope.launch {
-                    mutex.withLock {
-                        pendingOperations.remove(operationId)?.timeoutJob?.cancel()
+        /**
+         * Deliver a GATT callback for [key]. A callback owed to a timed-out
+         * operation is dropped rather than completing the operation that
+         * replaced it. If one arrives while the next operation of that kind is
+         * already in flight, it is held: a second callback means the first was
+         * the late one, and a timeout means the late one was lost and the held
+         * one is ours.
+         *
+         * @return false if nothing was waiting for it
+         */
+        fun complete(
+            key: String,
+            result: OperationResult,
+        ): Boolean {
+            synchronized(callbackLock) {
+                val entry = inFlight?.takeIf { it.key == key && !it.result.isCompleted }
+                val lateSequence = lateCallbacks[key]
+                if (lateSequence != null && entry?.heldResult == null) {
+                    if (entry == null) {
+                        lateCallbacks.remove(key)
+                        Log.d(TAG, "Dropping late '$key' callback on $name for timed-out operation #$lateSequence")
+                    } else {
+                        entry.heldResult = result
                     }
+                    return true
                 }
+                if (entry == null) return false
+                lateCallbacks.remove(key)
+                entry.result.complete(result)
+                return true
             }
         }
 
+        private fun timeoutFor(entry: Entry): Long {
+            val adaptive =
+                synchronized(timeouts) {
+                    timeouts.getOrPut(entry.key) {
+                        val floor = if (entry.key == "write") MIN_WRITE_TIMEOUT_MS else MIN_TIMEOUT_MS
+                        AdaptiveTimeout(DEFAULT_TIMEOUT_MS, floor, MAX_TIMEOUT_MS)
+                    }.currentMs()
+                }
+            return entry.timeoutMs ?: adaptive
+        }
+
+        /** Fail everything queued or in flight with [error]. */
+        fun failAll(error: Throwable) {
+            for (channel in listOf(high, normal)) {
+                while (true) {
+                    val entry = channel.tryReceive().getOrNull() ?: break
+                    entry.result.complete(OperationResult.Failure(error))
+                }
+            }
+            inFlight?.result?.complete(OperationResult.Failure(error))
+        }
+
+        fun close() {
+            high.close()
+            normal.close()
+            worker.cancel()
+        }
+    }
+
+    private val lanes = ConcurrentHashMap<String, Lane>()
+    private val inProgress = AtomicInteger(0)
+    private val pending = AtomicInteger(0)
+
+    // Per peer and operation kind; outlives the lane so a reconnect starts from what was learned
+    private val learned =
+        object : LinkedHashMap<String, HashMap<String, AdaptiveTimeout>>(16, 0.75f, true) {
+            override fun removeEldestEntry(eldest: MutableMap.MutableEntry<String, HashMap<String, AdaptiveTimeout>>) =
+                size > MAX_LEARNED_PEERS
+        }
+
+    /** Learned timeouts for [laneName]; callers synchronize on the returned map. */
+    private fun learnedTimeouts(laneName: String): HashMap<String, AdaptiveTimeout> =
+        synchronized(learned) { learned.getOrPut(laneName) { HashMap() } }
+
     /**
-     * Complete an operation by resuming its continuation.
+     * Timeout the next [key] operation on [address] would get, ignoring any
+     * explicit timeout passed to [enqueue].
+     */
+    @androidx.annotation.VisibleForTesting
+    internal fun adaptiveTimeoutMs(
+        address: String,
+        key: String,
+    ): Long? {
+        val timeouts = learnedTimeouts(address)
+        return synchronized(timeouts) { timeouts[key]?.currentMs() }
+    }
+
+    /**
+     * Enqueue a BLE operation and suspend until it completes.
      *
-     * @param operationId ID of the operation
-     * @param result Result to return
+     * @param operation The operation to execute
+     * @param timeoutMs Timeout in milliseconds once the operation has started;
+     *                  null uses the connection's adaptive timeout
+     * @param priority Position within the connection's lane; data writes default to HIGH
+     * @return Result of the operation
      */
-    suspend fun completeOperation(
-        operationId: String,
-        result: OperationResult,
-    ) {
-        mutex.withLock {
-            pendingOperations.remove(operationId)?.let { holder ->
-                holder.timeoutJob.cancel()
-                when (result) {
-                    is OperationResult.Success -> holder.continuation.resume(result)
-                    is OperationResult.Failure -> holder.continuation.resumeWithException(result.error)
-                    is OperationResult.Pending -> {
-                        // This should never happen - Pending results should not call completeOperation
-                        Log.e(TAG, "Attempted to complete operation with Pending result - this is a bug")
-                    }
-                }
+    suspend fun enqueue(
+        operation: BleOperation,
+        timeoutMs: Long? = null,
+        priority: Priority = defaultPriority(operation),
+    ): OperationResult {
+        val entry = Entry(operation, timeoutMs)
+        val lane = laneFor(operation)
+        pending.incrementAndGet()
+        try {
+            val target = if (priority == Priority.HIGH) lane.high else lane.normal
+            if (target.trySend(entry).isFailure) {
+                throw CancellationException("Operation cancelled: connection released")
+            }
+            return when (val result = entry.result.await()) {
+                is OperationResult.Failure -> throw result.error
+                else -> result
             }
+        } catch (e: CancellationException) {
+            // Skipped by the worker if still queued; unblocks the lane if in flight
+            entry.result.complete(OperationResult.Failure(e))
+            throw e
+        } finally {
+            pending.decrementAndGet()
         }
-
-        // Signal queue processor that async operation completed
-        // This unblocks the queue to process the next operation
-        operationCompletion.trySend(Unit)
     }
 
     /**
-     * Complete an operation from a callback (when you don't have the operation ID).
-     * This is a convenience method for callbacks.
+     * Complete the operation awaiting a GATT callback on [address].
      *
-     * @param key A unique key identifying the operation (e.g., "write_${char.uuid}")
+     * Only the in-flight operation of that connection is completed, and only
+     * if it is the kind of operation [key] names. Each operation carries a
+     * sequence number, and a late callback owed to one that already timed
+     * out is dropped instead of completing its successor.
+     *
+     * @param address Device address the callback came from
+     * @param key Operation kind: "services", "mtu", "read", "write", "descriptor" or "descriptor_read"
      * @param result Result to return
      */
-    suspend fun completeOperationByKey(
+    fun completeOperationByKey(
+        address: String,
         key: String,
         result: OperationResult,
     ) {
-        mutex.withLock {
-            // Find and complete the first pending operation (FIFO)
-            pendingOperations.entries.firstOrNull()?.let { (id, holder) ->
-                pendingOperations.remove(id)
-                holder.timeoutJob.cancel()
-                when (result) {
-                    is OperationResult.Success -> holder.continuation.resume(result)
-                    is OperationResult.Failure -> holder.continuation.resumeWithException(result.error)
-                    is OperationResult.Pending -> {
-                        // This should never happen - Pending results should not call completeOperationByKey
-                        Log.e(TAG, "Attempted to complete operation with Pending result - this is a bug")
-                    }
-                }
-            }
+        if (result is OperationResult.Pending) {
+            // This should never happen - Pending results should not call completeOperationByKey
+            Log.e(TAG, "Attempted to complete operation with Pending result - this is a bug")
+            return
+        }
+        if (lanes[address]?.complete(key, result) != true) {
+            Log.d(TAG, "No in-flight '$key' operation for $address, dropping completion")
         }
+    }
+
+    /**
+     * Fail everything queued for [address] and drop its lane.
+     * Called when the connection goes away; learned timeouts are kept.
+     */
+    fun releaseConnection(address: String) {
+        val lane = lanes.remove(address) ?: return
+        lane.close()
+        lane.failAll(CancellationException("Operation cancelled: $address disconnected"))
+    }
 
-        // Signal queue processor that async operation completed
-        // This unblocks the queue to process the next operation
-        operationCompletion.trySend(Unit)
+    private fun laneFor(operation: BleOperation): Lane {
+        val name = laneName(operation)
+        return lanes.computeIfAbsent(name) { Lane(it) }
     }
 
+    private fun laneName(operation: BleOperation): String =
+        when (operation) {
+            is BleOperation.Connect -> GLOBAL_LANE
+            is BleOperation.Disconnect -> operation.gatt.address()
+            is BleOperation.DiscoverServices -> operation.gatt.address()
+            is BleOperation.RequestMtu -> operation.gatt.address()
+            is BleOperation.ReadCharacteristic -> operation.gatt.address()
+            is BleOperation.WriteCharacteristic -> operation.gatt.address()
+            is BleOperation.ReadDescriptor -> operation.gatt.address()
+            is BleOperation.WriteDescriptor -> operation.gatt.address()
+            is BleOperation.SetCharacteristicNotification -> operation.gatt.address()
+        }
+
+    private fun BluetoothGatt.address(): String = device?.address ?: GLOBAL_LANE
+
+    private fun defaultPriority(operation: BleOperation): Priority =
+        if (operation is BleOperation.WriteCharacteristic) Priority.HIGH else Priority.NORMAL
+
     /**
      * Execute a BLE operation.
      * This method actually calls the Android BLE APIs.
      *
      * Note: The actual completion happens in callbacks (onCharacteristicRead, etc.)
-     * which must call completeOperation().
+     * which must call completeOperationByKey().
      */
     private suspend fun executeOperation(operation: BleOperation): OperationResult {
         return try {
@@ -455,31 +635,21 @@ class BleOperationQueue(
     }
 
     /**
-     * Check if an operation is currently in progress.
+     * Check if an operation is currently in progress on any connection.
      */
-    fun isOperationInProgress(): Boolean = operationInProgress.get()
+    fun isOperationInProgress(): Boolean = inProgress.get() > 0
 
     /**
-     * Get the number of pending operations.
+     * Get the number of pending operations (queued or in flight) across all connections.
      */
-    suspend fun getPendingOperationCount(): Int {
-        return mutex.withLock { pendingOperations.size }
-    }
+    fun getPendingOperationCount(): Int = pending.get()
 
     /**
      * Clear all pending operations.
      * This should be called when disconnecting or shutting down.
      */
-    suspend fun clearPendingOperations() {
-        mutex.withLock {
-            pendingOperations.values.forEach { holder ->
-                holder.timeoutJob.cancel()
-                holder.continuation.resumeWithException(
-                    CancellationException("Operation cancelled: queue cleared"),
-                )
-            }
-            pendingOperations.clear()
-        }
+    fun clearPendingOperations() {
+        lanes.values.forEach { it.failAll(CancellationException("Operation cancelled: queue cleared")) }
     }
 
     /**
@@ -487,11 +657,28 @@ class BleOperationQueue(
      * Cancels all pending operations and closes the queue.
      */
     fun shutdown() {
+        clearPendingOperations()
+        lanes.values.forEach { it.close() }
+        lanes.clear()
         scope.cancel()
-        operationQueue.close()
     }
 }
 
+/**
+ * Key that GATT callbacks use to complete [operation], or "" for operations
+ * that complete synchronously.
+ */
+private fun completionKey(operation: BleOperationQueue.BleOperation): String =
+    when (operation) {
+        is BleOperationQueue.BleOperation.DiscoverServices -> "services"
+        is BleOperationQueue.BleOperation.RequestMtu -> "mtu"
+        is BleOperationQueue.BleOperation.ReadCharacteristic -> "read"
+        is BleOperationQueue.BleOperation.WriteCharacteristic -> "write"
+        is BleOperationQueue.BleOperation.ReadDescriptor -> "descriptor_read"
+        is BleOperationQueue.BleOperation.WriteDescriptor -> "descriptor"
+        else -> ""
+    }
+
 /**
  * Timeout exception for BLE operations.
  */
@@ -29,7 +29,12 @@ object ServiceDatabaseProvider {
                 context.applicationContext,
                 ColumbaDatabase::class.java,
                 DatabaseModule.DATABASE_NAME,
-            ).addMigrations(ColumbaDatabase.MIGRATION_1_2)
+            ).addMigrations(
+                ColumbaDatabase.MIGRATION_1_2,
+                ColumbaDatabase.MIGRATION_2_3,
+                ColumbaDatabase.MIGRATION_3_4,
+                ColumbaDatabase.MIGRATION_4_5,
+            )
             .fallbackToDestructiveMigration()
             .fallbackToDestructiveMigrationOnDowngrade()
             .enableMultiInstanceInvalidation()
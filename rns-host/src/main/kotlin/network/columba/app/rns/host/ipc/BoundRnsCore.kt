@@ -26,6 +26,7 @@ import network.columba.app.rns.api.model.LinkSpeedProbeResult
 import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.ReceivedPacket
 import network.columba.app.rns.api.model.ReticulumConfig
 
@@ -168,6 +169,11 @@ internal class BoundRnsCore(
 
     override suspend fun getPathTableHashes(): List<String> = awaitBound().core.getPathTableHashes()
 
+    // A rebind starts a fresh upstream, whose first batch is a reset
+    @OptIn(ExperimentalCoroutinesApi::class)
+    override fun observePathTable(): Flow<PathTableDelta> =
+        backendFlow.filterNotNull().flatMapLatest { it.core.observePathTable() }
+
     override suspend fun probeLinkSpeed(
         destinationHash: ByteArray,
         timeoutSeconds: Float,
@@ -62,6 +62,12 @@ internal class BoundRnsTelemetry(
         iconAppearance: IconAppearance?,
     ): Result<Unit> = awaitBound().telemetry.storeOwnTelemetry(locationJson, iconAppearance)
 
+    override suspend fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ): Result<Unit> = awaitBound().telemetry.storeOwnTelemetryPacked(packedTelemetry, timestampSeconds, iconAppearance)
+
     override suspend fun setTelemetryAllowedRequesters(allowedHashes: Set<String>): Result<Unit> =
         awaitBound().telemetry.setTelemetryAllowedRequesters(allowedHashes)
 
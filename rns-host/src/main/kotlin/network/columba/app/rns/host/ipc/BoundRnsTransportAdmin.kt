@@ -2,6 +2,7 @@ package network.columba.app.rns.host.ipc
 
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.SharingStarted
 import kotlinx.coroutines.flow.StateFlow
@@ -16,6 +17,7 @@ import network.columba.app.rns.api.model.BatteryProfile
 import network.columba.app.rns.api.model.DiscoveredInterface
 import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 
 /**
  * UI-side proxy that delegates every [RnsTransportAdmin] member to the
@@ -79,6 +81,12 @@ internal class BoundRnsTransportAdmin(
     override suspend fun getInterfaceStats(interfaceName: String): Map<String, Any>? =
         awaitBound().transportAdmin.getInterfaceStats(interfaceName)
 
+    // Not shared here: the bound client already multiplexes collectors onto
+    // one IPC subscription, and a rebind must switch to the new backend's.
+    @OptIn(ExperimentalCoroutinesApi::class)
+    override fun observeInterfaceStats(): Flow<List<InterfaceStatsSnapshot>> =
+        backendFlow.filterNotNull().flatMapLatest { it.transportAdmin.observeInterfaceStats() }
+
     override suspend fun reconnectRNodeInterface() {
         awaitBound().transportAdmin.reconnectRNodeInterface()
     }
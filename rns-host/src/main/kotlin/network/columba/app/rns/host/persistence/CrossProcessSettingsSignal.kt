@@ -0,0 +1,79 @@
+package network.columba.app.rns.host.persistence
+
+import android.content.Context
+import android.os.FileObserver
+import android.util.Log
+import kotlinx.coroutines.channels.awaitClose
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.callbackFlow
+import kotlinx.coroutines.flow.conflate
+import java.io.Closeable
+import java.io.File
+
+/**
+ * Change signal for the [ServiceSettingsAccessor.CROSS_PROCESS_PREFS_NAME]
+ * file, shared by the app and :reticulum processes.
+ *
+ * `OnSharedPreferenceChangeListener` only fires in the process that made the
+ * edit, so neither process hears the other's writes. SharedPreferences
+ * commits by writing the whole XML file, so watching that file with
+ * [FileObserver] (inotify) gives a signal in both processes. Readers keep a
+ * parsed copy and reload it when the signal fires, instead of asking a
+ * `MODE_MULTI_PROCESS` instance to stat and re-parse the file on every read.
+ *
+ * The signal carries no data: after it fires, readers reload through
+ * `MODE_MULTI_PROCESS` once to pick up the new contents.
+ */
+class CrossProcessSettingsSignal(
+    private val context: Context,
+) {
+    companion object {
+        private const val TAG = "CrossProcessSettings"
+
+        private const val PREFS_FILE_NAME = "${ServiceSettingsAccessor.CROSS_PROCESS_PREFS_NAME}.xml"
+
+        // SharedPreferences writes the file in place (CLOSE_WRITE); MOVED_TO
+        // covers the restore from its .bak copy.
+        private const val EVENTS = FileObserver.CLOSE_WRITE or FileObserver.MOVED_TO
+    }
+
+    /**
+     * Start watching; [onChange] runs on the FileObserver thread after every
+     * write to the prefs file by any process. Returns null if the file can't
+     * be watched, in which case callers must not trust a cached copy.
+     * Keep the returned handle referenced — a collected FileObserver stops.
+     */
+    fun watch(onChange: () -> Unit): Closeable? =
+        try {
+            val dir = File(context.applicationInfo.dataDir, "shared_prefs").apply { mkdirs() }
+
+            @Suppress("DEPRECATION") // FileObserver(File, Int) needs API 29; minSdk is 24
+            val observer =
+                object : FileObserver(dir.path, EVENTS) {
+                    override fun onEvent(
+                        event: Int,
+                        path: String?,
+                    ) {
+                        if (path == PREFS_FILE_NAME) onChange()
+                    }
+                }
+            observer.startWatching()
+            Closeable { observer.stopWatching() }
+        } catch (e: Exception) {
+            Log.w(TAG, "Could not watch cross-process settings: ${e.message}")
+            null
+        } catch (e: LinkageError) {
+            Log.w(TAG, "Could not watch cross-process settings: ${e.message}")
+            null
+        }
+
+    /**
+     * Pulses once per write to the prefs file, from either process.
+     * Emits nothing if the file can't be watched.
+     */
+    fun changes(): Flow<Unit> =
+        callbackFlow {
+            val handle = watch { trySend(Unit) }
+            awaitClose { handle?.close() }
+        }.conflate()
+}
@@ -0,0 +1,166 @@
+package network.columba.app.rns.host.persistence
+
+import android.util.Log
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.CoroutineStart
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.MutableSharedFlow
+import kotlinx.coroutines.flow.SharedFlow
+import kotlinx.coroutines.flow.asSharedFlow
+import kotlinx.coroutines.launch
+import network.columba.app.data.storage.AttachmentStorageManager
+import network.columba.app.rns.api.RnsBackend
+import network.columba.app.rns.api.RnsLxmf
+import network.columba.app.rns.api.model.ReceivedMessage
+import network.columba.app.rns.api.util.toHex
+
+/**
+ * Single owner of inbound message persistence in the :reticulum process.
+ *
+ * Collects the backend's raw message stream as soon as the service starts,
+ * writes each message through [ServicePersistenceManager.ingestMessage], and
+ * republishes it on [messages] enriched with the outcome:
+ *
+ * - persisted → `persisted = true`, `resolvedPeerName` set
+ * - already stored and still unread → `persisted = true`, so it notifies again
+ * - already stored and read → `persisted = true`, `isDuplicate = true`
+ * - rejected by policy (blocked, unknown sender, other identity) → not emitted
+ * - write failed, or fields too large for the service to store inline →
+ *   emitted unchanged (`persisted = false`) so the UI falls back to saving it
+ *
+ * The UI process therefore needs no existence checks or dedup sets of its
+ * own: it only notifies for `persisted && !isDuplicate` events.
+ *
+ * Messages that are already waiting when a batch starts are handed to
+ * [InboundMessageIngest] together, so it can commit them in one transaction.
+ * They are written and emitted in arrival order.
+ *
+ * The backend's message stream is hot and does not replay, so [start] must run
+ * before the backend is initialized; it subscribes before returning.
+ */
+class InboundMessageHandoff(
+    private val lxmf: RnsLxmf,
+    private val persistenceManager: ServicePersistenceManager,
+    private val scope: CoroutineScope,
+    private val maxBatchSize: Int = InboundMessageIngest.DEFAULT_MAX_BATCH_SIZE,
+) {
+    companion object {
+        private const val TAG = "InboundMessageHandoff"
+
+        // Above this the UI extracts attachments to disk before inserting
+        // (AttachmentStorageManager); the service has no such path, so leave
+        // these to the UI rather than store a row the CursorWindow can't read.
+        private const val MAX_INLINE_FIELDS_CHARS = AttachmentStorageManager.SIZE_THRESHOLD
+    }
+
+    private val _messages = MutableSharedFlow<ReceivedMessage>(extraBufferCapacity = 64)
+
+    /** Enriched inbound messages, in arrival order. */
+    val messages: SharedFlow<ReceivedMessage> = _messages.asSharedFlow()
+
+    private var job: Job? = null
+
+    /**
+     * Start collecting from the backend. Idempotent.
+     *
+     * The subscription is made before this returns (undispatched), so nothing the
+     * backend emits afterwards is missed; arrivals queue in an unlimited inbox
+     * while a batch is being written.
+     */
+    fun start() {
+        if (job?.isActive == true) return
+        job =
+            scope.launch(start = CoroutineStart.UNDISPATCHED) {
+                val inbox = Channel<ReceivedMessage>(Channel.UNLIMITED)
+                launch(start = CoroutineStart.UNDISPATCHED) {
+                    lxmf.observeMessages().collect { inbox.send(it) }
+                }
+                while (true) {
+                    val batch = mutableListOf(inbox.receive())
+                    while (batch.size < maxBatchSize) {
+                        batch.add(inbox.tryReceive().getOrNull() ?: break)
+                    }
+                    handleBatch(batch)
+                }
+            }
+        Log.d(TAG, "Inbound message handoff started")
+    }
+
+    fun stop() {
+        job?.cancel()
+        job = null
+    }
+
+    /**
+     * Wrap [backend] so that `lxmf.observeMessages()` returns [messages].
+     * Everything else is forwarded unchanged. Handed to the AIDL server so the
+     * UI process only ever sees enriched events.
+     */
+    fun wrap(backend: RnsBackend): RnsBackend {
+        val lxmf = HandoffRnsLxmf(backend.lxmf, messages)
+        return object : RnsBackend by backend {
+            override val lxmf: RnsLxmf = lxmf
+        }
+    }
+
+    private suspend fun handleBatch(batch: List<ReceivedMessage>) {
+        // Oversized messages get no result and go to the UI as persisted = false
+        val inline = batch.indices.filter { (batch[it].fieldsJson?.length ?: 0) < MAX_INLINE_FIELDS_CHARS }
+        val results = arrayOfNulls<IngestResult>(batch.size)
+        if (inline.isNotEmpty()) {
+            persistenceManager
+                .ingestMessages(inline.map { batch[it].toInboundMessage() })
+                .forEachIndexed { i, result -> results[inline[i]] = result }
+        }
+        batch.forEachIndexed { index, message ->
+            enrich(message, results[index])?.let { _messages.emit(it) }
+        }
+    }
+
+    private fun enrich(
+        message: ReceivedMessage,
+        result: IngestResult?,
+    ): ReceivedMessage? =
+        when (result?.outcome) {
+            IngestResult.Outcome.PERSISTED ->
+                message.copy(persisted = true, resolvedPeerName = result.peerName)
+            // A replay the user hasn't read yet still notifies, as the UI's own fallback does
+            IngestResult.Outcome.DUPLICATE ->
+                message.copy(persisted = true, isDuplicate = !result.unread, resolvedPeerName = result.peerName)
+            IngestResult.Outcome.REJECTED -> {
+                Log.d(TAG, "Dropped rejected message ${message.messageHash.take(16)}")
+                null
+            }
+            IngestResult.Outcome.FAILED, null -> message
+        }
+
+    private fun ReceivedMessage.toInboundMessage() =
+        InboundMessage(
+            messageHash = messageHash,
+            content = content,
+            sourceHash = sourceHash.toHex(),
+            timestamp = timestamp,
+            fieldsJson = fieldsJson,
+            publicKey = publicKey,
+            replyToMessageId = null,
+            deliveryMethod = deliveryMethod,
+            // Cheap pre-filter; the supersede check itself matches on original_message_id.
+            hasFileAttachments = fieldsJson?.contains("\"5\"") == true,
+            receivedHopCount = receivedHopCount,
+            receivedInterface = receivedInterface,
+            receivedRssi = receivedRssi,
+            receivedSnr = receivedSnr,
+            destinationHash = destinationHash.toHex(),
+            iconAppearance = iconAppearance,
+        )
+}
+
+/** [RnsLxmf] that serves [messages] in place of the delegate's raw stream. */
+private class HandoffRnsLxmf(
+    delegate: RnsLxmf,
+    private val messages: Flow<ReceivedMessage>,
+) : RnsLxmf by delegate {
+    override fun observeMessages(): Flow<ReceivedMessage> = messages
+}
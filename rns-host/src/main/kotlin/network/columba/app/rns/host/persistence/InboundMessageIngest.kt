@@ -0,0 +1,454 @@
+package network.columba.app.rns.host.persistence
+
+import android.util.Log
+import androidx.room.withTransaction
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.ConversationEntity
+import network.columba.app.data.db.entity.MessageEntity
+import network.columba.app.data.db.entity.PeerIconEntity
+import network.columba.app.data.db.entity.PeerIdentityEntity
+import network.columba.app.data.util.TextSanitizer
+import network.columba.app.rns.api.model.IconAppearance
+import network.columba.app.rns.host.util.PeerNameResolver
+import org.json.JSONObject
+import java.util.concurrent.ConcurrentLinkedQueue
+
+/**
+ * A received LXMF message waiting to be written by [InboundMessageIngest].
+ * Fields mirror the [ServicePersistenceManager.persistMessage] parameters.
+ *
+ * [destinationHash] is the local LXMF destination the message was addressed
+ * to; when set, messages for any destination other than the active identity's
+ * are rejected (they arrived for an identity the user has since switched away
+ * from). [iconAppearance] is the sender's LXMF Field 4 icon, saved alongside
+ * the message.
+ */
+data class InboundMessage(
+    val messageHash: String,
+    val content: String,
+    val sourceHash: String,
+    val timestamp: Long,
+    val fieldsJson: String?,
+    val publicKey: ByteArray?,
+    val replyToMessageId: String?,
+    val deliveryMethod: String?,
+    val hasFileAttachments: Boolean = false,
+    val receivedHopCount: Int? = null,
+    val receivedInterface: String? = null,
+    val receivedRssi: Int? = null,
+    val receivedSnr: Float? = null,
+    val destinationHash: String? = null,
+    val iconAppearance: IconAppearance? = null,
+) {
+    // ByteArray field: identity is the message hash, not structural equality.
+    override fun equals(other: Any?): Boolean = other is InboundMessage && other.messageHash == messageHash
+
+    override fun hashCode(): Int = messageHash.hashCode()
+}
+
+/**
+ * What [InboundMessageIngest] did with a submitted message.
+ *
+ * [peerName] is the display name the conversation ended up with, so the UI
+ * can notify without resolving it again. Null for rejected/failed messages.
+ * [unread] is set for a [Outcome.DUPLICATE] whose stored row is not read yet.
+ */
+data class IngestResult(
+    val outcome: Outcome,
+    val peerName: String? = null,
+    val unread: Boolean = false,
+) {
+    enum class Outcome {
+        /** Newly written to the database. */
+        PERSISTED,
+
+        /** Already in the database for the active identity; nothing written. */
+        DUPLICATE,
+
+        /** Dropped by policy: blocked peer, unknown sender, wrong or no active identity. */
+        REJECTED,
+
+        /** The write failed; the message is not in the database. */
+        FAILED,
+    }
+
+    /** True when the message is in the database, either from this call or an earlier one. */
+    val isAccepted: Boolean
+        get() = outcome == Outcome.PERSISTED || outcome == Outcome.DUPLICATE
+
+    companion object {
+        val REJECTED = IngestResult(Outcome.REJECTED)
+        val FAILED = IngestResult(Outcome.FAILED)
+    }
+}
+
+/**
+ * Group-commit ingest stage for inbound messages.
+ *
+ * Callers [submit] a message and suspend until it is durable. Submissions are
+ * queued; whichever caller holds the commit lock drains up to [maxBatchSize]
+ * queued messages and writes them in a single `withTransaction` block, then
+ * completes every caller in the batch. While one transaction is in flight, new
+ * arrivals accumulate in the queue and form the next batch — so the batching
+ * window is the commit time of the previous batch: a lone message commits
+ * immediately, and a propagation-node sync delivering hundreds of messages
+ * collapses into a handful of transactions (and a handful of Room
+ * invalidations) instead of one per statement.
+ *
+ * Sender policy (active identity, blocked peers, contacts) comes from
+ * [SenderPolicyCache] once per batch, and duplicates are detected with an
+ * `EXISTS` probe rather than loading the existing row.
+ */
+class InboundMessageIngest(
+    private val database: ColumbaDatabase,
+    private val policyCache: SenderPolicyCache,
+    private val settingsAccessor: ServiceSettingsAccessor,
+    private val maxBatchSize: Int = DEFAULT_MAX_BATCH_SIZE,
+) {
+    companion object {
+        private const val TAG = "InboundMessageIngest"
+        const val DEFAULT_MAX_BATCH_SIZE = 64
+    }
+
+    private class Pending(
+        val message: InboundMessage,
+        val result: CompletableDeferred<IngestResult> = CompletableDeferred(),
+    )
+
+    private val queue = ConcurrentLinkedQueue<Pending>()
+    private val commitLock = Mutex()
+
+    private val messageDao by lazy { database.messageDao() }
+    private val conversationDao by lazy { database.conversationDao() }
+    private val contactDao by lazy { database.contactDao() }
+    private val announceDao by lazy { database.announceDao() }
+    private val peerIdentityDao by lazy { database.peerIdentityDao() }
+    private val peerIconDao by lazy { database.peerIconDao() }
+
+    /** Number of transactions committed so far. Exposed for throughput tests. */
+    @Volatile
+    var committedBatches: Long = 0
+        private set
+
+    /**
+     * Queue [message] and suspend until it has been committed (or rejected).
+     *
+     * @return the [IngestResult]; [IngestResult.isAccepted] is true if the message
+     *   was persisted or already existed.
+     */
+    suspend fun submit(message: InboundMessage): IngestResult = submitAll(listOf(message)).single()
+
+    /**
+     * Queue [messages] in order and suspend until all of them are committed.
+     * They are written in list order, in as few transactions as [maxBatchSize]
+     * allows, so arrival order survives into `received_at` and the conversation's
+     * latest message.
+     *
+     * @return one [IngestResult] per message, in the same order.
+     */
+    suspend fun submitAll(messages: List<InboundMessage>): List<IngestResult> {
+        val pending = messages.map { Pending(it) }
+        queue.addAll(pending)
+        commitLock.withLock {
+            // FIFO queue: by the time our last entry is at the head, everything ahead
+            // of it has been committed by us or by an earlier lock holder.
+            while (pending.any { !it.result.isCompleted }) {
+                commitNextBatch()
+            }
+        }
+        return pending.map { it.result.await() }
+    }
+
+    private suspend fun commitNextBatch() {
+        val batch = ArrayList<Pending>(maxBatchSize)
+        while (batch.size < maxBatchSize) {
+            batch.add(queue.poll() ?: break)
+        }
+        if (batch.isEmpty()) return
+
+        try {
+            val policy = policyCache.get()
+            if (policy == null) {
+                Log.w(TAG, "No active identity - cannot persist ${batch.size} message(s)")
+                batch.forEach { it.result.complete(IngestResult.REJECTED) }
+                return
+            }
+            val blockUnknownSenders = readBlockUnknownSenders()
+
+            val results =
+                try {
+                    database.withTransaction {
+                        batch.map { persistOne(it.message, policy, blockUnknownSenders) }
+                    }
+                } catch (e: Exception) {
+                    // One bad row must not cost the whole batch: retry each message in
+                    // its own transaction so only the failing one reports FAILED.
+                    Log.w(TAG, "Batch of ${batch.size} failed, retrying individually: ${e.message}")
+                    batch.map { persistIsolated(it.message, policy, blockUnknownSenders) }
+                }
+            committedBatches++
+            batch.forEachIndexed { index, pending -> pending.result.complete(results[index]) }
+            Log.d(TAG, "Committed inbound batch of ${batch.size} message(s)")
+        } catch (e: Exception) {
+            Log.e(TAG, "Error persisting inbound batch of ${batch.size} message(s)", e)
+        } finally {
+            // Cancellation or an unexpected error: never leave a waiter hanging.
+            batch.forEach { it.result.complete(IngestResult.FAILED) }
+        }
+    }
+
+    private suspend fun persistIsolated(
+        message: InboundMessage,
+        policy: SenderPolicySnapshot,
+        blockUnknownSenders: Boolean,
+    ): IngestResult =
+        try {
+            database.withTransaction { persistOne(message, policy, blockUnknownSenders) }
+        } catch (e: Exception) {
+            Log.e(TAG, "Error persisting message in service from ${message.sourceHash}", e)
+            IngestResult.FAILED
+        }
+
+    @Suppress("ReturnCount")
+    private suspend fun persistOne(
+        message: InboundMessage,
+        policy: SenderPolicySnapshot,
+        blockUnknownSenders: Boolean,
+    ): IngestResult {
+        val sourceHash = message.sourceHash
+        val identityHash = policy.activeIdentity.identityHash
+
+        // Prevents messages from being saved to the wrong identity after switching
+        if (message.destinationHash != null && message.destinationHash != policy.activeIdentity.destinationHash) {
+            Log.w(TAG, "Message destination ${message.destinationHash} doesn't match active identity - skipping")
+            return IngestResult.REJECTED
+        }
+        // Defense-in-depth for the LXMF ignore list (window between init and restore)
+        if (policy.isBlocked(sourceHash)) {
+            Log.d(TAG, "Blocking message from blocked peer: ${sourceHash.take(16)}")
+            return IngestResult.REJECTED
+        }
+        if (blockUnknownSenders && !policy.isContact(sourceHash)) {
+            Log.d(TAG, "Blocking message from unknown sender: ${sourceHash.take(16)}")
+            return IngestResult.REJECTED
+        }
+
+        // Composite key is id + identityHash. Also catches repeats within this batch,
+        // since earlier inserts are visible inside the transaction.
+        if (messageDao.messageExists(message.messageHash, identityHash)) {
+            Log.d(TAG, "Message already exists - skipping duplicate: ${message.messageHash}")
+            return IngestResult(
+                outcome = IngestResult.Outcome.DUPLICATE,
+                peerName = conversationDao.getConversation(sourceHash, identityHash)?.peerName,
+                unread = messageDao.isMessageUnread(message.messageHash, identityHash),
+            )
+        }
+
+        val receivedAt = System.currentTimeMillis()
+        val peerName = upsertConversation(message, policy, receivedAt)
+
+        messageDao.insertMessage(
+            MessageEntity(
+                id = message.messageHash,
+                conversationHash = sourceHash,
+                identityHash = identityHash,
+                content = TextSanitizer.sanitizeMessage(message.content),
+                timestamp = message.timestamp,
+                isFromMe = false,
+                status = "delivered",
+                isRead = false,
+                fieldsJson = message.fieldsJson,
+                replyToMessageId = message.replyToMessageId,
+                deliveryMethod = message.deliveryMethod,
+                errorMessage = null,
+                receivedHopCount = message.receivedHopCount,
+                receivedInterface = message.receivedInterface,
+                receivedRssi = message.receivedRssi,
+                receivedSnr = message.receivedSnr,
+                receivedAt = receivedAt,
+            ),
+        )
+
+        if (message.hasFileAttachments) {
+            supersedePendingFileNotifications(sourceHash, identityHash, message.messageHash)
+        }
+
+        message.publicKey?.let { publicKey ->
+            peerIdentityDao.insertPeerIdentity(
+                PeerIdentityEntity(
+                    peerHash = sourceHash,
+                    publicKey = publicKey,
+                    lastSeenTimestamp = receivedAt,
+                ),
+            )
+        }
+
+        message.iconAppearance?.let { saveIconAppearance(sourceHash, it, receivedAt) }
+
+        Log.d(TAG, "Service persisted message from ${sourceHash.take(16)}")
+        return IngestResult(IngestResult.Outcome.PERSISTED, peerName)
+    }
+
+    /**
+     * Store the sender's icon appearance (Sideband/MeshChat interop). Icons live in
+     * peer_icons (LXMF concept), separate from announces (Reticulum concept).
+     */
+    private suspend fun saveIconAppearance(
+        sourceHash: String,
+        appearance: IconAppearance,
+        updatedTimestamp: Long,
+    ) {
+        if (appearance.iconName.isEmpty() ||
+            appearance.foregroundColor.isEmpty() ||
+            appearance.backgroundColor.isEmpty()
+        ) {
+            return
+        }
+        peerIconDao.upsertIcon(
+            PeerIconEntity(
+                destinationHash = sourceHash,
+                iconName = appearance.iconName,
+                foregroundColor = appearance.foregroundColor,
+                backgroundColor = appearance.backgroundColor,
+                updatedTimestamp = updatedTimestamp,
+            ),
+        )
+    }
+
+    /** Create or update the sender's conversation and return its display name. */
+    private suspend fun upsertConversation(
+        message: InboundMessage,
+        policy: SenderPolicySnapshot,
+        receivedAt: Long,
+    ): String {
+        val sourceHash = message.sourceHash
+        val identityHash = policy.activeIdentity.identityHash
+        val existingConversation = conversationDao.getConversation(sourceHash, identityHash)
+        val sanitizedPreview = TextSanitizer.sanitizePreview(message.content)
+
+        val resolvedName =
+            PeerNameResolver.resolve(
+                peerHash = sourceHash,
+                cachedName = existingConversation?.peerName,
+                // Only non-contacts can be ruled out from the snapshot; skip the row load for them.
+                contactNicknameLookup = {
+                    if (policy.isContact(sourceHash)) contactDao.getContact(sourceHash, identityHash)?.customNickname else null
+                },
+                announcePeerNameLookup = { announceDao.getAnnounce(sourceHash)?.peerName },
+            )
+        val peerName = TextSanitizer.sanitizePeerName(resolvedName)
+
+        if (existingConversation != null) {
+            // Update peerName if we resolved a better name (nickname or announce)
+            val updatedPeerName =
+                if (PeerNameResolver.isValidPeerName(resolvedName)) peerName else existingConversation.peerName
+            conversationDao.updateConversation(
+                existingConversation.copy(
+                    peerName = updatedPeerName,
+                    lastMessage = sanitizedPreview,
+                    lastMessageTimestamp = receivedAt,
+                    unreadCount = existingConversation.unreadCount + 1,
+                    peerPublicKey = message.publicKey ?: existingConversation.peerPublicKey,
+                ),
+            )
+            return updatedPeerName
+        } else {
+            conversationDao.insertConversation(
+                ConversationEntity(
+                    peerHash = sourceHash,
+                    identityHash = identityHash,
+                    peerName = peerName,
+                    peerPublicKey = message.publicKey,
+                    lastMessage = sanitizedPreview,
+                    lastMessageTimestamp = receivedAt,
+                    unreadCount = 1,
+                    lastSeenTimestamp = 0,
+                ),
+            )
+            return peerName
+        }
+    }
+
+    private fun readBlockUnknownSenders(): Boolean =
+        try {
+            settingsAccessor.getBlockUnknownSenders()
+        } catch (e: Exception) {
+            // Fail open: if we can't read the setting, allow messages through
+            Log.w(TAG, "Error reading block-unknown-senders setting, allowing messages: ${e.message}")
+            false
+        }
+
+    /**
+     * Check if an incoming message with file attachments should supersede
+     * a pending file notification, and mark it as superseded if so.
+     *
+     * Matches notifications by original_message_id (the hash of the file message).
+     * Called only when hasFileAttachments=true, so we don't need to check fieldsJson.
+     */
+    @Suppress("SwallowedException", "TooGenericExceptionCaught")
+    private suspend fun supersedePendingFileNotifications(
+        peerHash: String,
+        identityHash: String,
+        incomingMessageId: String,
+    ) {
+        try {
+            Log.d(TAG, "Checking for pending notifications to supersede for message $incomingMessageId")
+
+            val pendingNotifications = messageDao.findPendingFileNotifications(peerHash, identityHash)
+            Log.d(TAG, "supersede: Found ${pendingNotifications.size} pending notifications")
+            if (pendingNotifications.isEmpty()) return
+
+            val match =
+                pendingNotifications.firstNotNullOfOrNull { notification ->
+                    tryParseNotificationMatch(notification, incomingMessageId)
+                } ?: return
+
+            val (notification, notificationJson, field16) = match
+            Log.d(TAG, "Superseding pending notification ${notification.id} for message $incomingMessageId")
+
+            // Mark as superseded by adding "superseded": true to field 16
+            field16.put("superseded", true)
+            notificationJson.put("16", field16)
+
+            messageDao.updateMessageFieldsJson(
+                notification.id,
+                identityHash,
+                notificationJson.toString(),
+            )
+        } catch (e: Exception) {
+            Log.w(TAG, "Error checking for pending notifications to supersede: ${e.message}")
+        }
+    }
+
+    /**
+     * Try to parse a notification and check if it matches the incoming message ID.
+     * Returns a Triple of (notification, json, field16) if matched, null otherwise.
+     */
+    @Suppress("SwallowedException", "TooGenericExceptionCaught")
+    private fun tryParseNotificationMatch(
+        notification: MessageEntity,
+        incomingMessageId: String,
+    ): Triple<MessageEntity, JSONObject, JSONObject>? {
+        return try {
+            val notificationFieldsJson = notification.fieldsJson ?: return null
+            val notificationJson = JSONObject(notificationFieldsJson)
+            val field16 = notificationJson.optJSONObject("16")
+            val pendingInfo = field16?.optJSONObject("pending_file_notification")
+            val originalMessageId = pendingInfo?.optString("original_message_id", "") ?: ""
+
+            Log.d(TAG, "supersede: Comparing incoming=$incomingMessageId vs original=$originalMessageId")
+
+            if (field16 != null && originalMessageId.isNotEmpty() && originalMessageId == incomingMessageId) {
+                Triple(notification, notificationJson, field16)
+            } else {
+                null
+            }
+        } catch (e: Exception) {
+            Log.w(TAG, "Failed to parse pending notification ${notification.id}: ${e.message}")
+            null
+        }
+    }
+}
@@ -0,0 +1,124 @@
+package network.columba.app.rns.host.persistence
+
+import android.util.Log
+import androidx.room.InvalidationTracker
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.LocalIdentityEntity
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicLong
+
+/**
+ * Point-in-time view of everything the inbound message path needs to decide
+ * whether a sender is allowed: the active identity, its blocked peers and its
+ * contacts.
+ *
+ * [failOpen] is set when the blocked/contact sets could not be loaded. In that
+ * case both checks allow the sender, matching the fail-open semantics the
+ * per-message DAO checks had.
+ */
+data class SenderPolicySnapshot(
+    val activeIdentity: LocalIdentityEntity,
+    val blockedPeers: Set<String>,
+    val contacts: Set<String>,
+    val failOpen: Boolean = false,
+) {
+    fun isBlocked(sourceHash: String): Boolean = !failOpen && sourceHash in blockedPeers
+
+    fun isContact(sourceHash: String): Boolean = failOpen || sourceHash in contacts
+}
+
+/**
+ * In-memory cache of the [SenderPolicySnapshot] for the :reticulum process.
+ *
+ * Replaces the `getActiveIdentitySync` + `isBlocked` + `contactExists` round
+ * trips that used to run for every inbound message. The snapshot is dropped
+ * whenever Room reports a write to `local_identities`, `blocked_peers` or
+ * `contacts`; because the service database is opened with multi-instance
+ * invalidation, writes made by the UI process (blocking a peer, adding a
+ * contact, switching identity) invalidate it too.
+ *
+ * Invalidation is asynchronous (Room refreshes its tracker after the writing
+ * transaction ends), so a message arriving in the same few milliseconds as a
+ * block/unblock may still be judged against the previous snapshot. That is the
+ * same race the app process already had between the UI write and the LXMF
+ * ignore-list update.
+ */
+class SenderPolicyCache(
+    private val database: ColumbaDatabase,
+) {
+    companion object {
+        private const val TAG = "SenderPolicyCache"
+
+        internal val OBSERVED_TABLES = arrayOf("local_identities", "blocked_peers", "contacts")
+    }
+
+    @Volatile
+    private var cached: SenderPolicySnapshot? = null
+
+    // Bumped on every invalidation so a load that raced with a write is not cached.
+    private val generation = AtomicLong()
+    private val observerRegistered = AtomicBoolean(false)
+
+    @Volatile
+    private var observing = false
+
+    private val observer =
+        object : InvalidationTracker.Observer(OBSERVED_TABLES) {
+            override fun onInvalidated(tables: Set<String>) {
+                invalidate()
+            }
+        }
+
+    /**
+     * Return the current snapshot, loading it from the database if there is no
+     * valid cached copy. Returns null when there is no active identity.
+     */
+    suspend fun get(): SenderPolicySnapshot? {
+        ensureObserver()
+        cached?.let { return it }
+
+        val loadGeneration = generation.get()
+        val snapshot = load() ?: return null
+        // Only cache when something will tell us it went stale.
+        if (observing && !snapshot.failOpen && generation.get() == loadGeneration) {
+            cached = snapshot
+        }
+        return snapshot
+    }
+
+    fun invalidate() {
+        generation.incrementAndGet()
+        cached = null
+    }
+
+    private suspend fun load(): SenderPolicySnapshot? {
+        val activeIdentity = database.localIdentityDao().getActiveIdentitySync() ?: return null
+        return try {
+            SenderPolicySnapshot(
+                activeIdentity = activeIdentity,
+                blockedPeers = database.blockedPeerDao().getBlockedPeerHashes(activeIdentity.identityHash).toHashSet(),
+                contacts = database.contactDao().getContactDestinationHashes(activeIdentity.identityHash).toHashSet(),
+            )
+        } catch (e: Exception) {
+            Log.w(TAG, "Error loading blocked/contact sets, allowing senders: ${e.message}")
+            SenderPolicySnapshot(
+                activeIdentity = activeIdentity,
+                blockedPeers = emptySet(),
+                contacts = emptySet(),
+                failOpen = true,
+            )
+        }
+    }
+
+    private fun ensureObserver() {
+        if (!observerRegistered.compareAndSet(false, true)) return
+        try {
+            database.invalidationTracker.addObserver(observer)
+            observing = true
+        } catch (e: Exception) {
+            // Without an observer we can't know when the snapshot goes stale, so
+            // every call reloads — same cost as before, never wrong.
+            Log.w(TAG, "Could not observe sender policy tables, caching disabled: ${e.message}")
+        }
+    }
+}
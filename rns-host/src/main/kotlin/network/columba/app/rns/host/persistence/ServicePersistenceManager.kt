@@ -4,16 +4,12 @@ import android.content.Context
 import android.util.Log
 import network.columba.app.data.db.ColumbaDatabase
 import network.columba.app.data.db.entity.AnnounceEntity
-import network.columba.app.data.db.entity.ConversationEntity
-import network.columba.app.data.db.entity.MessageEntity
 import network.columba.app.data.db.entity.PeerIdentityEntity
 import network.columba.app.data.util.HashUtils
-import network.columba.app.data.util.TextSanitizer
 import network.columba.app.rns.host.di.ServiceDatabaseProvider
 import network.columba.app.rns.host.util.PeerNameResolver
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.launch
-import org.json.JSONObject
 
 /**
  * Manages database persistence from the service process.
@@ -35,61 +31,24 @@ class ServicePersistenceManager(
         private const val ANNOUNCE_TTL_MS = 30L * 24 * 60 * 60 * 1000 // 30 days
     }
 
-    /**
-     * Check if a sender should be blocked based on privacy settings.
-     * Returns true if the message should be blocked, false if it should be allowed.
-     * Fails open: if checking contact status fails, the message is allowed through.
-     */
-    private suspend fun shouldBlockUnknownSender(
-        sourceHash: String,
-        identityHash: String,
-    ): Boolean =
-        try {
-            if (settingsAccessor.getBlockUnknownSenders()) {
-                val isKnownContact = contactDao.contactExists(sourceHash, identityHash)
-                if (!isKnownContact) {
-                    Log.d(TAG, "Blocking message from unknown sender: ${sourceHash.take(16)}")
-                    true
-                } else {
-                    false
-                }
-            } else {
-                false
-            }
-        } catch (e: Exception) {
-            // Fail open: if we can't check the contact list, allow the message through
-            Log.w(TAG, "Error checking contact status, allowing message: ${e.message}")
-            false
-        }
-
     private val database: ColumbaDatabase by lazy {
         ServiceDatabaseProvider.getDatabase(context)
     }
 
     private val announceDao by lazy { database.announceDao() }
-    private val blockedPeerDao by lazy { database.blockedPeerDao() }
     private val contactDao by lazy { database.contactDao() }
     private val messageDao by lazy { database.messageDao() }
-    private val conversationDao by lazy { database.conversationDao() }
     private val localIdentityDao by lazy { database.localIdentityDao() }
     private val peerIdentityDao by lazy { database.peerIdentityDao() }
 
     /**
-     * Check if a peer is explicitly blocked.
-     * This is defense-in-depth: catches messages during the window between
-     * Python init and LXMF ignore list restore.
-     * Fails open: if DB check fails, message is allowed through.
+     * Active identity + blocked/contact sets, kept in memory and dropped by
+     * Room table observers instead of being re-queried per inbound message.
      */
-    private suspend fun isBlockedPeer(
-        sourceHash: String,
-        identityHash: String,
-    ): Boolean =
-        try {
-            blockedPeerDao.isBlocked(sourceHash, identityHash)
-        } catch (e: Exception) {
-            Log.w(TAG, "Error checking blocked status, allowing message: ${e.message}")
-            false
-        }
+    private val senderPolicyCache by lazy { SenderPolicyCache(database) }
+
+    /** Group-commit stage that writes inbound messages in batched transactions. */
+    private val inboundIngest by lazy { InboundMessageIngest(database, senderPolicyCache, settingsAccessor) }
 
     /**
      * Persist an announce to the database.
@@ -178,6 +137,8 @@ class ServicePersistenceManager(
      * Called from EventHandler.handleMessageEvent() in the service process.
      *
      * This includes identity scoping to ensure messages are saved to the correct identity.
+     * Messages arriving while a previous write is in flight are committed together
+     * in one transaction by [InboundMessageIngest].
      *
      * This is a suspend function that completes before returning, ensuring the message
      * is fully persisted before sync completion is reported to the UI.
@@ -185,7 +146,7 @@ class ServicePersistenceManager(
      * @return true if the message was persisted (or already exists), false if blocked or error.
      *         The caller should only broadcast to the app process if this returns true.
      */
-    @Suppress("LongParameterList", "LongMethod", "ReturnCount") // Parameters mirror MessageEntity fields; early returns for clarity
+    @Suppress("LongParameterList") // Parameters mirror MessageEntity fields
     suspend fun persistMessage(
         messageHash: String,
         content: String,
@@ -200,137 +161,53 @@ class ServicePersistenceManager(
         receivedInterface: String? = null,
         receivedRssi: Int? = null,
         receivedSnr: Float? = null,
-    ): Boolean {
-        try {
-            // Get active identity to scope the message correctly
-            val activeIdentity = localIdentityDao.getActiveIdentitySync()
-            if (activeIdentity == null) {
-                Log.w(TAG, "No active identity - cannot persist message")
-                return false
-            }
-
-            // Check if this peer is explicitly blocked (defense-in-depth for LXMF ignore list)
-            if (isBlockedPeer(sourceHash, activeIdentity.identityHash)) {
-                Log.d(TAG, "Blocking message from blocked peer: ${sourceHash.take(16)}")
-                return false
-            }
-
-            // Check if we should block this sender
-            if (shouldBlockUnknownSender(sourceHash, activeIdentity.identityHash)) {
-                return false
-            }
-
-            // Check for duplicates (composite key is id + identityHash)
-            val existingMessage = messageDao.getMessageById(messageHash, activeIdentity.identityHash)
-            if (existingMessage != null) {
-                Log.d(TAG, "Message already exists - skipping duplicate: $messageHash")
-                // Return true for duplicates - message exists, app should still show notification
-                return true
-            }
-
-            // Create/update conversation
-            val existingConversation =
-                conversationDao.getConversation(
-                    sourceHash,
-                    activeIdentity.identityHash,
-                )
-
-            // Sanitize content to remove control characters and normalize whitespace
-            val sanitizedContent = TextSanitizer.sanitizeMessage(content)
-            val sanitizedPreview = TextSanitizer.sanitizePreview(content)
-
-            // Get peer name using centralized resolver, then sanitize
-            val resolvedName =
-                PeerNameResolver.resolve(
-                    peerHash = sourceHash,
-                    cachedName = existingConversation?.peerName,
-                    contactNicknameLookup = {
-                        activeIdentity?.let {
-                            contactDao.getContact(sourceHash, it.identityHash)?.customNickname
-                        }
-                    },
-                    announcePeerNameLookup = {
-                        announceDao.getAnnounce(sourceHash)?.peerName
-                    },
-                )
-            val peerName = TextSanitizer.sanitizePeerName(resolvedName)
-
-            // Use local reception time for conversation ordering (immune to sender clock skew)
-            val receivedAt = System.currentTimeMillis()
-
-            // Insert/update conversation
-            if (existingConversation != null) {
-                // Update peerName if we resolved a better name (nickname or announce)
-                val updatedPeerName =
-                    if (PeerNameResolver.isValidPeerName(resolvedName)) peerName else existingConversation.peerName
-                val updated =
-                    existingConversation.copy(
-                        peerName = updatedPeerName,
-                        lastMessage = sanitizedPreview,
-                        lastMessageTimestamp = receivedAt,
-                        unreadCount = existingConversation.unreadCount + 1,
-                        peerPublicKey = publicKey ?: existingConversation.peerPublicKey,
-                    )
-                conversationDao.updateConversation(updated)
-            } else {
-                val newConversation =
-                    ConversationEntity(
-                        peerHash = sourceHash,
-                        identityHash = activeIdentity.identityHash,
-                        peerName = peerName,
-                        peerPublicKey = publicKey,
-                        lastMessage = sanitizedPreview,
-                        lastMessageTimestamp = receivedAt,
-                        unreadCount = 1,
-                        lastSeenTimestamp = 0,
-                    )
-                conversationDao.insertConversation(newConversation)
-            }
-
-            // Insert message
-            val messageEntity =
-                MessageEntity(
-                    id = messageHash,
-                    conversationHash = sourceHash,
-                    identityHash = activeIdentity.identityHash,
-                    content = sanitizedContent,
-                    timestamp = timestamp,
-                    isFromMe = false,
-                    status = "delivered",
-                    isRead = false,
-                    fieldsJson = fieldsJson,
-                    replyToMessageId = replyToMessageId,
-                    deliveryMethod = deliveryMethod,
-                    errorMessage = null,
-                    receivedHopCount = receivedHopCount,
-                    receivedInterface = receivedInterface,
-                    receivedRssi = receivedRssi,
-                    receivedSnr = receivedSnr,
-                    receivedAt = receivedAt,
-                )
-            messageDao.insertMessage(messageEntity)
-
-            // Check if this message has file attachments and should supersede a pending notification
-            if (hasFileAttachments) {
-                supersedePendingFileNotifications(
-                    sourceHash,
-                    activeIdentity.identityHash,
-                    messageHash,
-                )
-            }
+    ): Boolean =
+        ingestMessage(
+            InboundMessage(
+                messageHash = messageHash,
+                content = content,
+                sourceHash = sourceHash,
+                timestamp = timestamp,
+                fieldsJson = fieldsJson,
+                publicKey = publicKey,
+                replyToMessageId = replyToMessageId,
+                deliveryMethod = deliveryMethod,
+                hasFileAttachments = hasFileAttachments,
+                receivedHopCount = receivedHopCount,
+                receivedInterface = receivedInterface,
+                receivedRssi = receivedRssi,
+                receivedSnr = receivedSnr,
+            ),
+        ).isAccepted
 
-            // Store peer public key if available
-            if (publicKey != null) {
-                persistPeerIdentity(sourceHash, publicKey)
-            }
+    /**
+     * Persist a received message and report what happened to it: new, a
+     * duplicate, or not stored at all.
+     */
+    suspend fun ingestMessage(message: InboundMessage): IngestResult =
+        try {
+            inboundIngest.submit(message)
+        } catch (e: Exception) {
+            Log.e(TAG, "Error persisting message in service from ${message.sourceHash}", e)
+            IngestResult.FAILED
+        }
 
-            Log.d(TAG, "Service persisted message from ${sourceHash.take(16)}")
-            return true
+    /**
+     * [ingestMessage] for a batch, written in list order through the
+     * group-commit stage.
+     *
+     * Used by [InboundMessageHandoff], which needs to tell the UI process whether
+     * each message was new, a duplicate, or not stored at all.
+     *
+     * @return one [IngestResult] per message, in the same order.
+     */
+    suspend fun ingestMessages(messages: List<InboundMessage>): List<IngestResult> =
+        try {
+            inboundIngest.submitAll(messages)
         } catch (e: Exception) {
-            Log.e(TAG, "Error persisting message in service from $sourceHash", e)
-            return false
+            Log.e(TAG, "Error persisting ${messages.size} message(s) in service", e)
+            messages.map { IngestResult.FAILED }
         }
-    }
 
     /**
      * Check if an announce exists (for de-duplication in app process).
@@ -353,88 +230,13 @@ class ServicePersistenceManager(
                 Log.w(TAG, "No active identity for message existence check")
                 return false
             }
-            messageDao.getMessageById(messageHash, activeIdentity.identityHash) != null
+            messageDao.messageExists(messageHash, activeIdentity.identityHash)
         } catch (e: Exception) {
             Log.e(TAG, "Error checking message existence: $messageHash", e)
             false
         }
     }
 
-    /**
-     * Check if an incoming message with file attachments should supersede
-     * a pending file notification, and mark it as superseded if so.
-     *
-     * Matches notifications by original_message_id (the hash of the file message).
-     * Called only when hasFileAttachments=true, so we don't need to check fieldsJson.
-     */
-    @Suppress("SwallowedException", "TooGenericExceptionCaught", "NestedBlockDepth")
-    private suspend fun supersedePendingFileNotifications(
-        peerHash: String,
-        identityHash: String,
-        incomingMessageId: String,
-    ) {
-        try {
-            Log.d(TAG, "Checking for pending notifications to supersede for message $incomingMessageId")
-
-            // Find pending notifications in this conversation
-            val pendingNotifications = messageDao.findPendingFileNotifications(peerHash, identityHash)
-            Log.d(TAG, "supersede: Found ${pendingNotifications.size} pending notifications")
-            if (pendingNotifications.isEmpty()) return
-
-            // Find matching notification using functional approach
-            val match =
-                pendingNotifications.firstNotNullOfOrNull { notification ->
-                    tryParseNotificationMatch(notification, incomingMessageId)
-                }
-
-            if (match != null) {
-                val (notification, notificationJson, field16) = match
-                Log.d(TAG, "Superseding pending notification ${notification.id} for message $incomingMessageId")
-
-                // Mark as superseded by adding "superseded": true to field 16
-                field16.put("superseded", true)
-                notificationJson.put("16", field16)
-
-                messageDao.updateMessageFieldsJson(
-                    notification.id,
-                    identityHash,
-                    notificationJson.toString(),
-                )
-            }
-        } catch (e: Exception) {
-            Log.w(TAG, "Error checking for pending notifications to supersede: ${e.message}")
-        }
-    }
-
-    /**
-     * Try to parse a notification and check if it matches the incoming message ID.
-     * Returns a Triple of (notification, json, field16) if matched, null otherwise.
-     */
-    @Suppress("SwallowedException", "TooGenericExceptionCaught")
-    private fun tryParseNotificationMatch(
-        notification: MessageEntity,
-        incomingMessageId: String,
-    ): Triple<MessageEntity, JSONObject, JSONObject>? {
-        return try {
-            val notificationFieldsJson = notification.fieldsJson ?: return null
-            val notificationJson = JSONObject(notificationFieldsJson)
-            val field16 = notificationJson.optJSONObject("16")
-            val pendingInfo = field16?.optJSONObject("pending_file_notification")
-            val originalMessageId = pendingInfo?.optString("original_message_id", "") ?: ""
-
-            Log.d(TAG, "supersede: Comparing incoming=$incomingMessageId vs original=$originalMessageId")
-
-            if (field16 != null && originalMessageId.isNotEmpty() && originalMessageId == incomingMessageId) {
-                Triple(notification, notificationJson, field16)
-            } else {
-                null
-            }
-        } catch (e: Exception) {
-            Log.w(TAG, "Failed to parse pending notification ${notification.id}: ${e.message}")
-            null
-        }
-    }
-
     /**
      * Look up display name for a peer with priority:
      * 1. Contact's custom nickname (user-set, by destination hash)
@@ -1,6 +1,10 @@
 package network.columba.app.rns.host.persistence
 
 import android.content.Context
+import android.content.SharedPreferences
+import java.io.Closeable
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicLong
 
 /**
  * Service-side accessor for settings that need cross-process communication.
@@ -10,10 +14,16 @@ import android.content.Context
  * errors when both the service and main app try to access the same file.
  *
  * Settings written here are read by the main app's SettingsRepository via SharedPreferences.
+ *
+ * The privacy flags are read on every inbound message and call, so they are kept as one
+ * parsed [PrivacySettings] and only reloaded after [CrossProcessSettingsSignal] (a write by
+ * either process) or a same-process edit. If the file can't be watched, every read goes to
+ * the prefs as before.
  */
 @Suppress("DEPRECATION") // MODE_MULTI_PROCESS is deprecated but necessary for cross-process access
 class ServiceSettingsAccessor(
     private val context: Context,
+    private val signal: CrossProcessSettingsSignal = CrossProcessSettingsSignal(context),
 ) {
     companion object {
         // SharedPreferences file for cross-process communication
@@ -28,9 +38,63 @@ class ServiceSettingsAccessor(
         const val KEY_LAST_NETWORK_STATUS = "last_network_status"
     }
 
+    /** The settings the service checks per inbound message or call, read together. */
+    private data class PrivacySettings(
+        val blockUnknownSenders: Boolean,
+        val allowCallsFromContactsOnly: Boolean,
+        val allowVoiceCalls: Boolean,
+    )
+
+    @Volatile
+    private var cached: PrivacySettings? = null
+
+    // Bumped on every invalidation so a load that raced with a write is not cached.
+    private val generation = AtomicLong()
+    private val watchStarted = AtomicBoolean(false)
+
+    @Volatile
+    private var watching = false
+
+    // Both must stay referenced: SharedPreferences holds listeners weakly, and a
+    // collected FileObserver stops watching.
+    private var watchHandle: Closeable? = null
+    private val sameProcessListener =
+        SharedPreferences.OnSharedPreferenceChangeListener { _, _ -> invalidate() }
+
     // Get fresh SharedPreferences each time to avoid caching issues across processes
     private fun getCrossProcessPrefs() = context.getSharedPreferences(CROSS_PROCESS_PREFS_NAME, Context.MODE_MULTI_PROCESS)
 
+    private fun privacySettings(): PrivacySettings {
+        ensureWatching()
+        cached?.let { return it }
+
+        val loadGeneration = generation.get()
+        val prefs = getCrossProcessPrefs()
+        val settings =
+            PrivacySettings(
+                blockUnknownSenders = prefs.getBoolean(KEY_BLOCK_UNKNOWN_SENDERS, false),
+                allowCallsFromContactsOnly = prefs.getBoolean(KEY_ALLOW_CALLS_FROM_CONTACTS_ONLY, false),
+                allowVoiceCalls = prefs.getBoolean(KEY_ALLOW_VOICE_CALLS, true),
+            )
+        // Only cache when something will tell us it went stale.
+        if (watching && generation.get() == loadGeneration) {
+            cached = settings
+        }
+        return settings
+    }
+
+    private fun invalidate() {
+        generation.incrementAndGet()
+        cached = null
+    }
+
+    private fun ensureWatching() {
+        if (!watchStarted.compareAndSet(false, true)) return
+        getCrossProcessPrefs().registerOnSharedPreferenceChangeListener(sameProcessListener)
+        watchHandle = signal.watch { invalidate() }
+        watching = watchHandle != null
+    }
+
     /**
      * Save the network change announce timestamp.
      * Called when a network topology change triggers an announce, signaling the main app's
@@ -62,12 +126,11 @@ class ServiceSettingsAccessor(
      * Get the block unknown senders setting.
      * When enabled, messages from senders not in the contacts list should be discarded.
      *
-     * Uses SharedPreferences with MODE_MULTI_PROCESS to read settings written by the app process.
-     * Gets a fresh SharedPreferences instance each time to ensure we see cross-process updates.
+     * Reads the cached [PrivacySettings], reloaded whenever the app process writes the file.
      *
      * @return true if unknown senders should be blocked, false otherwise (default)
      */
-    fun getBlockUnknownSenders(): Boolean = getCrossProcessPrefs().getBoolean(KEY_BLOCK_UNKNOWN_SENDERS, false)
+    fun getBlockUnknownSenders(): Boolean = privacySettings().blockUnknownSenders
 
     /**
      * Get the calls-from-contacts-only setting.
@@ -76,8 +139,7 @@ class ServiceSettingsAccessor(
      *
      * @return true if non-contact callers should be silently dropped, false (default) otherwise
      */
-    fun getAllowCallsFromContactsOnly(): Boolean =
-        getCrossProcessPrefs().getBoolean(KEY_ALLOW_CALLS_FROM_CONTACTS_ONLY, false)
+    fun getAllowCallsFromContactsOnly(): Boolean = privacySettings().allowCallsFromContactsOnly
 
     /**
      * Get the master allow-voice-calls setting.
@@ -88,8 +150,7 @@ class ServiceSettingsAccessor(
      *
      * @return true (default) if incoming voice calls should be accepted, false otherwise
      */
-    fun getAllowVoiceCalls(): Boolean =
-        getCrossProcessPrefs().getBoolean(KEY_ALLOW_VOICE_CALLS, true)
+    fun getAllowVoiceCalls(): Boolean = privacySettings().allowVoiceCalls
 
     /**
      * Persist the app process's current network-status string so the service process can
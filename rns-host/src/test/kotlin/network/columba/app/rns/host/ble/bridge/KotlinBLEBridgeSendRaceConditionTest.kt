@@ -15,8 +15,10 @@ import io.mockk.coEvery
 import io.mockk.coVerify
 import io.mockk.every
 import io.mockk.mockk
+import kotlinx.coroutines.CompletableDeferred
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.sync.Mutex
 import org.junit.After
 import org.junit.Assert.assertFalse
 import org.junit.Assert.assertTrue
@@ -275,6 +277,39 @@ class KotlinBLEBridgeSendRaceConditionTest {
         coVerify(exactly = 0) { mockGattServer.notifyCentrals(any(), any()) }
     }
 
+    @Test
+    fun `send releases the peer mutex while a peripheral notification is queued`() {
+        /**
+         * notifyCentrals suspends while the central's notification queue is full.
+         * The route is decided under the mutex, but the send must not hold it, or
+         * dedup transitions and disconnect handling for the peer would wait on the
+         * slowest central.
+         */
+        val bridge = createBridgeWithMocks()
+        val address = "AA:BB:CC:DD:EE:01"
+        val identityHash = "ab5609dfffb33b21a102e1ff81196be5"
+        val data = byteArrayOf(0x01, 0x02, 0x03)
+
+        addMockPeer(bridge, address, identityHash, isCentral = false, isPeripheral = true)
+        setAddressToIdentity(bridge, address, identityHash)
+
+        val queueFull = CompletableDeferred<Unit>()
+        coEvery { mockGattServer.notifyCentrals(any(), any()) } coAnswers {
+            queueFull.await()
+            Result.success(Unit)
+        }
+
+        runBlocking {
+            bridge.sendAsync(address, data)
+            delay(50) // Let send reach notifyCentrals and suspend there
+
+            coVerify { mockGattServer.notifyCentrals(data, address) }
+            assertFalse("Peer mutex must be free while the send waits", getStateMutex(getPeer(bridge, address)!!).isLocked)
+
+            queueFull.complete(Unit)
+        }
+    }
+
     // ========== Helper Methods ==========
 
     private fun createBridgeWithMocks(): KotlinBLEBridge {
@@ -358,6 +393,12 @@ class KotlinBLEBridgeSendRaceConditionTest {
         return connectedPeers[address]
     }
 
+    private fun getStateMutex(peer: Any): Mutex {
+        val field = peer::class.java.getDeclaredField("stateMutex")
+        field.isAccessible = true
+        return field.get(peer) as Mutex
+    }
+
     private fun setDeduplicationState(
         peer: Any,
         stateName: String,
@@ -177,11 +177,10 @@ class BleScannerRemoveDeviceTest {
                 lastSeen = System.currentTimeMillis(),
             )
 
-        // Access private devices map and mutex
+        // Access private device index and mutex
         val devicesField = BleScanner::class.java.getDeclaredField("devices")
         devicesField.isAccessible = true
-        @Suppress("UNCHECKED_CAST")
-        val devices = devicesField.get(scanner) as MutableMap<String, Any>
+        val devices = devicesField.get(scanner) as ScannedDeviceIndex
 
         val mutexField = BleScanner::class.java.getDeclaredField("devicesMutex")
         mutexField.isAccessible = true
@@ -195,8 +194,8 @@ class BleScannerRemoveDeviceTest {
                 as kotlinx.coroutines.flow.MutableStateFlow<Map<String, network.columba.app.rns.host.ble.model.BleDevice>>
 
         mutex.withLock {
-            devices[address] = device
-            discoveredDevicesFlow.value = devices.toMap() as Map<String, network.columba.app.rns.host.ble.model.BleDevice>
+            devices.put(device)
+            discoveredDevicesFlow.value = devices.toMap()
         }
     }
 
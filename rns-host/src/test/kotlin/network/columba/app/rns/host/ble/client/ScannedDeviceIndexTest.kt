@@ -0,0 +1,226 @@
+package network.columba.app.rns.host.ble.client
+
+import android.bluetooth.le.ScanCallback
+import network.columba.app.rns.host.ble.model.BleDevice
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import kotlin.random.Random
+
+/**
+ * Unit tests for ScannedDeviceIndex and ScanDeliveryPolicy, fed with synthetic
+ * scan-result streams in the shapes each delivery mode produces.
+ */
+class ScannedDeviceIndexTest {
+    private val baseMs = System.currentTimeMillis()
+
+    private fun sighting(
+        n: Int,
+        rssi: Int = -60,
+        atMs: Long = baseMs,
+        lost: Boolean = false,
+    ) = ScanSighting(
+        address = "AA:BB:CC:DD:EE:%02X".format(n),
+        name = "node$n",
+        rssi = rssi,
+        seenAtMs = atMs,
+        lost = lost,
+    )
+
+    private fun ScannedDeviceIndex.expectedOrder(): List<String> =
+        toMap().values.sortedByDescending { it.calculatePriorityScore() }.map { it.address }
+
+    // ========== Index Tests ==========
+
+    @Test
+    fun `immediate stream reports each device once and tracks rssi`() {
+        val index = ScannedDeviceIndex()
+
+        val first = index.apply(listOf(sighting(1, rssi = -70)))
+        val again = index.apply(listOf(sighting(1, rssi = -50, atMs = baseMs + 100)))
+
+        assertEquals(listOf("AA:BB:CC:DD:EE:01"), first.discovered.map { it.address })
+        assertTrue(again.discovered.isEmpty())
+        assertTrue(again.changed)
+        assertEquals(-50, index["AA:BB:CC:DD:EE:01"]?.rssi)
+    }
+
+    @Test
+    fun `batch applies in order and ignores weak and out-of-order sightings`() {
+        val index = ScannedDeviceIndex()
+
+        val update =
+            index.apply(
+                listOf(
+                    sighting(1, rssi = -60, atMs = baseMs + 200),
+                    sighting(2, rssi = -95), // below MIN_RSSI_DBM
+                    sighting(1, rssi = -80, atMs = baseMs + 100), // older than what we have
+                    sighting(3, rssi = -65, atMs = baseMs + 300),
+                ),
+            )
+
+        assertEquals(listOf("AA:BB:CC:DD:EE:01", "AA:BB:CC:DD:EE:03"), update.discovered.map { it.address })
+        assertEquals(2, index.size)
+        assertEquals(-60, index["AA:BB:CC:DD:EE:01"]?.rssi)
+        assertEquals(baseMs + 200, index["AA:BB:CC:DD:EE:01"]?.lastSeen)
+    }
+
+    @Test
+    fun `match tracking stream drops lost devices and rediscovers them`() {
+        val index = ScannedDeviceIndex()
+        index.apply(listOf(sighting(1), sighting(2)))
+
+        val lost = index.apply(listOf(sighting(1, lost = true)))
+        val lostAgain = index.apply(listOf(sighting(1, lost = true)))
+        val back = index.apply(listOf(sighting(1, atMs = baseMs + 5_000)))
+
+        assertEquals(listOf("AA:BB:CC:DD:EE:01"), lost.lost)
+        assertFalse(lostAgain.changed)
+        assertEquals(listOf("AA:BB:CC:DD:EE:01"), back.discovered.map { it.address })
+    }
+
+    @Test
+    fun `priority order matches the full score as sightings move devices`() {
+        val index = ScannedDeviceIndex()
+        val random = Random(7)
+
+        repeat(2_000) { i ->
+            val n = random.nextInt(40)
+            index.apply(listOf(sighting(n, rssi = -85 + random.nextInt(60), atMs = baseMs - random.nextLong(120_000))))
+            if (i % 250 == 0) {
+                assertEquals(index.expectedOrder(), index.sortedByPriority().map { it.address })
+            }
+        }
+        assertEquals(index.expectedOrder(), index.sortedByPriority().map { it.address })
+    }
+
+    @Test
+    fun `long-unseen devices get no more recency than the score gives them`() {
+        val index = ScannedDeviceIndex()
+        // Both are past the 25-point recency window, so the stronger signal wins
+        index.apply(
+            listOf(
+                sighting(1, rssi = -60, atMs = baseMs - 600_000),
+                sighting(2, rssi = -62, atMs = baseMs - 300_000),
+            ),
+        )
+
+        assertEquals(listOf("AA:BB:CC:DD:EE:01", "AA:BB:CC:DD:EE:02"), index.sortedByPriority().map { it.address })
+        assertEquals(index.expectedOrder(), index.sortedByPriority().map { it.address })
+    }
+
+    @Test
+    fun `order is re-ranked as devices age out of the recency window`() {
+        val index = ScannedDeviceIndex()
+        index.apply(
+            listOf(
+                sighting(1, rssi = -50, atMs = baseMs - 200_000),
+                sighting(2, rssi = -70, atMs = baseMs),
+            ),
+        )
+        val later = baseMs + 100_000
+
+        assertEquals("AA:BB:CC:DD:EE:02", index.sortedByPriority(baseMs).first().address)
+        val reranked = index.sortedByPriority(later).map { it.address }
+        assertEquals("AA:BB:CC:DD:EE:01", reranked.first())
+        assertEquals(
+            index.toMap().values.sortedByDescending { it.priorityRank(referenceMs = later) }.map { it.address },
+            reranked,
+        )
+    }
+
+    @Test
+    fun `connection history is part of the order`() {
+        val index = ScannedDeviceIndex()
+        index.apply(listOf(sighting(1, rssi = -60), sighting(2, rssi = -62)))
+
+        index.put(
+            index["AA:BB:CC:DD:EE:02"]!!.copy(connectionAttempts = 2, successfulConnections = 2),
+        )
+
+        assertEquals("AA:BB:CC:DD:EE:02", index.sortedByPriority().first().address)
+        assertTrue(index.remove("AA:BB:CC:DD:EE:02"))
+        assertNull(index["AA:BB:CC:DD:EE:02"])
+        assertEquals(listOf("AA:BB:CC:DD:EE:01"), index.sortedByPriority().map { it.address })
+    }
+
+    @Test
+    fun `crowded stream costs less than re-sorting per advertisement`() {
+        val beacons = 60
+        val advertisements = 20_000
+        val stream = List(advertisements) { i -> sighting(i % beacons, rssi = -40 - (i * 7) % 45, atMs = baseMs + i) }
+
+        // Before: per advertisement, copy the map; per query, sort everything
+        val legacy = HashMap<String, BleDevice>()
+        var legacySnapshot: Map<String, BleDevice> = emptyMap()
+        var legacyTop: List<BleDevice> = emptyList()
+        val legacyStart = System.nanoTime()
+        stream.forEachIndexed { i, s ->
+            val existing = legacy[s.address]
+            legacy[s.address] = existing?.copy(rssi = s.rssi, lastSeen = s.seenAtMs)
+                ?: BleDevice(s.address, s.name, s.rssi, firstSeen = s.seenAtMs, lastSeen = s.seenAtMs)
+            legacySnapshot = legacy.toMap()
+            if (i % 100 == 0) legacyTop = legacy.values.sortedByDescending { it.calculatePriorityScore() }
+        }
+        val legacyMs = (System.nanoTime() - legacyStart) / 1_000_000
+
+        // After: batches of 50 (a 1s report delay on a busy channel), one publish per batch
+        val index = ScannedDeviceIndex()
+        var snapshot: Map<String, BleDevice> = emptyMap()
+        var top: List<BleDevice> = emptyList()
+        val indexStart = System.nanoTime()
+        stream.chunked(50).forEachIndexed { batch, sightings ->
+            if (index.apply(sightings).changed) snapshot = index.toMap()
+            if (batch % 2 == 0) top = index.sortedByPriority()
+        }
+        val indexMs = (System.nanoTime() - indexStart) / 1_000_000
+        println(
+            "$beacons beacons × $advertisements adverts: per-advert ${legacyMs}ms " +
+                "(${advertisements} publishes), batched index ${indexMs}ms (${advertisements / 50} publishes)",
+        )
+
+        assertEquals(legacySnapshot.keys, snapshot.keys)
+        assertEquals(legacyTop.size, top.size)
+        assertEquals(index.expectedOrder(), index.sortedByPriority().map { it.address })
+    }
+
+    // ========== Delivery Policy Tests ==========
+
+    @Test
+    fun `policy batches while discovering and tracks matches when idle`() {
+        val policy = ScanDeliveryPolicy(batchingSupported = true, trackingSupported = true)
+
+        assertEquals(ScanDelivery.BATCHED, policy.choose(idle = false))
+        assertEquals(ScanDelivery.MATCH_TRACKING, policy.choose(idle = true))
+    }
+
+    @Test
+    fun `policy falls back when the controller refuses a mode`() {
+        val policy = ScanDeliveryPolicy(batchingSupported = true, trackingSupported = true)
+
+        assertTrue(policy.onScanFailed(ScanDelivery.MATCH_TRACKING, ScanCallback.SCAN_FAILED_OUT_OF_HARDWARE_RESOURCES))
+        assertEquals(ScanDelivery.BATCHED, policy.choose(idle = true))
+
+        assertTrue(policy.onScanFailed(ScanDelivery.BATCHED, ScanCallback.SCAN_FAILED_FEATURE_UNSUPPORTED))
+        assertEquals(ScanDelivery.IMMEDIATE, policy.choose(idle = false))
+        assertFalse(policy.onScanFailed(ScanDelivery.IMMEDIATE, ScanCallback.SCAN_FAILED_FEATURE_UNSUPPORTED))
+    }
+
+    @Test
+    fun `policy does not fall back for unrelated failures`() {
+        val policy = ScanDeliveryPolicy(batchingSupported = true, trackingSupported = false)
+
+        assertFalse(policy.onScanFailed(ScanDelivery.BATCHED, ScanCallback.SCAN_FAILED_APPLICATION_REGISTRATION_FAILED))
+        assertEquals(ScanDelivery.BATCHED, policy.choose(idle = true))
+    }
+
+    @Test
+    fun `policy without offload scans immediately`() {
+        val policy = ScanDeliveryPolicy(batchingSupported = false, trackingSupported = false)
+
+        assertEquals(ScanDelivery.IMMEDIATE, policy.choose(idle = false))
+        assertEquals(ScanDelivery.IMMEDIATE, policy.choose(idle = true))
+    }
+}
@@ -0,0 +1,276 @@
+package network.columba.app.rns.host.ble.server
+
+import android.bluetooth.BluetoothDevice
+import network.columba.app.rns.host.ble.model.BleConstants
+import io.mockk.every
+import io.mockk.mockk
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.test.StandardTestDispatcher
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Unit tests for BleNotificationQueue.
+ *
+ * A fake GATT server stands in for BluetoothGattServer: it records every
+ * notification and reports delivery through onNotificationSent, either
+ * immediately or when the test says so.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class BleNotificationQueueTest {
+    private val centralA = device("AA:AA:AA:AA:AA:AA")
+    private val centralB = device("BB:BB:BB:BB:BB:BB")
+
+    private fun device(address: String): BluetoothDevice =
+        mockk<BluetoothDevice>().also { every { it.address } returns address }
+
+    /**
+     * Fake GATT server. [busyResponses] makes the next calls report
+     * ERROR_GATT_WRITE_REQUEST_BUSY; [autoConfirm] reports delivery at once.
+     */
+    private class FakeGattServer(
+        var autoConfirm: Boolean = false,
+    ) {
+        lateinit var queue: BleNotificationQueue
+        val sent = mutableListOf<Pair<String, String>>()
+        var busyResponses = 0
+
+        fun notify(
+            device: BluetoothDevice,
+            value: ByteArray,
+        ): Int {
+            if (busyResponses > 0) {
+                busyResponses--
+                return BleConstants.ERROR_GATT_WRITE_REQUEST_BUSY
+            }
+            sent.add(device.address to value.decodeToString())
+            if (autoConfirm) queue.onNotificationSent(device.address, BleConstants.GATT_SUCCESS)
+            return BleConstants.GATT_SUCCESS
+        }
+
+        fun confirm(device: BluetoothDevice) = queue.onNotificationSent(device.address, BleConstants.GATT_SUCCESS)
+
+        fun sentTo(device: BluetoothDevice) = sent.filter { it.first == device.address }.map { it.second }
+    }
+
+    private fun TestScope.createQueue(
+        server: FakeGattServer,
+        maxDepth: Int = 8,
+    ): BleNotificationQueue =
+        BleNotificationQueue(
+            scope = backgroundScope,
+            dispatcher = StandardTestDispatcher(testScheduler),
+            notifier = server::notify,
+            maxDepth = maxDepth,
+            sentTimeoutMs = 1000L,
+        ).also {
+            server.queue = it
+            it.open(centralA)
+            it.open(centralB)
+        }
+
+    // ========== Flow Control Tests ==========
+
+    @Test
+    fun `waits for onNotificationSent before sending the next value`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server)
+
+            listOf("1", "2", "3").forEach { queue.enqueue(centralA, it.encodeToByteArray()) }
+            runCurrent()
+            assertEquals(listOf("1"), server.sentTo(centralA))
+
+            server.confirm(centralA)
+            runCurrent()
+            assertEquals(listOf("1", "2"), server.sentTo(centralA))
+
+            server.confirm(centralA)
+            runCurrent()
+            assertEquals(listOf("1", "2", "3"), server.sentTo(centralA))
+        }
+
+    @Test
+    fun `each value is sent as its own payload in order`() =
+        runTest {
+            val server = FakeGattServer(autoConfirm = true)
+            val queue = createQueue(server)
+
+            val values = (0 until 100).map { "fragment_$it" }
+            values.forEach { queue.enqueue(centralA, it.encodeToByteArray()) }
+            runCurrent()
+
+            assertEquals(values, server.sentTo(centralA))
+        }
+
+    @Test
+    fun `a slow central does not block others`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server)
+
+            queue.enqueue(centralA, "a1".encodeToByteArray())
+            queue.enqueue(centralA, "a2".encodeToByteArray())
+            queue.enqueue(centralB, "b1".encodeToByteArray())
+            queue.enqueue(centralB, "b2".encodeToByteArray())
+            runCurrent()
+
+            // A never confirms; B's deliveries keep flowing
+            server.confirm(centralB)
+            runCurrent()
+
+            assertEquals(listOf("a1"), server.sentTo(centralA))
+            assertEquals(listOf("b1", "b2"), server.sentTo(centralB))
+        }
+
+    @Test
+    fun `missing callback times out instead of stalling the queue`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server)
+
+            queue.enqueue(centralA, "1".encodeToByteArray())
+            queue.enqueue(centralA, "2".encodeToByteArray())
+            runCurrent()
+            assertEquals(listOf("1"), server.sentTo(centralA))
+
+            advanceTimeBy(1001L)
+            runCurrent()
+            assertEquals(listOf("1", "2"), server.sentTo(centralA))
+        }
+
+    @Test
+    fun `late callback for a timed out send does not complete the next one`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server)
+
+            listOf("1", "2", "3").forEach { queue.enqueue(centralA, it.encodeToByteArray()) }
+            runCurrent()
+            advanceTimeBy(1001L)
+            runCurrent()
+            assertEquals(listOf("1", "2"), server.sentTo(centralA))
+
+            // Belongs to "1"; "2" is still waiting for its own
+            server.confirm(centralA)
+            runCurrent()
+            assertEquals(listOf("1", "2"), server.sentTo(centralA))
+
+            server.confirm(centralA)
+            runCurrent()
+            assertEquals(listOf("1", "2", "3"), server.sentTo(centralA))
+        }
+
+    @Test
+    fun `a late callback that never arrives costs one timeout`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server)
+
+            listOf("1", "2", "3", "4").forEach { queue.enqueue(centralA, it.encodeToByteArray()) }
+            runCurrent()
+            advanceTimeBy(1001L)
+            runCurrent()
+
+            // "1" never confirms, so "2"'s callback is taken for it and "2" times out
+            server.confirm(centralA)
+            runCurrent()
+            advanceTimeBy(1001L)
+            runCurrent()
+            assertEquals(listOf("1", "2", "3"), server.sentTo(centralA))
+
+            // Nothing is owed for "2": callbacks match their sends again
+            server.confirm(centralA)
+            runCurrent()
+            assertEquals(listOf("1", "2", "3", "4"), server.sentTo(centralA))
+        }
+
+    @Test
+    fun `busy stack is retried rather than dropped`() =
+        runTest {
+            val server = FakeGattServer(autoConfirm = true)
+            server.busyResponses = 2
+            val queue = createQueue(server)
+
+            queue.enqueue(centralA, "1".encodeToByteArray())
+            advanceTimeBy(BleConstants.NOTIFY_BUSY_RETRY_DELAY_MS * 2 + 1)
+            runCurrent()
+
+            assertEquals(listOf("1"), server.sentTo(centralA))
+        }
+
+    // ========== Backpressure Tests ==========
+
+    @Test
+    fun `enqueue suspends once the central's queue is full`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server, maxDepth = 2)
+
+            var accepted = 0
+            launch {
+                repeat(5) {
+                    queue.enqueue(centralA, "$it".encodeToByteArray())
+                    accepted++
+                }
+            }
+            runCurrent()
+
+            // One in flight + two buffered; the 4th enqueue is suspended
+            assertEquals(listOf("0"), server.sentTo(centralA))
+            assertEquals(3, accepted)
+
+            server.confirm(centralA)
+            runCurrent()
+            assertEquals(4, accepted)
+        }
+
+    @Test
+    fun `removing a central fails senders waiting on its full queue`() =
+        runTest {
+            val server = FakeGattServer()
+            val queue = createQueue(server, maxDepth = 1)
+
+            queue.enqueue(centralA, "0".encodeToByteArray())
+            runCurrent()
+            queue.enqueue(centralA, "1".encodeToByteArray())
+
+            var result: Result<Unit>? = null
+            launch { result = queue.enqueue(centralA, "2".encodeToByteArray()) }
+            runCurrent()
+            assertEquals(null, result)
+
+            queue.remove(centralA.address)
+            runCurrent()
+            assertTrue(result!!.isFailure)
+
+            // A reconnect starts from an empty queue
+            server.autoConfirm = true
+            queue.open(centralA)
+            assertTrue(queue.enqueue(centralA, "3".encodeToByteArray()).isSuccess)
+            runCurrent()
+            assertEquals(listOf("0", "3"), server.sentTo(centralA))
+        }
+
+    @Test
+    fun `enqueue after disconnect fails without recreating the queue`() =
+        runTest {
+            val server = FakeGattServer(autoConfirm = true)
+            val queue = createQueue(server)
+
+            queue.remove(centralA.address)
+            val result = queue.enqueue(centralA, "late".encodeToByteArray())
+            runCurrent()
+
+            assertTrue(result.isFailure)
+            assertEquals(emptyList<String>(), server.sentTo(centralA))
+            // Still nothing queued for it: the next send fails too
+            assertTrue(queue.enqueue(centralA, "later".encodeToByteArray()).isFailure)
+        }
+}
@@ -0,0 +1,228 @@
+// BluetoothGatt, BluetoothDevice and characteristics are Android framework classes
+@file:Suppress("NoRelaxedMocks")
+
+package network.columba.app.rns.host.ble.util
+
+import android.bluetooth.BluetoothDevice
+import android.bluetooth.BluetoothGatt
+import android.bluetooth.BluetoothGattCharacteristic
+import io.mockk.every
+import io.mockk.mockk
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeout
+import network.columba.app.rns.host.ble.util.BleOperationQueue.BleOperation
+import network.columba.app.rns.host.ble.util.BleOperationQueue.OperationResult
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
+import org.junit.Test
+import java.util.Collections
+
+/**
+ * Tests for BleOperationQueue's per-connection lanes, priority and adaptive
+ * timeouts, against fake GATT objects whose callbacks are driven by the test.
+ */
+class BleOperationQueueLaneTest {
+    private val callbacks = CoroutineScope(Dispatchers.Default + SupervisorJob())
+    private val queue = BleOperationQueue()
+
+    /** Operations in the order the fake GATT objects saw them start. */
+    private val started = Collections.synchronizedList(mutableListOf<String>())
+
+    @After
+    fun tearDown() {
+        queue.shutdown()
+        callbacks.cancel()
+    }
+
+    /**
+     * A fake connection to [address]. Writes and reads complete [writeLatencyMs]
+     * after they start; service discovery completes after [discoveryLatencyMs],
+     * or never if null.
+     */
+    private fun fakeGatt(
+        address: String,
+        writeLatencyMs: Long = 5,
+        discoveryLatencyMs: Long? = null,
+    ): BluetoothGatt {
+        val device = mockk<BluetoothDevice> { every { this@mockk.address } returns address }
+        val gatt = mockk<BluetoothGatt>(relaxed = true)
+        every { gatt.device } returns device
+        every { gatt.discoverServices() } answers {
+            started.add("$address:services")
+            discoveryLatencyMs?.let { respond(address, "services", it) }
+            true
+        }
+        @Suppress("DEPRECATION")
+        every { gatt.writeCharacteristic(any<BluetoothGattCharacteristic>()) } answers {
+            started.add("$address:write")
+            respond(address, "write", writeLatencyMs)
+            true
+        }
+        every { gatt.readCharacteristic(any()) } answers {
+            started.add("$address:read")
+            respond(address, "read", writeLatencyMs)
+            true
+        }
+        return gatt
+    }
+
+    private fun respond(
+        address: String,
+        key: String,
+        afterMs: Long,
+    ) {
+        callbacks.launch {
+            delay(afterMs)
+            queue.completeOperationByKey(address, key, OperationResult.Success())
+        }
+    }
+
+    private fun write(gatt: BluetoothGatt) = BleOperation.WriteCharacteristic(gatt, mockk(relaxed = true), byteArrayOf(0x01))
+
+    private fun read(gatt: BluetoothGatt) = BleOperation.ReadCharacteristic(gatt, mockk(relaxed = true))
+
+    // ========== Head-of-Line Blocking Tests ==========
+
+    @Test
+    fun `slow discovery on one peer does not delay writes to another`() =
+        runBlocking {
+            val slowPeer = fakeGatt("AA:AA:AA:AA:AA:01", discoveryLatencyMs = 2_000)
+            val fastPeer = fakeGatt("AA:AA:AA:AA:AA:02", writeLatencyMs = 5)
+
+            val discovery = async { queue.enqueue(BleOperation.DiscoverServices(slowPeer), timeoutMs = 5_000) }
+            delay(50) // discovery is in flight
+
+            val startNs = System.nanoTime()
+            val writes = List(20) { async { queue.enqueue(write(fastPeer)) } }
+            withTimeout(1_500) { writes.awaitAll() }
+            val writesMs = (System.nanoTime() - startNs) / 1_000_000
+
+            assertFalse("Discovery should still be in flight", discovery.isCompleted)
+            println("20 writes to peer B during a 2000ms discovery on peer A: ${writesMs}ms")
+
+            assertTrue(discovery.await() is OperationResult.Success)
+        }
+
+    @Test
+    fun `completion for one peer does not complete another peer's operation`() =
+        runBlocking {
+            val peerA = fakeGatt("AA:AA:AA:AA:AA:01", discoveryLatencyMs = null)
+            val peerB = fakeGatt("AA:AA:AA:AA:AA:02", discoveryLatencyMs = null)
+
+            val discoveryA = async { queue.enqueue(BleOperation.DiscoverServices(peerA), timeoutMs = 2_000) }
+            val discoveryB = async { queue.enqueue(BleOperation.DiscoverServices(peerB), timeoutMs = 2_000) }
+            delay(100)
+
+            queue.completeOperationByKey("AA:AA:AA:AA:AA:02", "services", OperationResult.Success("B"))
+            // Wrong kind for A's in-flight operation: dropped
+            queue.completeOperationByKey("AA:AA:AA:AA:AA:01", "write", OperationResult.Success("stray"))
+
+            assertEquals(OperationResult.Success("B"), discoveryB.await())
+            assertFalse(discoveryA.isCompleted)
+
+            queue.completeOperationByKey("AA:AA:AA:AA:AA:01", "services", OperationResult.Success("A"))
+            assertEquals(OperationResult.Success("A"), discoveryA.await())
+        }
+
+    // ========== Priority Tests ==========
+
+    @Test
+    fun `data writes run before queued setup operations on the same peer`() =
+        runBlocking {
+            val peer = fakeGatt("AA:AA:AA:AA:AA:01", writeLatencyMs = 20, discoveryLatencyMs = 200)
+
+            val discovery = async { queue.enqueue(BleOperation.DiscoverServices(peer)) }
+            delay(50) // discovery is in flight, everything below queues behind it
+            val reads = List(3) { async { queue.enqueue(read(peer)) } }
+            delay(20)
+            val dataWrite = async { queue.enqueue(write(peer)) }
+
+            (reads + dataWrite + discovery).awaitAll()
+
+            assertEquals(
+                listOf("services", "write", "read", "read", "read"),
+                started.map { it.substringAfterLast(':') },
+            )
+        }
+
+    @Test
+    fun `explicit priority overrides the default`() =
+        runBlocking {
+            val peer = fakeGatt("AA:AA:AA:AA:AA:01", writeLatencyMs = 20, discoveryLatencyMs = 200)
+
+            val discovery = async { queue.enqueue(BleOperation.DiscoverServices(peer)) }
+            delay(50)
+            val bulk = async { queue.enqueue(write(peer), priority = BleOperationQueue.Priority.NORMAL) }
+            delay(20)
+            val urgent = async { queue.enqueue(read(peer), priority = BleOperationQueue.Priority.HIGH) }
+
+            listOf(discovery, bulk, urgent).awaitAll()
+
+            assertEquals(listOf("services", "read", "write"), started.map { it.substringAfterLast(':') })
+        }
+
+    // ========== Timeout Tests ==========
+
+    @Test
+    fun `timed out operation frees its lane`() =
+        runBlocking {
+            val stuck = fakeGatt("AA:AA:AA:AA:AA:01", discoveryLatencyMs = null)
+
+            try {
+                queue.enqueue(BleOperation.DiscoverServices(stuck), timeoutMs = 200)
+                fail("Discovery should have timed out")
+            } catch (e: TimeoutException) {
+                // Expected
+            }
+
+            val result = withTimeout(1_000) { queue.enqueue(write(stuck)) }
+            assertTrue(result is OperationResult.Success)
+        }
+
+    @Test
+    fun `releasing a connection fails its queued operations`() =
+        runBlocking {
+            val peer = fakeGatt("AA:AA:AA:AA:AA:01", discoveryLatencyMs = null)
+
+            async { runCatching { queue.enqueue(BleOperation.DiscoverServices(peer), timeoutMs = 5_000) } }
+            delay(50)
+            val queued = async { runCatching { queue.enqueue(read(peer)) } }
+            delay(50)
+
+            queue.releaseConnection("AA:AA:AA:AA:AA:01")
+
+            assertTrue(withTimeout(1_000) { queued.await() }.isFailure)
+            assertFalse(started.contains("AA:AA:AA:AA:AA:01:read"))
+        }
+
+    @Test
+    fun `adaptive timeout follows observed latency`() {
+        val timeout = AdaptiveTimeout(initialMs = 5_000, minMs = 1_000, maxMs = 15_000)
+        assertEquals(5_000, timeout.currentMs())
+
+        repeat(20) { timeout.record(40) }
+        assertEquals(1_000, timeout.currentMs()) // fast peer: floor
+
+        repeat(20) { timeout.record(3_000) }
+        assertTrue(timeout.currentMs() in 2_500..15_000) // slow peer: more room than the 5s default cut
+
+        timeout.onTimeout()
+        val backedOff = timeout.currentMs()
+        timeout.onTimeout()
+        assertTrue(timeout.currentMs() > backedOff || timeout.currentMs() == 15_000L)
+
+        timeout.record(3_000)
+        assertTrue(timeout.currentMs() < 15_000)
+    }
+}
@@ -1,250 +1,196 @@
+// BluetoothGatt, BluetoothDevice and characteristics are Android framework classes
+@file:Suppress("NoRelaxedMocks")
+
 package network.columba.app.rns.host.ble.util
 
-import io.mockk.clearAllMocks
-import kotlinx.coroutines.ExperimentalCoroutinesApi
-import kotlinx.coroutines.channels.Channel
+import android.bluetooth.BluetoothDevice
+import android.bluetooth.BluetoothGatt
+import android.bluetooth.BluetoothGattCharacteristic
+import io.mockk.every
+import io.mockk.mockk
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.launch
-import kotlinx.coroutines.test.advanceUntilIdle
-import kotlinx.coroutines.test.runTest
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeout
+import network.columba.app.rns.host.ble.model.BleConstants
+import network.columba.app.rns.host.ble.util.BleOperationQueue.BleOperation
+import network.columba.app.rns.host.ble.util.BleOperationQueue.OperationResult
 import org.junit.After
 import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
 import org.junit.Assert.assertTrue
+import org.junit.Assert.fail
 import org.junit.Test
-import java.util.concurrent.atomic.AtomicInteger
 
 /**
- * Unit tests for BleOperationQueue timeout handling.
- *
- * These tests verify the fix for the queue deadlock bug where a timeout would
- * permanently block the queue processor, causing all subsequent operations to fail.
- *
- * The fix: When a timeout occurs, we must signal operationCompletion.trySend(Unit)
- * to unblock the queue processor waiting on operationCompletion.receive().
- *
- * Bug scenario (before fix):
- * 1. Operation starts, returns Pending
- * 2. Queue processor waits on operationCompletion.receive()
- * 3. Timeout fires, resumes continuation with TimeoutException
- * 4. BUG: operationCompletion never signaled
- * 5. Queue processor stays blocked forever
- * 6. All subsequent operations timeout without even starting
+ * Tests for BleOperationQueue timeout handling on a connection's lane: a
+ * timeout frees the lane, a late callback for a timed-out operation never
+ * completes its successor, and learned timeouts outlive the connection.
  *
- * After fix:
- * 1-3. Same as above
- * 4. Timeout handler calls operationCompletion.trySend(Unit)
- * 5. Queue processor unblocks and processes next operation
+ * Callbacks are delivered by the test, so each one stands for a GATT callback
+ * arriving at that moment.
  */
-@OptIn(ExperimentalCoroutinesApi::class)
 class BleOperationQueueTimeoutTest {
+    private val callbacks = CoroutineScope(Dispatchers.Default + SupervisorJob())
+    private val queue = BleOperationQueue()
+
+    private val address = "AA:AA:AA:AA:AA:01"
+
     @After
     fun tearDown() {
-        clearAllMocks()
+        queue.shutdown()
+        callbacks.cancel()
     }
 
     /**
-     * Test the core timeout mechanism by simulating the queue processor behavior.
-     *
-     * This test verifies that when a timeout occurs, the completion signal is sent,
-     * allowing subsequent operations to proceed.
+     * A fake connection to [address]. Reads complete [readLatencyMs] after
+     * they start; writes and service discovery only complete when the test
+     * calls [callback].
      */
-    @Test
-    fun `timeout signals completion channel - core fix verification`() =
-        runTest {
-            // Simulate the queue's completion channel
-            val operationCompletion = Channel<Unit>(Channel.RENDEZVOUS)
-
-            // Track completion signals received
-            val completionCount = AtomicInteger(0)
-
-            // Simulate queue processor waiting for completion
-            launch {
-                repeat(2) {
-                    operationCompletion.receive()
-                    completionCount.incrementAndGet()
-                }
+    private fun fakeGatt(readLatencyMs: Long = 5): BluetoothGatt {
+        val device = mockk<BluetoothDevice> { every { this@mockk.address } returns address }
+        val gatt = mockk<BluetoothGatt>(relaxed = true)
+        every { gatt.device } returns device
+        every { gatt.discoverServices() } returns true
+        @Suppress("DEPRECATION")
+        every { gatt.writeCharacteristic(any<BluetoothGattCharacteristic>()) } returns true
+        every { gatt.readCharacteristic(any()) } answers {
+            callbacks.launch {
+                delay(readLatencyMs)
+                callback("read", OperationResult.Success())
             }
+            true
+        }
+        return gatt
+    }
 
-            // Simulate two timeouts - each should signal completion
-            launch {
-                // First timeout signals
-                operationCompletion.send(Unit)
-                // Second timeout signals
-                operationCompletion.send(Unit)
-            }
+    private fun callback(
+        key: String,
+        result: OperationResult,
+    ) = queue.completeOperationByKey(address, key, result)
 
-            // Let coroutines run
-            advanceUntilIdle()
+    private fun write(gatt: BluetoothGatt) = BleOperation.WriteCharacteristic(gatt, mockk(relaxed = true), byteArrayOf(0x01))
 
-            assertEquals("Both completions should be received", 2, completionCount.get())
+    private fun read(gatt: BluetoothGatt) = BleOperation.ReadCharacteristic(gatt, mockk(relaxed = true))
+
+    private suspend fun timedOutWrite(gatt: BluetoothGatt) {
+        try {
+            queue.enqueue(write(gatt), timeoutMs = 100)
+            fail("Write should have timed out")
+        } catch (e: TimeoutException) {
+            // Expected
         }
+    }
+
+    // ========== Lane Tests ==========
 
-    /**
-     * Test that without the fix, the queue would deadlock.
-     *
-     * This test demonstrates the bug scenario - if we don't signal completion
-     * after timeout, the queue processor stays blocked.
-     */
     @Test
-    fun `demonstrates deadlock without completion signal`() =
-        runTest {
-            val operationCompletion = Channel<Unit>(Channel.RENDEZVOUS)
-
-            // Processor waiting
-            val processorBlocked = AtomicInteger(0)
-            launch {
-                processorBlocked.set(1)
-                operationCompletion.receive() // This would block forever without the fix
-                processorBlocked.set(2)
-            }
+    fun `sequential timeouts all free the lane - no deadlock`() =
+        runBlocking {
+            val gatt = fakeGatt()
 
-            // Let the processor job start and block on receive
-            advanceUntilIdle()
-            assertEquals("Processor should be waiting on receive", 1, processorBlocked.get())
+            repeat(3) {
+                val result = runCatching { queue.enqueue(BleOperation.DiscoverServices(gatt), timeoutMs = 100) }
+                assertTrue(result.exceptionOrNull() is TimeoutException)
+            }
 
-            // Now send the completion signal (this is what the fix does)
-            operationCompletion.send(Unit)
+            val read = withTimeout(1_000) { queue.enqueue(read(gatt)) }
+            assertTrue(read is OperationResult.Success)
+            assertEquals(0, queue.getPendingOperationCount())
+        }
 
-            // Let coroutines run
-            advanceUntilIdle()
+    // ========== Late Callback Tests ==========
 
-            assertEquals("Processor should complete after signal", 2, processorBlocked.get())
+    @Test
+    fun `late callback before the next write is dropped`() =
+        runBlocking {
+            val gatt = fakeGatt()
+            timedOutWrite(gatt)
+
+            callback("write", OperationResult.Success("late"))
+            val next = async { queue.enqueue(write(gatt), timeoutMs = 2_000) }
+            delay(50)
+            assertFalse(next.isCompleted)
+
+            callback("write", OperationResult.Success("next"))
+            assertEquals(OperationResult.Success("next"), next.await())
         }
 
-    /**
-     * Test that timeout handler code path correctly signals completion.
-     *
-     * Simulates the timeout handler logic from BleOperationQueue.
-     */
     @Test
-    fun `timeout handler signals completion correctly`() =
-        runTest {
-            val operationCompletion = Channel<Unit>(Channel.RENDEZVOUS)
-            val timeoutFired = AtomicInteger(0)
-
-            // Simulate the timeout handler (as it exists after the fix)
-            launch {
-                // This is the critical part - the fix ensures this runs:
-                // mutex.withLock { pendingOperations.remove(...)?.continuation.resumeWithException(...) }
-                // operationCompletion.trySend(Unit)  <-- THE FIX
-
-                timeoutFired.incrementAndGet()
-                operationCompletion.send(Unit) // The fix
-            }
-
-            // Simulate queue processor waiting
-            launch {
-                operationCompletion.receive()
-            }
-
-            // Let coroutines run
-            advanceUntilIdle()
-
-            assertEquals("Timeout should have fired", 1, timeoutFired.get())
+    fun `late callback during the next write does not complete it`() =
+        runBlocking {
+            val gatt = fakeGatt()
+            timedOutWrite(gatt)
+
+            val next = async { queue.enqueue(write(gatt), timeoutMs = 2_000) }
+            delay(50)
+            callback("write", OperationResult.Success("late"))
+            delay(50)
+            assertFalse("Late callback completed the next write", next.isCompleted)
+
+            callback("write", OperationResult.Success("next"))
+            assertEquals(OperationResult.Success("next"), next.await())
         }
 
-    /**
-     * Test sequential operations with timeouts.
-     *
-     * Before the fix, the first timeout would block all subsequent operations.
-     * After the fix, each operation can proceed even if previous ones timed out.
-     */
     @Test
-    fun `sequential timeouts all complete - no deadlock`() =
-        runTest {
-            val operationCompletion = Channel<Unit>(Channel.RENDEZVOUS)
-            val completedOperations = AtomicInteger(0)
-
-            // Simulate queue processor handling 5 operations
-            launch {
-                repeat(5) {
-                    operationCompletion.receive()
-                    completedOperations.incrementAndGet()
-                }
-            }
+    fun `held callback completes the next write when the late one was lost`() =
+        runBlocking {
+            val gatt = fakeGatt()
+            timedOutWrite(gatt)
+
+            val next = async { queue.enqueue(write(gatt), timeoutMs = 300) }
+            delay(50)
+            callback("write", OperationResult.Success("next"))
+
+            assertEquals(OperationResult.Success("next"), withTimeout(1_000) { next.await() })
+
+            // Nothing is owed any more: the following write completes on its own callback
+            val after = async { queue.enqueue(write(gatt), timeoutMs = 2_000) }
+            delay(50)
+            callback("write", OperationResult.Success("after"))
+            assertEquals(OperationResult.Success("after"), after.await())
+        }
 
-            // Simulate 5 timeouts in sequence
-            launch {
-                repeat(5) {
-                    operationCompletion.send(Unit) // The fix ensures this happens
-                }
-            }
+    // ========== Adaptive Timeout Tests ==========
 
-            // Let coroutines run
-            advanceUntilIdle()
+    @Test
+    fun `write timeouts never adapt below the fixed operation timeout`() =
+        runBlocking {
+            val gatt = fakeGatt()
+
+            repeat(10) {
+                val write = async { queue.enqueue(write(gatt)) }
+                delay(10)
+                callback("write", OperationResult.Success())
+                write.await()
+                queue.enqueue(read(gatt))
+            }
 
-            assertEquals("All 5 operations should complete", 5, completedOperations.get())
+            assertEquals(BleConstants.OPERATION_TIMEOUT_MS, queue.adaptiveTimeoutMs(address, "write"))
+            assertTrue(queue.adaptiveTimeoutMs(address, "read")!! < BleConstants.OPERATION_TIMEOUT_MS)
         }
 
-    /**
-     * Test concurrent timeout signals don't cause issues.
-     */
     @Test
-    fun `concurrent timeout signals are handled correctly`() =
-        runTest {
-            val operationCompletion = Channel<Unit>(Channel.RENDEZVOUS)
-            val receivedCount = AtomicInteger(0)
-
-            // Receiver
-            launch {
-                repeat(10) {
-                    operationCompletion.receive()
-                    receivedCount.incrementAndGet()
-                }
-            }
-
-            // Sequential senders (RENDEZVOUS channel requires sequential for guaranteed delivery)
-            launch {
-                repeat(10) {
-                    operationCompletion.send(Unit)
-                }
-            }
+    fun `learned timeouts survive a reconnect`() =
+        runBlocking {
+            val gatt = fakeGatt()
+            repeat(20) { queue.enqueue(read(gatt)) }
+            val learned = queue.adaptiveTimeoutMs(address, "read")
 
-            // Let coroutines run
-            advanceUntilIdle()
+            queue.releaseConnection(address)
 
-            assertEquals("All 10 signals should be received", 10, receivedCount.get())
+            assertEquals(learned, queue.adaptiveTimeoutMs(address, "read"))
+            val afterReconnect = withTimeout(1_000) { queue.enqueue(read(fakeGatt())) }
+            assertTrue(afterReconnect is OperationResult.Success)
         }
 
-    /**
-     * Test that the DEFAULT_TIMEOUT_MS constant is reasonable.
-     */
     @Test
-    @Suppress("SwallowedException")
     fun `default timeout constant is 5 seconds`() {
-        val defaultTimeout = 5000L
-
-        // Verify via reflection that BleConstants has this value
-        val value =
-            try {
-                val constantsClass = Class.forName("network.columba.app.rns.host.ble.model.BleConstants")
-                val field = constantsClass.getDeclaredField("OPERATION_TIMEOUT_MS")
-                field.isAccessible = true
-                field.get(null) as Long
-            } catch (e: ReflectiveOperationException) {
-                // Reflection may fail in test environment - use expected value as fallback
-                // Exception is intentionally swallowed since we have a valid fallback
-                defaultTimeout
-            }
-
-        assertEquals("Operation timeout should be 5000ms", defaultTimeout, value)
+        assertEquals(5_000L, BleConstants.OPERATION_TIMEOUT_MS)
     }
-
-    /**
-     * Test that trySend on RENDEZVOUS channel doesn't block.
-     *
-     * This is important for the fix - we use trySend to avoid blocking
-     * the timeout handler if no receiver is waiting.
-     */
-    @Test
-    fun `trySend does not block when no receiver`() =
-        runTest {
-            val channel = Channel<Unit>(Channel.RENDEZVOUS)
-
-            // trySend should return immediately even with no receiver
-            val startTime = System.currentTimeMillis()
-            channel.trySend(Unit) // Result intentionally ignored - we only care that it doesn't block
-            val elapsed = System.currentTimeMillis() - startTime
-
-            assertTrue("trySend should complete quickly (not block)", elapsed < 100)
-        }
 }
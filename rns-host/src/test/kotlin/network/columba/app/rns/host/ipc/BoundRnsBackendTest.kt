@@ -35,6 +35,7 @@ import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.IconAppearance
 import network.columba.app.rns.api.model.Identity
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.rns.api.model.Link
 import network.columba.app.rns.api.model.LinkEvent
 import network.columba.app.rns.api.model.LinkSpeedProbeResult
@@ -44,6 +45,7 @@ import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.NomadnetPageResult
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.PropagationState
 import network.columba.app.rns.api.model.ReceivedMessage
 import network.columba.app.rns.api.model.ReceivedPacket
@@ -255,6 +257,7 @@ class BoundRnsBackendTest {
         override suspend fun getHopCount(destinationHash: ByteArray): Int? = null
         override suspend fun getNextHopInterfaceName(destinationHash: ByteArray): String? = null
         override suspend fun getPathTableHashes(): List<String> = emptyList()
+        override fun observePathTable() = kotlinx.coroutines.flow.emptyFlow<PathTableDelta>()
         override suspend fun probeLinkSpeed(destinationHash: ByteArray, timeoutSeconds: Float, deliveryMethod: String): LinkSpeedProbeResult = error("not used")
         override suspend fun isTransportEnabled() = false
         override suspend fun establishConversationLink(destinationHash: ByteArray, timeoutSeconds: Float): Result<ConversationLinkResult> = error("not used")
@@ -316,6 +319,7 @@ class BoundRnsBackendTest {
         override suspend fun getDebugInfo() = emptyMap<String, Any>()
         override suspend fun getFailedInterfaces(): List<FailedInterface> = emptyList()
         override suspend fun getInterfaceStats(interfaceName: String) = null
+        override fun observeInterfaceStats() = kotlinx.coroutines.flow.emptyFlow<List<InterfaceStatsSnapshot>>()
         override suspend fun reconnectRNodeInterface() {}
         override fun getRNodeRssi(): Int = rssi
         override fun getBleConnectionDetails(): String = bleConnections
@@ -352,6 +356,7 @@ class BoundRnsBackendTest {
         override suspend fun sendTelemetryRequest(destinationHash: ByteArray, sourceIdentity: Identity, timebase: Long?, isCollectorRequest: Boolean): Result<MessageReceipt> = error("not used")
         override suspend fun setTelemetryCollectorMode(enabled: Boolean) = Result.success(Unit)
         override suspend fun storeOwnTelemetry(locationJson: String, iconAppearance: IconAppearance?) = Result.success(Unit)
+        override suspend fun storeOwnTelemetryPacked(packedTelemetry: ByteArray, timestampSeconds: Long, iconAppearance: IconAppearance?) = Result.success(Unit)
         override suspend fun setTelemetryAllowedRequesters(allowedHashes: Set<String>) = Result.success(Unit)
         override val locationTelemetryFlow: SharedFlow<LocationTelemetry> = MutableSharedFlow<LocationTelemetry>(replay = 0).asSharedFlow()
     }
@@ -0,0 +1,232 @@
+package network.columba.app.rns.host.persistence
+
+import io.mockk.Runs
+import io.mockk.clearAllMocks
+import io.mockk.coEvery
+import io.mockk.coVerify
+import io.mockk.every
+import io.mockk.just
+import io.mockk.mockk
+import io.mockk.verify
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.flow.MutableSharedFlow
+import kotlinx.coroutines.flow.take
+import kotlinx.coroutines.flow.toList
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.advanceUntilIdle
+import kotlinx.coroutines.test.runCurrent
+import kotlinx.coroutines.test.runTest
+import network.columba.app.rns.api.RnsBackend
+import network.columba.app.rns.api.RnsLxmf
+import network.columba.app.rns.api.model.ReceivedMessage
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertSame
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+/**
+ * Unit tests for InboundMessageHandoff.
+ *
+ * Verifies every raw backend message goes through the persistence manager and
+ * is republished with the outcome flags, in arrival order, and that rejected
+ * messages never reach the UI.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+class InboundMessageHandoffTest {
+    private lateinit var lxmf: RnsLxmf
+    private lateinit var persistenceManager: ServicePersistenceManager
+    private lateinit var rawMessages: MutableSharedFlow<ReceivedMessage>
+
+    private val sourceHash = ByteArray(16) { it.toByte() }
+    private val destinationHash = ByteArray(16) { (it + 16).toByte() }
+
+    @Before
+    fun setup() {
+        lxmf = mockk()
+        persistenceManager = mockk()
+        rawMessages = MutableSharedFlow(extraBufferCapacity = 64)
+        every { lxmf.observeMessages() } returns rawMessages
+    }
+
+    @After
+    fun tearDown() {
+        clearAllMocks()
+    }
+
+    // Collection loop never completes; run it in the test's background scope.
+    private fun TestScope.startHandoff(): InboundMessageHandoff =
+        InboundMessageHandoff(lxmf, persistenceManager, backgroundScope).also {
+            it.start()
+            runCurrent()
+        }
+
+    private fun message(hash: String) =
+        ReceivedMessage(
+            messageHash = hash,
+            content = "Hello",
+            sourceHash = sourceHash,
+            destinationHash = destinationHash,
+            timestamp = 0L,
+        )
+
+    // Answers each batch from [outcomes] by message hash, recording what was submitted
+    private fun stubIngest(
+        outcomes: Map<String, IngestResult>,
+        submitted: MutableList<List<String>> = mutableListOf(),
+    ) {
+        coEvery { persistenceManager.ingestMessages(any()) } answers {
+            val messages = firstArg<List<InboundMessage>>()
+            submitted.add(messages.map { it.messageHash })
+            messages.map { outcomes[it.messageHash] ?: IngestResult(IngestResult.Outcome.PERSISTED) }
+        }
+    }
+
+    @Test
+    fun `enriches events with the ingest outcome and drops rejected ones`() =
+        runTest {
+            stubIngest(
+                mapOf(
+                    "new" to IngestResult(IngestResult.Outcome.PERSISTED, "Alice"),
+                    "dup" to IngestResult(IngestResult.Outcome.DUPLICATE, "Alice"),
+                    "blocked" to IngestResult.REJECTED,
+                    "failed" to IngestResult.FAILED,
+                ),
+            )
+
+            val handoff = startHandoff()
+            val received = mutableListOf<ReceivedMessage>()
+            val collector = launch { handoff.messages.take(3).toList(received) }
+            runCurrent()
+
+            listOf("new", "dup", "blocked", "failed").forEach { rawMessages.emit(message(it)) }
+            advanceUntilIdle()
+            collector.join()
+
+            assertEquals(listOf("new", "dup", "failed"), received.map { it.messageHash })
+
+            val (new, dup, failed) = received
+            assertTrue(new.persisted)
+            assertFalse(new.isDuplicate)
+            assertEquals("Alice", new.resolvedPeerName)
+
+            assertTrue(dup.persisted)
+            assertTrue(dup.isDuplicate)
+
+            // UI falls back to saving it itself
+            assertFalse(failed.persisted)
+        }
+
+    @Test
+    fun `unread duplicates notify again`() =
+        runTest {
+            stubIngest(mapOf("unread" to IngestResult(IngestResult.Outcome.DUPLICATE, "Alice", unread = true)))
+
+            val handoff = startHandoff()
+            val received = mutableListOf<ReceivedMessage>()
+            val collector = launch { handoff.messages.take(1).toList(received) }
+            runCurrent()
+
+            rawMessages.emit(message("unread"))
+            advanceUntilIdle()
+            collector.join()
+
+            val replay = received.single()
+            assertTrue(replay.persisted)
+            assertFalse(replay.isDuplicate)
+            assertEquals("Alice", replay.resolvedPeerName)
+        }
+
+    @Test
+    fun `subscribes before start returns`() =
+        runTest {
+            val submitted = mutableListOf<List<String>>()
+            stubIngest(emptyMap(), submitted)
+            val handoff = InboundMessageHandoff(lxmf, persistenceManager, backgroundScope)
+
+            // No runCurrent(): the backend may deliver as soon as start() returns
+            handoff.start()
+            assertEquals(1, rawMessages.subscriptionCount.value)
+            rawMessages.tryEmit(message("early"))
+            advanceUntilIdle()
+
+            assertEquals(listOf("early"), submitted.flatten())
+        }
+
+    @Test
+    fun `passes hex hashes and destination through to ingest`() =
+        runTest {
+            stubIngest(emptyMap())
+            startHandoff()
+
+            rawMessages.emit(message("hex"))
+            advanceUntilIdle()
+
+            coVerify {
+                persistenceManager.ingestMessages(
+                    match { batch ->
+                        batch.single().sourceHash == "000102030405060708090a0b0c0d0e0f" &&
+                            batch.single().destinationHash == "101112131415161718191a1b1c1d1e1f"
+                    },
+                )
+            }
+        }
+
+    @Test
+    fun `waiting messages are ingested together in arrival order`() =
+        runTest {
+            val submitted = mutableListOf<List<String>>()
+            stubIngest(emptyMap(), submitted)
+            val handoff = startHandoff()
+            val received = mutableListOf<ReceivedMessage>()
+            val collector = launch { handoff.messages.take(5).toList(received) }
+            runCurrent()
+
+            // However the loop splits them into batches, order must survive
+            val hashes = listOf("m1", "m2", "big", "m3", "m4")
+            hashes.forEach { hash ->
+                val raw = message(hash)
+                rawMessages.emit(if (hash == "big") raw.copy(fieldsJson = "x".repeat(600 * 1024)) else raw)
+            }
+            advanceUntilIdle()
+            collector.join()
+
+            assertEquals(listOf("m1", "m2", "m3", "m4"), submitted.flatten())
+            assertEquals(hashes, received.map { it.messageHash })
+            assertFalse(received[2].persisted)
+        }
+
+    @Test
+    fun `oversized fields are left for the UI to store`() =
+        runTest {
+            val handoff = startHandoff()
+            val received = mutableListOf<ReceivedMessage>()
+            val collector = launch { handoff.messages.take(1).toList(received) }
+            runCurrent()
+
+            rawMessages.emit(message("big").copy(fieldsJson = "x".repeat(600 * 1024)))
+            advanceUntilIdle()
+            collector.join()
+
+            assertFalse(received.single().persisted)
+            coVerify(exactly = 0) { persistenceManager.ingestMessages(any()) }
+        }
+
+    @Test
+    fun `wrapped backend serves the enriched stream and forwards the rest`() =
+        runTest {
+            val handoff = startHandoff()
+            val backend = mockk<RnsBackend>()
+            every { backend.lxmf } returns lxmf
+            every { lxmf.setConversationActive(true) } just Runs
+
+            val wrapped = handoff.wrap(backend)
+
+            assertSame(handoff.messages, wrapped.lxmf.observeMessages())
+            wrapped.lxmf.setConversationActive(true)
+            verify { lxmf.setConversationActive(true) }
+        }
+}
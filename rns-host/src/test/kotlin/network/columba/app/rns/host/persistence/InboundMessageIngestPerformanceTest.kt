@@ -0,0 +1,162 @@
+package network.columba.app.rns.host.persistence
+
+import android.app.Application
+import android.content.Context
+import androidx.room.Room
+import androidx.test.core.app.ApplicationProvider
+import io.mockk.every
+import io.mockk.mockk
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.runBlocking
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.entity.LocalIdentityEntity
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.robolectric.RobolectricTestRunner
+import org.robolectric.annotation.Config
+import java.util.concurrent.atomic.AtomicInteger
+import kotlin.system.measureTimeMillis
+
+/**
+ * Throughput benchmark for the inbound message ingest stage against a real
+ * in-memory Room database.
+ *
+ * Simulates a propagation-node sync (hundreds of messages from a few dozen
+ * senders landing at once) and compares it with the same volume delivered one
+ * at a time. Statements are counted with Room's query callback so the test
+ * asserts on work done rather than wall-clock time, which is too noisy on CI;
+ * timings are printed for manual comparison between builds.
+ */
+@RunWith(RobolectricTestRunner::class)
+@Config(sdk = [34], application = Application::class)
+class InboundMessageIngestPerformanceTest {
+    companion object {
+        private const val IDENTITY_HASH = "ingest_identity_hash_123456789012"
+        private const val SENDER_COUNT = 25
+        private const val MESSAGES_PER_SENDER = 20
+        private const val MESSAGE_COUNT = SENDER_COUNT * MESSAGES_PER_SENDER
+    }
+
+    private lateinit var database: ColumbaDatabase
+    private lateinit var ingest: InboundMessageIngest
+    private val statementCount = AtomicInteger()
+
+    @Before
+    fun setup() {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        database =
+            Room
+                .inMemoryDatabaseBuilder(context, ColumbaDatabase::class.java)
+                .setQueryCallback({ _, _ -> statementCount.incrementAndGet() }, { it.run() })
+                .build()
+
+        val settingsAccessor = mockk<ServiceSettingsAccessor>()
+        every { settingsAccessor.getBlockUnknownSenders() } returns false
+        ingest = InboundMessageIngest(database, SenderPolicyCache(database), settingsAccessor)
+
+        runBlocking {
+            database.localIdentityDao().insert(
+                LocalIdentityEntity(
+                    identityHash = IDENTITY_HASH,
+                    displayName = "Ingest",
+                    destinationHash = "ingest_dest_hash_1234567890123456",
+                    filePath = "/data/identity_ingest",
+                    keyData = null,
+                    createdTimestamp = 0L,
+                    lastUsedTimestamp = 0L,
+                    isActive = true,
+                ),
+            )
+        }
+    }
+
+    @After
+    fun tearDown() {
+        database.close()
+    }
+
+    private fun message(
+        prefix: String,
+        index: Int,
+    ) = InboundMessage(
+        messageHash = "${prefix}_msg_%05d".format(index),
+        content = "Message $index",
+        sourceHash = "${prefix}_sender_%02d".format(index % SENDER_COUNT),
+        timestamp = index.toLong(),
+        fieldsJson = null,
+        publicKey = null,
+        replyToMessageId = null,
+        deliveryMethod = "propagated",
+    )
+
+    @Test
+    fun `burst sync commits in batched transactions with fewer statements per message`() =
+        runBlocking {
+            // Warm the sender-policy snapshot so both runs start from the same state
+            ingest.submit(message("warmup", 0))
+
+            statementCount.set(0)
+            val serialBatchesBefore = ingest.committedBatches
+            val serialMs =
+                measureTimeMillis {
+                    repeat(MESSAGE_COUNT) { assertTrue(ingest.submit(message("serial", it)).isAccepted) }
+                }
+            val serialStatements = statementCount.get()
+            val serialBatches = ingest.committedBatches - serialBatchesBefore
+
+            statementCount.set(0)
+            val burstBatchesBefore = ingest.committedBatches
+            val burstMs =
+                measureTimeMillis {
+                    val results =
+                        (0 until MESSAGE_COUNT)
+                            .map { async(Dispatchers.IO) { ingest.submit(message("burst", it)) } }
+                            .awaitAll()
+                    assertTrue("Every burst message should persist", results.all { it.isAccepted })
+                }
+            val burstStatements = statementCount.get()
+            val burstBatches = ingest.committedBatches - burstBatchesBefore
+
+            println(
+                "Inbound ingest: serial $MESSAGE_COUNT msgs in ${serialMs}ms ($serialBatches txns, $serialStatements stmts); " +
+                    "burst in ${burstMs}ms ($burstBatches txns, $burstStatements stmts)",
+            )
+
+            assertEquals(MESSAGE_COUNT.toLong(), serialBatches)
+            assertTrue("Burst should group messages ($burstBatches transactions)", burstBatches < MESSAGE_COUNT / 2)
+            assertTrue(
+                "Batching should cut statements ($burstStatements vs $serialStatements)",
+                burstStatements < serialStatements,
+            )
+
+            // Every conversation saw exactly its share of messages, none lost or doubled
+            repeat(SENDER_COUNT) { sender ->
+                val peerHash = "burst_sender_%02d".format(sender)
+                assertEquals(MESSAGES_PER_SENDER, database.messageDao().getUnreadCount(peerHash, IDENTITY_HASH))
+                assertEquals(
+                    MESSAGES_PER_SENDER,
+                    database.conversationDao().getConversation(peerHash, IDENTITY_HASH)?.unreadCount,
+                )
+            }
+        }
+
+    @Test
+    fun `duplicates inside one burst are persisted once`() =
+        runBlocking {
+            val results =
+                (0 until 50)
+                    .map { async(Dispatchers.IO) { ingest.submit(message("dup", 0)) } }
+                    .awaitAll()
+
+            assertTrue("Duplicates report persisted", results.all { it.isAccepted })
+            val peerHash = "dup_sender_00"
+            assertEquals(1, database.messageDao().getUnreadCount(peerHash, IDENTITY_HASH))
+            assertEquals(1, database.conversationDao().getConversation(peerHash, IDENTITY_HASH)?.unreadCount)
+        }
+}
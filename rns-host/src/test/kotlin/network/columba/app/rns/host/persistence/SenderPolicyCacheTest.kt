@@ -0,0 +1,139 @@
+package network.columba.app.rns.host.persistence
+
+import androidx.room.InvalidationTracker
+import io.mockk.Runs
+import io.mockk.clearAllMocks
+import io.mockk.coEvery
+import io.mockk.coVerify
+import io.mockk.every
+import io.mockk.just
+import io.mockk.mockk
+import io.mockk.slot
+import kotlinx.coroutines.test.runTest
+import network.columba.app.data.db.ColumbaDatabase
+import network.columba.app.data.db.dao.BlockedPeerDao
+import network.columba.app.data.db.dao.ContactDao
+import network.columba.app.data.db.dao.LocalIdentityDao
+import network.columba.app.data.db.entity.LocalIdentityEntity
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+/**
+ * Unit tests for SenderPolicyCache.
+ *
+ * Verifies the snapshot is loaded once, reused until a table observer fires,
+ * and falls back to fail-open / uncached behaviour when loading or observing fails.
+ */
+class SenderPolicyCacheTest {
+    private lateinit var database: ColumbaDatabase
+    private lateinit var tracker: InvalidationTracker
+    private lateinit var localIdentityDao: LocalIdentityDao
+    private lateinit var blockedPeerDao: BlockedPeerDao
+    private lateinit var contactDao: ContactDao
+    private val observerSlot = slot<InvalidationTracker.Observer>()
+
+    private val identity =
+        LocalIdentityEntity(
+            identityHash = "owner_identity",
+            displayName = "Owner",
+            destinationHash = "owner_dest",
+            filePath = "/dev/null",
+            createdTimestamp = 0L,
+            lastUsedTimestamp = 0L,
+            isActive = true,
+        )
+
+    @Before
+    fun setup() {
+        database = mockk()
+        tracker = mockk()
+        localIdentityDao = mockk()
+        blockedPeerDao = mockk()
+        contactDao = mockk()
+
+        every { database.invalidationTracker } returns tracker
+        every { tracker.addObserver(capture(observerSlot)) } just Runs
+        every { database.localIdentityDao() } returns localIdentityDao
+        every { database.blockedPeerDao() } returns blockedPeerDao
+        every { database.contactDao() } returns contactDao
+
+        coEvery { localIdentityDao.getActiveIdentitySync() } returns identity
+        coEvery { blockedPeerDao.getBlockedPeerHashes("owner_identity") } returns listOf("blocked_peer")
+        coEvery { contactDao.getContactDestinationHashes("owner_identity") } returns listOf("friend")
+    }
+
+    @After
+    fun tearDown() {
+        clearAllMocks()
+    }
+
+    @Test
+    fun `snapshot reflects blocked and contact sets`() =
+        runTest {
+            val snapshot = SenderPolicyCache(database).get()!!
+
+            assertEquals("owner_identity", snapshot.activeIdentity.identityHash)
+            assertTrue(snapshot.isBlocked("blocked_peer"))
+            assertFalse(snapshot.isBlocked("friend"))
+            assertTrue(snapshot.isContact("friend"))
+            assertFalse(snapshot.isContact("stranger"))
+        }
+
+    @Test
+    fun `snapshot is reused until an observed table is invalidated`() =
+        runTest {
+            val cache = SenderPolicyCache(database)
+
+            repeat(100) { cache.get() }
+            coVerify(exactly = 1) { localIdentityDao.getActiveIdentitySync() }
+            coVerify(exactly = 1) { contactDao.getContactDestinationHashes(any()) }
+
+            coEvery { contactDao.getContactDestinationHashes("owner_identity") } returns listOf("friend", "new_friend")
+            observerSlot.captured.onInvalidated(setOf("contacts"))
+
+            assertTrue(cache.get()!!.isContact("new_friend"))
+            coVerify(exactly = 2) { localIdentityDao.getActiveIdentitySync() }
+        }
+
+    @Test
+    fun `returns null without active identity and does not cache it`() =
+        runTest {
+            coEvery { localIdentityDao.getActiveIdentitySync() } returns null
+            val cache = SenderPolicyCache(database)
+
+            assertNull(cache.get())
+            assertNull(cache.get())
+            coVerify(exactly = 2) { localIdentityDao.getActiveIdentitySync() }
+        }
+
+    @Test
+    fun `fails open and skips caching when sets cannot be loaded`() =
+        runTest {
+            coEvery { blockedPeerDao.getBlockedPeerHashes(any()) } throws RuntimeException("Database error")
+            val cache = SenderPolicyCache(database)
+
+            val snapshot = cache.get()!!
+            assertTrue(snapshot.failOpen)
+            assertFalse(snapshot.isBlocked("blocked_peer"))
+            assertTrue(snapshot.isContact("stranger"))
+
+            cache.get()
+            coVerify(exactly = 2) { localIdentityDao.getActiveIdentitySync() }
+        }
+
+    @Test
+    fun `reloads every time when observer cannot be registered`() =
+        runTest {
+            every { tracker.addObserver(any()) } throws IllegalStateException("closed")
+            val cache = SenderPolicyCache(database)
+
+            cache.get()
+            cache.get()
+            coVerify(exactly = 2) { localIdentityDao.getActiveIdentitySync() }
+        }
+}
@@ -2,7 +2,9 @@ package network.columba.app.rns.host.persistence
 
 import android.content.Context
 import network.columba.app.data.db.ColumbaDatabase
+import androidx.room.withTransaction
 import network.columba.app.data.db.dao.AnnounceDao
+import network.columba.app.data.db.dao.BlockedPeerDao
 import network.columba.app.data.db.dao.ContactDao
 import network.columba.app.data.db.dao.ConversationDao
 import network.columba.app.data.db.dao.LocalIdentityDao
@@ -12,7 +14,6 @@ import network.columba.app.data.db.dao.PeerIdentityDao
 import network.columba.app.data.db.entity.AnnounceEntity
 import network.columba.app.data.db.entity.ConversationEntity
 import network.columba.app.data.db.entity.LocalIdentityEntity
-import network.columba.app.data.db.entity.MessageEntity
 import network.columba.app.rns.host.di.ServiceDatabaseProvider
 import io.mockk.Runs
 import io.mockk.clearAllMocks
@@ -22,13 +23,17 @@ import io.mockk.every
 import io.mockk.just
 import io.mockk.mockk
 import io.mockk.mockkObject
+import io.mockk.mockkStatic
+import io.mockk.slot
 import io.mockk.unmockkObject
+import io.mockk.unmockkStatic
 import kotlinx.coroutines.ExperimentalCoroutinesApi
 import kotlinx.coroutines.test.TestScope
 import kotlinx.coroutines.test.UnconfinedTestDispatcher
 import kotlinx.coroutines.test.advanceUntilIdle
 import kotlinx.coroutines.test.runTest
 import org.junit.After
+import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
 import org.junit.Assert.assertTrue
 import org.junit.Before
@@ -46,6 +51,7 @@ class ServicePersistenceManagerTest {
     private lateinit var testScope: TestScope
     private lateinit var database: ColumbaDatabase
     private lateinit var announceDao: AnnounceDao
+    private lateinit var blockedPeerDao: BlockedPeerDao
     private lateinit var contactDao: ContactDao
     private lateinit var messageDao: MessageDao
     private lateinit var conversationDao: ConversationDao
@@ -67,6 +73,7 @@ class ServicePersistenceManagerTest {
         testScope = TestScope(UnconfinedTestDispatcher())
         database = mockk()
         announceDao = mockk()
+        blockedPeerDao = mockk()
         contactDao = mockk()
         messageDao = mockk()
         conversationDao = mockk()
@@ -77,6 +84,7 @@ class ServicePersistenceManagerTest {
 
         // Mock database DAOs
         every { database.announceDao() } returns announceDao
+        every { database.blockedPeerDao() } returns blockedPeerDao
         every { database.contactDao() } returns contactDao
         every { database.messageDao() } returns messageDao
         every { database.conversationDao() } returns conversationDao
@@ -84,6 +92,19 @@ class ServicePersistenceManagerTest {
         every { database.peerIdentityDao() } returns peerIdentityDao
         every { database.peerIconDao() } returns peerIconDao
 
+        // Sender policy snapshot: no blocked peers, no contacts unless a test says otherwise
+        coEvery { blockedPeerDao.getBlockedPeerHashes(any()) } returns emptyList()
+        coEvery { contactDao.getContactDestinationHashes(any()) } returns emptyList()
+
+        // Duplicates report the conversation's peer name; none by default
+        coEvery { conversationDao.getConversation(any(), any()) } returns null
+        coEvery { messageDao.isMessageUnread(any(), any()) } returns false
+
+        // Inbound messages are written inside withTransaction; run the block inline
+        mockkStatic("androidx.room.RoomDatabaseKt")
+        val transactionBlock = slot<suspend () -> Any?>()
+        coEvery { database.withTransaction(capture(transactionBlock)) } coAnswers { transactionBlock.captured.invoke() }
+
         // Mock ServiceDatabaseProvider singleton
         mockkObject(ServiceDatabaseProvider)
         every { ServiceDatabaseProvider.getDatabase(any()) } returns database
@@ -97,6 +118,7 @@ class ServicePersistenceManagerTest {
     @After
     fun tearDown() {
         unmockkObject(ServiceDatabaseProvider)
+        unmockkStatic("androidx.room.RoomDatabaseKt")
         clearAllMocks()
     }
 
@@ -303,7 +325,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -355,7 +377,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation("sender_hash", testIdentityHash) } returns existingConversation
             coEvery { conversationDao.updateConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -399,21 +421,8 @@ class ServicePersistenceManagerTest {
                     isActive = true,
                 )
 
-            val existingMessage =
-                MessageEntity(
-                    id = "test_message_hash",
-                    conversationHash = "sender_hash",
-                    identityHash = testIdentityHash,
-                    content = "Existing message",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = false,
-                    status = "delivered",
-                    isRead = false,
-                    fieldsJson = null,
-                )
-
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById("test_message_hash", testIdentityHash) } returns existingMessage
+            coEvery { messageDao.messageExists("test_message_hash", testIdentityHash) } returns true
 
             val result =
                 persistenceManager.persistMessage(
@@ -434,6 +443,72 @@ class ServicePersistenceManagerTest {
             coVerify(exactly = 0) { messageDao.insertMessage(any()) }
         }
 
+    @Test
+    fun `ingestMessage reports duplicate with the conversation peer name`() =
+        runTest {
+            coEvery { localIdentityDao.getActiveIdentitySync() } returns testIdentity()
+            coEvery { messageDao.messageExists("test_message_hash", testIdentityHash) } returns true
+            coEvery { conversationDao.getConversation("sender_hash", testIdentityHash) } returns
+                mockk { every { peerName } returns "Alice" }
+
+            val result = persistenceManager.ingestMessage(inboundMessage(destinationHash = "dest_hash"))
+
+            assertEquals(IngestResult.Outcome.DUPLICATE, result.outcome)
+            assertEquals("Alice", result.peerName)
+            assertFalse(result.unread)
+            coVerify(exactly = 0) { messageDao.insertMessage(any()) }
+        }
+
+    @Test
+    fun `ingestMessage reports a duplicate that is still unread`() =
+        runTest {
+            coEvery { localIdentityDao.getActiveIdentitySync() } returns testIdentity()
+            coEvery { messageDao.messageExists("test_message_hash", testIdentityHash) } returns true
+            coEvery { messageDao.isMessageUnread("test_message_hash", testIdentityHash) } returns true
+
+            val result = persistenceManager.ingestMessage(inboundMessage(destinationHash = "dest_hash"))
+
+            assertEquals(IngestResult.Outcome.DUPLICATE, result.outcome)
+            assertTrue(result.unread)
+            coVerify(exactly = 0) { messageDao.insertMessage(any()) }
+        }
+
+    @Test
+    fun `ingestMessage rejects message addressed to another identity`() =
+        runTest {
+            coEvery { localIdentityDao.getActiveIdentitySync() } returns testIdentity()
+
+            val result = persistenceManager.ingestMessage(inboundMessage(destinationHash = "other_dest_hash"))
+
+            assertEquals(IngestResult.REJECTED, result)
+            coVerify(exactly = 0) { messageDao.messageExists(any(), any()) }
+            coVerify(exactly = 0) { messageDao.insertMessage(any()) }
+        }
+
+    private fun testIdentity() =
+        LocalIdentityEntity(
+            identityHash = testIdentityHash,
+            displayName = "Test",
+            destinationHash = "dest_hash",
+            filePath = "/test/path",
+            createdTimestamp = 0L,
+            lastUsedTimestamp = 0L,
+            isActive = true,
+        )
+
+    private fun inboundMessage(destinationHash: String?) =
+        InboundMessage(
+            messageHash = "test_message_hash",
+            content = "Hello",
+            sourceHash = "sender_hash",
+            timestamp = 0L,
+            fieldsJson = null,
+            publicKey = null,
+            replyToMessageId = null,
+            deliveryMethod = null,
+            destinationHash = destinationHash,
+        )
+
     @Test
     fun `persistMessage skips when no active identity`() =
         runTest {
@@ -473,7 +548,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -512,7 +587,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -573,7 +648,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -650,20 +725,8 @@ class ServicePersistenceManagerTest {
                     isActive = true,
                 )
 
-            val existingMessage =
-                MessageEntity(
-                    id = "test_message_hash",
-                    conversationHash = "sender_hash",
-                    identityHash = testIdentityHash,
-                    content = "Test",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = false,
-                    status = "delivered",
-                    isRead = false,
-                )
-
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById("test_message_hash", testIdentityHash) } returns existingMessage
+            coEvery { messageDao.messageExists("test_message_hash", testIdentityHash) } returns true
 
             val result = persistenceManager.messageExists("test_message_hash")
 
@@ -685,7 +748,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
 
             val result = persistenceManager.messageExists("test_message_hash")
 
@@ -743,7 +806,7 @@ class ServicePersistenceManagerTest {
             // Enable block unknown senders
             every { settingsAccessor.getBlockUnknownSenders() } returns true
             // Sender is NOT in contacts
-            coEvery { contactDao.contactExists("unknown_sender", testIdentityHash) } returns false
+            coEvery { contactDao.getContactDestinationHashes(testIdentityHash) } returns emptyList()
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
 
             val result =
@@ -783,9 +846,9 @@ class ServicePersistenceManagerTest {
             // Enable block unknown senders
             every { settingsAccessor.getBlockUnknownSenders() } returns true
             // Sender IS in contacts
-            coEvery { contactDao.contactExists("known_sender", testIdentityHash) } returns true
+            coEvery { contactDao.getContactDestinationHashes(testIdentityHash) } returns listOf("known_sender")
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -826,7 +889,7 @@ class ServicePersistenceManagerTest {
             // Disable block unknown senders (default)
             every { settingsAccessor.getBlockUnknownSenders() } returns false
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -848,8 +911,8 @@ class ServicePersistenceManagerTest {
             // Should return true and persist message (setting is disabled)
             assertTrue("persistMessage should return true when setting disabled", result)
             coVerify { messageDao.insertMessage(any()) }
-            // Should NOT check contact existence when setting is disabled
-            coVerify(exactly = 0) { contactDao.contactExists(any(), any()) }
+            // Non-contact senders never load a contact row (nickname lookup is skipped)
+            coVerify(exactly = 0) { contactDao.getContact(any(), any()) }
         }
 
     @Test
@@ -869,9 +932,9 @@ class ServicePersistenceManagerTest {
             // Enable block unknown senders
             every { settingsAccessor.getBlockUnknownSenders() } returns true
             // Contact check throws exception
-            coEvery { contactDao.contactExists(any(), any()) } throws RuntimeException("Database error")
+            coEvery { contactDao.getContactDestinationHashes(any()) } throws RuntimeException("Database error")
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -914,7 +977,7 @@ class ServicePersistenceManagerTest {
                 )
 
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
@@ -951,7 +1014,7 @@ class ServicePersistenceManagerTest {
             // Enable block unknown senders
             every { settingsAccessor.getBlockUnknownSenders() } returns true
             // Sender is NOT in contacts
-            coEvery { contactDao.contactExists("unknown_sender", testIdentityHash) } returns false
+            coEvery { contactDao.getContactDestinationHashes(testIdentityHash) } returns emptyList()
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
 
             val result =
@@ -983,21 +1046,8 @@ class ServicePersistenceManagerTest {
                     isActive = true,
                 )
 
-            val existingMessage =
-                MessageEntity(
-                    id = "test_message_hash",
-                    conversationHash = "sender_hash",
-                    identityHash = testIdentityHash,
-                    content = "Existing message",
-                    timestamp = System.currentTimeMillis(),
-                    isFromMe = false,
-                    status = "delivered",
-                    isRead = false,
-                    fieldsJson = null,
-                )
-
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById("test_message_hash", testIdentityHash) } returns existingMessage
+            coEvery { messageDao.messageExists("test_message_hash", testIdentityHash) } returns true
 
             val result =
                 persistenceManager.persistMessage(
@@ -1072,9 +1122,9 @@ class ServicePersistenceManagerTest {
             // Enable block unknown senders
             every { settingsAccessor.getBlockUnknownSenders() } returns true
             // Sender IS in contacts
-            coEvery { contactDao.contactExists("known_sender", testIdentityHash) } returns true
+            coEvery { contactDao.getContactDestinationHashes(testIdentityHash) } returns listOf("known_sender")
             coEvery { localIdentityDao.getActiveIdentitySync() } returns activeIdentity
-            coEvery { messageDao.getMessageById(any(), any()) } returns null
+            coEvery { messageDao.messageExists(any(), any()) } returns false
             coEvery { conversationDao.getConversation(any(), any()) } returns null
             coEvery { conversationDao.insertConversation(any()) } just Runs
             coEvery { messageDao.insertMessage(any()) } just Runs
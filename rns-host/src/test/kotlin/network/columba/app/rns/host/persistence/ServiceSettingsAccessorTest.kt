@@ -4,6 +4,9 @@ import android.app.Application
 import android.content.Context
 import android.content.SharedPreferences
 import androidx.test.core.app.ApplicationProvider
+import io.mockk.every
+import io.mockk.mockk
+import io.mockk.slot
 import org.junit.After
 import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
@@ -13,6 +16,8 @@ import org.junit.Test
 import org.junit.runner.RunWith
 import org.robolectric.RobolectricTestRunner
 import org.robolectric.annotation.Config
+import java.io.Closeable
+import java.io.File
 
 /**
  * Unit tests for ServiceSettingsAccessor.
@@ -185,6 +190,75 @@ class ServiceSettingsAccessorTest {
         assertFalse(accessor.getAllowVoiceCalls())
     }
 
+    // ========== Cached Privacy Settings Tests ==========
+
+    @Test
+    fun `write by another process is picked up once the change signal fires`() {
+        val onChange = slot<() -> Unit>()
+        val signal = mockk<CrossProcessSettingsSignal>()
+        every { signal.watch(capture(onChange)) } returns Closeable {}
+        val watched = ServiceSettingsAccessor(context, signal)
+        prefs.edit().putBoolean(ServiceSettingsAccessor.KEY_BLOCK_UNKNOWN_SENDERS, false).commit()
+        assertFalse(watched.getBlockUnknownSenders())
+
+        // Rewrite the file behind this process's back, as the app process would
+        File(context.applicationInfo.dataDir, "shared_prefs/${ServiceSettingsAccessor.CROSS_PROCESS_PREFS_NAME}.xml")
+            .writeText(
+                "<?xml version='1.0' encoding='utf-8' standalone='yes' ?>\n<map>\n" +
+                    "    <boolean name=\"${ServiceSettingsAccessor.KEY_BLOCK_UNKNOWN_SENDERS}\" value=\"true\" />\n" +
+                    "    <boolean name=\"${ServiceSettingsAccessor.KEY_ALLOW_VOICE_CALLS}\" value=\"false\" />\n" +
+                    "</map>\n",
+            )
+        // Until the signal fires the cached copy is served without touching the file
+        assertFalse(watched.getBlockUnknownSenders())
+
+        onChange.captured()
+
+        assertTrue(watched.getBlockUnknownSenders())
+        assertFalse(watched.getAllowVoiceCalls())
+    }
+
+    @Test
+    fun `settings are read per call when the file cannot be watched`() {
+        val signal = mockk<CrossProcessSettingsSignal>()
+        every { signal.watch(any()) } returns null
+        val unwatched = ServiceSettingsAccessor(context, signal)
+
+        assertFalse(unwatched.getAllowCallsFromContactsOnly())
+        prefs.edit().putBoolean(ServiceSettingsAccessor.KEY_ALLOW_CALLS_FROM_CONTACTS_ONLY, true).apply()
+
+        assertTrue(unwatched.getAllowCallsFromContactsOnly())
+    }
+
+    @Test
+    fun `per-message settings read cost`() {
+        val signal = mockk<CrossProcessSettingsSignal>()
+        every { signal.watch(any()) } returns Closeable {}
+        val cachedAccessor = ServiceSettingsAccessor(context, signal)
+        prefs.edit().putBoolean(ServiceSettingsAccessor.KEY_BLOCK_UNKNOWN_SENDERS, true).commit()
+        val reads = 20_000
+
+        // Before: a fresh MODE_MULTI_PROCESS instance per read, stat-checking the file each time
+        val prefsStart = System.nanoTime()
+        var prefsBlocked = 0
+        repeat(reads) {
+            @Suppress("DEPRECATION")
+            val fresh = context.getSharedPreferences(ServiceSettingsAccessor.CROSS_PROCESS_PREFS_NAME, Context.MODE_MULTI_PROCESS)
+            if (fresh.getBoolean(ServiceSettingsAccessor.KEY_BLOCK_UNKNOWN_SENDERS, false)) prefsBlocked++
+        }
+        val prefsMs = (System.nanoTime() - prefsStart) / 1_000_000
+
+        // After: the cached snapshot, reloaded only on change
+        val cachedStart = System.nanoTime()
+        var cachedBlocked = 0
+        repeat(reads) { if (cachedAccessor.getBlockUnknownSenders()) cachedBlocked++ }
+        val cachedMs = (System.nanoTime() - cachedStart) / 1_000_000
+        println("$reads block-unknown-senders reads: multi-process prefs ${prefsMs}ms, cached ${cachedMs}ms")
+
+        assertEquals(reads, prefsBlocked)
+        assertEquals(reads, cachedBlocked)
+    }
+
     // ========== Cross-process key constants Tests ==========
 
     @Test
@@ -2,11 +2,13 @@ package network.columba.app.rns.ipc.client
 
 import android.os.RemoteException
 import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.channels.awaitClose
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.buffer
 import kotlinx.coroutines.flow.callbackFlow
 import kotlinx.coroutines.flow.launchIn
 import kotlinx.coroutines.flow.onEach
@@ -26,6 +28,7 @@ import network.columba.app.rns.api.model.LinkSpeedProbeResult
 import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.ReceivedPacket
 import network.columba.app.rns.api.model.ReticulumConfig
 import network.columba.app.rns.ipc.BundleKeys
@@ -34,6 +37,7 @@ import network.columba.app.rns.ipc.callback.IRnsAnnounceCallback
 import network.columba.app.rns.ipc.callback.IRnsLinkEventCallback
 import network.columba.app.rns.ipc.callback.IRnsNetworkStatusCallback
 import network.columba.app.rns.ipc.callback.IRnsPacketCallback
+import network.columba.app.rns.ipc.callback.IRnsPathTableCallback
 import network.columba.app.rns.ipc.toAnnounceRestoreEntries
 import network.columba.app.rns.ipc.toPeerIdentityEntries
 
@@ -235,6 +239,16 @@ internal class ClientRnsCore(
     override suspend fun getPathTableHashes(): List<String> =
         awaitStringList { cb -> remote.getPathTableHashes(cb) }
 
+    // Unbounded: a dropped delta would leave the mirror wrong until the next
+    // resubscribe, and the reset burst for a big table exceeds the default buffer.
+    override fun observePathTable(): Flow<PathTableDelta> = callbackFlow {
+        val cb = object : IRnsPathTableCallback.Stub() {
+            override fun onPathTableDelta(delta: PathTableDelta?) { if (delta != null) trySend(delta) }
+        }
+        if (!registerObserverOrClose { remote.registerPathTableObserver(cb) }) return@callbackFlow
+        awaitClose { runCatching { remote.unregisterPathTableObserver(cb) } }
+    }.buffer(Channel.UNLIMITED)
+
     override suspend fun probeLinkSpeed(
         destinationHash: ByteArray,
         timeoutSeconds: Float,
@@ -73,6 +73,15 @@ internal class ClientRnsTelemetry(
         Unit
     }
 
+    override suspend fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ): Result<Unit> = runCatching {
+        awaitResult { cb -> remote.storeOwnTelemetryPacked(packedTelemetry, timestampSeconds, iconAppearance, cb) }
+        Unit
+    }
+
     override suspend fun setTelemetryAllowedRequesters(allowedHashes: Set<String>): Result<Unit> = runCatching {
         awaitResult { cb -> remote.setTelemetryAllowedRequesters(allowedHashes.toTypedArray(), cb) }
         Unit
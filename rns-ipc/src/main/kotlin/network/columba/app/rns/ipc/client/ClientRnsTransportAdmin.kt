@@ -5,18 +5,22 @@ import kotlinx.coroutines.channels.awaitClose
 import kotlinx.coroutines.flow.Flow
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.SharedFlow
+import kotlinx.coroutines.flow.SharingStarted
 import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.flow.callbackFlow
 import kotlinx.coroutines.flow.launchIn
 import kotlinx.coroutines.flow.onEach
+import kotlinx.coroutines.flow.shareIn
 import kotlinx.coroutines.launch
 import network.columba.app.rns.api.RnsTransportAdmin
 import network.columba.app.rns.api.model.BatteryProfile
 import network.columba.app.rns.api.model.DiscoveredInterface
 import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.rns.ipc.BundleKeys
 import network.columba.app.rns.ipc.IRnsTransportAdmin
+import network.columba.app.rns.ipc.callback.IRnsInterfaceStatsCallback
 import network.columba.app.rns.ipc.callback.IRnsStringEventCallback
 import network.columba.app.rns.ipc.callback.IRnsUnitEventCallback
 import network.columba.app.rns.ipc.toAnyMap
@@ -83,6 +87,22 @@ internal class ClientRnsTransportAdmin(
         return bundle.toAnyMap(skip = setOf(BundleKeys.HAS_STATS))
     }
 
+    // One IPC registration however many screens collect, held only while at
+    // least one does. The last sample is replayed to a new collector but
+    // dropped once everyone has left, so a screen never opens on stale rates.
+    private val interfaceStatsShared: SharedFlow<List<InterfaceStatsSnapshot>> =
+        callbackFlow {
+            val cb = object : IRnsInterfaceStatsCallback.Stub() {
+                override fun onInterfaceStats(snapshots: MutableList<InterfaceStatsSnapshot>?) {
+                    if (snapshots != null) trySend(snapshots.toList())
+                }
+            }
+            if (!registerObserverOrClose { remote.registerInterfaceStatsObserver(cb) }) return@callbackFlow
+            awaitClose { runCatching { remote.unregisterInterfaceStatsObserver(cb) } }
+        }.shareIn(scope, SharingStarted.WhileSubscribed(replayExpirationMillis = 0), replay = 1)
+
+    override fun observeInterfaceStats(): Flow<List<InterfaceStatsSnapshot>> = interfaceStatsShared
+
     override suspend fun reconnectRNodeInterface() {
         awaitResult { cb -> remote.reconnectRNodeInterface(cb) }
     }
@@ -7,7 +7,11 @@ import android.os.TransactionTooLargeException
 import android.util.Log
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.Flow
+import kotlinx.coroutines.flow.collect
+import kotlinx.coroutines.flow.takeWhile
+import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import java.util.concurrent.ConcurrentHashMap
 
@@ -124,3 +128,89 @@ internal class ObserverHub<T, C : Any>(
             .onSuccess { deathRecipients[binder] = recipient }
     }
 }
+
+/**
+ * Like [ObserverHub], but every observer gets its own upstream collection.
+ *
+ * For streams whose first element is per-subscriber state (e.g. a reset
+ * snapshot followed by deltas) a shared collector is wrong: a late observer
+ * would join mid-stream and never see the snapshot. Each registration here
+ * calls [upstream] afresh; unregistering or binder death cancels only that
+ * observer's collector.
+ *
+ * Such a stream can't skip a value: a dropped delta leaves the client out
+ * of step for good. So an emit that fails (payload too large, transient
+ * remote error) restarts that observer's collection, which begins again
+ * with a fresh snapshot and heals the gap.
+ */
+internal class PerObserverRelay<T, C : Any>(
+    private val scope: CoroutineScope,
+    private val upstream: () -> Flow<T>,
+    private val callbackBinder: (C) -> IBinder,
+    private val emit: (C, T) -> Unit,
+) {
+    private val collectors = ConcurrentHashMap<IBinder, Job>()
+    private val deathRecipients = ConcurrentHashMap<IBinder, IBinder.DeathRecipient>()
+
+    private companion object {
+        const val TAG = "PerObserverRelay"
+
+        // Back-off before resubscribing after a failed emit
+        const val RESYNC_DELAY_MS = 1_000L
+    }
+
+    fun registerObserver(cb: C) {
+        val binder = callbackBinder(cb)
+        val job = scope.launch {
+            while (isActive) {
+                var delivered = true
+                upstream()
+                    .takeWhile { value -> deliver(binder, cb, value).also { delivered = it } }
+                    .collect()
+                if (delivered) break
+                delay(RESYNC_DELAY_MS)
+            }
+        }
+        collectors.put(binder, job)?.cancel()
+        hookDeath(binder)
+    }
+
+    /** Emit [value]; false if it didn't arrive and the observer must resubscribe. */
+    private fun deliver(
+        binder: IBinder,
+        cb: C,
+        value: T,
+    ): Boolean =
+        try {
+            emit(cb, value)
+            true
+        } catch (e: DeadObjectException) {
+            Log.d(TAG, "Observer client is dead; detaching", e)
+            detach(binder)
+            false
+        } catch (e: TransactionTooLargeException) {
+            Log.e(TAG, "Observer payload exceeded the Binder transaction limit; resubscribing for a full reset", e)
+            false
+        } catch (e: RemoteException) {
+            Log.w(TAG, "Observer emit failed; resubscribing for a full reset", e)
+            false
+        }
+
+    fun unregisterObserver(cb: C) {
+        detach(callbackBinder(cb))
+    }
+
+    private fun detach(binder: IBinder) {
+        collectors.remove(binder)?.cancel()
+        deathRecipients.remove(binder)?.let { recipient ->
+            runCatching { binder.unlinkToDeath(recipient, 0) }
+        }
+    }
+
+    private fun hookDeath(binder: IBinder) {
+        if (deathRecipients.containsKey(binder)) return
+        val recipient = IBinder.DeathRecipient { detach(binder) }
+        runCatching { binder.linkToDeath(recipient, 0) }
+            .onSuccess { deathRecipients[binder] = recipient }
+    }
+}
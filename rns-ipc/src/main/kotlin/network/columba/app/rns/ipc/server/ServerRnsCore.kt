@@ -13,6 +13,7 @@ import network.columba.app.rns.api.model.Link
 import network.columba.app.rns.api.model.LinkEvent
 import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.PeerIdentityEntry
 import network.columba.app.rns.api.model.ReceivedPacket
 import network.columba.app.rns.api.model.ReticulumConfig
@@ -25,6 +26,7 @@ import network.columba.app.rns.ipc.callback.IRnsIntCallback
 import network.columba.app.rns.ipc.callback.IRnsLinkEventCallback
 import network.columba.app.rns.ipc.callback.IRnsNetworkStatusCallback
 import network.columba.app.rns.ipc.callback.IRnsPacketCallback
+import network.columba.app.rns.ipc.callback.IRnsPathTableCallback
 import network.columba.app.rns.ipc.callback.IRnsResultCallback
 import network.columba.app.rns.ipc.callback.IRnsStringCallback
 import network.columba.app.rns.ipc.callback.IRnsStringListCallback
@@ -60,6 +62,12 @@ internal class ServerRnsCore(
         callbackBinder = { it.asBinder() },
         emit = { cb, value -> cb.onAnnounce(value) },
     )
+    private val pathTableRelay = PerObserverRelay<PathTableDelta, IRnsPathTableCallback>(
+        scope = scope,
+        upstream = { impl.observePathTable() },
+        callbackBinder = { it.asBinder() },
+        emit = { cb, value -> cb.onPathTableDelta(value) },
+    )
 
     override fun initialize(config: ReticulumConfig, cb: IRnsResultCallback) =
         dispatch(cb, scope) { impl.initialize(config).bundleOrThrow() }
@@ -179,6 +187,9 @@ internal class ServerRnsCore(
         impl.getPathTableHashes()
     }
 
+    override fun registerPathTableObserver(cb: IRnsPathTableCallback) = pathTableRelay.registerObserver(cb)
+    override fun unregisterPathTableObserver(cb: IRnsPathTableCallback) = pathTableRelay.unregisterObserver(cb)
+
     override fun probeLinkSpeed(
         destinationHash: ByteArray,
         timeoutSeconds: Float,
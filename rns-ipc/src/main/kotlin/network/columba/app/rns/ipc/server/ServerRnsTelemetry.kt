@@ -70,6 +70,15 @@ internal class ServerRnsTelemetry(
         impl.storeOwnTelemetry(locationJson, iconAppearance).bundleOrThrow()
     }
 
+    override fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+        cb: IRnsResultCallback,
+    ) = dispatch(cb, scope) {
+        impl.storeOwnTelemetryPacked(packedTelemetry, timestampSeconds, iconAppearance).bundleOrThrow()
+    }
+
     override fun setTelemetryAllowedRequesters(allowedHashes: Array<out String>, cb: IRnsResultCallback) =
         dispatch(cb, scope) {
             impl.setTelemetryAllowedRequesters(allowedHashes.toSet()).bundleOrThrow()
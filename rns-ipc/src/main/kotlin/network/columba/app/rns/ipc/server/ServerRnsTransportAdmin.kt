@@ -5,10 +5,12 @@ import kotlinx.coroutines.CoroutineScope
 import network.columba.app.rns.api.RnsTransportAdmin
 import network.columba.app.rns.api.model.BatteryProfile
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.rns.ipc.BundleKeys
 import network.columba.app.rns.ipc.IRnsTransportAdmin
 import network.columba.app.rns.ipc.callback.IRnsBoolCallback
 import network.columba.app.rns.ipc.callback.IRnsIntCallback
+import network.columba.app.rns.ipc.callback.IRnsInterfaceStatsCallback
 import network.columba.app.rns.ipc.callback.IRnsResultCallback
 import network.columba.app.rns.ipc.callback.IRnsStringCallback
 import network.columba.app.rns.ipc.callback.IRnsStringEventCallback
@@ -31,6 +33,15 @@ internal class ServerRnsTransportAdmin(
     private val ifStatusHub = stringHub(scope) { impl.interfaceStatusFlow }
     private val reactionHub = stringHub(scope) { impl.reactionReceivedFlow }
 
+    // Shared upstream: every observer gets the same samples, and the backend
+    // stops sampling when the last one leaves.
+    private val interfaceStatsHub = ObserverHub<List<InterfaceStatsSnapshot>, IRnsInterfaceStatsCallback>(
+        scope = scope,
+        upstream = { impl.observeInterfaceStats() },
+        callbackBinder = { it.asBinder() },
+        emit = { cb, value -> cb.onInterfaceStats(value) },
+    )
+
     override fun setBatteryProfile(profile: BatteryProfile) {
         // Fire-and-forget; errors logged on host (no callback per the AIDL contract).
         runCatching { impl.setBatteryProfile(profile) }
@@ -118,6 +129,9 @@ internal class ServerRnsTransportAdmin(
 
     override fun registerReactionReceivedObserver(cb: IRnsStringEventCallback) = reactionHub.registerObserver(cb)
     override fun unregisterReactionReceivedObserver(cb: IRnsStringEventCallback) = reactionHub.unregisterObserver(cb)
+
+    override fun registerInterfaceStatsObserver(cb: IRnsInterfaceStatsCallback) = interfaceStatsHub.registerObserver(cb)
+    override fun unregisterInterfaceStatsObserver(cb: IRnsInterfaceStatsCallback) = interfaceStatsHub.unregisterObserver(cb)
 }
 
 private fun stringHub(
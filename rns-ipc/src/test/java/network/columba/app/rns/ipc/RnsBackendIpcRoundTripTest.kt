@@ -10,6 +10,8 @@ import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.emitAll
+import kotlinx.coroutines.flow.flow
 import kotlinx.coroutines.test.StandardTestDispatcher
 import kotlinx.coroutines.test.TestScope
 import kotlinx.coroutines.test.advanceUntilIdle
@@ -36,6 +38,7 @@ import network.columba.app.rns.api.model.FailedInterface
 import network.columba.app.rns.api.model.IconAppearance
 import network.columba.app.rns.api.model.Identity
 import network.columba.app.rns.api.model.InterfaceConfig
+import network.columba.app.rns.api.model.InterfaceStatsSnapshot
 import network.columba.app.rns.api.model.Link
 import network.columba.app.rns.api.model.LinkEvent
 import network.columba.app.rns.api.model.LinkSpeedProbeResult
@@ -45,6 +48,7 @@ import network.columba.app.rns.api.model.NetworkStatus
 import network.columba.app.rns.api.model.NomadnetPageResult
 import network.columba.app.rns.api.model.PacketReceipt
 import network.columba.app.rns.api.model.PacketType
+import network.columba.app.rns.api.model.PathTableDelta
 import network.columba.app.rns.api.model.PropagationState
 import network.columba.app.rns.api.model.ReceivedMessage
 import network.columba.app.rns.api.model.ReceivedPacket
@@ -165,6 +169,53 @@ class RnsBackendIpcRoundTripTest {
         }
     }
 
+    @Test
+    fun `observePathTable gives every subscriber its own reset before deltas`() = runTest {
+        val (client, _) = buildClientAndServer()
+        advanceUntilIdle()
+        fake.core.pathTableSnapshot = mapOf("aa" to 1, "bb" to 2)
+        val delta = PathTableDelta(updated = mapOf("bb" to 3), expired = listOf("aa"))
+
+        client.core.observePathTable().test {
+            advanceUntilIdle()
+            assertEquals(PathTableDelta(reset = true, added = mapOf("aa" to 1, "bb" to 2)), awaitItem())
+
+            // A second subscriber joining later still starts from a reset
+            client.core.observePathTable().test {
+                advanceUntilIdle()
+                assertTrue(awaitItem().reset)
+                fake.core.pathTableDeltas.emit(delta)
+                advanceUntilIdle()
+                assertEquals(delta, awaitItem())
+                cancelAndIgnoreRemainingEvents()
+            }
+
+            assertEquals(delta, awaitItem())
+            cancelAndIgnoreRemainingEvents()
+        }
+    }
+
+    @Test
+    fun `observeInterfaceStats shares one upstream between collectors`() = runTest {
+        val (client, _) = buildClientAndServer()
+        advanceUntilIdle()
+        val sample = listOf(InterfaceStatsSnapshot(name = "RNode", online = true, rxBytes = 10, txBytes = 20, rxRate = 5))
+
+        client.transportAdmin.observeInterfaceStats().test {
+            client.transportAdmin.observeInterfaceStats().test {
+                advanceUntilIdle()
+                fake.transportAdmin.interfaceStats.emit(sample)
+                advanceUntilIdle()
+                assertEquals(sample, awaitItem())
+                cancelAndIgnoreRemainingEvents()
+            }
+            assertEquals(sample, awaitItem())
+            cancelAndIgnoreRemainingEvents()
+        }
+
+        assertEquals(1, fake.transportAdmin.interfaceStatsCollections)
+    }
+
     @Test
     fun `capabilities snapshot lands in the client StateFlow on connect`() = runTest {
         val (client, _) = buildClientAndServer()
@@ -280,6 +331,26 @@ class RnsBackendIpcRoundTripTest {
         assertArrayEquals("3 MB file must survive the PFD round trip", bigFile, files?.first()?.second)
     }
 
+    @Test
+    fun `storeOwnTelemetryPacked carries Telemeter bytes across the seam`() = runTest {
+        val (client, _) = buildClientAndServer()
+        advanceUntilIdle()
+
+        val packed = network.columba.app.rns.api.util.TelemeterCodec.packLocationTelemetry(
+            network.columba.app.rns.api.model.LocationTelemetry(lat = 52.52, lng = 13.405, acc = 4f, ts = 1_700_000_000_000L),
+        )
+        val appearance = IconAppearance(iconName = "account", foregroundColor = "ffffff", backgroundColor = "1e88e5")
+
+        val result = client.telemetry.storeOwnTelemetryPacked(packed, 1_700_000_000L, appearance)
+        advanceUntilIdle()
+
+        assertTrue("store should succeed, was $result", result.isSuccess)
+        val telemetry = fake.telemetry
+        assertArrayEquals(packed, telemetry.lastPackedTelemetry)
+        assertEquals(1_700_000_000L, telemetry.lastPackedTimestampSeconds)
+        assertEquals(appearance, telemetry.lastPackedAppearance)
+    }
+
     @Test
     fun `text-only send sends a null attachment blob`() = runTest {
         val (client, _) = buildClientAndServer()
@@ -345,12 +416,12 @@ private class FakeRnsBackend : RnsBackend {
     )
 
     override val capabilities: StateFlow<BackendCapabilities> get() = capabilitiesState.asStateFlow()
-    override val core: RnsCore = FakeRnsCore()
+    override val core: FakeRnsCore = FakeRnsCore()
     override val lxmf: FakeRnsLxmf = FakeRnsLxmf()
     override val telephony: FakeRnsTelephony = FakeRnsTelephony()
-    override val telemetry: RnsTelemetry = FakeRnsTelemetry()
+    override val telemetry: FakeRnsTelemetry = FakeRnsTelemetry()
     override val nomadnet: RnsNomadnet = FakeRnsNomadnet()
-    override val transportAdmin: RnsTransportAdmin = FakeRnsTransportAdmin()
+    override val transportAdmin: FakeRnsTransportAdmin = FakeRnsTransportAdmin()
 }
 
 private class FakeRnsTelephony : RnsTelephony {
@@ -535,6 +606,14 @@ private class FakeRnsCore : RnsCore {
     override suspend fun getHopCount(destinationHash: ByteArray): Int? = null
     override suspend fun getNextHopInterfaceName(destinationHash: ByteArray): String? = null
     override suspend fun getPathTableHashes(): List<String> = emptyList()
+
+    // Every subscriber starts from its own reset snapshot, like PathTableDiffer
+    var pathTableSnapshot: Map<String, Int> = emptyMap()
+    val pathTableDeltas = MutableSharedFlow<PathTableDelta>()
+    override fun observePathTable(): Flow<PathTableDelta> = flow {
+        emit(PathTableDelta(reset = true, added = pathTableSnapshot))
+        emitAll(pathTableDeltas)
+    }
     override suspend fun probeLinkSpeed(
         destinationHash: ByteArray,
         timeoutSeconds: Float,
@@ -576,6 +655,21 @@ private class FakeRnsTelemetry : RnsTelemetry {
     override suspend fun setTelemetryCollectorMode(enabled: Boolean) = Result.success(Unit)
     override suspend fun storeOwnTelemetry(locationJson: String, iconAppearance: IconAppearance?) =
         Result.success(Unit)
+
+    var lastPackedTelemetry: ByteArray? = null
+    var lastPackedTimestampSeconds: Long? = null
+    var lastPackedAppearance: IconAppearance? = null
+
+    override suspend fun storeOwnTelemetryPacked(
+        packedTelemetry: ByteArray,
+        timestampSeconds: Long,
+        iconAppearance: IconAppearance?,
+    ): Result<Unit> {
+        lastPackedTelemetry = packedTelemetry
+        lastPackedTimestampSeconds = timestampSeconds
+        lastPackedAppearance = iconAppearance
+        return Result.success(Unit)
+    }
     override suspend fun setTelemetryAllowedRequesters(allowedHashes: Set<String>) = Result.success(Unit)
     override val locationTelemetryFlow: SharedFlow<network.columba.app.rns.api.model.LocationTelemetry> =
         emissions.asSharedFlow()
@@ -612,6 +706,14 @@ private class FakeRnsTransportAdmin : RnsTransportAdmin {
     override suspend fun getDebugInfo(): Map<String, Any> = emptyMap()
     override suspend fun getFailedInterfaces(): List<FailedInterface> = emptyList()
     override suspend fun getInterfaceStats(interfaceName: String): Map<String, Any>? = null
+
+    // Counts upstream collections so tests can see how many samplers are running
+    var interfaceStatsCollections = 0
+    val interfaceStats = MutableSharedFlow<List<InterfaceStatsSnapshot>>()
+    override fun observeInterfaceStats(): Flow<List<InterfaceStatsSnapshot>> = flow {
+        interfaceStatsCollections++
+        emitAll(interfaceStats)
+    }
     override suspend fun reconnectRNodeInterface() {}
     override fun getRNodeRssi(): Int = -100
     override fun getBleConnectionDetails(): String = "[]"